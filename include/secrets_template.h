@@ -18,6 +18,12 @@
 #define WIFI_SSID "Your_WiFi_Network_Name"
 #define WIFI_PASSWORD "Your_WiFi_Password"
 
+// Optional fallback networks; the station moves to the best one it can reach
+// #define WIFI_SSID_2 "Second_Network"
+// #define WIFI_PASSWORD_2 "Second_Password"
+// #define WIFI_SSID_3 "Third_Network"
+// #define WIFI_PASSWORD_3 "Third_Password"
+
 // ==================== SETUP INSTRUCTIONS ====================
 // 1. Copy this file to secrets.h: cp secrets_template.h secrets.h
 // 2. Replace the placeholder values above with your actual credentials
@@ -0,0 +1,137 @@
+#include "alloc_tracker.h"
+#include <stdlib.h>
+#include <string.h>
+
+AllocTagStats AllocTracker::tags[ALLOC_TAG_COUNT];
+AllocTracker::ScopeFrame AllocTracker::scopes[ALLOC_SCOPE_DEPTH];
+int AllocTracker::depth = 0;
+HeapProbe AllocTracker::heapProbe = nullptr;
+
+const char* AllocTracker::tagName(uint8_t tag) {
+    switch (tag) {
+        case ALLOC_TAG_OTHER: return "other";
+        case ALLOC_TAG_DISPLAY: return "display";
+        case ALLOC_TAG_NETWORK: return "network";
+        case ALLOC_TAG_JSON: return "json";
+        case ALLOC_TAG_LOGGING: return "logging";
+        default: return "unknown";
+    }
+}
+
+void AllocTracker::reset() {
+    memset(tags, 0, sizeof(tags));
+    depth = 0;
+}
+
+void AllocTracker::apply(uint8_t tag, int32_t delta) {
+    if (tag >= ALLOC_TAG_COUNT) {
+        tag = ALLOC_TAG_OTHER;
+    }
+    AllocTagStats& s = tags[tag];
+    s.current += delta;
+    if (s.current > s.peak) {
+        s.peak = s.current;
+    }
+
+    // Enclosing scope must not count these bytes a second time
+    if (depth > 0) {
+        scopes[innermost()].attributed += delta;
+    }
+}
+
+void AllocTracker::recordAlloc(uint8_t tag, size_t bytes) {
+    apply(tag, (int32_t)bytes);
+    tags[tag < ALLOC_TAG_COUNT ? tag : 0].count++;
+}
+
+void AllocTracker::recordFree(uint8_t tag, size_t bytes) {
+    apply(tag, -(int32_t)bytes);
+    tags[tag < ALLOC_TAG_COUNT ? tag : 0].frees++;
+}
+
+uint8_t AllocTracker::currentTag() {
+    return depth > 0 ? scopes[innermost()].tag : (uint8_t)ALLOC_TAG_OTHER;
+}
+
+void AllocTracker::pushScope(uint8_t tag) {
+    if (depth >= ALLOC_SCOPE_DEPTH) {
+        depth++;  // Too deep - counted for balance, attributed to the outer scope
+        return;
+    }
+    ScopeFrame& f = scopes[depth++];
+    f.tag = tag;
+    f.freeBefore = heapProbe ? heapProbe() : 0;
+    f.attributed = 0;
+}
+
+void AllocTracker::popScope() {
+    if (depth == 0) {
+        return;
+    }
+    if (depth > ALLOC_SCOPE_DEPTH) {
+        depth--;
+        return;
+    }
+
+    ScopeFrame f = scopes[--depth];
+    if (heapProbe == nullptr) {
+        return;
+    }
+
+    // Net growth over the scope, minus what nested sources already claimed
+    int32_t grown = (int32_t)(f.freeBefore - heapProbe());
+    int32_t own = grown - f.attributed;
+    AllocTagStats& s = tags[f.tag < ALLOC_TAG_COUNT ? f.tag : 0];
+    s.scopeRuns++;
+    if (own > s.scopeMaxGrowth) {
+        s.scopeMaxGrowth = own;
+    }
+    // The enclosing scope must not count any of it again
+    if (depth > 0) {
+        scopes[depth - 1].attributed += grown;
+    }
+}
+
+// Counting allocator - a small header remembers size and tag for the free
+struct TrackedHeader {
+    uint32_t size;
+    uint8_t tag;
+    uint8_t pad[3];  // Keep the payload 8-byte aligned
+};
+
+void* trackedMalloc(size_t size, uint8_t tag) {
+    TrackedHeader* h = (TrackedHeader*)malloc(sizeof(TrackedHeader) + size);
+    if (h == nullptr) {
+        return nullptr;
+    }
+    h->size = (uint32_t)size;
+    h->tag = tag;
+    AllocTracker::recordAlloc(tag, size);
+    return h + 1;
+}
+
+void* trackedRealloc(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return trackedMalloc(size, AllocTracker::currentTag());
+    }
+    TrackedHeader* old = (TrackedHeader*)ptr - 1;
+    uint8_t tag = old->tag;
+    uint32_t oldSize = old->size;
+    TrackedHeader* h = (TrackedHeader*)realloc(old, sizeof(TrackedHeader) + size);
+    if (h == nullptr) {
+        return nullptr;
+    }
+    AllocTracker::recordFree(tag, oldSize);
+    AllocTracker::recordAlloc(tag, size);
+    h->size = (uint32_t)size;
+    return h + 1;
+}
+
+void trackedFree(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    TrackedHeader* h = (TrackedHeader*)ptr - 1;
+    AllocTracker::recordFree(h->tag, h->size);
+    free(h);
+}
@@ -0,0 +1,86 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Per-subsystem allocation accounting. No Arduino dependencies.
+//
+// Two sources feed it:
+//  - exact allocators (trackedMalloc, TrackingJsonAllocator) call
+//    recordAlloc/recordFree; these are the figures budgets are checked against
+//  - AllocScope brackets a block of code and notes the net heap change it
+//    caused (minus anything nested scopes or exact allocators claimed). The
+//    heap is shared with the tasks on the other core, so this is approximate
+//    and kept apart from the exact figures.
+// The heap probe is ESP.getFreeHeap() on the device and a counting
+// allocator on the host.
+
+enum AllocTag : uint8_t {
+    ALLOC_TAG_OTHER = 0,
+    ALLOC_TAG_DISPLAY,
+    ALLOC_TAG_NETWORK,
+    ALLOC_TAG_JSON,
+    ALLOC_TAG_LOGGING,
+    ALLOC_TAG_COUNT
+};
+
+struct AllocTagStats {
+    int32_t current;          // Exact bytes currently held
+    int32_t peak;             // Highest value of current
+    uint32_t count;           // Exact allocations
+    uint32_t frees;
+    uint32_t scopeRuns;       // Approximate: AllocScope blocks run
+    int32_t scopeMaxGrowth;   // Largest net heap growth of one run, other tasks included
+};
+
+typedef uint32_t (*HeapProbe)();  // Returns free heap bytes
+
+class AllocTracker {
+public:
+    static void setHeapProbe(HeapProbe probe) { heapProbe = probe; }
+
+    static void recordAlloc(uint8_t tag, size_t bytes);
+    static void recordFree(uint8_t tag, size_t bytes);
+
+    static void pushScope(uint8_t tag);
+    static void popScope();
+    static uint8_t currentTag();
+
+    static const AllocTagStats& stats(uint8_t tag) { return tags[tag < ALLOC_TAG_COUNT ? tag : 0]; }
+    // Exact peak only; scope figures are too noisy to fail on
+    static bool withinBudget(uint8_t tag, int32_t peakBytes) { return stats(tag).peak <= peakBytes; }
+    static const char* tagName(uint8_t tag);
+    static void reset();
+
+private:
+    struct ScopeFrame {
+        uint8_t tag;
+        uint32_t freeBefore;
+        int32_t attributed;  // Bytes already accounted inside this scope
+    };
+
+    static AllocTagStats tags[ALLOC_TAG_COUNT];
+    static ScopeFrame scopes[ALLOC_SCOPE_DEPTH];
+    static int depth;
+    static HeapProbe heapProbe;
+
+    static void apply(uint8_t tag, int32_t delta);
+    // Frame of the innermost scope; scopes nested too deep share the last one
+    static int innermost() { return (depth < ALLOC_SCOPE_DEPTH ? depth : ALLOC_SCOPE_DEPTH) - 1; }
+};
+
+// Counting allocator - exact per-tag accounting for allocations routed through it
+void* trackedMalloc(size_t size, uint8_t tag);
+void* trackedRealloc(void* ptr, size_t size);
+void trackedFree(void* ptr);
+
+// Notes the net heap growth of the enclosing block under a subsystem (approximate)
+class AllocScope {
+public:
+    explicit AllocScope(uint8_t tag) { AllocTracker::pushScope(tag); }
+    ~AllocScope() { AllocTracker::popScope(); }
+};
+
+#endif // ALLOC_TRACKER_H
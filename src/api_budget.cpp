@@ -0,0 +1,263 @@
+#include "api_budget.h"
+#include <string.h>
+
+// ==================== TOKEN BUCKET ====================
+
+void TokenBucket::reset(uint32_t cap, uint32_t period, uint32_t nowMs) {
+    capacity = cap;
+    periodMs = period;
+    level = cap * 1000;
+    carry = 0;
+    lastMs = nowMs;
+}
+
+void TokenBucket::update(uint32_t nowMs) {
+    credit(nowMs - lastMs);
+    lastMs = nowMs;
+}
+
+void TokenBucket::credit(uint32_t elapsedMs) {
+    uint32_t full = capacity * 1000;
+    if (level >= full) {
+        carry = 0;
+        return;
+    }
+    uint64_t added = (uint64_t)elapsedMs * full + carry;
+    uint64_t gained = added / periodMs;
+    carry = (uint32_t)(added % periodMs);
+    if (gained >= full - level) {
+        level = full;
+        carry = 0;
+    } else {
+        level += (uint32_t)gained;
+    }
+}
+
+void TokenBucket::setMilliTokens(uint32_t value) {
+    level = value < capacity * 1000 ? value : capacity * 1000;
+    carry = 0;
+}
+
+bool TokenBucket::take(uint32_t count, uint32_t keep) {
+    if (level < (count + keep) * 1000) {
+        return false;
+    }
+    level -= count * 1000;
+    return true;
+}
+
+uint32_t TokenBucket::msUntil(uint32_t count) const {
+    uint32_t need = count * 1000;
+    if (level >= need) {
+        return 0;
+    }
+    uint64_t missing = (uint64_t)(need - level) * periodMs - carry;
+    uint64_t full = (uint64_t)capacity * 1000;
+    uint64_t ms = (missing + full - 1) / full;
+    return ms > UINT32_MAX ? UINT32_MAX : (uint32_t)ms;
+}
+
+// ==================== GOVERNOR ====================
+
+// Tokens a request of this kind must leave behind for higher-priority ones
+static uint32_t reserveFor(ApiRequestKind kind, uint32_t capacity) {
+    uint32_t pct = 0;
+    if (kind == API_REQUEST_FORECAST) {
+        pct = API_RESERVE_FORECAST_PCT;
+    } else if (kind == API_REQUEST_AIR_QUALITY) {
+        pct = API_RESERVE_AIR_QUALITY_PCT;
+    }
+    uint32_t reserve = (capacity * pct + 99) / 100;
+    return reserve < capacity ? reserve : capacity - 1;
+}
+
+ApiBudget::ApiBudget() : granted(0), deferred(0), throttled(0) {
+    reset(0);
+}
+
+void ApiBudget::reset(uint32_t nowMs) {
+    minute.reset(API_CALLS_PER_MINUTE, 60000UL, nowMs);
+    day.reset(API_CALLS_PER_DAY, 86400000UL, nowMs);
+    holdStartMs = nowMs;
+    holdMs = 0;
+    backoffLevel = 0;
+}
+
+void ApiBudget::restore(const ApiBudgetState& saved, uint32_t nowMs, uint32_t nowEpoch) {
+    reset(nowMs);
+    if (saved.magic != API_BUDGET_MAGIC || saved.perMinute != API_CALLS_PER_MINUTE ||
+        saved.perDay != API_CALLS_PER_DAY) {
+        return;   // Nothing saved, or for other caps
+    }
+    minute.setMilliTokens(saved.minuteLevel);
+    day.setMilliTokens(saved.dayLevel);
+    backoffLevel = saved.backoffLevel;
+
+    uint32_t hold = saved.holdSeconds;
+    if (saved.savedEpoch != 0 && nowEpoch >= saved.savedEpoch) {
+        uint32_t offline = nowEpoch - saved.savedEpoch;
+        uint32_t creditS = offline < 86400 ? offline : 86400;   // A day refills both buckets
+        minute.credit(creditS * 1000);
+        day.credit(creditS * 1000);
+        hold = hold > offline ? hold - offline : 0;
+    }
+    if (hold > 0) {
+        holdStartMs = nowMs;
+        holdMs = hold * 1000;
+    }
+}
+
+void ApiBudget::save(ApiBudgetState* out, uint32_t nowMs, uint32_t nowEpoch) {
+    minute.update(nowMs);
+    day.update(nowMs);
+    memset(out, 0, sizeof(*out));
+    out->magic = API_BUDGET_MAGIC;
+    out->savedEpoch = nowEpoch;
+    out->minuteLevel = minute.milliTokens();
+    out->dayLevel = day.milliTokens();
+    out->holdSeconds = (holdRemainingMs(nowMs) + 999) / 1000;
+    out->perMinute = API_CALLS_PER_MINUTE;
+    out->perDay = API_CALLS_PER_DAY;
+    out->backoffLevel = backoffLevel;
+}
+
+uint32_t ApiBudget::holdRemainingMs(uint32_t nowMs) {
+    if (holdMs == 0) {
+        return 0;
+    }
+    uint32_t elapsed = nowMs - holdStartMs;
+    if (elapsed >= holdMs) {
+        holdMs = 0;
+        return 0;
+    }
+    return holdMs - elapsed;
+}
+
+uint32_t ApiBudget::waitMs(ApiRequestKind kind, uint32_t nowMs) {
+    minute.update(nowMs);
+    day.update(nowMs);
+    uint32_t wait = holdRemainingMs(nowMs);
+    uint32_t w = minute.msUntil(1 + reserveFor(kind, API_CALLS_PER_MINUTE));
+    if (w > wait) wait = w;
+    w = day.msUntil(1 + reserveFor(kind, API_CALLS_PER_DAY));
+    if (w > wait) wait = w;
+    return wait;
+}
+
+bool ApiBudget::acquire(ApiRequestKind kind, uint32_t nowMs) {
+    if (waitMs(kind, nowMs) != 0) {
+        deferred++;
+        return false;
+    }
+    minute.take(1, 0);
+    day.take(1, 0);
+    granted++;
+    return true;
+}
+
+bool ApiBudget::onResponse(int status, uint32_t retryAfterS, uint32_t nowMs) {
+    if (status != 429 && !(status == 503 && retryAfterS > 0)) {
+        if (status >= 200 && status < 300) {
+            backoffLevel = 0;
+        }
+        return false;
+    }
+
+    uint32_t hold = retryAfterS;
+    if (hold == 0) {
+        // No Retry-After: back off exponentially
+        hold = API_BACKOFF_MIN_S;
+        for (uint8_t i = 0; i < backoffLevel && hold < API_BACKOFF_MAX_S; i++) {
+            hold *= 2;
+        }
+        if (hold > API_BACKOFF_MAX_S) hold = API_BACKOFF_MAX_S;
+        if (backoffLevel < 16) backoffLevel++;
+    }
+    if (hold > API_RETRY_AFTER_MAX_S) {
+        hold = API_RETRY_AFTER_MAX_S;
+    }
+    if (status == 429) {
+        throttled++;
+        minute.update(nowMs);   // So the time before the 429 doesn't refill the drained bucket
+        minute.drain();   // The server's count says this minute is spent, whatever ours says
+    }
+    holdStartMs = nowMs;
+    holdMs = hold * 1000;
+    return true;
+}
+
+ApiBudgetStatus ApiBudget::status(uint32_t nowMs) {
+    minute.update(nowMs);
+    day.update(nowMs);
+    ApiBudgetStatus s;
+    s.minuteRemaining = minute.tokens();
+    s.dayRemaining = day.tokens();
+    s.holdSeconds = (holdRemainingMs(nowMs) + 999) / 1000;
+    s.granted = granted;
+    s.deferred = deferred;
+    s.throttled = throttled;
+    return s;
+}
+
+// ==================== RETRY-AFTER ====================
+
+static bool parseDigits(const char** p, int count, uint32_t* value) {
+    *value = 0;
+    for (int i = 0; i < count; i++) {
+        char c = (*p)[i];
+        if (c < '0' || c > '9') return false;
+        *value = *value * 10 + (uint32_t)(c - '0');
+    }
+    *p += count;
+    return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+uint32_t parseRetryAfter(const char* value, uint32_t nowEpoch) {
+    if (value == nullptr) {
+        return 0;
+    }
+    while (*value == ' ') value++;
+
+    if (*value >= '0' && *value <= '9') {
+        uint64_t seconds = 0;
+        for (; *value >= '0' && *value <= '9'; value++) {
+            seconds = seconds * 10 + (uint64_t)(*value - '0');
+            if (seconds > UINT32_MAX) return UINT32_MAX;
+        }
+        return *value == '\0' || *value == ' ' ? (uint32_t)seconds : 0;
+    }
+
+    // IMF-fixdate: "Sun, 06 Nov 1994 08:49:37 GMT"
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    const char* comma = strchr(value, ',');
+    if (comma == nullptr || comma[1] != ' ' || nowEpoch == 0 || strlen(comma) < 26) {
+        return 0;
+    }
+    const char* p = comma + 2;
+    uint32_t day, year, hour, minute, second, month = 0;
+    if (!parseDigits(&p, 2, &day) || *p++ != ' ') return 0;
+    for (uint32_t m = 0; m < 12; m++) {
+        if (strncmp(p, MONTHS + m * 3, 3) == 0) month = m + 1;
+    }
+    p += 3;
+    if (month == 0 || *p++ != ' ' || !parseDigits(&p, 4, &year) || *p++ != ' ' ||
+        !parseDigits(&p, 2, &hour) || *p++ != ':' || !parseDigits(&p, 2, &minute) || *p++ != ':' ||
+        !parseDigits(&p, 2, &second) || strncmp(p, " GMT", 4) != 0) {
+        return 0;
+    }
+    if (day < 1 || day > 31 || year < 1970 || hour > 23 || minute > 59 || second > 60) {
+        return 0;
+    }
+    int64_t at = (int64_t)daysFromCivil((int32_t)year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return at > (int64_t)nowEpoch ? (uint32_t)(at - nowEpoch < UINT32_MAX ? at - nowEpoch : UINT32_MAX) : 0;
+}
@@ -0,0 +1,110 @@
+#ifndef API_BUDGET_H
+#define API_BUDGET_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Request governor for the OpenWeatherMap plan: token buckets for the
+// per-minute and per-day caps, a hold after 429 (Retry-After, else backoff),
+// and reserves that keep lower-priority request kinds from spending what
+// current conditions need. The state is saved so reboots can't refill the
+// buckets. Times are millis() plus UTC epoch seconds, 0 while the clock is
+// unset. No Arduino dependencies.
+
+#define API_BUDGET_MAGIC 0x41504231u   // "APB1" - bump when the layout changes
+
+enum ApiRequestKind : uint8_t {
+    API_REQUEST_CURRENT = 0,     // Highest priority, never held back by a reserve
+    API_REQUEST_FORECAST,
+    API_REQUEST_AIR_QUALITY,
+    API_REQUEST_KINDS
+};
+
+// What survives a reboot
+struct ApiBudgetState {
+    uint32_t magic;
+    uint32_t savedEpoch;      // 0 = clock unset when saved
+    uint32_t minuteLevel;     // Milli-tokens
+    uint32_t dayLevel;
+    uint32_t holdSeconds;     // Left of a 429 hold when saved
+    uint16_t perMinute;       // Caps the levels belong to
+    uint16_t perDay;
+    uint8_t backoffLevel;
+};
+
+struct ApiBudgetStatus {
+    uint32_t minuteRemaining;   // Whole tokens
+    uint32_t dayRemaining;
+    uint32_t holdSeconds;       // Until a 429 hold ends
+    uint32_t granted;
+    uint32_t deferred;          // Requests the governor held back
+    uint32_t throttled;         // 429 responses
+};
+
+// Refills continuously: capacity tokens per periodMs, exact over any number of updates
+class TokenBucket {
+public:
+    void reset(uint32_t capacity, uint32_t periodMs, uint32_t nowMs);
+    void update(uint32_t nowMs);
+    void credit(uint32_t elapsedMs);    // Time that passed while powered off
+
+    uint32_t tokens() const { return level / 1000; }
+    uint32_t milliTokens() const { return level; }
+    void setMilliTokens(uint32_t value);
+    bool take(uint32_t count, uint32_t keep);   // Only if keep tokens remain afterwards
+    void drain() { level = 0; carry = 0; }
+    uint32_t msUntil(uint32_t count) const;     // Until count tokens are in
+
+private:
+    uint32_t capacity;
+    uint32_t periodMs;
+    uint32_t level;       // Milli-tokens
+    uint32_t carry;       // Refill remainder, in milli-token-ms
+    uint32_t lastMs;
+};
+
+class ApiBudget {
+public:
+    ApiBudget();
+
+    // Full buckets with the config.h caps
+    void reset(uint32_t nowMs);
+
+    // Resume from a saved state. Offline time is credited only when both
+    // epochs are known; otherwise nothing refills and a saved hold restarts in full.
+    void restore(const ApiBudgetState& saved, uint32_t nowMs, uint32_t nowEpoch);
+    void save(ApiBudgetState* out, uint32_t nowMs, uint32_t nowEpoch);
+
+    // 0 when a request of this kind may go now, else how long until it may
+    uint32_t waitMs(ApiRequestKind kind, uint32_t nowMs);
+
+    // Take a token for a request about to be sent; false when it must wait
+    bool acquire(ApiRequestKind kind, uint32_t nowMs);
+
+    // A caller postponed a request after waitMs() said so
+    void defer() { deferred++; }
+
+    // retryAfterS from parseRetryAfter(), 0 if absent. True when a hold started.
+    bool onResponse(int status, uint32_t retryAfterS, uint32_t nowMs);
+
+    ApiBudgetStatus status(uint32_t nowMs);
+
+private:
+    TokenBucket minute;
+    TokenBucket day;
+    uint32_t holdStartMs;
+    uint32_t holdMs;          // 0 = no hold
+    uint8_t backoffLevel;
+    uint32_t granted;
+    uint32_t deferred;
+    uint32_t throttled;
+
+    uint32_t holdRemainingMs(uint32_t nowMs);
+};
+
+// Retry-After as seconds from now: delta-seconds or an IMF-fixdate
+// ("Wed, 21 Oct 2015 07:28:00 GMT", needs nowEpoch). 0 when missing,
+// malformed or in the past.
+uint32_t parseRetryAfter(const char* value, uint32_t nowEpoch);
+
+#endif // API_BUDGET_H
@@ -0,0 +1,107 @@
+#include "backlight.h"
+#include "driver/ledc.h"
+
+// Arduino LEDC channels 0-7 map to the low-speed group on the ESP32-S3
+#define BACKLIGHT_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_LEDC_CHANNEL ((ledc_channel_t)(BACKLIGHT_PWM_CHANNEL % 8))
+
+BacklightManager::BacklightManager() :
+    currentLevel(DEFAULT_BRIGHTNESS),
+    dayPhase(true),
+    fadeInstalled(false),
+    lastScheduleCheck(0),
+    lastHistogramUpdate(0),
+    saveDirty(false),
+    lastOverrideChange(0) {
+}
+
+void BacklightManager::begin() {
+    ledcSetup(BACKLIGHT_PWM_CHANNEL, BACKLIGHT_PWM_FREQ, BACKLIGHT_PWM_BITS);
+    ledcAttachPin(BACKLIGHT_PIN, BACKLIGHT_PWM_CHANNEL);
+    ledcWrite(BACKLIGHT_PWM_CHANNEL, currentLevel);
+
+    // Fade service runs from the LEDC interrupt, no task involvement
+    fadeInstalled = (ledc_fade_func_install(0) == ESP_OK);
+    if (!fadeInstalled) {
+        Serial.println("Backlight: fade service unavailable, using direct writes");
+    }
+
+    prefs.begin("backlight", false);
+    curve.dayLevel = prefs.getUChar("day", DEFAULT_BRIGHTNESS);
+    curve.nightLevel = prefs.getUChar("night", BACKLIGHT_NIGHT_LEVEL);
+
+    lastHistogramUpdate = millis();
+    Serial.printf("Backlight: day level %d, night level %d\n", curve.dayLevel, curve.nightLevel);
+}
+
+void BacklightManager::fadeTo(uint8_t level, uint32_t fadeMs) {
+    if (level == currentLevel) {
+        return;
+    }
+    accountDuty(millis());
+    currentLevel = level;
+
+    if (fadeInstalled) {
+        ledc_set_fade_time_and_start(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL, level, fadeMs, LEDC_FADE_NO_WAIT);
+    } else {
+        ledcWrite(BACKLIGHT_PWM_CHANNEL, level);
+    }
+}
+
+void BacklightManager::accountDuty(unsigned long nowMs) {
+    histogram.add(currentLevel, nowMs - lastHistogramUpdate);
+    lastHistogramUpdate = nowMs;
+}
+
+void BacklightManager::service(time_t now, time_t sunrise, time_t sunset) {
+    unsigned long nowMs = millis();
+
+    if (saveDirty && nowMs - lastOverrideChange >= BACKLIGHT_SAVE_DELAY_MS) {
+        saveLevels();
+    }
+
+    if (nowMs - lastScheduleCheck < BACKLIGHT_SCHEDULE_MS && lastScheduleCheck != 0) {
+        return;
+    }
+    lastScheduleCheck = nowMs;
+
+    dayPhase = backlightDaylightFactor(curve, now, sunrise, sunset) >= 128;
+    fadeTo(backlightScheduledLevel(curve, now, sunrise, sunset), BACKLIGHT_SCHEDULE_FADE_MS);
+    accountDuty(nowMs);
+}
+
+void BacklightManager::adjust(int delta) {
+    int level = constrain((int)currentLevel + delta, BACKLIGHT_MIN_LEVEL, 255);
+    if (level == currentLevel) {
+        return;
+    }
+
+    // The override becomes the new level for whichever phase we are in
+    if (dayPhase) {
+        curve.dayLevel = level;
+    } else {
+        curve.nightLevel = level;
+    }
+    fadeTo(level, BACKLIGHT_BUTTON_FADE_MS);
+
+    saveDirty = true;
+    lastOverrideChange = millis();
+}
+
+void BacklightManager::saveLevels() {
+    // putUChar skips the flash write when the stored value is unchanged
+    prefs.putUChar("day", curve.dayLevel);
+    prefs.putUChar("night", curve.nightLevel);
+    saveDirty = false;
+    Serial.printf("Backlight: saved day level %d, night level %d\n", curve.dayLevel, curve.nightLevel);
+}
+
+void BacklightManager::reportStats() {
+    accountDuty(millis());
+    Serial.printf("Backlight: level=%d, mean duty=%d/255 over %lus, histogram(%%):",
+                 currentLevel, histogram.meanDuty(), (unsigned long)(histogram.totalMs() / 1000));
+    for (int i = 0; i < BACKLIGHT_HISTOGRAM_BINS; i++) {
+        Serial.printf(" %d", histogram.binPercent(i));
+    }
+    Serial.println();
+}
@@ -0,0 +1,50 @@
+#ifndef BACKLIGHT_H
+#define BACKLIGHT_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+#include "backlight_schedule.h"
+
+// Backlight manager - drives the LEDC hardware fade engine so level changes are
+// smooth and cost no CPU, follows a sunrise/sunset dimming curve and persists
+// the user's day/night levels in NVS.
+class BacklightManager {
+public:
+    BacklightManager();
+
+    // Configure PWM, install the fade service and restore saved levels
+    void begin();
+
+    // Re-evaluate the curve, flush coalesced writes and account duty time.
+    // Call from loop(); cheap when nothing is due.
+    void service(time_t now, time_t sunrise, time_t sunset);
+
+    // User override from the buttons - adjusts the level of the current phase (day or night)
+    void adjust(int delta);
+
+    uint8_t getLevel() const { return currentLevel; }
+    void reportStats();
+
+private:
+    Preferences prefs;
+    BacklightCurve curve;
+    DutyHistogram histogram;
+
+    uint8_t currentLevel;
+    bool dayPhase;
+    bool fadeInstalled;
+
+    unsigned long lastScheduleCheck;
+    unsigned long lastHistogramUpdate;
+
+    // Write coalescing - button bursts end up as a single NVS write
+    bool saveDirty;
+    unsigned long lastOverrideChange;
+
+    void fadeTo(uint8_t level, uint32_t fadeMs);
+    void accountDuty(unsigned long nowMs);
+    void saveLevels();
+};
+
+#endif // BACKLIGHT_H
@@ -0,0 +1,80 @@
+#include "backlight_schedule.h"
+#include <string.h>
+
+static const int32_t SECONDS_PER_DAY = 86400;
+static const time_t MIN_VALID_EPOCH = 1000000000;  // Sep 2001 - anything earlier means no NTP yet
+
+// Signed difference a - b folded into (-12h, +12h]
+static int32_t circularDiff(int32_t a, int32_t b) {
+    int32_t d = (a - b) % SECONDS_PER_DAY;
+    if (d <= -SECONDS_PER_DAY / 2) d += SECONDS_PER_DAY;
+    if (d > SECONDS_PER_DAY / 2) d -= SECONDS_PER_DAY;
+    return d;
+}
+
+static int32_t secondOfDay(time_t t) {
+    return (int32_t)(t % SECONDS_PER_DAY);
+}
+
+uint16_t backlightDaylightFactor(const BacklightCurve& curve, time_t now, time_t sunrise, time_t sunset) {
+    if (now < MIN_VALID_EPOCH || sunrise <= 0 || sunset <= 0) {
+        return 256;
+    }
+
+    int32_t t = secondOfDay(now);
+    int32_t rise = secondOfDay(sunrise);
+    int32_t set = secondOfDay(sunset);
+    int32_t half = (int32_t)curve.twilightMinutes * 30;  // Half ramp in seconds
+
+    if (half > 0) {
+        // Morning ramp: night -> day across [sunrise - half, sunrise + half]
+        int32_t dRise = circularDiff(t, rise);
+        if (dRise >= -half && dRise <= half) {
+            return (uint16_t)(((int64_t)(dRise + half) * 256) / (2 * half));
+        }
+
+        // Evening ramp: day -> night across [sunset - half, sunset + half]
+        int32_t dSet = circularDiff(t, set);
+        if (dSet >= -half && dSet <= half) {
+            return (uint16_t)(256 - ((int64_t)(dSet + half) * 256) / (2 * half));
+        }
+    }
+
+    // Outside the ramps: day if we are between sunrise and sunset (wrapping past midnight UTC)
+    int32_t sinceRise = (t - rise + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+    int32_t dayLength = (set - rise + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+    return sinceRise < dayLength ? 256 : 0;
+}
+
+uint8_t backlightScheduledLevel(const BacklightCurve& curve, time_t now, time_t sunrise, time_t sunset) {
+    uint16_t factor = backlightDaylightFactor(curve, now, sunrise, sunset);
+    int32_t span = (int32_t)curve.dayLevel - (int32_t)curve.nightLevel;
+    return (uint8_t)(curve.nightLevel + (span * (int32_t)factor) / 256);
+}
+
+DutyHistogram::DutyHistogram() {
+    reset();
+}
+
+void DutyHistogram::reset() {
+    memset(bins, 0, sizeof(bins));
+    total = 0;
+    weightedDuty = 0;
+}
+
+void DutyHistogram::add(uint8_t duty, uint32_t elapsedMs) {
+    int bin = (duty * BACKLIGHT_HISTOGRAM_BINS) / 256;
+    bins[bin] += elapsedMs;
+    total += elapsedMs;
+    weightedDuty += (uint64_t)duty * elapsedMs;
+}
+
+uint8_t DutyHistogram::meanDuty() const {
+    if (total == 0) return 0;
+    return (uint8_t)(weightedDuty / total);
+}
+
+uint8_t DutyHistogram::binPercent(int bin) const {
+    if (total == 0 || bin < 0 || bin >= BACKLIGHT_HISTOGRAM_BINS) return 0;
+    return (uint8_t)((bins[bin] * 100) / total);
+}
@@ -0,0 +1,49 @@
+#ifndef BACKLIGHT_SCHEDULE_H
+#define BACKLIGHT_SCHEDULE_H
+
+#include <stdint.h>
+#include <time.h>
+#include "config.h"
+
+// Pure schedule/curve logic for the backlight - no Arduino dependencies so it
+// can be compiled and exercised on the host.
+
+// ==================== DIMMING CURVE ====================
+struct BacklightCurve {
+    uint8_t dayLevel;          // Duty between sunrise and sunset ramps
+    uint8_t nightLevel;        // Duty between sunset and sunrise ramps
+    uint16_t twilightMinutes;  // Ramp length centered on sunrise/sunset
+
+    BacklightCurve(uint8_t day = DEFAULT_BRIGHTNESS, uint8_t night = BACKLIGHT_NIGHT_LEVEL,
+                   uint16_t twilight = BACKLIGHT_TWILIGHT_MINUTES)
+        : dayLevel(day), nightLevel(night), twilightMinutes(twilight) {}
+};
+
+// Daylight factor in 1/256 steps: 0 = full night, 256 = full day.
+// Returns full day when sunrise/sunset are unknown (0) or the clock is not set.
+uint16_t backlightDaylightFactor(const BacklightCurve& curve, time_t now, time_t sunrise, time_t sunset);
+
+// Target duty for the given moment, blending nightLevel -> dayLevel by the daylight factor
+uint8_t backlightScheduledLevel(const BacklightCurve& curve, time_t now, time_t sunrise, time_t sunset);
+
+// ==================== DUTY HISTOGRAM ====================
+// Time-weighted histogram of PWM duty since boot, used for backlight power
+// estimates. 64-bit so it doesn't wrap after 49.7 days.
+class DutyHistogram {
+public:
+    DutyHistogram();
+
+    void add(uint8_t duty, uint32_t elapsedMs);
+    void reset();
+
+    uint64_t totalMs() const { return total; }
+    uint8_t meanDuty() const;
+    uint8_t binPercent(int bin) const;
+
+private:
+    uint64_t bins[BACKLIGHT_HISTOGRAM_BINS];
+    uint64_t total;
+    uint64_t weightedDuty;  // Sum of duty * ms
+};
+
+#endif // BACKLIGHT_SCHEDULE_H
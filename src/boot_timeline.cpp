@@ -0,0 +1,34 @@
+#include "boot_timeline.h"
+#include <stdio.h>
+
+BootTimeline::BootTimeline() : used(0) {
+}
+
+void BootTimeline::add(const char* name, uint32_t startMs, uint32_t endMs) {
+    if (used >= BOOT_TIMELINE_MAX_PHASES) {
+        return;
+    }
+    phases[used].name = name;
+    phases[used].startMs = startMs;
+    phases[used].endMs = endMs < startMs ? startMs : endMs;
+    used++;
+}
+
+size_t BootTimeline::format(char* out, size_t size) const {
+    if (size == 0) {
+        return 0;
+    }
+    size_t len = 0;
+    uint32_t lastEnd = 0;
+    for (uint8_t i = 0; i < used && len < size; i++) {
+        len += snprintf(out + len, size - len, "  %-18s at %6lu ms, %6lu ms\n", phases[i].name,
+                        (unsigned long)phases[i].startMs, (unsigned long)duration(i));
+        if (phases[i].endMs > lastEnd) {
+            lastEnd = phases[i].endMs;
+        }
+    }
+    if (len < size) {
+        len += snprintf(out + len, size - len, "  %-18s    %6lu ms\n", "ready", (unsigned long)lastEnd);
+    }
+    return len < size ? len : size - 1;
+}
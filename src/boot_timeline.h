@@ -0,0 +1,34 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Start and duration of each startup phase, printed once setup() is done.
+// Phase names must be string literals. No Arduino dependencies.
+class BootTimeline {
+public:
+    BootTimeline();
+
+    // A phase that ran from startMs to endMs (millis())
+    void add(const char* name, uint32_t startMs, uint32_t endMs);
+
+    uint8_t count() const { return used; }
+    const char* name(uint8_t i) const { return phases[i].name; }
+    uint32_t duration(uint8_t i) const { return phases[i].endMs - phases[i].startMs; }
+
+    // One line per phase plus the total; returns the length written
+    size_t format(char* out, size_t size) const;
+
+private:
+    struct Phase {
+        const char* name;
+        uint32_t startMs;
+        uint32_t endMs;
+    };
+    Phase phases[BOOT_TIMELINE_MAX_PHASES];
+    uint8_t used;
+};
+
+#endif // BOOT_TIMELINE_H
@@ -10,6 +10,7 @@
 #define POWER_PIN 15
 #define DEFAULT_BRIGHTNESS 215
 #define GRAY_LEVELS 13
+#define TICKER_MESSAGE_SIZE 256  // Per ticker slot, including the terminator
 
 // ==================== WEATHER CONFIGURATION ====================
 #define UPDATE_INTERVAL_MS 180000  // 3 minutes - respects API rate limits
@@ -20,17 +21,249 @@
 #define ANIMATION_START_POSITION 100
 #define TEMPERATURE_HISTORY_SIZE 24
 
+// ==================== TICKER CONFIGURATION ====================
+#define TICKER_QUEUE_SIZE 6                 // Queued messages, at most one per source
+#define TICKER_QUEUE_TEXT_SIZE 128
+#define TICKER_PREPARE_INTERVAL_MS 100      // Pre-render the next message off the frame path
+#define TICKER_ALERT_WIND_KMH 50            // Wind speed that raises a ticker alert
+#define TICKER_ALERT_TTL_MS (UPDATE_INTERVAL_MS * 2)  // Alerts lapse if fetches stop
+#define TICKER_ALERT_REPEATS 2              // Minimum showings of an alert
+#define TICKER_TEMPLATE_SIZE 160            // Literal text of a compiled template (max 255)
+#define TICKER_TEMPLATE_MAX_OPS 24
+#define TICKER_DEFAULT_TEMPLATE "... {desc}, visibility is {vis:1}{vis_unit}, wind of {wind:1}{wind_unit}, last updated at {updated} ..."
+#ifndef TICKER_TEMPLATE                     // Override with -DTICKER_TEMPLATE='"..."'
+#define TICKER_TEMPLATE TICKER_DEFAULT_TEMPLATE
+#endif
+
+// ==================== ICON CONFIGURATION ====================
+#define ICON_DRAW_SIZE 40                   // Conditions icon beside sunrise/sunset (px)
+#define ICON_CACHE_SLOTS 4                  // Scaled variants kept (LRU)
+#define ICON_CACHE_MAX_SIZE 48              // Largest cacheable size; slots are preallocated
+
+// ==================== ANIMATION CONFIGURATION ====================
+#define TWEEN_MAX_CHANNELS 12               // Preallocated tweens, one per animated value
+#define TWEEN_VALUE_MS 500                  // Count-up of temperature and box values after a fetch
+#define TWEEN_ICON_MS 400                   // Icon cross-fade
+#define TWEEN_TICKER_MS 250                 // Ticker slide-in on a message swap
+#define FRAME_BUDGET_US (RENDER_INTERVAL_MS * 1000)  // Frame-cost ceiling reported by the display
+
+// ==================== PAGE CONFIGURATION ====================
+#define PAGE_TRANSITION_MS 300              // Slide/fade between pages
+#define PAGE_AUTO_ADVANCE_MS 0              // Rotate pages on a timer; 0 = buttons only
+#define PAGE_RETURN_MS 60000                // Back to current conditions after this long without input
+#define PAGE_REFRESH_MS 1000                // Redraw cadence of the secondary pages
+#define PAGE_FADE_BAND_ROWS 10              // Rows blended per push during a fade
+
+// ==================== SCHEDULER CONFIGURATION ====================
+#define RENDER_INTERVAL_MS 25          // 40 FPS display refresh
+#define INPUT_POLL_INTERVAL_MS 20      // Button polling and backlight service
+#define STATS_INTERVAL_MS 30000        // Heap and task accounting report
+#define TIME_SYNC_INTERVAL_MS (UPDATE_INTERVAL_MS * SYNC_INTERVAL_UPDATES)
+#define SCHEDULER_MAX_TASKS 12         // setup() registers 8; a full table is logged at boot
+#define SCHEDULER_WHEEL_BITS 6         // 64 slots per wheel level
+#define SCHEDULER_WHEEL_LEVELS 4       // 1 ms ticks, 64^4 ms (~4.6 h) direct range
+
+// ==================== DIAGNOSTICS CONFIGURATION ====================
+#define PERF_REPORT_MAX_SECTIONS 10    // Subsystems printing in the 10-second perf report
+#define STALL_THRESHOLD_MS 250         // Heartbeat gap counted as a loop stall
+#define STALL_CHECK_INTERVAL_MS 50     // Watchdog timer sampling period
+#define STALL_LOG_SIZE 16              // Persistent stall records kept in RTC memory
+#define STALL_REPORT_RECENT 3          // Latest stalls listed in the perf report
+#define TASK_STATS_SAMPLE_MS 10000     // FreeRTOS task sampling period
+#define TASK_STATS_MAX_TASKS 20        // Must cover every task or the snapshot fails
+#define TASK_STATS_RING_SIZE 4         // Snapshot intervals kept
+#define TASK_STATS_CORES 2
+#define TASK_STACK_ALERT_BYTES 1024    // Warn when a task's stack headroom drops below this
+#define ALLOC_SCOPE_DEPTH 4            // Nesting depth of allocation-accounting scopes
+#define ALLOC_BUDGET_JSON 8192         // Peak JSON document bytes (exact) for one API response
+
+// ==================== MIRROR CONFIGURATION ====================
+// Streams the screen to tools/mirror_viewer.py for screenshots and remote viewing
+#define MIRROR_OFF 0
+#define MIRROR_SERIAL 1                // Binary packets between serial log lines, at MIRROR_SERIAL_BAUD
+#define MIRROR_TCP 2                   // One viewer at a time on MIRROR_TCP_PORT
+#ifndef MIRROR_TRANSPORT               // Override with -DMIRROR_TRANSPORT=MIRROR_TCP
+#define MIRROR_TRANSPORT MIRROR_OFF
+#endif
+#define MIRROR_TCP_PORT 5005
+#define MIRROR_SERIAL_BAUD 921600      // Serial.begin() rate with MIRROR_SERIAL; the viewer's --baud default
+#define MIRROR_SERIAL_SHARE 75         // Percent of the line per interval a serial packet may fill; the log gets the rest
+#define MIRROR_INTERVAL_MS 100         // Minimum time between mirrored frames
+#define MIRROR_BUFFER_SIZE 16384       // One packet; spans that don't fit go in the next
+#define MIRROR_SPAN_PIXELS 32          // Diff granularity along a scanline
+#define MIRROR_KEYFRAME_PACKETS 600    // Periodic full refresh so a late serial viewer syncs (0 = off)
+#define MIRROR_TASK_STACK 3072
+#define MIRROR_TASK_PRIORITY 1         // Below the WiFi/lwIP tasks
+#define MIRROR_TASK_CORE 0             // Network core; loop() renders on core 1
+
+// ==================== STATUS SERVER CONFIGURATION ====================
+// HTTP on the station: /weather, /metrics, /history, /screenshot
+#ifndef STATUS_SERVER_ENABLED
+#define STATUS_SERVER_ENABLED 1
+#endif
+#define STATUS_HTTP_PORT 80
+#define STATUS_REQUEST_SIZE 512        // Request line and headers; longer headers are ignored
+#define STATUS_RESPONSE_BUFFER 1460    // Flushed to the socket whenever full (one TCP segment)
+#define STATUS_REQUEST_TIMEOUT_MS 2000
+#define STATUS_POLL_MS 50              // Accept polling while idle
+#define STATUS_ERROR_TYPES 4           // ErrorHandler::ErrorType values counted for /metrics
+#define STATUS_TASK_STACK 4096
+#define STATUS_TASK_PRIORITY 1         // Below the WiFi/lwIP tasks
+#define STATUS_TASK_CORE 0             // Network core; loop() renders on core 1
+
+// ==================== TELEMETRY CONFIGURATION ====================
+// MQTT publishing of observations and health, sent in the fetch windows
+#ifndef TELEMETRY_BROKER_HOST          // Empty disables; -DTELEMETRY_BROKER_HOST='"192.168.1.10"'
+#define TELEMETRY_BROKER_HOST ""
+#endif
+#define TELEMETRY_BROKER_PORT 1883
+#ifndef TELEMETRY_USERNAME             // Empty for brokers without authentication
+#define TELEMETRY_USERNAME ""
+#endif
+#ifndef TELEMETRY_PASSWORD
+#define TELEMETRY_PASSWORD ""
+#endif
+#ifndef TELEMETRY_STATION              // MQTT client id and topic level
+#define TELEMETRY_STATION "weather-station"
+#endif
+#define TELEMETRY_TOPIC_PREFIX "weather/"   // Topic: weather/<station>/telemetry
+#define TELEMETRY_FORMAT_VERSION 1
+#define TELEMETRY_QUEUE_SIZE 48        // Samples kept while the broker is unreachable
+#define TELEMETRY_MAX_VALUES 6
+#define TELEMETRY_BATCH_SAMPLES 16     // Samples per PUBLISH
+#define TELEMETRY_PAYLOAD_SIZE 768     // Holds a full batch (TELEMETRY_SAMPLE_MAX_BYTES each)
+#define TELEMETRY_MAX_BATCHES 6        // Per window, so a backlog can't hold the link for long
+#define TELEMETRY_TIMEOUT_MS 2000      // Connect, CONNACK and each PUBACK
+#define TELEMETRY_KEEPALIVE_S 30
+#define TELEMETRY_TASK_STACK 4096
+#define TELEMETRY_TASK_PRIORITY 1      // Below the WiFi/lwIP tasks
+#define TELEMETRY_TASK_CORE 0          // Network core; loop() renders on core 1
+
+// ==================== WIFI JOIN CONFIGURATION ====================
+// The last access point, channel and DHCP lease are cached in NVS for a fast rejoin
+#ifndef WIFI_STATIC_IP                 // Empty uses DHCP; -DWIFI_STATIC_IP='"192.168.1.50"'
+#define WIFI_STATIC_IP ""
+#endif
+#ifndef WIFI_STATIC_GATEWAY
+#define WIFI_STATIC_GATEWAY ""
+#endif
+#ifndef WIFI_STATIC_SUBNET
+#define WIFI_STATIC_SUBNET "255.255.255.0"
+#endif
+#ifndef WIFI_STATIC_DNS                // Empty uses the gateway
+#define WIFI_STATIC_DNS ""
+#endif
+#ifndef WIFI_REUSE_LEASE               // 1 skips DHCP on the cached access point while the lease is fresh.
+#define WIFI_REUSE_LEASE 0             // The address is then held like a static one and never renewed
+#endif                                 // until the next reconnect, so only for routers with reservations
+#define WIFI_LEASE_REUSE_S (4 * 3600)  // Well inside typical 12-24 h leases
+#define WIFI_LEASE_REFRESH_S 3600      // Renewed leases are rewritten to flash at most this often
+#define WIFI_CACHE_MAX_FAILURES 2      // Failed fast joins before the cached access point is forgotten
+#define WIFI_FAST_JOIN_TIMEOUT_MS 4000 // Then fall back to a scan
+#define WIFI_JOIN_TIMEOUT_MS 30000     // After a scan; the station restarts when this fails
+#define WIFI_JOIN_POLL_MS 10
+#define WIFI_SCAN_MS_PER_CHANNEL 120   // Active scan dwell time
+#define BOOT_TIMELINE_MAX_PHASES 10
+
+// ==================== WIFI MANAGER CONFIGURATION ====================
+// Background reconnection and roaming across WIFI_SSID, WIFI_SSID_2 and WIFI_SSID_3
+#define WIFI_MAX_NETWORKS 3
+#define WIFI_MAX_CANDIDATES 4          // Access points tried per round, best first
+#define WIFI_RECONNECT_DELAY_MS 500    // After a drop, before retrying the same access point
+#define WIFI_BACKOFF_MIN_MS 2000       // Between failed rounds, doubling...
+#define WIFI_BACKOFF_MAX_MS 60000      // ...up to this
+#define WIFI_CONNECT_TIMEOUT_MS 10000  // Per attempt, association through DHCP
+#define WIFI_SCAN_TIMEOUT_MS 8000
+#define WIFI_FAILURE_PENALTY_DB 8      // Ranking: per recent failure (up to 4)...
+#define WIFI_PREFERRED_BONUS_DB 5      // ...and for the network that last worked
+#define WIFI_ROAM_RSSI_DBM -75         // Look for a better access point below this
+#define WIFI_ROAM_WEAK_SAMPLES 2       // Consecutive weak samples before a roam scan
+#define WIFI_ROAM_SCAN_INTERVAL_MS 300000
+#define WIFI_ROAM_HYSTERESIS_DB 8      // A roam target must be this much better
+#define WIFI_RSSI_SAMPLE_MS 30000
+#define WIFI_RSSI_HISTORY 120          // One hour of samples
+#define WIFI_EVENT_QUEUE 8
+#define WIFI_MANAGER_TICK_MS 200
+#define WIFI_LINK_CHECK_MS 500         // Loop-side check for link changes
+#define WIFI_FETCH_AFTER_RECONNECT_MS 2000   // Catch up on a fetch missed while offline
+#define WIFI_TASK_STACK 3072
+#define WIFI_TASK_PRIORITY 1           // Below the WiFi/lwIP tasks
+#define WIFI_TASK_CORE 0               // Network core; loop() renders on core 1
+
+// ==================== DNS CONFIGURATION ====================
+// Resolver cache for the API host, refreshed in the background before each fetch
+#define DNS_CACHE_ENTRIES 4
+#define DNS_HOST_MAX 64                // Longest cached host name, with terminator
+#define DNS_MIN_TTL_S 30               // Server TTLs are clamped: ask at most this often...
+#define DNS_MAX_TTL_S 3600             // ...and at least this often
+#define DNS_STALE_MAX_S 86400          // Fall back to an expired address this long when DNS fails
+#define DNS_TIMEOUT_MS 1500            // Per query
+#define DNS_ATTEMPTS 2                 // Per server, DHCP primary then secondary
+#define DNS_PREFETCH_LEAD_MS 10000     // Refresh this long before a scheduled fetch
+#ifndef DNS_SERVER
+#define DNS_SERVER ""                  // Overrides the DHCP servers, e.g. "192.168.1.10"
+#endif
+#define DNS_TASK_STACK 3072
+#define DNS_TASK_PRIORITY 1
+#define DNS_TASK_CORE 0
+
+// ==================== FETCH STATS CONFIGURATION ====================
+// Per-fetch latency breakdown in the perf report
+#define FETCH_HISTORY 16               // Recent fetches kept phase by phase (24 bytes each)
+#define FETCH_HISTOGRAM_BUCKETS 12     // 5 ms .. 10 s in 1-2-5 steps, then everything slower
+#define FETCH_HISTOGRAM_WINDOW 20      // Histograms cover the last 20-40 fetches (1-2 hours)
+#define FETCH_STATUS_SLOTS 8           // Distinct HTTP status codes counted separately
+
+// ==================== API BUDGET CONFIGURATION ====================
+// OpenWeatherMap plan limits, enforced on the station's side and kept across reboots
+#ifndef API_CALLS_PER_MINUTE
+#define API_CALLS_PER_MINUTE 60
+#endif
+#ifndef API_CALLS_PER_DAY
+#define API_CALLS_PER_DAY 1000
+#endif
+#define API_RESERVE_FORECAST_PCT 10      // Left for current conditions before a forecast may go...
+#define API_RESERVE_AIR_QUALITY_PCT 25   // ...and before an air quality request may
+#define API_BACKOFF_MIN_S 60             // 429 without Retry-After: hold this long, doubling...
+#define API_BACKOFF_MAX_S 3600           // ...up to this
+#define API_RETRY_AFTER_MAX_S 86400      // Longest Retry-After honoured (a daily cap resets within a day)
+
+// ==================== SOLAR CONFIGURATION ====================
+#define SOLAR_MIN_EPOCH 1577836800     // Clock not yet synced before 2020-01-01
+#define SOLAR_LOCATION_SAVE_E4 100     // Re-save cached coordinates after a 0.01 degree move
+
+// ==================== UNITS CONFIGURATION ====================
+// Display units: "metric", "imperial" or "mixed" (C, mph, miles).
+// Empty follows OPENWEATHERMAP_UNITS from secrets.h.
+#define DISPLAY_UNITS ""
+
 // ==================== NETWORK CONFIGURATION ====================
 #define NTP_SERVER "pool.ntp.org"
 #define GMT_OFFSET_SEC -5 * 3600   // UTC-5 (Eastern Standard Time)
 #define DAYLIGHT_OFFSET_SEC 3600  // +1 hour for Daylight Saving Time
+#define TIMEZONE_TZ "EST5EDT,M3.2.0/2,M11.1.0/2"  // POSIX TZ rules for local time display
 #define WIFI_TIMEOUT_MS 5000
 
 // ==================== BUTTON CONFIGURATION ====================
 #define BUTTON_BOOT 0      // GPIO0 - Boot button (brightness down - bottom button)
 #define BUTTON_KEY 14      // GPIO14 - Key button (brightness up - top button)
 #define BRIGHTNESS_STEP 25 // Step size for brightness changes
-#define BUTTON_DEBOUNCE_MS 200  // Debounce delay
+#define BUTTON_DEBOUNCE_MS 200  // Debounce delay, also the brightness repeat rate while held
+#define BUTTON_CLICK_MIN_MS 30   // Shorter presses are contact bounce
+#define BUTTON_HOLD_MS 500       // Click switches pages, holding adjusts brightness
+
+// ==================== BACKLIGHT CONFIGURATION ====================
+#define BACKLIGHT_PWM_CHANNEL 0
+#define BACKLIGHT_PWM_FREQ 10000
+#define BACKLIGHT_PWM_BITS 8
+#define BACKLIGHT_MIN_LEVEL 10          // Keep display visible at the bottom of the range
+#define BACKLIGHT_NIGHT_LEVEL 40        // Default curve level between dusk and dawn
+#define BACKLIGHT_TWILIGHT_MINUTES 45   // Ramp length centered on sunrise/sunset
+#define BACKLIGHT_BUTTON_FADE_MS 150    // Hardware fade for button steps
+#define BACKLIGHT_SCHEDULE_FADE_MS 2000 // Hardware fade for curve changes
+#define BACKLIGHT_SCHEDULE_MS 60000     // Re-evaluate the curve every minute
+#define BACKLIGHT_SAVE_DELAY_MS 10000   // Coalesce override writes to flash
+#define BACKLIGHT_HISTOGRAM_BINS 8      // PWM duty histogram resolution
 
 // ==================== DISPLAY COLORS ====================
 #define TFT_BLACK 0x0000
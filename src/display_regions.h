@@ -0,0 +1,47 @@
+#ifndef DISPLAY_REGIONS_H
+#define DISPLAY_REGIONS_H
+
+#include <stdint.h>
+
+// Screen areas the renderer can redraw and push on their own. Everything
+// outside them (dividers, headers, city) only changes on a full redraw.
+// Rectangles must not overlap each other or that static content.
+
+enum DisplayRegion : uint8_t {
+    REGION_TEMP = 0,     // Big temperature and unit, left panel
+    REGION_CLOCK,        // HH:MM and seconds box
+    REGION_SUN,          // Sunrise/sunset text and conditions icon
+    REGION_BOX0,         // Value boxes, top row left to right...
+    REGION_BOX1,
+    REGION_BOX2,
+    REGION_BOX3,         // ...then bottom row
+    REGION_BOX4,
+    REGION_BOX5,
+    REGION_TICKER,       // Conditions header, update counter and scrolling strip
+    REGION_COUNT
+};
+
+#define REGION_BIT(region) (1UL << (region))
+#define REGION_ALL_BITS ((1UL << REGION_COUNT) - 1)
+
+struct RegionRect {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+};
+
+static const RegionRect DISPLAY_REGIONS[REGION_COUNT] = {
+    {0, 40, 137, 67},     // REGION_TEMP - between the header and the left divider
+    {0, 130, 137, 40},    // REGION_CLOCK
+    {140, 0, 180, 52},    // REGION_SUN - above the boxes
+    {144, 53, 54, 32},
+    {204, 53, 54, 32},
+    {264, 53, 54, 32},
+    {144, 93, 54, 32},
+    {204, 93, 54, 32},
+    {264, 93, 54, 32},
+    {140, 132, 180, 38},  // REGION_TICKER
+};
+
+#endif // DISPLAY_REGIONS_H
@@ -0,0 +1,75 @@
+#include "dns_cache.h"
+#include <string.h>
+#include <strings.h>
+
+DnsCache::DnsCache() {
+    clear();
+}
+
+void DnsCache::clear() {
+    memset(entries, 0, sizeof(entries));
+    useCounter = 0;
+}
+
+int DnsCache::find(const char* host) const {
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        if (entries[i].host[0] != '\0' && strcasecmp(entries[i].host, host) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool DnsCache::lookup(const char* host, uint32_t now, uint32_t* address) {
+    int i = find(host);
+    if (i < 0 || now - entries[i].storedAt >= entries[i].ttlMs) {
+        return false;
+    }
+    entries[i].lastUse = ++useCounter;
+    *address = entries[i].address;
+    return true;
+}
+
+bool DnsCache::lastKnownGood(const char* host, uint32_t now, uint32_t* address) {
+    int i = find(host);
+    if (i < 0 || now - entries[i].storedAt >= entries[i].ttlMs + (uint32_t)DNS_STALE_MAX_S * 1000) {
+        return false;
+    }
+    entries[i].lastUse = ++useCounter;
+    *address = entries[i].address;
+    return true;
+}
+
+bool DnsCache::store(const char* host, uint32_t address, uint32_t ttlSeconds, uint32_t now) {
+    if (strlen(host) >= DNS_HOST_MAX || address == 0) {
+        return false;
+    }
+    if (ttlSeconds < DNS_MIN_TTL_S) ttlSeconds = DNS_MIN_TTL_S;
+    if (ttlSeconds > DNS_MAX_TTL_S) ttlSeconds = DNS_MAX_TTL_S;
+
+    int i = find(host);
+    if (i < 0) {
+        // Free slot, else the one used longest ago
+        i = 0;
+        for (int j = 0; j < DNS_CACHE_ENTRIES; j++) {
+            if (entries[j].host[0] == '\0') {
+                i = j;
+                break;
+            }
+            if (entries[j].lastUse < entries[i].lastUse) {
+                i = j;
+            }
+        }
+        strcpy(entries[i].host, host);
+    }
+    entries[i].address = address;
+    entries[i].storedAt = now;
+    entries[i].ttlMs = ttlSeconds * 1000;
+    entries[i].lastUse = ++useCounter;
+    return true;
+}
+
+bool DnsCache::needsRefresh(const char* host, uint32_t now, uint32_t withinMs) const {
+    int i = find(host);
+    return i < 0 || now - entries[i].storedAt + withinMs >= entries[i].ttlMs;
+}
@@ -0,0 +1,56 @@
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Resolved addresses with their TTLs, keyed by host name (case-insensitive).
+// An entry stays usable as the last known-good address for DNS_STALE_MAX_S
+// after it expires. Times are millis(); addresses are in IPAddress order.
+// No Arduino dependencies.
+
+struct DnsCacheEntry {
+    char host[DNS_HOST_MAX];     // Empty when unused
+    uint32_t address;
+    uint32_t storedAt;
+    uint32_t ttlMs;
+    uint32_t lastUse;            // Use counter, for least-recently-used replacement
+};
+
+// Resolver counters since boot
+struct DnsStats {
+    uint32_t hits;           // Answered from the cache
+    uint32_t queries;        // Sent to a server (fetch or prefetch) and answered
+    uint32_t prefetches;     // Of those, refreshed ahead of a fetch
+    uint32_t fallbacks;      // DNS failed, last known-good address used
+    uint32_t failures;       // DNS failed with nothing to fall back on
+    uint32_t lastQueryMs;
+    uint32_t maxQueryMs;
+};
+
+class DnsCache {
+public:
+    DnsCache();
+
+    // Address still within its TTL
+    bool lookup(const char* host, uint32_t now, uint32_t* address);
+
+    // Expired address still inside the stale window, for when DNS fails
+    bool lastKnownGood(const char* host, uint32_t now, uint32_t* address);
+
+    // ttlSeconds is clamped to DNS_MIN_TTL_S..DNS_MAX_TTL_S; false if host is too long
+    bool store(const char* host, uint32_t address, uint32_t ttlSeconds, uint32_t now);
+
+    // True if the entry is missing or expires within withinMs from now
+    bool needsRefresh(const char* host, uint32_t now, uint32_t withinMs) const;
+
+    void clear();
+
+private:
+    DnsCacheEntry entries[DNS_CACHE_ENTRIES];
+    uint32_t useCounter;
+
+    int find(const char* host) const;
+};
+
+#endif // DNS_CACHE_H
@@ -0,0 +1,163 @@
+#include "dns_message.h"
+#include <string.h>
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return ((uint32_t)get16(p) << 16) | get16(p + 2);
+}
+
+static char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+size_t dnsBuildQuery(uint16_t id, const char* host, uint8_t* out, size_t size) {
+    size_t hostLen = strlen(host);
+    if (hostLen == 0 || hostLen > 253 || size < 12 + hostLen + 2 + 4) {
+        return 0;
+    }
+    memset(out, 0, 12);
+    out[0] = (uint8_t)(id >> 8);
+    out[1] = (uint8_t)id;
+    out[2] = 0x01;   // RD: the server resolves recursively
+    out[5] = 1;      // One question
+
+    size_t pos = 12;
+    const char* label = host;
+    while (*label) {
+        const char* dot = strchr(label, '.');
+        size_t len = dot != nullptr ? (size_t)(dot - label) : strlen(label);
+        if (len == 0 || len > 63) {
+            return 0;
+        }
+        out[pos++] = (uint8_t)len;
+        memcpy(out + pos, label, len);
+        pos += len;
+        label += len + (dot != nullptr ? 1 : 0);
+        if (dot != nullptr && *label == '\0') {
+            break;   // Trailing dot
+        }
+    }
+    out[pos++] = 0;
+    out[pos++] = 0;
+    out[pos++] = 1;   // QTYPE A
+    out[pos++] = 0;
+    out[pos++] = 1;   // QCLASS IN
+    return pos;
+}
+
+// Advance past a possibly compressed name; 0 when it runs off the message
+static size_t skipName(const uint8_t* msg, size_t len, size_t pos) {
+    while (pos < len) {
+        uint8_t n = msg[pos];
+        if (n == 0) {
+            return pos + 1;
+        }
+        if ((n & 0xC0) == 0xC0) {
+            return pos + 2 <= len ? pos + 2 : 0;
+        }
+        if (n & 0xC0) {
+            return 0;   // Reserved label types
+        }
+        pos += 1 + n;
+    }
+    return 0;
+}
+
+// Compare the (uncompressed) question name against host, ignoring case
+static bool questionMatches(const uint8_t* msg, size_t len, size_t pos, const char* host) {
+    const char* h = host;
+    while (pos < len && msg[pos] != 0) {
+        uint8_t n = msg[pos++];
+        if ((n & 0xC0) || pos + n > len) {
+            return false;
+        }
+        if (h != host) {
+            if (*h++ != '.') return false;
+        }
+        for (uint8_t i = 0; i < n; i++) {
+            if (*h == '\0' || lower(*h++) != lower((char)msg[pos + i])) return false;
+        }
+        pos += n;
+    }
+    if (*h == '.') {
+        h++;
+    }
+    return pos < len && *h == '\0';
+}
+
+DnsResult dnsParseResponse(const uint8_t* msg, size_t len, uint16_t id, const char* host,
+                           uint32_t* address, uint32_t* ttlSeconds) {
+    if (len < 12) {
+        return DNS_MALFORMED;
+    }
+    if (get16(msg) != id || !(msg[2] & 0x80) || get16(msg + 4) != 1) {
+        return DNS_MISMATCH;
+    }
+    if (!questionMatches(msg, len, 12, host)) {
+        return DNS_MISMATCH;
+    }
+    if (msg[2] & 0x02) {
+        return DNS_TRUNCATED;
+    }
+    uint8_t rcode = msg[3] & 0x0F;
+    if (rcode == 3) {
+        return DNS_NXDOMAIN;
+    }
+    if (rcode != 0) {
+        return DNS_SERVER_ERROR;
+    }
+
+    size_t pos = skipName(msg, len, 12);
+    if (pos == 0 || pos + 4 > len) {
+        return DNS_MALFORMED;
+    }
+    pos += 4;
+
+    uint16_t answers = get16(msg + 6);
+    uint32_t ttl = UINT32_MAX;
+    for (uint16_t i = 0; i < answers; i++) {
+        pos = skipName(msg, len, pos);
+        if (pos == 0 || pos + 10 > len) {
+            return DNS_MALFORMED;
+        }
+        uint16_t type = get16(msg + pos);
+        uint16_t cls = get16(msg + pos + 2);
+        uint32_t recordTtl = get32(msg + pos + 4);
+        if (recordTtl & 0x80000000u) {
+            recordTtl = 0;   // RFC 2181: treat TTLs with the top bit set as zero
+        }
+        uint16_t rdLength = get16(msg + pos + 8);
+        pos += 10;
+        if (pos + rdLength > len) {
+            return DNS_MALFORMED;
+        }
+        if (cls == 1 && (type == 1 || type == 5)) {
+            // CNAMEs in the chain bound how long the address stays valid too
+            if (recordTtl < ttl) ttl = recordTtl;
+            if (type == 1 && rdLength == 4) {
+                const uint8_t* a = msg + pos;
+                *address = (uint32_t)a[0] | ((uint32_t)a[1] << 8) | ((uint32_t)a[2] << 16) | ((uint32_t)a[3] << 24);
+                *ttlSeconds = ttl;
+                return DNS_OK;
+            }
+        }
+        pos += rdLength;
+    }
+    return DNS_NO_ADDRESS;
+}
+
+const char* dnsResultName(DnsResult result) {
+    switch (result) {
+        case DNS_OK: return "ok";
+        case DNS_MISMATCH: return "mismatch";
+        case DNS_MALFORMED: return "malformed";
+        case DNS_TRUNCATED: return "truncated";
+        case DNS_NXDOMAIN: return "nxdomain";
+        case DNS_SERVER_ERROR: return "server error";
+        case DNS_NO_ADDRESS: return "no address";
+        default: return "?";
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef DNS_MESSAGE_H
+#define DNS_MESSAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal DNS client messages: one A question out, the first address and
+// the smallest TTL on the way to it back. Addresses are in IPAddress
+// order (first octet in the low byte). No Arduino dependencies.
+
+#define DNS_PORT 53
+#define DNS_MESSAGE_MAX 512            // Plain UDP DNS
+
+enum DnsResult : uint8_t {
+    DNS_OK = 0,
+    DNS_MISMATCH,       // Not the answer to our question (id or name); keep waiting
+    DNS_MALFORMED,
+    DNS_TRUNCATED,
+    DNS_NXDOMAIN,
+    DNS_SERVER_ERROR,   // Any other non-zero rcode
+    DNS_NO_ADDRESS      // Valid answer without an A record
+};
+
+// A query for host's A record; 0 if the name is invalid or doesn't fit
+size_t dnsBuildQuery(uint16_t id, const char* host, uint8_t* out, size_t size);
+
+// Parse a response to dnsBuildQuery(id, host). ttlSeconds covers every
+// record in the CNAME chain that led to the address.
+DnsResult dnsParseResponse(const uint8_t* msg, size_t len, uint16_t id, const char* host,
+                           uint32_t* address, uint32_t* ttlSeconds);
+
+const char* dnsResultName(DnsResult result);
+
+#endif // DNS_MESSAGE_H
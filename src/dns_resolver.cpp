@@ -0,0 +1,204 @@
+#include "dns_resolver.h"
+#include <WiFiUdp.h>
+#include "dns_message.h"
+#include "wifi_cache.h"
+
+DnsCache DnsResolver::cache;
+DnsStats DnsResolver::counters;
+TaskHandle_t DnsResolver::task = nullptr;
+char DnsResolver::prefetchHost[DNS_HOST_MAX];
+uint32_t DnsResolver::prefetchDue = 0;
+bool DnsResolver::prefetchPending = false;
+
+static portMUX_TYPE dnsMux = portMUX_INITIALIZER_UNLOCKED;
+
+void DnsResolver::begin() {
+    if (xTaskCreatePinnedToCore(prefetchTask, "dns", DNS_TASK_STACK, nullptr, DNS_TASK_PRIORITY, &task,
+                                DNS_TASK_CORE) != pdPASS) {
+        Serial.println("DNS: failed to create prefetch task");
+        task = nullptr;
+    }
+    if (DNS_SERVER[0] != '\0') {
+        Serial.printf("DNS: using %s instead of the DHCP servers\n", DNS_SERVER);
+    }
+}
+
+bool DnsResolver::queryServer(IPAddress server, const char* host, uint32_t* address, uint32_t* ttlSeconds) {
+    uint8_t packet[DNS_MESSAGE_MAX];
+    WiFiUDP udp;
+    if (!udp.begin(0)) {   // Ephemeral source port
+        return false;
+    }
+    for (int attempt = 0; attempt < DNS_ATTEMPTS; attempt++) {
+        uint16_t id = (uint16_t)esp_random();
+        size_t n = dnsBuildQuery(id, host, packet, sizeof(packet));
+        if (n == 0 || !udp.beginPacket(server, DNS_PORT)) {
+            break;
+        }
+        udp.write(packet, n);
+        if (!udp.endPacket()) {
+            continue;
+        }
+
+        uint32_t sent = millis();
+        while (millis() - sent < DNS_TIMEOUT_MS) {
+            if (udp.parsePacket() <= 0) {
+                vTaskDelay(pdMS_TO_TICKS(5));
+                continue;
+            }
+            int len = udp.read(packet, sizeof(packet));
+            if (len <= 0 || udp.remoteIP() != server || udp.remotePort() != DNS_PORT) {
+                continue;
+            }
+            DnsResult result = dnsParseResponse(packet, (size_t)len, id, host, address, ttlSeconds);
+            if (result == DNS_MISMATCH) {
+                continue;   // A late answer to an earlier attempt
+            }
+            udp.stop();
+            if (result != DNS_OK) {
+                Serial.printf("DNS: %s from %s: %s\n", host, server.toString().c_str(), dnsResultName(result));
+            }
+            return result == DNS_OK;
+        }
+    }
+    udp.stop();
+    return false;
+}
+
+bool DnsResolver::query(const char* host, uint32_t* address, uint32_t* ttlSeconds) {
+    IPAddress servers[2];
+    uint8_t count = 0;
+    uint32_t fixed = parseIPv4(DNS_SERVER);
+    if (fixed != 0) {
+        servers[count++] = IPAddress(fixed);
+    } else {
+        for (uint8_t i = 0; i < 2; i++) {
+            IPAddress server = WiFi.dnsIP(i);
+            if ((uint32_t)server != 0) {
+                servers[count++] = server;
+            }
+        }
+    }
+
+    uint32_t start = millis();
+    bool ok = false;
+    for (uint8_t i = 0; i < count && !ok; i++) {
+        ok = queryServer(servers[i], host, address, ttlSeconds);
+    }
+    uint32_t elapsed = millis() - start;
+
+    portENTER_CRITICAL(&dnsMux);
+    if (ok) {
+        cache.store(host, *address, *ttlSeconds, millis());
+        counters.queries++;
+    }
+    counters.lastQueryMs = elapsed;
+    if (elapsed > counters.maxQueryMs) {
+        counters.maxQueryMs = elapsed;
+    }
+    portEXIT_CRITICAL(&dnsMux);
+    return ok;
+}
+
+bool DnsResolver::resolve(const char* host, IPAddress* address, uint32_t* latencyMs) {
+    *latencyMs = 0;
+    uint32_t resolved = parseIPv4(host);
+    if (resolved != 0) {
+        *address = IPAddress(resolved);
+        return true;
+    }
+
+    portENTER_CRITICAL(&dnsMux);
+    bool hit = cache.lookup(host, millis(), &resolved);
+    if (hit) {
+        counters.hits++;
+    }
+    portEXIT_CRITICAL(&dnsMux);
+
+    if (!hit) {
+        uint32_t start = millis();
+        uint32_t ttl;
+        bool ok = WiFi.status() == WL_CONNECTED && query(host, &resolved, &ttl);
+        *latencyMs = millis() - start;
+
+        if (!ok) {
+            portENTER_CRITICAL(&dnsMux);
+            ok = cache.lastKnownGood(host, millis(), &resolved);
+            if (ok) {
+                counters.fallbacks++;
+            } else {
+                counters.failures++;
+            }
+            portEXIT_CRITICAL(&dnsMux);
+            if (!ok) {
+                Serial.printf("DNS: %s failed after %lu ms, no known address\n", host, (unsigned long)*latencyMs);
+                return false;
+            }
+            Serial.printf("DNS: %s failed after %lu ms, using last known %s\n", host,
+                         (unsigned long)*latencyMs, IPAddress(resolved).toString().c_str());
+        }
+    }
+    *address = IPAddress(resolved);
+    return true;
+}
+
+void DnsResolver::prefetch(const char* host, uint32_t dueInMs) {
+    if (task == nullptr || strlen(host) >= DNS_HOST_MAX || parseIPv4(host) != 0) {
+        return;
+    }
+    portENTER_CRITICAL(&dnsMux);
+    strcpy(prefetchHost, host);
+    prefetchDue = millis() + dueInMs;
+    prefetchPending = true;
+    portEXIT_CRITICAL(&dnsMux);
+    xTaskNotifyGive(task);
+}
+
+void DnsResolver::prefetchTask(void* arg) {
+    char host[DNS_HOST_MAX];
+    for (;;) {
+        portENTER_CRITICAL(&dnsMux);
+        bool pending = prefetchPending;
+        uint32_t due = prefetchDue;
+        strcpy(host, prefetchHost);
+        portEXIT_CRITICAL(&dnsMux);
+
+        // Sleep until the lead time before the fetch; a new prefetch() wakes us to re-plan
+        int32_t wait = pending ? (int32_t)(due - DNS_PREFETCH_LEAD_MS - millis()) : -1;
+        if (!pending || wait > 0) {
+            ulTaskNotifyTake(pdTRUE, pending ? pdMS_TO_TICKS(wait) : portMAX_DELAY);
+            continue;
+        }
+
+        // The fetch resolves a little after it is due (status message first), hence the margin
+        portENTER_CRITICAL(&dnsMux);
+        prefetchPending = false;
+        uint32_t now = millis();
+        int32_t untilDue = (int32_t)(due - now);
+        bool needed = cache.needsRefresh(host, now, (untilDue > 0 ? untilDue : 0) + DNS_PREFETCH_LEAD_MS);
+        portEXIT_CRITICAL(&dnsMux);
+
+        uint32_t address, ttl;
+        if (needed && WiFi.status() == WL_CONNECTED && query(host, &address, &ttl)) {
+            portENTER_CRITICAL(&dnsMux);
+            counters.prefetches++;
+            portEXIT_CRITICAL(&dnsMux);
+        }
+    }
+}
+
+void DnsResolver::stats(DnsStats* out) {
+    portENTER_CRITICAL(&dnsMux);
+    *out = counters;
+    portEXIT_CRITICAL(&dnsMux);
+}
+
+void DnsResolver::report() {
+    DnsStats s;
+    stats(&s);
+    Serial.printf("DNS: %lu cache hits, %lu queries (%lu prefetched), %lu fallbacks, %lu failures, "
+                 "last query %lu ms, slowest %lu ms\n",
+                 (unsigned long)s.hits, (unsigned long)s.queries, (unsigned long)s.prefetches,
+                 (unsigned long)s.fallbacks, (unsigned long)s.failures, (unsigned long)s.lastQueryMs,
+                 (unsigned long)s.maxQueryMs);
+}
@@ -0,0 +1,45 @@
+#ifndef DNS_RESOLVER_H
+#define DNS_RESOLVER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "dns_cache.h"
+
+// Resolves the API host ahead of HTTPClient so fetches don't pay for a
+// lookup. Queries go straight to the DHCP (or DNS_SERVER) resolvers over UDP
+// because lwIP's resolver doesn't expose TTLs; answers are cached for their
+// TTL and refreshed by a task on the network core shortly before the next
+// scheduled fetch. When DNS fails the last known-good address is used.
+class DnsResolver {
+public:
+    static void begin();
+
+    // Cache, then DNS, then the last known-good address. latencyMs is the
+    // time spent waiting on DNS (0 for a cache hit). Safe from any task.
+    static bool resolve(const char* host, IPAddress* address, uint32_t* latencyMs);
+
+    // A fetch of host is due in dueInMs; refresh the entry beforehand if it
+    // would have expired by then
+    static void prefetch(const char* host, uint32_t dueInMs);
+
+    static void stats(DnsStats* out);
+
+    // Perf report section
+    static void report();
+
+private:
+    static DnsCache cache;
+    static DnsStats counters;
+    static TaskHandle_t task;
+    static char prefetchHost[DNS_HOST_MAX];
+    static uint32_t prefetchDue;     // millis() of the fetch, valid while prefetchPending
+    static bool prefetchPending;
+
+    static bool query(const char* host, uint32_t* address, uint32_t* ttlSeconds);
+    static bool queryServer(IPAddress server, const char* host, uint32_t* address, uint32_t* ttlSeconds);
+    static void prefetchTask(void* arg);
+};
+
+#endif // DNS_RESOLVER_H
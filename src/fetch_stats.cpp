@@ -0,0 +1,199 @@
+#include "fetch_stats.h"
+#include <stdio.h>
+#include <string.h>
+
+static const uint32_t BUCKET_LIMITS[FETCH_HISTOGRAM_BUCKETS] = {
+    5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, UINT32_MAX
+};
+
+static uint16_t saturate16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+}
+
+// ==================== TRACE ====================
+
+FetchTrace::FetchTrace() {
+    begin(0);
+}
+
+void FetchTrace::begin(uint32_t now) {
+    memset(&record, 0, sizeof(record));
+    record.startMs = now;
+    record.error = FETCH_NO_ERROR;
+    lastMark = now;
+}
+
+void FetchTrace::endPhase(FetchPhase phase, uint32_t now) {
+    record.phaseMs[phase] = saturate16(record.phaseMs[phase] + (now - lastMark));
+    record.phases |= (uint8_t)(1 << phase);
+    lastMark = now;
+}
+
+void FetchTrace::setStatus(int status) {
+    record.httpStatus = (int16_t)(status > 32767 ? 32767 : status < -32768 ? -32768 : status);
+}
+
+void FetchTrace::addBytes(uint32_t count) {
+    record.bytes = saturate16(record.bytes + count);
+}
+
+void FetchTrace::fail(uint8_t errorType) {
+    if (record.error == FETCH_NO_ERROR) {
+        record.error = errorType;
+    }
+}
+
+const FetchRecord& FetchTrace::finish(uint32_t now) {
+    record.totalMs = saturate16(now - record.startMs);
+    return record;
+}
+
+// ==================== HISTOGRAM ====================
+
+RollingHistogram::RollingHistogram() {
+    memset(current, 0, sizeof(current));
+    memset(previous, 0, sizeof(previous));
+    currentCount = previousCount = 0;
+    currentMax = previousMax = 0;
+}
+
+void RollingHistogram::add(uint32_t ms) {
+    if (currentCount >= FETCH_HISTOGRAM_WINDOW) {
+        memcpy(previous, current, sizeof(previous));
+        previousCount = currentCount;
+        previousMax = currentMax;
+        memset(current, 0, sizeof(current));
+        currentCount = 0;
+        currentMax = 0;
+    }
+    uint8_t i = 0;
+    while (ms > BUCKET_LIMITS[i]) {
+        i++;
+    }
+    current[i]++;
+    currentCount++;
+    if (ms > currentMax) {
+        currentMax = ms;
+    }
+}
+
+uint32_t RollingHistogram::count() const {
+    return (uint32_t)currentCount + previousCount;
+}
+
+uint32_t RollingHistogram::bucket(uint8_t i) const {
+    return (uint32_t)current[i] + previous[i];
+}
+
+uint32_t RollingHistogram::maxMs() const {
+    return currentMax > previousMax ? currentMax : previousMax;
+}
+
+uint32_t RollingHistogram::percentile(uint8_t pct) const {
+    uint32_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    uint32_t rank = (total * pct + 99) / 100;   // Samples at or below the answer
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < FETCH_HISTOGRAM_BUCKETS; i++) {
+        seen += bucket(i);
+        if (seen >= rank) {
+            return BUCKET_LIMITS[i] < maxMs() ? BUCKET_LIMITS[i] : maxMs();
+        }
+    }
+    return maxMs();
+}
+
+uint32_t RollingHistogram::bucketLimit(uint8_t i) {
+    return BUCKET_LIMITS[i];
+}
+
+// ==================== STATS ====================
+
+FetchStats::FetchStats() : head(0), used(0), count(0), bytes(0), statusUsed(0), otherStatuses(0) {
+    memset(ring, 0, sizeof(ring));
+    memset(errorCounts, 0, sizeof(errorCounts));
+    memset(statuses, 0, sizeof(statuses));
+}
+
+void FetchStats::record(const FetchRecord& fetch) {
+    ring[head] = fetch;
+    head = (uint8_t)((head + 1) % FETCH_HISTORY);
+    if (used < FETCH_HISTORY) {
+        used++;
+    }
+    count++;
+    bytes += fetch.bytes;
+
+    // Only phases that ran; a failed connect says nothing about response times
+    for (uint8_t p = 0; p < FETCH_PHASE_COUNT; p++) {
+        if (fetch.phases & (1 << p)) {
+            phases[p].add(fetch.phaseMs[p]);
+        }
+    }
+    totals.add(fetch.totalMs);
+
+    if (fetch.error < STATUS_ERROR_TYPES) {
+        errorCounts[fetch.error]++;
+    }
+    if (fetch.httpStatus != 0) {
+        uint8_t i = 0;
+        while (i < statusUsed && statuses[i].code != fetch.httpStatus) {
+            i++;
+        }
+        if (i == statusUsed && statusUsed < FETCH_STATUS_SLOTS) {
+            statuses[statusUsed].code = fetch.httpStatus;
+            statuses[statusUsed].hits = 0;
+            statusUsed++;
+        }
+        if (i < statusUsed) {
+            statuses[i].hits++;
+        } else {
+            otherStatuses++;
+        }
+    }
+}
+
+const FetchRecord& FetchStats::history(uint8_t i) const {
+    return ring[(head + FETCH_HISTORY - used + i) % FETCH_HISTORY];
+}
+
+const char* fetchPhaseName(FetchPhase phase) {
+    switch (phase) {
+        case FETCH_PHASE_DNS: return "dns";
+        case FETCH_PHASE_CONNECT: return "connect";
+        case FETCH_PHASE_TLS: return "tls";
+        case FETCH_PHASE_TTFB: return "ttfb";
+        case FETCH_PHASE_BODY: return "body";
+        case FETCH_PHASE_PARSE: return "parse";
+        default: return "?";
+    }
+}
+
+size_t formatFetchRecord(const FetchRecord& fetch, char* out, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    size_t len = 0;
+    out[0] = '\0';
+    for (uint8_t p = 0; p < FETCH_PHASE_COUNT; p++) {
+        if (!(fetch.phases & (1 << p)) || len >= size) {
+            continue;
+        }
+        int n = snprintf(out + len, size - len, "%s %u ", fetchPhaseName((FetchPhase)p), fetch.phaseMs[p]);
+        len += n > 0 ? (size_t)n : 0;
+    }
+    if (len < size) {
+        int n = snprintf(out + len, size - len, "= %u ms, %u B", fetch.totalMs, fetch.bytes);
+        len += n > 0 ? (size_t)n : 0;
+    }
+    if (len < size && fetch.httpStatus != 0) {
+        int n = snprintf(out + len, size - len, ", HTTP %d", fetch.httpStatus);
+        len += n > 0 ? (size_t)n : 0;
+    }
+    return len < size ? len : size - 1;
+}
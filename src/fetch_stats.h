@@ -0,0 +1,128 @@
+#ifndef FETCH_STATS_H
+#define FETCH_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Where each fetch spends its time: a trace of one fetch, the last
+// FETCH_HISTORY of them, rolling histograms per phase and failure counters
+// by error type and HTTP status. Times are millis(). No Arduino dependencies.
+
+enum FetchPhase : uint8_t {
+    FETCH_PHASE_DNS = 0,
+    FETCH_PHASE_CONNECT,    // TCP
+    FETCH_PHASE_TLS,        // Handshake; includes the TCP connect when both happen in one call
+    FETCH_PHASE_TTFB,       // Request sent until the response headers are in
+    FETCH_PHASE_BODY,
+    FETCH_PHASE_PARSE,
+    FETCH_PHASE_COUNT
+};
+
+#define FETCH_NO_ERROR 0xFF   // FetchRecord::error of a successful fetch
+
+struct FetchRecord {
+    uint32_t startMs;
+    uint16_t phaseMs[FETCH_PHASE_COUNT];   // Saturating
+    uint16_t totalMs;
+    uint16_t bytes;         // Body bytes received
+    int16_t httpStatus;     // 0 = no response, negative = HTTPClient error
+    uint8_t error;          // ErrorHandler::ErrorType, or FETCH_NO_ERROR
+    uint8_t phases;         // Bit per FetchPhase that completed
+};
+
+// Builds the record of the fetch in progress; each endPhase() charges the
+// time since the previous one to that phase
+class FetchTrace {
+public:
+    FetchTrace();
+
+    void begin(uint32_t now);
+    void endPhase(FetchPhase phase, uint32_t now);
+    void setStatus(int status);
+    void addBytes(uint32_t count);
+    void fail(uint8_t errorType);    // The first failure is the one kept
+    const FetchRecord& finish(uint32_t now);
+
+    const FetchRecord& current() const { return record; }
+
+private:
+    FetchRecord record;
+    uint32_t lastMark;
+};
+
+// Latency histogram over the last FETCH_HISTOGRAM_WINDOW to twice that many
+// samples: a full window is kept as the previous one while the next fills
+class RollingHistogram {
+public:
+    RollingHistogram();
+
+    void add(uint32_t ms);
+
+    uint32_t count() const;
+    uint32_t bucket(uint8_t i) const;
+    // Upper bound of the bucket holding the pct-th percentile, capped at the max seen
+    uint32_t percentile(uint8_t pct) const;
+    uint32_t maxMs() const;
+
+    // Bucket upper bounds (1-2-5 series), the last one open
+    static uint32_t bucketLimit(uint8_t i);
+
+private:
+    uint16_t current[FETCH_HISTOGRAM_BUCKETS];
+    uint16_t previous[FETCH_HISTOGRAM_BUCKETS];
+    uint16_t currentCount;
+    uint16_t previousCount;
+    uint32_t currentMax;
+    uint32_t previousMax;
+};
+
+class FetchStats {
+public:
+    FetchStats();
+
+    void record(const FetchRecord& fetch);
+
+    // Ring of recent fetches, 0 = oldest
+    uint8_t historyCount() const { return used; }
+    const FetchRecord& history(uint8_t i) const;
+
+    const RollingHistogram& phase(FetchPhase p) const { return phases[p]; }
+    const RollingHistogram& total() const { return totals; }
+
+    uint32_t fetches() const { return count; }
+    uint32_t failures(uint8_t errorType) const { return errorCounts[errorType]; }
+    uint32_t bytesReceived() const { return bytes; }
+
+    // Responses by status code, in order of first appearance; codes beyond
+    // FETCH_STATUS_SLOTS are counted together
+    uint8_t statusCodes() const { return statusUsed; }
+    int16_t statusCode(uint8_t i) const { return statuses[i].code; }
+    uint32_t statusHits(uint8_t i) const { return statuses[i].hits; }
+    uint32_t otherStatusHits() const { return otherStatuses; }
+
+private:
+    struct StatusCount {
+        int16_t code;
+        uint32_t hits;
+    };
+
+    FetchRecord ring[FETCH_HISTORY];
+    uint8_t head;
+    uint8_t used;
+    RollingHistogram phases[FETCH_PHASE_COUNT];
+    RollingHistogram totals;
+    uint32_t count;
+    uint32_t errorCounts[STATUS_ERROR_TYPES];
+    uint32_t bytes;
+    StatusCount statuses[FETCH_STATUS_SLOTS];
+    uint8_t statusUsed;
+    uint32_t otherStatuses;
+};
+
+const char* fetchPhaseName(FetchPhase phase);
+
+// "dns 0 tls 412 ttfb 188 body 9 parse 3 = 612 ms, 1843 B, HTTP 200"
+size_t formatFetchRecord(const FetchRecord& fetch, char* out, size_t size);
+
+#endif // FETCH_STATS_H
@@ -0,0 +1,174 @@
+#include "frame_mirror.h"
+#include <WiFi.h>
+#include <new>
+#include "alloc_tracker.h"
+#if MIRROR_TRANSPORT == MIRROR_SERIAL
+#include "esp_log.h"
+#endif
+
+MirrorEncoder* FrameMirror::encoder = nullptr;
+uint8_t* FrameMirror::buffer = nullptr;
+TaskHandle_t FrameMirror::sender = nullptr;
+volatile size_t FrameMirror::pending = 0;
+volatile bool FrameMirror::viewerPresent = false;
+volatile bool FrameMirror::viewerReset = false;
+uint32_t FrameMirror::lastCaptureMs = 0;
+uint32_t FrameMirror::packets = 0;
+uint32_t FrameMirror::bytesSent = 0;
+uint32_t FrameMirror::skipped = 0;
+uint32_t FrameMirror::encodeMicrosMax = 0;
+uint32_t FrameMirror::logLinesDropped = 0;
+
+#if MIRROR_TRANSPORT == MIRROR_TCP
+static WiFiServer mirrorServer(MIRROR_TCP_PORT);
+#endif
+
+#if MIRROR_TRANSPORT == MIRROR_SERIAL
+// Bytes the line carries in one capture interval (10 bits a byte), less the log's share
+#define MIRROR_SERIAL_PACKET_MAX \
+    ((size_t)MIRROR_SERIAL_BAUD / 10 * MIRROR_INTERVAL_MS / 1000 * MIRROR_SERIAL_SHARE / 100)
+static_assert(MIRROR_SERIAL_PACKET_MAX >= MIRROR_HEADER_SIZE + MIRROR_RECORD_HEADER_SIZE +
+                                              MIRROR_RLE_BOUND(SPRITE_WIDTH) + MIRROR_TRAILER_SIZE,
+              "MIRROR_SERIAL_BAUD too low for serial mirroring: a packet must hold a full scanline");
+static const size_t packetLimit =
+    MIRROR_SERIAL_PACKET_MAX < MIRROR_BUFFER_SIZE ? MIRROR_SERIAL_PACKET_MAX : MIRROR_BUFFER_SIZE;
+
+static volatile bool packetOnWire = false;
+static vprintf_like_t idfLog = nullptr;
+
+// ESP-IDF log lines bypass the Serial lock; drop them rather than split a packet
+static int mirrorLogVprintf(const char* format, va_list args) {
+    if (packetOnWire) {
+        FrameMirror::logLinesDropped++;
+        return 0;
+    }
+    return idfLog(format, args);
+}
+#else
+static const size_t packetLimit = MIRROR_BUFFER_SIZE;
+#endif
+
+void FrameMirror::begin() {
+#if MIRROR_TRANSPORT != MIRROR_OFF
+    {
+        AllocScope allocScope(ALLOC_TAG_NETWORK);
+        encoder = new (std::nothrow) MirrorEncoder();
+        buffer = (uint8_t*)malloc(MIRROR_BUFFER_SIZE);
+    }
+    if (encoder == nullptr || buffer == nullptr) {
+        Serial.println("Mirror: not enough memory, disabled");
+        delete encoder;
+        free(buffer);
+        encoder = nullptr;
+        buffer = nullptr;
+        return;
+    }
+
+#if MIRROR_TRANSPORT == MIRROR_TCP
+    mirrorServer.begin();
+    mirrorServer.setNoDelay(true);
+    Serial.printf("Mirror: listening on %s:%d\n", WiFi.localIP().toString().c_str(), MIRROR_TCP_PORT);
+#else
+    // Serial has no connection state; periodic full refreshes let a late viewer sync
+    viewerPresent = true;
+    // Core debug output goes straight to the UART; IDF log lines are dropped while a packet is out
+    Serial.setDebugOutput(false);
+    idfLog = esp_log_set_vprintf(mirrorLogVprintf);
+    Serial.printf("Mirror: streaming over serial at %d baud, packets up to %u bytes\n", MIRROR_SERIAL_BAUD,
+                  (unsigned)packetLimit);
+#endif
+
+    if (xTaskCreatePinnedToCore(senderTask, "mirror", MIRROR_TASK_STACK, nullptr, MIRROR_TASK_PRIORITY,
+                                &sender, MIRROR_TASK_CORE) != pdPASS) {
+        Serial.println("Mirror: failed to create sender task");
+        sender = nullptr;
+    }
+#endif
+}
+
+void FrameMirror::capture(const uint16_t* pixels) {
+    if (sender == nullptr || !viewerPresent) {
+        return;
+    }
+    uint32_t now = millis();
+    if (now - lastCaptureMs < MIRROR_INTERVAL_MS) {
+        return;
+    }
+    lastCaptureMs = now;
+    if (pending != 0) {
+        skipped++;  // Sender still writing the last packet
+        return;
+    }
+
+    if (viewerReset) {
+        viewerReset = false;
+        encoder->reset();
+    }
+    uint32_t start = micros();
+    size_t len = encoder->encode(pixels, buffer, packetLimit);
+    uint32_t elapsed = micros() - start;
+    if (elapsed > encodeMicrosMax) {
+        encodeMicrosMax = elapsed;
+    }
+    if (len > 0) {
+        pending = len;
+        xTaskNotifyGive(sender);
+    }
+}
+
+void FrameMirror::senderTask(void* arg) {
+#if MIRROR_TRANSPORT == MIRROR_TCP
+    WiFiClient client;
+#endif
+    for (;;) {
+#if MIRROR_TRANSPORT == MIRROR_TCP
+        if (!client.connected()) {
+            if (viewerPresent) {
+                viewerPresent = false;
+                pending = 0;  // Drop the packet meant for the old viewer
+                Serial.println("Mirror: viewer disconnected");
+            }
+            client = mirrorServer.accept();
+            if (client) {
+                client.setNoDelay(true);
+                viewerReset = true;
+                viewerPresent = true;
+                Serial.println("Mirror: viewer connected");
+            }
+        }
+#endif
+        // Woken by capture(); the timeout keeps polling for a viewer
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MIRROR_INTERVAL_MS));
+        size_t len = pending;
+        if (len == 0) {
+            continue;
+        }
+
+#if MIRROR_TRANSPORT == MIRROR_TCP
+        if (client.write(buffer, len) != len) {
+            client.stop();
+        }
+#elif MIRROR_TRANSPORT == MIRROR_SERIAL
+        // One write holds the Serial lock, so Serial.printf lines land between packets;
+        // flush() keeps IDF log lines out until the last byte has left the UART
+        packetOnWire = true;
+        Serial.write(buffer, len);
+        Serial.flush();
+        packetOnWire = false;
+#endif
+        packets++;
+        bytesSent += len;
+        pending = 0;
+    }
+}
+
+void FrameMirror::report() {
+    if (sender == nullptr) {
+        return;
+    }
+    Serial.printf("Mirror: %s, %lu packets, %lu KB, %lu frames skipped, encode max %lu us, %lu log lines dropped\n",
+                 viewerPresent ? "streaming" : "no viewer", (unsigned long)packets,
+                 (unsigned long)(bytesSent / 1024), (unsigned long)skipped, (unsigned long)encodeMicrosMax,
+                 (unsigned long)logLinesDropped);
+    encodeMicrosMax = 0;
+}
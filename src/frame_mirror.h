@@ -0,0 +1,42 @@
+#ifndef FRAME_MIRROR_H
+#define FRAME_MIRROR_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mirror_codec.h"
+
+// Streams the display to tools/mirror_viewer.py over serial or TCP (MIRROR_TRANSPORT).
+// The render loop encodes a frame only when the sender task has finished the
+// previous packet; otherwise the frame is skipped, so a slow link never stalls drawing.
+// Over serial, packets are capped to what MIRROR_SERIAL_BAUD carries in one interval.
+class FrameMirror {
+public:
+    static void begin();
+
+    // Offer a complete SPRITE_WIDTH x SPRITE_HEIGHT frame in sprite byte order
+    static void capture(const uint16_t* pixels);
+
+    // Perf report section: packets, bytes, skipped frames and encode time
+    static void report();
+
+    // IDF log lines held back while a serial packet was on the wire
+    static uint32_t logLinesDropped;
+
+private:
+    static MirrorEncoder* encoder;
+    static uint8_t* buffer;
+    static TaskHandle_t sender;
+    static volatile size_t pending;     // Packet bytes handed to the sender, 0 when it is idle
+    static volatile bool viewerPresent;
+    static volatile bool viewerReset;   // New viewer: the next packet starts a full refresh
+    static uint32_t lastCaptureMs;
+    static uint32_t packets;
+    static uint32_t bytesSent;
+    static uint32_t skipped;
+    static uint32_t encodeMicrosMax;
+
+    static void senderTask(void* arg);
+};
+
+#endif // FRAME_MIRROR_H
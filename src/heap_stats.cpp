@@ -0,0 +1,50 @@
+#include "heap_stats.h"
+#include "esp_heap_caps.h"
+
+static uint32_t probeFreeHeap() {
+    return ESP.getFreeHeap();
+}
+
+void HeapStats::begin() {
+    AllocTracker::setHeapProbe(probeFreeHeap);
+}
+
+uint32_t HeapStats::freeHeap() {
+    return ESP.getFreeHeap();
+}
+
+uint32_t HeapStats::largestFreeBlock() {
+    return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+uint32_t HeapStats::minFreeHeap() {
+    return ESP.getMinFreeHeap();
+}
+
+void HeapStats::report() {
+    uint32_t free = freeHeap();
+    uint32_t largest = largestFreeBlock();
+    // Fragmentation: share of free memory not usable as one block
+    uint32_t fragmentation = free > 0 ? 100 - (largest * 100) / free : 0;
+    Serial.printf("Heap: free=%lu largest=%lu frag=%lu%% min-ever=%lu\n",
+                 (unsigned long)free, (unsigned long)largest,
+                 (unsigned long)fragmentation, (unsigned long)minFreeHeap());
+
+    // Exact figures, then the approximate per-run growth of the scoped blocks
+    Serial.print("Alloc:");
+    for (int tag = 0; tag < ALLOC_TAG_COUNT; tag++) {
+        const AllocTagStats& s = AllocTracker::stats(tag);
+        if (s.count > 0 || s.frees > 0) {
+            Serial.printf(" %s cur=%ld peak=%ld n=%lu", AllocTracker::tagName(tag),
+                         (long)s.current, (long)s.peak, (unsigned long)s.count);
+        }
+        if (s.scopeRuns > 0) {
+            Serial.printf(" %s ~%ld/run max (%lu runs)", AllocTracker::tagName(tag),
+                         (long)s.scopeMaxGrowth, (unsigned long)s.scopeRuns);
+        }
+    }
+    if (!AllocTracker::withinBudget(ALLOC_TAG_JSON, ALLOC_BUDGET_JSON)) {
+        Serial.printf(" | json over its %d byte budget", ALLOC_BUDGET_JSON);
+    }
+    Serial.println();
+}
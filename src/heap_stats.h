@@ -0,0 +1,21 @@
+#ifndef HEAP_STATS_H
+#define HEAP_STATS_H
+
+#include <Arduino.h>
+#include "alloc_tracker.h"
+
+// Heap health and per-subsystem allocation report for the perf report
+class HeapStats {
+public:
+    // Connect AllocTracker to the ESP heap
+    static void begin();
+
+    static uint32_t freeHeap();
+    static uint32_t largestFreeBlock();
+    static uint32_t minFreeHeap();
+
+    // Perf report section: fragmentation plus current/peak/count per tag
+    static void report();
+};
+
+#endif // HEAP_STATS_H
@@ -0,0 +1,48 @@
+#include "http_url.h"
+#include <string.h>
+#include <strings.h>
+
+bool parseHttpUrl(const char* url, HttpUrl* out) {
+    const char* rest;
+    if (strncasecmp(url, "https://", 8) == 0) {
+        out->secure = true;
+        out->port = 443;
+        rest = url + 8;
+    } else if (strncasecmp(url, "http://", 7) == 0) {
+        out->secure = false;
+        out->port = 80;
+        rest = url + 7;
+    } else {
+        return false;
+    }
+
+    // Authority ends at the path, query or fragment; credentials aren't supported
+    size_t len = strcspn(rest, "/?#");
+    if (memchr(rest, '@', len) != nullptr) {
+        return false;
+    }
+    const char* colon = (const char*)memchr(rest, ':', len);
+    size_t hostLen = colon != nullptr ? (size_t)(colon - rest) : len;
+    if (hostLen == 0 || hostLen >= sizeof(out->host)) {
+        return false;
+    }
+    if (colon != nullptr) {
+        uint32_t port = 0;
+        const char* p = colon + 1;
+        if (p == rest + len) {
+            return false;
+        }
+        for (; p < rest + len; p++) {
+            if (*p < '0' || *p > '9') return false;
+            port = port * 10 + (uint32_t)(*p - '0');
+            if (port > 65535) return false;
+        }
+        if (port == 0) {
+            return false;
+        }
+        out->port = (uint16_t)port;
+    }
+    memcpy(out->host, rest, hostLen);
+    out->host[hostLen] = '\0';
+    return true;
+}
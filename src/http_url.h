@@ -0,0 +1,20 @@
+#ifndef HTTP_URL_H
+#define HTTP_URL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Splits "https://host:port/path?query" so the host can be resolved ahead of
+// HTTPClient. No Arduino dependencies.
+
+struct HttpUrl {
+    bool secure;        // https
+    uint16_t port;      // Explicit, else 80 or 443
+    char host[DNS_HOST_MAX];
+};
+
+// False for anything but an http(s) URL with a host that fits
+bool parseHttpUrl(const char* url, HttpUrl* out);
+
+#endif // HTTP_URL_H
@@ -0,0 +1,154 @@
+#include "icon_cache.h"
+
+void scaleAlphaArea(const uint8_t* src, uint8_t srcSize, uint8_t* dst, uint8_t dstSize) {
+    // Work in units of 1/(srcSize * dstSize) of the image: destination pixel i
+    // spans [i * srcSize, (i + 1) * srcSize), source pixel j spans
+    // [j * dstSize, (j + 1) * dstSize). Overlaps are then integer weights.
+    const uint32_t total = (uint32_t)srcSize * srcSize;
+    for (int dy = 0; dy < dstSize; dy++) {
+        int y0 = dy * srcSize;
+        int y1 = y0 + srcSize;
+        for (int dx = 0; dx < dstSize; dx++) {
+            int x0 = dx * srcSize;
+            int x1 = x0 + srcSize;
+
+            uint32_t sum = 0;
+            for (int sy = y0 / dstSize; sy * dstSize < y1; sy++) {
+                int top = sy * dstSize > y0 ? sy * dstSize : y0;
+                int bottom = (sy + 1) * dstSize < y1 ? (sy + 1) * dstSize : y1;
+                const uint8_t* row = src + sy * srcSize;
+                uint32_t rowSum = 0;
+                for (int sx = x0 / dstSize; sx * dstSize < x1; sx++) {
+                    int left = sx * dstSize > x0 ? sx * dstSize : x0;
+                    int right = (sx + 1) * dstSize < x1 ? (sx + 1) * dstSize : x1;
+                    rowSum += (uint32_t)row[sx] * (uint32_t)(right - left);
+                }
+                sum += rowSum * (uint32_t)(bottom - top);
+            }
+            dst[dy * dstSize + dx] = (uint8_t)((sum + total / 2) / total);
+        }
+    }
+}
+
+uint16_t premultiply565(uint16_t color, uint8_t alpha) {
+    uint32_t r = div255((uint32_t)(color >> 11) * alpha);
+    uint32_t g = div255((uint32_t)((color >> 5) & 0x3F) * alpha);
+    uint32_t b = div255((uint32_t)(color & 0x1F) * alpha);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static inline uint16_t swap16(uint16_t c) {
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+void blitIcon(uint16_t* fb, int fbWidth, int fbHeight, int x, int y,
+              const IconImage& icon, uint16_t background, bool swapBytes) {
+    int x0 = x < 0 ? -x : 0;
+    int y0 = y < 0 ? -y : 0;
+    int x1 = x + icon.size > fbWidth ? fbWidth - x : icon.size;
+    int y1 = y + icon.size > fbHeight ? fbHeight - y : icon.size;
+
+    for (int py = y0; py < y1; py++) {
+        const uint8_t* alpha = icon.alpha + py * icon.size;
+        const uint16_t* color = icon.color + py * icon.size;
+        uint16_t* out = fb + (y + py) * fbWidth + x;
+
+        int px = x0;
+        while (px < x1) {
+            uint8_t a = alpha[px];
+            if (a == 0) {
+                do {
+                    px++;
+                } while (px < x1 && alpha[px] == 0);
+            } else if (a == 255) {
+                do {
+                    out[px] = swapBytes ? swap16(color[px]) : color[px];
+                    px++;
+                } while (px < x1 && alpha[px] == 255);
+            } else {
+                uint16_t c = blendOver565(color[px], a, background);
+                out[px] = swapBytes ? swap16(c) : c;
+                px++;
+            }
+        }
+    }
+}
+
+void blitIconCrossFade(uint16_t* fb, int fbWidth, int fbHeight, int x, int y,
+                       const IconImage* from, const IconImage& to, uint8_t mix,
+                       uint16_t background, bool swapBytes) {
+    if (from != nullptr && from->size != to.size) {
+        from = nullptr;
+    }
+    int x0 = x < 0 ? -x : 0;
+    int y0 = y < 0 ? -y : 0;
+    int x1 = x + to.size > fbWidth ? fbWidth - x : to.size;
+    int y1 = y + to.size > fbHeight ? fbHeight - y : to.size;
+
+    for (int py = y0; py < y1; py++) {
+        uint16_t* out = fb + (y + py) * fbWidth + x;
+        for (int px = x0; px < x1; px++) {
+            int i = py * to.size + px;
+            uint8_t af = from != nullptr ? from->alpha[i] : 0;
+            uint8_t at = to.alpha[i];
+            if (af == 0 && at == 0) {
+                continue;
+            }
+            uint16_t cf = af != 0 ? blendOver565(from->color[i], af, background) : background;
+            uint16_t ct = at != 0 ? blendOver565(to.color[i], at, background) : background;
+            uint16_t c = lerp565(cf, ct, mix);
+            out[px] = swapBytes ? swap16(c) : c;
+        }
+    }
+}
+
+IconCache::IconCache() {
+    for (int i = 0; i < ICON_CACHE_SLOTS; i++) {
+        entries[i].image.alpha = entries[i].alpha;
+        entries[i].image.color = entries[i].color;
+    }
+    clear();
+}
+
+void IconCache::clear() {
+    for (int i = 0; i < ICON_CACHE_SLOTS; i++) {
+        entries[i].master = nullptr;
+        entries[i].lastUse = 0;
+        entries[i].tint = 0;
+        entries[i].image.size = 0;
+    }
+    useClock = 0;
+    hitCount = 0;
+    missCount = 0;
+}
+
+const IconImage* IconCache::get(const uint8_t* master, uint8_t masterSize, uint16_t tint, uint8_t size) {
+    if (master == nullptr || size == 0 || size > ICON_CACHE_MAX_SIZE) {
+        return nullptr;
+    }
+
+    Entry* victim = &entries[0];
+    for (int i = 0; i < ICON_CACHE_SLOTS; i++) {
+        Entry& e = entries[i];
+        if (e.master == master && e.image.size == size && e.tint == tint) {
+            e.lastUse = ++useClock;
+            hitCount++;
+            return &e.image;
+        }
+        // Empty slots have lastUse 0, so they are taken before any live entry
+        if (e.lastUse < victim->lastUse) {
+            victim = &e;
+        }
+    }
+
+    scaleAlphaArea(master, masterSize, victim->alpha, size);
+    for (int i = 0; i < size * size; i++) {
+        victim->color[i] = premultiply565(tint, victim->alpha[i]);
+    }
+    victim->master = master;
+    victim->tint = tint;
+    victim->image.size = size;
+    victim->lastUse = ++useClock;
+    missCount++;
+    return &victim->image;
+}
@@ -0,0 +1,97 @@
+#ifndef ICON_CACHE_H
+#define ICON_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Scaled variants of the 8-bit alpha icon masters. A variant is produced
+// once, on first use, as premultiplied RGB565 plus alpha and kept in a small
+// preallocated LRU so frames only blit. No Arduino dependencies.
+
+// Area-averaging resample of a square alpha image: each destination pixel is
+// the coverage-weighted mean of the source pixels under it. Integer only.
+void scaleAlphaArea(const uint8_t* src, uint8_t srcSize, uint8_t* dst, uint8_t dstSize);
+
+// Scaled icon ready for blitIcon(): color is premultiplied by alpha
+struct IconImage {
+    const uint8_t* alpha;
+    const uint16_t* color;
+    uint8_t size;
+};
+
+// Exact round(x / 255) for x <= 65535
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// Tint scaled by alpha, per RGB565 channel
+uint16_t premultiply565(uint16_t color, uint8_t alpha);
+
+// Premultiplied source over an opaque destination, integer only
+static inline uint16_t blendOver565(uint16_t src, uint8_t alpha, uint16_t dst) {
+    uint32_t inv = 255 - alpha;
+    uint32_t r = (src >> 11) + div255((dst >> 11) * inv);
+    uint32_t g = ((src >> 5) & 0x3F) + div255(((dst >> 5) & 0x3F) * inv);
+    uint32_t b = (src & 0x1F) + div255((dst & 0x1F) * inv);
+    // Two roundings can overshoot a saturated channel by one
+    if (r > 0x1F) r = 0x1F;
+    if (g > 0x3F) g = 0x3F;
+    if (b > 0x1F) b = 0x1F;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Composite an icon onto a framebuffer whose area under the icon is the solid
+// background color. Transparent runs are skipped and opaque runs copied without
+// blending. swapBytes stores colors byte-swapped (TFT_eSprite 16-bit layout).
+// Clipped to the framebuffer.
+void blitIcon(uint16_t* fb, int fbWidth, int fbHeight, int x, int y,
+              const IconImage& icon, uint16_t background, bool swapBytes);
+
+// Blend two opaque colors: mix 0 = a, 255 = b
+static inline uint16_t lerp565(uint16_t a, uint16_t b, uint8_t mix) {
+    uint32_t inv = 255 - mix;
+    uint32_t r = div255((a >> 11) * inv + (b >> 11) * mix);
+    uint32_t g = div255(((a >> 5) & 0x3F) * inv + ((b >> 5) & 0x3F) * mix);
+    uint32_t bl = div255((a & 0x1F) * inv + (b & 0x1F) * mix);
+    return (uint16_t)((r << 11) | (g << 5) | bl);
+}
+
+// Cross-fade from one icon to another of the same size over the solid
+// background; from may be nullptr to fade in. Same layout rules as blitIcon.
+void blitIconCrossFade(uint16_t* fb, int fbWidth, int fbHeight, int x, int y,
+                       const IconImage* from, const IconImage& to, uint8_t mix,
+                       uint16_t background, bool swapBytes);
+
+class IconCache {
+public:
+    IconCache();
+
+    // The master tinted and scaled to size x size, built on a miss.
+    // nullptr if size is 0 or above ICON_CACHE_MAX_SIZE.
+    const IconImage* get(const uint8_t* master, uint8_t masterSize, uint16_t tint, uint8_t size);
+
+    void clear();
+
+    uint32_t hits() const { return hitCount; }
+    uint32_t misses() const { return missCount; }
+    static size_t memoryBytes() { return sizeof(Entry) * ICON_CACHE_SLOTS; }
+
+private:
+    struct Entry {
+        const uint8_t* master;   // nullptr = empty slot
+        uint32_t lastUse;
+        uint16_t tint;
+        IconImage image;         // Views alpha/color below
+        uint8_t alpha[ICON_CACHE_MAX_SIZE * ICON_CACHE_MAX_SIZE];
+        uint16_t color[ICON_CACHE_MAX_SIZE * ICON_CACHE_MAX_SIZE];
+    };
+
+    Entry entries[ICON_CACHE_SLOTS];
+    uint32_t useClock;
+    uint32_t hitCount;
+    uint32_t missCount;
+};
+
+#endif // ICON_CACHE_H
@@ -0,0 +1,29 @@
+#ifndef JSON_ALLOCATOR_H
+#define JSON_ALLOCATOR_H
+
+#include <ArduinoJson.h>
+#include "alloc_tracker.h"
+
+// ArduinoJson allocator that routes document memory through the counting
+// allocator, so JSON usage shows up exactly under ALLOC_TAG_JSON.
+class TrackingJsonAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override {
+        return trackedMalloc(size, ALLOC_TAG_JSON);
+    }
+
+    void deallocate(void* ptr) override {
+        trackedFree(ptr);
+    }
+
+    void* reallocate(void* ptr, size_t newSize) override {
+        return trackedRealloc(ptr, newSize);
+    }
+
+    static TrackingJsonAllocator* instance() {
+        static TrackingJsonAllocator allocator;
+        return &allocator;
+    }
+};
+
+#endif // JSON_ALLOCATOR_H
@@ -19,6 +19,18 @@
 #include "config.h"
 #include "weather_display.h"
 #include "weather_api.h"
+#include "scheduler.h"
+#include "stall_monitor.h"
+#include "perf_report.h"
+#include "runtime_stats.h"
+#include "heap_stats.h"
+#include "frame_mirror.h"
+#include "status_server.h"
+#include "telemetry_publisher.h"
+#include "wifi_join.h"
+#include "wifi_manager.h"
+#include "dns_resolver.h"
+#include "boot_timeline.h"
 #include "secrets.h"
 
 // Global objects
@@ -27,41 +39,213 @@ Preferences preferences;
 WeatherDisplay display(rtc); // Pass rtc to display
 WeatherAPI apiClient(rtc); // Pass rtc to API client
 
-// Animation and timing variables
-unsigned long timePased = 0;
+// Startup phases, printed at the end of setup()
+BootTimeline bootTimeline;
+
+// Networks the connection manager may use, best first; extras come from secrets.h
+static const WifiNetwork wifiNetworks[] = {
+    {WIFI_SSID, WIFI_PASSWORD},
+#ifdef WIFI_SSID_2
+    {WIFI_SSID_2, WIFI_PASSWORD_2},
+#endif
+#ifdef WIFI_SSID_3
+    {WIFI_SSID_3, WIFI_PASSWORD_3},
+#endif
+};
+
+// Work that was skipped while offline, caught up by linkTask
+static int fetchTaskId = -1;
+static int timeSyncTaskId = -1;
+static bool fetchMissed = false;
+static bool timeSyncMissed = false;
+
+// Cooperative scheduler - every periodic job is a task with a deadline
+Scheduler scheduler;
+MonotonicClock monotonicClock;
+static int loopCounter = 0;
+
+static uint64_t monotonicMillis() {
+    return monotonicClock.extend(millis());
+}
+
+static uint32_t schedulerMicros() {
+    return micros();
+}
+
+// A task that doesn't fit would silently never run; say so at boot
+static int addTask(const char* name, TaskCallback callback, uint32_t periodMs, uint32_t firstDelayMs) {
+    int id = scheduler.addTask(name, callback, periodMs, firstDelayMs);
+    if (id < 0) {
+        Serial.printf("=== STARTUP: scheduler full, task '%s' not added (SCHEDULER_MAX_TASKS %d) ===\n", name,
+                     SCHEDULER_MAX_TASKS);
+    }
+    return id;
+}
+
+/**
+ * Render task - advances the ticker animation and draws a frame (40Hz)
+ */
+void renderTask() {
+    display.updateData();
+    display.draw();
+}
+
+/**
+ * Input task - brightness buttons and backlight schedule
+ */
+void inputTask() {
+    display.handleButtons();
+    display.updateBacklight();
+}
+
+/**
+ * Fetch task - weather data refresh every UPDATE_INTERVAL_MS
+ */
+void fetchTask() {
+    if (!WifiManager::online()) {
+        // Nothing to gain from a request that can't leave; linkTask catches up
+        fetchMissed = true;
+        Serial.println("=== 3-MINUTE TIMER: WiFi offline, fetch postponed ===");
+        display.getAni() = ANIMATION_START_POSITION;
+        display.showStatusMessage("... WiFi offline ...");
+        return;
+    }
+    fetchMissed = false;
+    
+    uint32_t budgetWait = apiClient.budgetWaitMs();
+    if (budgetWait > 0) {
+        // Over the plan's limits or held after a 429; keep the current data on screen
+        Serial.printf("=== 3-MINUTE TIMER: API budget, fetch postponed %lu s ===\n",
+                     (unsigned long)((budgetWait + 999) / 1000));
+        scheduler.scheduleIn(fetchTaskId, budgetWait, monotonicMillis());
+        StatusServer::publishBudget(apiClient.budgetStatus());
+        return;
+    }
+    
+    StallScope stallScope(STALL_REGION_FETCH);  // Covers the 2-second "Fetching" pause too
+    display.getDisplayState().updateCounter++;
+    
+    Serial.printf("=== 3-MINUTE TIMER: Starting API fetch [%lu ms] ===\n", millis());
+    
+    // Clear existing scrolling message and reset animation
+    display.getAni() = ANIMATION_START_POSITION; // Reset animation position
+    display.showStatusMessage("... Fetching data ...");
+    Serial.println("Scrolling: ... Fetching data ...");
+    
+    // Wait 2 seconds so user can see "Fetching data..." clearly on device display
+    delay(2000);
+    
+    // Fetch new weather data
+    bool apiSuccess = apiClient.getData(display.getConfig(), display.getWeatherData(), display.getDisplayState());
+    if (!apiSuccess) {
+        Serial.println("API call failed");
+    }
+    // Have the address fresh in the cache by the next run
+    DnsResolver::prefetch(apiClient.apiHost(), UPDATE_INTERVAL_MS);
+    
+    // Queue the new content (or the connection status) and show it right away
+    display.recordFetch(apiSuccess);
+    StatusServer::publishFetch(apiSuccess, apiClient.lastFetchMillis(), apiClient.lastDnsMillis());
+    StatusServer::publishBudget(apiClient.budgetStatus());
+    display.getAni() = ANIMATION_START_POSITION; // Reset animation for new message
+    display.updateScrollingBuffer();
+    
+    // Telemetry goes out while the radio is busy with this fetch anyway
+    TelemetryPublisher::recordFetch(apiSuccess, apiClient.lastFetchMillis(), apiClient.lastDnsMillis());
+    if (apiSuccess) {
+        TelemetryPublisher::recordObservation(display.getWeatherData());
+    }
+    TelemetryPublisher::flush();
+}
+
+/**
+ * Ticker task - pre-renders the next scrolling message ahead of the wrap point
+ */
+void tickerTask() {
+    display.serviceTicker();
+}
+
+/**
+ * Time sync task - NTP resynchronization every SYNC_INTERVAL_UPDATES fetches (30 minutes)
+ */
+void timeSyncTask() {
+    if (!WifiManager::online()) {
+        timeSyncMissed = true;
+        return;
+    }
+    timeSyncMissed = !apiClient.setTime();
+    display.getDisplayState().updateCounter = 0;
+}
+
+/**
+ * Link task - catches up on a time sync or fetch skipped while WiFi was down
+ */
+void linkTask() {
+    if (!WifiManager::takeReconnected()) {
+        return;
+    }
+    uint64_t now = monotonicMillis();
+    if (timeSyncMissed) {
+        scheduler.scheduleIn(timeSyncTaskId, 0, now);
+    }
+    if (fetchMissed) {
+        scheduler.scheduleIn(fetchTaskId, WIFI_FETCH_AFTER_RECONNECT_MS, now);
+    }
+}
+
+/**
+ * Stats task - memory and per-task run-time accounting (every 30 seconds)
+ */
+void statsTask() {
+    Serial.printf("Free heap: %lu bytes, Largest block: %lu, Min ever: %lu, Loops: %d\n",
+                 (unsigned long)HeapStats::freeHeap(), (unsigned long)HeapStats::largestFreeBlock(),
+                 (unsigned long)HeapStats::minFreeHeap(), loopCounter);
+    loopCounter = 0;
+    
+    for (int i = 0; i < scheduler.taskCount(); i++) {
+        const SchedulerTaskStats& stats = scheduler.taskStats(i);
+        Serial.printf("Task %-8s runs=%lu avg=%luus max=%luus late=%lums\n",
+                     scheduler.taskName(i), (unsigned long)stats.runs,
+                     stats.runs ? (unsigned long)(stats.totalUs / stats.runs) : 0UL,
+                     (unsigned long)stats.maxUs, (unsigned long)stats.lateMs);
+    }
+    scheduler.resetStats();
+    
+    TelemetryPublisher::recordHealth(display.getHealth());
+}
 
 /**
  * Arduino setup function - initializes hardware and connections
  * Sets up display, WiFi, time synchronization, and initial data fetch
  */
 void setup() {
+#if MIRROR_TRANSPORT == MIRROR_SERIAL
+    Serial.begin(MIRROR_SERIAL_BAUD);  // The mirror shares the line with the log
+#else
     Serial.begin(115200);
+#endif
     Serial.println("Weather Micro Station Starting...");
+    HeapStats::begin();  // Before display.begin() so the sprite allocations are attributed
     
     // Initialize display
+    uint32_t phaseStart = millis();
     display.begin();
+    bootTimeline.add("display", phaseStart, millis());
     
-    // Direct WiFi connection using credentials from secrets.h
+    // WiFi from secrets.h, straight to the cached access point when there is one
     Serial.printf("Connecting to WiFi: %s\n", WIFI_SSID);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 30) {
-        delay(1000);
-        Serial.print(".");
-        attempts++;
-    }
-    
-    if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("\nFailed to connect to WiFi, restarting...");
-        delay(3000);
-        ESP.restart();
+    bool joined = WifiJoin::connect(WIFI_SSID, WIFI_PASSWORD, bootTimeline);
+    if (joined) {
+        Serial.println("WiFi connected successfully!");
+        Serial.printf("IP address: %s\n", WiFi.localIP().toString().c_str());
+        Serial.printf("Signal strength: %d dBm\n", WiFi.RSSI());
+        display.getDisplayState().isConnected = true;
+    } else {
+        Serial.println("Failed to connect to WiFi, continuing offline");
     }
-    
-    Serial.println("\nWiFi connected successfully!");
-    Serial.printf("IP address: %s\n", WiFi.localIP().toString().c_str());
-    Serial.printf("Signal strength: %d dBm\n", WiFi.RSSI());
-    display.getDisplayState().isConnected = true;
+    // From here on the manager keeps the link up (or brings it up) in the background
+    WifiManager::begin(wifiNetworks, sizeof(wifiNetworks) / sizeof(wifiNetworks[0]));
+    DnsResolver::begin();
     
     // Initialize preferences for secure storage
     preferences.begin("weather", false);
@@ -69,112 +253,116 @@ void setup() {
     display.initializeBrightnessControl();
     
     // Initial time synchronization and data fetch
-    apiClient.setTime();
+    if (joined) {
+        phaseStart = millis();
+        timeSyncMissed = !apiClient.setTime();
+        bootTimeline.add("time sync", phaseStart, millis());
+        WifiJoin::timeSynced();
+    } else {
+        timeSyncMissed = true;
+    }
+    // After the time sync so the time spent powered off counts towards the refill
+    WeatherAPI::beginBudget();
+    uint32_t budgetWait = WifiManager::online() ? WeatherAPI::budgetWaitMs() : 0;
+    uint32_t firstFetchDelay = budgetWait > 0 ? budgetWait : UPDATE_INTERVAL_MS;
     
-    Serial.println("=== STARTUP: Making initial API call ===");
-    // Clear existing scrolling message and reset animation for startup
-    display.getAni() = ANIMATION_START_POSITION; // Reset animation position
-    strcpy(display.getWeatherData().scrollingMessage, "... Fetching data ...");
-    display.updateScrollingBuffer();
-    Serial.println("Scrolling: ... Fetching data ...");
+    if (budgetWait > 0) {
+        // Rebooting doesn't buy extra requests; the scheduled fetch goes once the budget allows
+        fetchMissed = false;
+        display.getAni() = ANIMATION_START_POSITION;
+        display.showStatusMessage("... Waiting for API ...");
+        Serial.printf("=== STARTUP: API budget, initial API call in %lu s ===\n",
+                     (unsigned long)((firstFetchDelay + 999) / 1000));
+    } else if (WifiManager::online()) {
+        Serial.println("=== STARTUP: Making initial API call ===");
+        // Clear existing scrolling message and reset animation for startup
+        display.getAni() = ANIMATION_START_POSITION; // Reset animation position
+        display.showStatusMessage("... Fetching data ...");
+        Serial.println("Scrolling: ... Fetching data ...");
     
-    // Wait 2 seconds so user can see "Fetching data..." clearly on device display
-    delay(2000);
+        // Wait 2 seconds so user can see "Fetching data..." clearly on device display
+        delay(2000);
     
-    // Make initial API call
-    if (apiClient.getData(display.getWeatherData(), display.getDisplayState())) {
-        display.updateLegacyData();
-        display.updateScrollingMessage();
+        // Make initial API call
+        phaseStart = millis();
+        bool apiSuccess = apiClient.getData(display.getConfig(), display.getWeatherData(), display.getDisplayState());
+        bootTimeline.add("first fetch", phaseStart, millis());
+        display.recordFetch(apiSuccess);
+        StatusServer::publishFetch(apiSuccess, apiClient.lastFetchMillis(), apiClient.lastDnsMillis());
+        StatusServer::publishBudget(apiClient.budgetStatus());
         // Reset animation and update display buffer with the actual data
         display.getAni() = ANIMATION_START_POSITION; // Reset animation for new message
         display.updateScrollingBuffer();
-        Serial.println("=== STARTUP: Initial API call successful ===");
+        if (apiSuccess) {
+            Serial.println("=== STARTUP: Initial API call successful ===");
+        } else {
+            Serial.println("=== STARTUP: Initial API call failed ===");
+        }
     } else {
-        Serial.println("=== STARTUP: Initial API call failed ===");
+        fetchMissed = true;
+        display.getAni() = ANIMATION_START_POSITION;
+        display.showStatusMessage("... WiFi offline ...");
+        Serial.println("=== STARTUP: Offline, initial API call postponed ===");
     }
     
-    // Reset timer for 3-minute intervals starting now
-    timePased = millis();
-    Serial.printf("=== STARTUP: 3-minute timer started at %lu ms ===\n", timePased);
-    Serial.printf("=== STARTUP: Next API call in 3 minutes at %lu ms ===\n", timePased + UPDATE_INTERVAL_MS);
+    // Schedule periodic work - the 3-minute fetch timer starts now
+    scheduler.setMicrosSource(schedulerMicros);
+    scheduler.begin(monotonicMillis());
+    addTask("render", renderTask, RENDER_INTERVAL_MS, 0);
+    addTask("input", inputTask, INPUT_POLL_INTERVAL_MS, 0);
+    addTask("ticker", tickerTask, TICKER_PREPARE_INTERVAL_MS, 0);
+    fetchTaskId = addTask("fetch", fetchTask, UPDATE_INTERVAL_MS, firstFetchDelay);
+    timeSyncTaskId = addTask("timesync", timeSyncTask, TIME_SYNC_INTERVAL_MS, TIME_SYNC_INTERVAL_MS);
+    addTask("stats", statsTask, STATS_INTERVAL_MS, STATS_INTERVAL_MS);
+    addTask("taskstat", RuntimeStats::sample, TASK_STATS_SAMPLE_MS, 0);
+    addTask("link", linkTask, WIFI_LINK_CHECK_MS, WIFI_LINK_CHECK_MS);
+    DnsResolver::prefetch(apiClient.apiHost(), firstFetchDelay);
+    Serial.printf("=== STARTUP: Next API call at %lu ms ===\n", millis() + firstFetchDelay);
+    
+    // Stall watchdog - armed last so the blocking startup sequence isn't counted as one stall
+    StallMonitor::begin();
+    PerfReport::addSection(StallMonitor::report);
+    PerfReport::addSection(RuntimeStats::report);
+    PerfReport::addSection(HeapStats::report);
+    
+    // Screen mirror for the host viewer (off unless MIRROR_TRANSPORT is set)
+    FrameMirror::begin();
+    PerfReport::addSection(FrameMirror::report);
+    
+    // WiFi link state, reconnects and signal history (the manager started after the boot join)
+    PerfReport::addSection(WifiManager::report);
+    PerfReport::addSection(DnsResolver::report);
     
+    // Fetch phases (dns, connect/tls, ttfb, body, parse), failures and the last fetch
+    PerfReport::addSection(WeatherAPI::report);
+    
+    // HTTP status endpoints, served from the network core
+    StatusServer::begin(display.getFramebuffer());
+    PerfReport::addSection(StatusServer::report);
+    
+    // MQTT telemetry (off unless TELEMETRY_BROKER_HOST is set)
+    TelemetryPublisher::begin();
+    PerfReport::addSection(TelemetryPublisher::report);
+    
+    char timeline[512];
+    bootTimeline.format(timeline, sizeof(timeline));
+    Serial.printf("Boot timeline (%s join):\n%s", WifiJoin::usedFastJoin() ? "fast" : "scan", timeline);
     Serial.println("Setup complete - entering main loop");
 }
 
 /**
- * Arduino main loop - handles display updates and data refresh
- * Runs continuously to maintain real-time display
+ * Arduino main loop - runs due scheduler tasks, then idles until the next deadline
  */
 void loop() {
-    // Non-blocking timing for smoother performance
-    static unsigned long lastDisplayUpdate = 0;
-    static unsigned long lastMemoryCheck = 0;
-    static int loopCounter = 0;
-    
-    unsigned long currentMillis = millis();
-    
-    // Update display at 40Hz (25ms interval) for smooth animation
-    if (currentMillis - lastDisplayUpdate >= 25) {
-        // Update animation and scrolling
-        display.updateData();
-        
-        // Check if it's time for a data update (every 3 minutes)
-        if (millis() > timePased + UPDATE_INTERVAL_MS) {
-            timePased = millis();
-            display.getDisplayState().updateCounter++;
-            
-            Serial.printf("=== 3-MINUTE TIMER: Starting API fetch [%lu ms] ===\n", millis());
-            
-            // Clear existing scrolling message and reset animation
-            display.getAni() = ANIMATION_START_POSITION; // Reset animation position
-            strcpy(display.getWeatherData().scrollingMessage, "... Fetching data ...");
-            display.updateScrollingBuffer();
-            Serial.println("Scrolling: ... Fetching data ...");
-            
-            // Wait 2 seconds so user can see "Fetching data..." clearly on device display
-            delay(2000);
-            
-            // Fetch new weather data
-            bool apiSuccess = apiClient.getData(display.getWeatherData(), display.getDisplayState());
-            
-            if (apiSuccess) {
-                // Update legacy arrays for compatibility
-                display.updateLegacyData();
-                
-                // Update scrolling message with fetched data
-                display.updateScrollingMessage();
-                
-                // Reset animation and update display buffer with the actual data
-                display.getAni() = ANIMATION_START_POSITION; // Reset animation for new message
-                display.updateScrollingBuffer();
-            } else {
-                Serial.println("API call failed");
-                // Keep "Fetching data..." message on failure
-            }
-            
-            // Periodic time synchronization
-            if (display.getDisplayState().updateCounter >= SYNC_INTERVAL_UPDATES) {
-                apiClient.setTime();  // Sync time every 10 updates (30 minutes)
-                display.getDisplayState().updateCounter = 0;
-            }
-        }
-        
-        // Draw the display
-        display.draw();
-        lastDisplayUpdate = currentMillis;
-    }
-    
-    // Handle brightness control buttons (non-blocking)
-    display.handleBrightnessButtons();
-    
-    // Memory monitoring (every 30 seconds)
+    StallMonitor::heartbeat();
+    scheduler.run(monotonicMillis());
     loopCounter++;
-    if (currentMillis - lastMemoryCheck >= 30000) {  // 30 seconds
-        lastMemoryCheck = currentMillis;
-        Serial.printf("Free heap: %d bytes, Loops: %d\n", ESP.getFreeHeap(), loopCounter);
-        loopCounter = 0;
-    }
     
-    // Small yield to prevent watchdog triggers and allow other tasks
-    yield();
-}
\ No newline at end of file
+    // Sleep until the next deadline; delay() yields to other tasks and feeds the watchdog
+    uint32_t idleMs = scheduler.idleTimeMs(monotonicMillis());
+    if (idleMs > 0) {
+        delay(idleMs);
+    } else {
+        yield();
+    }
+}
@@ -0,0 +1,259 @@
+#include "mirror_codec.h"
+#include <string.h>
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint16_t fletcher16(const uint8_t* data, size_t len) {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    while (len > 0) {
+        // Defer the modulo: sums stay below 2^32 for 360-byte blocks
+        size_t block = len < 360 ? len : 360;
+        len -= block;
+        while (block-- > 0) {
+            a += *data++;
+            b += a;
+        }
+        a %= 255;
+        b %= 255;
+    }
+    return (uint16_t)((b << 8) | a);
+}
+
+static uint32_t hashSpan(const uint16_t* pixels, int count) {
+    uint32_t h = 2166136261u;  // FNV-1a, one step per pixel
+    for (int i = 0; i < count; i++) {
+        h = (h ^ pixels[i]) * 16777619u;
+    }
+    return h;
+}
+
+size_t mirrorEncodeRun(const uint16_t* pixels, uint16_t count, uint8_t* out, size_t outSize) {
+    size_t used = 0;
+    int i = 0;
+    while (i < count) {
+        int repeat = 1;
+        while (i + repeat < count && repeat < 128 && pixels[i + repeat] == pixels[i]) {
+            repeat++;
+        }
+        if (repeat >= 2) {
+            if (used + 3 > outSize) return 0;
+            out[used++] = (uint8_t)(0x80 | (repeat - 1));
+            memcpy(out + used, &pixels[i], 2);
+            used += 2;
+            i += repeat;
+            continue;
+        }
+
+        // Literal run up to the next stretch of three equal pixels
+        int end = i + 1;
+        while (end < count && end - i < 128 &&
+               !(end + 2 < count && pixels[end] == pixels[end + 1] && pixels[end] == pixels[end + 2])) {
+            end++;
+        }
+        int n = end - i;
+        if (used + 1 + 2 * (size_t)n > outSize) return 0;
+        out[used++] = (uint8_t)(n - 1);
+        memcpy(out + used, &pixels[i], 2 * (size_t)n);
+        used += 2 * (size_t)n;
+        i = end;
+    }
+    return used;
+}
+
+MirrorEncoder::MirrorEncoder() : frame(0), spansSent(0) {
+    reset();
+}
+
+void MirrorEncoder::reset() {
+    keyRow = 0;
+    keySpan = 0;
+    keyStart = true;
+    packetsSinceKey = 0;
+}
+
+size_t MirrorEncoder::encode(const uint16_t* pixels, uint8_t* out, size_t outSize) {
+    if (outSize < MIRROR_HEADER_SIZE + MIRROR_TRAILER_SIZE) {
+        return 0;
+    }
+#if MIRROR_KEYFRAME_PACKETS > 0
+    if (packetsSinceKey >= MIRROR_KEYFRAME_PACKETS && !refreshPending()) {
+        reset();
+    }
+#endif
+
+    const size_t limit = outSize - MIRROR_TRAILER_SIZE;
+    size_t used = MIRROR_HEADER_SIZE;
+    uint16_t records = 0;
+    uint32_t spans = 0;
+    bool full = false;
+    int stopSpan = 0;
+    uint32_t hashes[MIRROR_SPANS_PER_ROW];
+
+    int y = 0;
+    for (; y < SPRITE_HEIGHT && !full; y++) {
+        const uint16_t* row = pixels + y * SPRITE_WIDTH;
+        // Spans from (keyRow, keySpan) on are sent regardless of hash
+        int forcedFrom = y > keyRow ? 0 : y == keyRow ? keySpan : MIRROR_SPANS_PER_ROW;
+        for (int s = 0; s < MIRROR_SPANS_PER_ROW; s++) {
+            int x = s * MIRROR_SPAN_PIXELS;
+            int w = SPRITE_WIDTH - x < MIRROR_SPAN_PIXELS ? SPRITE_WIDTH - x : MIRROR_SPAN_PIXELS;
+            hashes[s] = hashSpan(row + x, w);
+        }
+
+        // Adjacent changed spans go out as one record
+        int s = 0;
+        while (s < MIRROR_SPANS_PER_ROW) {
+            if (s < forcedFrom && hashes[s] == spanHash[y][s]) {
+                s++;
+                continue;
+            }
+            int last = s + 1;
+            while (last < MIRROR_SPANS_PER_ROW && (last >= forcedFrom || hashes[last] != spanHash[y][last])) {
+                last++;
+            }
+
+            // Trim the run to what is sure to fit
+            int x = s * MIRROR_SPAN_PIXELS;
+            int count = 0;
+            while (last > s) {
+                int end = last * MIRROR_SPAN_PIXELS < SPRITE_WIDTH ? last * MIRROR_SPAN_PIXELS : SPRITE_WIDTH;
+                count = end - x;
+                if (used + MIRROR_RECORD_HEADER_SIZE + MIRROR_RLE_BOUND(count) <= limit) break;
+                last--;
+            }
+            if (last == s) {
+                full = true;
+                stopSpan = s;
+                break;
+            }
+
+            uint8_t* rec = out + used;
+            put16(rec, (uint16_t)y);
+            put16(rec + 2, (uint16_t)x);
+            put16(rec + 4, (uint16_t)count);
+            used += MIRROR_RECORD_HEADER_SIZE;
+            used += mirrorEncodeRun(row + x, (uint16_t)count, out + used, limit - used);
+            for (int k = s; k < last; k++) {
+                spanHash[y][k] = hashes[k];
+            }
+            records++;
+            spans += (uint32_t)(last - s);
+            s = last;
+            if (last < MIRROR_SPANS_PER_ROW && (last >= forcedFrom || hashes[last] != spanHash[y][last])) {
+                full = true;  // Trimmed: the rest of the row waits for the next packet
+                stopSpan = last;
+                break;
+            }
+        }
+    }
+
+    uint8_t flags = 0;
+    if (full) {
+        flags |= MIRROR_FLAG_PARTIAL;
+        // The span where space ran out is where the refresh resumes
+        if (keyRow < SPRITE_HEIGHT && (y - 1 > keyRow || (y - 1 == keyRow && stopSpan > keySpan))) {
+            keyRow = (uint16_t)(y - 1);
+            keySpan = (uint16_t)stopSpan;
+        }
+    } else {
+        keyRow = SPRITE_HEIGHT;
+        keySpan = 0;
+    }
+    if (records == 0 && !keyStart) {
+        return 0;
+    }
+    if (keyStart) {
+        flags |= MIRROR_FLAG_KEYFRAME;
+        keyStart = false;
+        packetsSinceKey = 0;
+    }
+
+    out[0] = 'W';
+    out[1] = 'M';
+    out[2] = MIRROR_VERSION;
+    out[3] = flags;
+    put16(out + 4, SPRITE_WIDTH);
+    put16(out + 6, SPRITE_HEIGHT);
+    put32(out + 8, frame);
+    put32(out + 12, (uint32_t)(used - MIRROR_HEADER_SIZE));
+    put16(out + 16, records);
+    put16(out + used, fletcher16(out, used));
+
+    frame++;
+    packetsSinceKey++;
+    spansSent = spans;
+    return used + MIRROR_TRAILER_SIZE;
+}
+
+bool mirrorApply(const uint8_t* packet, size_t len, uint16_t* pixels, uint16_t width, uint16_t height,
+                 MirrorPacketInfo* info) {
+    if (len < MIRROR_HEADER_SIZE + MIRROR_TRAILER_SIZE || packet[0] != 'W' || packet[1] != 'M' ||
+        packet[2] != MIRROR_VERSION) {
+        return false;
+    }
+    size_t payload = get32(packet + 12);
+    if (get16(packet + 4) != width || get16(packet + 6) != height ||
+        payload != len - MIRROR_HEADER_SIZE - MIRROR_TRAILER_SIZE) {
+        return false;
+    }
+    size_t end = MIRROR_HEADER_SIZE + payload;
+    if (get16(packet + end) != fletcher16(packet, end)) {
+        return false;
+    }
+
+    uint16_t records = get16(packet + 16);
+    if (info != nullptr) {
+        info->frame = get32(packet + 8);
+        info->flags = packet[3];
+        info->records = records;
+    }
+
+    size_t pos = MIRROR_HEADER_SIZE;
+    for (uint16_t r = 0; r < records; r++) {
+        if (pos + MIRROR_RECORD_HEADER_SIZE > end) return false;
+        uint16_t y = get16(packet + pos);
+        uint16_t x = get16(packet + pos + 2);
+        uint16_t count = get16(packet + pos + 4);
+        pos += MIRROR_RECORD_HEADER_SIZE;
+        if (y >= height || x + count > width) return false;
+
+        uint16_t* dst = pixels + (size_t)y * width + x;
+        while (count > 0) {
+            if (pos >= end) return false;
+            uint8_t op = packet[pos++];
+            uint16_t n = (uint16_t)((op & 0x7F) + 1);
+            if (n > count) return false;
+            if (op & 0x80) {
+                if (pos + 2 > end) return false;
+                uint16_t value;
+                memcpy(&value, packet + pos, 2);
+                pos += 2;
+                for (uint16_t i = 0; i < n; i++) dst[i] = value;
+            } else {
+                if (pos + 2 * (size_t)n > end) return false;
+                memcpy(dst, packet + pos, 2 * (size_t)n);
+                pos += 2 * (size_t)n;
+            }
+            dst += n;
+            count -= n;
+        }
+    }
+    return pos == end;
+}
@@ -0,0 +1,73 @@
+#ifndef MIRROR_CODEC_H
+#define MIRROR_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Wire format for mirroring the display to tools/mirror_viewer.py. A packet holds
+// the scanline spans that changed since they were last sent, run-length encoded:
+//
+//   header   'W' 'M' version flags | width:u16 height:u16 | frame:u32 | payload:u32 | records:u16
+//   record   y:u16 x:u16 pixels:u16, then ops until `pixels` are covered:
+//            0x80 | n -> next pixel repeated n + 1 times, n -> n + 1 literal pixels follow
+//   trailer  Fletcher-16 of header and payload
+//
+// Integers are little-endian. Pixels are copied in buffer byte order; TFT_eSprite
+// keeps colours byte-swapped, so on the wire they are big-endian RGB565.
+// No Arduino dependencies.
+
+#define MIRROR_VERSION 1
+#define MIRROR_HEADER_SIZE 18
+#define MIRROR_RECORD_HEADER_SIZE 6
+#define MIRROR_TRAILER_SIZE 2
+#define MIRROR_FLAG_KEYFRAME 0x01  // First packet of a full refresh
+#define MIRROR_FLAG_PARTIAL 0x02   // Out of room; the remaining spans follow in the next packet
+#define MIRROR_SPANS_PER_ROW ((SPRITE_WIDTH + MIRROR_SPAN_PIXELS - 1) / MIRROR_SPAN_PIXELS)
+
+// Largest RLE encoding of n pixels
+#define MIRROR_RLE_BOUND(n) (2 * (size_t)(n) + (size_t)(n) / 128 + 1)
+
+struct MirrorPacketInfo {
+    uint32_t frame;
+    uint8_t flags;
+    uint16_t records;
+};
+
+// Diffs SPRITE_WIDTH x SPRITE_HEIGHT frames against the last transmitted one.
+// Only a hash per span is kept (about 7 KB), not a copy of the frame.
+class MirrorEncoder {
+public:
+    MirrorEncoder();
+
+    // The next packet starts a full refresh (new viewer)
+    void reset();
+
+    // Encode the spans that changed since they were last sent into out.
+    // Spans that don't fit keep their old hash and go in the next packet.
+    // Returns the packet size, 0 when nothing changed.
+    size_t encode(const uint16_t* pixels, uint8_t* out, size_t outSize);
+
+    uint32_t frameNumber() const { return frame; }
+    uint32_t lastSpans() const { return spansSent; }
+    bool refreshPending() const { return keyRow < SPRITE_HEIGHT; }
+
+private:
+    uint32_t spanHash[SPRITE_HEIGHT][MIRROR_SPANS_PER_ROW];
+    uint16_t keyRow;           // Spans from (keyRow, keySpan) on are sent regardless of hash
+    uint16_t keySpan;
+    bool keyStart;             // Next packet carries MIRROR_FLAG_KEYFRAME
+    uint32_t frame;
+    uint32_t packetsSinceKey;
+    uint32_t spansSent;
+};
+
+// RLE-encode count pixels; returns bytes written, 0 when out is too small
+size_t mirrorEncodeRun(const uint16_t* pixels, uint16_t count, uint8_t* out, size_t outSize);
+
+// Reference decoder: apply a packet to a width x height buffer. False on a bad
+// checksum, size mismatch or malformed record (the buffer may be partly updated).
+bool mirrorApply(const uint8_t* packet, size_t len, uint16_t* pixels, uint16_t width, uint16_t height,
+                 MirrorPacketInfo* info);
+
+#endif // MIRROR_CODEC_H
@@ -0,0 +1,97 @@
+#include "mqtt_packet.h"
+#include <string.h>
+
+static size_t remainingLength(uint8_t* out, size_t value) {
+    size_t n = 0;
+    do {
+        uint8_t digit = value % 128;
+        value /= 128;
+        out[n++] = value > 0 ? (uint8_t)(digit | 0x80) : digit;
+    } while (value > 0 && n < 4);
+    return n;
+}
+
+static size_t putString(uint8_t* out, const char* text, size_t len) {
+    out[0] = (uint8_t)(len >> 8);
+    out[1] = (uint8_t)len;
+    memcpy(out + 2, text, len);
+    return 2 + len;
+}
+
+size_t mqttConnect(uint8_t* out, size_t outSize, const char* clientId, uint16_t keepAliveSeconds,
+                   const char* username, const char* password) {
+    size_t idLen = strlen(clientId);
+    size_t userLen = username != nullptr ? strlen(username) : 0;
+    size_t passLen = password != nullptr ? strlen(password) : 0;
+    if (idLen > 0xFFFF || userLen > 0xFFFF || passLen > 0xFFFF) {
+        return 0;
+    }
+
+    uint8_t flags = 0x02;  // Clean session
+    size_t body = 10 + 2 + idLen;
+    if (userLen > 0) {
+        flags |= 0x80;
+        body += 2 + userLen;
+        if (passLen > 0) {
+            flags |= 0x40;
+            body += 2 + passLen;
+        }
+    }
+    if (body > 268435455 || 1 + 4 + body > outSize) {
+        return 0;
+    }
+
+    size_t n = 0;
+    out[n++] = 0x10;
+    n += remainingLength(out + n, body);
+    n += putString(out + n, "MQTT", 4);
+    out[n++] = 4;  // Protocol level 3.1.1
+    out[n++] = flags;
+    out[n++] = (uint8_t)(keepAliveSeconds >> 8);
+    out[n++] = (uint8_t)keepAliveSeconds;
+    n += putString(out + n, clientId, idLen);
+    if (flags & 0x80) {
+        n += putString(out + n, username, userLen);
+    }
+    if (flags & 0x40) {
+        n += putString(out + n, password, passLen);
+    }
+    return n;
+}
+
+size_t mqttPublishHeader(uint8_t* out, size_t outSize, const char* topic, uint16_t packetId, size_t payloadLen) {
+    size_t topicLen = strlen(topic);
+    size_t body = 2 + topicLen + 2 + payloadLen;
+    if (topicLen > 0xFFFF || body > 268435455 || 1 + 4 + 2 + topicLen + 2 > outSize) {
+        return 0;
+    }
+
+    size_t n = 0;
+    out[n++] = 0x32;  // PUBLISH, QoS 1
+    n += remainingLength(out + n, body);
+    n += putString(out + n, topic, topicLen);
+    out[n++] = (uint8_t)(packetId >> 8);
+    out[n++] = (uint8_t)packetId;
+    return n;
+}
+
+size_t mqttDisconnect(uint8_t* out, size_t outSize) {
+    if (outSize < 2) {
+        return 0;
+    }
+    out[0] = 0xE0;
+    out[1] = 0x00;
+    return 2;
+}
+
+int mqttParseConnack(const uint8_t* in, size_t len) {
+    if (len < MQTT_CONNACK_SIZE || in[0] != 0x20 || in[1] != 0x02) {
+        return -1;
+    }
+    return in[3];
+}
+
+bool mqttIsPuback(const uint8_t* in, size_t len, uint16_t packetId) {
+    return len >= MQTT_PUBACK_SIZE && in[0] == 0x40 && in[1] == 0x02 &&
+           in[2] == (uint8_t)(packetId >> 8) && in[3] == (uint8_t)packetId;
+}
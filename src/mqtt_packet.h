@@ -0,0 +1,29 @@
+#ifndef MQTT_PACKET_H
+#define MQTT_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The few MQTT 3.1.1 packets the telemetry publisher needs: CONNECT, QoS 1
+// PUBLISH, DISCONNECT and the CONNACK / PUBACK replies. Builders return the
+// packet size, 0 if it doesn't fit in out. No Arduino dependencies.
+
+#define MQTT_CONNACK_SIZE 4
+#define MQTT_PUBACK_SIZE 4
+
+// Clean session; username and password are sent when non-empty
+size_t mqttConnect(uint8_t* out, size_t outSize, const char* clientId, uint16_t keepAliveSeconds,
+                   const char* username, const char* password);
+
+// Header only: the payload follows on the wire, so it needn't be copied
+size_t mqttPublishHeader(uint8_t* out, size_t outSize, const char* topic, uint16_t packetId, size_t payloadLen);
+
+size_t mqttDisconnect(uint8_t* out, size_t outSize);
+
+// CONNACK return code (0 = accepted), -1 if the bytes are not a CONNACK
+int mqttParseConnack(const uint8_t* in, size_t len);
+
+// True for the PUBACK of packetId
+bool mqttIsPuback(const uint8_t* in, size_t len, uint16_t packetId);
+
+#endif // MQTT_PACKET_H
@@ -0,0 +1,134 @@
+#include "pages.h"
+#include "icon_cache.h"
+#include "units.h"
+
+const char* pageTitle(uint8_t page) {
+    switch (page) {
+        case PAGE_CONDITIONS: return "WEATHER";
+        case PAGE_TREND: return "TREND";
+        case PAGE_STATS: return "TODAY";
+        case PAGE_HEALTH: return "DEVICE";
+        default: return "";
+    }
+}
+
+TemperatureHistory::TemperatureHistory() : head(0), used(0) {
+}
+
+void TemperatureHistory::record(uint32_t epoch, int16_t temperature) {
+    if (used > 0) {
+        TemperatureSample& last = samples[(head + TEMPERATURE_HISTORY_SIZE - 1) % TEMPERATURE_HISTORY_SIZE];
+        if (epoch / 3600 == last.epoch / 3600) {
+            if (epoch >= last.epoch) {
+                last.epoch = epoch;
+                last.temperature = temperature;
+            }
+            return;
+        }
+        if (epoch < last.epoch) {
+            return;   // Clock stepped back - keep the ring ordered
+        }
+    }
+    samples[head].epoch = epoch;
+    samples[head].temperature = temperature;
+    head = (uint8_t)((head + 1) % TEMPERATURE_HISTORY_SIZE);
+    if (used < TEMPERATURE_HISTORY_SIZE) {
+        used++;
+    }
+}
+
+const TemperatureSample& TemperatureHistory::at(uint8_t index) const {
+    return samples[(head + TEMPERATURE_HISTORY_SIZE - used + index) % TEMPERATURE_HISTORY_SIZE];
+}
+
+bool TemperatureHistory::range(int16_t& low, int16_t& high) const {
+    if (used == 0) {
+        return false;
+    }
+    low = high = at(0).temperature;
+    for (uint8_t i = 1; i < used; i++) {
+        int16_t t = at(i).temperature;
+        if (t < low) low = t;
+        if (t > high) high = t;
+    }
+    return true;
+}
+
+uint8_t layoutChart(const TemperatureHistory& history, int x, int y, int w, int h,
+                    ChartPoint* out, int16_t& low, int16_t& high) {
+    uint8_t n = history.count();
+    if (n == 0 || w < 2 || h < 2) {
+        return 0;
+    }
+
+    // Only hours inside the window are plotted - the ring may hold older ones after an outage
+    uint32_t newestHour = history.at(n - 1).epoch / 3600;
+    uint8_t first = 0;
+    while (first < n && newestHour - history.at(first).epoch / 3600 >= TEMPERATURE_HISTORY_SIZE) {
+        first++;
+    }
+
+    low = high = history.at(first).temperature;
+    for (uint8_t i = first + 1; i < n; i++) {
+        int16_t t = history.at(i).temperature;
+        if (t < low) low = t;
+        if (t > high) high = t;
+    }
+    if (high - low < TEMP_SCALE) {
+        int32_t mid = ((int32_t)low + high) / 2;
+        low = (int16_t)(mid - TEMP_SCALE / 2);
+        high = (int16_t)(low + TEMP_SCALE);
+    }
+
+    uint8_t count = 0;
+    for (uint8_t i = first; i < n; i++) {
+        const TemperatureSample& s = history.at(i);
+        int32_t age = (int32_t)(newestHour - s.epoch / 3600);
+        out[count].x = (int16_t)(x + (w - 1) - age * (w - 1) / (TEMPERATURE_HISTORY_SIZE - 1));
+        out[count].y = (int16_t)(y + (h - 1) - ((int32_t)s.temperature - low) * (h - 1) / (high - low));
+        count++;
+    }
+    return count;
+}
+
+PageNavigator::PageNavigator() : page(PAGE_CONDITIONS), lastChange(0) {
+}
+
+uint8_t PageNavigator::neighbor(int direction) const {
+    return (uint8_t)((page + PAGE_COUNT + (direction < 0 ? -1 : 1)) % PAGE_COUNT);
+}
+
+uint8_t PageNavigator::due(uint32_t nowMs) const {
+#if PAGE_AUTO_ADVANCE_MS > 0
+    if (nowMs - lastChange >= (uint32_t)PAGE_AUTO_ADVANCE_MS) {
+        return (uint8_t)((page + 1) % PAGE_COUNT);
+    }
+#endif
+#if PAGE_RETURN_MS > 0
+    if (page != PAGE_CONDITIONS && nowMs - lastChange >= (uint32_t)PAGE_RETURN_MS) {
+        return PAGE_CONDITIONS;
+    }
+#endif
+    (void)nowMs;
+    return PAGE_COUNT;
+}
+
+void PageNavigator::show(uint8_t next, uint32_t nowMs) {
+    if (next < PAGE_COUNT) {
+        page = next;
+        lastChange = nowMs;
+    }
+}
+
+static inline uint16_t unswap(uint16_t c) {
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+void fadeLine(const uint16_t* from, const uint16_t* to, uint16_t* out, int count, uint8_t mix) {
+    for (int i = 0; i < count; i++) {
+        uint16_t a = from[i];
+        uint16_t b = to[i];
+        // Unchanged pixels (most of the black background) skip the blend
+        out[i] = a == b ? unswap(a) : lerp565(unswap(a), unswap(b), mix);
+    }
+}
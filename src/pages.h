@@ -0,0 +1,101 @@
+#ifndef PAGES_H
+#define PAGES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Screen pages and the compact models the secondary pages render from.
+// Only the visible page (and, during a transition, the outgoing one) has
+// pixels; idle pages are just these models. No Arduino dependencies.
+
+enum PageId : uint8_t {
+    PAGE_CONDITIONS = 0,   // The original layout
+    PAGE_TREND,            // Hourly temperature chart
+    PAGE_STATS,            // Today's fetches and temperature range
+    PAGE_HEALTH,           // Heap, WiFi, frame timing, uptime
+    PAGE_COUNT
+};
+
+enum PageTransition : uint8_t {
+    TRANSITION_NONE = 0,
+    TRANSITION_SLIDE_LEFT,    // Incoming page enters from the right
+    TRANSITION_SLIDE_RIGHT,   // Incoming page enters from the left
+    TRANSITION_FADE
+};
+
+const char* pageTitle(uint8_t page);
+
+// Latest observed temperature per UTC hour, TEMPERATURE_HISTORY_SIZE hours
+struct TemperatureSample {
+    uint32_t epoch;
+    int16_t temperature;   // TEMP_SCALE
+};
+
+class TemperatureHistory {
+public:
+    TemperatureHistory();
+
+    // A later sample in the same hour replaces the earlier one; older ones are ignored
+    void record(uint32_t epoch, int16_t temperature);
+
+    uint8_t count() const { return used; }
+    const TemperatureSample& at(uint8_t index) const;   // 0 = oldest
+
+    // Min/max over the stored samples; false when empty
+    bool range(int16_t& low, int16_t& high) const;
+
+private:
+    TemperatureSample samples[TEMPERATURE_HISTORY_SIZE];
+    uint8_t head;   // Next write slot
+    uint8_t used;
+};
+
+struct ChartPoint {
+    int16_t x;
+    int16_t y;
+};
+
+// Place the history in a w x h box: newest hour at the right edge, one column
+// step per hour so gaps stay visible, temperature range padded to at least
+// 1 degree. Returns the number of points written (up to TEMPERATURE_HISTORY_SIZE).
+uint8_t layoutChart(const TemperatureHistory& history, int x, int y, int w, int h,
+                    ChartPoint* out, int16_t& low, int16_t& high);
+
+// Device health snapshot for the health page
+struct HealthModel {
+    uint32_t uptimeSeconds;
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+    uint32_t largestBlock;
+    uint32_t frameMaxMicros;
+    uint16_t fpsTenths;
+    int8_t rssi;           // 0 = not connected
+};
+
+// Page order, button clicks and the auto-advance / return timers
+class PageNavigator {
+public:
+    PageNavigator();
+
+    uint8_t current() const { return page; }
+
+    // Page after (+1) or before (-1) the current one, wrapping
+    uint8_t neighbor(int direction) const;
+
+    // Page a timer wants to show, or PAGE_COUNT when none is due
+    uint8_t due(uint32_t nowMs) const;
+
+    // Make a page current; restarts both timers
+    void show(uint8_t next, uint32_t nowMs);
+
+private:
+    uint8_t page;
+    uint32_t lastChange;
+};
+
+// Fade kernel for one run of pixels: inputs in TFT_eSprite byte-swapped
+// order, output in native RGB565 for pushImage(). mix 0 = from, 255 = to.
+void fadeLine(const uint16_t* from, const uint16_t* to, uint16_t* out, int count, uint8_t mix);
+
+#endif // PAGES_H
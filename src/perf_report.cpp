@@ -0,0 +1,18 @@
+#include "perf_report.h"
+
+PerfReportSection PerfReport::sections[PERF_REPORT_MAX_SECTIONS];
+int PerfReport::numSections = 0;
+
+bool PerfReport::addSection(PerfReportSection section) {
+    if (numSections >= PERF_REPORT_MAX_SECTIONS || section == nullptr) {
+        return false;
+    }
+    sections[numSections++] = section;
+    return true;
+}
+
+void PerfReport::print() {
+    for (int i = 0; i < numSections; i++) {
+        sections[i]();
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef PERF_REPORT_H
+#define PERF_REPORT_H
+
+#include "config.h"
+
+// Extension point for the periodic performance report.
+// Subsystems register a print function; WeatherDisplay calls print() every 10 seconds.
+typedef void (*PerfReportSection)();
+
+class PerfReport {
+public:
+    static bool addSection(PerfReportSection section);
+    static void print();
+
+private:
+    static PerfReportSection sections[PERF_REPORT_MAX_SECTIONS];
+    static int numSections;
+};
+
+#endif // PERF_REPORT_H
@@ -0,0 +1,96 @@
+#include "runtime_stats.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+TaskStatsAggregator RuntimeStats::aggregator;
+
+// Static to keep ~1 KB of snapshot data off the loop() stack
+static TaskSample samples[TASK_STATS_MAX_TASKS];
+
+#if (configUSE_TRACE_FACILITY == 1)
+static TaskStatus_t taskStatus[TASK_STATS_MAX_TASKS];
+#endif
+
+void RuntimeStats::sample() {
+    int count = 0;
+    uint32_t totalRunTime = 0;
+    bool hasRunTime = false;
+
+#if (configUSE_TRACE_FACILITY == 1)
+    UBaseType_t n = uxTaskGetSystemState(taskStatus, TASK_STATS_MAX_TASKS, &totalRunTime);
+    if (n == 0) {
+        Serial.printf("Task stats: more than %d tasks, raise TASK_STATS_MAX_TASKS\n", TASK_STATS_MAX_TASKS);
+        return;
+    }
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t& ts = taskStatus[i];
+        TaskSample& s = samples[count++];
+        strncpy(s.name, ts.pcTaskName, TASK_NAME_LEN - 1);
+        s.name[TASK_NAME_LEN - 1] = '\0';
+        s.taskNumber = ts.xTaskNumber;
+        s.runTime = ts.ulRunTimeCounter;
+        s.stackFreeBytes = ts.usStackHighWaterMark;  // ESP-IDF reports bytes
+#if (configTASKLIST_INCLUDE_COREID == 1)
+        s.core = ts.xCoreID < TASK_STATS_CORES ? (uint8_t)ts.xCoreID : TASK_CORE_ANY;
+#else
+        s.core = TASK_CORE_ANY;
+#endif
+        s.isIdle = false;
+        for (int c = 0; c < TASK_STATS_CORES; c++) {
+            if (ts.xHandle == xTaskGetIdleTaskHandleForCPU(c)) {
+                s.isIdle = true;
+                s.core = c;
+            }
+        }
+    }
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    hasRunTime = true;
+#endif
+#else
+    // No trace facility - the loop task's own stack is all we can see
+    TaskSample& s = samples[count++];
+    strncpy(s.name, pcTaskGetName(NULL), TASK_NAME_LEN - 1);
+    s.name[TASK_NAME_LEN - 1] = '\0';
+    s.taskNumber = 0;
+    s.runTime = 0;
+    s.stackFreeBytes = uxTaskGetStackHighWaterMark(NULL);
+    s.core = xPortGetCoreID();
+    s.isIdle = false;
+#endif
+
+    int alerts = aggregator.addSnapshot(millis(), samples, count, totalRunTime, hasRunTime);
+    for (int i = 0; i < alerts; i++) {
+        const TaskUsage& u = aggregator.alert(i);
+        Serial.printf("ALERT: task %s stack headroom %lu bytes (threshold %d)\n",
+                     u.name, (unsigned long)u.stackFreeBytes, TASK_STACK_ALERT_BYTES);
+    }
+}
+
+void RuntimeStats::report() {
+    const TaskStatsEntry* e = aggregator.latest();
+    if (e == nullptr) {
+        return;
+    }
+
+    Serial.print("Tasks:");
+    if (e->hasRunTime) {
+        Serial.print(" cores");
+        for (int c = 0; c < TASK_STATS_CORES; c++) {
+            Serial.printf(" %d.%d%%", e->coreBusyPermille[c] / 10, e->coreBusyPermille[c] % 10);
+        }
+        Serial.print(" |");
+    } else {
+        Serial.print(" cpu n/a |");
+    }
+    for (int i = 0; i < e->count; i++) {
+        const TaskUsage& u = e->tasks[i];
+        if (e->hasRunTime) {
+            Serial.printf(" %s %d.%d%% %luB", u.name, u.cpuPermille / 10, u.cpuPermille % 10,
+                         (unsigned long)u.stackFreeBytes);
+        } else {
+            Serial.printf(" %s %luB", u.name, (unsigned long)u.stackFreeBytes);
+        }
+    }
+    Serial.println();
+}
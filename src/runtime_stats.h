@@ -0,0 +1,22 @@
+#ifndef RUNTIME_STATS_H
+#define RUNTIME_STATS_H
+
+#include <Arduino.h>
+#include "task_stats.h"
+
+// FreeRTOS runtime statistics - per-task CPU share and stack headroom,
+// sampled periodically into a fixed ring and printed in the perf report.
+//
+// CPU figures need configGENERATE_RUN_TIME_STATS in the FreeRTOS build; the
+// stock Arduino core only provides stack high-water marks, in which case the
+// report shows "cpu n/a".
+class RuntimeStats {
+public:
+    static void sample();
+    static void report();
+
+private:
+    static TaskStatsAggregator aggregator;
+};
+
+#endif // RUNTIME_STATS_H
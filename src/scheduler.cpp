@@ -0,0 +1,181 @@
+#include "scheduler.h"
+#include <string.h>
+
+Scheduler::Scheduler() : numTasks(0), currentTick(0), microsSource(nullptr) {
+    memset(tasks, 0, sizeof(tasks));
+    memset(wheel, -1, sizeof(wheel));
+}
+
+void Scheduler::begin(uint64_t nowMs) {
+    currentTick = nowMs;
+}
+
+int Scheduler::addTask(const char* name, TaskCallback callback, uint32_t periodMs, uint32_t firstDelayMs) {
+    if (numTasks >= SCHEDULER_MAX_TASKS || callback == nullptr) {
+        return -1;
+    }
+    int id = numTasks++;
+    Task& t = tasks[id];
+    t.name = name;
+    t.callback = callback;
+    t.periodMs = periodMs;
+    t.level = -1;
+    t.next = -1;
+    t.deadline = currentTick + firstDelayMs;
+    insert(id, currentTick + 1);
+    return id;
+}
+
+void Scheduler::scheduleIn(int id, uint32_t delayMs, uint64_t nowMs) {
+    if (id < 0 || id >= numTasks) {
+        return;
+    }
+    unlink(id);
+    tasks[id].deadline = nowMs + delayMs;
+    insert(id, currentTick + 1);
+}
+
+void Scheduler::cancel(int id) {
+    if (id >= 0 && id < numTasks) {
+        unlink(id);
+    }
+}
+
+void Scheduler::insert(int id, uint64_t firstTick) {
+    Task& t = tasks[id];
+    uint64_t expires = t.deadline;
+    if (expires < firstTick) {
+        expires = firstTick;  // Overdue - run on the first tick still to be processed
+    }
+
+    // Pick the lowest level whose span covers the remaining delay
+    uint64_t delta = expires - currentTick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (LEVEL_BITS * (level + 1)))) {
+        level++;
+    }
+
+    // Beyond the wheel's range: park in the farthest top-level slot, re-placed on cascade
+    uint64_t range = 1ULL << (LEVEL_BITS * LEVELS);
+    if (delta >= range) {
+        expires = currentTick + range - 1;
+    }
+
+    int slot = (int)((expires >> (LEVEL_BITS * level)) & (SLOTS - 1));
+    t.level = level;
+    t.slot = slot;
+    t.next = wheel[level][slot];
+    wheel[level][slot] = id;
+}
+
+void Scheduler::unlink(int id) {
+    Task& t = tasks[id];
+    if (t.level < 0) {
+        return;
+    }
+    int8_t* link = &wheel[t.level][t.slot];
+    while (*link >= 0) {
+        if (*link == id) {
+            *link = t.next;
+            break;
+        }
+        link = &tasks[*link].next;
+    }
+    t.level = -1;
+    t.next = -1;
+}
+
+void Scheduler::cascade(int level) {
+    int slot = (int)((currentTick >> (LEVEL_BITS * level)) & (SLOTS - 1));
+    int8_t head = wheel[level][slot];
+    wheel[level][slot] = -1;
+
+    // Re-insert relative to the current tick - lands on a lower level. This
+    // tick's level-0 slot hasn't run yet, so a deadline on it still makes it.
+    while (head >= 0) {
+        int id = head;
+        head = tasks[id].next;
+        tasks[id].level = -1;
+        insert(id, currentTick);
+    }
+}
+
+void Scheduler::run(uint64_t nowMs) {
+    while (currentTick < nowMs) {
+        currentTick++;
+
+        // Lower level wrapped: pull the matching slot of each higher level down
+        for (int level = 1; level < LEVELS; level++) {
+            if ((currentTick & ((1ULL << (LEVEL_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        int slot = (int)(currentTick & (SLOTS - 1));
+        int8_t head = wheel[0][slot];
+        wheel[0][slot] = -1;
+        while (head >= 0) {
+            int id = head;
+            head = tasks[id].next;
+            tasks[id].level = -1;
+            tasks[id].next = -1;
+            runTask(id, nowMs);
+        }
+    }
+}
+
+void Scheduler::runTask(int id, uint64_t nowMs) {
+    Task& t = tasks[id];
+
+    uint32_t late = (uint32_t)(nowMs - t.deadline);
+    if (late > t.stats.lateMs) {
+        t.stats.lateMs = late;
+    }
+
+    uint32_t start = microsSource ? microsSource() : 0;
+    t.callback();
+    if (microsSource) {
+        uint32_t elapsed = microsSource() - start;
+        t.stats.totalUs += elapsed;
+        if (elapsed > t.stats.maxUs) {
+            t.stats.maxUs = elapsed;
+        }
+    }
+    t.stats.runs++;
+
+    // Periodic tasks keep their cadence; missed periods are skipped, not replayed
+    if (t.periodMs > 0 && t.level < 0) {
+        uint64_t next = t.deadline + t.periodMs;
+        if (next <= nowMs) {
+            next = nowMs + t.periodMs;
+        }
+        t.deadline = next;
+        insert(id, currentTick + 1);
+    }
+}
+
+uint64_t Scheduler::nextDeadline() const {
+    uint64_t earliest = UINT64_MAX;
+    for (int i = 0; i < numTasks; i++) {
+        if (tasks[i].level >= 0 && tasks[i].deadline < earliest) {
+            earliest = tasks[i].deadline;
+        }
+    }
+    return earliest;
+}
+
+uint32_t Scheduler::idleTimeMs(uint64_t nowMs, uint32_t maxIdleMs) const {
+    uint64_t next = nextDeadline();
+    if (next <= nowMs) {
+        return 0;
+    }
+    uint64_t idle = next - nowMs;
+    return idle > maxIdleMs ? maxIdleMs : (uint32_t)idle;
+}
+
+void Scheduler::resetStats() {
+    for (int i = 0; i < numTasks; i++) {
+        memset(&tasks[i].stats, 0, sizeof(tasks[i].stats));
+    }
+}
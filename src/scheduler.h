@@ -0,0 +1,99 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Cooperative scheduler built on a hierarchical timer wheel.
+// Time is 64-bit monotonic milliseconds, so deadlines survive the 49-day
+// millis() wraparound. No Arduino dependencies - the loop feeds it time.
+
+typedef void (*TaskCallback)();
+typedef uint32_t (*MicrosSource)();
+
+// Extends a wrapping 32-bit millisecond counter into a 64-bit monotonic one.
+// Must be sampled at least once per wrap period (~49 days).
+class MonotonicClock {
+public:
+    MonotonicClock() : lastRaw(0), high(0) {}
+
+    uint64_t extend(uint32_t raw) {
+        if (raw < lastRaw) {
+            high++;  // Counter wrapped since the previous sample
+        }
+        lastRaw = raw;
+        return ((uint64_t)high << 32) | raw;
+    }
+
+private:
+    uint32_t lastRaw;
+    uint32_t high;
+};
+
+// Per-task run-time accounting
+struct SchedulerTaskStats {
+    uint32_t runs;
+    uint64_t totalUs;
+    uint32_t maxUs;
+    uint32_t lateMs;  // Worst lateness against the deadline
+};
+
+class Scheduler {
+public:
+    Scheduler();
+
+    void begin(uint64_t nowMs);
+
+    // Register a task. periodMs == 0 makes it one-shot (re-arm with scheduleIn).
+    // Returns the task id or -1 when the table is full.
+    int addTask(const char* name, TaskCallback callback, uint32_t periodMs, uint32_t firstDelayMs);
+
+    // Move a task's next deadline to nowMs + delayMs
+    void scheduleIn(int id, uint32_t delayMs, uint64_t nowMs);
+    void cancel(int id);
+
+    // Advance the wheel to nowMs and run every task that came due
+    void run(uint64_t nowMs);
+
+    // Earliest armed deadline, or UINT64_MAX when nothing is armed
+    uint64_t nextDeadline() const;
+    // Milliseconds the loop may idle before the next deadline (capped)
+    uint32_t idleTimeMs(uint64_t nowMs, uint32_t maxIdleMs = 1000) const;
+
+    // Run-time accounting needs a microsecond clock (micros() on the device)
+    void setMicrosSource(MicrosSource source) { microsSource = source; }
+
+    int taskCount() const { return numTasks; }
+    const char* taskName(int id) const { return tasks[id].name; }
+    const SchedulerTaskStats& taskStats(int id) const { return tasks[id].stats; }
+    void resetStats();
+
+private:
+    static const int LEVEL_BITS = SCHEDULER_WHEEL_BITS;
+    static const int SLOTS = 1 << SCHEDULER_WHEEL_BITS;
+    static const int LEVELS = SCHEDULER_WHEEL_LEVELS;
+
+    struct Task {
+        const char* name;
+        TaskCallback callback;
+        uint32_t periodMs;
+        uint64_t deadline;
+        int8_t next;      // Next task in the same slot, -1 terminates
+        int8_t level;     // Wheel position while armed, -1 when idle
+        uint8_t slot;
+        SchedulerTaskStats stats;
+    };
+
+    Task tasks[SCHEDULER_MAX_TASKS];
+    int numTasks;
+    int8_t wheel[SCHEDULER_WHEEL_LEVELS][1 << SCHEDULER_WHEEL_BITS];
+    uint64_t currentTick;  // Last tick the wheel has processed
+    MicrosSource microsSource;
+
+    void insert(int id, uint64_t firstTick);
+    void unlink(int id);
+    void cascade(int level);
+    void runTask(int id, uint64_t nowMs);
+};
+
+#endif // SCHEDULER_H
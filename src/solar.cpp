@@ -0,0 +1,115 @@
+#include "solar.h"
+#include <math.h>
+
+#define DEG_TO_RADF 0.017453293f
+#define RAD_TO_DEGF 57.29578f
+#define J2000_EPOCH 946728000L      // 2000-01-01 12:00 UTC
+#define SUNRISE_ZENITH 90.833f      // Refraction and solar disc radius
+#define CIVIL_ZENITH 96.0f
+
+// Declination (radians) and equation of time (minutes) at an instant
+static void sunPosition(uint32_t epoch, float& declination, float& eqTime) {
+    // Julian centuries since J2000; kept small so float keeps its precision
+    float jc = (float)((int32_t)(epoch - J2000_EPOCH)) / (86400.0f * 36525.0f);
+
+    float meanLong = fmodf(280.46646f + jc * (36000.76983f + jc * 0.0003032f), 360.0f);
+    float meanAnom = 357.52911f + jc * (35999.05029f - 0.0001537f * jc);
+    float eccent = 0.016708634f - jc * (0.000042037f + 0.0000001267f * jc);
+
+    float m = meanAnom * DEG_TO_RADF;
+    float center = sinf(m) * (1.914602f - jc * (0.004817f + 0.000014f * jc))
+                 + sinf(2 * m) * (0.019993f - 0.000101f * jc)
+                 + sinf(3 * m) * 0.000289f;
+    float omega = (125.04f - 1934.136f * jc) * DEG_TO_RADF;
+    float apparentLong = (meanLong + center - 0.00569f - 0.00478f * sinf(omega)) * DEG_TO_RADF;
+
+    float meanObliq = 23.0f + (26.0f + (21.448f - jc * (46.815f + jc * (0.00059f - jc * 0.001813f))) / 60.0f) / 60.0f;
+    float obliq = (meanObliq + 0.00256f * cosf(omega)) * DEG_TO_RADF;
+    declination = asinf(sinf(obliq) * sinf(apparentLong));
+
+    float y = tanf(obliq / 2);
+    y *= y;
+    float l0 = meanLong * DEG_TO_RADF;
+    eqTime = 4.0f * RAD_TO_DEGF * (y * sinf(2 * l0) - 2 * eccent * sinf(m)
+                                   + 4 * eccent * y * sinf(m) * cosf(2 * l0)
+                                   - 0.5f * y * y * sinf(4 * l0)
+                                   - 1.25f * eccent * eccent * sinf(2 * m));
+}
+
+// Noon of mean solar time (no equation of time) nearest to `near`
+static int32_t meanSolarNoon(float longitude, uint32_t near) {
+    int32_t utcMidnight = (int32_t)(near - near % 86400);
+    int32_t noon = utcMidnight + (int32_t)lroundf((720.0f - 4.0f * longitude) * 60.0f);
+    // Longitude can put the nearest noon on the neighbouring UTC date
+    if (noon - (int32_t)near > 43200) {
+        noon -= 86400;
+    } else if ((int32_t)near - noon > 43200) {
+        noon += 86400;
+    }
+    return noon;
+}
+
+// Hour angle (degrees) for the zenith; returns false when the sun never reaches it
+static bool hourAngle(float latitude, float declination, float zenith, float& angle, bool& alwaysAbove) {
+    float lat = latitude * DEG_TO_RADF;
+    float cosHa = cosf(zenith * DEG_TO_RADF) / (cosf(lat) * cosf(declination)) - tanf(lat) * tanf(declination);
+    if (cosHa > 1.0f || cosHa < -1.0f) {
+        alwaysAbove = cosHa < -1.0f;
+        return false;
+    }
+    angle = acosf(cosHa) * RAD_TO_DEGF;
+    return true;
+}
+
+// Time the sun crosses the zenith before (sign -1) or after (sign +1) noon, 0 if it never does.
+// Sun position is re-evaluated at the estimate, which converges in two passes.
+// Near the polar limits the event sits close to noon or midnight, where the
+// declination differs enough to matter, so those are tried as starting points too.
+static uint32_t solarEvent(float latitude, int32_t meanNoon, float zenith, int sign, bool& alwaysAbove) {
+    static const int32_t STARTS[] = {21600, 0, 43200};
+    for (int32_t start : STARTS) {
+        int32_t t = meanNoon + sign * start;
+        bool found = true;
+        for (int i = 0; i < 2 && found; i++) {
+            float declination, eqTime, angle;
+            sunPosition((uint32_t)t, declination, eqTime);
+            found = hourAngle(latitude, declination, zenith, angle, alwaysAbove);
+            if (found) {
+                t = meanNoon - (int32_t)lroundf(eqTime * 60.0f) + sign * (int32_t)lroundf(angle * 240.0f);  // 4 min per degree
+            }
+        }
+        if (found) {
+            return (uint32_t)t;
+        }
+    }
+    return 0;
+}
+
+void solarEventTimes(float latitude, float longitude, uint32_t nearEpoch, SolarTimes& out) {
+    int32_t meanNoon = meanSolarNoon(longitude, nearEpoch);
+    float declination, eqTime;
+    sunPosition((uint32_t)meanNoon, declination, eqTime);
+    out.noon = (uint32_t)(meanNoon - (int32_t)lroundf(eqTime * 60.0f));
+
+    bool alwaysAbove = false;
+    out.sunrise = solarEvent(latitude, meanNoon, SUNRISE_ZENITH, -1, alwaysAbove);
+    out.sunset = out.sunrise ? solarEvent(latitude, meanNoon, SUNRISE_ZENITH, 1, alwaysAbove) : 0;
+    if (out.sunrise == 0 || out.sunset == 0) {
+        out.sunrise = out.sunset = 0;
+        out.dayType = alwaysAbove ? SOLAR_DAY_POLAR_DAY : SOLAR_DAY_POLAR_NIGHT;
+    } else {
+        out.dayType = SOLAR_DAY_NORMAL;
+    }
+
+    bool unused;
+    out.dawn = solarEvent(latitude, meanNoon, CIVIL_ZENITH, -1, unused);
+    out.dusk = out.dawn ? solarEvent(latitude, meanNoon, CIVIL_ZENITH, 1, unused) : 0;
+}
+
+bool solarIsNight(const SolarTimes& times, uint32_t now) {
+    switch (times.dayType) {
+        case SOLAR_DAY_POLAR_DAY: return false;
+        case SOLAR_DAY_POLAR_NIGHT: return true;
+        default: return now < times.sunrise || now >= times.sunset;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SOLAR_H
+#define SOLAR_H
+
+#include <stdint.h>
+
+// NOAA solar position approximations for sunrise, sunset and civil twilight.
+// Single-precision float; accurate to well under a minute at non-polar
+// latitudes. No Arduino dependencies.
+
+enum SolarDayType : uint8_t {
+    SOLAR_DAY_NORMAL = 0,   // Sun rises and sets
+    SOLAR_DAY_POLAR_DAY,    // Sun stays above the horizon
+    SOLAR_DAY_POLAR_NIGHT   // Sun stays below the horizon
+};
+
+struct SolarTimes {
+    uint32_t dawn;      // Civil twilight start (sun 6 degrees below), 0 if none
+    uint32_t sunrise;   // UTC epochs; 0 unless dayType is SOLAR_DAY_NORMAL
+    uint32_t noon;
+    uint32_t sunset;
+    uint32_t dusk;      // Civil twilight end, 0 if none
+    uint8_t dayType;
+};
+
+// Events of the solar day whose noon is nearest to nearEpoch (pass local noon
+// to get the local calendar day). Coordinates in degrees, east and north positive.
+void solarEventTimes(float latitude, float longitude, uint32_t nearEpoch, SolarTimes& out);
+
+// Night per the computed times: before sunrise or from sunset on
+bool solarIsNight(const SolarTimes& times, uint32_t now);
+
+#endif // SOLAR_H
@@ -0,0 +1,76 @@
+#include "solar_clock.h"
+#include "weather_conditions.h"
+#include "weather_format.h"
+
+SolarClock::SolarClock() :
+    hasLocation(false),
+    computed(false),
+    latitudeE4(0),
+    longitudeE4(0),
+    todayNoon(0),
+    nextCheck(0) {
+    today = SolarTimes();
+}
+
+void SolarClock::begin() {
+    prefs.begin("solar", false);
+    if (prefs.isKey("lat") && prefs.isKey("lon")) {
+        latitudeE4 = prefs.getInt("lat", 0);
+        longitudeE4 = prefs.getInt("lon", 0);
+        hasLocation = true;
+        Serial.printf("Solar: cached location %.4f, %.4f\n", latitudeE4 / 10000.0f, longitudeE4 / 10000.0f);
+    }
+}
+
+void SolarClock::setLocation(int32_t latitudeE4In, int32_t longitudeE4In) {
+    if (latitudeE4In == 0 && longitudeE4In == 0) {
+        return;  // Response had no coord block
+    }
+    bool moved = !hasLocation ||
+                 abs(latitudeE4In - latitudeE4) >= SOLAR_LOCATION_SAVE_E4 ||
+                 abs(longitudeE4In - longitudeE4) >= SOLAR_LOCATION_SAVE_E4;
+    if (!moved) {
+        return;
+    }
+    latitudeE4 = latitudeE4In;
+    longitudeE4 = longitudeE4In;
+    hasLocation = true;
+    prefs.putInt("lat", latitudeE4);
+    prefs.putInt("lon", longitudeE4);
+    nextCheck = 0;  // Recompute for the new location
+    todayNoon = 0;
+}
+
+bool SolarClock::service(uint32_t now) {
+    if (!hasLocation || now < SOLAR_MIN_EPOCH || now < nextCheck) {
+        return false;
+    }
+
+    uint32_t noon = localNoon(now);
+    nextCheck = noon + 12 * 3600;  // Local midnight, give or take a DST hour
+    if (nextCheck <= now) {
+        nextCheck = now + 3600;
+    }
+    if (noon == todayNoon && computed) {
+        return false;
+    }
+
+    todayNoon = noon;
+    solarEventTimes(latitudeE4 / 10000.0f, longitudeE4 / 10000.0f, noon, today);
+    computed = true;
+
+    char rise[10], set[10], dawn[10], dusk[10];
+    formatLocalTime(today.sunrise, rise, sizeof(rise));
+    formatLocalTime(today.sunset, set, sizeof(set));
+    formatLocalTime(today.dawn, dawn, sizeof(dawn));
+    formatLocalTime(today.dusk, dusk, sizeof(dusk));
+    Serial.printf("Solar: dawn %s, sunrise %s, sunset %s, dusk %s\n", dawn, rise, set, dusk);
+    return true;
+}
+
+uint8_t SolarClock::applyDayNight(uint8_t icon, uint32_t now) const {
+    if (!computed || WEATHER_ICON_CODE(icon) == ICON_NONE) {
+        return icon;  // Keep the API's variant until we have our own times
+    }
+    return solarIsNight(today, now) ? (uint8_t)(icon | WEATHER_ICON_NIGHT) : WEATHER_ICON_CODE(icon);
+}
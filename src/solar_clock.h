@@ -0,0 +1,42 @@
+#ifndef SOLAR_CLOCK_H
+#define SOLAR_CLOCK_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+#include "solar.h"
+
+// Local sunrise/sunset from the city's coordinates. The coordinates come
+// from the API and are cached in NVS, so the times (and the day/night icon
+// variant) stay right across reboots and while offline.
+class SolarClock {
+public:
+    SolarClock();
+
+    // Restore the cached coordinates
+    void begin();
+
+    // Coordinates from an API response, 1e-4 degree; persisted when they move
+    void setLocation(int32_t latitudeE4, int32_t longitudeE4);
+
+    // Recompute once per local day. Returns true when the times changed.
+    bool service(uint32_t now);
+
+    bool valid() const { return computed; }
+    const SolarTimes& times() const { return today; }
+
+    // Icon byte with its night flag set from the computed sunrise/sunset
+    uint8_t applyDayNight(uint8_t icon, uint32_t now) const;
+
+private:
+    Preferences prefs;
+    bool hasLocation;
+    bool computed;
+    int32_t latitudeE4;
+    int32_t longitudeE4;
+    SolarTimes today;
+    uint32_t todayNoon;    // localNoon() the times belong to
+    uint32_t nextCheck;    // Epoch to look for a day change again
+};
+
+#endif // SOLAR_CLOCK_H
@@ -0,0 +1,76 @@
+#include "stall_monitor.h"
+#include "esp_timer.h"
+
+// Survives software and watchdog resets; validated by magic on boot
+RTC_NOINIT_ATTR static StallLog stallLog;
+
+StallTracker StallMonitor::tracker;
+static portMUX_TYPE stallMux = portMUX_INITIALIZER_UNLOCKED;
+
+void StallMonitor::begin() {
+    portENTER_CRITICAL(&stallMux);
+    tracker.attach(&stallLog, millis());
+    portEXIT_CRITICAL(&stallMux);
+
+    // esp_timer callbacks run in the high-priority timer task on the other core,
+    // so sampling continues while loop() is blocked
+    esp_timer_create_args_t args = {};
+    args.callback = &StallMonitor::timerCallback;
+    args.name = "stallwd";
+    esp_timer_handle_t timer;
+    if (esp_timer_create(&args, &timer) == ESP_OK) {
+        esp_timer_start_periodic(timer, (uint64_t)STALL_CHECK_INTERVAL_MS * 1000);
+    } else {
+        Serial.println("Stall monitor: failed to create timer");
+    }
+
+    Serial.printf("Stall monitor: boot %d, %d stalls on record\n",
+                 stallLog.bootCount, stallLog.count);
+}
+
+void StallMonitor::timerCallback(void* arg) {
+    portENTER_CRITICAL(&stallMux);
+    tracker.check(millis());
+    portEXIT_CRITICAL(&stallMux);
+}
+
+void StallMonitor::heartbeat() {
+    portENTER_CRITICAL(&stallMux);
+    tracker.heartbeat(millis());
+    portEXIT_CRITICAL(&stallMux);
+}
+
+uint8_t StallMonitor::enterRegion(uint8_t region) {
+    return tracker.enterRegion(region);
+}
+
+void StallMonitor::exitRegion(uint8_t previous) {
+    tracker.exitRegion(previous);
+}
+
+void StallMonitor::report() {
+    const StallLog* log = tracker.getLog();
+    if (log == nullptr) {
+        return;
+    }
+
+    Serial.print("Stalls:");
+    for (int r = 0; r < STALL_REGION_COUNT; r++) {
+        const StallRegionStats& stats = log->regions[r];
+        if (stats.count > 0) {
+            Serial.printf(" %s n=%lu avg=%lums max=%lums", stallRegionName(r),
+                         (unsigned long)stats.count, (unsigned long)(stats.totalMs / stats.count),
+                         (unsigned long)stats.maxMs);
+        }
+    }
+    if (log->count == 0) {
+        Serial.print(" none");
+    }
+    Serial.println();
+
+    for (int i = 0; i < STALL_REPORT_RECENT && i < log->count; i++) {
+        const StallRecord* rec = tracker.recent(i);
+        Serial.printf("  stall boot=%u at=%lums gap=%lums region=%s\n", rec->boot,
+                     (unsigned long)rec->startMs, (unsigned long)rec->gapMs, stallRegionName(rec->region));
+    }
+}
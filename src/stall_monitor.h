@@ -0,0 +1,36 @@
+#ifndef STALL_MONITOR_H
+#define STALL_MONITOR_H
+
+#include <Arduino.h>
+#include "stall_tracker.h"
+
+// Loop-stall watchdog. A high-priority esp_timer samples the loop() heartbeat;
+// gaps over STALL_THRESHOLD_MS are attributed to the instrumented region that
+// was active and kept in a ring in RTC memory, so they survive resets.
+class StallMonitor {
+public:
+    static void begin();
+    static void heartbeat();
+
+    static uint8_t enterRegion(uint8_t region);
+    static void exitRegion(uint8_t previous);
+
+    // Perf report section: per-region counts and the latest stalls
+    static void report();
+
+private:
+    static StallTracker tracker;
+    static void timerCallback(void* arg);
+};
+
+// Marks a blocking region for stall attribution for the lifetime of the scope
+class StallScope {
+public:
+    explicit StallScope(uint8_t region) : previous(StallMonitor::enterRegion(region)) {}
+    ~StallScope() { StallMonitor::exitRegion(previous); }
+
+private:
+    uint8_t previous;
+};
+
+#endif // STALL_MONITOR_H
@@ -0,0 +1,96 @@
+#include "stall_tracker.h"
+#include <string.h>
+
+#define STALL_LOG_MAGIC 0x53544C31  // "STL1" - bump when StallLog changes
+
+const char* stallRegionName(uint8_t region) {
+    switch (region) {
+        case STALL_REGION_NONE: return "other";
+        case STALL_REGION_FETCH: return "fetch";
+        case STALL_REGION_NTP: return "ntp";
+        case STALL_REGION_DRAW: return "draw";
+        case STALL_REGION_LOG_FLUSH: return "logflush";
+        default: return "unknown";
+    }
+}
+
+StallTracker::StallTracker() :
+    log(nullptr),
+    lastHeartbeat(0),
+    activeRegion(STALL_REGION_NONE),
+    stallRegion(STALL_REGION_NONE),
+    stallOpen(false) {
+}
+
+void StallTracker::attach(StallLog* storage, uint32_t nowMs) {
+    log = storage;
+    if (log->magic != STALL_LOG_MAGIC || log->head >= STALL_LOG_SIZE || log->count > STALL_LOG_SIZE) {
+        memset(log, 0, sizeof(StallLog));
+        log->magic = STALL_LOG_MAGIC;
+    }
+    log->bootCount++;
+    lastHeartbeat = nowMs;
+    stallOpen = false;
+}
+
+uint8_t StallTracker::enterRegion(uint8_t region) {
+    uint8_t previous = activeRegion;
+    activeRegion = region;
+    return previous;
+}
+
+void StallTracker::check(uint32_t nowMs) {
+    if (log == nullptr || nowMs - lastHeartbeat < STALL_THRESHOLD_MS) {
+        return;
+    }
+
+    // Attribute to the region seen when the stall was first noticed;
+    // upgrade from "other" if an instrumented region shows up later
+    if (!stallOpen) {
+        stallOpen = true;
+        stallRegion = activeRegion;
+    } else if (stallRegion == STALL_REGION_NONE) {
+        stallRegion = activeRegion;
+    }
+}
+
+void StallTracker::heartbeat(uint32_t nowMs) {
+    uint32_t gap = nowMs - lastHeartbeat;
+    if (log != nullptr && (stallOpen || gap >= STALL_THRESHOLD_MS)) {
+        // A gap the timer never sampled could not be attributed
+        record(lastHeartbeat, gap, stallOpen ? stallRegion : (uint8_t)STALL_REGION_NONE);
+    }
+    lastHeartbeat = nowMs;
+    stallOpen = false;
+}
+
+void StallTracker::record(uint32_t startMs, uint32_t gapMs, uint8_t region) {
+    if (region >= STALL_REGION_COUNT) {
+        region = STALL_REGION_NONE;
+    }
+
+    StallRecord& rec = log->records[log->head];
+    rec.startMs = startMs;
+    rec.gapMs = gapMs;
+    rec.boot = log->bootCount;
+    rec.region = region;
+    log->head = (log->head + 1) % STALL_LOG_SIZE;
+    if (log->count < STALL_LOG_SIZE) {
+        log->count++;
+    }
+
+    StallRegionStats& stats = log->regions[region];
+    stats.count++;
+    stats.totalMs += gapMs;
+    if (gapMs > stats.maxMs) {
+        stats.maxMs = gapMs;
+    }
+}
+
+const StallRecord* StallTracker::recent(int index) const {
+    if (log == nullptr || index < 0 || index >= log->count) {
+        return nullptr;
+    }
+    int slot = (log->head + STALL_LOG_SIZE - 1 - index) % STALL_LOG_SIZE;
+    return &log->records[slot];
+}
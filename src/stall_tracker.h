@@ -0,0 +1,79 @@
+#ifndef STALL_TRACKER_H
+#define STALL_TRACKER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Loop-stall detection and attribution logic. No Arduino dependencies - the
+// device glue (stall_monitor.h) feeds it the heartbeat and timer samples.
+
+// Instrumented regions a stall can be attributed to
+enum StallRegion : uint8_t {
+    STALL_REGION_NONE = 0,   // Outside any instrumented region
+    STALL_REGION_FETCH,
+    STALL_REGION_NTP,
+    STALL_REGION_DRAW,
+    STALL_REGION_LOG_FLUSH,
+    STALL_REGION_COUNT
+};
+
+const char* stallRegionName(uint8_t region);
+
+struct StallRecord {
+    uint32_t startMs;   // Uptime of the last heartbeat before the stall
+    uint32_t gapMs;     // Heartbeat gap
+    uint16_t boot;      // Boot number the stall happened in
+    uint8_t region;
+};
+
+struct StallRegionStats {
+    uint32_t count;
+    uint32_t totalMs;
+    uint32_t maxMs;
+};
+
+// Persistent layout - lives in RTC memory on the device so it survives resets
+struct StallLog {
+    uint32_t magic;
+    uint16_t bootCount;
+    uint16_t head;       // Next record slot
+    uint16_t count;      // Valid records, up to STALL_LOG_SIZE
+    StallRecord records[STALL_LOG_SIZE];
+    StallRegionStats regions[STALL_REGION_COUNT];
+};
+
+class StallTracker {
+public:
+    StallTracker();
+
+    // Attach storage; resets it unless it already holds a valid log
+    void attach(StallLog* storage, uint32_t nowMs);
+
+    // Loop heartbeat - closes and records any stall in progress
+    void heartbeat(uint32_t nowMs);
+
+    // Periodic sample from the watchdog timer - notes the active region of an ongoing stall
+    void check(uint32_t nowMs);
+
+    // Region bookkeeping; enter returns the previous region for nesting
+    uint8_t enterRegion(uint8_t region);
+    void exitRegion(uint8_t previous) { activeRegion = previous; }
+    uint8_t currentRegion() const { return activeRegion; }
+
+    bool stallInProgress() const { return stallOpen; }
+    const StallLog* getLog() const { return log; }
+
+    // Most recent record first; index 0 .. count-1
+    const StallRecord* recent(int index) const;
+
+private:
+    StallLog* log;
+    uint32_t lastHeartbeat;
+    volatile uint8_t activeRegion;
+    uint8_t stallRegion;
+    bool stallOpen;
+
+    void record(uint32_t startMs, uint32_t gapMs, uint8_t region);
+};
+
+#endif // STALL_TRACKER_H
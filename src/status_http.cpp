@@ -0,0 +1,421 @@
+#include "status_http.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "weather_format.h"
+
+// ErrorHandler::ErrorType order
+static const char* const ERROR_LABELS[STATUS_ERROR_TYPES] = {"http", "json", "network", "time"};
+
+static const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 503: return "Service Unavailable";
+        default: return "Error";
+    }
+}
+
+HttpResponse::HttpResponse(uint8_t* buffer, size_t size, HttpSink sink, void* context)
+    : buffer(buffer), size(size), used(0), sink(sink), context(context), status(0), sent(0), failed(false) {
+}
+
+void HttpResponse::flush() {
+    if (used > 0 && !failed) {
+        failed = !sink(context, buffer, used);
+        sent += used;
+    }
+    used = 0;
+}
+
+void HttpResponse::begin(int code, const char* contentType, int32_t contentLength) {
+    status = code;
+    printf("HTTP/1.1 %d %s\r\nContent-Type: %s\r\nConnection: close\r\nCache-Control: no-store\r\n",
+           code, statusText(code), contentType);
+    if (contentLength >= 0) {
+        printf("Content-Length: %ld\r\n", (long)contentLength);
+    }
+    print("\r\n");
+}
+
+void HttpResponse::write(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (len > 0 && !failed) {
+        if (used == size) {
+            flush();
+        }
+        size_t n = size - used < len ? size - used : len;
+        memcpy(buffer + used, p, n);
+        used += n;
+        p += n;
+        len -= n;
+    }
+}
+
+void HttpResponse::print(const char* text) {
+    write(text, strlen(text));
+}
+
+void HttpResponse::printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list retry;
+    va_copy(retry, args);
+    int n = vsnprintf((char*)buffer + used, size - used, fmt, args);
+    if (n >= 0 && (size_t)n >= size - used) {
+        // Didn't fit behind what is buffered; lines longer than the buffer are cut
+        flush();
+        n = vsnprintf((char*)buffer, size, fmt, retry);
+        if ((size_t)n >= size) {
+            n = (int)size - 1;
+        }
+    }
+    if (n > 0) {
+        used += (size_t)n;
+    }
+    va_end(retry);
+    va_end(args);
+}
+
+void HttpResponse::printJson(const char* text) {
+    write("\"", 1);
+    const char* run = text;
+    for (const char* p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        write(run, (size_t)(p - run));
+        run = p + 1;
+        if (c == '"' || c == '\\') {
+            char escaped[2] = {'\\', (char)c};
+            write(escaped, 2);
+        } else {
+            printf("\\u%04x", c);
+        }
+    }
+    write(run, strlen(run));
+    write("\"", 1);
+}
+
+bool HttpResponse::end() {
+    flush();
+    return !failed;
+}
+
+static bool copyToken(const char* start, const char* end, char* out, size_t outSize) {
+    size_t n = (size_t)(end - start);
+    if (n >= outSize) {
+        return false;
+    }
+    memcpy(out, start, n);
+    out[n] = '\0';
+    return true;
+}
+
+bool parseRequestLine(const char* line, size_t len, HttpRequest* req) {
+    const char* end = line + len;
+    const char* eol = (const char*)memchr(line, '\n', len);
+    if (eol != nullptr) {
+        end = eol;
+    }
+
+    const char* sp1 = (const char*)memchr(line, ' ', (size_t)(end - line));
+    if (sp1 == nullptr) return false;
+    const char* target = sp1 + 1;
+    const char* sp2 = (const char*)memchr(target, ' ', (size_t)(end - target));
+    if (sp2 == nullptr || strncmp(sp2 + 1, "HTTP/", 5) != 0) return false;
+    if (!copyToken(line, sp1, req->method, sizeof(req->method))) return false;
+
+    const char* q = (const char*)memchr(target, '?', (size_t)(sp2 - target));
+    if (!copyToken(target, q != nullptr ? q : sp2, req->path, sizeof(req->path))) return false;
+    if (q != nullptr) {
+        if (!copyToken(q + 1, sp2, req->query, sizeof(req->query))) return false;
+    } else {
+        req->query[0] = '\0';
+    }
+    return req->path[0] == '/';
+}
+
+QueryResult queryUint(const char* query, const char* name, uint32_t* value) {
+    size_t nameLen = strlen(name);
+    const char* p = query;
+    while (*p != '\0') {
+        if (strncmp(p, name, nameLen) == 0 && p[nameLen] == '=') {
+            p += nameLen + 1;
+            uint64_t v = 0;
+            int digits = 0;
+            while (*p >= '0' && *p <= '9') {
+                v = v * 10 + (uint64_t)(*p++ - '0');
+                if (v > UINT32_MAX) return QUERY_INVALID;
+                digits++;
+            }
+            if (digits == 0 || (*p != '\0' && *p != '&')) return QUERY_INVALID;
+            *value = (uint32_t)v;
+            return QUERY_OK;
+        }
+        const char* amp = strchr(p, '&');
+        if (amp == nullptr) break;
+        p = amp + 1;
+    }
+    return QUERY_MISSING;
+}
+
+static void sendError(HttpResponse& res, int status, const char* message) {
+    res.begin(status, "application/json");
+    res.printf("{\"error\":\"%s\"}\n", message);
+}
+
+static void serveIndex(HttpResponse& res) {
+    res.begin(200, "text/plain");
+    res.print("/weather     current observation (JSON)\n"
+              "/metrics     Prometheus metrics\n"
+              "/history     hourly temperatures, ?from=&to= UTC epoch seconds (JSON)\n"
+              "/wifi        link state, reconnects, networks and RSSI history (JSON)\n"
+              "/screenshot  current screen (BMP)\n");
+}
+
+static void serveWeather(HttpResponse& res, const StatusSnapshot& snap) {
+    const WeatherData& w = snap.weather;
+    if (snap.units == nullptr || w.lastUpdated == 0) {
+        sendError(res, 503, "no data yet");
+        return;
+    }
+    char temp[8], feels[8], low[8], high[8], wind[8], vis[8], icon[4];
+    formatFixed(temp, sizeof(temp), w.temperature, TEMP_SCALE, 1);
+    formatFixed(feels, sizeof(feels), w.feelsLike, TEMP_SCALE, 1);
+    formatFixed(low, sizeof(low), w.minTemp, TEMP_SCALE, 1);
+    formatFixed(high, sizeof(high), w.maxTemp, TEMP_SCALE, 1);
+    formatFixed(wind, sizeof(wind), w.windSpeed, WIND_SCALE, 1);
+    formatFixed(vis, sizeof(vis), w.visibility, VISIBILITY_SCALE, 1);
+    weatherIconString(w.icon, icon);
+
+    res.begin(200, "application/json");
+    res.printf("{\"updated\":%lu,\"temperature\":%s,\"feels_like\":%s,\"min\":%s,\"max\":%s,",
+               (unsigned long)w.lastUpdated, temp, feels, low, high);
+    res.printf("\"humidity\":%u,\"pressure\":%u,\"wind\":%s,\"visibility\":%s,\"clouds\":%u,",
+               w.humidity, w.pressure, wind, vis, w.cloudCoverage);
+    res.printf("\"condition\":%u,\"description\":", w.conditionId);
+    res.printJson(conditionDescription(w.conditionId));
+    res.printf(",\"icon\":\"%s\",\"sunrise\":%lu,\"sunset\":%lu,", icon,
+               (unsigned long)w.sunrise, (unsigned long)w.sunset);
+    res.printf("\"units\":{\"temperature\":\"%s\",\"wind\":\"%s\",\"visibility\":\"%s\"}}\n",
+               snap.units->tempSymbol, snap.units->windSuffix, snap.units->distSuffix);
+}
+
+static void serveHistory(HttpResponse& res, const StatusSnapshot& snap, const char* query) {
+    uint32_t from = 0;
+    uint32_t to = UINT32_MAX;
+    if (queryUint(query, "from", &from) == QUERY_INVALID || queryUint(query, "to", &to) == QUERY_INVALID) {
+        sendError(res, 400, "from and to are UTC epoch seconds");
+        return;
+    }
+
+    res.begin(200, "application/json");
+    res.printf("{\"unit\":\"%s\",\"samples\":[", snap.units != nullptr ? snap.units->tempSymbol : "");
+    bool first = true;
+    for (uint8_t i = 0; i < snap.history.count(); i++) {
+        const TemperatureSample& s = snap.history.at(i);
+        if (s.epoch < from || s.epoch > to) {
+            continue;
+        }
+        char temp[8];
+        formatFixed(temp, sizeof(temp), s.temperature, TEMP_SCALE, 1);
+        res.printf("%s{\"t\":%lu,\"temp\":%s}", first ? "" : ",", (unsigned long)s.epoch, temp);
+        first = false;
+    }
+    res.print("]}\n");
+}
+
+static void serveWifi(HttpResponse& res, const StatusSnapshot& snap) {
+    const WifiLinkSnapshot& l = snap.link;
+    res.begin(200, "application/json");
+    res.printf("{\"state\":\"%s\",\"ssid\":", wifiLinkStateName(l.state));
+    res.printJson(l.network >= 0 && l.network < l.networkCount ? l.ssids[l.network] : "");
+    res.printf(",\"bssid\":\"%02x:%02x:%02x:%02x:%02x:%02x\",\"channel\":%u,",
+               l.bssid[0], l.bssid[1], l.bssid[2], l.bssid[3], l.bssid[4], l.bssid[5], l.channel);
+    res.printf("\"uptime\":%lu,\"last_outage_ms\":%lu,\"connects\":%lu,\"reconnects\":%lu,"
+               "\"disconnects\":%lu,\"roams\":%lu,\"failed_attempts\":%lu,\"networks\":[",
+               (unsigned long)l.uptimeSeconds, (unsigned long)l.lastOutageMs, (unsigned long)l.connects,
+               (unsigned long)l.reconnects, (unsigned long)l.disconnects, (unsigned long)l.roams,
+               (unsigned long)l.failedAttempts);
+    for (uint8_t i = 0; i < l.networkCount; i++) {
+        const WifiNetworkStats& n = l.networks[i];
+        res.print(i ? ",{\"ssid\":" : "{\"ssid\":");
+        res.printJson(l.ssids[i]);
+        res.printf(",\"successes\":%lu,\"failures\":%lu,\"rssi\":%d}",
+                   (unsigned long)n.successes, (unsigned long)n.failures, n.lastRssi);
+    }
+    res.printf("],\"rssi_interval_s\":%u,\"rssi\":[", WIFI_RSSI_SAMPLE_MS / 1000);
+    for (uint8_t i = 0; i < l.rssi.count(); i++) {
+        res.printf("%s%d", i ? "," : "", l.rssi.at(i));
+    }
+    res.print("]}\n");
+}
+
+static void metricHeader(HttpResponse& res, const char* name, const char* type, const char* help) {
+    res.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void serveMetrics(HttpResponse& res, const StatusSnapshot& snap) {
+    const StatusMetrics& m = snap.metrics;
+    char value[16];
+    res.begin(200, "text/plain; version=0.0.4");
+
+    metricHeader(res, "weather_uptime_seconds", "counter", "Time since boot.");
+    res.printf("weather_uptime_seconds %lu\n", (unsigned long)m.health.uptimeSeconds);
+
+    metricHeader(res, "weather_heap_free_bytes", "gauge", "Free heap.");
+    res.printf("weather_heap_free_bytes %lu\n", (unsigned long)m.health.freeHeap);
+    metricHeader(res, "weather_heap_min_free_bytes", "gauge", "Lowest free heap since boot.");
+    res.printf("weather_heap_min_free_bytes %lu\n", (unsigned long)m.health.minFreeHeap);
+    metricHeader(res, "weather_heap_largest_block_bytes", "gauge", "Largest allocatable block.");
+    res.printf("weather_heap_largest_block_bytes %lu\n", (unsigned long)m.health.largestBlock);
+
+    formatFixed(value, sizeof(value), m.health.fpsTenths, 10, 1);
+    metricHeader(res, "weather_frames_per_second", "gauge", "Frame rate over the last report window.");
+    res.printf("weather_frames_per_second %s\n", value);
+    formatFixed(value, sizeof(value), (int32_t)m.health.frameMaxMicros, 1000000, 6);
+    metricHeader(res, "weather_frame_time_max_seconds", "gauge", "Slowest frame in the last report window.");
+    res.printf("weather_frame_time_max_seconds %s\n", value);
+    metricHeader(res, "weather_frames_over_budget", "gauge", "Frames over FRAME_BUDGET_US in the last report window.");
+    res.printf("weather_frames_over_budget %lu\n", (unsigned long)m.framesOverBudget);
+
+    formatFixed(value, sizeof(value), (int32_t)m.lastFetchMs, 1000, 3);
+    metricHeader(res, "weather_fetch_duration_seconds", "gauge", "Duration of the last weather fetch.");
+    res.printf("weather_fetch_duration_seconds %s\n", value);
+    formatFixed(value, sizeof(value), (int32_t)m.lastFetchDnsMs, 1000, 3);
+    metricHeader(res, "weather_fetch_dns_seconds", "gauge", "DNS part of the last weather fetch, 0 from the cache.");
+    res.printf("weather_fetch_dns_seconds %s\n", value);
+    metricHeader(res, "weather_fetches_total", "counter", "Weather fetches by result.");
+    res.printf("weather_fetches_total{result=\"ok\"} %lu\n", (unsigned long)m.fetchesOk);
+    res.printf("weather_fetches_total{result=\"failed\"} %lu\n", (unsigned long)m.fetchesFailed);
+    metricHeader(res, "weather_dns_lookups_total", "counter", "API host lookups by how they were answered.");
+    res.printf("weather_dns_lookups_total{result=\"cache\"} %lu\n", (unsigned long)m.dns.hits);
+    res.printf("weather_dns_lookups_total{result=\"query\"} %lu\n", (unsigned long)m.dns.queries);
+    res.printf("weather_dns_lookups_total{result=\"fallback\"} %lu\n", (unsigned long)m.dns.fallbacks);
+    res.printf("weather_dns_lookups_total{result=\"failed\"} %lu\n", (unsigned long)m.dns.failures);
+    metricHeader(res, "weather_dns_prefetches_total", "counter", "Queries made ahead of a scheduled fetch.");
+    res.printf("weather_dns_prefetches_total %lu\n", (unsigned long)m.dns.prefetches);
+    formatFixed(value, sizeof(value), (int32_t)m.dns.maxQueryMs, 1000, 3);
+    metricHeader(res, "weather_dns_query_max_seconds", "gauge", "Slowest DNS query since boot.");
+    res.printf("weather_dns_query_max_seconds %s\n", value);
+    metricHeader(res, "weather_api_budget_remaining", "gauge", "Requests left under the plan's caps.");
+    res.printf("weather_api_budget_remaining{window=\"minute\"} %lu\n", (unsigned long)m.budget.minuteRemaining);
+    res.printf("weather_api_budget_remaining{window=\"day\"} %lu\n", (unsigned long)m.budget.dayRemaining);
+    metricHeader(res, "weather_api_hold_seconds", "gauge", "Left of a hold after a 429 response.");
+    res.printf("weather_api_hold_seconds %lu\n", (unsigned long)m.budget.holdSeconds);
+    metricHeader(res, "weather_api_requests_total", "counter", "API requests by budget decision.");
+    res.printf("weather_api_requests_total{result=\"granted\"} %lu\n", (unsigned long)m.budget.granted);
+    res.printf("weather_api_requests_total{result=\"deferred\"} %lu\n", (unsigned long)m.budget.deferred);
+    metricHeader(res, "weather_api_throttled_total", "counter", "429 responses from the API.");
+    res.printf("weather_api_throttled_total %lu\n", (unsigned long)m.budget.throttled);
+    metricHeader(res, "weather_errors_total", "counter", "Errors by type.");
+    for (int i = 0; i < STATUS_ERROR_TYPES; i++) {
+        res.printf("weather_errors_total{type=\"%s\"} %lu\n", ERROR_LABELS[i], (unsigned long)m.errors[i]);
+    }
+
+    metricHeader(res, "weather_wifi_rssi_dbm", "gauge", "WiFi signal strength, 0 when offline.");
+    res.printf("weather_wifi_rssi_dbm %d\n", m.health.rssi);
+    metricHeader(res, "weather_wifi_link_up", "gauge", "1 while the WiFi link is up.");
+    res.printf("weather_wifi_link_up %d\n", snap.link.state == LINK_UP ? 1 : 0);
+    metricHeader(res, "weather_wifi_link_uptime_seconds", "gauge", "Time since the link last came up.");
+    res.printf("weather_wifi_link_uptime_seconds %lu\n", (unsigned long)snap.link.uptimeSeconds);
+    metricHeader(res, "weather_wifi_reconnects_total", "counter", "Times the link came back after a drop.");
+    res.printf("weather_wifi_reconnects_total %lu\n", (unsigned long)snap.link.reconnects);
+    metricHeader(res, "weather_wifi_disconnects_total", "counter", "Link drops.");
+    res.printf("weather_wifi_disconnects_total %lu\n", (unsigned long)snap.link.disconnects);
+    metricHeader(res, "weather_wifi_roams_total", "counter", "Moves to a stronger access point.");
+    res.printf("weather_wifi_roams_total %lu\n", (unsigned long)snap.link.roams);
+    metricHeader(res, "weather_wifi_failed_attempts_total", "counter", "Connection attempts that failed.");
+    res.printf("weather_wifi_failed_attempts_total %lu\n", (unsigned long)snap.link.failedAttempts);
+    metricHeader(res, "weather_http_requests_total", "counter", "Status server requests.");
+    res.printf("weather_http_requests_total %lu\n", (unsigned long)m.httpRequests);
+
+    metricHeader(res, "weather_telemetry_queue_depth", "gauge", "Telemetry samples waiting for the broker.");
+    res.printf("weather_telemetry_queue_depth %lu\n", (unsigned long)m.telemetryQueueDepth);
+    metricHeader(res, "weather_telemetry_samples_sent_total", "counter", "Telemetry samples acknowledged by the broker.");
+    res.printf("weather_telemetry_samples_sent_total %lu\n", (unsigned long)m.telemetrySent);
+    metricHeader(res, "weather_telemetry_samples_dropped_total", "counter", "Telemetry samples dropped from a full queue.");
+    res.printf("weather_telemetry_samples_dropped_total %lu\n", (unsigned long)m.telemetryDropped);
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void serveScreenshot(HttpResponse& res, const uint16_t* framebuffer) {
+    if (framebuffer == nullptr) {
+        sendError(res, 503, "no framebuffer");
+        return;
+    }
+
+    // 16-bit BI_BITFIELDS BMP, top-down, so rows go out in sprite order
+    const uint32_t headerSize = 14 + 40 + 12;
+    const uint32_t rowBytes = SPRITE_WIDTH * 2;   // Already a multiple of 4
+    const uint32_t imageSize = rowBytes * SPRITE_HEIGHT;
+    uint8_t header[14 + 40 + 12] = {'B', 'M'};
+    put32(header + 2, headerSize + imageSize);
+    put32(header + 10, headerSize);
+    put32(header + 14, 40);
+    put32(header + 18, SPRITE_WIDTH);
+    put32(header + 22, (uint32_t)-SPRITE_HEIGHT);
+    put16(header + 26, 1);
+    put16(header + 28, 16);
+    put32(header + 30, 3);   // BI_BITFIELDS
+    put32(header + 34, imageSize);
+    put32(header + 54, 0xF800);
+    put32(header + 58, 0x07E0);
+    put32(header + 62, 0x001F);
+
+    res.begin(200, "image/bmp", (int32_t)(headerSize + imageSize));
+    res.write(header, sizeof(header));
+
+    // The sprite keeps colours byte-swapped; BMP wants little-endian RGB565
+    uint8_t row[SPRITE_WIDTH * 2];
+    for (int y = 0; y < SPRITE_HEIGHT; y++) {
+        const uint16_t* src = framebuffer + y * SPRITE_WIDTH;
+        for (int x = 0; x < SPRITE_WIDTH; x++) {
+            uint16_t c = (uint16_t)((src[x] >> 8) | (src[x] << 8));
+            put16(row + 2 * x, c);
+        }
+        res.write(row, sizeof(row));
+    }
+}
+
+void handleStatusRequest(const char* request, size_t len, const StatusSnapshot& snapshot,
+                         const uint16_t* framebuffer, HttpResponse& res) {
+    HttpRequest req;
+    if (!parseRequestLine(request, len, &req)) {
+        sendError(res, 400, "bad request");
+        return;
+    }
+    if (strcmp(req.method, "GET") != 0) {
+        sendError(res, 405, "only GET is supported");
+        return;
+    }
+
+    if (strcmp(req.path, "/") == 0) {
+        serveIndex(res);
+    } else if (strcmp(req.path, "/weather") == 0) {
+        serveWeather(res, snapshot);
+    } else if (strcmp(req.path, "/metrics") == 0) {
+        serveMetrics(res, snapshot);
+    } else if (strcmp(req.path, "/history") == 0) {
+        serveHistory(res, snapshot, req.query);
+    } else if (strcmp(req.path, "/wifi") == 0) {
+        serveWifi(res, snapshot);
+    } else if (strcmp(req.path, "/screenshot") == 0) {
+        serveScreenshot(res, framebuffer);
+    } else {
+        sendError(res, 404, "not found");
+    }
+}
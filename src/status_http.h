@@ -0,0 +1,104 @@
+#ifndef STATUS_HTTP_H
+#define STATUS_HTTP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "weather_data.h"
+#include "pages.h"
+#include "wifi_link.h"
+#include "dns_cache.h"
+#include "api_budget.h"
+
+// Request handling for the status server, independent of the socket layer so
+// the same code runs on the host. Responses are formatted into one fixed
+// buffer that is flushed to a sink whenever it fills; nothing is allocated.
+// No Arduino dependencies.
+
+// Delivers response bytes; false when the client has gone away
+typedef bool (*HttpSink)(void* context, const uint8_t* data, size_t len);
+
+class HttpResponse {
+public:
+    HttpResponse(uint8_t* buffer, size_t size, HttpSink sink, void* context);
+
+    // Status line and headers; bodies without a length end when the connection closes
+    void begin(int status, const char* contentType, int32_t contentLength = -1);
+
+    void write(const void* data, size_t len);
+    void print(const char* text);
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    // Quoted JSON string; quotes, backslashes and control characters are escaped
+    void printJson(const char* text);
+
+    // Flush what is left; false if any write failed
+    bool end();
+
+    int statusCode() const { return status; }
+    uint32_t bytesSent() const { return sent; }
+
+private:
+    uint8_t* buffer;
+    size_t size;
+    size_t used;
+    HttpSink sink;
+    void* context;
+    int status;
+    uint32_t sent;
+    bool failed;
+
+    void flush();
+};
+
+struct HttpRequest {
+    char method[8];
+    char path[32];
+    char query[64];
+};
+
+// "GET /history?from=1&to=2 HTTP/1.1" -> method, path and query. False when
+// the line is malformed or a part doesn't fit.
+bool parseRequestLine(const char* line, size_t len, HttpRequest* req);
+
+enum QueryResult : uint8_t {
+    QUERY_MISSING = 0,
+    QUERY_OK,
+    QUERY_INVALID
+};
+
+// Unsigned decimal parameter from a query string
+QueryResult queryUint(const char* query, const char* name, uint32_t* value);
+
+// Counters and timings for /metrics
+struct StatusMetrics {
+    HealthModel health;
+    uint32_t framesOverBudget;     // In the last perf report window
+    uint32_t fetchesOk;
+    uint32_t fetchesFailed;
+    uint32_t lastFetchMs;
+    uint32_t lastFetchDnsMs;       // Part of lastFetchMs
+    DnsStats dns;
+    ApiBudgetStatus budget;        // As of the last fetch or deferral
+    uint32_t errors[STATUS_ERROR_TYPES];   // ErrorHandler::ErrorType order
+    uint32_t httpRequests;
+    uint32_t telemetryQueueDepth;
+    uint32_t telemetrySent;
+    uint32_t telemetryDropped;
+};
+
+// Everything a request can read, copied from the loop task in one piece
+struct StatusSnapshot {
+    WeatherData weather;
+    const UnitProfile* units;      // nullptr until the first fetch
+    TemperatureHistory history;
+    StatusMetrics metrics;
+    WifiLinkSnapshot link;
+};
+
+// Serve one raw request (request line plus headers). framebuffer is the
+// SPRITE_WIDTH x SPRITE_HEIGHT sprite in its byte-swapped order, or nullptr.
+void handleStatusRequest(const char* request, size_t len, const StatusSnapshot& snapshot,
+                         const uint16_t* framebuffer, HttpResponse& res);
+
+#endif // STATUS_HTTP_H
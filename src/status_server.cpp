@@ -0,0 +1,157 @@
+#include "status_server.h"
+#include <WiFi.h>
+#include "heap_stats.h"
+#include "weather_api.h"
+#include "telemetry_publisher.h"
+#include "wifi_manager.h"
+#include "dns_resolver.h"
+
+StatusSnapshot StatusServer::snapshot;
+const uint16_t* StatusServer::framebuffer = nullptr;
+TaskHandle_t StatusServer::task = nullptr;
+uint32_t StatusServer::requests = 0;
+uint32_t StatusServer::bytesSent = 0;
+uint32_t StatusServer::slowestMs = 0;
+
+static portMUX_TYPE statusMux = portMUX_INITIALIZER_UNLOCKED;
+
+#if STATUS_SERVER_ENABLED
+static WiFiServer statusHttp(STATUS_HTTP_PORT);
+
+// Owned by the server task; static so requests cost no heap and little stack
+static char requestBuffer[STATUS_REQUEST_SIZE];
+static uint8_t responseBuffer[STATUS_RESPONSE_BUFFER];
+static StatusSnapshot requestSnapshot;
+
+static bool clientSink(void* context, const uint8_t* data, size_t len) {
+    return ((WiFiClient*)context)->write(data, len) == len;
+}
+
+// Read until the blank line ending the headers, the buffer is full or the client stalls
+static size_t readRequest(WiFiClient& client) {
+    size_t len = 0;
+    uint32_t start = millis();
+    while (len < sizeof(requestBuffer) - 1 && millis() - start < STATUS_REQUEST_TIMEOUT_MS) {
+        int available = client.available();
+        if (available <= 0) {
+            if (!client.connected()) break;
+            vTaskDelay(pdMS_TO_TICKS(5));
+            continue;
+        }
+        size_t want = sizeof(requestBuffer) - 1 - len;
+        int n = client.read((uint8_t*)requestBuffer + len, (size_t)available < want ? (size_t)available : want);
+        if (n <= 0) break;
+        len += (size_t)n;
+        requestBuffer[len] = '\0';
+        if (strstr(requestBuffer, "\r\n\r\n") != nullptr) break;
+    }
+    requestBuffer[len] = '\0';
+    return len;
+}
+#endif
+
+void StatusServer::begin(const uint16_t* pixels) {
+#if STATUS_SERVER_ENABLED
+    framebuffer = pixels;
+    statusHttp.begin();
+    statusHttp.setNoDelay(true);
+    if (xTaskCreatePinnedToCore(serverTask, "http", STATUS_TASK_STACK, nullptr, STATUS_TASK_PRIORITY,
+                                &task, STATUS_TASK_CORE) != pdPASS) {
+        Serial.println("Status server: failed to create task");
+        task = nullptr;
+        return;
+    }
+    Serial.printf("Status server: http://%s:%d/\n", WiFi.localIP().toString().c_str(), STATUS_HTTP_PORT);
+#endif
+}
+
+void StatusServer::publishWeather(const WeatherData& data, const TemperatureHistory& history,
+                                  const UnitProfile& units) {
+    portENTER_CRITICAL(&statusMux);
+    snapshot.weather = data;
+    snapshot.history = history;
+    snapshot.units = &units;
+    portEXIT_CRITICAL(&statusMux);
+}
+
+void StatusServer::publishFetch(bool success, uint32_t durationMs, uint32_t dnsMs) {
+    portENTER_CRITICAL(&statusMux);
+    if (success) {
+        snapshot.metrics.fetchesOk++;
+    } else {
+        snapshot.metrics.fetchesFailed++;
+    }
+    snapshot.metrics.lastFetchMs = durationMs;
+    snapshot.metrics.lastFetchDnsMs = dnsMs;
+    portEXIT_CRITICAL(&statusMux);
+}
+
+void StatusServer::publishBudget(const ApiBudgetStatus& budget) {
+    portENTER_CRITICAL(&statusMux);
+    snapshot.metrics.budget = budget;
+    portEXIT_CRITICAL(&statusMux);
+}
+
+void StatusServer::publishFrames(uint16_t fpsTenths, uint32_t frameMaxMicros, uint32_t framesOverBudget) {
+    portENTER_CRITICAL(&statusMux);
+    snapshot.metrics.health.fpsTenths = fpsTenths;
+    snapshot.metrics.health.frameMaxMicros = frameMaxMicros;
+    snapshot.metrics.framesOverBudget = framesOverBudget;
+    portEXIT_CRITICAL(&statusMux);
+}
+
+void StatusServer::serverTask(void* arg) {
+#if STATUS_SERVER_ENABLED
+    for (;;) {
+        WiFiClient client = statusHttp.accept();
+        if (!client) {
+            vTaskDelay(pdMS_TO_TICKS(STATUS_POLL_MS));
+            continue;
+        }
+        uint32_t start = millis();
+        size_t len = readRequest(client);
+
+        portENTER_CRITICAL(&statusMux);
+        requestSnapshot = snapshot;
+        portEXIT_CRITICAL(&statusMux);
+
+        // Live values are safe to read from this core
+        HealthModel& health = requestSnapshot.metrics.health;
+        health.uptimeSeconds = millis() / 1000;
+        health.freeHeap = HeapStats::freeHeap();
+        health.minFreeHeap = HeapStats::minFreeHeap();
+        health.largestBlock = HeapStats::largestFreeBlock();
+        health.rssi = WiFi.status() == WL_CONNECTED ? (int8_t)WiFi.RSSI() : 0;
+        for (int i = 0; i < STATUS_ERROR_TYPES; i++) {
+            requestSnapshot.metrics.errors[i] = ErrorHandler::errorCount((ErrorHandler::ErrorType)i);
+        }
+        requestSnapshot.metrics.httpRequests = ++requests;
+        requestSnapshot.metrics.telemetryQueueDepth = TelemetryPublisher::queueDepth();
+        requestSnapshot.metrics.telemetrySent = TelemetryPublisher::samplesSent();
+        requestSnapshot.metrics.telemetryDropped = TelemetryPublisher::samplesDropped();
+        DnsResolver::stats(&requestSnapshot.metrics.dns);
+        WifiManager::snapshot(&requestSnapshot.link);
+
+        HttpResponse res(responseBuffer, sizeof(responseBuffer), clientSink, &client);
+        handleStatusRequest(requestBuffer, len, requestSnapshot, framebuffer, res);
+        res.end();
+        client.stop();
+
+        bytesSent += res.bytesSent();
+        uint32_t elapsed = millis() - start;
+        if (elapsed > slowestMs) {
+            slowestMs = elapsed;
+        }
+    }
+#endif
+}
+
+void StatusServer::report() {
+    if (task == nullptr) {
+        return;
+    }
+    Serial.printf("HTTP: %lu requests, %lu KB sent, slowest %lu ms, stack free %u\n",
+                 (unsigned long)requests, (unsigned long)(bytesSent / 1024), (unsigned long)slowestMs,
+                 (unsigned)uxTaskGetStackHighWaterMark(task));
+    slowestMs = 0;
+}
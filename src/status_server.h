@@ -0,0 +1,38 @@
+#ifndef STATUS_SERVER_H
+#define STATUS_SERVER_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "status_http.h"
+
+// HTTP status server (status_http.h has the endpoints). One low-priority task
+// on the network core accepts and serves a connection at a time from static
+// buffers; the loop task only publishes snapshots, so requests never touch frame pacing.
+class StatusServer {
+public:
+    // framebuffer: the display sprite, read for /screenshot (may tear mid-frame)
+    static void begin(const uint16_t* framebuffer);
+
+    // Called from the loop task after each fetch and perf report
+    static void publishWeather(const WeatherData& data, const TemperatureHistory& history,
+                               const UnitProfile& units);
+    static void publishFetch(bool success, uint32_t durationMs, uint32_t dnsMs);
+    static void publishBudget(const ApiBudgetStatus& budget);
+    static void publishFrames(uint16_t fpsTenths, uint32_t frameMaxMicros, uint32_t framesOverBudget);
+
+    // Perf report section: requests served and the slowest one
+    static void report();
+
+private:
+    static StatusSnapshot snapshot;
+    static const uint16_t* framebuffer;
+    static TaskHandle_t task;
+    static uint32_t requests;
+    static uint32_t bytesSent;
+    static uint32_t slowestMs;
+
+    static void serverTask(void* arg);
+};
+
+#endif // STATUS_SERVER_H
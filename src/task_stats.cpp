@@ -0,0 +1,94 @@
+#include "task_stats.h"
+#include <string.h>
+
+TaskStatsAggregator::TaskStatsAggregator() :
+    head(0),
+    entries(0),
+    previousCount(0),
+    previousTotal(0),
+    havePrevious(false),
+    numAlerts(0) {
+    memset(ring, 0, sizeof(ring));
+    memset(previous, 0, sizeof(previous));
+}
+
+const TaskStatsAggregator::PreviousSample* TaskStatsAggregator::findPrevious(uint32_t taskNumber) const {
+    for (int i = 0; i < previousCount; i++) {
+        if (previous[i].taskNumber == taskNumber) {
+            return &previous[i];
+        }
+    }
+    return nullptr;
+}
+
+int TaskStatsAggregator::addSnapshot(uint32_t timestampMs, const TaskSample* samples, int count,
+                                     uint32_t totalRunTime, bool hasRunTime) {
+    if (count > TASK_STATS_MAX_TASKS) {
+        count = TASK_STATS_MAX_TASKS;
+    }
+
+    TaskStatsEntry& e = ring[head];
+    memset(&e, 0, sizeof(e));
+    e.timestampMs = timestampMs;
+    e.count = count;
+
+    // Counters wrap; unsigned subtraction keeps the deltas right across one wrap
+    uint32_t elapsed = totalRunTime - previousTotal;
+    e.hasRunTime = hasRunTime && havePrevious && elapsed > 0;
+
+    PreviousSample next[TASK_STATS_MAX_TASKS];
+    numAlerts = 0;
+
+    for (int i = 0; i < count; i++) {
+        const TaskSample& s = samples[i];
+        TaskUsage& u = e.tasks[i];
+        memcpy(u.name, s.name, TASK_NAME_LEN);
+        u.name[TASK_NAME_LEN - 1] = '\0';
+        u.stackFreeBytes = s.stackFreeBytes;
+        u.core = s.core;
+
+        const PreviousSample* prev = findPrevious(s.taskNumber);
+        if (e.hasRunTime && prev != nullptr) {
+            uint64_t permille = ((uint64_t)(s.runTime - prev->runTime) * 1000) / elapsed;
+            u.cpuPermille = permille > 1000 ? 1000 : (uint16_t)permille;
+        }
+
+        // Per-core load is whatever the core's idle task did not get
+        if (e.hasRunTime && s.isIdle && s.core < TASK_STATS_CORES) {
+            e.coreBusyPermille[s.core] = 1000 - u.cpuPermille;
+        }
+
+        // Alert once per crossing; re-arms when headroom recovers
+        bool low = s.stackFreeBytes < TASK_STACK_ALERT_BYTES;
+        bool wasAlerted = prev != nullptr && prev->alerted;
+        if (low && !wasAlerted) {
+            alerts[numAlerts++] = u;
+        }
+
+        next[i].taskNumber = s.taskNumber;
+        next[i].runTime = s.runTime;
+        next[i].alerted = low;
+    }
+
+    memcpy(previous, next, sizeof(PreviousSample) * count);
+    previousCount = count;
+    previousTotal = totalRunTime;
+    havePrevious = true;
+
+    head = (head + 1) % TASK_STATS_RING_SIZE;
+    if (entries < TASK_STATS_RING_SIZE) {
+        entries++;
+    }
+    return numAlerts;
+}
+
+const TaskStatsEntry* TaskStatsAggregator::entry(int index) const {
+    if (index < 0 || index >= entries) {
+        return nullptr;
+    }
+    return &ring[(head + TASK_STATS_RING_SIZE - 1 - index) % TASK_STATS_RING_SIZE];
+}
+
+const TaskStatsEntry* TaskStatsAggregator::latest() const {
+    return entry(0);
+}
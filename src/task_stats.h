@@ -0,0 +1,80 @@
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Per-task CPU and stack aggregation. No FreeRTOS dependencies - the device
+// glue (runtime_stats.h) fills TaskSample arrays from uxTaskGetSystemState().
+
+#define TASK_NAME_LEN 16
+#define TASK_CORE_ANY 0xFF
+
+// Raw reading for one task at one instant
+struct TaskSample {
+    char name[TASK_NAME_LEN];
+    uint32_t taskNumber;        // Stable id used to match tasks between snapshots
+    uint32_t runTime;           // Cumulative run-time counter
+    uint32_t stackFreeBytes;    // Stack high-water mark (minimum ever free)
+    uint8_t core;               // Affinity, TASK_CORE_ANY when unpinned
+    bool isIdle;                // Idle task of `core`
+};
+
+// Aggregated figures for one task over one sample interval
+struct TaskUsage {
+    char name[TASK_NAME_LEN];
+    uint16_t cpuPermille;       // Share of one core over the interval
+    uint32_t stackFreeBytes;
+    uint8_t core;
+};
+
+// One ring entry - a full snapshot interval
+struct TaskStatsEntry {
+    uint32_t timestampMs;
+    uint8_t count;
+    bool hasRunTime;            // False when run-time counters are not compiled in
+    uint16_t coreBusyPermille[TASK_STATS_CORES];
+    TaskUsage tasks[TASK_STATS_MAX_TASKS];
+};
+
+class TaskStatsAggregator {
+public:
+    TaskStatsAggregator();
+
+    // Fold a snapshot into the ring. totalRunTime is the run-time clock at
+    // the snapshot (elapsed time per core). Returns the number of tasks that
+    // newly crossed below TASK_STACK_ALERT_BYTES.
+    int addSnapshot(uint32_t timestampMs, const TaskSample* samples, int count,
+                    uint32_t totalRunTime, bool hasRunTime);
+
+    const TaskStatsEntry* latest() const;
+    int entryCount() const { return entries; }
+    const TaskStatsEntry* entry(int index) const;  // 0 = latest
+
+    // Tasks that crossed the stack threshold in the latest snapshot
+    int alertCount() const { return numAlerts; }
+    const TaskUsage& alert(int index) const { return alerts[index]; }
+
+private:
+    struct PreviousSample {
+        uint32_t taskNumber;
+        uint32_t runTime;
+        bool alerted;
+    };
+
+    TaskStatsEntry ring[TASK_STATS_RING_SIZE];
+    int head;
+    int entries;
+
+    PreviousSample previous[TASK_STATS_MAX_TASKS];
+    int previousCount;
+    uint32_t previousTotal;
+    bool havePrevious;
+
+    TaskUsage alerts[TASK_STATS_MAX_TASKS];
+    int numAlerts;
+
+    const PreviousSample* findPrevious(uint32_t taskNumber) const;
+};
+
+#endif // TASK_STATS_H
@@ -0,0 +1,112 @@
+#include "telemetry.h"
+#include <string.h>
+
+TelemetryQueue::TelemetryQueue() : used(0), peak(0), nextSeq(1), total(0) {
+    memset(drops, 0, sizeof(drops));
+}
+
+bool TelemetryQueue::push(const TelemetrySample& sample) {
+    uint8_t priority = sample.priority < TELEMETRY_PRIORITY_COUNT ? sample.priority : (uint8_t)TELEMETRY_PRIORITY_LOW;
+    bool lost = false;
+    if (used == TELEMETRY_QUEUE_SIZE) {
+        // Oldest entry of the lowest priority present
+        int victim = 0;
+        for (int i = 1; i < used; i++) {
+            if (samples[i].priority < samples[victim].priority) {
+                victim = i;
+            }
+        }
+        if (samples[victim].priority > priority) {
+            drops[priority]++;
+            return false;
+        }
+        drops[samples[victim].priority]++;
+        memmove(&samples[victim], &samples[victim + 1], (size_t)(used - victim - 1) * sizeof(TelemetrySample));
+        used--;
+        lost = true;
+    }
+
+    TelemetrySample& s = samples[used++];
+    s = sample;
+    s.priority = priority;
+    s.seq = nextSeq++;
+    total++;
+    if (used > peak) {
+        peak = used;
+    }
+    return !lost;
+}
+
+uint8_t TelemetryQueue::peek(TelemetrySample* out, uint8_t max) const {
+    uint8_t n = used < max ? used : max;
+    memcpy(out, samples, (size_t)n * sizeof(TelemetrySample));
+    return n;
+}
+
+void TelemetryQueue::popThrough(uint32_t seq) {
+    uint8_t n = 0;
+    while (n < used && (int32_t)(samples[n].seq - seq) <= 0) {
+        n++;
+    }
+    memmove(samples, samples + n, (size_t)(used - n) * sizeof(TelemetrySample));
+    used -= n;
+}
+
+// CBOR head: major type plus the shortest argument encoding
+static size_t cborHead(uint8_t* out, uint8_t major, uint32_t value) {
+    major <<= 5;
+    if (value < 24) {
+        out[0] = (uint8_t)(major | value);
+        return 1;
+    }
+    if (value <= 0xFF) {
+        out[0] = (uint8_t)(major | 24);
+        out[1] = (uint8_t)value;
+        return 2;
+    }
+    if (value <= 0xFFFF) {
+        out[0] = (uint8_t)(major | 25);
+        out[1] = (uint8_t)(value >> 8);
+        out[2] = (uint8_t)value;
+        return 3;
+    }
+    out[0] = (uint8_t)(major | 26);
+    out[1] = (uint8_t)(value >> 24);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 8);
+    out[4] = (uint8_t)value;
+    return 5;
+}
+
+static size_t cborInt(uint8_t* out, int32_t value) {
+    // Negative n is major type 1 with argument -1 - n
+    return value >= 0 ? cborHead(out, 0, (uint32_t)value) : cborHead(out, 1, (uint32_t)(-1 - value));
+}
+
+size_t encodeTelemetryBatch(const TelemetrySample* samples, uint8_t count, uint32_t batch,
+                            const char* station, uint8_t* out, size_t outSize) {
+    size_t stationLen = strlen(station);
+    if (stationLen > 0xFFFF ||
+        outSize < 1 + 1 + 5 + 3 + stationLen + 2 + (size_t)count * TELEMETRY_SAMPLE_MAX_BYTES) {
+        return 0;
+    }
+
+    size_t n = cborHead(out, 4, 4);
+    n += cborHead(out + n, 0, TELEMETRY_FORMAT_VERSION);
+    n += cborHead(out + n, 0, batch);
+    n += cborHead(out + n, 3, (uint32_t)stationLen);
+    memcpy(out + n, station, stationLen);
+    n += stationLen;
+    n += cborHead(out + n, 4, count);
+    for (uint8_t i = 0; i < count; i++) {
+        const TelemetrySample& s = samples[i];
+        uint8_t values = s.count <= TELEMETRY_MAX_VALUES ? s.count : TELEMETRY_MAX_VALUES;
+        n += cborHead(out + n, 4, 2u + values);
+        n += cborHead(out + n, 0, s.kind);
+        n += cborHead(out + n, 0, s.epoch);
+        for (uint8_t v = 0; v < values; v++) {
+            n += cborInt(out + n, s.values[v]);
+        }
+    }
+    return n;
+}
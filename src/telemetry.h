@@ -0,0 +1,71 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Telemetry samples, the bounded queue they wait in between publish windows,
+// and the CBOR batch they are sent as. No Arduino dependencies.
+
+enum TelemetryKind : uint8_t {
+    TELEMETRY_OBSERVATION = 1,  // temperature, humidity, pressure, wind, clouds, condition id
+    TELEMETRY_FETCH = 2,        // success (0/1), duration ms, dns ms
+    TELEMETRY_HEALTH = 3        // uptime s, free heap, min free heap, fps x10, max frame us, rssi
+};
+
+enum TelemetryPriority : uint8_t {
+    TELEMETRY_PRIORITY_LOW = 0,     // Health - periodic, the next one replaces it
+    TELEMETRY_PRIORITY_NORMAL = 1,  // Fetch results
+    TELEMETRY_PRIORITY_HIGH = 2,    // Observations
+    TELEMETRY_PRIORITY_COUNT
+};
+
+struct TelemetrySample {
+    uint32_t seq;         // Queue order, assigned by push()
+    uint32_t epoch;       // UTC seconds
+    int32_t values[TELEMETRY_MAX_VALUES];
+    uint8_t kind;
+    uint8_t priority;
+    uint8_t count;        // Values used
+};
+
+// Oldest-first queue. When full, the oldest sample of the lowest priority is
+// evicted, unless it outranks the new sample, which is dropped instead.
+class TelemetryQueue {
+public:
+    TelemetryQueue();
+
+    // False when a sample was dropped (the new one or an evicted one)
+    bool push(const TelemetrySample& sample);
+
+    // Copy up to max of the oldest samples without removing them
+    uint8_t peek(TelemetrySample* out, uint8_t max) const;
+
+    // Remove samples up to and including seq once the broker has them;
+    // anything evicted in the meantime is already gone
+    void popThrough(uint32_t seq);
+
+    uint8_t depth() const { return used; }
+    uint8_t highWater() const { return peak; }
+    uint32_t dropped(uint8_t priority) const { return drops[priority]; }
+    uint32_t pushed() const { return total; }
+
+private:
+    TelemetrySample samples[TELEMETRY_QUEUE_SIZE];
+    uint8_t used;
+    uint8_t peak;
+    uint32_t nextSeq;
+    uint32_t total;
+    uint32_t drops[TELEMETRY_PRIORITY_COUNT];
+};
+
+// Batch payload: CBOR array [version, batch number, station, [[kind, epoch, values...], ...]].
+// Returns the payload size, 0 if it doesn't fit in out.
+size_t encodeTelemetryBatch(const TelemetrySample* samples, uint8_t count, uint32_t batch,
+                            const char* station, uint8_t* out, size_t outSize);
+
+// Largest encoding of one sample, for sizing the payload buffer
+#define TELEMETRY_SAMPLE_MAX_BYTES (1 + 1 + 5 + 5 * TELEMETRY_MAX_VALUES)
+
+#endif // TELEMETRY_H
@@ -0,0 +1,157 @@
+#include "telemetry_publisher.h"
+#include <WiFi.h>
+#include <time.h>
+
+TelemetryQueue TelemetryPublisher::queue;
+TelemetrySession TelemetryPublisher::session;
+TaskHandle_t TelemetryPublisher::task = nullptr;
+uint32_t TelemetryPublisher::windows = 0;
+uint32_t TelemetryPublisher::failedWindows = 0;
+uint32_t TelemetryPublisher::lastWindowMs = 0;
+
+static portMUX_TYPE telemetryMux = portMUX_INITIALIZER_UNLOCKED;
+
+static char topic[64];
+
+void TelemetryPublisher::begin() {
+    if (TELEMETRY_BROKER_HOST[0] == '\0') {
+        return;
+    }
+    snprintf(topic, sizeof(topic), "%s%s/telemetry", TELEMETRY_TOPIC_PREFIX, TELEMETRY_STATION);
+    session.begin(TELEMETRY_STATION, topic, TELEMETRY_USERNAME, TELEMETRY_PASSWORD);
+    if (xTaskCreatePinnedToCore(publisherTask, "telemetry", TELEMETRY_TASK_STACK, nullptr,
+                                TELEMETRY_TASK_PRIORITY, &task, TELEMETRY_TASK_CORE) != pdPASS) {
+        Serial.println("Telemetry: failed to create task");
+        task = nullptr;
+        return;
+    }
+    Serial.printf("Telemetry: mqtt://%s:%d/%s\n", TELEMETRY_BROKER_HOST, TELEMETRY_BROKER_PORT, topic);
+}
+
+void TelemetryPublisher::record(uint8_t kind, uint8_t priority, uint32_t epoch, const int32_t* values,
+                                uint8_t count) {
+    if (task == nullptr) {
+        return;
+    }
+    TelemetrySample sample;
+    sample.kind = kind;
+    sample.priority = priority;
+    sample.epoch = epoch;
+    sample.count = count;
+    memcpy(sample.values, values, count * sizeof(int32_t));
+
+    portENTER_CRITICAL(&telemetryMux);
+    queue.push(sample);
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+void TelemetryPublisher::recordObservation(const WeatherData& data) {
+    int32_t values[] = {data.temperature, data.humidity, data.pressure, data.windSpeed,
+                        data.cloudCoverage, data.conditionId};
+    record(TELEMETRY_OBSERVATION, TELEMETRY_PRIORITY_HIGH, data.lastUpdated, values, 6);
+}
+
+void TelemetryPublisher::recordFetch(bool success, uint32_t durationMs, uint32_t dnsMs) {
+    int32_t values[] = {success ? 1 : 0, (int32_t)durationMs, (int32_t)dnsMs};
+    record(TELEMETRY_FETCH, TELEMETRY_PRIORITY_NORMAL, (uint32_t)time(nullptr), values, 3);
+}
+
+void TelemetryPublisher::recordHealth(const HealthModel& health) {
+    int32_t values[] = {(int32_t)health.uptimeSeconds, (int32_t)health.freeHeap, (int32_t)health.minFreeHeap,
+                        health.fpsTenths, (int32_t)health.frameMaxMicros, health.rssi};
+    record(TELEMETRY_HEALTH, TELEMETRY_PRIORITY_LOW, (uint32_t)time(nullptr), values, 6);
+}
+
+void TelemetryPublisher::flush() {
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+static bool linkSend(void* context, const uint8_t* data, size_t len) {
+    return ((WiFiClient*)context)->write(data, len) == len;
+}
+
+static bool linkReceive(void* context, uint8_t* buf, size_t len) {
+    WiFiClient& client = *(WiFiClient*)context;
+    size_t got = 0;
+    uint32_t start = millis();
+    while (got < len && millis() - start < TELEMETRY_TIMEOUT_MS) {
+        if (client.available() <= 0) {
+            if (!client.connected()) return false;
+            vTaskDelay(pdMS_TO_TICKS(5));
+            continue;
+        }
+        int n = client.read(buf + got, len - got);
+        if (n <= 0) return false;
+        got += (size_t)n;
+    }
+    return got == len;
+}
+
+static void linkLock(void* context) {
+    portENTER_CRITICAL(&telemetryMux);
+}
+
+static void linkUnlock(void* context) {
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+bool TelemetryPublisher::publishWindow() {
+    if (WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
+    WiFiClient client;
+    if (!client.connect(TELEMETRY_BROKER_HOST, TELEMETRY_BROKER_PORT, TELEMETRY_TIMEOUT_MS)) {
+        Serial.println("Telemetry: broker unreachable");
+        return false;
+    }
+    client.setNoDelay(true);
+
+    TelemetryLink link = {&client, linkSend, linkReceive, linkLock, linkUnlock};
+    bool ok = session.publishWindow(queue, link);
+    if (session.lastRefusal() != 0) {
+        Serial.printf("Telemetry: broker refused connection (%d)\n", session.lastRefusal());
+    }
+    client.stop();
+    return ok;
+}
+
+void TelemetryPublisher::publisherTask(void* arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t start = millis();
+        bool ok = publishWindow();
+        lastWindowMs = millis() - start;
+        windows++;
+        if (!ok) {
+            failedWindows++;
+        }
+    }
+}
+
+uint8_t TelemetryPublisher::queueDepth() {
+    return queue.depth();
+}
+
+uint32_t TelemetryPublisher::samplesDropped() {
+    uint32_t total = 0;
+    for (uint8_t p = 0; p < TELEMETRY_PRIORITY_COUNT; p++) {
+        total += queue.dropped(p);
+    }
+    return total;
+}
+
+void TelemetryPublisher::report() {
+    if (task == nullptr) {
+        return;
+    }
+    Serial.printf("Telemetry: queue %u/%d (peak %u), sent %lu samples in %lu batches (%lu KB), "
+                 "dropped low=%lu normal=%lu high=%lu, windows %lu (%lu failed, last %lu ms)\n",
+                 queue.depth(), TELEMETRY_QUEUE_SIZE, queue.highWater(), (unsigned long)session.samplesSent(),
+                 (unsigned long)session.batchesSent(), (unsigned long)(session.bytesSent() / 1024),
+                 (unsigned long)queue.dropped(TELEMETRY_PRIORITY_LOW),
+                 (unsigned long)queue.dropped(TELEMETRY_PRIORITY_NORMAL),
+                 (unsigned long)queue.dropped(TELEMETRY_PRIORITY_HIGH), (unsigned long)windows,
+                 (unsigned long)failedWindows, (unsigned long)lastWindowMs);
+}
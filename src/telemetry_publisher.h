@@ -0,0 +1,49 @@
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "telemetry.h"
+#include "telemetry_session.h"
+#include "weather_data.h"
+#include "pages.h"
+
+// MQTT telemetry (off unless TELEMETRY_BROKER_HOST is set). The loop task
+// queues samples; after each weather fetch, while the radio is busy anyway,
+// a low-priority task on the network core connects to the broker, publishes
+// the backlog in CBOR batches (QoS 1) and disconnects. Samples leave the queue
+// only once acknowledged, so an unreachable broker fills it and the lowest
+// priorities are dropped first.
+class TelemetryPublisher {
+public:
+    static void begin();
+
+    static void recordObservation(const WeatherData& data);
+    static void recordFetch(bool success, uint32_t durationMs, uint32_t dnsMs);
+    static void recordHealth(const HealthModel& health);
+
+    // Start a publish window now (called right after a fetch)
+    static void flush();
+
+    // Perf report section: queue depth, throughput and drops
+    static void report();
+
+    static uint8_t queueDepth();
+    static uint32_t samplesSent() { return session.samplesSent(); }
+    static uint32_t samplesDropped();
+
+private:
+    static TelemetryQueue queue;
+    static TelemetrySession session;   // Owned by the publisher task
+    static TaskHandle_t task;
+    static uint32_t windows;
+    static uint32_t failedWindows;
+    static uint32_t lastWindowMs;
+
+    static void record(uint8_t kind, uint8_t priority, uint32_t epoch, const int32_t* values, uint8_t count);
+    static bool publishWindow();
+    static void publisherTask(void* arg);
+};
+
+#endif // TELEMETRY_PUBLISHER_H
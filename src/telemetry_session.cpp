@@ -0,0 +1,73 @@
+#include "telemetry_session.h"
+#include "mqtt_packet.h"
+
+static void lockQueue(const TelemetryLink& link) {
+    if (link.lock != nullptr) {
+        link.lock(link.context);
+    }
+}
+
+static void unlockQueue(const TelemetryLink& link) {
+    if (link.unlock != nullptr) {
+        link.unlock(link.context);
+    }
+}
+
+TelemetrySession::TelemetrySession()
+    : clientId(""), topic(""), username(""), password(""), packetId(0), sent(0), batches(0), bytes(0),
+      refusal(0) {
+}
+
+void TelemetrySession::begin(const char* id, const char* topicName, const char* user, const char* pass) {
+    clientId = id;
+    topic = topicName;
+    username = user;
+    password = pass;
+}
+
+bool TelemetrySession::publishWindow(TelemetryQueue& queue, const TelemetryLink& link) {
+    refusal = 0;
+    size_t n = mqttConnect(controlPacket, sizeof(controlPacket), clientId, TELEMETRY_KEEPALIVE_S, username,
+                           password);
+    uint8_t reply[4];
+    if (n == 0 || !link.send(link.context, controlPacket, n) ||
+        !link.receive(link.context, reply, MQTT_CONNACK_SIZE)) {
+        return false;
+    }
+    int rc = mqttParseConnack(reply, MQTT_CONNACK_SIZE);
+    if (rc != 0) {
+        refusal = rc;
+        return false;
+    }
+
+    bool ok = true;
+    for (int b = 0; b < TELEMETRY_MAX_BATCHES; b++) {
+        lockQueue(link);
+        uint8_t count = queue.peek(batch, TELEMETRY_BATCH_SAMPLES);
+        unlockQueue(link);
+        if (count == 0) {
+            break;
+        }
+
+        size_t len = encodeTelemetryBatch(batch, count, batches, clientId, payload, sizeof(payload));
+        packetId = packetId == 0xFFFF ? 1 : packetId + 1;
+        n = mqttPublishHeader(controlPacket, sizeof(controlPacket), topic, packetId, len);
+        if (len == 0 || n == 0 || !link.send(link.context, controlPacket, n) ||
+            !link.send(link.context, payload, len) || !link.receive(link.context, reply, MQTT_PUBACK_SIZE) ||
+            !mqttIsPuback(reply, MQTT_PUBACK_SIZE, packetId)) {
+            ok = false;  // Unacknowledged samples stay queued for the next window
+            break;
+        }
+
+        lockQueue(link);
+        queue.popThrough(batch[count - 1].seq);
+        unlockQueue(link);
+        sent += count;
+        batches++;
+        bytes += (uint32_t)(n + len);
+    }
+
+    n = mqttDisconnect(controlPacket, sizeof(controlPacket));
+    link.send(link.context, controlPacket, n);
+    return ok;
+}
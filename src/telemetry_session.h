@@ -0,0 +1,56 @@
+#ifndef TELEMETRY_SESSION_H
+#define TELEMETRY_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "telemetry.h"
+
+// One publish window over an already open broker connection, independent of
+// the socket layer so the same code runs on the host against a stand-in
+// broker. No Arduino dependencies.
+
+// The connection and the queue lock. The publisher wraps a WiFiClient and a
+// critical section; lock/unlock may be nullptr when nothing else touches the queue.
+struct TelemetryLink {
+    void* context;
+    bool (*send)(void* context, const uint8_t* data, size_t len);
+    bool (*receive)(void* context, uint8_t* data, size_t len);   // Exactly len bytes; false on timeout or close
+    void (*lock)(void* context);
+    void (*unlock)(void* context);
+};
+
+class TelemetrySession {
+public:
+    TelemetrySession();
+
+    // topic must outlive the session
+    void begin(const char* clientId, const char* topic, const char* username, const char* password);
+
+    // CONNECT, then batches of the oldest samples as QoS 1 PUBLISH until the
+    // queue is empty or TELEMETRY_MAX_BATCHES went out, then DISCONNECT.
+    // Samples leave the queue only when their PUBACK arrives, so a window cut
+    // short leaves them for the next one. False on any failure.
+    bool publishWindow(TelemetryQueue& queue, const TelemetryLink& link);
+
+    uint32_t samplesSent() const { return sent; }
+    uint32_t batchesSent() const { return batches; }
+    uint32_t bytesSent() const { return bytes; }
+    int lastRefusal() const { return refusal; }   // CONNACK code if the last window was refused, else 0
+
+private:
+    const char* clientId;
+    const char* topic;
+    const char* username;
+    const char* password;
+    uint16_t packetId;
+    uint32_t sent;
+    uint32_t batches;
+    uint32_t bytes;
+    int refusal;
+    uint8_t controlPacket[160];
+    uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+    TelemetrySample batch[TELEMETRY_BATCH_SAMPLES];
+};
+
+#endif // TELEMETRY_SESSION_H
@@ -0,0 +1,48 @@
+#include "ticker_buffer.h"
+#include <string.h>
+
+TickerBuffer::TickerBuffer() : state(0) {
+    for (int i = 0; i < 2; i++) {
+        slots[i].text[0] = '\0';
+        slots[i].length = 0;
+        slots[i].width = TICKER_WIDTH_UNKNOWN;
+    }
+}
+
+char* TickerBuffer::beginWrite() {
+    // Clearing PENDING pins the front index until the next commit
+    uint8_t current = state.load(std::memory_order_acquire);
+    while (!state.compare_exchange_weak(current, (uint8_t)(current & ~PENDING),
+                                        std::memory_order_acq_rel)) {
+    }
+    return slots[(current & FRONT) ^ 1].text;
+}
+
+void TickerBuffer::commit(size_t length, int16_t width) {
+    TickerSlot& back = slots[frontIndex() ^ 1];
+    if (length >= TICKER_MESSAGE_SIZE) {
+        length = TICKER_MESSAGE_SIZE - 1;
+    }
+    back.text[length] = '\0';
+    back.length = (uint16_t)length;
+    back.width = width;
+    state.fetch_or(PENDING, std::memory_order_release);
+}
+
+void TickerBuffer::set(const char* text) {
+    char* out = beginWrite();
+    size_t length = strnlen(text, TICKER_MESSAGE_SIZE - 1);
+    memcpy(out, text, length);
+    commit(length);
+}
+
+bool TickerBuffer::swap() {
+    uint8_t current = state.load(std::memory_order_acquire);
+    while (current & PENDING) {
+        uint8_t flipped = (uint8_t)((current ^ FRONT) & ~PENDING);
+        if (state.compare_exchange_weak(current, flipped, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
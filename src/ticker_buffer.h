@@ -0,0 +1,60 @@
+#ifndef TICKER_BUFFER_H
+#define TICKER_BUFFER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Two-slot scrolling message store. The producer (fetch) formats into the
+// back slot and commits it; the renderer flips to it at the wrap point.
+// One producer and one consumer; the handoff is lock-free so either side
+// can run on the other core. No Arduino dependencies.
+
+#define TICKER_WIDTH_UNKNOWN -1
+
+struct TickerSlot {
+    char text[TICKER_MESSAGE_SIZE];
+    uint16_t length;
+    int16_t width;   // Pixel width, TICKER_WIDTH_UNKNOWN until measured
+};
+
+class TickerBuffer {
+public:
+    TickerBuffer();
+
+    // Producer: claim the back slot for writing. Withdraws any pending commit
+    // so the consumer cannot flip to a half-written slot.
+    char* beginWrite();
+    size_t capacity() const { return TICKER_MESSAGE_SIZE; }
+
+    // Producer: publish the back slot; length excludes the terminator.
+    // Pass the pixel width if already measured.
+    void commit(size_t length, int16_t width = TICKER_WIDTH_UNKNOWN);
+
+    // Producer: beginWrite + copy + commit
+    void set(const char* text);
+
+    // Consumer: make a committed back slot the front. Returns true if flipped.
+    bool swap();
+
+    bool pending() const { return (state.load(std::memory_order_acquire) & PENDING) != 0; }
+
+    // Consumer: front slot accessors
+    const char* front() const { return slots[frontIndex()].text; }
+    uint16_t frontLength() const { return slots[frontIndex()].length; }
+    int16_t frontWidth() const { return slots[frontIndex()].width; }
+    void setFrontWidth(int16_t width) { slots[frontIndex()].width = width; }
+
+private:
+    // state bit 0 = front slot index, bit 1 = back slot committed
+    static const uint8_t FRONT = 0x01;
+    static const uint8_t PENDING = 0x02;
+
+    TickerSlot slots[2];
+    std::atomic<uint8_t> state;
+
+    uint8_t frontIndex() const { return state.load(std::memory_order_acquire) & FRONT; }
+};
+
+#endif // TICKER_BUFFER_H
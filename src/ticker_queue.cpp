@@ -0,0 +1,115 @@
+#include "ticker_queue.h"
+#include <string.h>
+
+TickerQueue::TickerQueue() : showSeq(0), gen(0), nextId(1) {
+    memset(entries, 0, sizeof(entries));
+}
+
+TickerMessage* TickerQueue::find(uint8_t source) {
+    for (int i = 0; i < TICKER_QUEUE_SIZE; i++) {
+        if (entries[i].id != 0 && entries[i].source == source) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+char* TickerQueue::reserve(uint8_t source, uint8_t priority, uint32_t ttlMs,
+                           uint8_t minRepeats, uint32_t nowMs) {
+    TickerMessage* slot = find(source);
+    if (slot == nullptr) {
+        // Free entry, else the lowest-priority (then oldest) one
+        for (int i = 0; i < TICKER_QUEUE_SIZE; i++) {
+            TickerMessage& e = entries[i];
+            if (e.id == 0) {
+                slot = &e;
+                break;
+            }
+            if (slot == nullptr || e.priority < slot->priority ||
+                (e.priority == slot->priority && (int32_t)(e.postedMs - slot->postedMs) < 0)) {
+                slot = &e;
+            }
+        }
+        if (slot->id != 0 && slot->priority > priority) {
+            return nullptr;
+        }
+    }
+
+    slot->text[0] = '\0';
+    slot->postedMs = nowMs;
+    slot->ttlMs = ttlMs;
+    slot->lastShown = 0;   // Fresh content goes to the front of its level
+    slot->shown = 0;
+    slot->minRepeats = minRepeats;
+    slot->priority = priority;
+    slot->source = source;
+    slot->id = nextId++;
+    if (nextId == 0) {
+        nextId = 1;
+    }
+    gen++;
+    return slot->text;
+}
+
+uint16_t TickerQueue::post(uint8_t source, uint8_t priority, const char* text,
+                           uint32_t ttlMs, uint8_t minRepeats, uint32_t nowMs) {
+    char* out = reserve(source, priority, ttlMs, minRepeats, nowMs);
+    if (out == nullptr) {
+        return 0;
+    }
+    strncpy(out, text, TICKER_QUEUE_TEXT_SIZE - 1);
+    out[TICKER_QUEUE_TEXT_SIZE - 1] = '\0';
+    return find(source)->id;
+}
+
+void TickerQueue::clear(uint8_t source) {
+    TickerMessage* m = find(source);
+    if (m != nullptr) {
+        m->id = 0;
+        gen++;
+    }
+}
+
+bool TickerQueue::finished(const TickerMessage& m, uint32_t nowMs) const {
+    return m.ttlMs != 0 && nowMs - m.postedMs >= m.ttlMs && m.shown >= m.minRepeats;
+}
+
+const TickerMessage* TickerQueue::pick(uint32_t nowMs) {
+    const TickerMessage* best = nullptr;
+    for (int i = 0; i < TICKER_QUEUE_SIZE; i++) {
+        TickerMessage& e = entries[i];
+        if (e.id == 0) {
+            continue;
+        }
+        if (finished(e, nowMs)) {
+            e.id = 0;
+            gen++;
+            continue;
+        }
+        if (best == nullptr || e.priority > best->priority ||
+            (e.priority == best->priority && e.lastShown < best->lastShown)) {
+            best = &e;
+        }
+    }
+    return best;
+}
+
+void TickerQueue::markShown(uint16_t id) {
+    for (int i = 0; i < TICKER_QUEUE_SIZE; i++) {
+        if (entries[i].id == id && id != 0) {
+            entries[i].lastShown = ++showSeq;
+            entries[i].shown++;
+            return;
+        }
+    }
+}
+
+int TickerQueue::count() const {
+    int n = 0;
+    for (int i = 0; i < TICKER_QUEUE_SIZE; i++) {
+        if (entries[i].id != 0) {
+            n++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,75 @@
+#ifndef TICKER_QUEUE_H
+#define TICKER_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Ticker content scheduling. Each source owns at most one queued message;
+// posting again replaces it. At every wrap the highest priority level with a
+// live message wins, and messages within that level rotate least-recently-shown
+// first. No Arduino dependencies.
+
+enum TickerSource : uint8_t {
+    TICKER_SOURCE_CONDITIONS = 0,
+    TICKER_SOURCE_ALERT_WEATHER,
+    TICKER_SOURCE_ALERT_WIND,
+    TICKER_SOURCE_FORECAST,
+    TICKER_SOURCE_STATS,
+    TICKER_SOURCE_STATUS,
+    TICKER_SOURCE_COUNT
+};
+
+enum TickerPriority : uint8_t {
+    TICKER_PRIORITY_INFO = 1,     // Conditions, forecast, stats - rotate
+    TICKER_PRIORITY_STATUS = 2,   // Connection state - preempts info
+    TICKER_PRIORITY_ALERT = 3     // Severe weather - preempts everything
+};
+
+struct TickerMessage {
+    char text[TICKER_QUEUE_TEXT_SIZE];
+    uint32_t postedMs;
+    uint32_t ttlMs;        // 0 = until replaced or cleared
+    uint32_t lastShown;    // Show sequence number, 0 = never shown
+    uint16_t id;           // Unique per post, 0 = free entry
+    uint16_t shown;
+    uint8_t minRepeats;    // Kept past its TTL until shown this many times
+    uint8_t priority;
+    uint8_t source;
+};
+
+class TickerQueue {
+public:
+    TickerQueue();
+
+    // Queue or replace the source's message. When the queue is full the
+    // lowest-priority entry is evicted, unless it outranks the new message.
+    // Returns the message id, 0 if rejected.
+    uint16_t post(uint8_t source, uint8_t priority, const char* text,
+                  uint32_t ttlMs, uint8_t minRepeats, uint32_t nowMs);
+
+    // Same as post(), but returns the entry's text buffer (TICKER_QUEUE_TEXT_SIZE
+    // bytes) for the caller to fill in place. nullptr if rejected.
+    char* reserve(uint8_t source, uint8_t priority, uint32_t ttlMs, uint8_t minRepeats, uint32_t nowMs);
+    void clear(uint8_t source);
+
+    // Retire finished messages and return the entry to show next, nullptr if empty.
+    // Does not count as a showing - call markShown() when it reaches the screen.
+    const TickerMessage* pick(uint32_t nowMs);
+    void markShown(uint16_t id);
+
+    // Changes whenever queue contents change, so a prepared message can be revalidated
+    uint32_t generation() const { return gen; }
+    int count() const;
+
+private:
+    TickerMessage entries[TICKER_QUEUE_SIZE];
+    uint32_t showSeq;
+    uint32_t gen;
+    uint16_t nextId;
+
+    TickerMessage* find(uint8_t source);
+    bool finished(const TickerMessage& m, uint32_t nowMs) const;
+};
+
+#endif // TICKER_QUEUE_H
@@ -0,0 +1,77 @@
+#include "ticker_sources.h"
+#include <stdio.h>
+#include "weather_format.h"
+
+static size_t clampLength(int written, size_t outSize) {
+    if (written < 0) {
+        return 0;
+    }
+    return (size_t)written < outSize ? (size_t)written : outSize - 1;
+}
+
+void DailyStats::record(int32_t today, bool success, int16_t temperature) {
+    if (today != day) {
+        day = today;
+        fetches = 0;
+        failures = 0;
+    }
+    fetches++;
+    if (!success) {
+        failures++;
+        return;
+    }
+    if (fetches - failures == 1) {
+        minTemp = maxTemp = temperature;  // First good sample of the day
+    } else if (temperature < minTemp) {
+        minTemp = temperature;
+    } else if (temperature > maxTemp) {
+        maxTemp = temperature;
+    }
+}
+
+bool formatWeatherAlert(const WeatherData& data, char* out, size_t outSize) {
+    if (!isSevereCondition(data.conditionId)) {
+        return false;
+    }
+    snprintf(out, outSize, "!!! WEATHER ALERT: %s !!!", conditionDescription(data.conditionId));
+    return true;
+}
+
+bool formatWindAlert(const WeatherData& data, const UnitProfile& units, char* out, size_t outSize) {
+    if (data.windSpeed < units.wind(TICKER_ALERT_WIND_KMH / 3.6f)) {
+        return false;
+    }
+    char wind[8];
+    formatFixed(wind, sizeof(wind), data.windSpeed, WIND_SCALE, 0);
+    snprintf(out, outSize, "!!! WIND ALERT: %s %s !!!", wind, units.windSuffix);
+    return true;
+}
+
+size_t formatForecastSummary(const WeatherData& data, const UnitProfile& units, char* out, size_t outSize) {
+    char low[8], high[8], feels[8];
+    formatFixed(low, sizeof(low), data.minTemp, TEMP_SCALE, 1);
+    formatFixed(high, sizeof(high), data.maxTemp, TEMP_SCALE, 1);
+    formatFixed(feels, sizeof(feels), data.feelsLike, TEMP_SCALE, 1);
+    int n = snprintf(out, outSize, "... today: low %s%s, high %s%s, feels like %s%s ...",
+                     low, units.tempSymbol, high, units.tempSymbol, feels, units.tempSymbol);
+    return clampLength(n, outSize);
+}
+
+size_t formatDailyStats(const DailyStats& stats, const UnitProfile& units, char* out, size_t outSize) {
+    int n;
+    if (stats.fetches == stats.failures) {
+        n = snprintf(out, outSize, "... today: %u updates, %u failed ...", stats.fetches, stats.failures);
+    } else {
+        char low[8], high[8];
+        formatFixed(low, sizeof(low), stats.minTemp, TEMP_SCALE, 1);
+        formatFixed(high, sizeof(high), stats.maxTemp, TEMP_SCALE, 1);
+        n = snprintf(out, outSize, "... today: %u updates, %u failed, measured %s%s to %s%s ...",
+                     stats.fetches, stats.failures, low, units.tempSymbol, high, units.tempSymbol);
+    }
+    return clampLength(n, outSize);
+}
+
+size_t formatConnectionStatus(const char* lastUpdated, char* out, size_t outSize) {
+    int n = snprintf(out, outSize, "... connection lost - retrying, last update at %s ...", lastUpdated);
+    return clampLength(n, outSize);
+}
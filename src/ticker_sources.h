@@ -0,0 +1,36 @@
+#ifndef TICKER_SOURCES_H
+#define TICKER_SOURCES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "weather_data.h"
+
+// Ticker message text for each content source. No Arduino dependencies.
+
+// Fetch results and observed temperature range for the current local day
+struct DailyStats {
+    int32_t day;          // localDayNumber() the counters belong to
+    uint16_t fetches;
+    uint16_t failures;
+    int16_t minTemp;      // TEMP_SCALE
+    int16_t maxTemp;      // TEMP_SCALE
+
+    DailyStats() : day(0), fetches(0), failures(0), minTemp(0), maxTemp(0) {}
+
+    // Count a fetch; counters restart when the day changes
+    void record(int32_t today, bool success, int16_t temperature);
+};
+
+// Severe-weather and high-wind alerts; return false when there is nothing to report
+bool formatWeatherAlert(const WeatherData& data, char* out, size_t outSize);
+bool formatWindAlert(const WeatherData& data, const UnitProfile& units, char* out, size_t outSize);
+
+// Today's low/high from the current observation
+size_t formatForecastSummary(const WeatherData& data, const UnitProfile& units, char* out, size_t outSize);
+
+size_t formatDailyStats(const DailyStats& stats, const UnitProfile& units, char* out, size_t outSize);
+
+// Shown while the last fetch failed
+size_t formatConnectionStatus(const char* lastUpdated, char* out, size_t outSize);
+
+#endif // TICKER_SOURCES_H
@@ -0,0 +1,217 @@
+#include "ticker_template.h"
+#include <string.h>
+#include "weather_format.h"
+
+enum TickerOpKind : uint8_t {
+    TICKER_OP_LITERAL = 0,
+    TICKER_OP_FIELD
+};
+
+struct FieldInfo {
+    const char* name;
+    int8_t defaultDecimals;  // -1 = text field
+};
+
+// Indexed by TickerField
+static const FieldInfo FIELDS[TICKER_FIELD_COUNT] = {
+    {"desc", -1},
+    {"temp", 1},
+    {"feels", 1},
+    {"min", 1},
+    {"max", 1},
+    {"humidity", 0},
+    {"pressure", 0},
+    {"wind", 1},
+    {"vis", 1},
+    {"clouds", 0},
+    {"updated", -1},
+    {"sunrise", -1},
+    {"sunset", -1},
+    {"temp_unit", -1},
+    {"wind_unit", -1},
+    {"vis_unit", -1},
+};
+
+#define TICKER_MAX_DECIMALS 3
+
+TickerTemplate::TickerTemplate() : numOps(0), poolLen(0), errorText(nullptr), errorPos(-1) {
+}
+
+bool TickerTemplate::fail(const char* message, int offset) {
+    numOps = 0;
+    poolLen = 0;
+    errorText = message;
+    errorPos = offset;
+    return false;
+}
+
+bool TickerTemplate::addLiteral(const char* text, size_t length, int offset) {
+    if (length == 0) {
+        return true;
+    }
+    // Extend the previous literal when contiguous (e.g. around "{{")
+    if (numOps > 0 && ops[numOps - 1].kind == TICKER_OP_LITERAL &&
+        ops[numOps - 1].offset + ops[numOps - 1].arg == poolLen && ops[numOps - 1].arg + length <= 255) {
+        if (poolLen + length > sizeof(pool)) {
+            return fail("template too long", offset);
+        }
+        memcpy(pool + poolLen, text, length);
+        poolLen += length;
+        ops[numOps - 1].arg += length;
+        return true;
+    }
+    if (numOps >= TICKER_TEMPLATE_MAX_OPS) {
+        return fail("too many template parts", offset);
+    }
+    if (poolLen + length > sizeof(pool) || length > 255) {
+        return fail("template too long", offset);
+    }
+    TickerOp& op = ops[numOps++];
+    op.kind = TICKER_OP_LITERAL;
+    op.arg = (uint8_t)length;
+    op.decimals = 0;
+    op.offset = poolLen;
+    memcpy(pool + poolLen, text, length);
+    poolLen += length;
+    return true;
+}
+
+bool TickerTemplate::compile(const char* source) {
+    numOps = 0;
+    poolLen = 0;
+    errorText = nullptr;
+    errorPos = -1;
+
+    const char* p = source;
+    const char* literalStart = p;
+    while (*p != '\0') {
+        if (p[0] == '}') {
+            if (p[1] != '}') {
+                return fail("unmatched '}'", (int)(p - source));
+            }
+            if (!addLiteral(literalStart, p + 1 - literalStart, (int)(p - source))) {
+                return false;
+            }
+            p += 2;
+            literalStart = p;
+            continue;
+        }
+        if (p[0] != '{') {
+            p++;
+            continue;
+        }
+        if (p[1] == '{') {
+            if (!addLiteral(literalStart, p + 1 - literalStart, (int)(p - source))) {
+                return false;
+            }
+            p += 2;
+            literalStart = p;
+            continue;
+        }
+        if (!addLiteral(literalStart, p - literalStart, (int)(p - source))) {
+            return false;
+        }
+
+        // {name} or {name:N}
+        const char* nameStart = p + 1;
+        const char* nameEnd = nameStart;
+        while (*nameEnd != '\0' && *nameEnd != '}' && *nameEnd != ':') {
+            nameEnd++;
+        }
+        if (*nameEnd == '\0') {
+            return fail("unterminated field", (int)(p - source));
+        }
+        size_t nameLen = nameEnd - nameStart;
+        int field = -1;
+        for (int i = 0; i < TICKER_FIELD_COUNT; i++) {
+            if (strlen(FIELDS[i].name) == nameLen && strncmp(FIELDS[i].name, nameStart, nameLen) == 0) {
+                field = i;
+                break;
+            }
+        }
+        if (field < 0) {
+            return fail("unknown field", (int)(nameStart - source));
+        }
+
+        int decimals = FIELDS[field].defaultDecimals;
+        const char* end = nameEnd;
+        if (*end == ':') {
+            if (decimals < 0) {
+                return fail("text field takes no precision", (int)(end - source));
+            }
+            if (end[1] < '0' || end[1] > '0' + TICKER_MAX_DECIMALS || end[2] != '}') {
+                return fail("precision must be one digit 0-3", (int)(end - source));
+            }
+            decimals = end[1] - '0';
+            end += 2;
+        }
+
+        if (numOps >= TICKER_TEMPLATE_MAX_OPS) {
+            return fail("too many template parts", (int)(p - source));
+        }
+        TickerOp& op = ops[numOps++];
+        op.kind = TICKER_OP_FIELD;
+        op.arg = (uint8_t)field;
+        op.decimals = decimals < 0 ? 0 : (uint8_t)decimals;
+        op.offset = 0;
+
+        p = end + 1;
+        literalStart = p;
+    }
+    return addLiteral(literalStart, p - literalStart, (int)(p - source));
+}
+
+static size_t appendText(char* out, size_t len, size_t outSize, const char* text) {
+    while (*text != '\0' && len + 1 < outSize) {
+        out[len++] = *text++;
+    }
+    return len;
+}
+
+size_t TickerTemplate::render(const WeatherData& data, const TickerTextFields& text, char* out, size_t outSize) const {
+    if (outSize == 0) {
+        return 0;
+    }
+    size_t len = 0;
+    for (int i = 0; i < numOps && len + 1 < outSize; i++) {
+        const TickerOp& op = ops[i];
+        if (op.kind == TICKER_OP_LITERAL) {
+            size_t n = op.arg;
+            if (n > outSize - 1 - len) {
+                n = outSize - 1 - len;
+            }
+            memcpy(out + len, pool + op.offset, n);
+            len += n;
+            continue;
+        }
+
+        int32_t value = 0;
+        int32_t scale = 1;
+        const char* str = nullptr;
+        switch (op.arg) {
+            case TICKER_FIELD_DESC: str = conditionDescription(data.conditionId); break;
+            case TICKER_FIELD_TEMP: value = data.temperature; scale = TEMP_SCALE; break;
+            case TICKER_FIELD_FEELS: value = data.feelsLike; scale = TEMP_SCALE; break;
+            case TICKER_FIELD_MIN: value = data.minTemp; scale = TEMP_SCALE; break;
+            case TICKER_FIELD_MAX: value = data.maxTemp; scale = TEMP_SCALE; break;
+            case TICKER_FIELD_HUMIDITY: value = data.humidity; break;
+            case TICKER_FIELD_PRESSURE: value = data.pressure; break;
+            case TICKER_FIELD_WIND: value = data.windSpeed; scale = WIND_SCALE; break;
+            case TICKER_FIELD_VIS: value = data.visibility; scale = VISIBILITY_SCALE; break;
+            case TICKER_FIELD_CLOUDS: value = data.cloudCoverage; break;
+            case TICKER_FIELD_UPDATED: str = text.updated; break;
+            case TICKER_FIELD_SUNRISE: str = text.sunrise; break;
+            case TICKER_FIELD_SUNSET: str = text.sunset; break;
+            case TICKER_FIELD_TEMP_UNIT: str = text.tempUnit; break;
+            case TICKER_FIELD_WIND_UNIT: str = text.windUnit; break;
+            case TICKER_FIELD_VIS_UNIT: str = text.visUnit; break;
+        }
+        if (str != nullptr) {
+            len = appendText(out, len, outSize, str);
+        } else if (FIELDS[op.arg].defaultDecimals >= 0) {
+            len += formatFixed(out + len, outSize - len, value, scale, op.decimals);
+        }
+    }
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,77 @@
+#ifndef TICKER_TEMPLATE_H
+#define TICKER_TEMPLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "weather_data.h"
+
+// Ticker message templates, e.g. "{desc}, wind {wind:1}{wind_unit}, updated {updated}".
+// compile() turns the text into a short opcode list once; render() runs it
+// without printf. "{{" and "}}" are literal braces, ":N" sets the decimals
+// of a numeric field. No Arduino dependencies.
+
+enum TickerField : uint8_t {
+    TICKER_FIELD_DESC = 0,
+    TICKER_FIELD_TEMP,
+    TICKER_FIELD_FEELS,
+    TICKER_FIELD_MIN,
+    TICKER_FIELD_MAX,
+    TICKER_FIELD_HUMIDITY,
+    TICKER_FIELD_PRESSURE,
+    TICKER_FIELD_WIND,
+    TICKER_FIELD_VIS,
+    TICKER_FIELD_CLOUDS,
+    TICKER_FIELD_UPDATED,
+    TICKER_FIELD_SUNRISE,
+    TICKER_FIELD_SUNSET,
+    TICKER_FIELD_TEMP_UNIT,
+    TICKER_FIELD_WIND_UNIT,
+    TICKER_FIELD_VIS_UNIT,
+    TICKER_FIELD_COUNT
+};
+
+// Text values the template can reference besides WeatherData
+struct TickerTextFields {
+    const char* updated;
+    const char* sunrise;
+    const char* sunset;
+    const char* tempUnit;
+    const char* windUnit;
+    const char* visUnit;
+};
+
+struct TickerOp {
+    uint8_t kind;      // TICKER_OP_LITERAL or TICKER_OP_FIELD
+    uint8_t arg;       // Literal length, or TickerField
+    uint8_t decimals;  // Numeric fields only
+    uint8_t offset;    // Literal start in the pool
+};
+
+class TickerTemplate {
+public:
+    TickerTemplate();
+
+    // Parse source; on failure the template is left empty and error()/errorOffset() say why
+    bool compile(const char* source);
+
+    // Execute into out (always terminated); returns the length written
+    size_t render(const WeatherData& data, const TickerTextFields& text, char* out, size_t outSize) const;
+
+    int opCount() const { return numOps; }
+    const char* error() const { return errorText; }
+    int errorOffset() const { return errorPos; }
+
+private:
+    TickerOp ops[TICKER_TEMPLATE_MAX_OPS];
+    char pool[TICKER_TEMPLATE_SIZE];  // Literal text, not terminated
+    uint8_t numOps;
+    uint8_t poolLen;
+    const char* errorText;
+    int errorPos;
+
+    bool fail(const char* message, int offset);
+    bool addLiteral(const char* text, size_t length, int offset);
+};
+
+#endif // TICKER_TEMPLATE_H
@@ -0,0 +1,103 @@
+#include "tween.h"
+
+int32_t ease(uint8_t curve, int32_t t) {
+    if (t <= 0) return 0;
+    if (t >= EASE_ONE) return EASE_ONE;
+
+    switch (curve) {
+        case EASE_OUT_CUBIC: {
+            int32_t u = EASE_ONE - t;
+            int32_t u3 = (int32_t)(((int64_t)u * u >> 15) * u >> 15);
+            return EASE_ONE - u3;
+        }
+        case EASE_IN_OUT_QUAD:
+            if (t < EASE_ONE / 2) {
+                return (int32_t)((int64_t)t * t >> 14);   // 2t^2
+            } else {
+                int32_t u = EASE_ONE - t;
+                return EASE_ONE - (int32_t)((int64_t)u * u >> 14);
+            }
+        case EASE_LINEAR:
+        default:
+            return t;
+    }
+}
+
+Animator::Animator() : pendingRegions(0) {
+    for (int i = 0; i < TWEEN_MAX_CHANNELS; i++) {
+        tweens[i].active = false;
+        tweens[i].current = 0;
+        tweens[i].regions = 0;
+    }
+}
+
+bool Animator::start(uint8_t channel, int32_t from, int32_t to, uint32_t now,
+                     uint16_t durationMs, uint8_t curve, uint32_t regions) {
+    if (channel >= TWEEN_MAX_CHANNELS) {
+        return false;
+    }
+    Tween& tw = tweens[channel];
+    tw.from = from;
+    tw.to = to;
+    tw.current = from;
+    tw.start = now;
+    tw.regions = regions;
+    tw.duration = durationMs;   // 0 lands on the target at the next tick
+    tw.curve = curve < EASE_CURVE_COUNT ? curve : (uint8_t)EASE_LINEAR;
+    tw.active = true;
+    pendingRegions |= regions;
+    return true;
+}
+
+void Animator::cancel(uint8_t channel) {
+    if (channel < TWEEN_MAX_CHANNELS && tweens[channel].active) {
+        tweens[channel].active = false;
+        pendingRegions |= tweens[channel].regions;
+    }
+}
+
+uint32_t Animator::tick(uint32_t now) {
+    uint32_t dirty = pendingRegions;
+    pendingRegions = 0;
+
+    for (int i = 0; i < TWEEN_MAX_CHANNELS; i++) {
+        Tween& tw = tweens[i];
+        if (!tw.active) {
+            continue;
+        }
+        uint32_t elapsed = now - tw.start;
+        int32_t next;
+        if (elapsed >= tw.duration) {
+            next = tw.to;
+            tw.active = false;
+            dirty |= tw.regions;   // Final frame draws the target
+        } else {
+            int32_t e = ease(tw.curve, (int32_t)(((uint64_t)elapsed << 15) / tw.duration));
+            next = tw.from + (int32_t)(((int64_t)(tw.to - tw.from) * e) >> 15);
+        }
+        if (next != tw.current) {
+            tw.current = next;
+            dirty |= tw.regions;
+        }
+    }
+    return dirty;
+}
+
+bool Animator::active(uint8_t channel) const {
+    return channel < TWEEN_MAX_CHANNELS && tweens[channel].active;
+}
+
+uint8_t Animator::activeCount() const {
+    uint8_t n = 0;
+    for (int i = 0; i < TWEEN_MAX_CHANNELS; i++) {
+        n += tweens[i].active ? 1 : 0;
+    }
+    return n;
+}
+
+int32_t Animator::value(uint8_t channel, int32_t idle) const {
+    if (channel >= TWEEN_MAX_CHANNELS || !tweens[channel].active) {
+        return idle;
+    }
+    return tweens[channel].current;
+}
@@ -0,0 +1,60 @@
+#ifndef TWEEN_H
+#define TWEEN_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Fixed-point value animations driven by the frame clock. Each animated
+// value owns a channel in a preallocated table; tick() advances them all
+// and returns the display regions whose value changed, so the renderer only
+// redraws those. No Arduino dependencies.
+
+// Easing curves map progress 0..EASE_ONE to 0..EASE_ONE (Q15)
+#define EASE_ONE 32768
+
+enum EaseCurve : uint8_t {
+    EASE_LINEAR = 0,
+    EASE_OUT_CUBIC,      // Fast start, gentle landing - counters
+    EASE_IN_OUT_QUAD,    // Symmetric - fades and slides
+    EASE_CURVE_COUNT
+};
+
+int32_t ease(uint8_t curve, int32_t t);
+
+class Animator {
+public:
+    Animator();
+
+    // Animate channel from -> to starting now; replaces a running tween.
+    // regions is the invalidation mask reported by tick() while it runs.
+    bool start(uint8_t channel, int32_t from, int32_t to, uint32_t now,
+               uint16_t durationMs, uint8_t curve, uint32_t regions);
+    void cancel(uint8_t channel);
+
+    // Advance every running tween to now. Returns the regions to redraw:
+    // tweens whose value moved, just started or just finished.
+    uint32_t tick(uint32_t now);
+
+    bool active(uint8_t channel) const;
+    uint8_t activeCount() const;
+
+    // Value as of the last tick; idle (normally the target) when not running
+    int32_t value(uint8_t channel, int32_t idle) const;
+
+private:
+    struct Tween {
+        int32_t from;
+        int32_t to;
+        int32_t current;
+        uint32_t start;
+        uint32_t regions;
+        uint16_t duration;
+        uint8_t curve;
+        bool active;
+    };
+
+    Tween tweens[TWEEN_MAX_CHANNELS];
+    uint32_t pendingRegions;   // Starts and cancels since the last tick
+};
+
+#endif // TWEEN_H
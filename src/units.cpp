@@ -0,0 +1,49 @@
+#include "units.h"
+#include <string.h>
+
+// One instance of each policy
+template struct UnitPolicy<UNIT_CELSIUS, UNIT_KMH, UNIT_KILOMETERS>;
+template struct UnitPolicy<UNIT_FAHRENHEIT, UNIT_MPH, UNIT_MILES>;
+template struct UnitPolicy<UNIT_CELSIUS, UNIT_MPH, UNIT_MILES>;
+
+struct NamedProfile {
+    const char* name;
+    const UnitProfile* profile;
+};
+
+static const NamedProfile PROFILES[] = {
+    {"metric", &MetricUnits::profile},
+    {"imperial", &ImperialUnits::profile},
+    {"mixed", &MixedUnits::profile},
+};
+
+const UnitProfile& resolveUnitProfile(const char* name) {
+    for (const NamedProfile& p : PROFILES) {
+        if (name != nullptr && strcmp(name, p.name) == 0) {
+            return *p.profile;
+        }
+    }
+    return MetricUnits::profile;
+}
+
+ApiUnits resolveApiUnits(const char* name) {
+    if (name != nullptr && strcmp(name, "metric") == 0) {
+        return API_UNITS_METRIC;
+    }
+    if (name != nullptr && strcmp(name, "imperial") == 0) {
+        return API_UNITS_IMPERIAL;
+    }
+    return API_UNITS_STANDARD;
+}
+
+float apiTemperatureToCelsius(float value, ApiUnits api) {
+    switch (api) {
+        case API_UNITS_METRIC: return value;
+        case API_UNITS_IMPERIAL: return (value - 32.0f) / 1.8f;
+        default: return value - 273.15f;
+    }
+}
+
+float apiWindToMps(float value, ApiUnits api) {
+    return api == API_UNITS_IMPERIAL ? value / 2.236936f : value;
+}
@@ -0,0 +1,115 @@
+#ifndef UNITS_H
+#define UNITS_H
+
+#include <stdint.h>
+#include "weather_format.h"
+
+// Fixed-point scales of the WeatherData fields
+#define TEMP_SCALE 10        // 0.1 degree
+#define WIND_SCALE 10        // 0.1 wind unit
+#define VISIBILITY_SCALE 10  // 0.1 distance unit
+
+// Unit systems as policy templates. A policy fixes the conversion factors,
+// suffixes and layout for one combination of units; resolveUnitProfile()
+// picks one at config time and everything downstream uses the resolved
+// UnitProfile, so nothing compares unit names while rendering.
+// No Arduino dependencies.
+
+enum TempUnit : uint8_t { UNIT_CELSIUS, UNIT_FAHRENHEIT };
+enum SpeedUnit : uint8_t { UNIT_KMH, UNIT_MPH, UNIT_MPS };
+enum DistanceUnit : uint8_t { UNIT_KILOMETERS, UNIT_MILES };
+
+// Unit system of the API response (the OPENWEATHERMAP_UNITS query parameter)
+enum ApiUnits : uint8_t {
+    API_UNITS_STANDARD = 0,  // Kelvin, m/s
+    API_UNITS_METRIC,        // Celsius, m/s
+    API_UNITS_IMPERIAL       // Fahrenheit, mph
+};
+
+template <TempUnit T> struct TempTraits;
+template <> struct TempTraits<UNIT_CELSIUS> {
+    static constexpr const char* symbol = "C";
+    static constexpr int symbolY = 55;  // Baseline of the unit letter beside the big temperature
+    static float fromCelsius(float c) { return c; }
+};
+template <> struct TempTraits<UNIT_FAHRENHEIT> {
+    static constexpr const char* symbol = "F";
+    static constexpr int symbolY = 49;
+    static float fromCelsius(float c) { return c * 1.8f + 32.0f; }
+};
+
+template <SpeedUnit S> struct SpeedTraits;
+template <> struct SpeedTraits<UNIT_KMH> {
+    static constexpr const char* suffix = "km/h";
+    static constexpr float perMps = 3.6f;
+};
+template <> struct SpeedTraits<UNIT_MPH> {
+    static constexpr const char* suffix = "mph";
+    static constexpr float perMps = 2.236936f;
+};
+template <> struct SpeedTraits<UNIT_MPS> {
+    static constexpr const char* suffix = "m/s";
+    static constexpr float perMps = 1.0f;
+};
+
+template <DistanceUnit D> struct DistanceTraits;
+template <> struct DistanceTraits<UNIT_KILOMETERS> {
+    static constexpr const char* suffix = "km";
+    static constexpr int32_t metersPerUnit = 1000;
+};
+template <> struct DistanceTraits<UNIT_MILES> {
+    static constexpr const char* suffix = "mi";
+    static constexpr int32_t metersPerUnit = 1609;
+};
+
+// Resolved unit system - plain data plus conversion entry points
+struct UnitProfile {
+    const char* tempSymbol;     // "C" / "F"
+    const char* windSuffix;     // "km/h", "mph", "m/s"
+    const char* distSuffix;     // "km", "mi"
+    int tempSymbolY;            // Layout of the unit letter in the left panel
+    int16_t (*temperature)(float celsius);       // -> TEMP_SCALE
+    int16_t (*wind)(float metersPerSecond);      // -> WIND_SCALE
+    int16_t (*visibility)(int32_t meters);       // -> VISIBILITY_SCALE
+};
+
+template <TempUnit T, SpeedUnit S, DistanceUnit D>
+struct UnitPolicy {
+    static int16_t temperature(float celsius) {
+        return toFixed(TempTraits<T>::fromCelsius(celsius), TEMP_SCALE);
+    }
+    static int16_t wind(float metersPerSecond) {
+        return toFixed(metersPerSecond * SpeedTraits<S>::perMps, WIND_SCALE);
+    }
+    static int16_t visibility(int32_t meters) {
+        int32_t unit = DistanceTraits<D>::metersPerUnit;
+        return (int16_t)((meters * VISIBILITY_SCALE + unit / 2) / unit);
+    }
+
+    static const UnitProfile profile;
+};
+
+template <TempUnit T, SpeedUnit S, DistanceUnit D>
+const UnitProfile UnitPolicy<T, S, D>::profile = {
+    TempTraits<T>::symbol,
+    SpeedTraits<S>::suffix,
+    DistanceTraits<D>::suffix,
+    TempTraits<T>::symbolY,
+    &UnitPolicy<T, S, D>::temperature,
+    &UnitPolicy<T, S, D>::wind,
+    &UnitPolicy<T, S, D>::visibility,
+};
+
+typedef UnitPolicy<UNIT_CELSIUS, UNIT_KMH, UNIT_KILOMETERS> MetricUnits;
+typedef UnitPolicy<UNIT_FAHRENHEIT, UNIT_MPH, UNIT_MILES> ImperialUnits;
+typedef UnitPolicy<UNIT_CELSIUS, UNIT_MPH, UNIT_MILES> MixedUnits;   // UK style
+
+// Config-time lookup: "metric", "imperial" or "mixed"; anything else is metric
+const UnitProfile& resolveUnitProfile(const char* name);
+ApiUnits resolveApiUnits(const char* name);
+
+// Normalize raw API values to Celsius and m/s before the profile converts them
+float apiTemperatureToCelsius(float value, ApiUnits api);
+float apiWindToMps(float value, ApiUnits api);
+
+#endif // UNITS_H
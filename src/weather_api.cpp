@@ -1,8 +1,25 @@
 #include "weather_api.h"
 #include <ESP32Time.h> // Include ESP32Time for rtc object
+#include <WiFiClientSecure.h>
+#include <Preferences.h>
+#include "stall_monitor.h"
+#include "json_allocator.h"
+#include "weather_format.h"
+#include "dns_resolver.h"
+
+uint32_t ErrorHandler::counts[ErrorHandler::TIME_SYNC_ERROR + 1];
+FetchStats WeatherAPI::stats;
+ApiBudget WeatherAPI::budget;
+
+// UTC seconds, 0 while the clock is unset
+static uint32_t clockNow() {
+    time_t now = time(nullptr);
+    return now >= (time_t)SOLAR_MIN_EPOCH ? (uint32_t)now : 0;
+}
 
 // ErrorHandler implementation (moved from main.cpp)
 void ErrorHandler::handleError(ErrorType type, const char* message, int code) {
+    counts[type]++;
     Serial.print("ERROR [");
     Serial.print(getErrorTypeName(type));
     Serial.print("]: ");
@@ -29,13 +46,16 @@ const char* ErrorHandler::getErrorTypeName(ErrorType type) {
     }
 }
 
-WeatherAPI::WeatherAPI(ESP32Time& rtcRef) : rtc(rtcRef) {
-    // Constructor initialization
+WeatherAPI::WeatherAPI(ESP32Time& rtcRef) : rtc(rtcRef), lastFetchMs(0), lastDnsMs(0) {
+    if (!parseHttpUrl(OPENWEATHERMAP_API_ENDPOINT, &endpoint)) {
+        endpoint.host[0] = '\0';   // Reported on the first fetch
+    }
 }
 
 // connectWiFi() removed - WiFi connection now handled in main.cpp
 
 bool WeatherAPI::setTime() {
+    StallScope stallScope(STALL_REGION_NTP);
     Serial.println("Synchronizing time with NTP server...");
     configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
     
@@ -52,29 +72,141 @@ bool WeatherAPI::setTime() {
         attempts++;
     }
     
-    Serial.println("Failed to sync time with NTP");
+    ErrorHandler::handleError(ErrorHandler::TIME_SYNC_ERROR, "Failed to sync time with NTP");
     return false;
 }
 
-bool WeatherAPI::getData(WeatherData& weatherData, DisplayState& displayState) {
+void WeatherAPI::beginBudget() {
+    ApiBudgetState saved = {};
+    Preferences prefs;
+    prefs.begin("api", true);
+    if (prefs.getBytesLength("budget") == sizeof(saved)) {
+        prefs.getBytes("budget", &saved, sizeof(saved));
+    }
+    prefs.end();
+    budget.restore(saved, millis(), clockNow());
+    ApiBudgetStatus s = budget.status(millis());
+    Serial.printf("API budget: %lu/%d this minute, %lu/%d today, hold %lu s\n",
+                 (unsigned long)s.minuteRemaining, API_CALLS_PER_MINUTE, (unsigned long)s.dayRemaining,
+                 API_CALLS_PER_DAY, (unsigned long)s.holdSeconds);
+}
+
+void WeatherAPI::saveBudget() {
+    ApiBudgetState state;
+    budget.save(&state, millis(), clockNow());
+    Preferences prefs;
+    prefs.begin("api", false);
+    prefs.putBytes("budget", &state, sizeof(state));
+    prefs.end();
+}
+
+uint32_t WeatherAPI::budgetWaitMs() {
+    uint32_t wait = budget.waitMs(API_REQUEST_CURRENT, millis());
+    if (wait > 0) {
+        budget.defer();
+    }
+    return wait;
+}
+
+ApiBudgetStatus WeatherAPI::budgetStatus() {
+    return budget.status(millis());
+}
+
+bool WeatherAPI::getData(const WeatherConfig& config, WeatherData& weatherData, DisplayState& displayState) {
+    uint32_t start = millis();
+    if (!budget.acquire(API_REQUEST_CURRENT, start)) {
+        // Callers check budgetWaitMs() first; this only catches one that didn't
+        ErrorHandler::handleError(ErrorHandler::HTTP_ERROR, "API request budget exhausted");
+        lastFetchMs = 0;
+        lastDnsMs = 0;
+        return false;
+    }
+    saveBudget();   // Before sending, so a crash mid-fetch still counts the request
+    trace.begin(start);
+    bool ok = fetch(config, weatherData, displayState);
+    uint32_t end = millis();
+    lastFetchMs = end - start;
+    stats.record(trace.finish(end));
+    return ok;
+}
+
+void WeatherAPI::fetchFailed(ErrorHandler::ErrorType type, const char* message, int code) {
+    ErrorHandler::handleError(type, message, code);
+    trace.fail(type);
+}
+
+bool WeatherAPI::fetch(const WeatherConfig& config, WeatherData& weatherData, DisplayState& displayState) {
+    StallScope stallScope(STALL_REGION_FETCH);
+    AllocScope allocScope(ALLOC_TAG_NETWORK);
     Serial.printf("=== FETCHING WEATHER DATA [%lu ms] ===\n", millis());
     Serial.printf("API URL: %s\n", OPENWEATHERMAP_API_ENDPOINT);
     
     // Use full API endpoint from secrets.h
     const char* apiUrl = OPENWEATHERMAP_API_ENDPOINT;
     
+    lastDnsMs = 0;
+    if (endpoint.host[0] == '\0') {
+        fetchFailed(ErrorHandler::NETWORK_ERROR, "Invalid API URL");
+        displayState.isConnected = false;
+        return false;
+    }
+    
+    // Resolve through the DNS cache and connect here; HTTPClient reuses a connected client
+    IPAddress address;
+    bool resolved = DnsResolver::resolve(endpoint.host, &address, &lastDnsMs);
+    trace.endPhase(FETCH_PHASE_DNS, millis());
+    if (!resolved) {
+        fetchFailed(ErrorHandler::NETWORK_ERROR, "DNS lookup failed");
+        displayState.isConnected = false;
+        Serial.println("=== API FETCH FAILED ===");
+        return false;
+    }
+    
+    WiFiClientSecure secureClient;
+    WiFiClient plainClient;
+    bool connected;
+    if (endpoint.secure) {
+        secureClient.setInsecure();  // What HTTPClient does for https without a CA certificate
+        connected = secureClient.connect(address, endpoint.port, endpoint.host, nullptr, nullptr, nullptr);
+    } else {
+        connected = plainClient.connect(address, endpoint.port);
+    }
+    // WiFiClientSecure connects and handshakes in one call, so https time is all "tls"
+    trace.endPhase(endpoint.secure ? FETCH_PHASE_TLS : FETCH_PHASE_CONNECT, millis());
+    if (!connected) {
+        fetchFailed(ErrorHandler::NETWORK_ERROR, "Connection to API failed");
+        displayState.isConnected = false;
+        Serial.println("=== API FETCH FAILED ===");
+        return false;
+    }
+    
     HTTPClient http;
-    http.begin(apiUrl);
+    http.begin(endpoint.secure ? static_cast<WiFiClient&>(secureClient) : plainClient, apiUrl);
     http.setTimeout(10000);  // 10 second timeout
     
+    static const char* RESPONSE_HEADERS[] = {"Retry-After"};
+    http.collectHeaders(RESPONSE_HEADERS, 1);
+    
     Serial.println("Fetching weather data from API...");
     int httpResponseCode = http.GET();
+    trace.endPhase(FETCH_PHASE_TTFB, millis());
+    trace.setStatus(httpResponseCode);
     
-    if (httpResponseCode > 0) {
+    uint32_t retryAfter = parseRetryAfter(http.header("Retry-After").c_str(), clockNow());
+    if (budget.onResponse(httpResponseCode, retryAfter, millis())) {
+        ApiBudgetStatus s = budget.status(millis());
+        Serial.printf("API throttled (%d), holding requests for %lu s\n", httpResponseCode,
+                     (unsigned long)s.holdSeconds);
+        saveBudget();
+    }
+    
+    if (httpResponseCode > 0 && httpResponseCode != HTTP_CODE_OK) {
+        fetchFailed(ErrorHandler::HTTP_ERROR, "Unexpected HTTP status", httpResponseCode);
+    } else if (httpResponseCode > 0) {
         // Use more memory-efficient approach than String
         int payloadSize = http.getSize();
         if (payloadSize > 2048) {
-            Serial.println("Response too large");
+            fetchFailed(ErrorHandler::HTTP_ERROR, "Response too large", payloadSize);
             http.end();
             return false;
         }
@@ -82,70 +214,63 @@ bool WeatherAPI::getData(WeatherData& weatherData, DisplayState& displayState) {
         // Read directly into char buffer to avoid String heap allocation
         char payload[2048];
         WiFiClient* stream = http.getStreamPtr();
-        int bytesRead = stream->readBytes(payload, min(payloadSize, (int)sizeof(payload) - 1));
+        // No Content-Length: read what fits, until the server closes or the timeout
+        int wanted = payloadSize >= 0 ? min(payloadSize, (int)sizeof(payload) - 1) : (int)sizeof(payload) - 1;
+        int bytesRead = stream->readBytes(payload, wanted);
         payload[bytesRead] = '\0';
+        trace.endPhase(FETCH_PHASE_BODY, millis());
+        trace.addBytes(bytesRead);
         
         Serial.println("API response received successfully");
         
         // Parse JSON response with error handling
-        JsonDocument doc;
+        JsonDocument doc(TrackingJsonAllocator::instance());
         DeserializationError error = deserializeJson(doc, payload);
         
         if (!error) {
             // Validate required fields exist
-            if (!doc["main"]["temp"] || !doc["weather"][0]["description"]) {
-                Serial.println("Missing required fields in API response");
+            if (!doc["main"]["temp"] || !doc["weather"][0]["id"]) {
+                trace.endPhase(FETCH_PHASE_PARSE, millis());
+                fetchFailed(ErrorHandler::JSON_ERROR, "Missing required fields in API response");
                 http.end();
                 return false;
             }
             
-            // Extract and validate data
-            weatherData.temperature = doc["main"]["temp"];
-            weatherData.feelsLike = doc["main"]["feels_like"];
-            weatherData.humidity = doc["main"]["humidity"];
-            weatherData.pressure = doc["main"]["pressure"];
-            weatherData.windSpeed = doc["wind"]["speed"];
-            weatherData.cloudCoverage = doc["clouds"]["all"];
-            weatherData.visibility = doc["visibility"];
-            
-            // Convert units
-            weatherData.visibility = weatherData.visibility / 1000.0;  // Convert to km
-            weatherData.windSpeed = weatherData.windSpeed * 3.6;       // Convert to km/h
-            
-            // Copy description safely
-            const char* desc = doc["weather"][0]["description"];
-            strncpy(weatherData.description, desc, sizeof(weatherData.description) - 1);
-            weatherData.description[sizeof(weatherData.description) - 1] = '\0';
-            
-            // Set last updated to current local time when API fetch happened
-            time_t now = time(nullptr);
-            struct tm* timeinfo = localtime(&now);
-            if (timeinfo != nullptr) {
-                strftime(weatherData.lastUpdated, sizeof(weatherData.lastUpdated), "%H:%M:%S", timeinfo);
-            } else {
-                strcpy(weatherData.lastUpdated, "12:00:00");
-            }
-            
-            // Extract weather icon code
-            const char* icon = doc["weather"][0]["icon"];
-            if (icon) {
-                strncpy(weatherData.weatherIcon, icon, sizeof(weatherData.weatherIcon) - 1);
-                weatherData.weatherIcon[sizeof(weatherData.weatherIcon) - 1] = '\0';
-            }
-            
-            // Process sunrise/sunset times
-            long sunrise = doc["sys"]["sunrise"];
-            long sunset = doc["sys"]["sunset"];
-            formatEpochToLocal(sunrise, weatherData.sunriseTime, sizeof(weatherData.sunriseTime), "%H:%M:%S");
-            formatEpochToLocal(sunset, weatherData.sunsetTime, sizeof(weatherData.sunsetTime), "%H:%M:%S");
+            // Extract into fixed-point fields, converting API units to display units on the way in
+            const UnitProfile& units = *config.unitProfile;
+            ApiUnits api = config.apiUnits;
+            weatherData.temperature = units.temperature(apiTemperatureToCelsius(doc["main"]["temp"].as<float>(), api));
+            weatherData.feelsLike = units.temperature(apiTemperatureToCelsius(doc["main"]["feels_like"].as<float>(), api));
+            weatherData.minTemp = units.temperature(apiTemperatureToCelsius(doc["main"]["temp_min"].as<float>(), api));
+            weatherData.maxTemp = units.temperature(apiTemperatureToCelsius(doc["main"]["temp_max"].as<float>(), api));
+            weatherData.humidity = doc["main"]["humidity"].as<uint8_t>();
+            weatherData.pressure = doc["main"]["pressure"].as<uint16_t>();
+            weatherData.windSpeed = units.wind(apiWindToMps(doc["wind"]["speed"].as<float>(), api));
+            weatherData.cloudCoverage = doc["clouds"]["all"].as<uint8_t>();
+            weatherData.visibility = units.visibility(doc["visibility"].as<int32_t>());  // Always meters
+            weatherData.conditionId = doc["weather"][0]["id"].as<uint16_t>();
+            weatherData.icon = parseWeatherIcon(doc["weather"][0]["icon"]);
+            weatherData.sunrise = doc["sys"]["sunrise"].as<uint32_t>();
+            weatherData.sunset = doc["sys"]["sunset"].as<uint32_t>();
+            weatherData.lastUpdated = (uint32_t)time(nullptr);
+            weatherData.latitude = (int32_t)lroundf(doc["coord"]["lat"].as<float>() * 10000.0f);
+            weatherData.longitude = (int32_t)lroundf(doc["coord"]["lon"].as<float>() * 10000.0f);
+            trace.endPhase(FETCH_PHASE_PARSE, millis());
             
             // Simple API data output
+            char temp[8], feels[8], wind[8], vis[8], updated[12];
+            formatFixed(temp, sizeof(temp), weatherData.temperature, TEMP_SCALE, 1);
+            formatFixed(feels, sizeof(feels), weatherData.feelsLike, TEMP_SCALE, 1);
+            formatFixed(wind, sizeof(wind), weatherData.windSpeed, WIND_SCALE, 1);
+            formatFixed(vis, sizeof(vis), weatherData.visibility, VISIBILITY_SCALE, 1);
+            formatLocalTime(weatherData.lastUpdated, updated, sizeof(updated));
             Serial.println("API VALUES:");
-            Serial.printf("Temp: %.1f°C | Feels: %.1f°C | Humidity: %.0f%% | Pressure: %.0f hPa\n", 
-                         weatherData.temperature, weatherData.feelsLike, weatherData.humidity, weatherData.pressure);
-            Serial.printf("Wind: %.1f km/h | Clouds: %.0f%% | Visibility: %.1f km | %s\n", 
-                         weatherData.windSpeed, weatherData.cloudCoverage, weatherData.visibility, weatherData.description);
-            Serial.printf("Updated: %s\n", weatherData.lastUpdated);
+            Serial.printf("Temp: %s°%s | Feels: %s°%s | Humidity: %u%% | Pressure: %u hPa\n", 
+                         temp, units.tempSymbol, feels, units.tempSymbol, weatherData.humidity, weatherData.pressure);
+            Serial.printf("Wind: %s %s | Clouds: %u%% | Visibility: %s %s | %s\n", 
+                         wind, units.windSuffix, weatherData.cloudCoverage, vis, units.distSuffix,
+                         conditionDescription(weatherData.conditionId));
+            Serial.printf("Updated: %s\n", updated);
             Serial.println("=== API FETCH SUCCESS ===");
             
             displayState.isConnected = true;
@@ -153,10 +278,11 @@ bool WeatherAPI::getData(WeatherData& weatherData, DisplayState& displayState) {
             return true;
             
         } else {
-            Serial.println("ERROR: Failed to parse JSON response");
+            trace.endPhase(FETCH_PHASE_PARSE, millis());
+            fetchFailed(ErrorHandler::JSON_ERROR, "Failed to parse JSON response");
         }
     } else {
-        Serial.printf("ERROR: HTTP request failed with code: %d\n", httpResponseCode);
+        fetchFailed(ErrorHandler::NETWORK_ERROR, "HTTP request failed", httpResponseCode);
     }
     
     http.end();
@@ -165,13 +291,40 @@ bool WeatherAPI::getData(WeatherData& weatherData, DisplayState& displayState) {
     return false;
 }
 
-void WeatherAPI::formatEpochToLocal(time_t epoch, char* out, size_t outSize, const char* fmt) {
-    // Eastern Time with DST rules (EST/EDT)
-    setenv("TZ", "EST5EDT,M3.2.0/2,M11.1.0/2", 1);
-    tzset();
+void WeatherAPI::report() {
+    if (stats.fetches() == 0) {
+        return;
+    }
+    char last[128];
+    formatFetchRecord(stats.history(stats.historyCount() - 1), last, sizeof(last));
+    Serial.printf("Fetch: %lu fetches, %lu KB, failed http=%lu json=%lu network=%lu, last: %s\n",
+                 (unsigned long)stats.fetches(), (unsigned long)(stats.bytesReceived() / 1024),
+                 (unsigned long)stats.failures(ErrorHandler::HTTP_ERROR),
+                 (unsigned long)stats.failures(ErrorHandler::JSON_ERROR),
+                 (unsigned long)stats.failures(ErrorHandler::NETWORK_ERROR), last);
+    
+    ApiBudgetStatus b = budget.status(millis());
+    Serial.printf("API budget: %lu/%d this minute, %lu/%d today, hold %lu s, granted %lu, deferred %lu, "
+                 "throttled %lu\n", (unsigned long)b.minuteRemaining, API_CALLS_PER_MINUTE,
+                 (unsigned long)b.dayRemaining, API_CALLS_PER_DAY, (unsigned long)b.holdSeconds,
+                 (unsigned long)b.granted, (unsigned long)b.deferred, (unsigned long)b.throttled);
 
-    struct tm tmLocal;
-    localtime_r(&epoch, &tmLocal);     // convert to local time
-    strftime(out, outSize, fmt, &tmLocal); // format to "HH:MM:SS EDT" by default
+    Serial.print("Fetch p50/p90/max ms:");
+    for (uint8_t p = 0; p < FETCH_PHASE_COUNT; p++) {
+        const RollingHistogram& h = stats.phase((FetchPhase)p);
+        if (h.count() > 0) {
+            Serial.printf(" %s %lu/%lu/%lu", fetchPhaseName((FetchPhase)p), (unsigned long)h.percentile(50),
+                         (unsigned long)h.percentile(90), (unsigned long)h.maxMs());
+        }
+    }
+    const RollingHistogram& total = stats.total();
+    Serial.printf(" total %lu/%lu/%lu | HTTP", (unsigned long)total.percentile(50),
+                 (unsigned long)total.percentile(90), (unsigned long)total.maxMs());
+    for (uint8_t i = 0; i < stats.statusCodes(); i++) {
+        Serial.printf(" %dx%lu", stats.statusCode(i), (unsigned long)stats.statusHits(i));
+    }
+    if (stats.otherStatusHits() > 0) {
+        Serial.printf(" otherx%lu", (unsigned long)stats.otherStatusHits());
+    }
+    Serial.println();
 }
-
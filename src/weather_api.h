@@ -8,6 +8,9 @@
 // WiFiManager removed - using direct WiFi connection
 #include "config.h"
 #include "weather_data.h"
+#include "http_url.h"
+#include "fetch_stats.h"
+#include "api_budget.h"
 #include "secrets.h"
 
 // Forward declarations
@@ -24,8 +27,10 @@ public:
 
     static void handleError(ErrorType type, const char* message, int code = 0);
     static void clearError();
+    static uint32_t errorCount(ErrorType type) { return counts[type]; }
 
 private:
+    static uint32_t counts[TIME_SYNC_ERROR + 1];   // Since boot, for /metrics
     static const char* getErrorTypeName(ErrorType type);
 };
 
@@ -35,13 +40,35 @@ public:
 
     // connectWiFi() removed - WiFi connection now handled in main.cpp
     bool setTime();
-    bool getData(WeatherData& weatherData, DisplayState& displayState);
+    bool getData(const WeatherConfig& config, WeatherData& weatherData, DisplayState& displayState);
+    uint32_t lastFetchMillis() const { return lastFetchMs; }
+    uint32_t lastDnsMillis() const { return lastDnsMs; }   // Part of lastFetchMillis(), 0 from the cache
+
+    // Host of OPENWEATHERMAP_API_ENDPOINT, for DnsResolver::prefetch()
+    const char* apiHost() const { return endpoint.host; }
+
+    // Request budget (api_budget.h), restored from NVS; call once the clock is set
+    static void beginBudget();
+    // 0 when a fetch may go now, else how long to postpone it (counted as deferred)
+    static uint32_t budgetWaitMs();
+    static ApiBudgetStatus budgetStatus();
+
+    // Perf report section: phase percentiles, failures, the budget and the last fetch
+    static void report();
 
 private:
     ESP32Time& rtc; // Reference to the global ESP32Time object
+    HttpUrl endpoint;      // OPENWEATHERMAP_API_ENDPOINT, split once
+    uint32_t lastFetchMs;  // Duration of the last getData(), success or not
+    uint32_t lastDnsMs;
+    FetchTrace trace;      // Fetch in progress
+    static FetchStats stats;
+    static ApiBudget budget;
+    
+    static void saveBudget();
 
-    // Helper functions
-    void formatEpochToLocal(time_t epoch, char* out, size_t outSize, const char* fmt = "%H:%M");
+    bool fetch(const WeatherConfig& config, WeatherData& weatherData, DisplayState& displayState);
+    void fetchFailed(ErrorHandler::ErrorType type, const char* message, int code = 0);
 };
 
 #endif // WEATHER_API_H
@@ -0,0 +1,143 @@
+#include "weather_conditions.h"
+
+struct ConditionEntry {
+    uint16_t id;
+    const char* description;
+};
+
+// Sorted by id for binary search - OWM's English descriptions
+static const ConditionEntry CONDITIONS[] = {
+    {200, "thunderstorm with light rain"},
+    {201, "thunderstorm with rain"},
+    {202, "thunderstorm with heavy rain"},
+    {210, "light thunderstorm"},
+    {211, "thunderstorm"},
+    {212, "heavy thunderstorm"},
+    {221, "ragged thunderstorm"},
+    {230, "thunderstorm with light drizzle"},
+    {231, "thunderstorm with drizzle"},
+    {232, "thunderstorm with heavy drizzle"},
+    {300, "light intensity drizzle"},
+    {301, "drizzle"},
+    {302, "heavy intensity drizzle"},
+    {310, "light intensity drizzle rain"},
+    {311, "drizzle rain"},
+    {312, "heavy intensity drizzle rain"},
+    {313, "shower rain and drizzle"},
+    {314, "heavy shower rain and drizzle"},
+    {321, "shower drizzle"},
+    {500, "light rain"},
+    {501, "moderate rain"},
+    {502, "heavy intensity rain"},
+    {503, "very heavy rain"},
+    {504, "extreme rain"},
+    {511, "freezing rain"},
+    {520, "light intensity shower rain"},
+    {521, "shower rain"},
+    {522, "heavy intensity shower rain"},
+    {531, "ragged shower rain"},
+    {600, "light snow"},
+    {601, "snow"},
+    {602, "heavy snow"},
+    {611, "sleet"},
+    {612, "light shower sleet"},
+    {613, "shower sleet"},
+    {615, "light rain and snow"},
+    {616, "rain and snow"},
+    {620, "light shower snow"},
+    {621, "shower snow"},
+    {622, "heavy shower snow"},
+    {701, "mist"},
+    {711, "smoke"},
+    {721, "haze"},
+    {731, "sand/dust whirls"},
+    {741, "fog"},
+    {751, "sand"},
+    {761, "dust"},
+    {762, "volcanic ash"},
+    {771, "squalls"},
+    {781, "tornado"},
+    {800, "clear sky"},
+    {801, "few clouds"},
+    {802, "scattered clouds"},
+    {803, "broken clouds"},
+    {804, "overcast clouds"},
+};
+
+static const int NUM_CONDITIONS = sizeof(CONDITIONS) / sizeof(CONDITIONS[0]);
+
+const char* conditionDescription(uint16_t conditionId) {
+    int lo = 0;
+    int hi = NUM_CONDITIONS - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (CONDITIONS[mid].id == conditionId) {
+            return CONDITIONS[mid].description;
+        }
+        if (CONDITIONS[mid].id < conditionId) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    switch (conditionId / 100) {
+        case 2: return "thunderstorm";
+        case 3: return "drizzle";
+        case 5: return "rain";
+        case 6: return "snow";
+        case 7: return "mist";
+        case 8: return conditionId == 800 ? "clear sky" : "clouds";
+        default: return "unknown";
+    }
+}
+
+bool isSevereCondition(uint16_t conditionId) {
+    if (conditionId / 100 == 2) {
+        return true;
+    }
+    switch (conditionId) {
+        case 502: case 503: case 504:  // Heavy to extreme rain
+        case 511:                      // Freezing rain
+        case 522:                      // Heavy shower rain
+        case 602: case 622:            // Heavy snow
+        case 762: case 771: case 781:  // Ash, squalls, tornado
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint8_t parseWeatherIcon(const char* code) {
+    if (code == nullptr || code[0] < '0' || code[0] > '9' || code[1] < '0' || code[1] > '9') {
+        return ICON_NONE;
+    }
+    uint8_t number = (uint8_t)((code[0] - '0') * 10 + (code[1] - '0'));
+    switch (number) {
+        case ICON_CLEAR_SKY:
+        case ICON_FEW_CLOUDS:
+        case ICON_SCATTERED_CLOUDS:
+        case ICON_BROKEN_CLOUDS:
+        case ICON_SHOWER_RAIN:
+        case ICON_RAIN:
+        case ICON_THUNDERSTORM:
+        case ICON_SNOW:
+        case ICON_MIST:
+            break;
+        default:
+            return ICON_NONE;
+    }
+    return code[2] == 'n' ? (uint8_t)(number | WEATHER_ICON_NIGHT) : number;
+}
+
+void weatherIconString(uint8_t icon, char* out) {
+    uint8_t number = WEATHER_ICON_CODE(icon);
+    if (number == ICON_NONE) {
+        out[0] = '\0';
+        return;
+    }
+    out[0] = (char)('0' + number / 10);
+    out[1] = (char)('0' + number % 10);
+    out[2] = WEATHER_ICON_IS_NIGHT(icon) ? 'n' : 'd';
+    out[3] = '\0';
+}
@@ -0,0 +1,43 @@
+#ifndef WEATHER_CONDITIONS_H
+#define WEATHER_CONDITIONS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// OpenWeatherMap condition ids and icon codes in compact form.
+// See https://openweathermap.org/weather-conditions
+
+// Icon enum - values are the OWM two-digit icon number ("10d" -> 10)
+enum WeatherIconCode : uint8_t {
+    ICON_NONE = 0,
+    ICON_CLEAR_SKY = 1,
+    ICON_FEW_CLOUDS = 2,
+    ICON_SCATTERED_CLOUDS = 3,
+    ICON_BROKEN_CLOUDS = 4,
+    ICON_SHOWER_RAIN = 9,
+    ICON_RAIN = 10,
+    ICON_THUNDERSTORM = 11,
+    ICON_SNOW = 13,
+    ICON_MIST = 50
+};
+
+// Stored icon byte: WeatherIconCode in the low bits, night variant flag on top
+#define WEATHER_ICON_NIGHT 0x80
+#define WEATHER_ICON_CODE(icon) ((uint8_t)((icon) & ~WEATHER_ICON_NIGHT))
+#define WEATHER_ICON_IS_NIGHT(icon) (((icon) & WEATHER_ICON_NIGHT) != 0)
+
+// "10n" -> ICON_RAIN | WEATHER_ICON_NIGHT; ICON_NONE for anything unrecognized
+uint8_t parseWeatherIcon(const char* code);
+
+// Inverse of parseWeatherIcon; out needs 4 bytes. Writes "" for ICON_NONE.
+void weatherIconString(uint8_t icon, char* out);
+
+// Interned description for an OWM condition id (e.g. 800 -> "clear sky").
+// Unknown ids fall back to the description of their group.
+const char* conditionDescription(uint16_t conditionId);
+
+// Conditions worth a ticker alert: thunderstorms, heavy/freezing rain,
+// heavy snow, ash, squalls and tornadoes
+bool isSevereCondition(uint16_t conditionId);
+
+#endif // WEATHER_CONDITIONS_H
@@ -1,8 +1,11 @@
 #ifndef WEATHER_DATA_H
 #define WEATHER_DATA_H
 
+#include <string.h>
 #include "config.h"
 #include "secrets.h"
+#include "weather_conditions.h"
+#include "units.h"
 
 // ==================== WEATHER CONFIGURATION STRUCTURE ====================
 struct WeatherConfig {
@@ -10,6 +13,8 @@ struct WeatherConfig {
     char city[32];
     char units[16];
     int timezone;
+    const UnitProfile* unitProfile;   // Display units, resolved once here
+    ApiUnits apiUnits;                // Units of the API response
     
     // Default constructor with secure defaults
     WeatherConfig() {
@@ -17,39 +22,44 @@ struct WeatherConfig {
         strcpy(city, OPENWEATHERMAP_CITY);       // Using city from secrets.h
         strcpy(units, OPENWEATHERMAP_UNITS);     // Using units from secrets.h
         timezone = 2;
+        apiUnits = resolveApiUnits(units);
+        unitProfile = &resolveUnitProfile(DISPLAY_UNITS[0] != '\0' ? DISPLAY_UNITS : units);
     }
 };
 
 // ==================== WEATHER DATA STRUCTURE ====================
+// Compact fixed-point layout (40 bytes, down from 692 with float fields and
+// preformatted strings). Text is produced only at the render boundary.
+// Values are in the configured display units at the scales in units.h.
+
 struct WeatherData {
-    float temperature;
-    float feelsLike;
-    float humidity;
-    float pressure;
-    float windSpeed;
-    float cloudCoverage;
-    float visibility;
-    char description[64];
-    char weatherIcon[8];  // Weather icon code (e.g., "01d", "02n")
-    char sunriseTime[16];
-    char sunsetTime[16];
-    char scrollingMessage[512];  // Increased buffer size for longer messages
-    char lastUpdated[32];       // Last updated datetime from API
-    float minTemp;
-    float maxTemp;
+    int16_t temperature;     // Degrees x TEMP_SCALE
+    int16_t feelsLike;       // Degrees x TEMP_SCALE
+    int16_t minTemp;         // Degrees x TEMP_SCALE
+    int16_t maxTemp;         // Degrees x TEMP_SCALE
+    int16_t windSpeed;       // Wind unit x WIND_SCALE
+    int16_t visibility;      // Distance unit x VISIBILITY_SCALE
+    uint16_t pressure;       // hPa
+    uint16_t conditionId;    // OWM condition id, description via conditionDescription()
+    uint8_t humidity;        // %
+    uint8_t cloudCoverage;   // %
+    uint8_t icon;            // WeatherIconCode | WEATHER_ICON_NIGHT
+    uint32_t sunrise;        // UTC epoch seconds, 0 = unknown
+    uint32_t sunset;         // UTC epoch seconds, 0 = unknown
+    uint32_t lastUpdated;    // UTC epoch of the last successful fetch, 0 = never
+    int32_t latitude;        // City coordinates from the API, 1e-4 degree
+    int32_t longitude;
     
     // Constructor with default values
-    WeatherData() : temperature(22.2), feelsLike(22.2), humidity(50), pressure(1013), 
-                   windSpeed(5.0), cloudCoverage(25), visibility(10), minTemp(-50), maxTemp(1000) {
-        strcpy(description, "clear sky");
-        strcpy(weatherIcon, "01d");  // Default clear sky day icon
-        strcpy(sunriseTime, "--:--");
-        strcpy(sunsetTime, "--:--");
-        strcpy(scrollingMessage, "Initializing weather data...");
-        strcpy(lastUpdated, "12:00:00");
+    WeatherData() : temperature(222), feelsLike(222), minTemp(-500), maxTemp(10000),
+                   windSpeed(50), visibility(100), pressure(1013), conditionId(800),
+                   humidity(50), cloudCoverage(25), icon(ICON_CLEAR_SKY),
+                   sunrise(0), sunset(0), lastUpdated(0), latitude(0), longitude(0) {
     }
 };
 
+static_assert(sizeof(WeatherData) == 40, "WeatherData layout grew; update the size noted above");
+
 // ==================== DISPLAY STATE STRUCTURE ====================
 struct DisplayState {
     int animationOffset;
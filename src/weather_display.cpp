@@ -1,10 +1,19 @@
 #include "weather_display.h"
 #include <ESP32Time.h>
+#include <WiFi.h>
+#include "heap_stats.h"
+#include "perf_report.h"
+#include "stall_monitor.h"
+#include "alloc_tracker.h"
+#include "weather_format.h"
+#include "frame_mirror.h"
+#include "status_server.h"
 
 // Initialize static variables
 char WeatherDisplay::timeBuffer[32];
 char WeatherDisplay::valueStrBuffer[32];
 char WeatherDisplay::counterStrBuffer[16];
+uint16_t WeatherDisplay::fadeBand[SPRITE_WIDTH * PAGE_FADE_BAND_ROWS];
 unsigned long WeatherDisplay::frameCount = 0;
 unsigned long WeatherDisplay::lastPerformanceReport = 0;
 unsigned long WeatherDisplay::lastFrameTime = 0;
@@ -13,32 +22,47 @@ WeatherDisplay::WeatherDisplay(ESP32Time& rtcRef) :
     tft(),
     sprite(&tft),
     errSprite(&tft),
+    stage(&tft),
     rtc(rtcRef), // Initialize the reference
     ani(ANIMATION_START_POSITION), 
     timePased(0), 
-    displayBrightness(DEFAULT_BRIGHTNESS),
     lastButtonPress(0),
-    temperature(22.2),
-    messageUpdatePending(false),
-    currentMessageWidth(0),
-    messageWidthCached(false),
+    transition(TRANSITION_NONE),
+    inTransition(false),
+    lastPageDraw(0),
+    lastFpsTenths(0),
+    lastFrameMaxMicros(0),
+    preparedId(0),
+    preparedGeneration(0),
+    iconDrawMicros(0),
+    fullRedraw(true),
+    hasShownValues(false),
+    shownIcon(ICON_NONE),
+    fadeFromIcon(ICON_NONE),
+    frameMicrosMax(0),
+    framesOverBudget(0),
+    pushedPixels(0),
     currentFont(nullptr) {
     
-    // Initialize legacy arrays with default values
-    wData1[0] = 22.2;  // feels like
-    wData1[1] = 25.0;   // cloud coverage
-    wData1[2] = 10.0;   // visibility
-    wData2[0] = 50.0;   // humidity
-    wData2[1] = 1013.0; // pressure
-    wData2[2] = 5.0;    // wind speed
-    
-    // Initialize message buffers with default weather message
-    strcpy(Wmsg, "... clear sky, visibility is 10.0km/h, wind of 5.0km/h, last updated at 12:00:00 ...");
-    strcpy(WmsgBuffer, "... clear sky, visibility is 10.0km/h, wind of 5.0km/h, last updated at 12:00:00 ...");
+    memset(shownValues, 0, sizeof(shownValues));
+    for (int i = 0; i < 2; i++) {
+        buttonDown[i] = false;
+        buttonHeld[i] = false;
+        buttonPressStart[i] = 0;
+    }
+    clockSecond = 0;
     
     setupUILabels();
     
-    // Initialize scrolling message with default weather data
+    // Compile the ticker template once; a bad override falls back to the default
+    if (!conditionsTemplate.compile(TICKER_TEMPLATE)) {
+        Serial.printf("Ticker template error at %d: %s - using default\n",
+                     conditionsTemplate.errorOffset(), conditionsTemplate.error());
+        conditionsTemplate.compile(TICKER_DEFAULT_TEMPLATE);
+    }
+    
+    // Initialize cached text and scrolling message with default weather data
+    applyWeatherUpdate();
     updateScrollingMessage();
 }
 
@@ -58,19 +82,25 @@ void WeatherDisplay::begin() {
     tft.drawString("Weather Micro Station", 30, 50, 4);
     
     // Create sprites for double buffering
-    sprite.createSprite(SPRITE_WIDTH, SPRITE_HEIGHT);
-    errSprite.createSprite(ERRSPRITE_WIDTH, ERRSPRITE_HEIGHT);
+    {
+        AllocScope allocScope(ALLOC_TAG_DISPLAY);
+        sprite.createSprite(SPRITE_WIDTH, SPRITE_HEIGHT);
+        errSprite.createSprite(ERRSPRITE_WIDTH, ERRSPRITE_HEIGHT);
+        // Second full-screen buffer for page transitions; without it pages cut instead
+        if (stage.createSprite(SPRITE_WIDTH, SPRITE_HEIGHT) == nullptr) {
+            Serial.println("Page transition buffer unavailable - pages will switch without animation");
+        }
+    }
     
-    // Configure display backlight
-    ledcSetup(0, 10000, 8);
-    ledcAttachPin(BACKLIGHT_PIN, 0);
-    ledcWrite(0, DEFAULT_BRIGHTNESS);
+    // Configure display backlight (hardware fade + saved levels)
+    backlight.begin();
+    solar.begin();
     
     // Generate grayscale palette
     generateGrayscalePalette();
     
-    // Initialize scrolling message with default weather data
-    updateScrollingMessage();
+    // Show the default weather message (needs the sprite font for its width)
+    updateScrollingBuffer();
     
     // Initialize brightness control buttons
     initializeBrightnessControl();
@@ -89,9 +119,15 @@ void WeatherDisplay::setupUILabels() {
     PPlbl1[1] = "CLOUDS";
     PPlbl1[2] = "VISIBIL.";
     
-    PPlblU1[0] = " °C";
+    // Unit suffixes come from the profile resolved at config load
+    const UnitProfile& units = *config.unitProfile;
+    snprintf(tempUnitLabel, sizeof(tempUnitLabel), " °%s", units.tempSymbol);
+    snprintf(distUnitLabel, sizeof(distUnitLabel), " %s", units.distSuffix);
+    snprintf(windUnitLabel, sizeof(windUnitLabel), " %s", units.windSuffix);
+    
+    PPlblU1[0] = tempUnitLabel;
     PPlblU1[1] = " %";
-    PPlblU1[2] = " km";
+    PPlblU1[2] = distUnitLabel;
     
     PPlbl2[0] = "HUMIDITY";
     PPlbl2[1] = "PRESSURE";
@@ -99,7 +135,7 @@ void WeatherDisplay::setupUILabels() {
     
     PPlblU2[0] = " %";
     PPlblU2[1] = " hPa";
-    PPlblU2[2] = " km/h";
+    PPlblU2[2] = windUnitLabel;
 }
 
 void WeatherDisplay::initializeBrightnessControl() {
@@ -107,63 +143,88 @@ void WeatherDisplay::initializeBrightnessControl() {
     pinMode(BUTTON_BOOT, INPUT_PULLUP);
     pinMode(BUTTON_KEY, INPUT_PULLUP);
     
-    displayBrightness = DEFAULT_BRIGHTNESS;
-    
-    Serial.printf("Brightness control initialized. Default brightness: %d\n", displayBrightness);
-    Serial.println("Use Key button (GPIO14, top) to increase brightness, Boot button (GPIO0, bottom) to decrease");
+    Serial.printf("Brightness control initialized. Current brightness: %d\n", backlight.getLevel());
+    Serial.println("Click Key (GPIO14, top) / Boot (GPIO0, bottom) to change page; hold to raise / lower brightness");
 }
 
-void WeatherDisplay::handleBrightnessButtons() {
+void WeatherDisplay::handleButtons() {
     unsigned long currentTime = millis();
+    static const uint8_t pins[2] = {BUTTON_KEY, BUTTON_BOOT};
     
-    // Check if enough time has passed since last button press (debouncing)
-    if (currentTime - lastButtonPress < BUTTON_DEBOUNCE_MS) {
-        return;
-    }
-    
-    bool buttonPressed = false;
-    
-    // Key button (GPIO14) - Increase brightness (top button)
-    if (digitalRead(BUTTON_KEY) == LOW) {
-        if (displayBrightness < 255) {
-            displayBrightness = min(displayBrightness + BRIGHTNESS_STEP, 255);
-            ledcWrite(0, displayBrightness);  // Use existing PWM channel 0
-            Serial.printf("Brightness increased to: %d/255\n", displayBrightness);
-            buttonPressed = true;
+    for (int i = 0; i < 2; i++) {
+        bool down = digitalRead(pins[i]) == LOW;
+        if (down && !buttonDown[i]) {
+            buttonPressStart[i] = currentTime;
+            buttonHeld[i] = false;
         }
-    }
-    
-    // Boot button (GPIO0) - Decrease brightness (bottom button)
-    if (digitalRead(BUTTON_BOOT) == LOW) {
-        if (displayBrightness > 10) {  // Keep minimum brightness at 10 so display stays visible
-            displayBrightness = max(displayBrightness - BRIGHTNESS_STEP, 10);
-            ledcWrite(0, displayBrightness);  // Use existing PWM channel 0
-            Serial.printf("Brightness decreased to: %d/255\n", displayBrightness);
-            buttonPressed = true;
+        
+        // Held - step brightness every BUTTON_DEBOUNCE_MS; top raises, bottom lowers
+        if (down && currentTime - buttonPressStart[i] >= BUTTON_HOLD_MS &&
+            currentTime - lastButtonPress >= BUTTON_DEBOUNCE_MS) {
+            buttonHeld[i] = true;
+            lastButtonPress = currentTime;
+            if (i == 0 && backlight.getLevel() < 255) {
+                backlight.adjust(BRIGHTNESS_STEP);  // Faded by the LEDC hardware, saved after a short delay
+                Serial.printf("Brightness increased to: %d/255\n", backlight.getLevel());
+            } else if (i == 1 && backlight.getLevel() > BACKLIGHT_MIN_LEVEL) {  // Keep display visible
+                backlight.adjust(-BRIGHTNESS_STEP);
+                Serial.printf("Brightness decreased to: %d/255\n", backlight.getLevel());
+            }
         }
+        
+        // Released before the hold threshold - a click
+        if (!down && buttonDown[i] && !buttonHeld[i] &&
+            currentTime - buttonPressStart[i] >= BUTTON_CLICK_MIN_MS && !inTransition) {
+            showPage(pages.neighbor(i == 0 ? 1 : -1), i == 0 ? TRANSITION_SLIDE_LEFT : TRANSITION_SLIDE_RIGHT);
+        }
+        buttonDown[i] = down;
     }
     
-    if (buttonPressed) {
-        lastButtonPress = currentTime;
+    // Timed rotation, or back to current conditions when left alone
+    uint8_t due = pages.due(currentTime);
+    if (due < PAGE_COUNT && !inTransition) {
+        showPage(due, TRANSITION_FADE);
     }
 }
 
-void WeatherDisplay::updateLegacyArrays() {
-    // Update legacy arrays for compatibility
-    wData1[0] = weatherData.feelsLike;
-    wData1[1] = weatherData.cloudCoverage;
-    wData1[2] = weatherData.visibility;
-    wData2[0] = weatherData.humidity;
-    wData2[1] = weatherData.pressure;
-    wData2[2] = weatherData.windSpeed;
-
-    // Update legacy variables
-    temperature = weatherData.temperature;
+void WeatherDisplay::updateBacklight() {
+    uint32_t now = (uint32_t)time(nullptr);
+    if (solar.service(now)) {
+        applyWeatherUpdate();  // New day - refresh the sunrise/sunset text
+    }
     
+    // Follow the sunrise/sunset dimming curve, preferring the locally computed times
+    if (solar.valid()) {
+        backlight.service(now, solar.times().sunrise, solar.times().sunset);
+    } else {
+        backlight.service(now, weatherData.sunrise, weatherData.sunset);
+    }
 }
 
-void WeatherDisplay::updateLegacyData() {
-    updateLegacyArrays();
+void WeatherDisplay::applyWeatherUpdate() {
+    // Times only change per fetch (or day) - format them here instead of every frame
+    uint32_t sunrise = solar.valid() ? solar.times().sunrise : weatherData.sunrise;
+    uint32_t sunset = solar.valid() ? solar.times().sunset : weatherData.sunset;
+    formatLocalTime(sunrise, sunriseText, sizeof(sunriseText));
+    formatLocalTime(sunset, sunsetText, sizeof(sunsetText));
+    formatLocalTime(weatherData.lastUpdated, updatedText, sizeof(updatedText));
+    fullRedraw = true;
+}
+
+void WeatherDisplay::animateValues() {
+    // Count displayed values from where they are now to the new data
+    uint32_t now = millis();
+    for (int i = 0; i < 7; i++) {
+        uint8_t channel = (uint8_t)(TWEEN_CH_TEMP + i);   // Temperature, then BOX0..BOX5
+        int32_t target = i == 0 ? weatherData.temperature : boxValue(i - 1);
+        if (hasShownValues && target != shownValues[i]) {
+            uint32_t region = REGION_BIT(i == 0 ? REGION_TEMP : REGION_BOX0 + i - 1);
+            animator.start(channel, animator.value(channel, shownValues[i]), target, now,
+                           TWEEN_VALUE_MS, EASE_OUT_CUBIC, region);
+        }
+        shownValues[i] = target;
+    }
+    hasShownValues = true;
 }
 
 // Performance optimization: Font management
@@ -185,24 +246,102 @@ void WeatherDisplay::unloadFontOnce() {
 }
 
 void WeatherDisplay::updateScrollingMessage() {
-    // Create scrolling message in your requested format: "... description, visibility is (value)km/h, wind of (value)km/h, last updated at (time) ..."
-    snprintf(weatherData.scrollingMessage, sizeof(weatherData.scrollingMessage),
-            "... %s, visibility is %.1fkm/h, wind of %.1fkm/h, last updated at %s ...",
-            weatherData.description, weatherData.visibility, weatherData.windSpeed, weatherData.lastUpdated);
+    // Post every content source; the queue decides what scrolls next
+    uint32_t now = millis();
+    char text[TICKER_QUEUE_TEXT_SIZE];
+    
+    char* conditions = tickerQueue.reserve(TICKER_SOURCE_CONDITIONS, TICKER_PRIORITY_INFO, 0, 1, now);
+    if (conditions != nullptr) {
+        const UnitProfile& units = *config.unitProfile;
+        TickerTextFields fields = {updatedText, sunriseText, sunsetText,
+                                   units.tempSymbol, units.windSuffix, units.distSuffix};
+        conditionsTemplate.render(weatherData, fields, conditions, TICKER_QUEUE_TEXT_SIZE);
+        Serial.printf("Scrolling: %s\n", conditions);
+    }
     
-    Serial.printf("Scrolling: %s\n", weatherData.scrollingMessage);
+    if (formatWeatherAlert(weatherData, text, sizeof(text))) {
+        tickerQueue.post(TICKER_SOURCE_ALERT_WEATHER, TICKER_PRIORITY_ALERT, text,
+                         TICKER_ALERT_TTL_MS, TICKER_ALERT_REPEATS, now);
+    } else {
+        tickerQueue.clear(TICKER_SOURCE_ALERT_WEATHER);
+    }
+    if (formatWindAlert(weatherData, *config.unitProfile, text, sizeof(text))) {
+        tickerQueue.post(TICKER_SOURCE_ALERT_WIND, TICKER_PRIORITY_ALERT, text,
+                         TICKER_ALERT_TTL_MS, TICKER_ALERT_REPEATS, now);
+    } else {
+        tickerQueue.clear(TICKER_SOURCE_ALERT_WIND);
+    }
     
+    if (weatherData.lastUpdated != 0) {  // Defaults carry no meaningful range
+        formatForecastSummary(weatherData, *config.unitProfile, text, sizeof(text));
+        tickerQueue.post(TICKER_SOURCE_FORECAST, TICKER_PRIORITY_INFO, text, 0, 1, now);
+    }
     
-    strcpy(WmsgBuffer, weatherData.scrollingMessage);
-    messageUpdatePending = true;  // Mark that new message is ready
+    if (dailyStats.fetches > 0) {
+        formatDailyStats(dailyStats, *config.unitProfile, text, sizeof(text));
+        tickerQueue.post(TICKER_SOURCE_STATS, TICKER_PRIORITY_INFO, text, 0, 1, now);
+    }
+}
+
+void WeatherDisplay::recordFetch(bool success) {
+    dailyStats.record(localDayNumber((uint32_t)time(nullptr)), success, weatherData.temperature);
+    
+    if (success) {
+        solar.setLocation(weatherData.latitude, weatherData.longitude);
+        solar.service((uint32_t)time(nullptr));
+        animateValues();
+        history.record(weatherData.lastUpdated != 0 ? weatherData.lastUpdated : (uint32_t)time(nullptr),
+                       weatherData.temperature);
+        StatusServer::publishWeather(weatherData, history, *config.unitProfile);
+        applyWeatherUpdate();
+        tickerQueue.clear(TICKER_SOURCE_STATUS);
+        updateScrollingMessage();
+    } else {
+        char text[TICKER_QUEUE_TEXT_SIZE];
+        formatConnectionStatus(updatedText, text, sizeof(text));
+        tickerQueue.post(TICKER_SOURCE_STATUS, TICKER_PRIORITY_STATUS, text, 0, 1, millis());
+        formatDailyStats(dailyStats, *config.unitProfile, text, sizeof(text));
+        tickerQueue.post(TICKER_SOURCE_STATS, TICKER_PRIORITY_INFO, text, 0, 1, millis());
+    }
+}
+
+void WeatherDisplay::showStatusMessage(const char* message) {
+    tickerQueue.post(TICKER_SOURCE_STATUS, TICKER_PRIORITY_STATUS, message, 0, 1, millis());
+    updateScrollingBuffer();
+}
+
+void WeatherDisplay::prepareTicker(bool force) {
+    // The back slot is still current unless the queue changed since it was filled
+    if (!force && ticker.pending() && tickerQueue.generation() == preparedGeneration) {
+        return;
+    }
+    const TickerMessage* next = tickerQueue.pick(millis());
+    preparedGeneration = tickerQueue.generation();
+    if (next == nullptr) {
+        return;
+    }
+    
+    // Copy and measure here so the swap at the wrap point is only an index flip
+    char* out = ticker.beginWrite();
+    size_t length = strnlen(next->text, ticker.capacity() - 1);
+    memcpy(out, next->text, length);
+    out[length] = '\0';
+    ticker.commit(length, errSprite.textWidth(out));
+    preparedId = next->id;
+}
+
+void WeatherDisplay::serviceTicker() {
+    prepareTicker(false);
 }
 
 void WeatherDisplay::updateScrollingBuffer() {
-    // Immediately update the display buffers with current scrolling message
-    strcpy(Wmsg, weatherData.scrollingMessage);
-    strcpy(WmsgBuffer, weatherData.scrollingMessage);
-    messageUpdatePending = true;
-    messageWidthCached = false; // Force recalculation of message width
+    // Immediately show the best message instead of waiting for the scroll to wrap
+    prepareTicker(true);
+    if (ticker.swap()) {
+        tickerQueue.markShown(preparedId);
+        animator.start(TWEEN_CH_TICKER, ERRSPRITE_HEIGHT, 0, millis(), TWEEN_TICKER_MS,
+                       EASE_IN_OUT_QUAD, REGION_BIT(REGION_TICKER));
+    }
 }
 
 void WeatherDisplay::updateData() {
@@ -218,36 +357,47 @@ void WeatherDisplay::updateData() {
         ani = ANIMATION_START_POSITION;
         
         // Apply pending message update AFTER position reset for smoother transition
-        if (messageUpdatePending) {
-            strcpy(Wmsg, WmsgBuffer);
-            messageUpdatePending = false;
-            currentMessageWidth = 0;  // Reset width so it gets recalculated in next draw()
-            messageWidthCached = false;  // Mark width as needing recalculation
-            Serial.printf("Scrolling message updated at animation restart: %s\n", Wmsg);
+        if (ticker.swap()) {
+            tickerQueue.markShown(preparedId);
+            animator.start(TWEEN_CH_TICKER, ERRSPRITE_HEIGHT, 0, millis(), TWEEN_TICKER_MS,
+                           EASE_IN_OUT_QUAD, REGION_BIT(REGION_TICKER));
+            Serial.printf("Scrolling message updated at animation restart: %s\n", ticker.front());
         }
     }
 }
 
-void WeatherDisplay::drawWeatherIcon(int x, int y, const char* iconCode) {
-    const WeatherIcon* icon = getWeatherIcon(iconCode);
-    if (icon != nullptr) {
-        // Draw the icon pixel by pixel
-        for (int py = 0; py < icon->height; py++) {
-            for (int px = 0; px < icon->width; px++) {
-                int pixelIndex = py * icon->width + px;
-                uint16_t color = pgm_read_word(&icon->data[pixelIndex]);
-                
-                // Only draw non-black pixels (skip transparent areas)
-                if (color != 0x0000) {
-                    sprite.drawPixel(x + px, y + py, color);
-                }
-            }
-        }
+const IconImage* WeatherDisplay::iconImage(uint8_t iconByte, uint8_t size) {
+    const WeatherIcon* icon = getWeatherIcon(WEATHER_ICON_CODE(iconByte), WEATHER_ICON_IS_NIGHT(iconByte));
+    if (icon == nullptr) {
+        return nullptr;
+    }
+
+    uint32_t misses = iconCache.misses();
+    unsigned long start = micros();
+    const IconImage* image = iconCache.get(icon->alpha, icon->size, icon->color, size);
+    if (image != nullptr && iconCache.misses() != misses) {
+        Serial.printf("Icon scaled %u->%u px in %lu us (cache %u bytes)\n",
+                      icon->size, size, micros() - start, (unsigned)IconCache::memoryBytes());
     }
+    return image;
+}
+
+void WeatherDisplay::drawWeatherIcon(int x, int y, uint8_t iconByte, uint8_t size, uint16_t background) {
+    uint16_t* fb = (uint16_t*)sprite.getPointer();
+    const IconImage* image = iconImage(iconByte, size);
+    if (image == nullptr || fb == nullptr) {
+        return;
+    }
+
+    // 16-bit sprites hold byte-swapped colors
+    unsigned long start = micros();
+    blitIcon(fb, SPRITE_WIDTH, SPRITE_HEIGHT, x, y, *image, background, true);
+    iconDrawMicros = micros() - start;
 }
 
 void WeatherDisplay::drawLeftPanel() {
     // Header
+    sprite.setTextDatum(0);
     sprite.loadFont(midleFont);
     sprite.setTextColor(grays[1], TFT_BLACK);
     sprite.drawString("WEATHER", 6, 10);
@@ -261,28 +411,36 @@ void WeatherDisplay::drawLeftPanel() {
     sprite.drawString(config.city, 48, 110);
     sprite.unloadFont();
     
-    // Main temperature display
+    drawTemperature();
+    drawClock();
+    
+    // Icon placeholder area - keeping your original "ICON HERE" text
+    sprite.setTextDatum(0);
+    sprite.setTextColor(grays[5], TFT_BLACK);
+    sprite.drawString("MICRO", 88, 10);
+    sprite.drawString("STATION", 88, 20);
+}
+
+void WeatherDisplay::drawTemperature() {
+    // Main temperature display - counts up to a new value after a fetch
     sprite.setTextDatum(4);  // Center alignment for temperature
     sprite.loadFont(bigFont);
     sprite.setTextColor(grays[0], TFT_BLACK);
-    sprite.drawFloat(weatherData.temperature, 1, 50, 80);
+    formatFixed(valueStrBuffer, sizeof(valueStrBuffer),
+                animator.value(TWEEN_CH_TEMP, weatherData.temperature), TEMP_SCALE, 1);
+    sprite.drawString(valueStrBuffer, 50, 80);
     sprite.unloadFont();
     
     // Temperature unit indicator
     sprite.loadFont(font18);
     sprite.setTextColor(grays[2], TFT_BLACK);
-    if (strcmp(config.units, "metric") == 0) {
-        sprite.drawString("C", 112, 55);
-        sprite.fillCircle(103, 50, 2, grays[2]);  // Degree symbol
-    } else {
-        sprite.drawString("F", 112, 49);
-        sprite.fillCircle(103, 50, 2, grays[2]);  // Degree symbol
-    }
+    sprite.drawString(config.unitProfile->tempSymbol, 112, config.unitProfile->tempSymbolY);
+    sprite.fillCircle(103, 50, 2, grays[2]);  // Degree symbol
     sprite.unloadFont();
-    
-    // Time display - memory efficient implementation using static buffer
-    strcpy(timeBuffer, rtc.getTime().c_str());
-    
+}
+
+void WeatherDisplay::drawClock() {
+    // timeBuffer holds rtc.getTime(), refreshed by draw()
     // Extract hours:minutes (first 5 characters)
     char timeHM[6];
     strncpy(timeHM, timeBuffer, 5);
@@ -312,14 +470,17 @@ void WeatherDisplay::drawLeftPanel() {
     sprite.setTextDatum(0);
     sprite.setTextColor(grays[5], TFT_BLACK);
     sprite.drawString("SECONDS", 91, 157);
-    
-    // Icon placeholder area - keeping your original "ICON HERE" text
-    sprite.setTextColor(grays[5], TFT_BLACK);
-    sprite.drawString("MICRO", 88, 10);
-    sprite.drawString("STATION", 88, 20);
 }
 
 void WeatherDisplay::drawRightPanel() {
+    drawSunAndIcon();
+    for (int i = 0; i < 6; i++) {
+        drawValueBox(i);
+    }
+    drawTickerArea();
+}
+
+void WeatherDisplay::drawSunAndIcon() {
     // Sunrise and sunset information
     sprite.setTextDatum(0);  // Left alignment
     sprite.loadFont(font18);
@@ -328,48 +489,61 @@ void WeatherDisplay::drawRightPanel() {
     sprite.drawString("sunset:", 144, 28);
     
     sprite.setTextColor(grays[3], TFT_BLACK);
-    sprite.drawString(weatherData.sunriseTime, 210, 12);
-    sprite.drawString(weatherData.sunsetTime, 210, 30);
+    sprite.drawString(sunriseText, 210, 12);
+    sprite.drawString(sunsetText, 210, 30);
     sprite.unloadFont();
     
-    // Draw weather icon next to sunrise/sunset times
-    if (strlen(weatherData.weatherIcon) > 0) {
-        drawWeatherIcon(278, 12, weatherData.weatherIcon);
+    // Weather icon next to sunrise/sunset times, cross-fading after a change
+    int32_t mix = animator.value(TWEEN_CH_ICON, 255);
+    uint16_t* fb = (uint16_t*)sprite.getPointer();
+    if (mix >= 255 || fb == nullptr) {
+        drawWeatherIcon(276, 10, shownIcon);
+        return;
     }
-    
-    // Weather data boxes - top row
-    for (int i = 0; i < 3; i++) {
-        int x = 144 + (i * 60);
-        sprite.fillSmoothRoundRect(x, 53, 54, 32, 3, grays[9], TFT_BLACK);
-        sprite.setTextDatum(4);  // Center alignment
-        sprite.setTextColor(grays[3], grays[9]);
-        sprite.drawString(PPlbl1[i], x + 27, 59);
-        sprite.setTextColor(grays[2], grays[9]);
-        sprite.loadFont(font18);
-        // Special formatting for feels like temperature (index 0) to show 1 decimal place
-        if (i == 0) {
-            snprintf(valueStrBuffer, sizeof(valueStrBuffer), "%.1f%s", wData1[i], PPlblU1[i]);
-        } else {
-            snprintf(valueStrBuffer, sizeof(valueStrBuffer), "%.0f%s", wData1[i], PPlblU1[i]);
-        }
-        sprite.drawString(valueStrBuffer, x + 27, 76);
-        sprite.unloadFont();
+    const IconImage* to = iconImage(shownIcon, ICON_DRAW_SIZE);
+    const IconImage* from = iconImage(fadeFromIcon, ICON_DRAW_SIZE);
+    if (to != nullptr) {
+        blitIconCrossFade(fb, SPRITE_WIDTH, SPRITE_HEIGHT, 276, 10, from, *to, (uint8_t)mix, TFT_BLACK, true);
+    } else if (from != nullptr) {
+        blitIconCrossFade(fb, SPRITE_WIDTH, SPRITE_HEIGHT, 276, 10, nullptr, *from, (uint8_t)(255 - mix), TFT_BLACK, true);
     }
-    
-    // Weather data boxes - bottom row
-    for (int i = 0; i < 3; i++) {
-        int x = 144 + (i * 60);
-        sprite.fillSmoothRoundRect(x, 93, 54, 32, 3, grays[9], TFT_BLACK);
-        sprite.setTextDatum(4);  // Center alignment
-        sprite.setTextColor(grays[3], grays[9]);
-        sprite.drawString(PPlbl2[i], x + 27, 99);
-        sprite.setTextColor(grays[2], grays[9]);
-        sprite.loadFont(font18);
-        snprintf(valueStrBuffer, sizeof(valueStrBuffer), "%.0f%s", wData2[i], PPlblU2[i]);
-        sprite.drawString(valueStrBuffer, x + 27, 116);
-        sprite.unloadFont();
+}
+
+int32_t WeatherDisplay::boxValue(int index) const {
+    switch (index) {
+        case 0: return weatherData.feelsLike;
+        case 1: return weatherData.cloudCoverage;
+        case 2: return weatherData.visibility;
+        case 3: return weatherData.humidity;
+        case 4: return weatherData.pressure;
+        default: return weatherData.windSpeed;
     }
-    
+}
+
+void WeatherDisplay::drawValueBox(int index) {
+    // Box values as {scale, decimals}, same order as boxValue()
+    static const int32_t formats[6][2] = {
+        {TEMP_SCALE, 1}, {1, 0}, {VISIBILITY_SCALE, 0},
+        {1, 0}, {1, 0}, {WIND_SCALE, 0}
+    };
+    const RegionRect& r = DISPLAY_REGIONS[REGION_BOX0 + index];
+    const char* label = index < 3 ? PPlbl1[index] : PPlbl2[index - 3];
+    const char* unit = index < 3 ? PPlblU1[index] : PPlblU2[index - 3];
+    
+    sprite.fillSmoothRoundRect(r.x, r.y, r.w, r.h, 3, grays[9], TFT_BLACK);
+    sprite.setTextDatum(4);  // Center alignment
+    sprite.setTextColor(grays[3], grays[9]);
+    sprite.drawString(label, r.x + 27, r.y + 6);
+    sprite.setTextColor(grays[2], grays[9]);
+    sprite.loadFont(font18);
+    int32_t value = animator.value(TWEEN_CH_BOX0 + index, boxValue(index));
+    size_t len = formatFixed(valueStrBuffer, sizeof(valueStrBuffer), value, formats[index][0], formats[index][1]);
+    snprintf(valueStrBuffer + len, sizeof(valueStrBuffer) - len, "%s", unit);
+    sprite.drawString(valueStrBuffer, r.x + 27, r.y + 23);
+    sprite.unloadFont();
+}
+
+void WeatherDisplay::drawTickerArea() {
     // Scrolling message area
     sprite.fillSmoothRoundRect(144, 148, 174, 16, 2, grays[10], TFT_BLACK);
     errSprite.pushToSprite(&sprite, 148, 150);
@@ -383,48 +557,341 @@ void WeatherDisplay::drawRightPanel() {
     sprite.drawString(counterStrBuffer, 310, 141);
 }
 
-void WeatherDisplay::draw() {
-    
+void WeatherDisplay::renderTickerStrip() {
     // Prepare scrolling message with seamless looping
     errSprite.fillSprite(grays[10]);
     errSprite.setTextColor(grays[1], grays[10]);
     
     // Calculate message width for seamless scrolling (only when needed)
     errSprite.setTextDatum(0);  // Left alignment
-    if (!messageWidthCached || currentMessageWidth == 0) {
-        currentMessageWidth = errSprite.textWidth(Wmsg);
-        messageWidthCached = true;
+    if (ticker.frontWidth() == TICKER_WIDTH_UNKNOWN) {
+        ticker.setFrontWidth(errSprite.textWidth(ticker.front()));
     }
+    const char* message = ticker.front();
+    int currentMessageWidth = ticker.frontWidth();
     int spacing = 80;  // Increased space between repeated messages for cleaner transitions
     int totalWidth = currentMessageWidth + spacing;
+    int y = 4 + animator.value(TWEEN_CH_TICKER, 0);  // Slides up after a message swap
     
     // Only draw the message once at the start of a new cycle to avoid mid-transition issues
     if (ani >= 0) {
         // Normal scrolling - draw two copies for seamless loop
-        errSprite.drawString(Wmsg, ani, 4);
-        errSprite.drawString(Wmsg, ani + totalWidth, 4);
+        errSprite.drawString(message, ani, y);
+        errSprite.drawString(message, ani + totalWidth, y);
     } else {
         // During off-screen phase - only draw the copy that might be visible
-        errSprite.drawString(Wmsg, ani, 4);
+        errSprite.drawString(message, ani, y);
         if (ani + totalWidth > -currentMessageWidth) {
-            errSprite.drawString(Wmsg, ani + totalWidth, 4);
+            errSprite.drawString(message, ani + totalWidth, y);
         }
     }
+}
+
+void WeatherDisplay::drawRegion(uint8_t region) {
+    switch (region) {
+        case REGION_TEMP: drawTemperature(); break;
+        case REGION_CLOCK: drawClock(); break;
+        case REGION_SUN: drawSunAndIcon(); break;
+        case REGION_TICKER: drawTickerArea(); break;
+        default: drawValueBox(region - REGION_BOX0); break;
+    }
+}
+
+void WeatherDisplay::drawConditionsPage() {
+    clockSecond = time(nullptr);
+    strcpy(timeBuffer, rtc.getTime().c_str());
+    renderTickerStrip();
     
-    // Clear main sprite and draw divider lines
-    sprite.fillSprite(TFT_BLACK);
     sprite.drawLine(138, 10, 138, 164, grays[6]);  // Vertical divider
     sprite.drawLine(100, 108, 134, 108, grays[6]); // Horizontal divider in left panel
     sprite.setTextDatum(0);  // Reset text alignment
-    
-    // Draw main panels
     drawLeftPanel();
     drawRightPanel();
+}
+
+void WeatherDisplay::drawPageHeader(uint8_t page) {
+    sprite.setTextDatum(0);
+    sprite.loadFont(midleFont);
+    sprite.setTextColor(grays[1], TFT_BLACK);
+    sprite.drawString(pageTitle(page), 6, 10);
+    sprite.unloadFont();
+    
+    // Page position dots, top right
+    for (int i = 0; i < PAGE_COUNT; i++) {
+        int x = SPRITE_WIDTH - 12 - (PAGE_COUNT - 1 - i) * 12;
+        sprite.fillCircle(x, 20, 3, i == page ? grays[1] : grays[8]);
+    }
+    sprite.drawLine(6, 42, SPRITE_WIDTH - 6, 42, grays[6]);
+}
+
+void WeatherDisplay::drawKeyValue(const char* label, const char* value, int y) {
+    // font18 is loaded by the caller
+    sprite.setTextDatum(0);
+    sprite.setTextColor(grays[4], TFT_BLACK);
+    sprite.drawString(label, 12, y);
+    sprite.setTextDatum(2);  // Top right
+    sprite.setTextColor(grays[1], TFT_BLACK);
+    sprite.drawString(value, SPRITE_WIDTH - 12, y);
+    sprite.setTextDatum(0);
+}
+
+void WeatherDisplay::drawTrendPage() {
+    drawPageHeader(PAGE_TREND);
+    
+    const int chartX = 52, chartY = 54, chartW = 258, chartH = 92;
+    ChartPoint points[TEMPERATURE_HISTORY_SIZE];
+    int16_t low, high;
+    uint8_t n = layoutChart(history, chartX, chartY, chartW, chartH, points, low, high);
+    
+    sprite.loadFont(font18);
+    if (n == 0) {
+        sprite.setTextDatum(4);
+        sprite.setTextColor(grays[4], TFT_BLACK);
+        sprite.drawString("Collecting hourly samples", SPRITE_WIDTH / 2, 100);
+        sprite.unloadFont();
+        sprite.setTextDatum(0);
+        return;
+    }
+    
+    // Grid and range labels
+    for (int i = 0; i < 3; i++) {
+        sprite.drawFastHLine(chartX, chartY + i * (chartH - 1) / 2, chartW, grays[10]);
+    }
+    sprite.setTextDatum(0);
+    sprite.setTextColor(grays[3], TFT_BLACK);
+    size_t len = formatFixed(valueStrBuffer, sizeof(valueStrBuffer), high, TEMP_SCALE, 1);
+    snprintf(valueStrBuffer + len, sizeof(valueStrBuffer) - len, "%s", config.unitProfile->tempSymbol);
+    sprite.drawString(valueStrBuffer, 4, chartY - 4);
+    len = formatFixed(valueStrBuffer, sizeof(valueStrBuffer), low, TEMP_SCALE, 1);
+    snprintf(valueStrBuffer + len, sizeof(valueStrBuffer) - len, "%s", config.unitProfile->tempSymbol);
+    sprite.drawString(valueStrBuffer, 4, chartY + chartH - 14);
+    sprite.setTextColor(grays[6], TFT_BLACK);
+    sprite.drawString("-24h", chartX, 152);
+    sprite.setTextDatum(2);
+    sprite.drawString("now", chartX + chartW, 152);
+    sprite.setTextDatum(0);
+    sprite.unloadFont();
+    
+    // Samples, joined only across consecutive hours so outages show as gaps
+    uint8_t first = history.count() - n;
+    for (uint8_t i = 0; i < n; i++) {
+        if (i > 0 && history.at(first + i).epoch / 3600 - history.at(first + i - 1).epoch / 3600 == 1) {
+            sprite.drawLine(points[i - 1].x, points[i - 1].y, points[i].x, points[i].y, grays[1]);
+        }
+        sprite.fillCircle(points[i].x, points[i].y, 2, grays[0]);
+    }
+}
+
+void WeatherDisplay::drawStatsPage() {
+    drawPageHeader(PAGE_STATS);
+    sprite.loadFont(font18);
+    
+    char value[24];
+    snprintf(value, sizeof(value), "%u", dailyStats.fetches);
+    drawKeyValue("Fetches", value, 52);
+    snprintf(value, sizeof(value), "%u", dailyStats.failures);
+    drawKeyValue("Failures", value, 72);
+    
+    const int16_t range[2] = {dailyStats.minTemp, dailyStats.maxTemp};
+    const char* labels[2] = {"Low", "High"};
+    for (int i = 0; i < 2; i++) {
+        if (dailyStats.fetches > dailyStats.failures) {
+            size_t len = formatFixed(value, sizeof(value), range[i], TEMP_SCALE, 1);
+            snprintf(value + len, sizeof(value) - len, " %s", config.unitProfile->tempSymbol);
+        } else {
+            strcpy(value, "--");
+        }
+        drawKeyValue(labels[i], value, 92 + i * 20);
+    }
+    
+    drawKeyValue("Last update", updatedText, 132);
+    snprintf(value, sizeof(value), "%d", displayState.updateCounter);
+    drawKeyValue("Fetches since time sync", value, 152);
+    sprite.unloadFont();
+}
+
+HealthModel WeatherDisplay::getHealth() {
+    HealthModel health;
+    health.uptimeSeconds = millis() / 1000;
+    health.freeHeap = HeapStats::freeHeap();
+    health.minFreeHeap = HeapStats::minFreeHeap();
+    health.largestBlock = HeapStats::largestFreeBlock();
+    health.frameMaxMicros = lastFrameMaxMicros;
+    health.fpsTenths = lastFpsTenths;
+    health.rssi = WiFi.status() == WL_CONNECTED ? (int8_t)WiFi.RSSI() : 0;
+    return health;
+}
+
+void WeatherDisplay::drawHealthPage() {
+    HealthModel health = getHealth();
+    
+    drawPageHeader(PAGE_HEALTH);
+    sprite.loadFont(font18);
+    
+    char value[32];
+    unsigned long minutes = health.uptimeSeconds / 60;
+    snprintf(value, sizeof(value), "%lud %02luh %02lum", minutes / 1440, (minutes / 60) % 24, minutes % 60);
+    drawKeyValue("Uptime", value, 52);
+    snprintf(value, sizeof(value), "%lu KB (min %lu)", (unsigned long)health.freeHeap / 1024,
+             (unsigned long)health.minFreeHeap / 1024);
+    drawKeyValue("Free heap", value, 72);
+    snprintf(value, sizeof(value), "%lu KB", (unsigned long)health.largestBlock / 1024);
+    drawKeyValue("Largest block", value, 92);
+    if (health.rssi != 0) {
+        snprintf(value, sizeof(value), "%d dBm", health.rssi);
+    } else {
+        strcpy(value, "offline");
+    }
+    drawKeyValue("WiFi", value, 112);
+    snprintf(value, sizeof(value), "%u.%u fps, max %lu.%lu ms", health.fpsTenths / 10, health.fpsTenths % 10,
+             (unsigned long)health.frameMaxMicros / 1000, (unsigned long)(health.frameMaxMicros / 100) % 10);
+    drawKeyValue("Frames", value, 132);
+    snprintf(value, sizeof(value), "%lu hits / %lu misses", (unsigned long)iconCache.hits(),
+             (unsigned long)iconCache.misses());
+    drawKeyValue("Icon cache", value, 152);
+    sprite.unloadFont();
+}
+
+void WeatherDisplay::renderPage(uint8_t page) {
+    sprite.fillSprite(TFT_BLACK);
+    switch (page) {
+        case PAGE_TREND: drawTrendPage(); break;
+        case PAGE_STATS: drawStatsPage(); break;
+        case PAGE_HEALTH: drawHealthPage(); break;
+        default: drawConditionsPage(); break;
+    }
+    lastPageDraw = millis();
+}
+
+void WeatherDisplay::showPage(uint8_t page, uint8_t transitionType) {
+    if (page >= PAGE_COUNT || page == pages.current() || inTransition) {
+        return;
+    }
+    pages.show(page, millis());
+    Serial.printf("Page: %s\n", pageTitle(page));
     
-    // Push sprite to display
-    sprite.pushSprite(0, 0);
+    uint16_t* outgoing = (uint16_t*)stage.getPointer();
+    uint16_t* incoming = (uint16_t*)sprite.getPointer();
+    if (outgoing == nullptr || incoming == nullptr || transitionType == TRANSITION_NONE) {
+        fullRedraw = true;  // Cut to the new page on the next frame
+        return;
+    }
+    
+    // Keep the screen as it is, then build the whole incoming page before the
+    // first transition frame - transition frames only composite the two
+    memcpy(outgoing, incoming, (size_t)SPRITE_WIDTH * SPRITE_HEIGHT * sizeof(uint16_t));
+    renderPage(page);
+    transition = transitionType;
+    inTransition = true;
+    animator.start(TWEEN_CH_PAGE, 0, transitionType == TRANSITION_FADE ? 255 : SPRITE_WIDTH,
+                   millis(), PAGE_TRANSITION_MS, EASE_IN_OUT_QUAD, 0);
+}
+
+void WeatherDisplay::compositeTransition() {
+    const int w = SPRITE_WIDTH;
+    const int h = SPRITE_HEIGHT;
+    int32_t progress = animator.value(TWEEN_CH_PAGE, 0);
+    
+    if (transition == TRANSITION_FADE) {
+        const uint16_t* from = (const uint16_t*)stage.getPointer();
+        const uint16_t* to = (const uint16_t*)sprite.getPointer();
+        tft.startWrite();
+        for (int y = 0; y < h; y += PAGE_FADE_BAND_ROWS) {
+            int rows = h - y < PAGE_FADE_BAND_ROWS ? h - y : PAGE_FADE_BAND_ROWS;
+            fadeLine(from + y * w, to + y * w, fadeBand, rows * w, (uint8_t)progress);
+            tft.pushImage(0, y, w, rows, fadeBand);
+        }
+        tft.endWrite();
+    } else if (transition == TRANSITION_SLIDE_LEFT) {
+        // Outgoing moves left, incoming follows from the right edge
+        if (progress < w) stage.pushSprite(0, 0, progress, 0, w - progress, h);
+        if (progress > 0) sprite.pushSprite(w - progress, 0, 0, 0, progress, h);
+    } else {
+        if (progress < w) stage.pushSprite(progress, 0, 0, 0, w - progress, h);
+        if (progress > 0) sprite.pushSprite(0, 0, w - progress, 0, progress, h);
+    }
+    pushedPixels += (unsigned long)w * h;
+}
+
+void WeatherDisplay::draw() {
+    StallScope stallScope(STALL_REGION_DRAW);
+    AllocScope allocScope(ALLOC_TAG_DISPLAY);  // Font load/unload churn
+    unsigned long frameStart = micros();
+    
+    // The ticker scrolls every frame; everything else redraws only when it changes
+    uint32_t dirty = animator.tick(millis()) | REGION_BIT(REGION_TICKER);
+    
+    if (inTransition) {
+        if (animator.active(TWEEN_CH_PAGE)) {
+            compositeTransition();
+        } else {
+            // The incoming page is already complete in sprite
+            inTransition = false;
+            fullRedraw = true;
+        }
+    }
+    
+    if (inTransition) {
+        // Frame already pushed by the transition
+    } else if (pages.current() != PAGE_CONDITIONS) {
+        // Secondary pages are cheap to rebuild from their models once a second
+        if (fullRedraw || millis() - lastPageDraw >= PAGE_REFRESH_MS) {
+            renderPage(pages.current());
+            sprite.pushSprite(0, 0);
+            pushedPixels += (unsigned long)SPRITE_WIDTH * SPRITE_HEIGHT;
+            fullRedraw = false;
+        }
+    } else {
+        // Format the clock only when the second changes
+        time_t now = time(nullptr);
+        if (now != clockSecond) {
+            clockSecond = now;
+            strcpy(timeBuffer, rtc.getTime().c_str());
+            dirty |= REGION_BIT(REGION_CLOCK);
+        }
+        
+        // Day/night variant switches at the computed sunrise/sunset, not at the next fetch
+        uint8_t icon = solar.applyDayNight(weatherData.icon, (uint32_t)now);
+        if (icon != shownIcon) {
+            fadeFromIcon = shownIcon;
+            shownIcon = icon;
+            animator.start(TWEEN_CH_ICON, 0, 255, millis(), TWEEN_ICON_MS, EASE_IN_OUT_QUAD, REGION_BIT(REGION_SUN));
+            dirty |= REGION_BIT(REGION_SUN);
+        }
+        
+        if (fullRedraw) {
+            renderPage(PAGE_CONDITIONS);
+            sprite.pushSprite(0, 0);
+            pushedPixels += (unsigned long)SPRITE_WIDTH * SPRITE_HEIGHT;
+            fullRedraw = false;
+        } else {
+            renderTickerStrip();
+            for (uint8_t region = 0; region < REGION_COUNT; region++) {
+                if ((dirty & REGION_BIT(region)) == 0) {
+                    continue;
+                }
+                const RegionRect& r = DISPLAY_REGIONS[region];
+                sprite.fillRect(r.x, r.y, r.w, r.h, TFT_BLACK);
+                drawRegion(region);
+                sprite.pushSprite(r.x, r.y, r.x, r.y, r.w, r.h);
+                pushedPixels += (unsigned long)r.w * r.h;
+            }
+        }
+    }
+    
+    // Transition frames never exist as one buffer; the mirror catches up afterwards
+    if (!inTransition) {
+        FrameMirror::capture((const uint16_t*)sprite.getPointer());
+    }
     
     // Performance monitoring
+    unsigned long frameMicros = micros() - frameStart;
+    if (frameMicros > frameMicrosMax) {
+        frameMicrosMax = frameMicros;
+    }
+    if (frameMicros > FRAME_BUDGET_US) {
+        framesOverBudget++;
+    }
     frameCount++;
     unsigned long currentTime = millis();
     if (currentTime - lastPerformanceReport >= 10000) {  // Every 10 seconds
@@ -439,5 +906,18 @@ void WeatherDisplay::reportPerformanceStats() {
     float fps = frameCount / 10.0f;  // Frames per second over last 10 seconds
     Serial.printf("Performance: FPS=%.1f, Free Heap=%d bytes, Frame Count=%lu\n", 
                  fps, ESP.getFreeHeap(), frameCount);
+    Serial.printf("Frame: max %lu us (budget %lu), %lu over budget, %lu px pushed/frame\n",
+                 frameMicrosMax, (unsigned long)FRAME_BUDGET_US, framesOverBudget,
+                 frameCount > 0 ? pushedPixels / frameCount : 0UL);
+    Serial.printf("Icon: draw %lu us, cache %lu hits / %lu misses\n",
+                 iconDrawMicros, (unsigned long)iconCache.hits(), (unsigned long)iconCache.misses());
+    backlight.reportStats();
+    PerfReport::print();
+    lastFpsTenths = (uint16_t)frameCount;  // Frames per 10 s = tenths of FPS
+    lastFrameMaxMicros = frameMicrosMax;
+    StatusServer::publishFrames(lastFpsTenths, frameMicrosMax, framesOverBudget);
     frameCount = 0;  // Reset counter
+    frameMicrosMax = 0;
+    framesOverBudget = 0;
+    pushedPixels = 0;
 }
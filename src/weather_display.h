@@ -4,7 +4,17 @@
 #include <TFT_eSPI.h>
 #include "config.h"
 #include "weather_data.h"
+#include "backlight.h"
+#include "solar_clock.h"
+#include "ticker_buffer.h"
+#include "ticker_queue.h"
+#include "ticker_sources.h"
+#include "ticker_template.h"
 #include "weather_icons.h"
+#include "icon_cache.h"
+#include "tween.h"
+#include "display_regions.h"
+#include "pages.h"
 #include "NotoSansBold15.h"
 #include "tinyFont.h"
 #include "smallFont.h"
@@ -15,6 +25,15 @@
 // Forward declarations
 class ESP32Time;
 
+// Animator channels
+enum DisplayTween : uint8_t {
+    TWEEN_CH_TEMP = 0,
+    TWEEN_CH_BOX0,       // Six value boxes, REGION_BOX0 order
+    TWEEN_CH_ICON = TWEEN_CH_BOX0 + 6,
+    TWEEN_CH_TICKER,
+    TWEEN_CH_PAGE        // Page transition progress
+};
+
 class WeatherDisplay {
 public:
     WeatherDisplay(ESP32Time& rtcRef); // Constructor takes ESP32Time reference
@@ -22,36 +41,41 @@ public:
     // Initialize display and sprites
     void begin();
     
-    // Main drawing functions
+    // Main drawing functions - draw() redraws and pushes only dirty regions
     void draw();
     void drawLeftPanel();
     void drawRightPanel();
-    void drawWeatherIcon(int x, int y, const char* iconCode);
+    void invalidate() { fullRedraw = true; }
+    // iconByte is WeatherIconCode | WEATHER_ICON_NIGHT; background is the solid panel color under the icon
+    void drawWeatherIcon(int x, int y, uint8_t iconByte, uint8_t size = ICON_DRAW_SIZE,
+                         uint16_t background = TFT_BLACK);
     
     // Animation and scrolling
     void updateData();
     void updateScrollingMessage();
     
-    // Brightness control
+    // Ticker content - the next message is pre-rendered by serviceTicker()
+    void serviceTicker();
+    void recordFetch(bool success);
+    void showStatusMessage(const char* message);
+    
+    // Buttons: click pages forward (top) / back (bottom), hold for brightness
     void initializeBrightnessControl();
-    void handleBrightnessButtons();
+    void handleButtons();
+    void showPage(uint8_t page, uint8_t transition);
+    void updateBacklight();
     
     // Getters for external access
     WeatherData& getWeatherData() { return weatherData; }
     DisplayState& getDisplayState() { return displayState; }
     
-    // Update scrolling message buffer immediately
+    // Show the highest-priority queued message now instead of at the next wrap
     void updateScrollingBuffer();
     WeatherConfig& getConfig() { return config; }
     
-    // Legacy data access (for compatibility)
-    float& getTemperature() { return temperature; }
-    float* getWData1() { return wData1; }
-    float* getWData2() { return wData2; }
-    char* getWmsg() { return Wmsg; }
-    char* getWmsgBuffer() { return WmsgBuffer; }
-    bool& getMessageUpdatePending() { return messageUpdatePending; }
-    int& getCurrentMessageWidth() { return currentMessageWidth; }
+    const uint16_t* getFramebuffer() { return (const uint16_t*)sprite.getPointer(); }
+    HealthModel getHealth();   // Heap, WiFi, uptime and the last perf report's frame timing
+    
     int& getAni() { return ani; }
     unsigned long& getTimePased() { return timePased; }
     
@@ -60,6 +84,7 @@ private:
     TFT_eSPI tft;
     TFT_eSprite sprite;
     TFT_eSprite errSprite;
+    TFT_eSprite stage;       // Outgoing page during a transition (PSRAM when available)
     ESP32Time& rtc; // Reference to the global ESP32Time object
     
     // Data structures
@@ -72,20 +97,50 @@ private:
     unsigned long timePased;
     
     // Button and brightness control
-    int displayBrightness;
-    unsigned long lastButtonPress;
-    
-    // Legacy data arrays (for compatibility)
-    float temperature;
-    float wData1[3];
-    float wData2[3];
-    
-    // Scrolling message with buffer system
-    char Wmsg[512];
-    char WmsgBuffer[512];
-    bool messageUpdatePending;
-    int currentMessageWidth;
-    bool messageWidthCached;
+    BacklightManager backlight;
+    SolarClock solar;
+    unsigned long lastButtonPress;   // Last brightness step while a button is held
+    bool buttonDown[2];              // [0] = KEY (top), [1] = BOOT (bottom)
+    bool buttonHeld[2];
+    unsigned long buttonPressStart[2];
+    
+    // Pages - only the visible page has pixels, idle pages render from their models
+    PageNavigator pages;
+    TemperatureHistory history;
+    uint8_t transition;              // PageTransition while TWEEN_CH_PAGE runs
+    bool inTransition;
+    unsigned long lastPageDraw;
+    uint16_t lastFpsTenths;          // From the last performance report, for the health page
+    unsigned long lastFrameMaxMicros;
+    
+    // Local-time text cached per fetch by applyWeatherUpdate()
+    char sunriseText[12];
+    char sunsetText[12];
+    char updatedText[12];
+    
+    // Scrolling message - front slot is drawn, back slot takes the next message
+    TickerBuffer ticker;
+    TickerQueue tickerQueue;
+    TickerTemplate conditionsTemplate;   // Compiled TICKER_TEMPLATE
+    DailyStats dailyStats;
+    uint16_t preparedId;           // Queue id of the message in the back slot
+    uint32_t preparedGeneration;   // Queue generation it was picked from
+    
+    // Icon masters scaled to their drawing size on first use
+    IconCache iconCache;
+    unsigned long iconDrawMicros;   // Last blit, for the performance report
+    
+    // Value transitions and partial redraw
+    Animator animator;
+    bool fullRedraw;
+    bool hasShownValues;
+    int32_t shownValues[7];        // Last animation targets: temperature, then the boxes
+    uint8_t shownIcon;             // Icon byte on screen (day/night applied)
+    uint8_t fadeFromIcon;          // Previous icon during the cross-fade
+    time_t clockSecond;            // Wall-clock second last drawn
+    unsigned long frameMicrosMax;  // Worst frame since the last report
+    unsigned long framesOverBudget;
+    unsigned long pushedPixels;    // Pixels sent to the panel since the last report
     
     // Grayscale palette
     unsigned short grays[GRAY_LEVELS];
@@ -95,11 +150,36 @@ private:
     const char* PPlblU1[3];
     const char* PPlbl2[3];
     const char* PPlblU2[3];
+    char tempUnitLabel[8];   // Unit suffixes built from the unit profile
+    char distUnitLabel[8];
+    char windUnitLabel[8];
     
     // Helper functions
     void generateGrayscalePalette();
     void setupUILabels();
-    void updateLegacyArrays();
+    void prepareTicker(bool force);
+    void animateValues();
+    int32_t boxValue(int index) const;
+    const IconImage* iconImage(uint8_t iconByte, uint8_t size);
+    
+    // Region drawers - each sets its own text state and stays inside its DISPLAY_REGIONS rect
+    void drawRegion(uint8_t region);
+    void drawTemperature();
+    void drawClock();
+    void drawSunAndIcon();
+    void drawValueBox(int index);
+    void drawTickerArea();
+    void renderTickerStrip();
+    
+    // Pages render into sprite without pushing
+    void renderPage(uint8_t page);
+    void drawConditionsPage();
+    void drawTrendPage();
+    void drawStatsPage();
+    void drawHealthPage();
+    void drawPageHeader(uint8_t page);
+    void drawKeyValue(const char* label, const char* value, int y);
+    void compositeTransition();
     
     // Performance optimization: Font management
     void loadFontOnce(const uint8_t* font);
@@ -110,16 +190,17 @@ private:
     static char timeBuffer[32];
     static char valueStrBuffer[32];
     static char counterStrBuffer[16];
+    static uint16_t fadeBand[SPRITE_WIDTH * PAGE_FADE_BAND_ROWS];
     
     // Performance monitoring
     static unsigned long frameCount;
     static unsigned long lastPerformanceReport;
     static unsigned long lastFrameTime;
-    static void reportPerformanceStats();
+    void reportPerformanceStats();
     
 public:
-    // Public method for updating legacy arrays
-    void updateLegacyData();
+    // Refresh cached text after new weather data arrives
+    void applyWeatherUpdate();
 };
 
 #endif // WEATHER_DISPLAY_H
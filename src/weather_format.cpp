@@ -0,0 +1,88 @@
+#include "weather_format.h"
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+
+int16_t toFixed(float value, int scale) {
+    float scaled = value * scale;
+    scaled += scaled < 0 ? -0.5f : 0.5f;
+    if (scaled > 32767.0f) return 32767;
+    if (scaled < -32768.0f) return -32768;
+    return (int16_t)scaled;
+}
+
+size_t formatFixed(char* out, size_t outSize, int32_t value, int32_t scale, int decimals) {
+    if (outSize == 0) {
+        return 0;
+    }
+
+    // Rescale to the requested number of decimals with rounding
+    int32_t target = 1;
+    for (int i = 0; i < decimals; i++) {
+        target *= 10;
+    }
+    int64_t scaled = (int64_t)value * target;
+    scaled = scaled >= 0 ? (scaled + scale / 2) / scale : (scaled - scale / 2) / scale;
+
+    char digits[16];
+    int n = 0;
+    bool negative = scaled < 0;
+    uint64_t magnitude = negative ? (uint64_t)(-scaled) : (uint64_t)scaled;
+    do {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+        if (n == decimals) {
+            digits[n++] = '.';
+        }
+    } while (magnitude > 0 || n <= decimals);
+    if (digits[n - 1] == '.') {
+        digits[n++] = '0';  // Leading zero: ".5" -> "0.5"
+    }
+
+    size_t len = 0;
+    if (negative && len + 1 < outSize) {
+        out[len++] = '-';
+    }
+    while (n > 0 && len + 1 < outSize) {
+        out[len++] = digits[--n];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+static void toLocal(uint32_t epoch, struct tm* tmLocal) {
+    // configTime() rewrites TZ on every NTP sync, so apply the zone rules here
+    setenv("TZ", TIMEZONE_TZ, 1);
+    tzset();
+
+    time_t t = (time_t)epoch;
+    localtime_r(&t, tmLocal);
+}
+
+void formatLocalTime(uint32_t epoch, char* out, size_t outSize, const char* fmt) {
+    if (epoch == 0) {
+        strncpy(out, "--:--", outSize - 1);
+        out[outSize - 1] = '\0';
+        return;
+    }
+
+    struct tm tmLocal;
+    toLocal(epoch, &tmLocal);
+    strftime(out, outSize, fmt, &tmLocal);
+}
+
+int32_t localDayNumber(uint32_t epoch) {
+    struct tm tmLocal;
+    toLocal(epoch, &tmLocal);
+    return (int32_t)(tmLocal.tm_year + 1900) * 1000 + tmLocal.tm_yday;
+}
+
+uint32_t localNoon(uint32_t epoch) {
+    struct tm tmLocal;
+    toLocal(epoch, &tmLocal);
+    tmLocal.tm_hour = 12;
+    tmLocal.tm_min = 0;
+    tmLocal.tm_sec = 0;
+    tmLocal.tm_isdst = -1;  // Let mktime work out DST for noon
+    return (uint32_t)mktime(&tmLocal);
+}
@@ -0,0 +1,28 @@
+#ifndef WEATHER_FORMAT_H
+#define WEATHER_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Render-boundary formatting for the compact WeatherData fields.
+// No Arduino dependencies.
+
+// Round a float to a fixed-point int16 with the given scale, saturating
+int16_t toFixed(float value, int scale);
+
+// Format a fixed-point value: formatFixed(buf, n, 225, 10, 1) -> "22.5".
+// decimals may be lower than the scale's precision (rounds half away from zero).
+// Returns the number of characters written.
+size_t formatFixed(char* out, size_t outSize, int32_t value, int32_t scale, int decimals);
+
+// Local wall-clock text for a UTC epoch using TIMEZONE_TZ; "--:--" style placeholder when epoch is 0
+void formatLocalTime(uint32_t epoch, char* out, size_t outSize, const char* fmt = "%H:%M:%S");
+
+// Local calendar day (year * 1000 + day of year) for day-boundary bookkeeping
+int32_t localDayNumber(uint32_t epoch);
+
+// 12:00 local time on the local calendar day containing epoch
+uint32_t localNoon(uint32_t epoch);
+
+#endif // WEATHER_FORMAT_H
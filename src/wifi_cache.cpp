@@ -0,0 +1,137 @@
+#include "wifi_cache.h"
+#include <string.h>
+
+static uint32_t fnv1a(uint32_t h, const char* text) {
+    for (; *text; text++) {
+        h = (h ^ (uint8_t)*text) * 16777619u;
+    }
+    return h;
+}
+
+uint32_t wifiCredentialHash(const char* ssid, const char* password) {
+    uint32_t h = fnv1a(2166136261u, ssid);
+    h = (h ^ 0xFFu) * 16777619u;   // Separator so "ab"+"c" differs from "a"+"bc"
+    return fnv1a(h, password);
+}
+
+void wifiCacheReset(WifiJoinCache* cache, uint32_t credentialHash) {
+    memset(cache, 0, sizeof(*cache));
+    cache->magic = WIFI_CACHE_MAGIC;
+    cache->ssidHash = credentialHash;
+}
+
+bool wifiCacheValid(const WifiJoinCache& cache, uint32_t credentialHash) {
+    return cache.magic == WIFI_CACHE_MAGIC && cache.ssidHash == credentialHash && cache.channel <= 14;
+}
+
+WifiAddressConfig wifiStaticAddress() {
+    WifiAddressConfig address = {parseIPv4(WIFI_STATIC_IP), parseIPv4(WIFI_STATIC_GATEWAY),
+                                 parseIPv4(WIFI_STATIC_SUBNET), parseIPv4(WIFI_STATIC_DNS)};
+    if (address.dns == 0) {
+        address.dns = address.gateway;
+    }
+    return address;
+}
+
+static bool leaseFresh(const WifiJoinCache& cache, uint32_t now) {
+    return cache.ip != 0 && cache.subnet != 0 && cache.leaseEpoch != 0 && now >= cache.leaseEpoch &&
+           now - cache.leaseEpoch < WIFI_LEASE_REUSE_S;
+}
+
+WifiJoinPlan planWifiJoin(const WifiJoinCache& cache, const WifiAddressConfig& fixed, bool reuseLease,
+                          uint32_t now) {
+    WifiJoinPlan plan;
+    memset(&plan, 0, sizeof(plan));
+
+    plan.fastJoin = cache.channel != 0 && cache.failures < WIFI_CACHE_MAX_FAILURES;
+    if (plan.fastJoin) {
+        memcpy(plan.bssid, cache.bssid, sizeof(plan.bssid));
+        plan.channel = cache.channel;
+    }
+
+    if (fixed.ip != 0 && fixed.subnet != 0) {
+        plan.ipMode = WIFI_IP_STATIC;
+        plan.address = fixed;
+    } else if (reuseLease && plan.fastJoin && leaseFresh(cache, now)) {
+        // Only on the same access point: a lease from elsewhere may belong to another network
+        plan.ipMode = WIFI_IP_CACHED_LEASE;
+        plan.address.ip = cache.ip;
+        plan.address.gateway = cache.gateway;
+        plan.address.subnet = cache.subnet;
+        plan.address.dns = cache.dns;
+    } else {
+        plan.ipMode = WIFI_IP_DHCP;
+    }
+    return plan;
+}
+
+bool wifiCacheRecordFailure(WifiJoinCache* cache) {
+    if (cache->channel == 0) {
+        return false;
+    }
+    cache->failures++;
+    if (cache->failures >= WIFI_CACHE_MAX_FAILURES) {
+        // The access point is gone or moved; the scan will find the new one
+        uint32_t hash = cache->ssidHash;
+        wifiCacheReset(cache, hash);
+    }
+    return true;
+}
+
+bool wifiCacheStampLease(WifiJoinCache* cache, uint32_t now) {
+    if (cache->ip == 0 || now == 0) {
+        return false;
+    }
+    // Renewals of the same lease are only written once they have moved the
+    // reuse window noticeably, so every boot doesn't cost a flash write
+    if (cache->leaseEpoch != 0 && now >= cache->leaseEpoch && now - cache->leaseEpoch < WIFI_LEASE_REFRESH_S) {
+        return false;
+    }
+    cache->leaseEpoch = now;
+    return true;
+}
+
+bool wifiCacheRecordJoin(WifiJoinCache* cache, const uint8_t* bssid, uint8_t channel,
+                         WifiIpMode mode, const WifiAddressConfig& lease, uint32_t now) {
+    bool changed = cache->failures != 0 || cache->channel != channel ||
+                   memcmp(cache->bssid, bssid, sizeof(cache->bssid)) != 0;
+    memcpy(cache->bssid, bssid, sizeof(cache->bssid));
+    cache->channel = channel;
+    cache->failures = 0;
+
+    if (mode != WIFI_IP_DHCP) {
+        return changed;   // A static or reused address says nothing new about the lease
+    }
+    if (cache->ip != lease.ip || cache->gateway != lease.gateway || cache->subnet != lease.subnet ||
+        cache->dns != lease.dns) {
+        cache->ip = lease.ip;
+        cache->gateway = lease.gateway;
+        cache->subnet = lease.subnet;
+        cache->dns = lease.dns;
+        cache->leaseEpoch = now;
+        return true;
+    }
+    return wifiCacheStampLease(cache, now) || changed;
+}
+
+uint32_t parseIPv4(const char* text) {
+    uint32_t result = 0;
+    for (int octet = 0; octet < 4; octet++) {
+        if (*text < '0' || *text > '9') {
+            return 0;
+        }
+        uint32_t value = 0;
+        int digits = 0;
+        while (*text >= '0' && *text <= '9') {
+            value = value * 10 + (uint32_t)(*text++ - '0');
+            if (++digits > 3 || value > 255) {
+                return 0;
+            }
+        }
+        result |= value << (8 * octet);
+        if (octet < 3 && *text++ != '.') {
+            return 0;
+        }
+    }
+    return *text == '\0' ? result : 0;
+}
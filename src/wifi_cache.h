@@ -0,0 +1,80 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <stdint.h>
+#include "config.h"
+
+// What the last successful join learned (access point, channel, DHCP lease)
+// and the decision of how to use it on the next boot. Addresses are kept as
+// IPAddress holds them; 0 means none. No Arduino dependencies.
+
+#define WIFI_CACHE_MAGIC 0x57434A31u   // "WCJ1" - bump when the layout changes
+
+struct WifiJoinCache {
+    uint32_t magic;
+    uint32_t ssidHash;      // Credentials the entry was learned with
+    uint32_t ip;            // Last DHCP lease
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t leaseEpoch;    // UTC seconds the lease was last handed out, 0 = unknown
+    uint8_t bssid[6];
+    uint8_t channel;        // 0 = no access point cached
+    uint8_t failures;       // Fast joins that failed since the last success
+};
+
+enum WifiIpMode : uint8_t {
+    WIFI_IP_DHCP = 0,
+    WIFI_IP_STATIC,         // WIFI_STATIC_IP from config.h
+    WIFI_IP_CACHED_LEASE    // Last lease reused without asking DHCP
+};
+
+struct WifiAddressConfig {
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+struct WifiJoinPlan {
+    bool fastJoin;          // Skip the scan and go straight to bssid on channel
+    uint8_t bssid[6];
+    uint8_t channel;
+    WifiIpMode ipMode;
+    WifiAddressConfig address;   // Unused for WIFI_IP_DHCP
+};
+
+// Identifies the configured network so changed credentials drop the cache
+uint32_t wifiCredentialHash(const char* ssid, const char* password);
+
+// Start over with an empty entry for these credentials
+void wifiCacheReset(WifiJoinCache* cache, uint32_t credentialHash);
+
+// A restored entry is only trusted if it belongs to the same layout and credentials
+bool wifiCacheValid(const WifiJoinCache& cache, uint32_t credentialHash);
+
+// WIFI_STATIC_* from config.h, dns defaulting to the gateway; ip 0 when unset
+WifiAddressConfig wifiStaticAddress();
+
+// How to join. fixed.ip and subnet select a static address; reuseLease
+// (WIFI_REUSE_LEASE) allows skipping DHCP with a fresh cached lease; now is
+// UTC seconds, 0 while the clock is unset (a lease of unknown age is never reused).
+WifiJoinPlan planWifiJoin(const WifiJoinCache& cache, const WifiAddressConfig& fixed, bool reuseLease,
+                          uint32_t now);
+
+// The fast join timed out. Returns true when the entry changed and should be saved.
+bool wifiCacheRecordFailure(WifiJoinCache* cache);
+
+// A join succeeded. The lease is only recorded when DHCP handed it out;
+// now may be 0 and stamped later with wifiCacheStampLease(). Returns true
+// when the entry changed enough to be worth a flash write.
+bool wifiCacheRecordJoin(WifiJoinCache* cache, const uint8_t* bssid, uint8_t channel,
+                         WifiIpMode mode, const WifiAddressConfig& lease, uint32_t now);
+
+// Date a lease obtained before the clock was set
+bool wifiCacheStampLease(WifiJoinCache* cache, uint32_t now);
+
+// "a.b.c.d" in IPAddress order; 0 when empty or malformed
+uint32_t parseIPv4(const char* text);
+
+#endif // WIFI_CACHE_H
@@ -0,0 +1,146 @@
+#include "wifi_join.h"
+#include <Preferences.h>
+#include <time.h>
+
+WifiJoinCache WifiJoin::cache;
+bool WifiJoin::fastJoined = false;
+bool WifiJoin::leaseUndated = false;
+volatile uint32_t WifiJoin::connectedAt = 0;
+volatile uint32_t WifiJoin::gotIpAt = 0;
+
+// 0 until the clock has been set since power-on (it survives software resets)
+static uint32_t clockNow() {
+    time_t now = time(nullptr);
+    return now >= (time_t)SOLAR_MIN_EPOCH ? (uint32_t)now : 0;
+}
+
+// Runs in the WiFi event task
+void WifiJoin::onEvent(arduino_event_t* event) {
+    if (event->event_id == ARDUINO_EVENT_WIFI_STA_CONNECTED) {
+        connectedAt = millis();
+    } else if (event->event_id == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        gotIpAt = millis();
+    }
+}
+
+void WifiJoin::save() {
+    Preferences prefs;
+    prefs.begin("wifi", false);
+    prefs.putBytes("join", &cache, sizeof(cache));
+    prefs.end();
+}
+
+bool WifiJoin::attempt(const char* ssid, const char* password, const WifiJoinPlan& plan,
+                       uint32_t timeoutMs, const char* joinPhase, BootTimeline& timeline) {
+    if (plan.ipMode == WIFI_IP_DHCP) {
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+    } else {
+        WiFi.config(IPAddress(plan.address.ip), IPAddress(plan.address.gateway),
+                    IPAddress(plan.address.subnet), IPAddress(plan.address.dns));
+    }
+
+    connectedAt = 0;
+    gotIpAt = 0;
+    uint32_t start = millis();
+    if (plan.channel != 0) {
+        WiFi.begin(ssid, password, plan.channel, plan.bssid);
+    } else {
+        WiFi.begin(ssid, password);
+    }
+    while (WiFi.status() != WL_CONNECTED && millis() - start < timeoutMs) {
+        delay(WIFI_JOIN_POLL_MS);
+    }
+    uint32_t end = millis();
+
+    if (WiFi.status() != WL_CONNECTED) {
+        timeline.add(joinPhase, start, end);
+        WiFi.disconnect();
+        return false;
+    }
+    // Association and authentication finish together in one event, so they are one phase
+    uint32_t associated = connectedAt != 0 ? connectedAt : end;
+    uint32_t addressed = gotIpAt != 0 ? gotIpAt : end;
+    timeline.add(joinPhase, start, associated);
+    timeline.add(plan.ipMode == WIFI_IP_DHCP ? "wifi dhcp" : "wifi ip (no dhcp)", associated, addressed);
+    return true;
+}
+
+bool WifiJoin::scanForAccessPoint(const char* ssid, WifiJoinPlan* plan) {
+    int16_t found = WiFi.scanNetworks(false, false, false, WIFI_SCAN_MS_PER_CHANNEL);
+    int best = -1;
+    for (int16_t i = 0; i < found; i++) {
+        if (WiFi.SSID(i) == ssid && (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best))) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        memcpy(plan->bssid, WiFi.BSSID(best), sizeof(plan->bssid));
+        plan->channel = (uint8_t)WiFi.channel(best);
+        Serial.printf("WiFi: strongest of %d networks on channel %u (%ld dBm)\n", found, plan->channel,
+                     (long)WiFi.RSSI(best));
+    }
+    WiFi.scanDelete();
+    return best >= 0;
+}
+
+bool WifiJoin::connect(const char* ssid, const char* password, BootTimeline& timeline) {
+    uint32_t hash = wifiCredentialHash(ssid, password);
+    Preferences prefs;
+    prefs.begin("wifi", true);
+    bool restored = prefs.getBytesLength("join") == sizeof(cache) &&
+                    prefs.getBytes("join", &cache, sizeof(cache)) == sizeof(cache);
+    prefs.end();
+    if (!restored || !wifiCacheValid(cache, hash)) {
+        wifiCacheReset(&cache, hash);
+    }
+
+    WifiJoinPlan plan = planWifiJoin(cache, wifiStaticAddress(), WIFI_REUSE_LEASE, clockNow());
+
+    WiFi.persistent(false);   // Credentials come from secrets.h; don't rewrite them to flash every boot
+    WiFi.mode(WIFI_STA);
+    WiFi.onEvent(onEvent);
+
+    fastJoined = false;
+    if (plan.fastJoin) {
+        Serial.printf("WiFi: fast join to cached access point on channel %u%s\n", plan.channel,
+                     plan.ipMode == WIFI_IP_CACHED_LEASE ? " with cached lease" : "");
+        fastJoined = attempt(ssid, password, plan, WIFI_FAST_JOIN_TIMEOUT_MS, "wifi join (cached)", timeline);
+        if (!fastJoined) {
+            Serial.println("WiFi: cached access point didn't answer, scanning");
+            if (wifiCacheRecordFailure(&cache)) {
+                save();
+            }
+        }
+    }
+
+    if (!fastJoined) {
+        // A reused lease is only trusted on the access point it came from
+        if (plan.ipMode == WIFI_IP_CACHED_LEASE) {
+            plan.ipMode = WIFI_IP_DHCP;
+        }
+        uint32_t scanStart = millis();
+        if (!scanForAccessPoint(ssid, &plan)) {
+            plan.channel = 0;   // Not seen; let the driver search (hidden networks)
+        }
+        timeline.add("wifi scan", scanStart, millis());
+        if (!attempt(ssid, password, plan, WIFI_JOIN_TIMEOUT_MS, "wifi join", timeline)) {
+            return false;
+        }
+    }
+
+    WifiAddressConfig lease = {(uint32_t)WiFi.localIP(), (uint32_t)WiFi.gatewayIP(),
+                               (uint32_t)WiFi.subnetMask(), (uint32_t)WiFi.dnsIP()};
+    uint32_t now = clockNow();
+    leaseUndated = plan.ipMode == WIFI_IP_DHCP && now == 0;
+    if (wifiCacheRecordJoin(&cache, WiFi.BSSID(), (uint8_t)WiFi.channel(), plan.ipMode, lease, now)) {
+        save();
+    }
+    return true;
+}
+
+void WifiJoin::timeSynced() {
+    if (leaseUndated && wifiCacheStampLease(&cache, clockNow())) {
+        save();
+    }
+    leaseUndated = false;
+}
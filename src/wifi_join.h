@@ -0,0 +1,37 @@
+#ifndef WIFI_JOIN_H
+#define WIFI_JOIN_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "wifi_cache.h"
+#include "boot_timeline.h"
+
+// Station join at boot. The access point, channel and DHCP lease of the last
+// successful join are kept in NVS, so the next boot goes straight to that
+// BSSID (and, while the lease is fresh, skips DHCP). A scan for the strongest
+// access point is the fallback.
+class WifiJoin {
+public:
+    // Blocks until connected or WIFI_JOIN_TIMEOUT_MS; phases go into timeline
+    static bool connect(const char* ssid, const char* password, BootTimeline& timeline);
+
+    // Call after the first time sync, to date a lease obtained before it
+    static void timeSynced();
+
+    static bool usedFastJoin() { return fastJoined; }
+
+private:
+    static WifiJoinCache cache;
+    static bool fastJoined;
+    static bool leaseUndated;
+    static volatile uint32_t connectedAt;
+    static volatile uint32_t gotIpAt;
+
+    static bool attempt(const char* ssid, const char* password, const WifiJoinPlan& plan,
+                        uint32_t timeoutMs, const char* joinPhase, BootTimeline& timeline);
+    static bool scanForAccessPoint(const char* ssid, WifiJoinPlan* plan);
+    static void save();
+    static void onEvent(arduino_event_t* event);
+};
+
+#endif // WIFI_JOIN_H
@@ -0,0 +1,363 @@
+#include "wifi_link.h"
+#include <string.h>
+
+const char* wifiLinkStateName(uint8_t state) {
+    static const char* const names[] = {"down", "scanning", "connecting", "up"};
+    return state < sizeof(names) / sizeof(names[0]) ? names[state] : "?";
+}
+
+void RssiHistory::push(int8_t rssi) {
+    samples[head] = rssi;
+    head = (uint8_t)((head + 1) % WIFI_RSSI_HISTORY);
+    if (used < WIFI_RSSI_HISTORY) {
+        used++;
+    }
+}
+
+int8_t RssiHistory::at(uint8_t i) const {
+    return samples[(head + WIFI_RSSI_HISTORY - used + i) % WIFI_RSSI_HISTORY];
+}
+
+// Wrap-safe "now is at or past deadline"
+static bool due(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+WifiLink::WifiLink() {
+    begin(0, 0, -1, nullptr, 0);
+}
+
+void WifiLink::begin(uint8_t networkCount, uint32_t now, int network, const uint8_t* bssid, uint8_t channel) {
+    numNetworks = networkCount < WIFI_MAX_NETWORKS ? networkCount : WIFI_MAX_NETWORKS;
+    memset(networks, 0, sizeof(networks));
+    memset(currentBssid, 0, sizeof(currentBssid));
+    current = -1;
+    lastGood = -1;
+    currentChannel = 0;
+    candidateCount = 0;
+    nextCandidate = 0;
+    roaming = false;
+    roamScanWanted = false;
+    roamScanActive = false;
+    backoffMs = WIFI_BACKOFF_MIN_MS;
+    outageMs = 0;
+    lastRoamScan = now;
+    weakSamples = 0;
+    currentRssi = 0;
+    connectCount = 0;
+    reconnectCount = 0;
+    disconnectCount = 0;
+    roamCount = 0;
+    failedCount = 0;
+    history = RssiHistory();
+
+    if (network >= 0 && network < numNetworks) {
+        linkState = LINK_UP;
+        current = network;
+        lastGood = network;
+        currentChannel = channel;
+        if (bssid != nullptr) {
+            memcpy(currentBssid, bssid, sizeof(currentBssid));
+        }
+        networks[network].successes = 1;
+        connectCount = 1;
+        upSince = now;
+        stateSince = now;
+        downSince = now;
+    } else {
+        linkState = LINK_DOWN;
+        upSince = now;
+        downSince = now;
+        stateSince = now;
+        retryAt = now;
+    }
+}
+
+int WifiLink::score(uint8_t network, int8_t rssi) const {
+    uint8_t streak = networks[network].failStreak < 4 ? networks[network].failStreak : 4;
+    return rssi - WIFI_FAILURE_PENALTY_DB * streak + (network == lastGood ? WIFI_PREFERRED_BONUS_DB : 0);
+}
+
+void WifiLink::rankCandidates(const WifiScanResult* results, uint8_t count) {
+    candidateCount = 0;
+    nextCandidate = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const WifiScanResult& r = results[i];
+        if (r.network >= numNetworks) {
+            continue;
+        }
+        bool duplicate = false;
+        for (uint8_t j = 0; j < candidateCount; j++) {
+            duplicate |= memcmp(candidates[j].bssid, r.bssid, sizeof(r.bssid)) == 0;
+        }
+        if (duplicate) {
+            continue;
+        }
+        // Insertion sort by score, best first; the weakest falls off a full list
+        int s = score(r.network, r.rssi);
+        uint8_t pos = candidateCount;
+        while (pos > 0 && s > score(candidates[pos - 1].network, candidates[pos - 1].rssi)) {
+            pos--;
+        }
+        if (pos >= WIFI_MAX_CANDIDATES) {
+            continue;
+        }
+        uint8_t last = candidateCount < WIFI_MAX_CANDIDATES ? candidateCount : WIFI_MAX_CANDIDATES - 1;
+        for (uint8_t j = last; j > pos; j--) {
+            candidates[j] = candidates[j - 1];
+        }
+        candidates[pos].network = r.network;
+        candidates[pos].rssi = r.rssi;
+        candidates[pos].channel = r.channel;
+        memcpy(candidates[pos].bssid, r.bssid, sizeof(r.bssid));
+        if (candidateCount < WIFI_MAX_CANDIDATES) {
+            candidateCount++;
+        }
+    }
+    if (candidateCount > 0) {
+        return;
+    }
+
+    // Nothing heard (hidden SSIDs, or a scan that failed): try every network
+    // blind, least recently failing and most often successful first
+    for (uint8_t n = 0; n < numNetworks && candidateCount < WIFI_MAX_CANDIDATES; n++) {
+        uint8_t pos = candidateCount;
+        while (pos > 0) {
+            const WifiNetworkStats& prev = networks[candidates[pos - 1].network];
+            bool better = networks[n].failStreak < prev.failStreak ||
+                          (networks[n].failStreak == prev.failStreak && networks[n].successes > prev.successes);
+            if (!better) break;
+            candidates[pos] = candidates[pos - 1];
+            pos--;
+        }
+        memset(&candidates[pos], 0, sizeof(Candidate));
+        candidates[pos].network = n;
+        candidateCount++;
+    }
+}
+
+void WifiLink::goDown(uint32_t now, uint32_t delayMs) {
+    linkState = LINK_DOWN;
+    retryAt = now + delayMs;
+    roaming = false;
+    roamScanWanted = false;
+    roamScanActive = false;
+    weakSamples = 0;
+}
+
+void WifiLink::attemptFailed(uint32_t now) {
+    failedCount++;
+    if (current >= 0) {
+        networks[current].failures++;
+        if (networks[current].failStreak < 255) {
+            networks[current].failStreak++;
+        }
+    }
+    if (roaming) {
+        // The old association is gone too; start over from a fresh scan
+        disconnectCount++;
+        downSince = now;
+        candidateCount = 0;
+        goDown(now, 0);
+    } else if (nextCandidate < candidateCount) {
+        goDown(now, 0);
+    } else {
+        candidateCount = 0;
+        goDown(now, backoffMs);
+        backoffMs = backoffMs * 2 < WIFI_BACKOFF_MAX_MS ? backoffMs * 2 : WIFI_BACKOFF_MAX_MS;
+    }
+}
+
+WifiLinkAction WifiLink::connectTo(uint32_t now, const Candidate& candidate) {
+    linkState = LINK_CONNECTING;
+    stateSince = now;
+    current = candidate.network;
+    currentChannel = candidate.channel;
+    memcpy(currentBssid, candidate.bssid, sizeof(currentBssid));
+
+    WifiLinkAction action;
+    action.type = LINK_ACTION_CONNECT;
+    action.network = candidate.network;
+    action.channel = candidate.channel;
+    memcpy(action.bssid, candidate.bssid, sizeof(action.bssid));
+    return action;
+}
+
+void WifiLink::onConnected(uint32_t now, const uint8_t* bssid, uint8_t channel) {
+    if (current < 0 || linkState == LINK_UP) {
+        return;
+    }
+    if (bssid != nullptr) {
+        memcpy(currentBssid, bssid, sizeof(currentBssid));
+    }
+    currentChannel = channel;
+    networks[current].successes++;
+    networks[current].failStreak = 0;
+    lastGood = current;
+    candidateCount = 0;
+    nextCandidate = 0;
+    backoffMs = WIFI_BACKOFF_MIN_MS;
+
+    if (roaming) {
+        roamCount++;   // The link stayed up as far as users are concerned
+    } else {
+        if (connectCount > 0) {
+            reconnectCount++;
+        }
+        connectCount++;
+        outageMs = now - downSince;
+        upSince = now;
+    }
+    roaming = false;
+    linkState = LINK_UP;
+    stateSince = now;
+    lastRoamScan = now;
+    weakSamples = 0;
+}
+
+void WifiLink::onDisconnected(uint32_t now, uint8_t reason) {
+    if (linkState == LINK_UP) {
+        disconnectCount++;
+        downSince = now;
+        // Straight back to the same access point first; a scan only if that fails
+        candidateCount = 0;
+        nextCandidate = 0;
+        if (current >= 0) {
+            candidates[0].network = (uint8_t)current;
+            candidates[0].rssi = currentRssi;
+            candidates[0].channel = currentChannel;
+            memcpy(candidates[0].bssid, currentBssid, sizeof(currentBssid));
+            candidateCount = 1;
+        }
+        backoffMs = WIFI_BACKOFF_MIN_MS;
+        goDown(now, WIFI_RECONNECT_DELAY_MS);
+    } else if (linkState == LINK_CONNECTING && reason != WIFI_REASON_ASSOC_LEAVE) {
+        attemptFailed(now);
+    }
+}
+
+void WifiLink::onScanDone(uint32_t now, const WifiScanResult* results, uint8_t count) {
+    bool forLink = linkState == LINK_SCANNING;
+    bool forRoam = linkState == LINK_UP && roamScanActive;
+    if (!forLink && !forRoam) {
+        return;   // Overtaken by a link change
+    }
+
+    for (uint8_t n = 0; n < numNetworks; n++) {
+        networks[n].lastRssi = 0;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (results[i].network < numNetworks) {
+            int8_t& seen = networks[results[i].network].lastRssi;
+            if (seen == 0 || results[i].rssi > seen) {
+                seen = results[i].rssi;
+            }
+        }
+    }
+
+    if (forLink) {
+        rankCandidates(results, count);
+        if (candidateCount == 0) {
+            goDown(now, backoffMs);
+            backoffMs = backoffMs * 2 < WIFI_BACKOFF_MAX_MS ? backoffMs * 2 : WIFI_BACKOFF_MAX_MS;
+        } else {
+            goDown(now, 0);
+        }
+        return;
+    }
+
+    // Roam only to a clearly better access point, so two similar ones don't ping-pong
+    roamScanActive = false;
+    lastRoamScan = now;
+    int best = -1;
+    int bestScore = score((uint8_t)current, currentRssi) + WIFI_ROAM_HYSTERESIS_DB;
+    for (uint8_t i = 0; i < count; i++) {
+        const WifiScanResult& r = results[i];
+        if (r.network >= numNetworks || memcmp(r.bssid, currentBssid, sizeof(currentBssid)) == 0) {
+            continue;
+        }
+        int s = score(r.network, r.rssi);
+        if (s >= bestScore) {
+            best = i;
+            bestScore = s;
+        }
+    }
+    if (best >= 0) {
+        candidates[0].network = results[best].network;
+        candidates[0].rssi = results[best].rssi;
+        candidates[0].channel = results[best].channel;
+        memcpy(candidates[0].bssid, results[best].bssid, sizeof(candidates[0].bssid));
+        candidateCount = 1;
+        nextCandidate = 0;
+        roaming = true;
+    }
+}
+
+void WifiLink::onRssi(uint32_t now, int8_t rssi) {
+    if (linkState != LINK_UP) {
+        return;
+    }
+    currentRssi = rssi;
+    history.push(rssi);
+    weakSamples = rssi < WIFI_ROAM_RSSI_DBM ? (uint8_t)(weakSamples + (weakSamples < 255)) : 0;
+    if (weakSamples >= WIFI_ROAM_WEAK_SAMPLES && !roamScanActive && !roaming &&
+        now - lastRoamScan >= WIFI_ROAM_SCAN_INTERVAL_MS) {
+        roamScanWanted = true;
+    }
+}
+
+WifiLinkAction WifiLink::poll(uint32_t now) {
+    WifiLinkAction none;
+    memset(&none, 0, sizeof(none));
+
+    switch (linkState) {
+    case LINK_UP:
+        if (roaming && nextCandidate < candidateCount) {
+            return connectTo(now, candidates[nextCandidate++]);
+        }
+        if (roamScanActive && now - stateSince >= WIFI_SCAN_TIMEOUT_MS) {
+            roamScanActive = false;
+            lastRoamScan = now;
+        }
+        if (roamScanWanted) {
+            roamScanWanted = false;
+            roamScanActive = true;
+            stateSince = now;
+            none.type = LINK_ACTION_SCAN;
+        }
+        return none;
+
+    case LINK_SCANNING:
+        if (now - stateSince >= WIFI_SCAN_TIMEOUT_MS) {
+            onScanDone(now, nullptr, 0);
+        }
+        break;
+
+    case LINK_CONNECTING:
+        if (now - stateSince >= WIFI_CONNECT_TIMEOUT_MS) {
+            attemptFailed(now);
+        }
+        break;
+
+    case LINK_DOWN:
+        break;
+    }
+
+    if (linkState != LINK_DOWN || !due(now, retryAt) || numNetworks == 0) {
+        return none;
+    }
+    if (nextCandidate < candidateCount) {
+        return connectTo(now, candidates[nextCandidate++]);
+    }
+    linkState = LINK_SCANNING;
+    stateSince = now;
+    none.type = LINK_ACTION_SCAN;
+    return none;
+}
+
+uint32_t WifiLink::retryInMs(uint32_t now) const {
+    if (linkState != LINK_DOWN || due(now, retryAt)) {
+        return 0;
+    }
+    return retryAt - now;
+}
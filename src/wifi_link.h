@@ -0,0 +1,165 @@
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Connection manager state machine. The device side feeds it WiFi events,
+// scan results and RSSI samples and carries out the actions poll() returns,
+// so the whole policy (backoff, network ranking, roaming) runs on the host
+// against a scripted event stream. Times are millis(). No Arduino dependencies.
+
+#define WIFI_REASON_ASSOC_LEAVE 8      // We left, e.g. WiFi.begin() to another access point
+
+enum WifiLinkState : uint8_t {
+    LINK_DOWN = 0,      // Waiting for the next attempt
+    LINK_SCANNING,
+    LINK_CONNECTING,
+    LINK_UP
+};
+
+// "down", "scanning", "connecting", "up"
+const char* wifiLinkStateName(uint8_t state);
+
+enum WifiLinkActionType : uint8_t {
+    LINK_ACTION_NONE = 0,
+    LINK_ACTION_SCAN,       // Start an asynchronous scan, report it with onScanDone()
+    LINK_ACTION_CONNECT     // Join network (bssid on channel; channel 0 lets the driver search)
+};
+
+struct WifiLinkAction {
+    WifiLinkActionType type;
+    uint8_t network;
+    uint8_t channel;
+    uint8_t bssid[6];
+};
+
+// A scan hit for one of the configured networks
+struct WifiScanResult {
+    uint8_t network;
+    int8_t rssi;
+    uint8_t channel;
+    uint8_t bssid[6];
+};
+
+struct WifiNetworkStats {
+    uint32_t successes;
+    uint32_t failures;
+    uint8_t failStreak;     // Failed attempts since the last success
+    int8_t lastRssi;        // Seen in the last scan, 0 = not seen
+};
+
+// Signal strength samples while the link is up, oldest first
+class RssiHistory {
+public:
+    RssiHistory() : head(0), used(0) {}
+    void push(int8_t rssi);
+    uint8_t count() const { return used; }
+    int8_t at(uint8_t i) const;
+
+private:
+    int8_t samples[WIFI_RSSI_HISTORY];
+    uint8_t head;
+    uint8_t used;
+};
+
+class WifiLink {
+public:
+    WifiLink();
+
+    // network is the one the boot join reached, or -1 if it failed
+    void begin(uint8_t networkCount, uint32_t now, int network, const uint8_t* bssid, uint8_t channel);
+
+    void onConnected(uint32_t now, const uint8_t* bssid, uint8_t channel);   // Got an address
+    void onDisconnected(uint32_t now, uint8_t reason);
+    void onScanDone(uint32_t now, const WifiScanResult* results, uint8_t count);
+    void onRssi(uint32_t now, int8_t rssi);
+
+    // Timeouts and retries; at most one action per call
+    WifiLinkAction poll(uint32_t now);
+
+    WifiLinkState state() const { return linkState; }
+    bool online() const { return linkState == LINK_UP || (linkState == LINK_CONNECTING && roaming); }
+    int network() const { return current; }
+    uint8_t channel() const { return currentChannel; }
+    const uint8_t* bssid() const { return currentBssid; }
+    uint32_t uptimeMs(uint32_t now) const { return linkState == LINK_UP ? now - upSince : 0; }
+    uint32_t lastOutageMs() const { return outageMs; }
+    uint32_t retryInMs(uint32_t now) const;
+
+    uint32_t connects() const { return connectCount; }
+    uint32_t reconnects() const { return reconnectCount; }
+    uint32_t disconnects() const { return disconnectCount; }
+    uint32_t roams() const { return roamCount; }
+    uint32_t failedAttempts() const { return failedCount; }
+    uint8_t networkCount() const { return numNetworks; }
+    const WifiNetworkStats& networkStats(uint8_t i) const { return networks[i]; }
+    const RssiHistory& rssiHistory() const { return history; }
+
+private:
+    struct Candidate {
+        uint8_t network;
+        int8_t rssi;        // 0 for a blind attempt
+        uint8_t channel;
+        uint8_t bssid[6];
+    };
+
+    WifiLinkState linkState;
+    uint8_t numNetworks;
+    WifiNetworkStats networks[WIFI_MAX_NETWORKS];
+    int current;             // Network of the link or attempt, -1 none
+    int lastGood;
+    uint8_t currentBssid[6];
+    uint8_t currentChannel;
+
+    Candidate candidates[WIFI_MAX_CANDIDATES];
+    uint8_t candidateCount;
+    uint8_t nextCandidate;
+    bool roaming;            // Current attempt moves an up link to another access point
+    bool roamScanWanted;
+    bool roamScanActive;
+
+    uint32_t stateSince;     // Scan or attempt start
+    uint32_t retryAt;
+    uint32_t backoffMs;
+    uint32_t upSince;
+    uint32_t downSince;
+    uint32_t outageMs;
+    uint32_t lastRoamScan;
+    uint8_t weakSamples;
+    int8_t currentRssi;
+    RssiHistory history;
+
+    uint32_t connectCount;
+    uint32_t reconnectCount;
+    uint32_t disconnectCount;
+    uint32_t roamCount;
+    uint32_t failedCount;
+
+    int score(uint8_t network, int8_t rssi) const;
+    void rankCandidates(const WifiScanResult* results, uint8_t count);
+    void attemptFailed(uint32_t now);
+    void goDown(uint32_t now, uint32_t delayMs);
+    WifiLinkAction connectTo(uint32_t now, const Candidate& candidate);
+};
+
+// Everything /wifi and /metrics report about the link
+struct WifiLinkSnapshot {
+    uint8_t state;               // WifiLinkState
+    int8_t network;              // -1 when none
+    uint8_t channel;
+    uint8_t bssid[6];
+    uint32_t uptimeSeconds;
+    uint32_t lastOutageMs;
+    uint32_t connects;
+    uint32_t reconnects;
+    uint32_t disconnects;
+    uint32_t roams;
+    uint32_t failedAttempts;
+    uint8_t networkCount;
+    const char* ssids[WIFI_MAX_NETWORKS];
+    WifiNetworkStats networks[WIFI_MAX_NETWORKS];
+    RssiHistory rssi;
+};
+
+#endif // WIFI_LINK_H
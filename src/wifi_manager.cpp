@@ -0,0 +1,266 @@
+#include "wifi_manager.h"
+#include "wifi_cache.h"
+
+WifiLink WifiManager::link;
+const WifiNetwork* WifiManager::networks = nullptr;
+uint8_t WifiManager::networkCount = 0;
+TaskHandle_t WifiManager::task = nullptr;
+WifiManager::Event WifiManager::events[WIFI_EVENT_QUEUE];
+uint8_t WifiManager::eventHead = 0;
+uint8_t WifiManager::eventCount = 0;
+uint32_t WifiManager::eventsDropped = 0;
+uint32_t WifiManager::connectsSeen = 0;
+volatile bool WifiManager::linkOnline = false;
+
+static portMUX_TYPE wifiMux = portMUX_INITIALIZER_UNLOCKED;
+
+enum : uint8_t {
+    EVENT_GOT_IP = 1,
+    EVENT_DISCONNECTED
+};
+
+// Owned by the manager task
+static bool scanRunning = false;
+static WifiScanResult scanResults[16];
+
+int WifiManager::findNetwork(const String& ssid) {
+    for (uint8_t i = 0; i < networkCount; i++) {
+        if (ssid == networks[i].ssid) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void WifiManager::begin(const WifiNetwork* list, uint8_t count) {
+    networks = list;
+    networkCount = count < WIFI_MAX_NETWORKS ? count : WIFI_MAX_NETWORKS;
+    WiFi.setAutoReconnect(false);   // Reconnection is ours, with backoff and a choice of network
+
+    int current = -1;
+    uint8_t bssid[6] = {0};
+    uint8_t channel = 0;
+    if (WiFi.status() == WL_CONNECTED) {
+        current = findNetwork(WiFi.SSID());
+        if (WiFi.BSSID() != nullptr) {
+            memcpy(bssid, WiFi.BSSID(), sizeof(bssid));
+        }
+        channel = (uint8_t)WiFi.channel();
+    }
+
+    portENTER_CRITICAL(&wifiMux);
+    link.begin(networkCount, millis(), current, bssid, channel);
+    connectsSeen = link.connects();
+    linkOnline = link.online();
+    portEXIT_CRITICAL(&wifiMux);
+
+    WiFi.onEvent(onEvent);
+    if (xTaskCreatePinnedToCore(managerTask, "wifi", WIFI_TASK_STACK, nullptr, WIFI_TASK_PRIORITY, &task,
+                                WIFI_TASK_CORE) != pdPASS) {
+        Serial.println("WiFi manager: failed to create task");
+        task = nullptr;
+        return;
+    }
+    Serial.printf("WiFi manager: %u networks, %s\n", networkCount,
+                 linkOnline ? "online" : "offline, retrying in the background");
+}
+
+// Runs in the WiFi event task; the state machine runs in managerTask
+void WifiManager::onEvent(arduino_event_t* event) {
+    Event e = {0, 0};
+    if (event->event_id == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        e.type = EVENT_GOT_IP;
+    } else if (event->event_id == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        e.type = EVENT_DISCONNECTED;
+        e.reason = event->event_info.wifi_sta_disconnected.reason;
+    } else {
+        return;
+    }
+
+    portENTER_CRITICAL(&wifiMux);
+    if (eventCount < WIFI_EVENT_QUEUE) {
+        events[(eventHead + eventCount) % WIFI_EVENT_QUEUE] = e;
+        eventCount++;
+    } else {
+        eventsDropped++;
+    }
+    portEXIT_CRITICAL(&wifiMux);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+void WifiManager::collectScan(uint32_t now) {
+    int16_t found = WiFi.scanComplete();
+    if (found == WIFI_SCAN_RUNNING) {
+        return;
+    }
+    scanRunning = false;
+
+    uint8_t count = 0;
+    for (int16_t i = 0; i < found && count < sizeof(scanResults) / sizeof(scanResults[0]); i++) {
+        int network = findNetwork(WiFi.SSID(i));
+        if (network < 0) {
+            continue;
+        }
+        WifiScanResult& r = scanResults[count++];
+        r.network = (uint8_t)network;
+        r.rssi = (int8_t)WiFi.RSSI(i);
+        r.channel = (uint8_t)WiFi.channel(i);
+        memcpy(r.bssid, WiFi.BSSID(i), sizeof(r.bssid));
+    }
+    WiFi.scanDelete();
+
+    portENTER_CRITICAL(&wifiMux);
+    link.onScanDone(now, scanResults, count);
+    portEXIT_CRITICAL(&wifiMux);
+}
+
+void WifiManager::execute(const WifiLinkAction& action) {
+    if (action.type == LINK_ACTION_SCAN) {
+        if (link.state() == LINK_SCANNING) {
+            WiFi.disconnect();   // Stop a timed-out attempt the driver may still be making
+        }
+        // Asynchronous, so events keep flowing; collectScan() picks up the result
+        scanRunning = WiFi.scanNetworks(true, false, false, WIFI_SCAN_MS_PER_CHANNEL) == WIFI_SCAN_RUNNING;
+        if (!scanRunning) {
+            portENTER_CRITICAL(&wifiMux);
+            link.onScanDone(millis(), nullptr, 0);
+            portEXIT_CRITICAL(&wifiMux);
+        }
+    } else if (action.type == LINK_ACTION_CONNECT) {
+        const WifiNetwork& network = networks[action.network];
+        // The static address belongs to the primary network; everywhere else (and
+        // instead of a lease the boot join reused) the address comes from DHCP
+        WifiAddressConfig fixed = wifiStaticAddress();
+        if (action.network == 0 && fixed.ip != 0) {
+            WiFi.config(IPAddress(fixed.ip), IPAddress(fixed.gateway), IPAddress(fixed.subnet),
+                        IPAddress(fixed.dns));
+        } else {
+            WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+        }
+        Serial.printf("WiFi: connecting to %s (channel %u)\n", network.ssid, action.channel);
+        if (action.channel != 0) {
+            WiFi.begin(network.ssid, network.password, action.channel, action.bssid);
+        } else {
+            WiFi.begin(network.ssid, network.password);
+        }
+    }
+}
+
+void WifiManager::managerTask(void* arg) {
+    uint32_t lastRssiSample = millis();
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WIFI_MANAGER_TICK_MS));
+        uint32_t now = millis();
+
+        for (;;) {
+            Event e;
+            bool pending = false;
+            portENTER_CRITICAL(&wifiMux);
+            if (eventCount > 0) {
+                e = events[eventHead];
+                eventHead = (uint8_t)((eventHead + 1) % WIFI_EVENT_QUEUE);
+                eventCount--;
+                pending = true;
+            }
+            portEXIT_CRITICAL(&wifiMux);
+            if (!pending) {
+                break;
+            }
+
+            if (e.type == EVENT_GOT_IP) {
+                uint8_t bssid[6] = {0};
+                if (WiFi.BSSID() != nullptr) {
+                    memcpy(bssid, WiFi.BSSID(), sizeof(bssid));
+                }
+                uint8_t channel = (uint8_t)WiFi.channel();
+                portENTER_CRITICAL(&wifiMux);
+                link.onConnected(now, bssid, channel);
+                portEXIT_CRITICAL(&wifiMux);
+                Serial.printf("WiFi: online on channel %u, %ld dBm\n", channel, (long)WiFi.RSSI());
+            } else {
+                portENTER_CRITICAL(&wifiMux);
+                bool wasUp = link.state() == LINK_UP;
+                link.onDisconnected(now, e.reason);
+                portEXIT_CRITICAL(&wifiMux);
+                if (wasUp) {
+                    Serial.printf("WiFi: link lost (reason %u)\n", e.reason);
+                }
+            }
+        }
+
+        if (scanRunning) {
+            collectScan(now);
+        }
+        if (link.state() == LINK_UP && now - lastRssiSample >= WIFI_RSSI_SAMPLE_MS) {
+            lastRssiSample = now;
+            int8_t rssi = (int8_t)WiFi.RSSI();
+            portENTER_CRITICAL(&wifiMux);
+            link.onRssi(now, rssi);
+            portEXIT_CRITICAL(&wifiMux);
+        }
+
+        portENTER_CRITICAL(&wifiMux);
+        WifiLinkAction action = link.poll(now);
+        linkOnline = link.online();
+        portEXIT_CRITICAL(&wifiMux);
+        execute(action);
+    }
+}
+
+bool WifiManager::online() {
+    return linkOnline;
+}
+
+bool WifiManager::takeReconnected() {
+    portENTER_CRITICAL(&wifiMux);
+    bool reconnected = link.online() && link.connects() != connectsSeen;
+    connectsSeen = link.connects();
+    portEXIT_CRITICAL(&wifiMux);
+    return reconnected;
+}
+
+void WifiManager::snapshot(WifiLinkSnapshot* out) {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&wifiMux);
+    out->state = link.state();
+    out->network = (int8_t)link.network();
+    out->channel = link.channel();
+    memcpy(out->bssid, link.bssid(), sizeof(out->bssid));
+    out->uptimeSeconds = link.uptimeMs(now) / 1000;
+    out->lastOutageMs = link.lastOutageMs();
+    out->connects = link.connects();
+    out->reconnects = link.reconnects();
+    out->disconnects = link.disconnects();
+    out->roams = link.roams();
+    out->failedAttempts = link.failedAttempts();
+    out->networkCount = link.networkCount();
+    for (uint8_t i = 0; i < out->networkCount; i++) {
+        out->ssids[i] = networks[i].ssid;
+        out->networks[i] = link.networkStats(i);
+    }
+    out->rssi = link.rssiHistory();
+    portEXIT_CRITICAL(&wifiMux);
+}
+
+void WifiManager::report() {
+    if (task == nullptr) {
+        return;
+    }
+    static WifiLinkSnapshot s;   // Too big for the caller's stack to spare
+    snapshot(&s);
+    int minRssi = 0;
+    int sum = 0;
+    for (uint8_t i = 0; i < s.rssi.count(); i++) {
+        minRssi = i == 0 || s.rssi.at(i) < minRssi ? s.rssi.at(i) : minRssi;
+        sum += s.rssi.at(i);
+    }
+    Serial.printf("WiFi: %s, %s ch %u for %lus, rssi avg %d min %d (%u samples), %lu reconnects, "
+                 "%lu drops, %lu roams, %lu failed attempts, last outage %lu ms, stack free %u\n",
+                 wifiLinkStateName(s.state), s.network >= 0 ? s.ssids[s.network] : "-", s.channel,
+                 (unsigned long)s.uptimeSeconds, s.rssi.count() ? sum / s.rssi.count() : 0, minRssi,
+                 s.rssi.count(), (unsigned long)s.reconnects, (unsigned long)s.disconnects,
+                 (unsigned long)s.roams, (unsigned long)s.failedAttempts, (unsigned long)s.lastOutageMs,
+                 (unsigned)uxTaskGetStackHighWaterMark(task));
+}
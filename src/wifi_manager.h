@@ -0,0 +1,58 @@
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "wifi_link.h"
+
+struct WifiNetwork {
+    const char* ssid;
+    const char* password;
+};
+
+// Keeps the station online after boot. WiFi events are queued to a task on
+// the network core that runs the WifiLink state machine: reconnects with
+// backoff, ranks the configured networks by signal and past success, and
+// roams off a weak access point. loop() only ever reads the state.
+class WifiManager {
+public:
+    // After the boot join, whether or not it succeeded
+    static void begin(const WifiNetwork* networks, uint8_t count);
+
+    static bool online();
+
+    // True once per return to online after an outage (or a failed boot join)
+    static bool takeReconnected();
+
+    static void snapshot(WifiLinkSnapshot* out);
+
+    // Perf report section
+    static void report();
+
+private:
+    struct Event {
+        uint8_t type;
+        uint8_t reason;
+    };
+
+    static WifiLink link;
+    static const WifiNetwork* networks;
+    static uint8_t networkCount;
+    static TaskHandle_t task;
+    static Event events[WIFI_EVENT_QUEUE];
+    static uint8_t eventHead;
+    static uint8_t eventCount;
+    static uint32_t eventsDropped;
+    static uint32_t connectsSeen;
+    static volatile bool linkOnline;
+
+    static int findNetwork(const String& ssid);
+    static void onEvent(arduino_event_t* event);
+    static void managerTask(void* arg);
+    static void execute(const WifiLinkAction& action);
+    static void collectScan(uint32_t now);
+};
+
+#endif // WIFI_MANAGER_H
@@ -0,0 +1,87 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core the native build uses
+// (pio test -e native). millis() follows the host clock plus whatever a test
+// skips with hostAdvanceMillis(), so caches can age without waiting.
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+inline const std::chrono::steady_clock::time_point hostClockStart = std::chrono::steady_clock::now();
+inline std::atomic<uint32_t> hostClockSkipped{0};
+
+inline uint32_t millis() {
+    auto elapsed = std::chrono::steady_clock::now() - hostClockStart;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() + hostClockSkipped;
+}
+
+inline void hostAdvanceMillis(uint32_t ms) {
+    hostClockSkipped += ms;
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline uint32_t esp_random() {
+    static std::atomic<uint32_t> state{0x2545F491};
+    uint32_t x = state.fetch_add(0x9E3779B9) + 0x9E3779B9;
+    x ^= x >> 16;
+    x *= 0x7FEB352D;
+    x ^= x >> 15;
+    return x;
+}
+
+class String : public std::string {
+public:
+    String() {}
+    String(const char* s) : std::string(s) {}
+    String(const std::string& s) : std::string(s) {}
+};
+
+class HardwareSerial {
+public:
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        int n = vprintf(format, args);
+        va_end(args);
+        return n;
+    }
+    size_t print(const char* s) { return (size_t)::printf("%s", s); }
+    size_t println(const char* s = "") { return (size_t)::printf("%s\n", s); }
+};
+
+inline HardwareSerial Serial;
+
+// Four octets, the first in the low byte as on the device
+class IPAddress {
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint32_t value) : address(value) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+
+    operator uint32_t() const { return address; }
+    bool operator==(const IPAddress& other) const { return address == other.address; }
+    bool operator!=(const IPAddress& other) const { return address != other.address; }
+    uint8_t operator[](int i) const { return (uint8_t)(address >> (8 * i)); }
+
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(text);
+    }
+
+private:
+    uint32_t address;
+};
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,28 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Host stand-in for the station interface: tests set the link status and
+// the DHCP DNS servers directly.
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+    std::atomic<wl_status_t> hostStatus{WL_CONNECTED};
+    IPAddress hostDns[2];
+
+    wl_status_t status() const { return hostStatus; }
+    IPAddress dnsIP(uint8_t i = 0) const { return i < 2 ? hostDns[i] : IPAddress(); }
+};
+
+inline WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
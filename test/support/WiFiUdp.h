@@ -0,0 +1,114 @@
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+// Host stand-in for WiFiUDP on a POSIX datagram socket. Privileged
+// destination ports (below 1024) are shifted by hostUdpPortOffset, and
+// remotePort() shifts them back, so a test can stand in for a DNS server
+// on an ephemeral loopback port.
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+inline std::atomic<uint16_t> hostUdpPortOffset{0};
+
+class WiFiUDP {
+public:
+    WiFiUDP() : fd(-1), outLen(0), inLen(0), inPos(0), remoteAddress(0), remotePortNumber(0) {}
+    ~WiFiUDP() { stop(); }
+    WiFiUDP(const WiFiUDP&) = delete;
+    WiFiUDP& operator=(const WiFiUDP&) = delete;
+
+    uint8_t begin(uint16_t port) {
+        stop();
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            return 0;
+        }
+        sockaddr_in local = {};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        local.sin_port = htons(port);
+        if (bind(fd, (sockaddr*)&local, sizeof(local)) != 0) {
+            stop();
+            return 0;
+        }
+        return 1;
+    }
+
+    void stop() {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    int beginPacket(IPAddress ip, uint16_t port) {
+        if (fd < 0) {
+            return 0;
+        }
+        destination = {};
+        destination.sin_family = AF_INET;
+        destination.sin_addr.s_addr = (uint32_t)ip;   // Same byte order on both sides
+        destination.sin_port = htons(port < 1024 ? (uint16_t)(port + hostUdpPortOffset) : port);
+        outLen = 0;
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = size < sizeof(out) - outLen ? size : sizeof(out) - outLen;
+        memcpy(out + outLen, buffer, n);
+        outLen += n;
+        return n;
+    }
+
+    int endPacket() {
+        ssize_t sent = sendto(fd, out, outLen, 0, (const sockaddr*)&destination, sizeof(destination));
+        return sent == (ssize_t)outLen ? 1 : 0;
+    }
+
+    // Size of the next datagram, 0 if none is waiting
+    int parsePacket() {
+        if (fd < 0) {
+            return 0;
+        }
+        sockaddr_in from = {};
+        socklen_t fromLen = sizeof(from);
+        ssize_t n = recvfrom(fd, in, sizeof(in), MSG_DONTWAIT, (sockaddr*)&from, &fromLen);
+        if (n <= 0) {
+            return 0;
+        }
+        inLen = (size_t)n;
+        inPos = 0;
+        remoteAddress = from.sin_addr.s_addr;
+        uint16_t port = ntohs(from.sin_port);
+        uint16_t offset = hostUdpPortOffset;
+        remotePortNumber = offset != 0 && port >= offset && port - offset < 1024 ? (uint16_t)(port - offset) : port;
+        return (int)n;
+    }
+
+    int read(uint8_t* buffer, size_t len) {
+        size_t n = len < inLen - inPos ? len : inLen - inPos;
+        memcpy(buffer, in + inPos, n);
+        inPos += n;
+        return (int)n;
+    }
+
+    IPAddress remoteIP() const { return IPAddress(remoteAddress); }
+    uint16_t remotePort() const { return remotePortNumber; }
+
+private:
+    int fd;
+    sockaddr_in destination;
+    uint8_t out[1472];
+    size_t outLen;
+    uint8_t in[1472];
+    size_t inLen;
+    size_t inPos;
+    uint32_t remoteAddress;
+    uint16_t remotePortNumber;
+};
+
+#endif // HOST_WIFIUDP_H
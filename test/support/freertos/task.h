@@ -0,0 +1,57 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+// Host stand-in for tasks and direct-to-task notifications: each task is a
+// detached thread that lives as long as the process, like a firmware task
+// that never returns.
+
+#include "freertos/FreeRTOS.h"
+#include <condition_variable>
+
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+};
+
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline thread_local HostTask* hostCurrentTask = nullptr;
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                          void* arg, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    HostTask* task = new HostTask();
+    if (handle != nullptr) {
+        *handle = task;
+    }
+    std::thread([function, arg, task]() {
+        hostCurrentTask = task;
+        function(arg);
+    }).detach();
+    return pdPASS;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notifications++;
+    task->wake.notify_one();
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    HostTask* task = hostCurrentTask;
+    std::unique_lock<std::mutex> guard(task->lock);
+    auto notified = [task]() { return task->notifications > 0; };
+    if (ticksToWait == portMAX_DELAY) {
+        task->wake.wait(guard, notified);
+    } else {
+        task->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait), notified);
+    }
+    uint32_t count = task->notifications;
+    if (count > 0) {
+        task->notifications = clearOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+#endif // HOST_FREERTOS_TASK_H
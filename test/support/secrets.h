@@ -0,0 +1,3 @@
+// Placeholder credentials for the host tests (pio test -e native), so they
+// build without a real include/secrets.h
+#include "secrets_template.h"
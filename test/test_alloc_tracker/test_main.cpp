@@ -0,0 +1,144 @@
+#include <unity.h>
+#include <stdlib.h>
+#include "alloc_tracker.h"
+#include "json_allocator.h"
+
+// Host heap: a fixed pool that exact allocations and "other" allocations
+// (code outside any exact allocator, or another task) both draw from
+static int32_t untracked;
+
+static uint32_t hostFreeHeap() {
+    int32_t exact = 0;
+    for (int tag = 0; tag < ALLOC_TAG_COUNT; tag++) {
+        exact += AllocTracker::stats(tag).current;
+    }
+    return (uint32_t)(200000 - exact - untracked);
+}
+
+static const char OWM_RESPONSE[] =
+    "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},\"weather\":[{\"id\":803,\"main\":\"Clouds\","
+    "\"description\":\"broken clouds\",\"icon\":\"04d\"}],\"base\":\"stations\",\"main\":{\"temp\":14.2,"
+    "\"feels_like\":13.6,\"temp_min\":12.9,\"temp_max\":15.4,\"pressure\":1014,\"humidity\":77,"
+    "\"sea_level\":1014,\"grnd_level\":1010},\"visibility\":10000,\"wind\":{\"speed\":4.6,\"deg\":240,"
+    "\"gust\":7.2},\"clouds\":{\"all\":75},\"dt\":1729166400,\"sys\":{\"type\":2,\"id\":2075535,"
+    "\"country\":\"GB\",\"sunrise\":1729146958,\"sunset\":1729185043},\"timezone\":3600,"
+    "\"id\":2643743,\"name\":\"London\",\"cod\":200}";
+
+void setUp() {
+    AllocTracker::reset();
+    AllocTracker::setHeapProbe(hostFreeHeap);
+    untracked = 0;
+}
+
+void tearDown() {}
+
+void test_exact_allocations_per_tag() {
+    void* a = trackedMalloc(100, ALLOC_TAG_JSON);
+    void* b = trackedMalloc(50, ALLOC_TAG_NETWORK);
+    a = trackedRealloc(a, 300);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_EQUAL_INT32(300, AllocTracker::stats(ALLOC_TAG_JSON).current);
+    TEST_ASSERT_EQUAL_INT32(300, AllocTracker::stats(ALLOC_TAG_JSON).peak);
+    TEST_ASSERT_EQUAL_INT32(50, AllocTracker::stats(ALLOC_TAG_NETWORK).current);
+    trackedFree(a);
+    trackedFree(b);
+    trackedFree(nullptr);
+    const AllocTagStats& json = AllocTracker::stats(ALLOC_TAG_JSON);
+    TEST_ASSERT_EQUAL_INT32(0, json.current);
+    TEST_ASSERT_EQUAL_INT32(300, json.peak);
+    TEST_ASSERT_EQUAL_UINT32(2, json.count);   // malloc + realloc
+    TEST_ASSERT_EQUAL_UINT32(2, json.frees);
+    TEST_ASSERT_TRUE(AllocTracker::withinBudget(ALLOC_TAG_JSON, 300));
+    TEST_ASSERT_FALSE(AllocTracker::withinBudget(ALLOC_TAG_JSON, 299));
+}
+
+void test_realloc_of_null_uses_scope_tag() {
+    AllocScope scope(ALLOC_TAG_NETWORK);
+    void* p = trackedRealloc(nullptr, 64);
+    TEST_ASSERT_EQUAL_INT32(64, AllocTracker::stats(ALLOC_TAG_NETWORK).current);
+    trackedFree(p);
+}
+
+void test_json_document_within_budget() {
+    {
+        JsonDocument doc(TrackingJsonAllocator::instance());
+        DeserializationError error = deserializeJson(doc, OWM_RESPONSE);
+        TEST_ASSERT_FALSE(error);
+        TEST_ASSERT_EQUAL_INT(77, doc["main"]["humidity"].as<int>());
+        TEST_ASSERT_GREATER_THAN(0, AllocTracker::stats(ALLOC_TAG_JSON).current);
+    }
+    const AllocTagStats& json = AllocTracker::stats(ALLOC_TAG_JSON);
+    TEST_ASSERT_EQUAL_INT32(0, json.current);   // Everything went back through the allocator
+    TEST_ASSERT_GREATER_THAN(0, json.count);
+    TEST_ASSERT_EQUAL_UINT32(json.count, json.frees);
+    TEST_ASSERT_TRUE_MESSAGE(AllocTracker::withinBudget(ALLOC_TAG_JSON, ALLOC_BUDGET_JSON),
+                             "JSON document over ALLOC_BUDGET_JSON");
+    TEST_ASSERT_TRUE(AllocTracker::withinBudget(ALLOC_TAG_OTHER, 0));
+    TEST_ASSERT_TRUE(AllocTracker::withinBudget(ALLOC_TAG_NETWORK, 0));
+}
+
+void test_scope_growth_excludes_exact_and_nested() {
+    {
+        AllocScope outer(ALLOC_TAG_NETWORK);
+        untracked += 1000;                       // e.g. a client object
+        void* p = trackedMalloc(400, ALLOC_TAG_JSON);
+        {
+            AllocScope inner(ALLOC_TAG_DISPLAY);
+            untracked += 250;
+        }
+        trackedFree(p);
+        void* q = trackedMalloc(100, ALLOC_TAG_JSON);   // Still held at the end of the scope
+        trackedFree(q);
+    }
+    TEST_ASSERT_EQUAL_INT32(1000, AllocTracker::stats(ALLOC_TAG_NETWORK).scopeMaxGrowth);
+    TEST_ASSERT_EQUAL_INT32(250, AllocTracker::stats(ALLOC_TAG_DISPLAY).scopeMaxGrowth);
+    TEST_ASSERT_EQUAL_UINT32(1, AllocTracker::stats(ALLOC_TAG_NETWORK).scopeRuns);
+    // Scopes never touch the exact figures
+    TEST_ASSERT_EQUAL_INT32(0, AllocTracker::stats(ALLOC_TAG_NETWORK).peak);
+    TEST_ASSERT_EQUAL_INT32(0, AllocTracker::stats(ALLOC_TAG_DISPLAY).peak);
+    TEST_ASSERT_EQUAL_INT32(400, AllocTracker::stats(ALLOC_TAG_JSON).peak);
+}
+
+void test_concurrent_churn_stays_out_of_budgets() {
+    // A draw() scope every frame while another task allocates and frees:
+    // the free-heap delta picks the churn up, the exact figures don't
+    srand(1);
+    int32_t largest = 0;
+    for (int frame = 0; frame < 10000; frame++) {
+        AllocScope scope(ALLOC_TAG_DISPLAY);
+        int32_t churn = (rand() % 2001) - 1000;   // Other task, +-1 KB
+        if (untracked + churn < 0) churn = -untracked;
+        untracked += churn;
+        if (churn > largest) largest = churn;
+    }
+    const AllocTagStats& display = AllocTracker::stats(ALLOC_TAG_DISPLAY);
+    TEST_ASSERT_EQUAL_UINT32(10000, display.scopeRuns);
+    TEST_ASSERT_EQUAL_INT32(largest, display.scopeMaxGrowth);   // Bounded by one run, no drift
+    TEST_ASSERT_EQUAL_INT32(0, display.current);
+    TEST_ASSERT_EQUAL_INT32(0, display.peak);
+    TEST_ASSERT_TRUE(AllocTracker::withinBudget(ALLOC_TAG_DISPLAY, 0));
+}
+
+void test_scope_depth_overflow_stays_balanced() {
+    for (int i = 0; i < ALLOC_SCOPE_DEPTH + 3; i++) {
+        AllocTracker::pushScope(ALLOC_TAG_LOGGING);
+    }
+    TEST_ASSERT_EQUAL(ALLOC_TAG_LOGGING, AllocTracker::currentTag());
+    for (int i = 0; i < ALLOC_SCOPE_DEPTH + 3; i++) {
+        AllocTracker::popScope();
+    }
+    AllocTracker::popScope();   // Unbalanced extra pop is ignored
+    TEST_ASSERT_EQUAL(ALLOC_TAG_OTHER, AllocTracker::currentTag());
+    TEST_ASSERT_EQUAL_UINT32(ALLOC_SCOPE_DEPTH, AllocTracker::stats(ALLOC_TAG_LOGGING).scopeRuns);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_exact_allocations_per_tag);
+    RUN_TEST(test_realloc_of_null_uses_scope_tag);
+    RUN_TEST(test_json_document_within_budget);
+    RUN_TEST(test_scope_growth_excludes_exact_and_nested);
+    RUN_TEST(test_concurrent_churn_stays_out_of_budgets);
+    RUN_TEST(test_scope_depth_overflow_stays_balanced);
+    return UNITY_END();
+}
@@ -0,0 +1,458 @@
+#include <unity.h>
+#include <stdint.h>
+#include <deque>
+#include "api_budget.h"
+
+static const uint32_t DAY_MS = 86400000UL;
+static const uint32_t EPOCH = 1699920000;   // A UTC midnight
+
+// The plan's limits as the server applies them: a sliding 60 s window and a
+// count per UTC day, 429 with Retry-After (when enabled) once either is spent
+struct StandInServer {
+    uint32_t perMinute;
+    uint32_t perDay;
+    bool sendRetryAfter;
+    std::deque<uint64_t> recent;
+    uint64_t day;
+    uint32_t dayCount;
+    uint32_t served;
+    uint32_t rejected;
+
+    StandInServer(uint32_t minuteCap, uint32_t dayCap, bool retryAfter)
+        : perMinute(minuteCap), perDay(dayCap), sendRetryAfter(retryAfter), day(0), dayCount(0), served(0),
+          rejected(0) {}
+
+    int handle(uint64_t nowS, uint32_t* retryAfterS) {
+        if (nowS / 86400 != day) {
+            day = nowS / 86400;
+            dayCount = 0;
+        }
+        while (!recent.empty() && recent.front() + 60 <= nowS) {
+            recent.pop_front();
+        }
+        *retryAfterS = 0;
+        if (recent.size() >= perMinute) {
+            rejected++;
+            if (sendRetryAfter) *retryAfterS = (uint32_t)(recent.front() + 60 - nowS);
+            return 429;
+        }
+        if (dayCount >= perDay) {
+            rejected++;
+            if (sendRetryAfter) *retryAfterS = (uint32_t)(86400 - nowS % 86400);
+            return 429;
+        }
+        recent.push_back(nowS);
+        dayCount++;
+        served++;
+        return 200;
+    }
+};
+
+static void spend(TokenBucket& bucket, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(bucket.take(1, 0));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_bucket_refill_is_exact_over_small_steps() {
+    TokenBucket t;
+    t.reset(API_CALLS_PER_DAY, DAY_MS, 0);
+    spend(t, API_CALLS_PER_DAY);
+    TEST_ASSERT_EQUAL(0, t.milliTokens());
+
+    // 86.4 s per token does not divide into 7 ms steps; the carry keeps it exact
+    for (uint32_t ms = 7; ms < DAY_MS / 2; ms += 7) {
+        t.update(ms);
+    }
+    t.update(DAY_MS / 2);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY * 1000 / 2, t.milliTokens());
+    t.update(DAY_MS);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY, t.tokens());
+    t.update(DAY_MS + 3600000);   // Stays full, no carry left over
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY * 1000, t.milliTokens());
+    TEST_ASSERT_TRUE(t.take(1, 0));
+    t.update(DAY_MS + 3600000 + 86399);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY - 1, t.tokens());
+    t.update(DAY_MS + 3600000 + 86400);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY, t.tokens());
+}
+
+void test_bucket_ms_until_matches_refill() {
+    TokenBucket t;
+    t.reset(60, 60000, 1000);
+    spend(t, 60);
+    TEST_ASSERT_EQUAL(1000, t.msUntil(1));
+    TEST_ASSERT_EQUAL(60000, t.msUntil(60));
+    TEST_ASSERT_EQUAL(0, t.msUntil(0));
+
+    TokenBucket day;
+    day.reset(API_CALLS_PER_DAY, DAY_MS, 0);
+    spend(day, API_CALLS_PER_DAY);
+    day.update(13);   // Leaves a carry to account for
+    uint32_t wait = day.msUntil(1);
+    day.update(13 + wait - 1);
+    TEST_ASSERT_EQUAL(0, day.tokens());
+    day.update(13 + wait);
+    TEST_ASSERT_EQUAL(1, day.tokens());
+
+    // Across the millis() wrap
+    TokenBucket wrap;
+    wrap.reset(60, 60000, 0xFFFFFC18u);   // 1 s before the wrap
+    spend(wrap, 60);
+    wrap.update(0x000003E8u);             // 1 s after
+    TEST_ASSERT_EQUAL(2, wrap.tokens());
+}
+
+void test_bucket_take_keep_and_set() {
+    TokenBucket t;
+    t.reset(10, 60000, 0);
+    TEST_ASSERT_FALSE(t.take(1, 10));   // Would dip below the 10 to keep
+    TEST_ASSERT_TRUE(t.take(1, 9));
+    TEST_ASSERT_TRUE(t.take(3, 6));
+    TEST_ASSERT_FALSE(t.take(1, 6));
+    TEST_ASSERT_EQUAL(6, t.tokens());
+
+    t.setMilliTokens(999999);   // Clamped to the capacity
+    TEST_ASSERT_EQUAL(10000, t.milliTokens());
+    t.setMilliTokens(2500);
+    TEST_ASSERT_EQUAL(2, t.tokens());
+    TEST_ASSERT_EQUAL(3000, t.msUntil(3));   // 500 milli-tokens at one per 6 ms
+    t.credit(3000);
+    TEST_ASSERT_EQUAL(3000, t.milliTokens());
+    t.drain();
+    TEST_ASSERT_EQUAL(0, t.milliTokens());
+}
+
+void test_reserves_keep_tokens_for_current_conditions() {
+    ApiBudget b;
+    b.reset(0);
+    uint32_t airQuality = 0, forecast = 0, current = 0;
+    while (b.acquire(API_REQUEST_AIR_QUALITY, 0)) airQuality++;
+    while (b.acquire(API_REQUEST_FORECAST, 0)) forecast++;
+    while (b.acquire(API_REQUEST_CURRENT, 0)) current++;
+
+    // 60 per minute: air quality leaves 25 % (15), forecasts 10 % (6), current takes the rest
+    TEST_ASSERT_EQUAL(45, airQuality);
+    TEST_ASSERT_EQUAL(9, forecast);
+    TEST_ASSERT_EQUAL(6, current);
+    TEST_ASSERT_EQUAL(1000, b.waitMs(API_REQUEST_CURRENT, 0));
+    TEST_ASSERT_EQUAL(7000, b.waitMs(API_REQUEST_FORECAST, 0));
+    TEST_ASSERT_EQUAL(16000, b.waitMs(API_REQUEST_AIR_QUALITY, 0));
+
+    ApiBudgetStatus s = b.status(0);
+    TEST_ASSERT_EQUAL(60, s.granted);
+    TEST_ASSERT_EQUAL(3, s.deferred);   // The refused acquire() ending each loop
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY - 60, s.dayRemaining);
+
+    TEST_ASSERT_TRUE(b.acquire(API_REQUEST_CURRENT, 1000));
+    TEST_ASSERT_FALSE(b.acquire(API_REQUEST_FORECAST, 1000));
+}
+
+void test_steady_fetching_is_never_held() {
+    ApiBudget b;
+    b.reset(0);
+    StandInServer server(API_CALLS_PER_MINUTE, API_CALLS_PER_DAY, true);
+    uint64_t ms = 0;
+    for (; ms < 5ULL * DAY_MS; ms += UPDATE_INTERVAL_MS) {   // Five days of scheduled fetches
+        TEST_ASSERT_EQUAL(0, b.waitMs(API_REQUEST_CURRENT, (uint32_t)ms));
+        TEST_ASSERT_TRUE(b.acquire(API_REQUEST_CURRENT, (uint32_t)ms));
+        uint32_t retryAfter;
+        int code = server.handle(EPOCH + ms / 1000, &retryAfter);
+        TEST_ASSERT_FALSE(b.onResponse(code, retryAfter, (uint32_t)ms));
+    }
+    TEST_ASSERT_EQUAL(0, server.rejected);
+    TEST_ASSERT_EQUAL(0, b.status((uint32_t)ms).deferred);
+}
+
+void test_retry_after_holds_every_kind() {
+    ApiBudget b;
+    b.reset(0);
+    TEST_ASSERT_TRUE(b.onResponse(429, 120, 1000));
+    TEST_ASSERT_EQUAL(120000, b.waitMs(API_REQUEST_CURRENT, 1000));
+    TEST_ASSERT_EQUAL(0, b.status(1000).minuteRemaining);   // The server's count wins
+    TEST_ASSERT_FALSE(b.acquire(API_REQUEST_CURRENT, 100000));
+    TEST_ASSERT_EQUAL(21, b.status(100000).holdSeconds);
+    TEST_ASSERT_TRUE(b.acquire(API_REQUEST_CURRENT, 121000));
+
+    // Longer than a day is cut to API_RETRY_AFTER_MAX_S
+    TEST_ASSERT_TRUE(b.onResponse(429, 10 * 86400, 200000));
+    TEST_ASSERT_EQUAL(API_RETRY_AFTER_MAX_S * 1000u, b.waitMs(API_REQUEST_AIR_QUALITY, 200000));
+
+    // 503 only holds with Retry-After, and isn't counted as throttling
+    ApiBudget c;
+    c.reset(0);
+    TEST_ASSERT_FALSE(c.onResponse(503, 0, 0));
+    TEST_ASSERT_EQUAL(0, c.waitMs(API_REQUEST_CURRENT, 0));
+    TEST_ASSERT_TRUE(c.onResponse(503, 30, 0));
+    TEST_ASSERT_EQUAL(30000, c.waitMs(API_REQUEST_CURRENT, 0));
+    ApiBudgetStatus s = c.status(0);
+    TEST_ASSERT_EQUAL(0, s.throttled);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_MINUTE, s.minuteRemaining);
+    TEST_ASSERT_FALSE(c.onResponse(500, 30, 0));
+}
+
+void test_backoff_without_retry_after() {
+    ApiBudget b;
+    b.reset(0);
+    const uint32_t expected[] = {60, 120, 240, 480, 960, 1920, 3600, 3600};
+    uint32_t now = 5000;
+    for (uint32_t seconds : expected) {
+        TEST_ASSERT_TRUE(b.onResponse(429, 0, now));
+        uint32_t wait = b.waitMs(API_REQUEST_CURRENT, now);
+        TEST_ASSERT_EQUAL(seconds * 1000, wait);
+        now += wait;
+    }
+    TEST_ASSERT_EQUAL(8, b.status(now).throttled);
+
+    // A success starts over; a Retry-After neither uses nor advances the backoff
+    b.onResponse(304, 0, now);
+    b.onResponse(429, 0, now);
+    TEST_ASSERT_EQUAL(API_BACKOFF_MAX_S * 1000u, b.waitMs(API_REQUEST_CURRENT, now));   // Not a success
+    b.onResponse(200, 0, now);
+    b.onResponse(429, 0, now);
+    TEST_ASSERT_EQUAL(API_BACKOFF_MIN_S * 1000u, b.waitMs(API_REQUEST_CURRENT, now));
+    b.onResponse(429, 5, now);
+    TEST_ASSERT_EQUAL(5000, b.waitMs(API_REQUEST_CURRENT, now));
+    b.onResponse(429, 0, now);
+    TEST_ASSERT_EQUAL(2 * API_BACKOFF_MIN_S * 1000u, b.waitMs(API_REQUEST_CURRENT, now));
+}
+
+void test_backoff_level_saturates() {
+    ApiBudget b;
+    b.reset(0);
+    for (int i = 0; i < 40; i++) {
+        b.onResponse(429, 0, 0);
+    }
+    TEST_ASSERT_EQUAL(API_BACKOFF_MAX_S * 1000u, b.waitMs(API_REQUEST_CURRENT, 0));
+    ApiBudgetState st;
+    b.save(&st, 0, 0);
+    TEST_ASSERT_EQUAL(16, st.backoffLevel);
+}
+
+void test_restore_credits_offline_time_with_epochs() {
+    ApiBudget b;
+    b.reset(0);
+    for (int i = 0; i < API_CALLS_PER_MINUTE; i++) {
+        TEST_ASSERT_TRUE(b.acquire(API_REQUEST_CURRENT, 0));
+    }
+    ApiBudgetState st;
+    b.save(&st, 0, EPOCH);
+    TEST_ASSERT_EQUAL(API_BUDGET_MAGIC, st.magic);
+    TEST_ASSERT_EQUAL(0, st.minuteLevel);
+    TEST_ASSERT_EQUAL((API_CALLS_PER_DAY - API_CALLS_PER_MINUTE) * 1000, st.dayLevel);
+
+    ApiBudget r;
+    r.restore(st, 5000, EPOCH + 30);   // 30 s off: half a minute bucket back
+    ApiBudgetStatus s = r.status(5000);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_MINUTE / 2, s.minuteRemaining);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY - API_CALLS_PER_MINUTE, s.dayRemaining);
+    TEST_ASSERT_EQUAL(0, r.waitMs(API_REQUEST_CURRENT, 5000));
+
+    ApiBudget later;
+    later.restore(st, 5000, EPOCH + 3 * 86400);   // Days off: both full, no overflow
+    s = later.status(5000);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_MINUTE, s.minuteRemaining);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY, s.dayRemaining);
+}
+
+void test_restore_without_epochs_refills_nothing() {
+    ApiBudget b;
+    b.reset(0);
+    for (int i = 0; i < API_CALLS_PER_MINUTE; i++) {
+        b.acquire(API_REQUEST_CURRENT, 0);
+    }
+    ApiBudgetState unknownThen;
+    b.save(&unknownThen, 0, 0);
+
+    ApiBudget r;
+    r.restore(unknownThen, 5000, EPOCH);
+    TEST_ASSERT_EQUAL(0, r.status(5000).minuteRemaining);
+    TEST_ASSERT_EQUAL(1000, r.waitMs(API_REQUEST_CURRENT, 5000));   // Refills from boot on
+
+    ApiBudgetState knownThen;
+    b.save(&knownThen, 0, EPOCH);
+    r.restore(knownThen, 5000, 0);   // Clock unset now
+    TEST_ASSERT_EQUAL(0, r.status(5000).minuteRemaining);
+    r.restore(knownThen, 5000, EPOCH - 600);   // Clock went backwards: same as unknown
+    TEST_ASSERT_EQUAL(0, r.status(5000).minuteRemaining);
+}
+
+void test_restore_resumes_hold() {
+    ApiBudget b;
+    b.reset(0);
+    b.onResponse(429, 600, 10000);
+    ApiBudgetState st;
+    b.save(&st, 110000, EPOCH);   // 100 s into the hold
+    TEST_ASSERT_EQUAL(500, st.holdSeconds);
+
+    ApiBudget r;
+    r.restore(st, 2000, EPOCH + 200);
+    TEST_ASSERT_EQUAL(300000, r.waitMs(API_REQUEST_CURRENT, 2000));
+    r.restore(st, 2000, 0);   // Unknown time off: the rest of the hold in full
+    TEST_ASSERT_EQUAL(500000, r.waitMs(API_REQUEST_CURRENT, 2000));
+    r.restore(st, 2000, EPOCH + 501);   // Ran out while off
+    TEST_ASSERT_EQUAL(0, r.status(2000).holdSeconds);
+}
+
+void test_restore_ignores_foreign_state() {
+    ApiBudgetState st;
+    ApiBudget b;
+    b.reset(0);
+    b.acquire(API_REQUEST_CURRENT, 0);
+    b.onResponse(429, 600, 0);
+    b.save(&st, 0, EPOCH);
+
+    ApiBudgetState other = st;
+    other.magic ^= 1;
+    ApiBudget r;
+    r.restore(other, 0, EPOCH);
+    ApiBudgetStatus s = r.status(0);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_MINUTE, s.minuteRemaining);
+    TEST_ASSERT_EQUAL(0, s.holdSeconds);
+
+    other = st;
+    other.perMinute = API_CALLS_PER_MINUTE / 2;   // Learned under another plan
+    r.restore(other, 0, EPOCH);
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY, r.status(0).dayRemaining);
+    other = st;
+    other.perDay = API_CALLS_PER_DAY + 1;
+    r.restore(other, 0, EPOCH);
+    TEST_ASSERT_EQUAL(0, r.status(0).holdSeconds);
+
+    r.restore(st, 0, EPOCH);   // The genuine one still applies
+    TEST_ASSERT_EQUAL(600, r.status(0).holdSeconds);
+}
+
+void test_reboot_loop_cannot_exceed_the_plan() {
+    StandInServer server(API_CALLS_PER_MINUTE, API_CALLS_PER_DAY, true);
+    ApiBudgetState saved = {};
+    uint32_t sent = 0;
+    // A boot every 10 s for a day, each fetching right away
+    for (uint32_t t = EPOCH; t < EPOCH + 86400; t += 10) {
+        ApiBudget b;
+        b.restore(saved, 3000, t);
+        if (b.acquire(API_REQUEST_CURRENT, 3000)) {
+            uint32_t retryAfter;
+            int code = server.handle(t, &retryAfter);
+            b.onResponse(code, retryAfter, 3100);
+            sent++;
+        }
+        b.save(&saved, 3200, t);
+    }
+    // The bucket starts full and refills through the day, so the server's daily
+    // cap is what stops it - once, and the hold until midnight outlives every reboot
+    TEST_ASSERT_EQUAL(API_CALLS_PER_DAY, server.served);
+    TEST_ASSERT_EQUAL(1, server.rejected);
+    TEST_ASSERT_EQUAL(server.served + server.rejected, sent);
+
+    // Without a clock nothing refills across boots
+    ApiBudgetState noClock = {};
+    sent = 0;
+    for (int i = 0; i < 5000; i++) {
+        ApiBudget b;
+        b.restore(noClock, 3000, 0);
+        if (b.acquire(API_REQUEST_CURRENT, 3000)) sent++;
+        b.save(&noClock, 3200, 0);
+    }
+    TEST_ASSERT_TRUE(sent <= API_CALLS_PER_DAY + 12);   // Plus 200 ms of refill per boot
+}
+
+void test_server_stricter_than_the_budget() {
+    // The plan is believed to allow 60 per minute, the server allows 20 and sends no Retry-After
+    StandInServer server(20, API_CALLS_PER_DAY, false);
+    ApiBudget b;
+    b.reset(0);
+    uint32_t now = 0, sent = 0;
+    for (int i = 0; i < 2000; i++) {
+        uint32_t wait = b.waitMs(API_REQUEST_CURRENT, now);
+        if (wait != 0) {
+            now += wait;
+            continue;
+        }
+        TEST_ASSERT_TRUE(b.acquire(API_REQUEST_CURRENT, now));
+        sent++;
+        uint32_t retryAfter;
+        int code = server.handle(now / 1000, &retryAfter);
+        b.onResponse(code, retryAfter, now);
+        now += 100;
+    }
+    TEST_ASSERT_TRUE(server.rejected < sent / 5);
+    TEST_ASSERT_EQUAL(server.rejected, b.status(now).throttled);
+}
+
+void test_parse_retry_after_delta_seconds() {
+    const uint32_t now = 1445412480;   // Wed, 21 Oct 2015 07:28:00 GMT
+    TEST_ASSERT_EQUAL(120, parseRetryAfter("120", now));
+    TEST_ASSERT_EQUAL(120, parseRetryAfter("  120 ", now));
+    TEST_ASSERT_EQUAL(120, parseRetryAfter("120", 0));   // No clock needed
+    TEST_ASSERT_EQUAL(0, parseRetryAfter("0", now));
+    TEST_ASSERT_EQUAL(UINT32_MAX, parseRetryAfter("4294967295", now));
+    TEST_ASSERT_EQUAL(UINT32_MAX, parseRetryAfter("99999999999999999999999", now));
+}
+
+void test_parse_retry_after_http_date() {
+    const uint32_t now = 1445412480;   // Wed, 21 Oct 2015 07:28:00 GMT
+    TEST_ASSERT_EQUAL(120, parseRetryAfter("Wed, 21 Oct 2015 07:30:00 GMT", now));
+    TEST_ASSERT_EQUAL(86400 + 3600 + 61, parseRetryAfter("Thu, 22 Oct 2015 08:29:01 GMT", now));
+    TEST_ASSERT_EQUAL(0, parseRetryAfter("Wed, 21 Oct 2015 07:28:00 GMT", now));   // Now is not later
+    TEST_ASSERT_EQUAL(0, parseRetryAfter("Wed, 21 Oct 2015 07:20:00 GMT", now));
+    TEST_ASSERT_EQUAL(0, parseRetryAfter("Wed, 21 Oct 2015 07:30:00 GMT", 0));     // Needs the clock
+    TEST_ASSERT_EQUAL(5, parseRetryAfter("Thu, 29 Feb 2024 00:00:00 GMT", 1709164800 - 5));
+    TEST_ASSERT_EQUAL(1, parseRetryAfter("Fri, 01 Jan 2100 00:00:00 GMT", 4102444800u - 1));   // Not a leap year
+    TEST_ASSERT_EQUAL(UINT32_MAX, parseRetryAfter("Fri, 31 Dec 9999 23:59:59 GMT", now));
+}
+
+void test_parse_retry_after_malformed() {
+    const uint32_t now = 1445412480;
+    const char* bad[] = {
+        "",
+        "   ",
+        "12a",
+        "1.5",
+        "-5",
+        "Wed, 21 Foo 2015 07:30:00 GMT",
+        "Wed, 21 oct 2015 07:30:00 GMT",
+        "Wednesday, 21-Oct-15 07:30:00 GMT",   // RFC 850
+        "Wed Oct 21 07:30:00 2015",            // asctime
+        "Wed, 21 Oct 2015 07:30:00 UTC",
+        "Wed, 21 Oct 2015 07:30 GMT",
+        "Wed, 1 Oct 2015 07:30:00 GMT",
+        "Wed,21 Oct 2015 07:30:00 GMT",
+        "Wed, 32 Oct 2015 07:30:00 GMT",
+        "Wed, 00 Oct 2015 07:30:00 GMT",
+        "Wed, 21 Oct 2015 24:00:00 GMT",
+        "Wed, 21 Oct 2015 07:60:00 GMT",
+        "Wed, 21 Oct 1969 07:30:00 GMT",
+        "Wed, 21 Oct 2015 07:30:00",
+        "Wed, ",
+    };
+    for (const char* value : bad) {
+        TEST_ASSERT_EQUAL(0, parseRetryAfter(value, now));
+    }
+    TEST_ASSERT_EQUAL(0, parseRetryAfter(nullptr, now));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_refill_is_exact_over_small_steps);
+    RUN_TEST(test_bucket_ms_until_matches_refill);
+    RUN_TEST(test_bucket_take_keep_and_set);
+    RUN_TEST(test_reserves_keep_tokens_for_current_conditions);
+    RUN_TEST(test_steady_fetching_is_never_held);
+    RUN_TEST(test_retry_after_holds_every_kind);
+    RUN_TEST(test_backoff_without_retry_after);
+    RUN_TEST(test_backoff_level_saturates);
+    RUN_TEST(test_restore_credits_offline_time_with_epochs);
+    RUN_TEST(test_restore_without_epochs_refills_nothing);
+    RUN_TEST(test_restore_resumes_hold);
+    RUN_TEST(test_restore_ignores_foreign_state);
+    RUN_TEST(test_reboot_loop_cannot_exceed_the_plan);
+    RUN_TEST(test_server_stricter_than_the_budget);
+    RUN_TEST(test_parse_retry_after_delta_seconds);
+    RUN_TEST(test_parse_retry_after_http_date);
+    RUN_TEST(test_parse_retry_after_malformed);
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+#include <unity.h>
+#include <stdint.h>
+#include "backlight_schedule.h"
+
+static const time_t MIDNIGHT = 1718409600;   // 2024-06-15 00:00 UTC
+static const int32_t HALF_RAMP = 45 * 30;    // Seconds either side of sunrise/sunset
+
+static time_t at(int hour, int minute, int second = 0) {
+    return MIDNIGHT + hour * 3600 + minute * 60 + second;
+}
+
+static const BacklightCurve CURVE(200, 40, 45);
+
+void setUp() {}
+void tearDown() {}
+
+void test_morning_ramp() {
+    time_t rise = at(5, 30), set = at(20, 15);
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, at(3, 0), rise, set));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, rise - HALF_RAMP, rise, set));
+    TEST_ASSERT_EQUAL(64, backlightDaylightFactor(CURVE, rise - HALF_RAMP / 2, rise, set));
+    TEST_ASSERT_EQUAL(128, backlightDaylightFactor(CURVE, rise, rise, set));
+    TEST_ASSERT_EQUAL(192, backlightDaylightFactor(CURVE, rise + HALF_RAMP / 2, rise, set));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, rise + HALF_RAMP, rise, set));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(12, 0), rise, set));
+
+    TEST_ASSERT_EQUAL(40, backlightScheduledLevel(CURVE, rise - HALF_RAMP, rise, set));
+    TEST_ASSERT_EQUAL(120, backlightScheduledLevel(CURVE, rise, rise, set));
+    TEST_ASSERT_EQUAL(200, backlightScheduledLevel(CURVE, rise + HALF_RAMP, rise, set));
+}
+
+void test_evening_ramp() {
+    time_t rise = at(5, 30), set = at(20, 15);
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, set - HALF_RAMP, rise, set));
+    TEST_ASSERT_EQUAL(192, backlightDaylightFactor(CURVE, set - HALF_RAMP / 2, rise, set));
+    TEST_ASSERT_EQUAL(128, backlightDaylightFactor(CURVE, set, rise, set));
+    TEST_ASSERT_EQUAL(64, backlightDaylightFactor(CURVE, set + HALF_RAMP / 2, rise, set));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, set + HALF_RAMP, rise, set));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, at(23, 0), rise, set));
+
+    TEST_ASSERT_EQUAL(120, backlightScheduledLevel(CURVE, set, rise, set));
+    TEST_ASSERT_EQUAL(40, backlightScheduledLevel(CURVE, at(23, 0), rise, set));
+
+    // Sun times from another day (yesterday's forecast) still place the ramps by time of day
+    TEST_ASSERT_EQUAL(128, backlightDaylightFactor(CURVE, set, rise - 86400, set - 86400));
+}
+
+void test_day_wrapping_past_utc_midnight() {
+    // East of Greenwich: sunrise 23:50 UTC the day before, sunset 13:00 UTC
+    time_t rise = at(23, 50) - 86400, set = at(13, 0);
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(2, 0), rise, set));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(12, 0), rise, set));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, at(18, 0), rise, set));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, at(23, 0), rise, set));
+
+    // The morning ramp straddles midnight
+    TEST_ASSERT_EQUAL(128, backlightDaylightFactor(CURVE, at(23, 50), rise, set));
+    TEST_ASSERT_EQUAL((1200 + HALF_RAMP) * 256 / (2 * HALF_RAMP),
+                      backlightDaylightFactor(CURVE, at(0, 10), rise, set));
+    TEST_ASSERT_EQUAL((-1200 + HALF_RAMP) * 256 / (2 * HALF_RAMP),
+                      backlightDaylightFactor(CURVE, at(23, 30), rise, set));
+
+    // West: sunset after midnight UTC, the night in the middle of the UTC day
+    time_t westRise = at(11, 0), westSet = at(1, 30) + 86400;
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(23, 0), westRise, westSet));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(0, 30), westRise, westSet));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(CURVE, at(6, 0), westRise, westSet));
+    TEST_ASSERT_EQUAL(128, backlightDaylightFactor(CURVE, at(1, 30), westRise, westSet));
+}
+
+void test_without_twilight_the_curve_steps() {
+    BacklightCurve sharp(200, 40, 0);
+    time_t rise = at(5, 30), set = at(20, 15);
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(sharp, rise - 1, rise, set));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(sharp, rise, rise, set));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(sharp, set - 1, rise, set));
+    TEST_ASSERT_EQUAL(0, backlightDaylightFactor(sharp, set, rise, set));
+    TEST_ASSERT_EQUAL(40, backlightScheduledLevel(sharp, set, rise, set));
+    TEST_ASSERT_EQUAL(200, backlightScheduledLevel(sharp, rise, rise, set));
+}
+
+void test_unknown_inputs_mean_full_day() {
+    time_t rise = at(5, 30), set = at(20, 15);
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(23, 0), 0, set));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(23, 0), rise, 0));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, at(23, 0), -1, -1));
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, 3600, rise, set));        // Clock not set
+    TEST_ASSERT_EQUAL(256, backlightDaylightFactor(CURVE, 999999999, rise, set));
+    TEST_ASSERT_EQUAL(200, backlightScheduledLevel(CURVE, 0, rise, set));
+}
+
+void test_level_follows_the_curve_either_way() {
+    time_t rise = at(5, 30), set = at(20, 15);
+    // A night level above the day level (a bedside display kept dim by day) still blends
+    BacklightCurve inverted(40, 200, 45);
+    TEST_ASSERT_EQUAL(200, backlightScheduledLevel(inverted, at(3, 0), rise, set));
+    TEST_ASSERT_EQUAL(120, backlightScheduledLevel(inverted, rise, rise, set));
+    TEST_ASSERT_EQUAL(40, backlightScheduledLevel(inverted, at(12, 0), rise, set));
+
+    // Monotonic through the morning ramp
+    uint8_t last = 0;
+    for (time_t t = rise - HALF_RAMP; t <= rise + HALF_RAMP; t += 30) {
+        uint8_t level = backlightScheduledLevel(CURVE, t, rise, set);
+        TEST_ASSERT_TRUE(level >= last);
+        last = level;
+    }
+    TEST_ASSERT_EQUAL(200, last);
+}
+
+void test_histogram_weights_by_time() {
+    DutyHistogram h;
+    TEST_ASSERT_EQUAL(0, h.meanDuty());
+    TEST_ASSERT_EQUAL(0, h.binPercent(0));
+
+    h.add(0, 1000);
+    h.add(255, 3000);
+    TEST_ASSERT_EQUAL(4000, h.totalMs());
+    TEST_ASSERT_EQUAL(191, h.meanDuty());
+    TEST_ASSERT_EQUAL(25, h.binPercent(0));
+    TEST_ASSERT_EQUAL(75, h.binPercent(BACKLIGHT_HISTOGRAM_BINS - 1));
+    TEST_ASSERT_EQUAL(0, h.binPercent(-1));
+    TEST_ASSERT_EQUAL(0, h.binPercent(BACKLIGHT_HISTOGRAM_BINS));
+
+    h.reset();
+    TEST_ASSERT_EQUAL(0, h.totalMs());
+    TEST_ASSERT_EQUAL(0, h.meanDuty());
+}
+
+void test_histogram_past_32_bits_of_milliseconds() {
+    // Regression: 32-bit sums wrapped after 49.7 days and gave means and shares over 100
+    DutyHistogram h;
+    for (int i = 0; i < 3; i++) {
+        h.add(255, UINT32_MAX);
+    }
+    h.add(0, UINT32_MAX);
+    TEST_ASSERT_TRUE(h.totalMs() > UINT32_MAX);
+    TEST_ASSERT_EQUAL(4ULL * UINT32_MAX, h.totalMs());
+    TEST_ASSERT_EQUAL(191, h.meanDuty());
+    TEST_ASSERT_EQUAL(75, h.binPercent(BACKLIGHT_HISTOGRAM_BINS - 1));
+    TEST_ASSERT_EQUAL(25, h.binPercent(0));
+
+    // A year at one duty in minute-sized steps
+    DutyHistogram year;
+    for (uint32_t minute = 0; minute < 365u * 24 * 60; minute++) {
+        year.add(200, 60000);
+    }
+    TEST_ASSERT_EQUAL(200, year.meanDuty());
+    uint32_t sum = 0;
+    for (int bin = 0; bin < BACKLIGHT_HISTOGRAM_BINS; bin++) {
+        TEST_ASSERT_TRUE(year.binPercent(bin) <= 100);
+        sum += year.binPercent(bin);
+    }
+    TEST_ASSERT_EQUAL(100, sum);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_morning_ramp);
+    RUN_TEST(test_evening_ramp);
+    RUN_TEST(test_day_wrapping_past_utc_midnight);
+    RUN_TEST(test_without_twilight_the_curve_steps);
+    RUN_TEST(test_unknown_inputs_mean_full_day);
+    RUN_TEST(test_level_follows_the_curve_either_way);
+    RUN_TEST(test_histogram_weights_by_time);
+    RUN_TEST(test_histogram_past_32_bits_of_milliseconds);
+    return UNITY_END();
+}
@@ -0,0 +1,451 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "dns_cache.h"
+#include "dns_message.h"
+
+static const char* HOST = "api.openweathermap.org";
+static const uint16_t ID = 0x4D2A;
+
+// Builds response messages byte by byte so each test spells out the wire format
+struct Message {
+    std::vector<uint8_t> bytes;
+
+    void u8(uint8_t v) { bytes.push_back(v); }
+    void u16(uint16_t v) { u8((uint8_t)(v >> 8)); u8((uint8_t)v); }
+    void u32(uint32_t v) { u16((uint16_t)(v >> 16)); u16((uint16_t)v); }
+
+    // Labels of a dotted name, ended by a root label or a pointer when pointer != 0
+    void name(const char* dotted, uint16_t pointer = 0) {
+        while (*dotted) {
+            const char* dot = strchr(dotted, '.');
+            size_t len = dot != nullptr ? (size_t)(dot - dotted) : strlen(dotted);
+            u8((uint8_t)len);
+            bytes.insert(bytes.end(), dotted, dotted + len);
+            dotted += len + (dot != nullptr ? 1 : 0);
+        }
+        if (pointer != 0) {
+            u16((uint16_t)(0xC000 | pointer));
+        } else {
+            u8(0);
+        }
+    }
+
+    void header(uint16_t id, uint8_t flags2, uint8_t flags3, uint16_t questions, uint16_t answers) {
+        u16(id);
+        u8(flags2);
+        u8(flags3);
+        u16(questions);
+        u16(answers);
+        u16(0);
+        u16(0);
+    }
+
+    void question(const char* host) {
+        name(host);
+        u16(1);
+        u16(1);
+    }
+
+    // Record owned by the name at offset owner (compressed), rdata appended by the caller
+    size_t record(uint16_t owner, uint16_t type, uint16_t cls, uint32_t ttl, uint16_t rdLength) {
+        u16((uint16_t)(0xC000 | owner));
+        u16(type);
+        u16(cls);
+        u32(ttl);
+        u16(rdLength);
+        return bytes.size();
+    }
+
+    void a(uint16_t owner, uint32_t ttl, uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3) {
+        record(owner, 1, 1, ttl, 4);
+        u8(b0);
+        u8(b1);
+        u8(b2);
+        u8(b3);
+    }
+
+    // CNAME whose target ends in a pointer back into the question; returns the target's offset
+    uint16_t cname(uint16_t owner, uint32_t ttl, const char* prefix, uint16_t suffix) {
+        size_t at = record(owner, 5, 1, ttl, (uint16_t)(strlen(prefix) + 1 + 2));
+        name(prefix, suffix);
+        return (uint16_t)at;
+    }
+
+    void setAnswers(uint16_t n) {
+        bytes[6] = (uint8_t)(n >> 8);
+        bytes[7] = (uint8_t)n;
+    }
+
+    DnsResult parse(uint32_t* address, uint32_t* ttl, uint16_t id = ID, const char* host = HOST) const {
+        return dnsParseResponse(bytes.data(), bytes.size(), id, host, address, ttl);
+    }
+};
+
+static const uint16_t QNAME = 12;   // Offset of the question name
+
+static Message answerFor(const char* host, uint16_t answers) {
+    Message m;
+    m.header(ID, 0x81, 0x80, 1, answers);   // QR, RD / RA, NOERROR
+    m.question(host);
+    return m;
+}
+
+// "api.openweathermap.org" -> 203.0.113.7, TTL 300, answer name compressed to the question
+static Message simpleAnswer() {
+    Message m = answerFor(HOST, 1);
+    m.a(QNAME, 300, 203, 0, 113, 7);
+    return m;
+}
+
+static uint32_t ipv4(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3) {
+    return (uint32_t)b0 | ((uint32_t)b1 << 8) | ((uint32_t)b2 << 16) | ((uint32_t)b3 << 24);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_query_wire_format() {
+    uint8_t out[DNS_MESSAGE_MAX];
+    size_t n = dnsBuildQuery(0x1234, "a.bc", out, sizeof(out));
+    const uint8_t expected[] = {0x12, 0x34, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 0,
+                                1, 'a', 2, 'b', 'c', 0, 0, 1, 0, 1};
+    TEST_ASSERT_EQUAL(sizeof(expected), n);
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, n);
+
+    // A trailing dot is the same name
+    TEST_ASSERT_EQUAL(n, dnsBuildQuery(0x1234, "a.bc.", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, n);
+}
+
+void test_query_rejects_bad_names() {
+    uint8_t out[DNS_MESSAGE_MAX];
+    char longLabel[80];
+    memset(longLabel, 'x', 64);
+    strcpy(longLabel + 64, ".org");
+
+    TEST_ASSERT_EQUAL(0, dnsBuildQuery(1, "", out, sizeof(out)));
+    TEST_ASSERT_EQUAL(0, dnsBuildQuery(1, "a..b", out, sizeof(out)));
+    TEST_ASSERT_EQUAL(0, dnsBuildQuery(1, ".a", out, sizeof(out)));
+    TEST_ASSERT_EQUAL(0, dnsBuildQuery(1, longLabel, out, sizeof(out)));
+    TEST_ASSERT_EQUAL(0, dnsBuildQuery(1, HOST, out, 12 + strlen(HOST) + 5));   // One byte short
+    TEST_ASSERT_EQUAL(12 + strlen(HOST) + 6, dnsBuildQuery(1, HOST, out, 12 + strlen(HOST) + 6));
+}
+
+void test_query_and_answer_round_trip() {
+    uint8_t query[DNS_MESSAGE_MAX];
+    size_t n = dnsBuildQuery(ID, HOST, query, sizeof(query));
+    Message m;
+    m.bytes.assign(query, query + n);
+    m.bytes[2] |= 0x80;   // Turn the query into its response
+    m.bytes[3] = 0x80;
+    m.setAnswers(1);
+    m.a(QNAME, 300, 203, 0, 113, 7);
+
+    uint32_t address = 0, ttl = 0;
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL_HEX32(ipv4(203, 0, 113, 7), address);
+    TEST_ASSERT_EQUAL(300, ttl);
+}
+
+void test_cname_chain_takes_smallest_ttl() {
+    // api.openweathermap.org -> edge.openweathermap.org -> lb.edge.openweathermap.org -> A
+    Message m = answerFor(HOST, 3);
+    uint16_t suffix = QNAME + 4;   // "openweathermap.org" inside the question
+    uint16_t edge = m.cname(QNAME, 600, "edge", suffix);
+    uint16_t lb = m.cname(edge, 45, "lb", edge);   // Target compressed onto the previous target
+    m.a(lb, 300, 198, 51, 100, 20);
+
+    uint32_t address = 0, ttl = 0;
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL_HEX32(ipv4(198, 51, 100, 20), address);
+    TEST_ASSERT_EQUAL(45, ttl);
+
+    // The address record itself can be the shortest
+    Message short_ = answerFor(HOST, 2);
+    uint16_t target = short_.cname(QNAME, 600, "edge", suffix);
+    short_.a(target, 20, 198, 51, 100, 21);
+    TEST_ASSERT_EQUAL(DNS_OK, short_.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL(20, ttl);
+}
+
+void test_first_address_wins_and_others_are_skipped() {
+    Message m = answerFor(HOST, 4);
+    m.record(QNAME, 28, 1, 10, 16);   // AAAA
+    for (int i = 0; i < 16; i++) m.u8(0x20);
+    m.record(QNAME, 1, 3, 10, 4);     // A in class CH
+    m.u32(0x7F000001);
+    m.a(QNAME, 120, 192, 0, 2, 1);
+    m.a(QNAME, 5, 192, 0, 2, 2);
+
+    uint32_t address = 0, ttl = 0;
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL_HEX32(ipv4(192, 0, 2, 1), address);
+    TEST_ASSERT_EQUAL(120, ttl);   // Neither the skipped records nor the later A count
+}
+
+void test_ttl_with_top_bit_is_zero() {
+    Message m = answerFor(HOST, 1);
+    m.a(QNAME, 0x80000010u, 192, 0, 2, 1);
+    uint32_t address = 0, ttl = 99;
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL(0, ttl);
+}
+
+void test_answer_without_address() {
+    uint32_t address = 0, ttl = 0;
+    Message empty = answerFor(HOST, 0);
+    TEST_ASSERT_EQUAL(DNS_NO_ADDRESS, empty.parse(&address, &ttl));
+
+    Message cnameOnly = answerFor(HOST, 1);
+    cnameOnly.cname(QNAME, 60, "edge", QNAME + 4);
+    TEST_ASSERT_EQUAL(DNS_NO_ADDRESS, cnameOnly.parse(&address, &ttl));
+
+    Message shortRdata = answerFor(HOST, 1);
+    shortRdata.record(QNAME, 1, 1, 60, 3);
+    shortRdata.u8(1);
+    shortRdata.u8(2);
+    shortRdata.u8(3);
+    TEST_ASSERT_EQUAL(DNS_NO_ADDRESS, shortRdata.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL(0, address);
+}
+
+void test_id_and_question_mismatch() {
+    uint32_t address = 0, ttl = 0;
+    Message m = simpleAnswer();
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, m.parse(&address, &ttl, ID + 1));
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, m.parse(&address, &ttl, ID, "api.openweathermap.com"));
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, m.parse(&address, &ttl, ID, "openweathermap.org"));
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, m.parse(&address, &ttl, ID, "api.openweathermap.org.evil"));
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, m.parse(&address, &ttl, ID, "api.openweathermap.or"));
+    TEST_ASSERT_EQUAL(0, address);
+
+    // Case and a trailing dot don't matter
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl, ID, "API.OpenWeatherMap.org"));
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl, ID, "api.openweathermap.org."));
+
+    Message query = simpleAnswer();
+    query.bytes[2] &= 0x7F;   // QR clear: our own query echoed back
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, query.parse(&address, &ttl));
+
+    Message twoQuestions = simpleAnswer();
+    twoQuestions.bytes[5] = 2;
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, twoQuestions.parse(&address, &ttl));
+
+    // A compressed question name is not ours to chase
+    Message pointer;
+    pointer.header(ID, 0x81, 0x80, 1, 0);
+    pointer.u16(0xC000 | QNAME);
+    pointer.u16(1);
+    pointer.u16(1);
+    TEST_ASSERT_EQUAL(DNS_MISMATCH, pointer.parse(&address, &ttl));
+}
+
+void test_error_codes() {
+    uint32_t address = 0, ttl = 0;
+    Message m = answerFor(HOST, 0);
+    m.bytes[3] = 0x83;
+    TEST_ASSERT_EQUAL(DNS_NXDOMAIN, m.parse(&address, &ttl));
+    m.bytes[3] = 0x82;
+    TEST_ASSERT_EQUAL(DNS_SERVER_ERROR, m.parse(&address, &ttl));
+    m.bytes[3] = 0x85;
+    TEST_ASSERT_EQUAL(DNS_SERVER_ERROR, m.parse(&address, &ttl));
+
+    // TC wins over the rcode and the records; the caller retries or gives up
+    Message truncated = simpleAnswer();
+    truncated.bytes[2] |= 0x02;
+    TEST_ASSERT_EQUAL(DNS_TRUNCATED, truncated.parse(&address, &ttl));
+    TEST_ASSERT_EQUAL(0, address);
+}
+
+void test_every_cut_of_a_cname_answer_fails_cleanly() {
+    Message m = answerFor(HOST, 2);
+    uint16_t target = m.cname(QNAME, 600, "edge", QNAME + 4);
+    m.a(target, 300, 198, 51, 100, 20);
+    uint32_t address = 0, ttl = 0;
+    TEST_ASSERT_EQUAL(DNS_OK, m.parse(&address, &ttl));
+
+    size_t questionEnd = 12 + strlen(HOST) + 2 + 4;
+    for (size_t len = 0; len < m.bytes.size(); len++) {
+        // An exact-size copy so the sanitizer sees any read past the cut
+        std::vector<uint8_t> cut(m.bytes.begin(), m.bytes.begin() + len);
+        address = 0;
+        DnsResult r = dnsParseResponse(cut.data(), cut.size(), ID, HOST, &address, &ttl);
+        DnsResult expected = len < 12 ? DNS_MALFORMED : len < questionEnd - 4 ? DNS_MISMATCH : DNS_MALFORMED;
+        TEST_ASSERT_EQUAL(expected, r);
+        TEST_ASSERT_EQUAL(0, address);
+    }
+}
+
+void test_bad_names_in_answers() {
+    uint32_t address = 0, ttl = 0;
+
+    Message reserved = answerFor(HOST, 1);
+    reserved.u8(0x80);   // Label type 10 is reserved
+    reserved.u8(0);
+    TEST_ASSERT_EQUAL(DNS_MALFORMED, reserved.parse(&address, &ttl));
+
+    Message halfPointer = answerFor(HOST, 1);
+    halfPointer.u8(0xC0);
+    TEST_ASSERT_EQUAL(DNS_MALFORMED, halfPointer.parse(&address, &ttl));
+
+    Message overrun = answerFor(HOST, 1);
+    overrun.record(QNAME, 5, 1, 60, 40);   // rdata longer than what follows
+    overrun.name("edge", QNAME + 4);
+    TEST_ASSERT_EQUAL(DNS_MALFORMED, overrun.parse(&address, &ttl));
+
+    Message missing = simpleAnswer();
+    missing.setAnswers(2);   // Promises a record that isn't there
+    TEST_ASSERT_EQUAL(DNS_OK, missing.parse(&address, &ttl));   // The first one already answers
+    Message missingFirst = answerFor(HOST, 1);
+    TEST_ASSERT_EQUAL(DNS_MALFORMED, missingFirst.parse(&address, &ttl));
+}
+
+void test_result_names() {
+    TEST_ASSERT_EQUAL_STRING("ok", dnsResultName(DNS_OK));
+    TEST_ASSERT_EQUAL_STRING("truncated", dnsResultName(DNS_TRUNCATED));
+    TEST_ASSERT_EQUAL_STRING("no address", dnsResultName(DNS_NO_ADDRESS));
+    TEST_ASSERT_EQUAL_STRING("?", dnsResultName((DnsResult)99));
+}
+
+void test_cache_ttl_boundaries_and_clamping() {
+    DnsCache cache;
+    uint32_t address = 0;
+    TEST_ASSERT_FALSE(cache.lookup(HOST, 0, &address));
+
+    TEST_ASSERT_TRUE(cache.store(HOST, 0x0A000001, 120, 1000));
+    TEST_ASSERT_TRUE(cache.lookup(HOST, 1000 + 119999, &address));
+    TEST_ASSERT_EQUAL_HEX32(0x0A000001, address);
+    TEST_ASSERT_FALSE(cache.lookup(HOST, 1000 + 120000, &address));
+
+    cache.store(HOST, 0x0A000001, 1, 0);   // Below DNS_MIN_TTL_S
+    TEST_ASSERT_TRUE(cache.lookup(HOST, DNS_MIN_TTL_S * 1000 - 1, &address));
+    TEST_ASSERT_FALSE(cache.lookup(HOST, DNS_MIN_TTL_S * 1000, &address));
+
+    cache.store(HOST, 0x0A000001, 0x7FFFFFFF, 0);   // Above DNS_MAX_TTL_S, and no overflow in ms
+    TEST_ASSERT_TRUE(cache.lookup(HOST, DNS_MAX_TTL_S * 1000u - 1, &address));
+    TEST_ASSERT_FALSE(cache.lookup(HOST, DNS_MAX_TTL_S * 1000u, &address));
+}
+
+void test_cache_refresh_window() {
+    DnsCache cache;
+    TEST_ASSERT_TRUE(cache.needsRefresh(HOST, 0, 0));
+    cache.store(HOST, 0x0A000001, 300, 5000);
+    TEST_ASSERT_FALSE(cache.needsRefresh(HOST, 5000, 10000));
+    TEST_ASSERT_FALSE(cache.needsRefresh(HOST, 5000 + 289999, 10000));
+    TEST_ASSERT_TRUE(cache.needsRefresh(HOST, 5000 + 290000, 10000));   // Expires within the lead
+    TEST_ASSERT_TRUE(cache.needsRefresh("other.example", 5000, 0));
+}
+
+void test_cache_stale_fallback() {
+    DnsCache cache;
+    uint32_t address = 0;
+    TEST_ASSERT_FALSE(cache.lastKnownGood(HOST, 0, &address));
+
+    cache.store(HOST, 0x0A000002, 60, 0);
+    uint32_t staleEnd = 60000 + (uint32_t)DNS_STALE_MAX_S * 1000;
+    TEST_ASSERT_TRUE(cache.lastKnownGood(HOST, 30000, &address));   // Fresh entries count too
+    TEST_ASSERT_FALSE(cache.lookup(HOST, 60000, &address));
+    address = 0;
+    TEST_ASSERT_TRUE(cache.lastKnownGood(HOST, 60000, &address));
+    TEST_ASSERT_EQUAL_HEX32(0x0A000002, address);
+    TEST_ASSERT_TRUE(cache.lastKnownGood(HOST, staleEnd - 1, &address));
+    TEST_ASSERT_FALSE(cache.lastKnownGood(HOST, staleEnd, &address));
+
+    // A fresh answer restarts both windows
+    cache.store(HOST, 0x0A000003, 60, staleEnd);
+    TEST_ASSERT_TRUE(cache.lookup(HOST, staleEnd + 1, &address));
+    TEST_ASSERT_EQUAL_HEX32(0x0A000003, address);
+}
+
+void test_cache_survives_millis_wrap() {
+    DnsCache cache;
+    uint32_t address = 0;
+    uint32_t storedAt = 0xFFFFFFFFu - 10000;
+    cache.store(HOST, 0x0A000004, 60, storedAt);
+    TEST_ASSERT_TRUE(cache.lookup(HOST, storedAt + 30000, &address));   // Past the wrap
+    TEST_ASSERT_FALSE(cache.lookup(HOST, storedAt + 60000, &address));
+    TEST_ASSERT_TRUE(cache.lastKnownGood(HOST, storedAt + 60000, &address));
+}
+
+void test_cache_keys() {
+    DnsCache cache;
+    uint32_t address = 0;
+    cache.store("API.OpenWeatherMap.ORG", 0x0A000005, 60, 0);
+    TEST_ASSERT_TRUE(cache.lookup(HOST, 0, &address));
+    TEST_ASSERT_EQUAL_HEX32(0x0A000005, address);
+
+    char name[DNS_HOST_MAX + 1];
+    memset(name, 'h', DNS_HOST_MAX - 1);
+    name[DNS_HOST_MAX - 1] = '\0';
+    TEST_ASSERT_TRUE(cache.store(name, 0x0A000006, 60, 0));   // Longest that fits
+    name[DNS_HOST_MAX - 1] = 'h';
+    name[DNS_HOST_MAX] = '\0';
+    TEST_ASSERT_FALSE(cache.store(name, 0x0A000006, 60, 0));
+    TEST_ASSERT_FALSE(cache.store("zero.example", 0, 60, 0));
+    TEST_ASSERT_FALSE(cache.lookup("zero.example", 0, &address));
+
+    cache.clear();
+    TEST_ASSERT_FALSE(cache.lastKnownGood(HOST, 0, &address));
+}
+
+void test_cache_replaces_least_recently_used() {
+    DnsCache cache;
+    char hosts[DNS_CACHE_ENTRIES + 1][24];
+    for (int i = 0; i <= DNS_CACHE_ENTRIES; i++) {
+        snprintf(hosts[i], sizeof(hosts[i]), "h%d.example", i);
+    }
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        cache.store(hosts[i], 0x0A000010 + i, 60, 0);
+    }
+
+    // Use everything but h1; an expired entry read as last known-good counts as a use
+    uint32_t address = 0;
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        if (i == 0) {
+            TEST_ASSERT_TRUE(cache.lastKnownGood(hosts[i], 70000, &address));
+        } else if (i != 1) {
+            TEST_ASSERT_TRUE(cache.lookup(hosts[i], 1000, &address));
+        }
+    }
+    // Re-storing an existing host updates it in place instead of taking a slot
+    cache.store(hosts[2], 0x0A000022, 60, 2000);
+
+    cache.store(hosts[DNS_CACHE_ENTRIES], 0x0A0000FF, 60, 3000);
+    TEST_ASSERT_FALSE(cache.lastKnownGood(hosts[1], 3000, &address));
+    for (int i = 0; i <= DNS_CACHE_ENTRIES; i++) {
+        if (i == 1) continue;
+        TEST_ASSERT_TRUE(cache.lastKnownGood(hosts[i], 3000, &address));
+    }
+    TEST_ASSERT_TRUE(cache.lookup(hosts[2], 3000, &address));
+    TEST_ASSERT_EQUAL_HEX32(0x0A000022, address);
+
+    // The checks above touched h0 first, so it goes next
+    cache.store(hosts[1], 0x0A000011, 60, 4000);
+    TEST_ASSERT_FALSE(cache.lastKnownGood(hosts[0], 4000, &address));
+    TEST_ASSERT_TRUE(cache.lastKnownGood(hosts[3], 4000, &address));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_query_wire_format);
+    RUN_TEST(test_query_rejects_bad_names);
+    RUN_TEST(test_query_and_answer_round_trip);
+    RUN_TEST(test_cname_chain_takes_smallest_ttl);
+    RUN_TEST(test_first_address_wins_and_others_are_skipped);
+    RUN_TEST(test_ttl_with_top_bit_is_zero);
+    RUN_TEST(test_answer_without_address);
+    RUN_TEST(test_id_and_question_mismatch);
+    RUN_TEST(test_error_codes);
+    RUN_TEST(test_every_cut_of_a_cname_answer_fails_cleanly);
+    RUN_TEST(test_bad_names_in_answers);
+    RUN_TEST(test_result_names);
+    RUN_TEST(test_cache_ttl_boundaries_and_clamping);
+    RUN_TEST(test_cache_refresh_window);
+    RUN_TEST(test_cache_stale_fallback);
+    RUN_TEST(test_cache_survives_millis_wrap);
+    RUN_TEST(test_cache_keys);
+    RUN_TEST(test_cache_replaces_least_recently_used);
+    return UNITY_END();
+}
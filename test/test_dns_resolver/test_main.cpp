@@ -0,0 +1,309 @@
+#include <unity.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <WiFiUdp.h>
+#include "dns_message.h"
+#include "dns_resolver.h"
+
+// Stand-in DNS server on loopback, like tools/dns_standin.py: answers every
+// A query with a fixed address and TTL, with NXDOMAIN, or not at all
+enum StandinMode { STANDIN_ANSWER, STANDIN_NXDOMAIN, STANDIN_SILENT };
+
+static std::atomic<int> standinMode{STANDIN_ANSWER};
+static std::atomic<uint32_t> standinAddress{0};
+static std::atomic<uint32_t> standinTtl{60};
+static std::atomic<uint32_t> standinQueries{0};
+static std::atomic<bool> standinStopping{false};
+static int standinSocket = -1;
+
+static uint32_t ip(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+}
+
+static void serve() {
+    uint8_t packet[DNS_MESSAGE_MAX];
+    while (!standinStopping) {
+        pollfd p = {standinSocket, POLLIN, 0};
+        if (poll(&p, 1, 20) <= 0) {
+            continue;
+        }
+        sockaddr_in from = {};
+        socklen_t fromLen = sizeof(from);
+        ssize_t n = recvfrom(standinSocket, packet, sizeof(packet), 0, (sockaddr*)&from, &fromLen);
+        if (n < 12) {
+            continue;
+        }
+        standinQueries++;
+        int mode = standinMode;
+        if (mode == STANDIN_SILENT) {
+            continue;
+        }
+
+        // The query with its question, turned into a response
+        size_t len = (size_t)n;
+        packet[2] = 0x81;                                       // QR, RD
+        packet[3] = mode == STANDIN_NXDOMAIN ? 0x83 : 0x80;     // RA, rcode
+        packet[7] = mode == STANDIN_ANSWER ? 1 : 0;             // ANCOUNT
+        if (mode == STANDIN_ANSWER && len + 16 <= sizeof(packet)) {
+            uint32_t address = standinAddress, ttl = standinTtl;
+            const uint8_t answer[16] = {0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01,
+                                        (uint8_t)(ttl >> 24), (uint8_t)(ttl >> 16), (uint8_t)(ttl >> 8), (uint8_t)ttl,
+                                        0x00, 0x04,
+                                        (uint8_t)address, (uint8_t)(address >> 8), (uint8_t)(address >> 16),
+                                        (uint8_t)(address >> 24)};
+            memcpy(packet + len, answer, sizeof(answer));
+            len += sizeof(answer);
+        }
+        sendto(standinSocket, packet, len, 0, (sockaddr*)&from, fromLen);
+    }
+}
+
+static void answer(uint32_t address, uint32_t ttl) {
+    standinMode = STANDIN_ANSWER;
+    standinAddress = address;
+    standinTtl = ttl;
+}
+
+static DnsStats stats() {
+    DnsStats s;
+    DnsResolver::stats(&s);
+    return s;
+}
+
+// The prefetch task runs on its own thread; give it time to act (or not)
+static bool waitForPrefetches(uint32_t count) {
+    for (int i = 0; i < 200; i++) {
+        if (stats().prefetches >= count) {
+            return true;
+        }
+        delay(10);
+    }
+    return false;
+}
+
+static void settle() {
+    delay(200);
+}
+
+void setUp() {
+    WiFi.hostStatus = WL_CONNECTED;
+    answer(ip(203, 0, 113, 7), 60);
+}
+
+void tearDown() {}
+
+void test_prefetch_before_begin_is_ignored() {
+    uint32_t queries = standinQueries;
+    DnsResolver::prefetch("early.example.com", 0);
+    settle();
+    TEST_ASSERT_EQUAL(queries, standinQueries);
+    TEST_ASSERT_EQUAL(0, stats().prefetches);
+}
+
+void test_literal_address_needs_no_lookup() {
+    DnsResolver::begin();   // The prefetch task, for the rest of the tests
+    uint32_t queries = standinQueries;
+    IPAddress address;
+    uint32_t latencyMs = 99;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("192.168.1.7", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(192, 168, 1, 7), (uint32_t)address);
+    TEST_ASSERT_EQUAL(0, latencyMs);
+    TEST_ASSERT_EQUAL(queries, standinQueries);
+}
+
+void test_lookup_is_cached_for_its_ttl() {
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    IPAddress address;
+    uint32_t latencyMs;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("cold.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 7), (uint32_t)address);
+    TEST_ASSERT_TRUE(latencyMs < DNS_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+    TEST_ASSERT_EQUAL(before.queries + 1, stats().queries);
+    TEST_ASSERT_EQUAL(latencyMs, stats().lastQueryMs);
+
+    // Cache hits, whatever the case of the name
+    answer(ip(203, 0, 113, 8), 60);
+    TEST_ASSERT_TRUE(DnsResolver::resolve("cold.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 7), (uint32_t)address);
+    TEST_ASSERT_EQUAL(0, latencyMs);
+    TEST_ASSERT_TRUE(DnsResolver::resolve("COLD.Example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL(0, latencyMs);
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+    TEST_ASSERT_EQUAL(before.hits + 2, stats().hits);
+
+    // Expired: asked again
+    hostAdvanceMillis(61 * 1000);
+    TEST_ASSERT_TRUE(DnsResolver::resolve("cold.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 8), (uint32_t)address);
+    TEST_ASSERT_EQUAL(queries + 2, standinQueries);
+    TEST_ASSERT_EQUAL(before.fallbacks, stats().fallbacks);
+}
+
+void test_timeout_falls_back_to_the_stale_address() {
+    IPAddress address;
+    uint32_t latencyMs;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("stale.example.com", &address, &latencyMs));
+    hostAdvanceMillis(61 * 1000);
+
+    // Every attempt waits out DNS_TIMEOUT_MS, then the expired address is used
+    standinMode = STANDIN_SILENT;
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("stale.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 7), (uint32_t)address);
+    TEST_ASSERT_TRUE(latencyMs >= DNS_ATTEMPTS * DNS_TIMEOUT_MS);
+    TEST_ASSERT_TRUE(latencyMs < DNS_ATTEMPTS * DNS_TIMEOUT_MS + 1000);
+    TEST_ASSERT_EQUAL(queries + DNS_ATTEMPTS, standinQueries);
+    TEST_ASSERT_EQUAL(before.fallbacks + 1, stats().fallbacks);
+    TEST_ASSERT_EQUAL(before.queries, stats().queries);
+    TEST_ASSERT_TRUE(stats().maxQueryMs >= DNS_ATTEMPTS * DNS_TIMEOUT_MS);
+
+    // Past the stale window there is nothing to fall back on
+    hostAdvanceMillis(DNS_STALE_MAX_S * 1000u);
+    TEST_ASSERT_FALSE(DnsResolver::resolve("stale.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL(before.failures + 1, stats().failures);
+}
+
+void test_nxdomain_falls_back_at_once() {
+    IPAddress address;
+    uint32_t latencyMs;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("gone.example.com", &address, &latencyMs));
+    hostAdvanceMillis(61 * 1000);
+
+    // An answer ends the query: no retry, no wait for the timeout
+    standinMode = STANDIN_NXDOMAIN;
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("gone.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 7), (uint32_t)address);
+    TEST_ASSERT_TRUE(latencyMs < DNS_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+    TEST_ASSERT_EQUAL(before.fallbacks + 1, stats().fallbacks);
+
+    // Never resolved: a failure
+    TEST_ASSERT_FALSE(DnsResolver::resolve("never.example.com", &address, &latencyMs));
+    TEST_ASSERT_TRUE(latencyMs < DNS_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(before.failures + 1, stats().failures);
+}
+
+void test_offline_skips_the_query() {
+    IPAddress address;
+    uint32_t latencyMs;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("offline.example.com", &address, &latencyMs));
+    hostAdvanceMillis(61 * 1000);
+
+    WiFi.hostStatus = WL_DISCONNECTED;
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("offline.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 7), (uint32_t)address);
+    TEST_ASSERT_FALSE(DnsResolver::resolve("unknown.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL(queries, standinQueries);
+    TEST_ASSERT_EQUAL(before.fallbacks + 1, stats().fallbacks);
+    TEST_ASSERT_EQUAL(before.failures + 1, stats().failures);
+}
+
+void test_prefetch_refreshes_an_entry_expiring_before_the_fetch() {
+    IPAddress address;
+    uint32_t latencyMs;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("pre.example.com", &address, &latencyMs));
+    hostAdvanceMillis(55 * 1000);   // 5 s left, inside DNS_PREFETCH_LEAD_MS
+
+    answer(ip(203, 0, 113, 9), 60);
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    DnsResolver::prefetch("pre.example.com", 0);
+    TEST_ASSERT_TRUE(waitForPrefetches(before.prefetches + 1));
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+    TEST_ASSERT_EQUAL(before.queries + 1, stats().queries);
+
+    // The fetch then finds the new address in the cache
+    hostAdvanceMillis(30 * 1000);
+    TEST_ASSERT_TRUE(DnsResolver::resolve("pre.example.com", &address, &latencyMs));
+    TEST_ASSERT_EQUAL_HEX32(ip(203, 0, 113, 9), (uint32_t)address);
+    TEST_ASSERT_EQUAL(0, latencyMs);
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+}
+
+void test_prefetch_waits_for_the_lead_time() {
+    IPAddress address;
+    uint32_t latencyMs;
+    TEST_ASSERT_TRUE(DnsResolver::resolve("later.example.com", &address, &latencyMs));
+    hostAdvanceMillis(55 * 1000);
+
+    // The fetch is due in the lead time plus 300 ms: nothing until then
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    DnsResolver::prefetch("later.example.com", DNS_PREFETCH_LEAD_MS + 300);
+    delay(100);
+    TEST_ASSERT_EQUAL(queries, standinQueries);
+    TEST_ASSERT_TRUE(waitForPrefetches(before.prefetches + 1));
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+}
+
+void test_prefetch_skips() {
+    DnsStats before = stats();
+    uint32_t queries = standinQueries;
+    IPAddress address;
+    uint32_t latencyMs;
+
+    // Still fresh when the fetch is due
+    answer(ip(203, 0, 113, 7), 3600);
+    TEST_ASSERT_TRUE(DnsResolver::resolve("fresh.example.com", &address, &latencyMs));
+    DnsResolver::prefetch("fresh.example.com", 0);
+    settle();
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+
+    // Nothing to look up
+    DnsResolver::prefetch("10.0.0.1", 0);
+    std::string tooLong(DNS_HOST_MAX, 'a');
+    DnsResolver::prefetch(tooLong.c_str(), 0);
+    settle();
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+
+    // Offline: the fetch will fall back anyway
+    WiFi.hostStatus = WL_DISCONNECTED;
+    DnsResolver::prefetch("offline-prefetch.example.com", 0);
+    settle();
+    TEST_ASSERT_EQUAL(queries + 1, standinQueries);
+    TEST_ASSERT_EQUAL(before.prefetches, stats().prefetches);
+}
+
+int main() {
+    standinSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t localLen = sizeof(local);
+    bind(standinSocket, (sockaddr*)&local, sizeof(local));
+    getsockname(standinSocket, (sockaddr*)&local, &localLen);
+    hostUdpPortOffset = (uint16_t)(ntohs(local.sin_port) - DNS_PORT);
+    WiFi.hostDns[0] = IPAddress(127, 0, 0, 1);
+    std::thread standin(serve);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_prefetch_before_begin_is_ignored);
+    RUN_TEST(test_literal_address_needs_no_lookup);
+    RUN_TEST(test_lookup_is_cached_for_its_ttl);
+    RUN_TEST(test_timeout_falls_back_to_the_stale_address);
+    RUN_TEST(test_nxdomain_falls_back_at_once);
+    RUN_TEST(test_offline_skips_the_query);
+    RUN_TEST(test_prefetch_refreshes_an_entry_expiring_before_the_fetch);
+    RUN_TEST(test_prefetch_waits_for_the_lead_time);
+    RUN_TEST(test_prefetch_skips);
+    int failures = UNITY_END();
+
+    standinStopping = true;
+    standin.join();
+    close(standinSocket);
+    return failures;
+}
@@ -0,0 +1,325 @@
+#include <unity.h>
+#include <string.h>
+#include "fetch_stats.h"
+
+// ErrorHandler::ErrorType order (weather_api.h pulls in Arduino)
+enum { HTTP_ERROR = 0, JSON_ERROR, NETWORK_ERROR, TIME_SYNC_ERROR };
+
+// One scripted fetch: phase durations in FetchPhase order, 0xFFFF = phase never reached
+struct Script {
+    uint16_t phaseMs[FETCH_PHASE_COUNT];
+    int status;
+    uint32_t bytes;
+    uint8_t error;   // FETCH_NO_ERROR for a success
+};
+
+static const uint16_t SKIP = 0xFFFF;
+
+static FetchRecord run(FetchTrace& trace, uint32_t start, const Script& s) {
+    trace.begin(start);
+    uint32_t now = start;
+    for (uint8_t p = 0; p < FETCH_PHASE_COUNT; p++) {
+        if (s.phaseMs[p] == SKIP) {
+            continue;
+        }
+        now += s.phaseMs[p];
+        trace.endPhase((FetchPhase)p, now);
+    }
+    if (s.status != 0) {
+        trace.setStatus(s.status);
+    }
+    trace.addBytes(s.bytes);
+    if (s.error != FETCH_NO_ERROR) {
+        trace.fail(s.error);
+    }
+    return trace.finish(now + 1);   // The caller's bookkeeping after the last phase
+}
+
+static const Script OK_FETCH = {{5, SKIP, 412, 188, 9, 3}, 200, 1843, FETCH_NO_ERROR};
+static const Script DNS_FAILURE = {{SKIP, SKIP, SKIP, SKIP, SKIP, SKIP}, 0, 0, NETWORK_ERROR};
+static const Script TLS_FAILURE = {{12, SKIP, SKIP, SKIP, SKIP, SKIP}, -1, 0, NETWORK_ERROR};
+static const Script SERVER_ERROR = {{0, SKIP, 380, 95, 2, SKIP}, 503, 57, HTTP_ERROR};
+static const Script BAD_JSON = {{0, SKIP, 395, 170, 8, 4}, 200, 1200, JSON_ERROR};
+
+static uint32_t bucketOf(uint32_t ms) {
+    uint8_t i = 0;
+    while (ms > RollingHistogram::bucketLimit(i)) i++;
+    return i;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_trace_charges_time_to_each_phase() {
+    FetchTrace trace;
+    FetchRecord r = run(trace, 100000, OK_FETCH);
+    TEST_ASSERT_EQUAL(100000, r.startMs);
+    TEST_ASSERT_EQUAL(5, r.phaseMs[FETCH_PHASE_DNS]);
+    TEST_ASSERT_EQUAL(0, r.phaseMs[FETCH_PHASE_CONNECT]);
+    TEST_ASSERT_EQUAL(412, r.phaseMs[FETCH_PHASE_TLS]);
+    TEST_ASSERT_EQUAL(188, r.phaseMs[FETCH_PHASE_TTFB]);
+    TEST_ASSERT_EQUAL(9, r.phaseMs[FETCH_PHASE_BODY]);
+    TEST_ASSERT_EQUAL(3, r.phaseMs[FETCH_PHASE_PARSE]);
+    TEST_ASSERT_EQUAL(618, r.totalMs);
+    TEST_ASSERT_EQUAL_HEX8(0x3D, r.phases);   // Everything but connect
+    TEST_ASSERT_EQUAL(200, r.httpStatus);
+    TEST_ASSERT_EQUAL(1843, r.bytes);
+    TEST_ASSERT_EQUAL(FETCH_NO_ERROR, r.error);
+
+    char line[96];
+    size_t n = formatFetchRecord(r, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("dns 5 tls 412 ttfb 188 body 9 parse 3 = 618 ms, 1843 B, HTTP 200", line);
+    TEST_ASSERT_EQUAL(strlen(line), n);
+}
+
+void test_trace_accumulates_and_saturates() {
+    FetchTrace trace;
+    trace.begin(0xFFFFFF00u);   // Across the millis() wrap
+    trace.endPhase(FETCH_PHASE_DNS, 0xFFFFFF10u);
+    trace.endPhase(FETCH_PHASE_BODY, 0x00000010u);
+    trace.endPhase(FETCH_PHASE_BODY, 0x00000030u);   // Chunks add up
+    trace.addBytes(40000);
+    trace.addBytes(40000);
+    trace.setStatus(70000);
+    const FetchRecord& r = trace.finish(0x00000040u);
+    TEST_ASSERT_EQUAL(16, r.phaseMs[FETCH_PHASE_DNS]);
+    TEST_ASSERT_EQUAL(0x100 + 0x20, r.phaseMs[FETCH_PHASE_BODY]);
+    TEST_ASSERT_EQUAL(0x140, r.totalMs);
+    TEST_ASSERT_EQUAL(0xFFFF, r.bytes);
+    TEST_ASSERT_EQUAL(32767, r.httpStatus);
+
+    trace.begin(0);
+    trace.endPhase(FETCH_PHASE_TLS, 50000);
+    trace.endPhase(FETCH_PHASE_TLS, 100000);
+    trace.setStatus(-70000);
+    trace.finish(200000);
+    TEST_ASSERT_EQUAL(0xFFFF, trace.current().phaseMs[FETCH_PHASE_TLS]);
+    TEST_ASSERT_EQUAL(0xFFFF, trace.current().totalMs);
+    TEST_ASSERT_EQUAL(-32768, trace.current().httpStatus);
+    TEST_ASSERT_EQUAL(0, trace.current().bytes);   // begin() cleared the last fetch
+}
+
+void test_trace_keeps_first_failure() {
+    FetchTrace trace;
+    trace.begin(0);
+    trace.fail(NETWORK_ERROR);
+    trace.fail(JSON_ERROR);
+    TEST_ASSERT_EQUAL(NETWORK_ERROR, trace.finish(10).error);
+    trace.begin(20);
+    TEST_ASSERT_EQUAL(FETCH_NO_ERROR, trace.current().error);
+}
+
+void test_format_edge_cases() {
+    FetchTrace trace;
+    FetchRecord failed = run(trace, 0, DNS_FAILURE);
+    char line[96];
+    formatFetchRecord(failed, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("= 1 ms, 0 B", line);
+
+    FetchRecord refused = run(trace, 0, TLS_FAILURE);
+    formatFetchRecord(refused, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("dns 12 = 13 ms, 0 B, HTTP -1", line);
+
+    // Every short buffer ends in a terminator and reports what it holds
+    FetchRecord ok = run(trace, 0, OK_FETCH);
+    char full[96];
+    formatFetchRecord(ok, full, sizeof(full));
+    for (size_t size = 1; size < strlen(full) + 2; size++) {
+        char small[96];
+        memset(small, '#', sizeof(small));
+        size_t n = formatFetchRecord(ok, small, size);
+        TEST_ASSERT_EQUAL(strlen(small), n);
+        TEST_ASSERT_TRUE(n < size);
+        TEST_ASSERT_EQUAL(0, strncmp(full, small, n));
+        TEST_ASSERT_EQUAL('#', small[size]);
+    }
+    TEST_ASSERT_EQUAL(0, formatFetchRecord(ok, line, 0));
+}
+
+void test_histogram_buckets() {
+    RollingHistogram h;
+    TEST_ASSERT_EQUAL(0, h.count());
+    TEST_ASSERT_EQUAL(0, h.percentile(50));
+    TEST_ASSERT_EQUAL(0, h.maxMs());
+
+    const uint32_t samples[] = {0, 5, 6, 10, 11, 10000, 10001, 0xFFFFFFFFu};
+    const uint8_t expected[] = {0, 0, 1, 1, 2, 10, 11, 11};
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        TEST_ASSERT_EQUAL(expected[i], bucketOf(samples[i]));
+        h.add(samples[i]);
+    }
+    TEST_ASSERT_EQUAL(2, h.bucket(0));
+    TEST_ASSERT_EQUAL(2, h.bucket(1));
+    TEST_ASSERT_EQUAL(1, h.bucket(2));
+    TEST_ASSERT_EQUAL(1, h.bucket(10));
+    TEST_ASSERT_EQUAL(2, h.bucket(11));
+    TEST_ASSERT_EQUAL(0xFFFFFFFFu, h.maxMs());
+    TEST_ASSERT_EQUAL(UINT32_MAX, RollingHistogram::bucketLimit(FETCH_HISTOGRAM_BUCKETS - 1));
+}
+
+void test_percentile_ranks() {
+    RollingHistogram h;
+    // 10 samples: 6 at 40 ms (50 bucket), 3 at 150 ms (200 bucket), 1 at 730 ms (1000 bucket)
+    for (int i = 0; i < 6; i++) h.add(40);
+    for (int i = 0; i < 3; i++) h.add(150);
+    h.add(730);
+
+    TEST_ASSERT_EQUAL(50, h.percentile(0));     // Still the first sample
+    TEST_ASSERT_EQUAL(50, h.percentile(50));
+    TEST_ASSERT_EQUAL(50, h.percentile(60));    // Rank 6 is the last 40 ms sample
+    TEST_ASSERT_EQUAL(200, h.percentile(61));   // Rank 7 rounds up
+    TEST_ASSERT_EQUAL(200, h.percentile(90));
+    TEST_ASSERT_EQUAL(730, h.percentile(91));   // Capped at the max instead of 1000
+    TEST_ASSERT_EQUAL(730, h.percentile(100));
+    TEST_ASSERT_EQUAL(730, h.percentile(255));  // Nonsense ranks fall back to the max
+
+    RollingHistogram single;
+    single.add(3);
+    TEST_ASSERT_EQUAL(3, single.percentile(50));   // Under the first bucket's bound
+}
+
+void test_histogram_window_rollover() {
+    RollingHistogram h;
+    // A slow window, then fast ones: the slow samples leave after two rollovers
+    for (int i = 0; i < FETCH_HISTOGRAM_WINDOW; i++) h.add(3000);
+    TEST_ASSERT_EQUAL(FETCH_HISTOGRAM_WINDOW, h.count());
+    for (int i = 0; i < FETCH_HISTOGRAM_WINDOW; i++) h.add(80);
+    TEST_ASSERT_EQUAL(2 * FETCH_HISTOGRAM_WINDOW, h.count());   // Both windows full
+    TEST_ASSERT_EQUAL(FETCH_HISTOGRAM_WINDOW, h.bucket(bucketOf(3000)));
+    TEST_ASSERT_EQUAL(3000, h.maxMs());
+    TEST_ASSERT_EQUAL(100, h.percentile(50));
+    TEST_ASSERT_EQUAL(3000, h.percentile(51));
+
+    h.add(80);   // Starts a new window; the slow one is dropped whole
+    TEST_ASSERT_EQUAL(FETCH_HISTOGRAM_WINDOW + 1, h.count());
+    TEST_ASSERT_EQUAL(0, h.bucket(bucketOf(3000)));
+    TEST_ASSERT_EQUAL(80, h.maxMs());
+    TEST_ASSERT_EQUAL(80, h.percentile(99));
+
+    // The max of the kept window survives while the new one fills with faster samples
+    for (int i = 1; i < FETCH_HISTOGRAM_WINDOW; i++) h.add(7);
+    TEST_ASSERT_EQUAL(2 * FETCH_HISTOGRAM_WINDOW, h.count());
+    TEST_ASSERT_EQUAL(80, h.maxMs());
+    h.add(7);
+    TEST_ASSERT_EQUAL(FETCH_HISTOGRAM_WINDOW + 1, h.count());
+    TEST_ASSERT_EQUAL(80, h.maxMs());   // Its single 80 ms sample is in the kept window
+    for (int i = 1; i < FETCH_HISTOGRAM_WINDOW; i++) h.add(7);
+    h.add(7);
+    TEST_ASSERT_EQUAL(7, h.maxMs());
+    TEST_ASSERT_EQUAL(7, h.percentile(50));   // The 10 ms bucket, capped at the max
+}
+
+void test_stats_count_only_phases_that_ran() {
+    FetchTrace trace;
+    FetchStats stats;
+    const Script* scripts[] = {&OK_FETCH, &DNS_FAILURE, &TLS_FAILURE, &SERVER_ERROR, &BAD_JSON, &OK_FETCH};
+    uint32_t start = 0;
+    for (const Script* s : scripts) {
+        stats.record(run(trace, start, *s));
+        start += 180000;
+    }
+
+    TEST_ASSERT_EQUAL(6, stats.fetches());
+    TEST_ASSERT_EQUAL(1843 + 57 + 1200 + 1843, stats.bytesReceived());
+    TEST_ASSERT_EQUAL(1, stats.failures(HTTP_ERROR));
+    TEST_ASSERT_EQUAL(1, stats.failures(JSON_ERROR));
+    TEST_ASSERT_EQUAL(2, stats.failures(NETWORK_ERROR));
+    TEST_ASSERT_EQUAL(0, stats.failures(TIME_SYNC_ERROR));
+
+    TEST_ASSERT_EQUAL(5, stats.phase(FETCH_PHASE_DNS).count());    // Not the failed lookup
+    TEST_ASSERT_EQUAL(0, stats.phase(FETCH_PHASE_CONNECT).count());
+    TEST_ASSERT_EQUAL(4, stats.phase(FETCH_PHASE_TLS).count());    // Nor the refused handshake
+    TEST_ASSERT_EQUAL(4, stats.phase(FETCH_PHASE_BODY).count());
+    TEST_ASSERT_EQUAL(3, stats.phase(FETCH_PHASE_PARSE).count());
+    TEST_ASSERT_EQUAL(6, stats.total().count());                   // Every fetch has a total
+    TEST_ASSERT_EQUAL(412, stats.phase(FETCH_PHASE_TLS).maxMs());
+    TEST_ASSERT_EQUAL(412, stats.phase(FETCH_PHASE_TLS).percentile(50));
+    TEST_ASSERT_EQUAL(12, stats.phase(FETCH_PHASE_DNS).maxMs());
+
+    // Errors outside the counted types are kept in the record but not counted
+    FetchRecord odd = run(trace, start, OK_FETCH);
+    odd.error = STATUS_ERROR_TYPES;
+    stats.record(odd);
+    TEST_ASSERT_EQUAL(7, stats.fetches());
+    TEST_ASSERT_EQUAL(2, stats.failures(NETWORK_ERROR));
+}
+
+void test_history_ring_keeps_latest() {
+    FetchTrace trace;
+    FetchStats stats;
+    TEST_ASSERT_EQUAL(0, stats.historyCount());
+    const int extra = 3;
+    for (int i = 0; i < FETCH_HISTORY + extra; i++) {
+        stats.record(run(trace, (uint32_t)i * 1000, i % 4 == 1 ? DNS_FAILURE : OK_FETCH));
+        TEST_ASSERT_EQUAL(i < FETCH_HISTORY ? i + 1 : FETCH_HISTORY, stats.historyCount());
+        TEST_ASSERT_EQUAL((uint32_t)i * 1000, stats.history(stats.historyCount() - 1).startMs);
+    }
+    for (int i = 0; i < FETCH_HISTORY; i++) {
+        uint32_t n = (uint32_t)(i + extra);
+        TEST_ASSERT_EQUAL(n * 1000, stats.history((uint8_t)i).startMs);
+        TEST_ASSERT_EQUAL(n % 4 == 1 ? NETWORK_ERROR : FETCH_NO_ERROR, stats.history((uint8_t)i).error);
+    }
+}
+
+void test_status_slots_overflow() {
+    FetchStats stats;
+    FetchRecord r;
+    memset(&r, 0, sizeof(r));
+    r.error = FETCH_NO_ERROR;
+
+    stats.record(r);   // No response: not a status
+    TEST_ASSERT_EQUAL(0, stats.statusCodes());
+
+    const int16_t codes[] = {200, 429, -1, 503, 500, 404, 401, 502};
+    static_assert(sizeof(codes) / sizeof(codes[0]) == FETCH_STATUS_SLOTS, "one code per slot");
+    for (int16_t code : codes) {
+        r.httpStatus = code;
+        stats.record(r);
+        stats.record(r);
+    }
+    r.httpStatus = 200;
+    stats.record(r);
+    TEST_ASSERT_EQUAL(FETCH_STATUS_SLOTS, stats.statusCodes());
+    TEST_ASSERT_EQUAL(0, stats.otherStatusHits());
+
+    // New codes once the table is full share one counter; known ones keep their slot
+    r.httpStatus = 301;
+    stats.record(r);
+    r.httpStatus = -11;
+    stats.record(r);
+    stats.record(r);
+    r.httpStatus = 429;
+    stats.record(r);
+    TEST_ASSERT_EQUAL(FETCH_STATUS_SLOTS, stats.statusCodes());
+    TEST_ASSERT_EQUAL(3, stats.otherStatusHits());
+
+    for (uint8_t i = 0; i < FETCH_STATUS_SLOTS; i++) {
+        TEST_ASSERT_EQUAL(codes[i], stats.statusCode(i));   // In order of first appearance
+        uint32_t expected = codes[i] == 200 || codes[i] == 429 ? 3 : 2;
+        TEST_ASSERT_EQUAL(expected, stats.statusHits(i));
+    }
+    TEST_ASSERT_EQUAL(2 * FETCH_STATUS_SLOTS + 6, stats.fetches());
+}
+
+void test_phase_names() {
+    TEST_ASSERT_EQUAL_STRING("dns", fetchPhaseName(FETCH_PHASE_DNS));
+    TEST_ASSERT_EQUAL_STRING("connect", fetchPhaseName(FETCH_PHASE_CONNECT));
+    TEST_ASSERT_EQUAL_STRING("parse", fetchPhaseName(FETCH_PHASE_PARSE));
+    TEST_ASSERT_EQUAL_STRING("?", fetchPhaseName(FETCH_PHASE_COUNT));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_trace_charges_time_to_each_phase);
+    RUN_TEST(test_trace_accumulates_and_saturates);
+    RUN_TEST(test_trace_keeps_first_failure);
+    RUN_TEST(test_format_edge_cases);
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_percentile_ranks);
+    RUN_TEST(test_histogram_window_rollover);
+    RUN_TEST(test_stats_count_only_phases_that_ran);
+    RUN_TEST(test_history_ring_keeps_latest);
+    RUN_TEST(test_status_slots_overflow);
+    RUN_TEST(test_phase_names);
+    return UNITY_END();
+}
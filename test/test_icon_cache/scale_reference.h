@@ -0,0 +1,118 @@
+// Generated by tools/icon_scale_reference.py - do not edit.
+// Exact area-average reference for scaleAlphaArea(), rounded half up.
+
+#ifndef SCALE_REFERENCE_H
+#define SCALE_REFERENCE_H
+
+#include <stdint.h>
+
+#define SYNTHETIC_SIZE 8
+
+static const uint8_t SYNTHETIC_MASTER[64] = {
+    0, 37, 74, 111, 148, 0, 222, 3, 11, 48, 85, 122, 0, 196, 233, 14,
+    22, 59, 96, 0, 170, 207, 244, 25, 33, 70, 255, 144, 181, 218, 255, 0,
+    44, 255, 118, 155, 192, 229, 0, 47, 255, 92, 129, 166, 203, 0, 21, 58,
+    66, 103, 140, 177, 255, 251, 32, 69, 77, 114, 151, 255, 225, 6, 43, 80,
+};
+
+struct ScaledReference {
+    uint8_t size;
+    uint8_t pixels[144];
+};
+
+static const ScaledReference SYNTHETIC_SCALED[] = {
+    {1, {
+        114,
+    }},
+    {3, {
+        42, 96, 123, 119, 165, 107, 119, 193, 63,
+    }},
+    {5, {
+        18, 74, 104, 114, 89, 35, 91, 89, 205, 103, 85, 176, 168, 195, 63, 157,
+        131, 191, 89, 45, 87, 147, 231, 100, 62,
+    }},
+    {7, {
+        6, 48, 89, 121, 64, 174, 32, 18, 60, 89, 67, 140, 227, 44, 31, 86,
+        118, 114, 197, 239, 45, 54, 169, 173, 168, 210, 152, 37, 173, 146, 139, 180,
+        128, 31, 49, 112, 110, 151, 208, 208, 69, 62, 80, 122, 185, 237, 109, 40,
+        74,
+    }},
+    {8, {
+        0, 37, 74, 111, 148, 0, 222, 3, 11, 48, 85, 122, 0, 196, 233, 14,
+        22, 59, 96, 0, 170, 207, 244, 25, 33, 70, 255, 144, 181, 218, 255, 0,
+        44, 255, 118, 155, 192, 229, 0, 47, 255, 92, 129, 166, 203, 0, 21, 58,
+        66, 103, 140, 177, 255, 251, 32, 69, 77, 114, 151, 255, 225, 6, 43, 80,
+    }},
+    {12, {
+        0, 19, 37, 74, 93, 111, 148, 74, 0, 222, 113, 3, 6, 24, 43, 80,
+        98, 117, 74, 86, 98, 228, 118, 9, 11, 30, 48, 85, 104, 122, 0, 98,
+        196, 233, 124, 14, 22, 41, 59, 96, 48, 0, 170, 189, 207, 244, 135, 25,
+        28, 46, 65, 176, 124, 72, 176, 194, 213, 250, 131, 13, 33, 52, 70, 255,
+        200, 144, 181, 200, 218, 255, 128, 0, 44, 150, 255, 118, 137, 155, 192, 211,
+        229, 0, 24, 47, 150, 162, 174, 124, 142, 161, 198, 156, 115, 11, 32, 53,
+        255, 174, 92, 129, 148, 166, 203, 102, 0, 21, 40, 58, 66, 85, 103, 140,
+        159, 177, 255, 253, 251, 32, 51, 69, 72, 90, 109, 146, 181, 216, 240, 184,
+        129, 38, 56, 75, 77, 96, 114, 151, 203, 255, 225, 116, 6, 43, 62, 80,
+    }},
+};
+
+// include/weather_icons.h masters (64x64) at the drawing sizes
+struct MasterReference {
+    uint8_t master;     // Index into weather_icon_blobs
+    uint8_t size;
+    uint32_t fnv1a;     // Hash of the scaled size x size bytes
+    uint8_t centre;     // Pixel (size / 2, size / 2)
+};
+
+static const MasterReference MASTER_SCALED[] = {
+    {0, 16, 0xB4A813A1u, 255},
+    {0, 24, 0xCD1B87FAu, 255},
+    {0, 32, 0xDA9C4136u, 255},
+    {0, 40, 0xF4DA18EDu, 255},
+    {0, 48, 0xABFB276Du, 255},
+    {0, 64, 0xEB060577u, 255},
+    {1, 16, 0xB6F57F1Fu, 254},
+    {1, 24, 0xA3C0CED4u, 255},
+    {1, 32, 0x8ACF4AC3u, 255},
+    {1, 40, 0x670EDEEEu, 255},
+    {1, 48, 0x9A60C8FDu, 255},
+    {1, 64, 0xE92F9231u, 255},
+    {2, 16, 0xB482FA3Du, 255},
+    {2, 24, 0xE1C7F8FAu, 255},
+    {2, 32, 0x60819BAFu, 255},
+    {2, 40, 0xE1F189BEu, 255},
+    {2, 48, 0xEE61BC72u, 255},
+    {2, 64, 0xD997EFC0u, 255},
+    {3, 16, 0xA14883B1u, 254},
+    {3, 24, 0x9FAA3370u, 255},
+    {3, 32, 0x43A3EAE5u, 255},
+    {3, 40, 0x949123C3u, 255},
+    {3, 48, 0x41518C34u, 255},
+    {3, 64, 0x35C12FF0u, 255},
+    {4, 16, 0x0161C7E7u, 1},
+    {4, 24, 0x16EB644Fu, 1},
+    {4, 32, 0x0232DC39u, 1},
+    {4, 40, 0xC10E6E16u, 1},
+    {4, 48, 0xAD45C8B6u, 1},
+    {4, 64, 0xB66E9053u, 0},
+    {5, 16, 0x85244176u, 145},
+    {5, 24, 0x13E342BCu, 201},
+    {5, 32, 0x2A00FD3Cu, 234},
+    {5, 40, 0xCBBB4C44u, 237},
+    {5, 48, 0xFF3CDD1Du, 241},
+    {5, 64, 0xFB167D31u, 250},
+    {6, 16, 0xB425FC94u, 247},
+    {6, 24, 0xF29357F6u, 252},
+    {6, 32, 0x0300B99Fu, 254},
+    {6, 40, 0x45DE80EEu, 254},
+    {6, 48, 0xA4E66459u, 254},
+    {6, 64, 0xC9C089E8u, 255},
+    {7, 16, 0x155FD45Du, 142},
+    {7, 24, 0x16BD5299u, 191},
+    {7, 32, 0xC9810F86u, 220},
+    {7, 40, 0xD43C2BC5u, 226},
+    {7, 48, 0xAE3ECF8Au, 233},
+    {7, 64, 0xDBC8403Du, 247},
+};
+
+#endif // SCALE_REFERENCE_H
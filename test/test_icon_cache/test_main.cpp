@@ -0,0 +1,282 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "icon_cache.h"
+#include "weather_icons.h"
+#include "scale_reference.h"
+
+static IconCache cache;
+static uint8_t masters[ICON_CACHE_SLOTS + 2][16];   // Distinct 4x4 masters, told apart by address
+
+static uint32_t fnv1a(const uint8_t* data, size_t length) {
+    uint32_t h = 0x811C9DC5u;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ data[i]) * 0x01000193u;
+    }
+    return h;
+}
+
+void setUp() {
+    cache.clear();
+    for (int m = 0; m < ICON_CACHE_SLOTS + 2; m++) {
+        memset(masters[m], 40 * m, sizeof(masters[m]));
+    }
+}
+void tearDown() {}
+
+void test_scale_matches_reference() {
+    for (const ScaledReference& ref : SYNTHETIC_SCALED) {
+        uint8_t out[sizeof(ref.pixels)];
+        scaleAlphaArea(SYNTHETIC_MASTER, SYNTHETIC_SIZE, out, ref.size);
+        char message[32];
+        snprintf(message, sizeof(message), "size %u", ref.size);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(ref.pixels, out, ref.size * ref.size, message);
+    }
+}
+
+void test_scale_icon_masters_match_reference() {
+    static uint8_t out[64 * 64];
+    for (const MasterReference& ref : MASTER_SCALED) {
+        const WeatherIcon& icon = weather_icon_blobs[ref.master];
+        scaleAlphaArea(icon.alpha, icon.size, out, ref.size);
+        char message[48];
+        snprintf(message, sizeof(message), "master %u at %u", ref.master, ref.size);
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE(ref.centre, out[(ref.size / 2) * ref.size + ref.size / 2], message);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(ref.fnv1a, fnv1a(out, ref.size * ref.size), message);
+    }
+}
+
+void test_scale_preserves_flat_and_identity() {
+    uint8_t flat[48 * 48];
+    memset(flat, 200, sizeof(flat));
+    uint8_t out[40 * 40];
+    scaleAlphaArea(flat, 48, out, 40);
+    for (int i = 0; i < 40 * 40; i++) {
+        TEST_ASSERT_EQUAL_UINT8(200, out[i]);
+    }
+    uint8_t same[SYNTHETIC_SIZE * SYNTHETIC_SIZE];
+    scaleAlphaArea(SYNTHETIC_MASTER, SYNTHETIC_SIZE, same, SYNTHETIC_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(SYNTHETIC_MASTER, same, sizeof(same));
+}
+
+void test_cache_hits_and_premultiplies() {
+    const IconImage* a = cache.get(masters[1], 4, 0xF81F, 3);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_EQUAL(3, a->size);
+    for (int i = 0; i < 9; i++) {
+        TEST_ASSERT_EQUAL_UINT8(40, a->alpha[i]);
+        TEST_ASSERT_EQUAL_HEX16(premultiply565(0xF81F, 40), a->color[i]);
+    }
+    TEST_ASSERT_EQUAL_PTR(a, cache.get(masters[1], 4, 0xF81F, 3));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+    TEST_ASSERT_EQUAL_UINT32(1, cache.misses());
+
+    // Size and tint are part of the key
+    TEST_ASSERT_NOT_EQUAL(a, cache.get(masters[1], 4, 0xF81F, 2));
+    TEST_ASSERT_NOT_EQUAL(a, cache.get(masters[1], 4, 0x07E0, 3));
+    TEST_ASSERT_EQUAL_UINT32(3, cache.misses());
+}
+
+void test_cache_rejects_bad_sizes() {
+    TEST_ASSERT_NULL(cache.get(masters[0], 4, 0xFFFF, 0));
+    TEST_ASSERT_NULL(cache.get(masters[0], 4, 0xFFFF, ICON_CACHE_MAX_SIZE + 1));
+    TEST_ASSERT_NULL(cache.get(nullptr, 4, 0xFFFF, 4));
+    TEST_ASSERT_NOT_NULL(cache.get(masters[0], 4, 0xFFFF, ICON_CACHE_MAX_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.misses());
+}
+
+// Miss count after fetching m - tells whether it was still cached
+static uint32_t fetch(int m) {
+    cache.get(masters[m], 4, 0xFFFF, 4);
+    return cache.misses();
+}
+
+void test_cache_evicts_least_recently_used() {
+    for (int m = 0; m < ICON_CACHE_SLOTS; m++) {
+        fetch(m);
+    }
+    TEST_ASSERT_EQUAL_UINT32(ICON_CACHE_SLOTS, cache.misses());
+    // Touch all but masters[1]; it becomes the oldest
+    for (int m = 0; m < ICON_CACHE_SLOTS; m++) {
+        if (m != 1) fetch(m);
+    }
+    TEST_ASSERT_EQUAL_UINT32(ICON_CACHE_SLOTS, cache.misses());
+
+    fetch(ICON_CACHE_SLOTS);                      // New entry evicts masters[1]
+    uint32_t misses = cache.misses();
+    TEST_ASSERT_EQUAL_UINT32(misses, fetch(0));   // Still there
+    TEST_ASSERT_EQUAL_UINT32(misses, fetch(2));
+    TEST_ASSERT_EQUAL_UINT32(misses + 1, fetch(1));   // Gone: rebuilt, evicting masters[3]
+    TEST_ASSERT_EQUAL_UINT32(misses + 1, fetch(ICON_CACHE_SLOTS));
+    TEST_ASSERT_EQUAL_UINT32(misses + 2, fetch(3));
+}
+
+void test_evicted_slot_is_rebuilt_in_place() {
+    const IconImage* first = cache.get(masters[0], 4, 0xFFFF, 2);
+    for (int m = 1; m < ICON_CACHE_SLOTS; m++) {
+        cache.get(masters[m], 4, 0xFFFF, 2);
+    }
+    const IconImage* replaced = cache.get(masters[ICON_CACHE_SLOTS], 4, 0xFFFF, 2);
+    TEST_ASSERT_EQUAL_PTR(first, replaced);          // The oldest slot is reused
+    TEST_ASSERT_EQUAL_UINT8(40 * ICON_CACHE_SLOTS, replaced->alpha[0]);
+}
+
+void test_clear_empties_cache() {
+    fetch(0);
+    fetch(0);
+    cache.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, cache.hits());
+    TEST_ASSERT_EQUAL_UINT32(0, cache.misses());
+    TEST_ASSERT_EQUAL_UINT32(1, fetch(0));
+}
+
+void test_div255_exact() {
+    for (uint32_t x = 0; x <= 65535; x++) {
+        TEST_ASSERT_EQUAL_UINT32((x + 127) / 255, div255(x));
+    }
+}
+
+// One channel of a 565 color
+static uint32_t channel(uint16_t c, int shift, uint32_t mask) {
+    return (c >> shift) & mask;
+}
+
+// Premultiplied blend against straight float "tint * a + dst * (1 - a)", per channel
+void test_blend_within_one_lsb_of_float() {
+    const int shifts[3] = {11, 5, 0};
+    const uint32_t masks[3] = {0x1F, 0x3F, 0x1F};
+    int worst = 0;
+    for (int ch = 0; ch < 3; ch++) {
+        for (uint32_t t = 0; t <= masks[ch]; t++) {
+            for (uint32_t d = 0; d <= masks[ch]; d++) {
+                uint16_t tint = (uint16_t)(t << shifts[ch]);
+                uint16_t dst = (uint16_t)(d << shifts[ch]);
+                for (int a = 0; a <= 255; a++) {
+                    uint16_t out = blendOver565(premultiply565(tint, (uint8_t)a), (uint8_t)a, dst);
+                    double alpha = a / 255.0;
+                    double expected = t * alpha + d * (1.0 - alpha);
+                    int diff = abs((int)channel(out, shifts[ch], masks[ch]) - (int)lround(expected));
+                    if (diff > worst) worst = diff;
+                }
+            }
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(1, worst);
+}
+
+// Cross-fade mix is rounded exactly
+void test_lerp_within_one_lsb_of_float() {
+    const int shifts[3] = {11, 5, 0};
+    const uint32_t masks[3] = {0x1F, 0x3F, 0x1F};
+    for (int ch = 0; ch < 3; ch++) {
+        for (uint32_t x = 0; x <= masks[ch]; x++) {
+            for (uint32_t y = 0; y <= masks[ch]; y++) {
+                for (int mix = 0; mix <= 255; mix++) {
+                    uint16_t out = lerp565((uint16_t)(x << shifts[ch]), (uint16_t)(y << shifts[ch]), (uint8_t)mix);
+                    double expected = x + (double)((int)y - (int)x) * mix / 255.0;
+                    TEST_ASSERT_TRUE(fabs(channel(out, shifts[ch], masks[ch]) - expected) <= 0.5);
+                }
+            }
+        }
+    }
+    // Endpoints are exact
+    TEST_ASSERT_EQUAL_HEX16(0x1234, lerp565(0x1234, 0xFEDC, 0));
+    TEST_ASSERT_EQUAL_HEX16(0xFEDC, lerp565(0x1234, 0xFEDC, 255));
+}
+
+void test_blit_clips_and_skips_transparent() {
+    static uint16_t fb[8 * 6];
+    const uint16_t background = 0x0841;
+    uint8_t alpha[9] = {0, 255, 128, 0, 255, 0, 64, 0, 255};
+    uint16_t color[9];
+    for (int i = 0; i < 9; i++) color[i] = premultiply565(0xFFFF, alpha[i]);
+    IconImage icon = {alpha, color, 3};
+
+    // Only the top-left 2x2 of the icon is inside
+    for (int i = 0; i < 8 * 6; i++) fb[i] = background;
+    blitIcon(fb, 8, 6, 6, 4, icon, background, false);
+    TEST_ASSERT_EQUAL_HEX16(background, fb[4 * 8 + 6]);   // Transparent: untouched
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, fb[4 * 8 + 7]);       // Opaque: copied
+    TEST_ASSERT_EQUAL_HEX16(background, fb[5 * 8 + 6]);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, fb[5 * 8 + 7]);
+    int changed = 0;
+    for (int i = 0; i < 8 * 6; i++) changed += fb[i] != background;
+    TEST_ASSERT_EQUAL(2, changed);
+
+    // Partial alpha blends onto the background; negative origin clips the other way
+    for (int i = 0; i < 8 * 6; i++) fb[i] = background;
+    blitIcon(fb, 8, 6, -1, -1, icon, background, false);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, fb[0]);                                       // alpha[4]
+    TEST_ASSERT_EQUAL_HEX16(background, fb[1]);                                   // alpha[5]
+    TEST_ASSERT_EQUAL_HEX16(blendOver565(color[8], 255, background), fb[8 + 1]);  // alpha[8]
+    TEST_ASSERT_EQUAL_HEX16(background, fb[8]);                                   // alpha[7]
+
+    uint16_t swapped[1] = {0};
+    uint8_t one = 255;
+    uint16_t red = 0xF800;
+    IconImage dot = {&one, &red, 1};
+    blitIcon(swapped, 1, 1, 0, 0, dot, 0, true);
+    TEST_ASSERT_EQUAL_HEX16(0x00F8, swapped[0]);
+    uint8_t half = 128;
+    uint16_t halfRed = premultiply565(0xF800, 128);
+    IconImage soft = {&half, &halfRed, 1};
+    blitIcon(swapped, 1, 1, 0, 0, soft, 0x001F, false);
+    TEST_ASSERT_EQUAL_HEX16(blendOver565(halfRed, 128, 0x001F), swapped[0]);
+}
+
+// Draw cost of each master at the drawing size, plain and mid cross-fade
+void test_bench_icon_draw() {
+    static uint16_t fb[SPRITE_WIDTH * SPRITE_HEIGHT];
+    const int rounds = 2000;
+    const uint16_t background = 0x18E3;
+    int masterCount = sizeof(weather_icon_blobs) / sizeof(weather_icon_blobs[0]);
+    const IconImage* previous = nullptr;
+    for (int m = 0; m < masterCount; m++) {
+        const WeatherIcon& w = weather_icon_blobs[m];
+        const IconImage* image = cache.get(w.alpha, w.size, w.color, ICON_DRAW_SIZE);
+        TEST_ASSERT_NOT_NULL(image);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            blitIcon(fb, SPRITE_WIDTH, SPRITE_HEIGHT, 200, 60, *image, background, true);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            blitIconCrossFade(fb, SPRITE_WIDTH, SPRITE_HEIGHT, 200, 60, previous, *image, 128, background, true);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        int opaque = 0, edge = 0;
+        for (int i = 0; i < image->size * image->size; i++) {
+            if (image->alpha[i] == 255) opaque++;
+            else if (image->alpha[i] != 0) edge++;
+        }
+        char line[128];
+        snprintf(line, sizeof(line), "master %d at %d px: blit %.0f ns, cross-fade %.0f ns (%d opaque, %d edge pixels)",
+                 m, ICON_DRAW_SIZE,
+                 std::chrono::duration<double, std::nano>(t1 - t0).count() / rounds,
+                 std::chrono::duration<double, std::nano>(t2 - t1).count() / rounds, opaque, edge);
+        TEST_MESSAGE(line);
+        previous = image;   // Still cached: the LRU only evicts older masters
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_scale_matches_reference);
+    RUN_TEST(test_scale_icon_masters_match_reference);
+    RUN_TEST(test_scale_preserves_flat_and_identity);
+    RUN_TEST(test_cache_hits_and_premultiplies);
+    RUN_TEST(test_cache_rejects_bad_sizes);
+    RUN_TEST(test_cache_evicts_least_recently_used);
+    RUN_TEST(test_evicted_slot_is_rebuilt_in_place);
+    RUN_TEST(test_clear_empties_cache);
+    RUN_TEST(test_div255_exact);
+    RUN_TEST(test_blend_within_one_lsb_of_float);
+    RUN_TEST(test_lerp_within_one_lsb_of_float);
+    RUN_TEST(test_blit_clips_and_skips_transparent);
+    RUN_TEST(test_bench_icon_draw);
+    return UNITY_END();
+}
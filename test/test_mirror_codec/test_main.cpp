@@ -0,0 +1,316 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "mirror_codec.h"
+
+#define FRAME_PIXELS (SPRITE_WIDTH * SPRITE_HEIGHT)
+
+static uint16_t source[FRAME_PIXELS];
+static uint16_t viewer[FRAME_PIXELS];
+static uint8_t packet[MIRROR_HEADER_SIZE + SPRITE_HEIGHT * (MIRROR_RECORD_HEADER_SIZE + MIRROR_RLE_BOUND(SPRITE_WIDTH)) +
+                      MIRROR_TRAILER_SIZE];
+static uint32_t seed;
+
+static uint16_t nextRandom() {
+    seed = seed * 1103515245u + 12345u;
+    return (uint16_t)(seed >> 16);
+}
+
+static void fillNoise(uint16_t* pixels) {
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        pixels[i] = nextRandom();
+    }
+}
+
+// Decodes ops straight from the format in mirror_codec.h, independent of mirrorApply
+static size_t decodeRun(const uint8_t* in, size_t len, uint16_t* out, size_t maxPixels) {
+    size_t pos = 0;
+    size_t pixels = 0;
+    while (pos < len) {
+        uint8_t op = in[pos++];
+        size_t n = (op & 0x7F) + 1;
+        TEST_ASSERT_TRUE(pixels + n <= maxPixels);
+        if (op & 0x80) {
+            uint16_t value;
+            memcpy(&value, in + pos, 2);
+            pos += 2;
+            for (size_t i = 0; i < n; i++) out[pixels + i] = value;
+        } else {
+            memcpy(out + pixels, in + pos, 2 * n);
+            pos += 2 * n;
+        }
+        pixels += n;
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+    return pixels;
+}
+
+static void checkRun(const uint16_t* pixels, uint16_t count) {
+    uint8_t encoded[MIRROR_RLE_BOUND(SPRITE_WIDTH)];
+    uint16_t decoded[SPRITE_WIDTH];
+    size_t len = mirrorEncodeRun(pixels, count, encoded, sizeof(encoded));
+    TEST_ASSERT_GREATER_THAN(0, len);
+    TEST_ASSERT_TRUE(len <= MIRROR_RLE_BOUND(count));
+    TEST_ASSERT_EQUAL(count, decodeRun(encoded, len, decoded, SPRITE_WIDTH));
+    TEST_ASSERT_EQUAL_MEMORY(pixels, decoded, 2 * (size_t)count);
+}
+
+void setUp() {
+    seed = 12345;
+}
+
+void tearDown() {}
+
+void test_repeat_runs_split_at_128() {
+    uint16_t pixels[SPRITE_WIDTH];
+    for (int i = 0; i < SPRITE_WIDTH; i++) pixels[i] = 0xA55A;
+    uint8_t encoded[MIRROR_RLE_BOUND(SPRITE_WIDTH)];
+
+    // 128 fits one op, 129 leaves a single pixel as a literal, 130 two as a repeat
+    TEST_ASSERT_EQUAL(3, mirrorEncodeRun(pixels, 128, encoded, sizeof(encoded)));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, encoded[0]);
+    TEST_ASSERT_EQUAL(6, mirrorEncodeRun(pixels, 129, encoded, sizeof(encoded)));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, encoded[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, encoded[3]);
+    TEST_ASSERT_EQUAL(6, mirrorEncodeRun(pixels, 130, encoded, sizeof(encoded)));
+    TEST_ASSERT_EQUAL_HEX8(0x81, encoded[3]);
+    TEST_ASSERT_EQUAL(9, mirrorEncodeRun(pixels, SPRITE_WIDTH, encoded, sizeof(encoded)));
+
+    static const uint16_t lengths[] = {1, 2, 127, 128, 129, 130, 255, 256, 257, SPRITE_WIDTH};
+    for (uint16_t n : lengths) {
+        checkRun(pixels, n);
+    }
+}
+
+void test_literal_runs_split_at_128() {
+    uint16_t pixels[SPRITE_WIDTH];
+    for (int i = 0; i < SPRITE_WIDTH; i++) pixels[i] = (uint16_t)(i * 7 + 1);
+    uint8_t encoded[MIRROR_RLE_BOUND(SPRITE_WIDTH)];
+
+    TEST_ASSERT_EQUAL(1 + 2 * 128, mirrorEncodeRun(pixels, 128, encoded, sizeof(encoded)));
+    TEST_ASSERT_EQUAL_HEX8(0x7F, encoded[0]);
+    TEST_ASSERT_EQUAL(1 + 2 * 128 + 1 + 2, mirrorEncodeRun(pixels, 129, encoded, sizeof(encoded)));
+    TEST_ASSERT_EQUAL_HEX8(0x00, encoded[1 + 2 * 128]);
+    // All distinct is the worst case the bound is written for
+    TEST_ASSERT_EQUAL(MIRROR_RLE_BOUND(SPRITE_WIDTH), mirrorEncodeRun(pixels, SPRITE_WIDTH, encoded, sizeof(encoded)));
+
+    static const uint16_t lengths[] = {1, 2, 127, 128, 129, 130, 255, 256, 257, SPRITE_WIDTH};
+    for (uint16_t n : lengths) {
+        checkRun(pixels, n);
+    }
+}
+
+void test_mixed_runs_across_boundaries() {
+    uint16_t pixels[SPRITE_WIDTH];
+    // A literal run ending right where a repeat starts, at and either side of 128
+    static const int splits[] = {126, 127, 128, 129, 130};
+    for (int split : splits) {
+        for (int i = 0; i < SPRITE_WIDTH; i++) {
+            pixels[i] = i < split ? (uint16_t)(i + 1) : 0x0000;
+        }
+        checkRun(pixels, SPRITE_WIDTH);
+        for (int i = 0; i < SPRITE_WIDTH; i++) {
+            pixels[i] = i < split ? 0xFFFF : (uint16_t)(i + 1);
+        }
+        checkRun(pixels, SPRITE_WIDTH);
+    }
+    // Pairs and triples, the patterns at the literal/repeat decision
+    for (int i = 0; i < SPRITE_WIDTH; i++) pixels[i] = (uint16_t)(i / 2);
+    checkRun(pixels, SPRITE_WIDTH);
+    for (int i = 0; i < SPRITE_WIDTH; i++) pixels[i] = (uint16_t)(i / 3);
+    checkRun(pixels, SPRITE_WIDTH);
+    for (int i = 0; i < SPRITE_WIDTH; i++) pixels[i] = nextRandom() & 3;
+    checkRun(pixels, SPRITE_WIDTH);
+}
+
+void test_run_too_small_for_output() {
+    uint16_t pixels[129];
+    for (int i = 0; i < 129; i++) pixels[i] = 0x1234;
+    uint8_t encoded[8];
+    TEST_ASSERT_EQUAL(0, mirrorEncodeRun(pixels, 129, encoded, 5));
+    TEST_ASSERT_EQUAL(6, mirrorEncodeRun(pixels, 129, encoded, 6));
+}
+
+void test_first_packet_is_full_keyframe() {
+    MirrorEncoder encoder;
+    MirrorPacketInfo info;
+    fillNoise(source);
+    memset(viewer, 0, sizeof(viewer));
+
+    size_t len = encoder.encode(source, packet, sizeof(packet));
+    TEST_ASSERT_GREATER_THAN(0, len);
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+    TEST_ASSERT_EQUAL_HEX8(MIRROR_FLAG_KEYFRAME, info.flags);
+    TEST_ASSERT_EQUAL(0, info.frame);
+    TEST_ASSERT_EQUAL(SPRITE_HEIGHT, info.records);   // Adjacent spans merge into a record per row
+    TEST_ASSERT_FALSE(encoder.refreshPending());
+    TEST_ASSERT_EQUAL_MEMORY(source, viewer, sizeof(source));
+
+    // Nothing changed: no packet
+    TEST_ASSERT_EQUAL(0, encoder.encode(source, packet, sizeof(packet)));
+    TEST_ASSERT_EQUAL(1, encoder.frameNumber());
+}
+
+void test_changes_send_only_their_spans() {
+    MirrorEncoder encoder;
+    MirrorPacketInfo info;
+    fillNoise(source);
+    size_t len = encoder.encode(source, packet, sizeof(packet));
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+
+    source[10 * SPRITE_WIDTH + 5] ^= 0xFFFF;                             // Span 0
+    source[10 * SPRITE_WIDTH + 3 * MIRROR_SPAN_PIXELS] ^= 0xFFFF;        // Span 3, same row
+    source[10 * SPRITE_WIDTH + 4 * MIRROR_SPAN_PIXELS + 1] ^= 0xFFFF;    // Span 4, merges with 3
+    source[(SPRITE_HEIGHT - 1) * SPRITE_WIDTH + SPRITE_WIDTH - 1] ^= 0xFFFF;
+    len = encoder.encode(source, packet, sizeof(packet));
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+    TEST_ASSERT_EQUAL_HEX8(0, info.flags);
+    TEST_ASSERT_EQUAL(3, info.records);
+    TEST_ASSERT_EQUAL(4, encoder.lastSpans());
+    TEST_ASSERT_EQUAL_MEMORY(source, viewer, sizeof(source));
+}
+
+void test_keyframe_refresh_across_partial_packets() {
+    MirrorEncoder encoder;
+    MirrorPacketInfo info;
+    fillNoise(source);
+    for (int i = 0; i < FRAME_PIXELS; i++) viewer[i] = 0xDEAD;
+
+    // Noise barely compresses, so a 2 KB packet carries a few rows
+    const size_t outSize = 2048;
+    int count = 0;
+    bool changedMidway = false;
+    for (;;) {
+        size_t len = encoder.encode(source, packet, outSize);
+        if (len == 0) break;
+        TEST_ASSERT_TRUE(len <= outSize);
+        TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+        TEST_ASSERT_EQUAL((uint32_t)count, info.frame);
+        // Only the first packet marks the refresh; all but the last say more follows
+        TEST_ASSERT_EQUAL(count == 0, (info.flags & MIRROR_FLAG_KEYFRAME) != 0);
+        bool partial = (info.flags & MIRROR_FLAG_PARTIAL) != 0;
+        TEST_ASSERT_EQUAL(partial, encoder.refreshPending());
+        count++;
+        TEST_ASSERT_TRUE(count < 200);
+
+        if (count == 10 && !changedMidway) {
+            // The screen moves on mid-refresh: a row already sent and one still to come
+            changedMidway = true;
+            source[2 * SPRITE_WIDTH + 100] ^= 0x5555;
+            source[(SPRITE_HEIGHT - 2) * SPRITE_WIDTH + 200] ^= 0x5555;
+        }
+        if (!partial) {
+            TEST_ASSERT_TRUE(changedMidway);
+            break;
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(10, count);
+
+    // The row sent before the change follows as an ordinary update
+    size_t len = encoder.encode(source, packet, outSize);
+    if (len > 0) {
+        TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+        TEST_ASSERT_EQUAL_HEX8(0, info.flags);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(source, viewer, sizeof(source));
+    TEST_ASSERT_EQUAL(0, encoder.encode(source, packet, outSize));
+}
+
+void test_trimmed_row_resumes_in_next_packet() {
+    MirrorEncoder encoder;
+    MirrorPacketInfo info;
+    fillNoise(source);
+    for (int i = 0; i < FRAME_PIXELS; i++) viewer[i] = 0;
+
+    // Room for one span of noise per packet: every row is split across packets
+    const size_t outSize = MIRROR_HEADER_SIZE + MIRROR_RECORD_HEADER_SIZE + MIRROR_RLE_BOUND(MIRROR_SPAN_PIXELS) +
+                           MIRROR_TRAILER_SIZE;
+    int count = 0;
+    size_t len;
+    while ((len = encoder.encode(source, packet, outSize)) > 0) {
+        TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+        TEST_ASSERT_EQUAL(1, info.records);
+        TEST_ASSERT_EQUAL(1, encoder.lastSpans());
+        count++;
+        TEST_ASSERT_TRUE(count <= SPRITE_HEIGHT * MIRROR_SPANS_PER_ROW);
+        if (!(info.flags & MIRROR_FLAG_PARTIAL)) break;
+    }
+    TEST_ASSERT_EQUAL(SPRITE_HEIGHT * MIRROR_SPANS_PER_ROW, count);
+    TEST_ASSERT_EQUAL_MEMORY(source, viewer, sizeof(source));
+}
+
+void test_reset_resyncs_a_late_viewer() {
+    MirrorEncoder encoder;
+    MirrorPacketInfo info;
+    fillNoise(source);
+    size_t len = encoder.encode(source, packet, sizeof(packet));
+    TEST_ASSERT_GREATER_THAN(0, len);
+
+    // A viewer that saw nothing: the unchanged screen still comes across after reset()
+    for (int i = 0; i < FRAME_PIXELS; i++) viewer[i] = 0xDEAD;
+    encoder.reset();
+    TEST_ASSERT_TRUE(encoder.refreshPending());
+    len = encoder.encode(source, packet, sizeof(packet));
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+    TEST_ASSERT_EQUAL_HEX8(MIRROR_FLAG_KEYFRAME, info.flags);
+    TEST_ASSERT_EQUAL_MEMORY(source, viewer, sizeof(source));
+}
+
+void test_periodic_keyframe() {
+#if MIRROR_KEYFRAME_PACKETS > 0
+    MirrorEncoder encoder;
+    MirrorPacketInfo info;
+    memset(source, 0, sizeof(source));
+    size_t len = encoder.encode(source, packet, sizeof(packet));
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+
+    for (int i = 1; i <= MIRROR_KEYFRAME_PACKETS; i++) {
+        source[0] = (uint16_t)i;
+        len = encoder.encode(source, packet, sizeof(packet));
+        TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, &info));
+        uint8_t expected = i == MIRROR_KEYFRAME_PACKETS ? MIRROR_FLAG_KEYFRAME : 0;
+        TEST_ASSERT_EQUAL_HEX8(expected, info.flags);
+    }
+    TEST_ASSERT_EQUAL(SPRITE_HEIGHT, info.records);
+    TEST_ASSERT_EQUAL_MEMORY(source, viewer, sizeof(source));
+#else
+    TEST_IGNORE_MESSAGE("MIRROR_KEYFRAME_PACKETS is 0");
+#endif
+}
+
+void test_apply_rejects_damaged_packets() {
+    MirrorEncoder encoder;
+    fillNoise(source);
+    source[0] = 1;
+    size_t len = encoder.encode(source, packet, 4096);
+    TEST_ASSERT_GREATER_THAN(0, len);
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+
+    TEST_ASSERT_FALSE(mirrorApply(packet, len - 1, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+    TEST_ASSERT_FALSE(mirrorApply(packet, MIRROR_HEADER_SIZE, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+    TEST_ASSERT_FALSE(mirrorApply(packet, len, viewer, SPRITE_WIDTH - 1, SPRITE_HEIGHT, nullptr));
+
+    packet[MIRROR_HEADER_SIZE + 40] ^= 0x01;
+    TEST_ASSERT_FALSE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+    packet[MIRROR_HEADER_SIZE + 40] ^= 0x01;
+    packet[0] = 'X';
+    TEST_ASSERT_FALSE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+    packet[0] = 'W';
+    TEST_ASSERT_TRUE(mirrorApply(packet, len, viewer, SPRITE_WIDTH, SPRITE_HEIGHT, nullptr));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_repeat_runs_split_at_128);
+    RUN_TEST(test_literal_runs_split_at_128);
+    RUN_TEST(test_mixed_runs_across_boundaries);
+    RUN_TEST(test_run_too_small_for_output);
+    RUN_TEST(test_first_packet_is_full_keyframe);
+    RUN_TEST(test_changes_send_only_their_spans);
+    RUN_TEST(test_keyframe_refresh_across_partial_packets);
+    RUN_TEST(test_trimmed_row_resumes_in_next_packet);
+    RUN_TEST(test_reset_resyncs_a_late_viewer);
+    RUN_TEST(test_periodic_keyframe);
+    RUN_TEST(test_apply_rejects_damaged_packets);
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "pages.h"
+#include "icon_cache.h"
+
+#define FRAME_PIXELS (SPRITE_WIDTH * SPRITE_HEIGHT)
+#define TRANSITION_FRAMES (PAGE_TRANSITION_MS / RENDER_INTERVAL_MS)
+
+// Two full-screen sprites in TFT_eSprite byte order, and the panel-side copy
+static uint16_t outgoing[FRAME_PIXELS];
+static uint16_t incoming[FRAME_PIXELS];
+static uint16_t panel[FRAME_PIXELS];
+static uint16_t fadeBand[SPRITE_WIDTH * PAGE_FADE_BAND_ROWS];
+
+static uint16_t swap16(uint16_t c) {
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+// Mostly black pages with text-like blocks, as the real ones are
+static void fillPage(uint16_t* page, uint32_t seed) {
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        int x = i % SPRITE_WIDTH, y = i / SPRITE_WIDTH;
+        seed = seed * 1103515245u + 12345u;
+        bool ink = ((x / 8 + y / 12) % 5 == 0) && (seed >> 28) < 6;
+        page[i] = ink ? swap16((uint16_t)(seed >> 8)) : 0;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fade_line_endpoints_and_unchanged_pixels() {
+    uint16_t from[4] = {swap16(0xF800), swap16(0x07E0), swap16(0x1234), 0};
+    uint16_t to[4] = {swap16(0x001F), swap16(0x07E0), swap16(0xFFFF), 0};
+    uint16_t out[4];
+    fadeLine(from, to, out, 4, 0);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, out[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, out[2]);
+    fadeLine(from, to, out, 4, 255);
+    TEST_ASSERT_EQUAL_HEX16(0x001F, out[0]);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, out[2]);
+    fadeLine(from, to, out, 4, 128);
+    TEST_ASSERT_EQUAL_HEX16(lerp565(0xF800, 0x001F, 128), out[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, out[1]);   // Same pixel both sides: native order, no blend
+    TEST_ASSERT_EQUAL_HEX16(0x0000, out[3]);
+}
+
+void test_fade_line_matches_lerp_everywhere() {
+    fillPage(outgoing, 1);
+    fillPage(incoming, 2);
+    for (int mix = 0; mix <= 255; mix += 17) {
+        fadeLine(outgoing, incoming, panel, FRAME_PIXELS, (uint8_t)mix);
+        for (int i = 0; i < FRAME_PIXELS; i++) {
+            uint16_t expected = lerp565(swap16(outgoing[i]), swap16(incoming[i]), (uint8_t)mix);
+            if (panel[i] != expected) {
+                TEST_ASSERT_EQUAL_HEX16(expected, panel[i]);
+            }
+        }
+    }
+}
+
+// One fade frame as compositeTransition() runs it: band by band into the push buffer
+static void fadeFrame(uint8_t mix) {
+    for (int y = 0; y < SPRITE_HEIGHT; y += PAGE_FADE_BAND_ROWS) {
+        int rows = SPRITE_HEIGHT - y < PAGE_FADE_BAND_ROWS ? SPRITE_HEIGHT - y : PAGE_FADE_BAND_ROWS;
+        fadeLine(outgoing + y * SPRITE_WIDTH, incoming + y * SPRITE_WIDTH, fadeBand, rows * SPRITE_WIDTH, mix);
+        memcpy(panel + y * SPRITE_WIDTH, fadeBand, (size_t)rows * SPRITE_WIDTH * sizeof(uint16_t));
+    }
+}
+
+// One slide frame: the two windowed pushSprite() calls, modelled as the row
+// copies they stream. The SPI transfer itself is not part of this.
+static void slideFrame(int progress) {
+    const int w = SPRITE_WIDTH;
+    for (int y = 0; y < SPRITE_HEIGHT; y++) {
+        if (progress < w) {
+            memcpy(panel + y * w, outgoing + y * w + progress, (size_t)(w - progress) * sizeof(uint16_t));
+        }
+        if (progress > 0) {
+            memcpy(panel + y * w + (w - progress), incoming + y * w, (size_t)progress * sizeof(uint16_t));
+        }
+    }
+}
+
+void test_slide_frame_is_composite_of_both_pages() {
+    fillPage(outgoing, 3);
+    fillPage(incoming, 4);
+    slideFrame(100);
+    const int w = SPRITE_WIDTH;
+    TEST_ASSERT_EQUAL_HEX16(outgoing[100], panel[0]);
+    TEST_ASSERT_EQUAL_HEX16(outgoing[5 * w + w - 1], panel[5 * w + w - 101]);
+    TEST_ASSERT_EQUAL_HEX16(incoming[7 * w], panel[7 * w + w - 100]);
+    TEST_ASSERT_EQUAL_HEX16(incoming[7 * w + 99], panel[7 * w + w - 1]);
+}
+
+void test_bench_transition_frames() {
+    fillPage(outgoing, 5);
+    fillPage(incoming, 6);
+    const int rounds = 20;
+    volatile uint16_t sink = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 1; f <= TRANSITION_FRAMES; f++) {
+            fadeFrame((uint8_t)(255 * f / TRANSITION_FRAMES));
+            sink += panel[f];
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 1; f <= TRANSITION_FRAMES; f++) {
+            slideFrame(SPRITE_WIDTH * f / TRANSITION_FRAMES);
+            sink += panel[f];
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    (void)sink;
+
+    double fadeUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / (rounds * TRANSITION_FRAMES);
+    double slideUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / (rounds * TRANSITION_FRAMES);
+    char line[128];
+    snprintf(line, sizeof(line), "per frame: fade %.1f us, slide %.1f us (budget %d us, %d frames per transition)",
+             fadeUs, slideUs, FRAME_BUDGET_US, TRANSITION_FRAMES);
+    TEST_MESSAGE(line);
+    // The host is far faster than the ESP32; this only catches a kernel gone badly wrong
+    TEST_ASSERT_TRUE(fadeUs < FRAME_BUDGET_US);
+    TEST_ASSERT_TRUE(slideUs < FRAME_BUDGET_US);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fade_line_endpoints_and_unchanged_pixels);
+    RUN_TEST(test_fade_line_matches_lerp_everywhere);
+    RUN_TEST(test_slide_frame_is_composite_of_both_pages);
+    RUN_TEST(test_bench_transition_frames);
+    return UNITY_END();
+}
@@ -0,0 +1,173 @@
+#include <unity.h>
+#include "scheduler.h"
+
+// Callbacks record the time they ran at; the tests step the scheduler 1 ms at a time
+static uint64_t now;
+static uint64_t firedAt[4][8];
+static int fired[4];
+
+template <int N>
+static void record() {
+    if (fired[N] < 8) {
+        firedAt[N][fired[N]] = now;
+    }
+    fired[N]++;
+}
+
+static void runUntil(Scheduler& s, uint64_t until) {
+    while (now < until) {
+        now++;
+        s.run(now);
+    }
+}
+
+void setUp() {
+    now = 0;
+    memset(firedAt, 0, sizeof(firedAt));
+    memset(fired, 0, sizeof(fired));
+}
+
+void tearDown() {}
+
+void test_insert_fires_on_deadline() {
+    Scheduler s;
+    s.begin(0);
+    s.addTask("a", record<0>, 0, 10);
+    s.addTask("b", record<1>, 0, 63);   // Last slot of level 0
+    runUntil(s, 9);
+    TEST_ASSERT_EQUAL(0, fired[0]);
+    runUntil(s, 100);
+    TEST_ASSERT_EQUAL(1, fired[0]);
+    TEST_ASSERT_EQUAL_UINT64(10, firedAt[0][0]);
+    TEST_ASSERT_EQUAL_UINT64(63, firedAt[1][0]);
+}
+
+void test_cascade_keeps_exact_deadlines() {
+    Scheduler s;
+    s.begin(0);
+    s.addTask("l1", record<0>, 0, 64);                  // First level-1 slot
+    s.addTask("l2", record<1>, 0, 64 * 64 + 5);         // Cascades twice
+    s.addTask("l3", record<2>, 0, 64 * 64 * 64 + 777);  // Three times
+    runUntil(s, 64 * 64 * 64 + 1000);
+    TEST_ASSERT_EQUAL_UINT64(64, firedAt[0][0]);
+    TEST_ASSERT_EQUAL_UINT64(64 * 64 + 5, firedAt[1][0]);
+    TEST_ASSERT_EQUAL_UINT64(64 * 64 * 64 + 777, firedAt[2][0]);
+    TEST_ASSERT_EQUAL(1, fired[2]);
+}
+
+void test_beyond_wheel_range() {
+    // 64^4 ms is the direct range; longer delays are parked and re-placed
+    Scheduler s;
+    s.begin(0);
+    uint32_t delay = (1UL << 24) + 12345;
+    s.addTask("far", record<0>, 0, delay);
+    runUntil(s, delay - 1);
+    TEST_ASSERT_EQUAL(0, fired[0]);
+    runUntil(s, delay + 10);
+    TEST_ASSERT_EQUAL(1, fired[0]);
+    TEST_ASSERT_EQUAL_UINT64(delay, firedAt[0][0]);
+}
+
+void test_periodic_cadence_and_skipped_periods() {
+    Scheduler s;
+    s.begin(0);
+    s.addTask("p", record<0>, 100, 100);
+    runUntil(s, 300);
+    TEST_ASSERT_EQUAL(3, fired[0]);
+    TEST_ASSERT_EQUAL_UINT64(200, firedAt[0][1]);
+
+    // A late run(): the missed periods run once, not replayed
+    now = 1050;
+    s.run(now);
+    TEST_ASSERT_EQUAL(4, fired[0]);
+    runUntil(s, 1150);
+    TEST_ASSERT_EQUAL(5, fired[0]);
+    TEST_ASSERT_EQUAL_UINT64(1150, firedAt[0][4]);
+    TEST_ASSERT_EQUAL_UINT32(650, s.taskStats(0).lateMs);
+}
+
+void test_schedule_in_and_cancel() {
+    Scheduler s;
+    s.begin(0);
+    int a = s.addTask("a", record<0>, 1000, 1000);
+    int b = s.addTask("b", record<1>, 0, 50);
+    s.scheduleIn(a, 20, now);
+    s.cancel(b);
+    TEST_ASSERT_EQUAL_UINT64(20, s.nextDeadline());
+    TEST_ASSERT_EQUAL_UINT32(20, s.idleTimeMs(now));
+    runUntil(s, 100);
+    TEST_ASSERT_EQUAL(1, fired[0]);
+    TEST_ASSERT_EQUAL_UINT64(20, firedAt[0][0]);
+    TEST_ASSERT_EQUAL(0, fired[1]);
+    TEST_ASSERT_EQUAL_UINT64(1020, s.nextDeadline());
+    TEST_ASSERT_EQUAL_UINT32(1000, s.idleTimeMs(now, 5000) + 80);
+}
+
+void test_monotonic_clock_extends_across_wrap() {
+    MonotonicClock clock;
+    TEST_ASSERT_EQUAL_UINT64(0xFFFFFF00ULL, clock.extend(0xFFFFFF00UL));
+    TEST_ASSERT_EQUAL_UINT64(0xFFFFFFFFULL, clock.extend(0xFFFFFFFFUL));
+    TEST_ASSERT_EQUAL_UINT64(0x100000010ULL, clock.extend(0x10));
+    TEST_ASSERT_EQUAL_UINT64(0x100000010ULL, clock.extend(0x10));
+    TEST_ASSERT_EQUAL_UINT64(0x1FFFFFFFFULL, clock.extend(0xFFFFFFFFUL));
+    TEST_ASSERT_EQUAL_UINT64(0x200000000ULL, clock.extend(0));
+}
+
+void test_periodic_task_across_millis_wrap() {
+    // millis() wraps 49.7 days in; a 1 s task keeps exact 1 s spacing through it
+    MonotonicClock clock;
+    uint32_t raw = 0xFFFFFFFFUL - 2500;
+    now = clock.extend(raw);
+    Scheduler s;
+    s.begin(now);
+    s.addTask("p", record<0>, 1000, 1000);
+    for (int i = 0; i < 5000; i++) {
+        raw++;   // Wraps to 0 halfway through
+        now = clock.extend(raw);
+        s.run(now);
+    }
+    TEST_ASSERT_EQUAL(5, fired[0]);
+    for (int i = 1; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT64(1000, firedAt[0][i] - firedAt[0][i - 1]);
+    }
+    TEST_ASSERT_EQUAL_UINT64(0x100000000ULL, firedAt[0][1] + 501);
+    TEST_ASSERT_EQUAL_UINT32(0, s.taskStats(0).lateMs);
+}
+
+void test_add_task_when_full() {
+    Scheduler s;
+    s.begin(0);
+    for (int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+        TEST_ASSERT_EQUAL(i, s.addTask("t", record<3>, 10, 10));
+    }
+    TEST_ASSERT_EQUAL(-1, s.addTask("extra", record<0>, 10, 10));
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_TASKS, s.taskCount());
+    runUntil(s, 10);
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_TASKS, fired[3]);
+    TEST_ASSERT_EQUAL(0, fired[0]);
+    // Invalid ids are ignored
+    s.scheduleIn(-1, 5, now);
+    s.cancel(SCHEDULER_MAX_TASKS);
+}
+
+void test_add_task_rejects_null_callback() {
+    Scheduler s;
+    s.begin(0);
+    TEST_ASSERT_EQUAL(-1, s.addTask("null", nullptr, 10, 10));
+    TEST_ASSERT_EQUAL(0, s.taskCount());
+    TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, s.nextDeadline());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_insert_fires_on_deadline);
+    RUN_TEST(test_cascade_keeps_exact_deadlines);
+    RUN_TEST(test_beyond_wheel_range);
+    RUN_TEST(test_periodic_cadence_and_skipped_periods);
+    RUN_TEST(test_schedule_in_and_cancel);
+    RUN_TEST(test_monotonic_clock_extends_across_wrap);
+    RUN_TEST(test_periodic_task_across_millis_wrap);
+    RUN_TEST(test_add_task_when_full);
+    RUN_TEST(test_add_task_rejects_null_callback);
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+// Generated by tools/solar_reference.py - do not edit.
+// NOAA Solar Calculator sun position in double precision, events found by bisection.
+
+#ifndef SOLAR_REFERENCE_H
+#define SOLAR_REFERENCE_H
+
+#include <stdint.h>
+#include "solar.h"
+
+struct SolarReference {
+    const char* name;
+    float latitude;
+    float longitude;
+    uint32_t localNoon;   // Input: noon of the local calendar day
+    uint8_t dayType;
+    uint32_t dawn;        // UTC epochs, 0 = none
+    uint32_t sunrise;
+    uint32_t noon;
+    uint32_t sunset;
+    uint32_t dusk;
+};
+
+static const SolarReference SOLAR_REFERENCE[] = {
+    {"London 2024-01-15", 51.5074f, -0.1278f, 1705320000u, SOLAR_DAY_NORMAL, 1705303280u, 1705305593u, 1705320585u, 1705335601u, 1705337915u},
+    {"London 2024-03-20", 51.5074f, -0.1278f, 1710936000u, SOLAR_DAY_NORMAL, 1710912540u, 1710914537u, 1710936468u, 1710958460u, 1710960463u},
+    {"London 2024-06-21", 51.5074f, -0.1278f, 1718971200u, SOLAR_DAY_NORMAL, 1718938524u, 1718941391u, 1718971346u, 1719001300u, 1719004166u},
+    {"London 2024-09-22", 51.5074f, -0.1278f, 1727006400u, SOLAR_DAY_NORMAL, 1726982034u, 1726984036u, 1727005985u, 1727027875u, 1727029870u},
+    {"London 2024-12-21", 51.5074f, -0.1278f, 1734782400u, SOLAR_DAY_NORMAL, 1734765820u, 1734768240u, 1734782330u, 1734796420u, 1734798840u},
+    {"London 2025-02-28", 51.5074f, -0.1278f, 1740744000u, SOLAR_DAY_NORMAL, 1740723235u, 1740725247u, 1740744778u, 1740764363u, 1740766379u},
+    {"London 2026-05-05", 51.5074f, -0.1278f, 1777982400u, SOLAR_DAY_NORMAL, 1777952770u, 1777955113u, 1777982233u, 1778009417u, 1778011775u},
+    {"London 2027-08-01", 51.5074f, -0.1278f, 1817121600u, SOLAR_DAY_NORMAL, 1817091784u, 1817094226u, 1817122013u, 1817149740u, 1817152167u},
+    {"London 2029-11-11", 51.5074f, -0.1278f, 1889092800u, SOLAR_DAY_NORMAL, 1889073329u, 1889075517u, 1889091871u, 1889108188u, 1889110375u},
+    {"London 2032-02-29", 51.5074f, -0.1278f, 1961668800u, SOLAR_DAY_NORMAL, 1961647995u, 1961650006u, 1961669574u, 1961689195u, 1961691210u},
+    {"London 2037-10-17", 51.5074f, -0.1278f, 2139393600u, SOLAR_DAY_NORMAL, 2139371667u, 2139373698u, 2139392746u, 2139411743u, 2139413772u},
+    {"New York 2024-01-15", 40.7128f, -74.0060f, 1705338000u, SOLAR_DAY_NORMAL, 1705319278u, 1705321086u, 1705338320u, 1705355571u, 1705357380u},
+    {"New York 2024-03-20", 40.7128f, -74.0060f, 1710954000u, SOLAR_DAY_NORMAL, 1710930672u, 1710932309u, 1710954195u, 1710976123u, 1710977763u},
+    {"New York 2024-06-21", 40.7128f, -74.0060f, 1718989200u, SOLAR_DAY_NORMAL, 1718959901u, 1718961907u, 1718989080u, 1719016251u, 1719018257u},
+    {"New York 2024-09-22", 40.7128f, -74.0060f, 1727024400u, SOLAR_DAY_NORMAL, 1727000207u, 1727001847u, 1727023711u, 1727045535u, 1727047172u},
+    {"New York 2024-12-21", 40.7128f, -74.0060f, 1734800400u, SOLAR_DAY_NORMAL, 1734781550u, 1734783410u, 1734800067u, 1734816724u, 1734818584u},
+    {"New York 2025-02-28", 40.7128f, -74.0060f, 1740762000u, SOLAR_DAY_NORMAL, 1740740612u, 1740742260u, 1740762507u, 1740782791u, 1740784441u},
+    {"New York 2026-05-05", 40.7128f, -74.0060f, 1778000400u, SOLAR_DAY_NORMAL, 1777972774u, 1777974578u, 1777999963u, 1778025386u, 1778027198u},
+    {"New York 2027-08-01", 40.7128f, -74.0060f, 1817139600u, SOLAR_DAY_NORMAL, 1817112108u, 1817113954u, 1817139743u, 1817165497u, 1817167336u},
+    {"New York 2029-11-11", 40.7128f, -74.0060f, 1889110800u, SOLAR_DAY_NORMAL, 1889089762u, 1889091509u, 1889109603u, 1889127671u, 1889129417u},
+    {"New York 2032-02-29", 40.7128f, -74.0060f, 1961686800u, SOLAR_DAY_NORMAL, 1961665383u, 1961667031u, 1961687302u, 1961707611u, 1961709261u},
+    {"New York 2037-10-17", 40.7128f, -74.0060f, 2139411600u, SOLAR_DAY_NORMAL, 2139388926u, 2139390587u, 2139410474u, 2139430326u, 2139431985u},
+    {"Sydney 2024-01-15", -33.8688f, 151.2093f, 1705284000u, SOLAR_DAY_NORMAL, 1705257038u, 1705258741u, 1705284255u, 1705309748u, 1705311447u},
+    {"Sydney 2024-03-20", -33.8688f, 151.2093f, 1710900000u, SOLAR_DAY_NORMAL, 1710876804u, 1710878299u, 1710900155u, 1710921978u, 1710923471u},
+    {"Sydney 2024-06-21", -33.8688f, 151.2093f, 1718935200u, SOLAR_DAY_NORMAL, 1718915540u, 1718917204u, 1718935020u, 1718952836u, 1718954500u},
+    {"Sydney 2024-09-22", -33.8688f, 151.2093f, 1726970400u, SOLAR_DAY_NORMAL, 1726946388u, 1726947881u, 1726969673u, 1726991496u, 1726992991u},
+    {"Sydney 2024-12-21", -33.8688f, 151.2093f, 1734746400u, SOLAR_DAY_NORMAL, 1734718303u, 1734720053u, 1734745997u, 1734771941u, 1734773691u},
+    {"Sydney 2025-02-28", -33.8688f, 151.2093f, 1740708000u, SOLAR_DAY_NORMAL, 1740683790u, 1740685318u, 1740708462u, 1740731572u, 1740733097u},
+    {"Sydney 2026-05-05", -33.8688f, 151.2093f, 1777946400u, SOLAR_DAY_NORMAL, 1777925187u, 1777926751u, 1777945914u, 1777965055u, 1777966619u},
+    {"Sydney 2027-08-01", -33.8688f, 151.2093f, 1817085600u, SOLAR_DAY_NORMAL, 1817065302u, 1817066887u, 1817085694u, 1817104521u, 1817106106u},
+    {"Sydney 2029-11-11", -33.8688f, 151.2093f, 1889056800u, SOLAR_DAY_NORMAL, 1889029148u, 1889030777u, 1889055547u, 1889080346u, 1889081980u},
+    {"Sydney 2032-02-29", -33.8688f, 151.2093f, 1961632800u, SOLAR_DAY_NORMAL, 1961608606u, 1961610134u, 1961633258u, 1961656349u, 1961657872u},
+    {"Sydney 2037-10-17", -33.8688f, 151.2093f, 2139357600u, SOLAR_DAY_NORMAL, 2139331552u, 2139333087u, 2139356430u, 2139379807u, 2139381346u},
+    {"Quito 2024-01-15", -0.1807f, -78.4678f, 1705338000u, SOLAR_DAY_NORMAL, 1705316224u, 1705317554u, 1705339391u, 1705361227u, 1705362557u},
+    {"Quito 2024-03-20", -0.1807f, -78.4678f, 1710954000u, SOLAR_DAY_NORMAL, 1710932231u, 1710933470u, 1710955266u, 1710977061u, 1710978301u},
+    {"Quito 2024-06-21", -0.1807f, -78.4678f, 1718989200u, SOLAR_DAY_NORMAL, 1718966996u, 1718968348u, 1718990151u, 1719011953u, 1719013305u},
+    {"Quito 2024-09-22", -0.1807f, -78.4678f, 1727024400u, SOLAR_DAY_NORMAL, 1727001747u, 1727002987u, 1727024782u, 1727046577u, 1727047816u},
+    {"Quito 2024-12-21", -0.1807f, -78.4678f, 1734800400u, SOLAR_DAY_NORMAL, 1734777941u, 1734779294u, 1734801138u, 1734822982u, 1734824335u},
+    {"Quito 2025-02-28", -0.1807f, -78.4678f, 1740762000u, SOLAR_DAY_NORMAL, 1740740521u, 1740741773u, 1740763577u, 1740785382u, 1740786633u},
+    {"Quito 2026-05-05", -0.1807f, -78.4678f, 1778000400u, SOLAR_DAY_NORMAL, 1777977947u, 1777979239u, 1778001034u, 1778022828u, 1778024121u},
+    {"Quito 2027-08-01", -0.1807f, -78.4678f, 1817139600u, SOLAR_DAY_NORMAL, 1817117715u, 1817119019u, 1817140814u, 1817162609u, 1817163912u},
+    {"Quito 2029-11-11", -0.1807f, -78.4678f, 1889110800u, SOLAR_DAY_NORMAL, 1889087548u, 1889088849u, 1889110674u, 1889132500u, 1889133802u},
+    {"Quito 2032-02-29", -0.1807f, -78.4678f, 1961686800u, SOLAR_DAY_NORMAL, 1961665317u, 1961666568u, 1961688373u, 1961710177u, 1961711428u},
+    {"Quito 2037-10-17", -0.1807f, -78.4678f, 2139411600u, SOLAR_DAY_NORMAL, 2139388481u, 2139389738u, 2139411545u, 2139433352u, 2139434610u},
+    {"Singapore 2024-01-15", 1.3521f, 103.8198f, 1705291200u, SOLAR_DAY_NORMAL, 1705272606u, 1705273937u, 1705295631u, 1705317325u, 1705318655u},
+    {"Singapore 2024-03-20", 1.3521f, 103.8198f, 1710907200u, SOLAR_DAY_NORMAL, 1710888490u, 1710889731u, 1710911526u, 1710933322u, 1710934562u},
+    {"Singapore 2024-06-21", 1.3521f, 103.8198f, 1718942400u, SOLAR_DAY_NORMAL, 1718923079u, 1718924433u, 1718946395u, 1718968357u, 1718969711u},
+    {"Singapore 2024-09-22", 1.3521f, 103.8198f, 1726977600u, SOLAR_DAY_NORMAL, 1726958007u, 1726959248u, 1726981043u, 1727002838u, 1727004078u},
+    {"Singapore 2024-12-21", 1.3521f, 103.8198f, 1734753600u, SOLAR_DAY_NORMAL, 1734734337u, 1734735689u, 1734757374u, 1734779059u, 1734780411u},
+    {"Singapore 2025-02-28", 1.3521f, 103.8198f, 1740715200u, SOLAR_DAY_NORMAL, 1740696828u, 1740698080u, 1740719834u, 1740741589u, 1740742840u},
+    {"Singapore 2026-05-05", 1.3521f, 103.8198f, 1777953600u, SOLAR_DAY_NORMAL, 1777934094u, 1777935386u, 1777957287u, 1777979189u, 1777980483u},
+    {"Singapore 2027-08-01", 1.3521f, 103.8198f, 1817092800u, SOLAR_DAY_NORMAL, 1817073845u, 1817075151u, 1817097067u, 1817118982u, 1817120287u},
+    {"Singapore 2029-11-11", 1.3521f, 103.8198f, 1889064000u, SOLAR_DAY_NORMAL, 1889043912u, 1889045212u, 1889066922u, 1889088630u, 1889089931u},
+    {"Singapore 2032-02-29", 1.3521f, 103.8198f, 1961640000u, SOLAR_DAY_NORMAL, 1961621624u, 1961622876u, 1961644630u, 1961666385u, 1961667636u},
+    {"Singapore 2037-10-17", 1.3521f, 103.8198f, 2139364800u, SOLAR_DAY_NORMAL, 2139344799u, 2139346056u, 2139367802u, 2139389548u, 2139390805u},
+    {"Honolulu 2024-01-15", 21.3069f, -157.8583f, 1705356000u, SOLAR_DAY_NORMAL, 1705337262u, 1705338692u, 1705358449u, 1705378216u, 1705379645u},
+    {"Honolulu 2024-03-20", 21.3069f, -157.8583f, 1710972000u, SOLAR_DAY_NORMAL, 1710951154u, 1710952485u, 1710974316u, 1710996165u, 1710997497u},
+    {"Honolulu 2024-06-21", 21.3069f, -157.8583f, 1719007200u, SOLAR_DAY_NORMAL, 1718983538u, 1718985030u, 1719009207u, 1719033384u, 1719034876u},
+    {"Honolulu 2024-09-22", 21.3069f, -157.8583f, 1727042400u, SOLAR_DAY_NORMAL, 1727020696u, 1727022027u, 1727043831u, 1727065616u, 1727066947u},
+    {"Honolulu 2024-12-21", 21.3069f, -157.8583f, 1734818400u, SOLAR_DAY_NORMAL, 1734799235u, 1734800691u, 1734820198u, 1734839706u, 1734841162u},
+    {"Honolulu 2025-02-28", 21.3069f, -157.8583f, 1740780000u, SOLAR_DAY_NORMAL, 1740760198u, 1740761539u, 1740782628u, 1740803736u, 1740805077u},
+    {"Honolulu 2026-05-05", 21.3069f, -157.8583f, 1778018400u, SOLAR_DAY_NORMAL, 1777995274u, 1777996682u, 1778020086u, 1778043507u, 1778044917u},
+    {"Honolulu 2027-08-01", 21.3069f, -157.8583f, 1817157600u, SOLAR_DAY_NORMAL, 1817134874u, 1817136298u, 1817159867u, 1817183421u, 1817184843u},
+    {"Honolulu 2029-11-11", 21.3069f, -157.8583f, 1889128800u, SOLAR_DAY_NORMAL, 1889108212u, 1889109609u, 1889129730u, 1889149837u, 1889151234u},
+    {"Honolulu 2032-02-29", 21.3069f, -157.8583f, 1961704800u, SOLAR_DAY_NORMAL, 1961684983u, 1961686323u, 1961707424u, 1961728543u, 1961729883u},
+    {"Honolulu 2037-10-17", 21.3069f, -157.8583f, 2139429600u, SOLAR_DAY_NORMAL, 2139408336u, 2139409684u, 2139430596u, 2139451492u, 2139452840u},
+    {"Auckland 2024-01-15", -36.8485f, 174.7633f, 1705276800u, SOLAR_DAY_NORMAL, 1705250843u, 1705252634u, 1705278600u, 1705304542u, 1705306329u},
+    {"Auckland 2024-03-20", -36.8485f, 174.7633f, 1710892800u, SOLAR_DAY_NORMAL, 1710871079u, 1710872632u, 1710894503u, 1710916338u, 1710917888u},
+    {"Auckland 2024-06-21", -36.8485f, 174.7633f, 1718928000u, SOLAR_DAY_NORMAL, 1718910287u, 1718912027u, 1718929366u, 1718946705u, 1718948445u},
+    {"Auckland 2024-09-22", -36.8485f, 174.7633f, 1726963200u, SOLAR_DAY_NORMAL, 1726940681u, 1726942231u, 1726964021u, 1726985847u, 1726987399u},
+    {"Auckland 2024-12-21", -36.8485f, 174.7633f, 1734739200u, SOLAR_DAY_NORMAL, 1734712047u, 1734713894u, 1734740342u, 1734766790u, 1734768637u},
+    {"Auckland 2025-02-28", -36.8485f, 174.7633f, 1740700800u, SOLAR_DAY_NORMAL, 1740677909u, 1740679500u, 1740702810u, 1740726082u, 1740727668u},
+    {"Auckland 2026-05-05", -36.8485f, 174.7633f, 1777939200u, SOLAR_DAY_NORMAL, 1777919775u, 1777921403u, 1777940262u, 1777959096u, 1777960723u},
+    {"Auckland 2027-08-01", -36.8485f, 174.7633f, 1817078400u, SOLAR_DAY_NORMAL, 1817059937u, 1817061588u, 1817080041u, 1817098516u, 1817100167u},
+    {"Auckland 2029-11-11", -36.8485f, 174.7633f, 1889049600u, SOLAR_DAY_NORMAL, 1889023065u, 1889024771u, 1889049894u, 1889075049u, 1889076761u},
+    {"Auckland 2032-02-29", -36.8485f, 174.7633f, 1961625600u, SOLAR_DAY_NORMAL, 1961602728u, 1961604317u, 1961627606u, 1961650856u, 1961652441u},
+    {"Auckland 2037-10-17", -36.8485f, 174.7633f, 2139350400u, SOLAR_DAY_NORMAL, 2139325657u, 2139327254u, 2139350778u, 2139374340u, 2139375942u},
+    {"Cape Town 2024-01-15", -33.9249f, 18.4241f, 1705312800u, SOLAR_DAY_NORMAL, 1705288919u, 1705290622u, 1705316131u, 1705341619u, 1705343318u},
+    {"Cape Town 2024-03-20", -33.9249f, 18.4241f, 1710928800u, SOLAR_DAY_NORMAL, 1710908688u, 1710910185u, 1710932016u, 1710953816u, 1710955310u},
+    {"Cape Town 2024-06-21", -33.9249f, 18.4241f, 1718964000u, SOLAR_DAY_NORMAL, 1718947420u, 1718949085u, 1718966893u, 1718984701u, 1718986366u},
+    {"Cape Town 2024-09-22", -33.9249f, 18.4241f, 1726999200u, SOLAR_DAY_NORMAL, 1726978225u, 1726979719u, 1727001533u, 1727023380u, 1727024877u},
+    {"Cape Town 2024-12-21", -33.9249f, 18.4241f, 1734775200u, SOLAR_DAY_NORMAL, 1734750171u, 1734751923u, 1734777876u, 1734803829u, 1734805581u},
+    {"Cape Town 2025-02-28", -33.9249f, 18.4241f, 1740736800u, SOLAR_DAY_NORMAL, 1740715675u, 1740717203u, 1740740326u, 1740763416u, 1740764941u},
+    {"Cape Town 2026-05-05", -33.9249f, 18.4241f, 1777975200u, SOLAR_DAY_NORMAL, 1777957075u, 1777958642u, 1777977781u, 1777996897u, 1777998464u},
+    {"Cape Town 2027-08-01", -33.9249f, 18.4241f, 1817114400u, SOLAR_DAY_NORMAL, 1817097158u, 1817098744u, 1817117561u, 1817136398u, 1817137984u},
+    {"Cape Town 2029-11-11", -33.9249f, 18.4241f, 1889085600u, SOLAR_DAY_NORMAL, 1889060991u, 1889062623u, 1889087418u, 1889112242u, 1889113879u},
+    {"Cape Town 2032-02-29", -33.9249f, 18.4241f, 1961661600u, SOLAR_DAY_NORMAL, 1961640491u, 1961642018u, 1961665122u, 1961688192u, 1961689716u},
+    {"Cape Town 2037-10-17", -33.9249f, 18.4241f, 2139386400u, SOLAR_DAY_NORMAL, 2139363388u, 2139364925u, 2139388294u, 2139411697u, 2139413238u},
+    {"Anchorage 2024-01-15", 61.2181f, -149.9003f, 1705352400u, SOLAR_DAY_NORMAL, 1705341668u, 1705345040u, 1705356539u, 1705368071u, 1705371444u},
+    {"Anchorage 2024-03-20", 61.2181f, -149.9003f, 1710968400u, SOLAR_DAY_NORMAL, 1710947712u, 1710950302u, 1710972406u, 1710994598u, 1710997202u},
+    {"Anchorage 2024-06-21", 61.2181f, -149.9003f, 1719003600u, SOLAR_DAY_NORMAL, 0, 1718972422u, 1719007297u, 1719042167u, 0},
+    {"Anchorage 2024-09-22", 61.2181f, -149.9003f, 1727038800u, SOLAR_DAY_NORMAL, 1727017336u, 1727019934u, 1727041921u, 1727063823u, 1727066408u},
+    {"Anchorage 2024-12-21", 61.2181f, -149.9003f, 1734814800u, SOLAR_DAY_NORMAL, 1734804733u, 1734808477u, 1734818288u, 1734828099u, 1734831843u},
+    {"Anchorage 2025-02-28", 61.2181f, -149.9003f, 1740776400u, SOLAR_DAY_NORMAL, 1740759491u, 1740762102u, 1740780719u, 1740799410u, 1740802028u},
+    {"Anchorage 2026-05-05", 61.2181f, -149.9003f, 1778014800u, SOLAR_DAY_NORMAL, 1777984703u, 1777988308u, 1778018176u, 1778048159u, 1778051817u},
+    {"Anchorage 2027-08-01", 61.2181f, -149.9003f, 1817154000u, SOLAR_DAY_NORMAL, 1817123153u, 1817127119u, 1817157957u, 1817188683u, 1817192585u},
+    {"Anchorage 2029-11-11", 61.2181f, -149.9003f, 1889125200u, SOLAR_DAY_NORMAL, 1889111145u, 1889114179u, 1889127819u, 1889141411u, 1889144442u},
+    {"Anchorage 2032-02-29", 61.2181f, -149.9003f, 1961701200u, SOLAR_DAY_NORMAL, 1961684236u, 1961686845u, 1961705515u, 1961724259u, 1961726876u},
+    {"Anchorage 2037-10-17", 61.2181f, -149.9003f, 2139426000u, SOLAR_DAY_NORMAL, 2139408270u, 2139410929u, 2139428687u, 2139446375u, 2139449027u},
+    {"Reykjavik 2024-01-15", 64.1466f, -21.9426f, 1705320000u, SOLAR_DAY_NORMAL, 1705312104u, 1705316165u, 1705325821u, 1705335514u, 1705339577u},
+    {"Reykjavik 2024-03-20", 64.1466f, -21.9426f, 1710936000u, SOLAR_DAY_NORMAL, 1710916749u, 1710919613u, 1710941702u, 1710963893u, 1710966773u},
+    {"Reykjavik 2024-06-21", 64.1466f, -21.9426f, 1718971200u, SOLAR_DAY_NORMAL, 0, 1718938514u, 1718976583u, 1719014644u, 0},
+    {"Reykjavik 2024-09-22", 64.1466f, -21.9426f, 1727006400u, SOLAR_DAY_NORMAL, 1726986245u, 1726989122u, 1727011219u, 1727033217u, 1727036079u},
+    {"Reykjavik 2024-12-21", 64.1466f, -21.9426f, 1734782400u, SOLAR_DAY_NORMAL, 1734775396u, 1734780156u, 1734787567u, 1734794978u, 1734799739u},
+    {"Reykjavik 2025-02-28", 64.1466f, -21.9426f, 1740744000u, SOLAR_DAY_NORMAL, 1740728990u, 1740731885u, 1740750013u, 1740768224u, 1740771128u},
+    {"Reykjavik 2026-05-05", 64.1466f, -21.9426f, 1777982400u, SOLAR_DAY_NORMAL, 1777951880u, 1777956384u, 1777987468u, 1778018696u, 1778023309u},
+    {"Reykjavik 2027-08-01", 64.1466f, -21.9426f, 1817121600u, SOLAR_DAY_NORMAL, 1817089365u, 1817094823u, 1817127249u, 1817159528u, 1817164810u},
+    {"Reykjavik 2029-11-11", 64.1466f, -21.9426f, 1889092800u, SOLAR_DAY_NORMAL, 1889081175u, 1889084659u, 1889097107u, 1889109501u, 1889112982u},
+    {"Reykjavik 2032-02-29", 64.1466f, -21.9426f, 1961668800u, SOLAR_DAY_NORMAL, 1961653728u, 1961656619u, 1961674809u, 1961693081u, 1961695982u},
+    {"Reykjavik 2037-10-17", 64.1466f, -21.9426f, 2139393600u, SOLAR_DAY_NORMAL, 2139377748u, 2139380699u, 2139397981u, 2139415186u, 2139418129u},
+    {"Tromso 2024-01-15", 69.6492f, 18.9553f, 1705316400u, SOLAR_DAY_NORMAL, 1705305514u, 1705315529u, 1705316003u, 1705316521u, 1705326539u},
+    {"Tromso 2024-03-20", 69.6492f, 18.9553f, 1710932400u, SOLAR_DAY_NORMAL, 1710906089u, 1710909701u, 1710931889u, 1710954209u, 1710957850u},
+    {"Tromso 2024-06-21", 69.6492f, 18.9553f, 1718967600u, SOLAR_DAY_POLAR_DAY, 0, 0, 1718966766u, 0, 0},
+    {"Tromso 2024-09-22", 69.6492f, 18.9553f, 1727002800u, SOLAR_DAY_NORMAL, 1726975513u, 1726979150u, 1727001406u, 1727023532u, 1727027141u},
+    {"Tromso 2024-12-21", 69.6492f, 18.9553f, 1734778800u, SOLAR_DAY_POLAR_NIGHT, 1734769890u, 0, 1734777748u, 0, 1734785607u},
+    {"Tromso 2025-02-28", 69.6492f, 18.9553f, 1740740400u, SOLAR_DAY_NORMAL, 1740719554u, 1740723221u, 1740740199u, 1740757281u, 1740760962u},
+    {"Tromso 2026-05-05", 69.6492f, 18.9553f, 1777978800u, SOLAR_DAY_NORMAL, 0, 1777942659u, 1777977653u, 1778012943u, 0},
+    {"Tromso 2027-08-01", 69.6492f, 18.9553f, 1817118000u, SOLAR_DAY_NORMAL, 0, 1817079556u, 1817117434u, 1817154908u, 0},
+    {"Tromso 2029-11-11", 69.6492f, 18.9553f, 1889089200u, SOLAR_DAY_NORMAL, 1889073459u, 1889078617u, 1889087291u, 1889095899u, 1889101051u},
+    {"Tromso 2032-02-29", 69.6492f, 18.9553f, 1961665200u, SOLAR_DAY_NORMAL, 1961644274u, 1961647935u, 1961664995u, 1961682158u, 1961685834u},
+    {"Tromso 2037-10-17", 69.6492f, 18.9553f, 2139390000u, SOLAR_DAY_NORMAL, 2139368505u, 2139372278u, 2139388167u, 2139403959u, 2139407719u},
+    {"McMurdo 2024-01-15", -77.8419f, 166.6863f, 1705276800u, SOLAR_DAY_POLAR_DAY, 0, 0, 1705280539u, 0, 0},
+    {"McMurdo 2024-03-20", -77.8419f, 166.6863f, 1710892800u, SOLAR_DAY_NORMAL, 1710867491u, 1710873742u, 1710896441u, 1710918909u, 1710925052u},
+    {"McMurdo 2024-06-21", -77.8419f, 166.6863f, 1718928000u, SOLAR_DAY_POLAR_NIGHT, 0, 0, 1718931305u, 0, 0},
+    {"McMurdo 2024-09-22", -77.8419f, 166.6863f, 1726963200u, SOLAR_DAY_NORMAL, 1726937631u, 1726943741u, 1726965959u, 1726988402u, 1726994613u},
+    {"McMurdo 2024-12-21", -77.8419f, 166.6863f, 1734739200u, SOLAR_DAY_POLAR_DAY, 0, 0, 1734742281u, 0, 0},
+    {"McMurdo 2025-02-28", -77.8419f, 166.6863f, 1740700800u, SOLAR_DAY_NORMAL, 0, 1740671930u, 1740704748u, 1740737101u, 0},
+    {"McMurdo 2026-05-05", -77.8419f, 166.6863f, 1777939200u, SOLAR_DAY_POLAR_NIGHT, 1777934064u, 0, 1777942200u, 0, 1777950222u},
+    {"McMurdo 2027-08-01", -77.8419f, 166.6863f, 1817078400u, SOLAR_DAY_POLAR_NIGHT, 1817080773u, 0, 1817081980u, 0, 1817083281u},
+    {"McMurdo 2029-11-11", -77.8419f, 166.6863f, 1889049600u, SOLAR_DAY_POLAR_DAY, 0, 0, 1889051832u, 0, 0},
+    {"McMurdo 2032-02-29", -77.8419f, 166.6863f, 1961625600u, SOLAR_DAY_NORMAL, 0, 1961596920u, 1961629544u, 1961661711u, 0},
+    {"McMurdo 2037-10-17", -77.8419f, 166.6863f, 2139350400u, SOLAR_DAY_NORMAL, 0, 2139317945u, 2139352716u, 2139388099u, 0},
+};
+
+#endif // SOLAR_REFERENCE_H
@@ -0,0 +1,70 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "solar.h"
+#include "solar_reference.h"
+
+// NOAA calculator tolerance
+#define SOLAR_TOLERANCE_S 60
+
+void setUp() {}
+void tearDown() {}
+
+static void expectEvent(const SolarReference& ref, const char* event, uint32_t expected, uint32_t actual) {
+    char message[96];
+    snprintf(message, sizeof(message), "%s %s: expected %u, got %u", ref.name, event,
+             (unsigned)expected, (unsigned)actual);
+    if (expected == 0 || actual == 0) {
+        TEST_ASSERT_TRUE_MESSAGE(expected == actual, message);
+        return;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(labs((long)expected - (long)actual) <= SOLAR_TOLERANCE_S, message);
+}
+
+void test_matches_reference_table() {
+    for (const SolarReference& ref : SOLAR_REFERENCE) {
+        SolarTimes t;
+        solarEventTimes(ref.latitude, ref.longitude, ref.localNoon, t);
+        TEST_ASSERT_EQUAL_MESSAGE(ref.dayType, t.dayType, ref.name);
+        expectEvent(ref, "noon", ref.noon, t.noon);
+        expectEvent(ref, "sunrise", ref.sunrise, t.sunrise);
+        expectEvent(ref, "sunset", ref.sunset, t.sunset);
+        expectEvent(ref, "dawn", ref.dawn, t.dawn);
+        expectEvent(ref, "dusk", ref.dusk, t.dusk);
+    }
+}
+
+void test_events_are_ordered() {
+    for (const SolarReference& ref : SOLAR_REFERENCE) {
+        SolarTimes t;
+        solarEventTimes(ref.latitude, ref.longitude, ref.localNoon, t);
+        if (t.dayType != SOLAR_DAY_NORMAL) continue;
+        TEST_ASSERT_TRUE_MESSAGE(t.sunrise < t.noon && t.noon < t.sunset, ref.name);
+        if (t.dawn != 0) TEST_ASSERT_TRUE_MESSAGE(t.dawn < t.sunrise && t.sunset < t.dusk, ref.name);
+        // The day asked for, not a neighbouring one
+        TEST_ASSERT_TRUE_MESSAGE(labs((long)t.noon - (long)ref.localNoon) < 43200, ref.name);
+    }
+}
+
+void test_night_follows_day_type() {
+    SolarTimes t = {};
+    t.dayType = SOLAR_DAY_NORMAL;
+    t.sunrise = 1000;
+    t.sunset = 5000;
+    TEST_ASSERT_TRUE(solarIsNight(t, 999));
+    TEST_ASSERT_FALSE(solarIsNight(t, 1000));
+    TEST_ASSERT_FALSE(solarIsNight(t, 4999));
+    TEST_ASSERT_TRUE(solarIsNight(t, 5000));
+    t.dayType = SOLAR_DAY_POLAR_DAY;
+    TEST_ASSERT_FALSE(solarIsNight(t, 0));
+    t.dayType = SOLAR_DAY_POLAR_NIGHT;
+    TEST_ASSERT_TRUE(solarIsNight(t, 3000));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_reference_table);
+    RUN_TEST(test_events_are_ordered);
+    RUN_TEST(test_night_follows_day_type);
+    return UNITY_END();
+}
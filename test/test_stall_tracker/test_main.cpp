@@ -0,0 +1,152 @@
+#include <unity.h>
+#include <string.h>
+#include "stall_tracker.h"
+
+static StallLog storage;
+static StallTracker tracker;
+
+// Watchdog samples every STALL_CHECK_INTERVAL_MS from start to end, inclusive
+static void sample(uint32_t start, uint32_t end) {
+    for (uint32_t t = start; t - start <= end - start; t += STALL_CHECK_INTERVAL_MS) {
+        tracker.check(t);
+    }
+}
+
+void setUp() {
+    memset(&storage, 0, sizeof(storage));
+    tracker = StallTracker();
+    tracker.attach(&storage, 0);
+}
+
+void tearDown() {}
+
+void test_short_gaps_are_not_stalls() {
+    sample(0, STALL_THRESHOLD_MS - 1);
+    TEST_ASSERT_FALSE(tracker.stallInProgress());
+    tracker.heartbeat(STALL_THRESHOLD_MS - 1);
+    TEST_ASSERT_EQUAL(0, storage.count);
+}
+
+void test_stall_attributed_to_active_region() {
+    uint8_t prev = tracker.enterRegion(STALL_REGION_FETCH);
+    sample(0, 600);
+    TEST_ASSERT_TRUE(tracker.stallInProgress());
+    tracker.exitRegion(prev);
+    tracker.heartbeat(620);
+
+    TEST_ASSERT_EQUAL(1, storage.count);
+    const StallRecord* r = tracker.recent(0);
+    TEST_ASSERT_EQUAL(STALL_REGION_FETCH, r->region);
+    TEST_ASSERT_EQUAL_UINT32(0, r->startMs);
+    TEST_ASSERT_EQUAL_UINT32(620, r->gapMs);
+    TEST_ASSERT_EQUAL(1, r->boot);
+    TEST_ASSERT_EQUAL_UINT32(1, storage.regions[STALL_REGION_FETCH].count);
+    TEST_ASSERT_EQUAL_UINT32(620, storage.regions[STALL_REGION_FETCH].maxMs);
+    TEST_ASSERT_FALSE(tracker.stallInProgress());
+}
+
+void test_nested_regions_attribute_innermost_and_restore() {
+    uint8_t outer = tracker.enterRegion(STALL_REGION_FETCH);
+    uint8_t inner = tracker.enterRegion(STALL_REGION_NTP);
+    TEST_ASSERT_EQUAL(STALL_REGION_NONE, outer);
+    TEST_ASSERT_EQUAL(STALL_REGION_FETCH, inner);
+    sample(0, 400);
+    tracker.exitRegion(inner);
+    TEST_ASSERT_EQUAL(STALL_REGION_FETCH, tracker.currentRegion());
+    tracker.heartbeat(400);
+    TEST_ASSERT_EQUAL(STALL_REGION_NTP, tracker.recent(0)->region);
+
+    // Stall after the inner region closed belongs to the outer one
+    sample(400, 800);
+    tracker.exitRegion(outer);
+    TEST_ASSERT_EQUAL(STALL_REGION_NONE, tracker.currentRegion());
+    tracker.heartbeat(800);
+    TEST_ASSERT_EQUAL(STALL_REGION_FETCH, tracker.recent(0)->region);
+    TEST_ASSERT_EQUAL(STALL_REGION_NTP, tracker.recent(1)->region);
+}
+
+void test_overlapping_regions_keep_first_instrumented() {
+    // Noticed outside any region, then a region shows up: upgraded to it
+    sample(0, 300);
+    uint8_t prev = tracker.enterRegion(STALL_REGION_DRAW);
+    sample(350, 500);
+    // The draw region gives way to a fetch while the loop is still stuck: stays draw
+    tracker.exitRegion(prev);
+    prev = tracker.enterRegion(STALL_REGION_FETCH);
+    sample(550, 900);
+    tracker.exitRegion(prev);
+    tracker.heartbeat(900);
+    TEST_ASSERT_EQUAL(STALL_REGION_DRAW, tracker.recent(0)->region);
+    TEST_ASSERT_EQUAL_UINT32(900, tracker.recent(0)->gapMs);
+}
+
+void test_unsampled_gap_is_unattributed() {
+    tracker.enterRegion(STALL_REGION_LOG_FLUSH);
+    tracker.heartbeat(1000);   // The timer never ran during the gap
+    TEST_ASSERT_EQUAL(1, storage.count);
+    TEST_ASSERT_EQUAL(STALL_REGION_NONE, tracker.recent(0)->region);
+}
+
+void test_gap_across_millis_wrap() {
+    const uint32_t start = 0xFFFFFF00UL;
+    const uint32_t end = start + 500;   // Wraps past 0
+    tracker.attach(&storage, start);
+    tracker.enterRegion(STALL_REGION_DRAW);
+    sample(start, end);
+    tracker.heartbeat(end);
+    TEST_ASSERT_EQUAL_UINT32(500, tracker.recent(0)->gapMs);
+    TEST_ASSERT_EQUAL(STALL_REGION_DRAW, tracker.recent(0)->region);
+}
+
+void test_ring_keeps_newest_records() {
+    uint32_t t = 0;
+    for (int i = 0; i < STALL_LOG_SIZE + 5; i++) {
+        tracker.check(t + 300);
+        t += 300 + i;
+        tracker.heartbeat(t);
+    }
+    TEST_ASSERT_EQUAL(STALL_LOG_SIZE, storage.count);
+    TEST_ASSERT_EQUAL_UINT32(300 + STALL_LOG_SIZE + 4, tracker.recent(0)->gapMs);
+    TEST_ASSERT_EQUAL_UINT32(300 + 5, tracker.recent(STALL_LOG_SIZE - 1)->gapMs);
+    TEST_ASSERT_NULL(tracker.recent(STALL_LOG_SIZE));
+    TEST_ASSERT_NULL(tracker.recent(-1));
+    TEST_ASSERT_EQUAL_UINT32(STALL_LOG_SIZE + 5, storage.regions[STALL_REGION_NONE].count);
+}
+
+void test_log_survives_reset_unless_corrupt() {
+    tracker.enterRegion(STALL_REGION_FETCH);
+    sample(0, 300);
+    tracker.heartbeat(300);
+
+    StallTracker afterReset;
+    afterReset.attach(&storage, 0);
+    TEST_ASSERT_EQUAL(2, storage.bootCount);
+    TEST_ASSERT_EQUAL(1, storage.count);
+    TEST_ASSERT_EQUAL(1, afterReset.recent(0)->boot);
+
+    storage.head = STALL_LOG_SIZE;   // Garbage after a power cycle
+    StallTracker afterPowerCycle;
+    afterPowerCycle.attach(&storage, 0);
+    TEST_ASSERT_EQUAL(1, storage.bootCount);
+    TEST_ASSERT_EQUAL(0, storage.count);
+}
+
+void test_region_names() {
+    TEST_ASSERT_EQUAL_STRING("other", stallRegionName(STALL_REGION_NONE));
+    TEST_ASSERT_EQUAL_STRING("fetch", stallRegionName(STALL_REGION_FETCH));
+    TEST_ASSERT_EQUAL_STRING("unknown", stallRegionName(STALL_REGION_COUNT));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_short_gaps_are_not_stalls);
+    RUN_TEST(test_stall_attributed_to_active_region);
+    RUN_TEST(test_nested_regions_attribute_innermost_and_restore);
+    RUN_TEST(test_overlapping_regions_keep_first_instrumented);
+    RUN_TEST(test_unsampled_gap_is_unattributed);
+    RUN_TEST(test_gap_across_millis_wrap);
+    RUN_TEST(test_ring_keeps_newest_records);
+    RUN_TEST(test_log_survives_reset_unless_corrupt);
+    RUN_TEST(test_region_names);
+    return UNITY_END();
+}
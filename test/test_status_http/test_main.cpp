@@ -0,0 +1,347 @@
+#include <unity.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "status_http.h"
+
+// Collects the response; fails once `limit` bytes have been taken, like a closed socket
+struct Capture {
+    std::string data;
+    size_t limit;
+    int refusals;
+};
+
+static bool captureSink(void* context, const uint8_t* data, size_t len) {
+    Capture* c = (Capture*)context;
+    if (c->refusals > 0 || c->data.size() + len > c->limit) {
+        c->refusals++;
+        return false;
+    }
+    c->data.append((const char*)data, len);
+    return true;
+}
+
+static StatusSnapshot snap;
+static uint16_t framebuffer[SPRITE_WIDTH * SPRITE_HEIGHT];
+
+// Serves one request through a bufferSize buffer; returns the whole response
+static std::string serve(const char* request, size_t bufferSize = STATUS_RESPONSE_BUFFER,
+                         const uint16_t* fb = nullptr) {
+    uint8_t buffer[STATUS_RESPONSE_BUFFER];
+    Capture c = {std::string(), SIZE_MAX, 0};
+    HttpResponse res(buffer, bufferSize, captureSink, &c);
+    handleStatusRequest(request, strlen(request), snap, fb, res);
+    TEST_ASSERT_TRUE(res.end());
+    TEST_ASSERT_EQUAL(c.data.size(), res.bytesSent());
+    return c.data;
+}
+
+static int statusOf(const std::string& response) {
+    int status = 0;
+    TEST_ASSERT_EQUAL(1, sscanf(response.c_str(), "HTTP/1.1 %d ", &status));
+    return status;
+}
+
+static std::string bodyOf(const std::string& response) {
+    size_t end = response.find("\r\n\r\n");
+    TEST_ASSERT_TRUE(end != std::string::npos);
+    return response.substr(end + 4);
+}
+
+// Just enough of RFC 8259 to tell whether a body would parse
+static bool skipJson(const char*& p);
+
+static void skipSpace(const char*& p) {
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++;
+}
+
+static bool skipString(const char*& p) {
+    if (*p++ != '"') return false;
+    while (*p != '"') {
+        unsigned char c = (unsigned char)*p++;
+        if (c < 0x20) return false;
+        if (c == '\\') {
+            char e = *p++;
+            if (e == 'u') {
+                for (int i = 0; i < 4; i++) {
+                    if (!isxdigit((unsigned char)*p++)) return false;
+                }
+            } else if (strchr("\"\\/bfnrt", e) == nullptr || e == '\0') {
+                return false;
+            }
+        }
+    }
+    p++;
+    return true;
+}
+
+static bool skipJson(const char*& p) {
+    skipSpace(p);
+    if (*p == '{' || *p == '[') {
+        char close = *p == '{' ? '}' : ']';
+        bool object = *p == '{';
+        p++;
+        skipSpace(p);
+        if (*p == close) {
+            p++;
+            return true;
+        }
+        for (;;) {
+            if (object) {
+                skipSpace(p);
+                if (!skipString(p)) return false;
+                skipSpace(p);
+                if (*p++ != ':') return false;
+            }
+            if (!skipJson(p)) return false;
+            skipSpace(p);
+            if (*p == close) {
+                p++;
+                return true;
+            }
+            if (*p++ != ',') return false;
+        }
+    }
+    if (*p == '"') return skipString(p);
+    if (*p == '-' || isdigit((unsigned char)*p)) {
+        if (*p == '-') p++;
+        if (!isdigit((unsigned char)*p)) return false;
+        while (isdigit((unsigned char)*p) || *p == '.') p++;
+        return true;
+    }
+    for (const char* word : {"true", "false", "null"}) {
+        if (strncmp(p, word, strlen(word)) == 0) {
+            p += strlen(word);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool isJson(const std::string& body) {
+    const char* p = body.c_str();
+    if (!skipJson(p)) return false;
+    skipSpace(p);
+    return *p == '\0';
+}
+
+static bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+void setUp() {
+    snap = StatusSnapshot();   // Value-initialised: counters zero, no units
+    snap.link.network = -1;
+}
+
+void tearDown() {}
+
+static void withWeather() {
+    snap.units = &resolveUnitProfile("metric");
+    snap.weather.lastUpdated = 1760000000;
+    snap.weather.temperature = -35;
+    snap.weather.conditionId = 502;
+    snap.weather.sunrise = 1759990000;
+    snap.weather.sunset = 1760030000;
+}
+
+void test_request_line_errors() {
+    TEST_ASSERT_EQUAL(400, statusOf(serve("garbage\r\n\r\n")));
+    TEST_ASSERT_EQUAL(400, statusOf(serve("GET /weather\r\n\r\n")));
+    TEST_ASSERT_EQUAL(400, statusOf(serve("GET weather HTTP/1.1\r\n\r\n")));
+    TEST_ASSERT_EQUAL(400, statusOf(serve("GET /a-path-longer-than-the-thirty-one-bytes HTTP/1.1\r\n\r\n")));
+    TEST_ASSERT_EQUAL(405, statusOf(serve("POST /weather HTTP/1.1\r\n\r\n")));
+    TEST_ASSERT_EQUAL(404, statusOf(serve("GET /nothing HTTP/1.1\r\n\r\n")));
+    TEST_ASSERT_EQUAL(200, statusOf(serve("GET / HTTP/1.1\r\nHost: station\r\n\r\n")));
+    TEST_ASSERT_TRUE(isJson(bodyOf(serve("GET /nothing HTTP/1.1\r\n\r\n"))));
+}
+
+void test_headers() {
+    std::string r = serve("GET / HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL(0, r.find("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: close\r\n"));
+    TEST_ASSERT_TRUE(contains(bodyOf(r), "/screenshot"));
+}
+
+void test_weather_before_and_after_first_fetch() {
+    std::string r = serve("GET /weather HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL(503, statusOf(r));
+    std::string body = bodyOf(r);
+    TEST_ASSERT_EQUAL_STRING("{\"error\":\"no data yet\"}\n", body.c_str());
+
+    withWeather();
+    r = serve("GET /weather HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL(200, statusOf(r));
+    body = bodyOf(r);
+    TEST_ASSERT_TRUE(isJson(body));
+    TEST_ASSERT_TRUE(contains(body, "\"updated\":1760000000,\"temperature\":-3.5,"));
+    TEST_ASSERT_TRUE(contains(body, "\"condition\":502,\"description\":\"heavy intensity rain\","));
+    TEST_ASSERT_TRUE(contains(body, "\"units\":{\"temperature\":\"C\",\"wind\":\"km/h\",\"visibility\":\"km\"}}"));
+}
+
+void test_json_string_escaping() {
+    uint8_t buffer[64];
+    Capture c = {std::string(), SIZE_MAX, 0};
+    HttpResponse res(buffer, sizeof(buffer), captureSink, &c);
+    res.printJson("plain");
+    res.printJson("say \"hi\"");
+    res.printJson("C:\\dir\\");
+    res.printJson("tab\there\n\x01");
+    res.printJson("");
+    res.printJson("caf\xc3\xa9");   // UTF-8 passes through
+    TEST_ASSERT_TRUE(res.end());
+    TEST_ASSERT_EQUAL_STRING("\"plain\"\"say \\\"hi\\\"\"\"C:\\\\dir\\\\\""
+                             "\"tab\\u0009here\\u000a\\u0001\"\"\"\"caf\xc3\xa9\"",
+                             c.data.c_str());
+}
+
+void test_wifi_ssids_are_escaped() {
+    static const char* ssids[] = {"Home \"5G\"", "back\\slash", "\ttabbed"};
+    snap.link.state = LINK_UP;
+    snap.link.network = 0;
+    snap.link.networkCount = 3;
+    for (int i = 0; i < 3; i++) {
+        snap.link.ssids[i] = ssids[i];
+        snap.link.networks[i].successes = (uint32_t)i;
+        snap.link.networks[i].lastRssi = (int8_t)(-50 - i);
+    }
+    snap.link.rssi.push(-61);
+    snap.link.rssi.push(-63);
+
+    std::string r = serve("GET /wifi HTTP/1.1\r\n\r\n", 160);
+    TEST_ASSERT_EQUAL(200, statusOf(r));
+    std::string body = bodyOf(r);
+    TEST_ASSERT_TRUE(isJson(body));
+    TEST_ASSERT_TRUE(contains(body, "{\"state\":\"up\",\"ssid\":\"Home \\\"5G\\\"\",\"bssid\""));
+    TEST_ASSERT_TRUE(contains(body, "{\"ssid\":\"back\\\\slash\",\"successes\":1,"));
+    TEST_ASSERT_TRUE(contains(body, ",{\"ssid\":\"\\u0009tabbed\",\"successes\":2,\"failures\":0,\"rssi\":-52}]"));
+    TEST_ASSERT_TRUE(contains(body, "\"rssi\":[-61,-63]}"));
+
+    // No network selected: empty SSID
+    snap.link.network = -1;
+    body = bodyOf(serve("GET /wifi HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_TRUE(isJson(body));
+    TEST_ASSERT_TRUE(contains(body, "\"ssid\":\"\",\"bssid\""));
+}
+
+void test_history_filter() {
+    withWeather();
+    snap.history.record(1760000000, 101);
+    snap.history.record(1760003600, 112);
+    snap.history.record(1760007200, -5);
+
+    std::string body = bodyOf(serve("GET /history HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_TRUE(isJson(body));
+    TEST_ASSERT_EQUAL_STRING("{\"unit\":\"C\",\"samples\":[{\"t\":1760000000,\"temp\":10.1},"
+                             "{\"t\":1760003600,\"temp\":11.2},{\"t\":1760007200,\"temp\":-0.5}]}\n",
+                             body.c_str());
+    body = bodyOf(serve("GET /history?from=1760003600&to=1760003600 HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_EQUAL_STRING("{\"unit\":\"C\",\"samples\":[{\"t\":1760003600,\"temp\":11.2}]}\n", body.c_str());
+    body = bodyOf(serve("GET /history?from=1770000000 HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_EQUAL_STRING("{\"unit\":\"C\",\"samples\":[]}\n", body.c_str());
+
+    TEST_ASSERT_EQUAL(400, statusOf(serve("GET /history?from=abc HTTP/1.1\r\n\r\n")));
+    TEST_ASSERT_EQUAL(400, statusOf(serve("GET /history?to=99999999999 HTTP/1.1\r\n\r\n")));
+    TEST_ASSERT_EQUAL(400, statusOf(serve("GET /history?from=1&to= HTTP/1.1\r\n\r\n")));
+}
+
+void test_metrics_exposition() {
+    snap.metrics.fetchesOk = 12;
+    snap.metrics.errors[2] = 3;
+    snap.metrics.health.fpsTenths = 305;
+    snap.link.state = LINK_UP;
+    std::string r = serve("GET /metrics HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL(200, statusOf(r));
+    std::string body = bodyOf(r);
+    TEST_ASSERT_TRUE(contains(body, "\nweather_fetches_total{result=\"ok\"} 12\n"));
+    TEST_ASSERT_TRUE(contains(body, "\nweather_errors_total{type=\"network\"} 3\n"));
+    TEST_ASSERT_TRUE(contains(body, "\nweather_frames_per_second 30.5\n"));
+    TEST_ASSERT_TRUE(contains(body, "\nweather_wifi_link_up 1\n"));
+
+    // Every line is a comment or "name[{labels}] value"
+    size_t start = 0;
+    while (start < body.size()) {
+        size_t end = body.find('\n', start);
+        TEST_ASSERT_TRUE(end != std::string::npos);
+        std::string line = body.substr(start, end - start);
+        if (line[0] != '#') {
+            size_t space = line.rfind(' ');
+            TEST_ASSERT_TRUE(space != std::string::npos && space > 0);
+            TEST_ASSERT_EQUAL(0, line.find("weather_"));
+            char* rest = nullptr;
+            strtod(line.c_str() + space + 1, &rest);
+            TEST_ASSERT_EQUAL_INT('\0', *rest);
+        }
+        start = end + 1;
+    }
+}
+
+void test_screenshot_bmp() {
+    TEST_ASSERT_EQUAL(503, statusOf(serve("GET /screenshot HTTP/1.1\r\n\r\n")));
+
+    for (int i = 0; i < SPRITE_WIDTH * SPRITE_HEIGHT; i++) {
+        framebuffer[i] = (uint16_t)(i * 31);
+    }
+    std::string r = serve("GET /screenshot HTTP/1.1\r\n\r\n", STATUS_RESPONSE_BUFFER, framebuffer);
+    TEST_ASSERT_EQUAL(200, statusOf(r));
+    std::string body = bodyOf(r);
+    const size_t headerSize = 14 + 40 + 12;
+    char length[48];
+    snprintf(length, sizeof(length), "Content-Length: %u\r\n", (unsigned)(headerSize + SPRITE_WIDTH * SPRITE_HEIGHT * 2));
+    TEST_ASSERT_TRUE(contains(r, length));
+    TEST_ASSERT_EQUAL(headerSize + SPRITE_WIDTH * SPRITE_HEIGHT * 2, body.size());
+    TEST_ASSERT_EQUAL_INT('B', body[0]);
+    TEST_ASSERT_EQUAL_INT('M', body[1]);
+    // Sprite pixels are byte-swapped; the BMP has them little-endian
+    const uint8_t* pixels = (const uint8_t*)body.data() + headerSize;
+    for (int i : {0, 1, SPRITE_WIDTH, SPRITE_WIDTH * SPRITE_HEIGHT - 1}) {
+        uint16_t swapped = (uint16_t)((framebuffer[i] >> 8) | (framebuffer[i] << 8));
+        TEST_ASSERT_EQUAL_HEX16(swapped, (uint16_t)(pixels[2 * i] | (pixels[2 * i + 1] << 8)));
+    }
+}
+
+void test_buffer_size_does_not_change_output() {
+    withWeather();
+    static const char* ssids[] = {"a \"quoted\" ssid"};
+    snap.link.networkCount = 1;
+    snap.link.network = 0;
+    snap.link.ssids[0] = ssids[0];
+    snap.history.record(1760000000, 101);
+    for (const char* request : {"GET /weather HTTP/1.1\r\n\r\n", "GET /wifi HTTP/1.1\r\n\r\n",
+                                "GET /history HTTP/1.1\r\n\r\n", "GET /metrics HTTP/1.1\r\n\r\n"}) {
+        // Flushes land mid-line and mid-string; a printf line has to fit the buffer on its own
+        std::string reference = serve(request);
+        for (size_t size : {(size_t)256, (size_t)199, (size_t)160}) {
+            std::string response = serve(request, size);
+            TEST_ASSERT_EQUAL_STRING(reference.c_str(), response.c_str());
+        }
+    }
+}
+
+void test_sink_failure_reported() {
+    withWeather();
+    uint8_t buffer[64];
+    Capture c = {std::string(), 100, 0};
+    HttpResponse res(buffer, sizeof(buffer), captureSink, &c);
+    const char* request = "GET /metrics HTTP/1.1\r\n\r\n";
+    handleStatusRequest(request, strlen(request), snap, nullptr, res);
+    TEST_ASSERT_FALSE(res.end());
+    TEST_ASSERT_TRUE(c.data.size() <= 100);
+    TEST_ASSERT_EQUAL(1, c.refusals);   // Nothing more is offered once a write failed
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_request_line_errors);
+    RUN_TEST(test_headers);
+    RUN_TEST(test_weather_before_and_after_first_fetch);
+    RUN_TEST(test_json_string_escaping);
+    RUN_TEST(test_wifi_ssids_are_escaped);
+    RUN_TEST(test_history_filter);
+    RUN_TEST(test_metrics_exposition);
+    RUN_TEST(test_screenshot_bmp);
+    RUN_TEST(test_buffer_size_does_not_change_output);
+    RUN_TEST(test_sink_failure_reported);
+    return UNITY_END();
+}
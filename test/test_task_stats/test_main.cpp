@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <string.h>
+#include "task_stats.h"
+
+static TaskSample samples[TASK_STATS_MAX_TASKS + 2];
+
+static void setSample(int i, const char* name, uint32_t number, uint32_t runTime, uint32_t stackFree,
+                      uint8_t core, bool idle = false) {
+    memset(&samples[i], 0, sizeof(samples[i]));
+    strncpy(samples[i].name, name, TASK_NAME_LEN - 1);
+    samples[i].taskNumber = number;
+    samples[i].runTime = runTime;
+    samples[i].stackFreeBytes = stackFree;
+    samples[i].core = core;
+    samples[i].isIdle = idle;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_snapshot_has_no_cpu_share() {
+    TaskStatsAggregator agg;
+    setSample(0, "loopTask", 1, 5000, 4000, 1);
+    agg.addSnapshot(100, samples, 1, 10000, true);
+    const TaskStatsEntry* e = agg.latest();
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_FALSE(e->hasRunTime);
+    TEST_ASSERT_EQUAL_UINT16(0, e->tasks[0].cpuPermille);
+    TEST_ASSERT_EQUAL_STRING("loopTask", e->tasks[0].name);
+}
+
+void test_delta_permille_and_core_busy() {
+    TaskStatsAggregator agg;
+    setSample(0, "loopTask", 1, 0, 4000, 1);
+    setSample(1, "IDLE1", 2, 0, 800, 1, true);
+    setSample(2, "IDLE0", 3, 0, 800, 0, true);
+    setSample(3, "status", 4, 0, 2000, 0);
+    agg.addSnapshot(0, samples, 4, 0, true);
+
+    // 10 s interval: loop 7.5 s, idle1 2.5 s, idle0 9.9 s, status 0.1 s
+    setSample(0, "loopTask", 1, 7500000, 4000, 1);
+    setSample(1, "IDLE1", 2, 2500000, 800, 1, true);
+    setSample(2, "IDLE0", 3, 9900000, 800, 0, true);
+    setSample(3, "status", 4, 100000, 2000, 0);
+    agg.addSnapshot(10000, samples, 4, 10000000, true);
+
+    const TaskStatsEntry* e = agg.latest();
+    TEST_ASSERT_TRUE(e->hasRunTime);
+    TEST_ASSERT_EQUAL_UINT16(750, e->tasks[0].cpuPermille);
+    TEST_ASSERT_EQUAL_UINT16(250, e->tasks[1].cpuPermille);
+    TEST_ASSERT_EQUAL_UINT16(990, e->tasks[2].cpuPermille);
+    TEST_ASSERT_EQUAL_UINT16(10, e->tasks[3].cpuPermille);
+    TEST_ASSERT_EQUAL_UINT16(750, e->coreBusyPermille[1]);
+    TEST_ASSERT_EQUAL_UINT16(10, e->coreBusyPermille[0]);
+}
+
+void test_counters_wrap() {
+    TaskStatsAggregator agg;
+    setSample(0, "loopTask", 1, 0xFFFFFF00UL, 4000, 1);
+    agg.addSnapshot(0, samples, 1, 0xFFFFF000UL, true);
+    // Both the task's counter and the run-time clock wrap between the snapshots
+    setSample(0, "loopTask", 1, 0x00000300UL, 4000, 1);
+    agg.addSnapshot(10000, samples, 1, 0x00001000UL, true);
+    const TaskStatsEntry* e = agg.latest();
+    TEST_ASSERT_TRUE(e->hasRunTime);
+    // Task ran 0x400 of 0x2000 ticks
+    TEST_ASSERT_EQUAL_UINT16(125, e->tasks[0].cpuPermille);
+}
+
+void test_share_clamped_and_new_tasks_zero() {
+    TaskStatsAggregator agg;
+    setSample(0, "busy", 1, 0, 4000, TASK_CORE_ANY);
+    agg.addSnapshot(0, samples, 1, 0, true);
+    // An unpinned task can run on both cores: more than one core's worth, clamped
+    setSample(0, "busy", 1, 1500, 4000, TASK_CORE_ANY);
+    setSample(1, "fresh", 9, 800, 4000, 0);
+    agg.addSnapshot(1000, samples, 2, 1000, true);
+    const TaskStatsEntry* e = agg.latest();
+    TEST_ASSERT_EQUAL_UINT16(1000, e->tasks[0].cpuPermille);
+    TEST_ASSERT_EQUAL_UINT16(0, e->tasks[1].cpuPermille);   // No previous sample to diff against
+}
+
+void test_no_run_time_without_counters_or_elapsed_time() {
+    TaskStatsAggregator agg;
+    setSample(0, "loopTask", 1, 0, 4000, 1);
+    agg.addSnapshot(0, samples, 1, 0, false);
+    setSample(0, "loopTask", 1, 500, 4000, 1);
+    agg.addSnapshot(1000, samples, 1, 1000, false);
+    TEST_ASSERT_FALSE(agg.latest()->hasRunTime);
+    TEST_ASSERT_EQUAL_UINT16(0, agg.latest()->tasks[0].cpuPermille);
+
+    // Same run-time clock twice: nothing to divide by
+    agg.addSnapshot(2000, samples, 1, 1000, true);
+    TEST_ASSERT_FALSE(agg.latest()->hasRunTime);
+}
+
+void test_stack_alert_once_per_crossing() {
+    TaskStatsAggregator agg;
+    setSample(0, "dns", 1, 0, TASK_STACK_ALERT_BYTES + 100, 0);
+    TEST_ASSERT_EQUAL(0, agg.addSnapshot(0, samples, 1, 0, true));
+
+    setSample(0, "dns", 1, 0, TASK_STACK_ALERT_BYTES - 1, 0);
+    TEST_ASSERT_EQUAL(1, agg.addSnapshot(1, samples, 1, 1, true));
+    TEST_ASSERT_EQUAL_STRING("dns", agg.alert(0).name);
+    TEST_ASSERT_EQUAL_UINT32(TASK_STACK_ALERT_BYTES - 1, agg.alert(0).stackFreeBytes);
+    TEST_ASSERT_EQUAL(0, agg.addSnapshot(2, samples, 1, 2, true));   // Still low, already reported
+    TEST_ASSERT_EQUAL(0, agg.alertCount());
+
+    setSample(0, "dns", 1, 0, TASK_STACK_ALERT_BYTES, 0);         // Recovered: re-armed
+    TEST_ASSERT_EQUAL(0, agg.addSnapshot(3, samples, 1, 3, true));
+    setSample(0, "dns", 1, 0, 200, 0);
+    TEST_ASSERT_EQUAL(1, agg.addSnapshot(4, samples, 1, 4, true));
+}
+
+void test_ring_order_and_truncation() {
+    TaskStatsAggregator agg;
+    TEST_ASSERT_NULL(agg.latest());
+    for (int i = 0; i < TASK_STATS_MAX_TASKS + 2; i++) {
+        setSample(i, "t", i + 1, 0, 4000, 0);
+    }
+    for (int n = 0; n < TASK_STATS_RING_SIZE + 2; n++) {
+        agg.addSnapshot(n * 1000, samples, TASK_STATS_MAX_TASKS + 2, n, true);
+    }
+    TEST_ASSERT_EQUAL(TASK_STATS_RING_SIZE, agg.entryCount());
+    TEST_ASSERT_EQUAL_UINT32((TASK_STATS_RING_SIZE + 1) * 1000, agg.entry(0)->timestampMs);
+    TEST_ASSERT_EQUAL_UINT32(2000, agg.entry(TASK_STATS_RING_SIZE - 1)->timestampMs);
+    TEST_ASSERT_NULL(agg.entry(TASK_STATS_RING_SIZE));
+    TEST_ASSERT_EQUAL(TASK_STATS_MAX_TASKS, agg.latest()->count);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_snapshot_has_no_cpu_share);
+    RUN_TEST(test_delta_permille_and_core_busy);
+    RUN_TEST(test_counters_wrap);
+    RUN_TEST(test_share_clamped_and_new_tasks_zero);
+    RUN_TEST(test_no_run_time_without_counters_or_elapsed_time);
+    RUN_TEST(test_stack_alert_once_per_crossing);
+    RUN_TEST(test_ring_order_and_truncation);
+    return UNITY_END();
+}
@@ -0,0 +1,548 @@
+#include <unity.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+#include "telemetry_session.h"
+
+static TelemetrySample makeSample(uint8_t kind, uint8_t priority, uint32_t epoch, int32_t value) {
+    TelemetrySample s;
+    memset(&s, 0, sizeof(s));
+    s.kind = kind;
+    s.priority = priority;
+    s.epoch = epoch;
+    s.count = 1;
+    s.values[0] = value;
+    return s;
+}
+
+static uint8_t peekAll(const TelemetryQueue& queue, TelemetrySample* out) {
+    return queue.peek(out, TELEMETRY_QUEUE_SIZE);
+}
+
+// Minimal CBOR reader for the subset encodeTelemetryBatch writes
+struct Cbor {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    uint32_t head(uint8_t expectMajor) {
+        TEST_ASSERT_TRUE(p < end);
+        uint8_t major = *p >> 5;
+        uint8_t info = *p++ & 0x1F;
+        TEST_ASSERT_EQUAL(expectMajor, major);
+        if (info < 24) return info;
+        int bytes = info == 24 ? 1 : info == 25 ? 2 : 4;
+        TEST_ASSERT_TRUE(info <= 26);
+        TEST_ASSERT_TRUE(p + bytes <= end);
+        uint32_t v = 0;
+        for (int i = 0; i < bytes; i++) v = (v << 8) | *p++;
+        // Shortest form only
+        TEST_ASSERT_TRUE(bytes == 1 ? v >= 24 : bytes == 2 ? v > 0xFF : v > 0xFFFF);
+        return v;
+    }
+
+    int64_t integer() {
+        TEST_ASSERT_TRUE(p < end);
+        if ((*p >> 5) == 1) return -1 - (int64_t)head(1);
+        return head(0);
+    }
+
+    std::string text() {
+        uint32_t n = head(3);
+        TEST_ASSERT_TRUE(p + n <= end);
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+};
+
+struct DecodedBatch {
+    uint32_t version;
+    uint32_t number;
+    std::string station;
+    std::vector<TelemetrySample> samples;
+};
+
+static DecodedBatch decodeBatch(const uint8_t* data, size_t len) {
+    Cbor c = {data, data + len};
+    DecodedBatch b;
+    TEST_ASSERT_EQUAL(4, c.head(4));
+    b.version = c.head(0);
+    b.number = c.head(0);
+    b.station = c.text();
+    uint32_t count = c.head(4);
+    for (uint32_t i = 0; i < count; i++) {
+        TelemetrySample s;
+        memset(&s, 0, sizeof(s));
+        uint32_t items = c.head(4);
+        TEST_ASSERT_TRUE(items >= 2 && items <= 2 + TELEMETRY_MAX_VALUES);
+        s.kind = (uint8_t)c.head(0);
+        s.epoch = c.head(0);
+        s.count = (uint8_t)(items - 2);
+        for (uint8_t v = 0; v < s.count; v++) {
+            s.values[v] = (int32_t)c.integer();
+        }
+        b.samples.push_back(s);
+    }
+    TEST_ASSERT_TRUE(c.p == c.end);
+    return b;
+}
+
+// In-memory MQTT broker: parses what the session sends, replies as scripted
+struct StandInBroker {
+    struct Publish {
+        std::string topic;
+        uint16_t packetId;
+        DecodedBatch batch;
+    };
+
+    std::vector<uint8_t> inbox;
+    std::deque<uint8_t> outbox;
+    uint8_t connackCode = 0;
+    int acksLeft = -1;            // PUBACKs before going silent, -1 = always
+    bool wrongAckId = false;
+    int connects = 0;
+    int disconnects = 0;
+    std::string clientId;
+    uint8_t connectFlags = 0;
+    uint16_t keepAlive = 0;
+    std::vector<Publish> publishes;
+    int locks = 0;
+    int unlocks = 0;
+    void (*onPublish)(StandInBroker& broker) = nullptr;
+    TelemetryQueue* queue = nullptr;
+
+    static uint16_t get16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+    void handle(uint8_t type, const uint8_t* body, size_t len) {
+        if (type == 0x10) {
+            TEST_ASSERT_EQUAL(4, get16(body));
+            TEST_ASSERT_EQUAL_MEMORY("MQTT", body + 2, 4);
+            TEST_ASSERT_EQUAL(4, body[6]);
+            connectFlags = body[7];
+            keepAlive = get16(body + 8);
+            clientId.assign((const char*)body + 12, get16(body + 10));
+            connects++;
+            for (uint8_t b : {(uint8_t)0x20, (uint8_t)0x02, (uint8_t)0x00, connackCode}) outbox.push_back(b);
+        } else if (type == 0x32) {
+            Publish pub;
+            uint16_t topicLen = get16(body);
+            pub.topic.assign((const char*)body + 2, topicLen);
+            pub.packetId = get16(body + 2 + topicLen);
+            size_t offset = 2 + topicLen + 2;
+            pub.batch = decodeBatch(body + offset, len - offset);
+            publishes.push_back(pub);
+            if (onPublish != nullptr) onPublish(*this);
+            if (acksLeft != 0) {
+                if (acksLeft > 0) acksLeft--;
+                uint16_t id = wrongAckId ? (uint16_t)(pub.packetId + 1) : pub.packetId;
+                for (uint8_t b : {(uint8_t)0x40, (uint8_t)0x02, (uint8_t)(id >> 8), (uint8_t)id}) outbox.push_back(b);
+            }
+        } else if (type == 0xE0) {
+            TEST_ASSERT_EQUAL(0, len);
+            disconnects++;
+        } else {
+            TEST_FAIL_MESSAGE("unexpected packet type");
+        }
+    }
+
+    void parse() {
+        for (;;) {
+            if (inbox.size() < 2) return;
+            size_t remaining = 0;
+            size_t pos = 1;
+            int shift = 0;
+            for (;;) {
+                if (pos >= inbox.size()) return;
+                uint8_t digit = inbox[pos++];
+                remaining |= (size_t)(digit & 0x7F) << shift;
+                shift += 7;
+                if (!(digit & 0x80)) break;
+            }
+            if (inbox.size() < pos + remaining) return;
+            handle(inbox[0], inbox.data() + pos, remaining);
+            inbox.erase(inbox.begin(), inbox.begin() + (long)(pos + remaining));
+        }
+    }
+
+    static bool send(void* context, const uint8_t* data, size_t len) {
+        StandInBroker* b = (StandInBroker*)context;
+        b->inbox.insert(b->inbox.end(), data, data + len);
+        b->parse();
+        return true;
+    }
+
+    // Nothing queued is a timeout
+    static bool receive(void* context, uint8_t* data, size_t len) {
+        StandInBroker* b = (StandInBroker*)context;
+        if (b->outbox.size() < len) return false;
+        for (size_t i = 0; i < len; i++) {
+            data[i] = b->outbox.front();
+            b->outbox.pop_front();
+        }
+        return true;
+    }
+
+    static void lock(void* context) {
+        StandInBroker* b = (StandInBroker*)context;
+        TEST_ASSERT_EQUAL(b->unlocks, b->locks);
+        b->locks++;
+    }
+
+    static void unlock(void* context) {
+        ((StandInBroker*)context)->unlocks++;
+    }
+
+    TelemetryLink link() { return TelemetryLink{this, send, receive, lock, unlock}; }
+};
+
+static TelemetryQueue* queue;
+static TelemetrySession* session;
+
+void setUp() {
+    queue = new TelemetryQueue();
+    session = new TelemetrySession();
+    session->begin("ws-test", "weather/ws-test/telemetry", "", "");
+}
+
+void tearDown() {
+    delete queue;
+    delete session;
+}
+
+void test_queue_orders_and_numbers_samples() {
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(queue->push(makeSample(TELEMETRY_FETCH, TELEMETRY_PRIORITY_NORMAL, 1000 + i, i)));
+    }
+    TelemetrySample out[TELEMETRY_QUEUE_SIZE];
+    TEST_ASSERT_EQUAL(3, queue->peek(out, 3));
+    TEST_ASSERT_EQUAL(5, peekAll(*queue, out));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(i, out[i].values[0]);
+        TEST_ASSERT_EQUAL(i + 1, out[i].seq);
+    }
+    TEST_ASSERT_EQUAL(5, queue->depth());
+    TEST_ASSERT_EQUAL(5, queue->highWater());
+    TEST_ASSERT_EQUAL(5, queue->pushed());
+
+    // Out-of-range priorities count as low
+    TelemetrySample odd = makeSample(TELEMETRY_HEALTH, 7, 2000, 9);
+    queue->push(odd);
+    peekAll(*queue, out);
+    TEST_ASSERT_EQUAL(TELEMETRY_PRIORITY_LOW, out[5].priority);
+}
+
+void test_full_queue_evicts_oldest_of_lowest_priority() {
+    // Alternate normal and low, so the lows are spread through the queue
+    for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+        uint8_t priority = i % 2 ? TELEMETRY_PRIORITY_LOW : TELEMETRY_PRIORITY_NORMAL;
+        TEST_ASSERT_TRUE(queue->push(makeSample(TELEMETRY_FETCH, priority, 0, i)));
+    }
+    TEST_ASSERT_FALSE(queue->push(makeSample(TELEMETRY_OBSERVATION, TELEMETRY_PRIORITY_HIGH, 0, 100)));
+    TEST_ASSERT_EQUAL(TELEMETRY_QUEUE_SIZE, queue->depth());
+    TEST_ASSERT_EQUAL(1, queue->dropped(TELEMETRY_PRIORITY_LOW));
+
+    TelemetrySample out[TELEMETRY_QUEUE_SIZE];
+    peekAll(*queue, out);
+    TEST_ASSERT_EQUAL(0, out[0].values[0]);
+    TEST_ASSERT_EQUAL(2, out[1].values[0]);     // Sample 1, the oldest low, went
+    TEST_ASSERT_EQUAL(100, out[TELEMETRY_QUEUE_SIZE - 1].values[0]);
+
+    // Lows go first, one per push, oldest first
+    for (int i = 0; i < TELEMETRY_QUEUE_SIZE / 2 - 1; i++) {
+        queue->push(makeSample(TELEMETRY_FETCH, TELEMETRY_PRIORITY_NORMAL, 0, 200 + i));
+    }
+    TEST_ASSERT_EQUAL(TELEMETRY_QUEUE_SIZE / 2, queue->dropped(TELEMETRY_PRIORITY_LOW));
+    TEST_ASSERT_EQUAL(0, queue->dropped(TELEMETRY_PRIORITY_NORMAL));
+    peekAll(*queue, out);
+    for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+        TEST_ASSERT_NOT_EQUAL(TELEMETRY_PRIORITY_LOW, out[i].priority);
+    }
+
+    // Then the oldest normal
+    queue->push(makeSample(TELEMETRY_FETCH, TELEMETRY_PRIORITY_NORMAL, 0, 300));
+    TEST_ASSERT_EQUAL(1, queue->dropped(TELEMETRY_PRIORITY_NORMAL));
+    peekAll(*queue, out);
+    TEST_ASSERT_EQUAL(2, out[0].values[0]);
+    TEST_ASSERT_EQUAL(300, out[TELEMETRY_QUEUE_SIZE - 1].values[0]);
+}
+
+void test_new_sample_dropped_when_everything_outranks_it() {
+    for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+        queue->push(makeSample(TELEMETRY_OBSERVATION, TELEMETRY_PRIORITY_HIGH, 0, i));
+    }
+    TEST_ASSERT_FALSE(queue->push(makeSample(TELEMETRY_HEALTH, TELEMETRY_PRIORITY_LOW, 0, -1)));
+    TEST_ASSERT_FALSE(queue->push(makeSample(TELEMETRY_FETCH, TELEMETRY_PRIORITY_NORMAL, 0, -1)));
+    TEST_ASSERT_EQUAL(1, queue->dropped(TELEMETRY_PRIORITY_LOW));
+    TEST_ASSERT_EQUAL(1, queue->dropped(TELEMETRY_PRIORITY_NORMAL));
+    TEST_ASSERT_EQUAL(0, queue->dropped(TELEMETRY_PRIORITY_HIGH));
+    TEST_ASSERT_EQUAL(TELEMETRY_QUEUE_SIZE, queue->pushed());
+
+    // Equal priority: the oldest makes room
+    TEST_ASSERT_FALSE(queue->push(makeSample(TELEMETRY_OBSERVATION, TELEMETRY_PRIORITY_HIGH, 0, 999)));
+    TEST_ASSERT_EQUAL(1, queue->dropped(TELEMETRY_PRIORITY_HIGH));
+    TelemetrySample out[TELEMETRY_QUEUE_SIZE];
+    peekAll(*queue, out);
+    TEST_ASSERT_EQUAL(1, out[0].values[0]);
+    TEST_ASSERT_EQUAL(999, out[TELEMETRY_QUEUE_SIZE - 1].values[0]);
+}
+
+void test_pop_through_after_evictions() {
+    for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+        uint8_t priority = i < 8 ? TELEMETRY_PRIORITY_LOW : TELEMETRY_PRIORITY_HIGH;
+        queue->push(makeSample(TELEMETRY_FETCH, priority, 0, i));
+    }
+    TelemetrySample batch[TELEMETRY_BATCH_SAMPLES];
+    uint8_t count = queue->peek(batch, TELEMETRY_BATCH_SAMPLES);
+    uint32_t lastSeq = batch[count - 1].seq;
+
+    // While the batch is in flight, five of its lows are evicted by newer samples
+    for (int i = 0; i < 5; i++) {
+        queue->push(makeSample(TELEMETRY_OBSERVATION, TELEMETRY_PRIORITY_HIGH, 0, 100 + i));
+    }
+    queue->popThrough(lastSeq);
+
+    // Everything acknowledged is gone, the newer samples stay
+    TelemetrySample out[TELEMETRY_QUEUE_SIZE];
+    uint8_t left = peekAll(*queue, out);
+    TEST_ASSERT_EQUAL(TELEMETRY_QUEUE_SIZE - TELEMETRY_BATCH_SAMPLES + 5, left);
+    TEST_ASSERT_EQUAL(lastSeq + 1, out[0].seq);
+    TEST_ASSERT_EQUAL(104, out[left - 1].values[0]);
+
+    // Already-acknowledged and unknown sequence numbers are no-ops
+    queue->popThrough(lastSeq);
+    queue->popThrough(0);
+    TEST_ASSERT_EQUAL(left, queue->depth());
+    queue->popThrough(out[left - 1].seq);
+    TEST_ASSERT_EQUAL(0, queue->depth());
+    TEST_ASSERT_EQUAL(TELEMETRY_QUEUE_SIZE, queue->highWater());
+}
+
+void test_batch_encoding_exact_bytes() {
+    TelemetrySample s;
+    memset(&s, 0, sizeof(s));
+    s.kind = TELEMETRY_FETCH;
+    s.epoch = 1760000000;
+    s.count = 3;
+    s.values[0] = 1;
+    s.values[1] = 250;
+    s.values[2] = -3;
+    uint8_t out[64];
+    size_t len = encodeTelemetryBatch(&s, 1, 5, "ws", out, sizeof(out));
+    const uint8_t expected[] = {
+        0x84, TELEMETRY_FORMAT_VERSION, 0x05, 0x62, 'w', 's',   // [version, batch, "ws",
+        0x81, 0x85, 0x02, 0x1A, 0x68, 0xE7, 0x78, 0x00,         //  [[2, 1760000000,
+        0x01, 0x18, 0xFA, 0x22,                                 //    1, 250, -3]]]
+    };
+    TEST_ASSERT_EQUAL(sizeof(expected), len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+}
+
+void test_batch_integer_boundaries() {
+    static const int32_t values[] = {0, 23, 24, 255, 256, 65535, 65536, INT32_MAX,
+                                     -1, -24, -25, -256, -257, -65536, -65537, INT32_MIN};
+    static const size_t sizes[] = {1, 1, 2, 2, 3, 3, 5, 5, 1, 1, 2, 2, 3, 3, 5, 5};
+    const int n = sizeof(values) / sizeof(values[0]);
+    TelemetrySample samples[n];
+    for (int i = 0; i < n; i++) {
+        samples[i] = makeSample(TELEMETRY_HEALTH, TELEMETRY_PRIORITY_LOW, 23, values[i]);
+    }
+    uint8_t out[TELEMETRY_PAYLOAD_SIZE];
+    size_t len = encodeTelemetryBatch(samples, n, 70000, "station", out, sizeof(out));
+    TEST_ASSERT_GREATER_THAN(0, len);
+
+    DecodedBatch b = decodeBatch(out, len);   // Also rejects non-shortest heads
+    TEST_ASSERT_EQUAL(TELEMETRY_FORMAT_VERSION, b.version);
+    TEST_ASSERT_EQUAL(70000, b.number);
+    TEST_ASSERT_EQUAL_STRING("station", b.station.c_str());
+    TEST_ASSERT_EQUAL(n, b.samples.size());
+    size_t total = 1 + 1 + 5 + 1 + 7 + 1;
+    for (int i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL(TELEMETRY_HEALTH, b.samples[i].kind);
+        TEST_ASSERT_EQUAL(23, b.samples[i].epoch);
+        TEST_ASSERT_EQUAL(1, b.samples[i].count);
+        TEST_ASSERT_EQUAL_INT32(values[i], b.samples[i].values[0]);
+        total += 1 + 1 + 1 + sizes[i];
+    }
+    TEST_ASSERT_EQUAL(total, len);
+}
+
+void test_batch_size_limits() {
+    // A full batch of worst-case samples fits the configured payload buffer
+    TelemetrySample samples[TELEMETRY_BATCH_SAMPLES];
+    for (int i = 0; i < TELEMETRY_BATCH_SAMPLES; i++) {
+        samples[i].kind = TELEMETRY_HEALTH;
+        samples[i].epoch = UINT32_MAX;
+        samples[i].count = 200;   // Clamped to TELEMETRY_MAX_VALUES
+        for (int v = 0; v < TELEMETRY_MAX_VALUES; v++) samples[i].values[v] = INT32_MIN;
+    }
+    uint8_t out[TELEMETRY_PAYLOAD_SIZE];
+    size_t len = encodeTelemetryBatch(samples, TELEMETRY_BATCH_SAMPLES, UINT32_MAX, TELEMETRY_STATION, out,
+                                      sizeof(out));
+    TEST_ASSERT_GREATER_THAN(0, len);
+    DecodedBatch b = decodeBatch(out, len);
+    TEST_ASSERT_EQUAL(TELEMETRY_MAX_VALUES, b.samples[0].count);
+
+    // Too small for the worst case: refused rather than cut
+    TEST_ASSERT_EQUAL(0, encodeTelemetryBatch(samples, 1, 0, "ws", out, 20));
+    TEST_ASSERT_GREATER_THAN(0, encodeTelemetryBatch(samples, 0, 0, "ws", out, 20));
+}
+
+static void fillQueue(int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t kind = i % 3 == 0 ? TELEMETRY_OBSERVATION : i % 3 == 1 ? TELEMETRY_FETCH : TELEMETRY_HEALTH;
+        uint8_t priority = kind == TELEMETRY_OBSERVATION ? TELEMETRY_PRIORITY_HIGH
+                           : kind == TELEMETRY_FETCH ? TELEMETRY_PRIORITY_NORMAL : TELEMETRY_PRIORITY_LOW;
+        queue->push(makeSample(kind, priority, 1760000000 + i, i));
+    }
+}
+
+void test_window_with_empty_queue() {
+    StandInBroker broker;
+    TEST_ASSERT_TRUE(session->publishWindow(*queue, broker.link()));
+    TEST_ASSERT_EQUAL(1, broker.connects);
+    TEST_ASSERT_EQUAL_STRING("ws-test", broker.clientId.c_str());
+    TEST_ASSERT_EQUAL_HEX8(0x02, broker.connectFlags);   // Clean session, no credentials
+    TEST_ASSERT_EQUAL(TELEMETRY_KEEPALIVE_S, broker.keepAlive);
+    TEST_ASSERT_EQUAL(0, broker.publishes.size());
+    TEST_ASSERT_EQUAL(1, broker.disconnects);
+}
+
+void test_window_drains_backlog_in_batches() {
+    StandInBroker broker;
+    fillQueue(40);
+    TEST_ASSERT_TRUE(session->publishWindow(*queue, broker.link()));
+
+    TEST_ASSERT_EQUAL(3, broker.publishes.size());
+    int next = 0;
+    for (size_t i = 0; i < broker.publishes.size(); i++) {
+        const StandInBroker::Publish& p = broker.publishes[i];
+        TEST_ASSERT_EQUAL_STRING("weather/ws-test/telemetry", p.topic.c_str());
+        TEST_ASSERT_EQUAL(i + 1, p.packetId);
+        TEST_ASSERT_EQUAL(i, p.batch.number);
+        TEST_ASSERT_EQUAL_STRING("ws-test", p.batch.station.c_str());
+        for (const TelemetrySample& s : p.batch.samples) {
+            TEST_ASSERT_EQUAL(next, s.values[0]);
+            TEST_ASSERT_EQUAL(1760000000u + (uint32_t)next, s.epoch);
+            next++;
+        }
+    }
+    TEST_ASSERT_EQUAL(TELEMETRY_BATCH_SAMPLES, broker.publishes[0].batch.samples.size());
+    TEST_ASSERT_EQUAL(40 - 2 * TELEMETRY_BATCH_SAMPLES, broker.publishes[2].batch.samples.size());
+    TEST_ASSERT_EQUAL(40, next);
+    TEST_ASSERT_EQUAL(0, queue->depth());
+    TEST_ASSERT_EQUAL(40, session->samplesSent());
+    TEST_ASSERT_EQUAL(3, session->batchesSent());
+    TEST_ASSERT_EQUAL(1, broker.disconnects);
+    TEST_ASSERT_EQUAL(broker.locks, broker.unlocks);
+}
+
+void test_unacknowledged_batch_stays_queued() {
+    StandInBroker broker;
+    broker.acksLeft = 1;
+    fillQueue(40);
+    TEST_ASSERT_FALSE(session->publishWindow(*queue, broker.link()));
+    TEST_ASSERT_EQUAL(2, broker.publishes.size());
+    TEST_ASSERT_EQUAL(40 - TELEMETRY_BATCH_SAMPLES, queue->depth());
+    TEST_ASSERT_EQUAL(TELEMETRY_BATCH_SAMPLES, session->samplesSent());
+    TEST_ASSERT_EQUAL(1, broker.disconnects);
+
+    // The next window resends the same samples under the same batch number
+    StandInBroker again;
+    TEST_ASSERT_TRUE(session->publishWindow(*queue, again.link()));
+    TEST_ASSERT_EQUAL(2, again.publishes.size());
+    TEST_ASSERT_EQUAL(1, again.publishes[0].batch.number);
+    TEST_ASSERT_EQUAL(TELEMETRY_BATCH_SAMPLES, again.publishes[0].batch.samples[0].values[0]);
+    TEST_ASSERT_TRUE(again.publishes[0].packetId != broker.publishes[1].packetId);
+    TEST_ASSERT_EQUAL(0, queue->depth());
+    TEST_ASSERT_EQUAL(40, session->samplesSent());
+}
+
+void test_puback_for_another_packet_fails_window() {
+    StandInBroker broker;
+    broker.wrongAckId = true;
+    fillQueue(5);
+    TEST_ASSERT_FALSE(session->publishWindow(*queue, broker.link()));
+    TEST_ASSERT_EQUAL(1, broker.publishes.size());
+    TEST_ASSERT_EQUAL(5, queue->depth());
+    TEST_ASSERT_EQUAL(0, session->samplesSent());
+}
+
+void test_refused_connection() {
+    StandInBroker broker;
+    broker.connackCode = 5;   // Not authorised
+    fillQueue(5);
+    TEST_ASSERT_FALSE(session->publishWindow(*queue, broker.link()));
+    TEST_ASSERT_EQUAL(5, session->lastRefusal());
+    TEST_ASSERT_EQUAL(0, broker.publishes.size());
+    TEST_ASSERT_EQUAL(5, queue->depth());
+
+    StandInBroker accepting;
+    TEST_ASSERT_TRUE(session->publishWindow(*queue, accepting.link()));
+    TEST_ASSERT_EQUAL(0, session->lastRefusal());
+}
+
+void test_credentials_sent_when_set() {
+    StandInBroker broker;
+    session->begin("ws-test", "weather/ws-test/telemetry", "user", "secret");
+    TEST_ASSERT_TRUE(session->publishWindow(*queue, broker.link()));
+    TEST_ASSERT_EQUAL_HEX8(0xC2, broker.connectFlags);
+}
+
+// The loop task keeps recording while a batch waits for its PUBACK
+static void recordDuringPublish(StandInBroker& broker) {
+    for (int i = 0; i < 20; i++) {
+        broker.queue->push(makeSample(TELEMETRY_OBSERVATION, TELEMETRY_PRIORITY_HIGH, 0, 1000 + i));
+    }
+}
+
+void test_samples_recorded_during_window() {
+    StandInBroker broker;
+    broker.queue = queue;
+    broker.onPublish = recordDuringPublish;
+    broker.acksLeft = 1;
+    // A full queue of lows, so the new observations evict unsent samples mid-window
+    for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+        queue->push(makeSample(TELEMETRY_HEALTH, TELEMETRY_PRIORITY_LOW, 0, i));
+    }
+    TEST_ASSERT_FALSE(session->publishWindow(*queue, broker.link()));
+    TEST_ASSERT_EQUAL(2, broker.publishes.size());
+
+    // Each publish recorded 20 observations, evicting the 20 oldest lows, in-flight
+    // ones included. The first PUBACK then had nothing left to remove; the second
+    // never came. What remains is the newest lows and every observation.
+    TelemetrySample out[TELEMETRY_QUEUE_SIZE];
+    uint8_t left = peekAll(*queue, out);
+    TEST_ASSERT_EQUAL(TELEMETRY_QUEUE_SIZE, left);
+    TEST_ASSERT_EQUAL(40, queue->dropped(TELEMETRY_PRIORITY_LOW));
+    TEST_ASSERT_EQUAL(40, out[0].values[0]);   // Lows 0-39 evicted
+    int observations = 0;
+    for (uint8_t i = 0; i < left; i++) {
+        if (out[i].kind == TELEMETRY_OBSERVATION) observations++;
+    }
+    TEST_ASSERT_EQUAL(40, observations);
+    TEST_ASSERT_EQUAL(TELEMETRY_BATCH_SAMPLES, session->samplesSent());
+    TEST_ASSERT_EQUAL(20, broker.publishes[1].batch.samples[0].values[0]);   // After the first 20 evicted
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_orders_and_numbers_samples);
+    RUN_TEST(test_full_queue_evicts_oldest_of_lowest_priority);
+    RUN_TEST(test_new_sample_dropped_when_everything_outranks_it);
+    RUN_TEST(test_pop_through_after_evictions);
+    RUN_TEST(test_batch_encoding_exact_bytes);
+    RUN_TEST(test_batch_integer_boundaries);
+    RUN_TEST(test_batch_size_limits);
+    RUN_TEST(test_window_with_empty_queue);
+    RUN_TEST(test_window_drains_backlog_in_batches);
+    RUN_TEST(test_unacknowledged_batch_stays_queued);
+    RUN_TEST(test_puback_for_another_packet_fails_window);
+    RUN_TEST(test_refused_connection);
+    RUN_TEST(test_credentials_sent_when_set);
+    RUN_TEST(test_samples_recorded_during_window);
+    return UNITY_END();
+}
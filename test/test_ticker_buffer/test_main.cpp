@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "ticker_buffer.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_starts_empty() {
+    TickerBuffer t;
+    TEST_ASSERT_EQUAL_STRING("", t.front());
+    TEST_ASSERT_EQUAL_UINT16(0, t.frontLength());
+    TEST_ASSERT_EQUAL_INT16(TICKER_WIDTH_UNKNOWN, t.frontWidth());
+    TEST_ASSERT_FALSE(t.pending());
+    TEST_ASSERT_FALSE(t.swap());
+}
+
+void test_commit_visible_only_after_swap() {
+    TickerBuffer t;
+    t.set("first");
+    TEST_ASSERT_TRUE(t.pending());
+    TEST_ASSERT_EQUAL_STRING("", t.front());   // Renderer keeps the old message until its wrap point
+    TEST_ASSERT_TRUE(t.swap());
+    TEST_ASSERT_EQUAL_STRING("first", t.front());
+    TEST_ASSERT_EQUAL_UINT16(5, t.frontLength());
+    TEST_ASSERT_FALSE(t.pending());
+    TEST_ASSERT_FALSE(t.swap());                 // Nothing new: stays put
+    TEST_ASSERT_EQUAL_STRING("first", t.front());
+}
+
+void test_slots_alternate() {
+    TickerBuffer t;
+    t.set("A");
+    t.swap();
+    const char* slotA = t.front();
+    t.set("B");
+    t.swap();
+    const char* slotB = t.front();
+    TEST_ASSERT_TRUE(slotA != slotB);
+    // The third message reuses A's slot, never the front one
+    char* back = t.beginWrite();
+    TEST_ASSERT_EQUAL_PTR(slotA, back);
+    strcpy(back, "C");
+    t.commit(1);
+    TEST_ASSERT_EQUAL_STRING("B", t.front());
+    t.swap();
+    TEST_ASSERT_EQUAL_PTR(slotA, t.front());
+    TEST_ASSERT_EQUAL_STRING("C", t.front());
+}
+
+void test_begin_write_withdraws_pending_commit() {
+    TickerBuffer t;
+    t.set("ready");
+    char* back = t.beginWrite();
+    TEST_ASSERT_FALSE(t.pending());
+    TEST_ASSERT_FALSE(t.swap());      // Half-written slot is never shown
+    strcpy(back, "rewritten");
+    t.commit(9);
+    TEST_ASSERT_TRUE(t.swap());
+    TEST_ASSERT_EQUAL_STRING("rewritten", t.front());
+}
+
+void test_latest_commit_wins() {
+    TickerBuffer t;
+    t.set("old");
+    t.set("newer");
+    TEST_ASSERT_TRUE(t.swap());
+    TEST_ASSERT_EQUAL_STRING("newer", t.front());
+}
+
+void test_length_clamped_and_width_carried() {
+    TickerBuffer t;
+    char longText[TICKER_MESSAGE_SIZE + 20];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    t.set(longText);
+    t.swap();
+    TEST_ASSERT_EQUAL_UINT16(TICKER_MESSAGE_SIZE - 1, t.frontLength());
+    TEST_ASSERT_EQUAL(TICKER_MESSAGE_SIZE - 1, strlen(t.front()));
+
+    char* back = t.beginWrite();
+    strcpy(back, "measured");
+    t.commit(8, 123);
+    t.swap();
+    TEST_ASSERT_EQUAL_INT16(123, t.frontWidth());
+    t.setFrontWidth(99);
+    TEST_ASSERT_EQUAL_INT16(99, t.frontWidth());
+}
+
+void test_concurrent_producer_consumer() {
+    // Producer on one thread, renderer on another: every message seen is whole
+    // and they arrive in order
+    static TickerBuffer t;
+    std::atomic<bool> done(false);
+    const int MESSAGES = 20000;
+
+    std::thread producer([&]() {
+        for (int n = 1; n <= MESSAGES; n++) {
+            char* out = t.beginWrite();
+            int len = 0;
+            for (int r = 0; r < 8; r++) {
+                len += snprintf(out + len, t.capacity() - len, "%06d|", n);
+            }
+            t.commit(len);
+        }
+        done.store(true);
+    });
+
+    int last = 0, swaps = 0;
+    bool torn = false, backwards = false;
+    while (!done.load() || t.pending()) {
+        if (!t.swap()) continue;
+        swaps++;
+        const char* text = t.front();
+        int n = atoi(text);
+        for (int r = 1; r < 8; r++) {
+            if (atoi(text + r * 7) != n) torn = true;
+        }
+        if (n < last) backwards = true;
+        last = n;
+    }
+    producer.join();
+    TEST_ASSERT_FALSE(torn);
+    TEST_ASSERT_FALSE(backwards);
+    TEST_ASSERT_EQUAL(MESSAGES, last);
+    TEST_ASSERT_GREATER_THAN(0, swaps);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_empty);
+    RUN_TEST(test_commit_visible_only_after_swap);
+    RUN_TEST(test_slots_alternate);
+    RUN_TEST(test_begin_write_withdraws_pending_commit);
+    RUN_TEST(test_latest_commit_wins);
+    RUN_TEST(test_length_clamped_and_width_carried);
+    RUN_TEST(test_concurrent_producer_consumer);
+    return UNITY_END();
+}
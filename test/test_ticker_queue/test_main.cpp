@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <string.h>
+#include "ticker_queue.h"
+
+static TickerQueue* q;
+
+void setUp() { q = new TickerQueue(); }
+void tearDown() { delete q; }
+
+// Pick, then count it as shown - one ticker wrap
+static const char* showNext(uint32_t nowMs) {
+    const TickerMessage* m = q->pick(nowMs);
+    if (m == nullptr) return nullptr;
+    q->markShown(m->id);
+    return m->text;
+}
+
+void test_empty_queue_picks_nothing() {
+    TEST_ASSERT_NULL(q->pick(0));
+    TEST_ASSERT_EQUAL(0, q->count());
+}
+
+void test_higher_priority_preempts() {
+    q->post(TICKER_SOURCE_CONDITIONS, TICKER_PRIORITY_INFO, "sunny", 0, 0, 0);
+    q->post(TICKER_SOURCE_STATUS, TICKER_PRIORITY_STATUS, "offline", 0, 0, 0);
+    TEST_ASSERT_EQUAL_STRING("offline", showNext(10));
+    TEST_ASSERT_EQUAL_STRING("offline", showNext(20));   // Never yields to a lower level
+    q->post(TICKER_SOURCE_ALERT_WIND, TICKER_PRIORITY_ALERT, "gale", 0, 0, 30);
+    TEST_ASSERT_EQUAL_STRING("gale", showNext(40));
+    q->clear(TICKER_SOURCE_ALERT_WIND);
+    q->clear(TICKER_SOURCE_STATUS);
+    TEST_ASSERT_EQUAL_STRING("sunny", showNext(50));
+}
+
+void test_same_level_rotates_least_recently_shown() {
+    q->post(TICKER_SOURCE_CONDITIONS, TICKER_PRIORITY_INFO, "a", 0, 0, 0);
+    q->post(TICKER_SOURCE_FORECAST, TICKER_PRIORITY_INFO, "b", 0, 0, 0);
+    q->post(TICKER_SOURCE_STATS, TICKER_PRIORITY_INFO, "c", 0, 0, 0);
+    char seen[7] = {0};
+    for (int i = 0; i < 6; i++) {
+        seen[i] = showNext(i)[0];
+    }
+    TEST_ASSERT_EQUAL_STRING("abcabc", seen);
+}
+
+void test_repost_replaces_and_jumps_the_rotation() {
+    q->post(TICKER_SOURCE_CONDITIONS, TICKER_PRIORITY_INFO, "a", 0, 0, 0);
+    q->post(TICKER_SOURCE_FORECAST, TICKER_PRIORITY_INFO, "b", 0, 0, 0);
+    TEST_ASSERT_EQUAL_STRING("a", showNext(1));
+    TEST_ASSERT_EQUAL_STRING("b", showNext(2));
+    uint32_t before = q->generation();
+    uint16_t id = q->post(TICKER_SOURCE_FORECAST, TICKER_PRIORITY_INFO, "b2", 0, 0, 3);
+    TEST_ASSERT_NOT_EQUAL(0, id);
+    TEST_ASSERT_NOT_EQUAL(before, q->generation());
+    TEST_ASSERT_EQUAL(2, q->count());                     // Replaced, not added
+    TEST_ASSERT_EQUAL_STRING("b2", showNext(4));          // Fresh content shows first
+    TEST_ASSERT_EQUAL_STRING("a", showNext(5));
+}
+
+void test_expiry_waits_for_min_repeats() {
+    q->post(TICKER_SOURCE_CONDITIONS, TICKER_PRIORITY_INFO, "base", 0, 0, 0);
+    q->post(TICKER_SOURCE_ALERT_WEATHER, TICKER_PRIORITY_ALERT, "storm", 1000, 2, 0);
+    // Past its TTL but shown fewer than twice: still kept
+    TEST_ASSERT_EQUAL_STRING("storm", showNext(5000));
+    TEST_ASSERT_EQUAL_STRING("storm", showNext(6000));
+    TEST_ASSERT_EQUAL_STRING("base", showNext(7000));
+    TEST_ASSERT_EQUAL(1, q->count());
+}
+
+void test_expiry_after_ttl() {
+    q->post(TICKER_SOURCE_STATUS, TICKER_PRIORITY_STATUS, "joining", 1000, 0, 100);
+    TEST_ASSERT_NOT_NULL(q->pick(1099));
+    TEST_ASSERT_NULL(q->pick(1100));     // TTL is inclusive of its end
+    TEST_ASSERT_EQUAL(0, q->count());
+}
+
+void test_expiry_across_millis_wrap() {
+    uint32_t posted = 0xFFFFFF00u;
+    q->post(TICKER_SOURCE_STATUS, TICKER_PRIORITY_STATUS, "wrap", 0x200, 0, posted);
+    TEST_ASSERT_NOT_NULL(q->pick(posted + 0x1FF));
+    TEST_ASSERT_NULL(q->pick(posted + 0x200));
+}
+
+void test_zero_ttl_persists() {
+    q->post(TICKER_SOURCE_CONDITIONS, TICKER_PRIORITY_INFO, "forever", 0, 0, 0);
+    for (int i = 0; i < 10; i++) showNext(i * 100000u);
+    TEST_ASSERT_NOT_NULL(q->pick(0xF0000000u));
+}
+
+void test_full_queue_evicts_lowest_then_oldest() {
+    // Sources past the named ones fill every slot
+    for (uint8_t s = 0; s < TICKER_QUEUE_SIZE; s++) {
+        uint8_t prio = (s == 2) ? TICKER_PRIORITY_ALERT : TICKER_PRIORITY_INFO;
+        TEST_ASSERT_NOT_EQUAL(0, q->post(10 + s, prio, "x", 0, 0, 100 + s));
+    }
+    // A status message displaces the oldest info entry (source 10)
+    TEST_ASSERT_NOT_EQUAL(0, q->post(50, TICKER_PRIORITY_STATUS, "s", 0, 0, 200));
+    TEST_ASSERT_EQUAL(TICKER_QUEUE_SIZE, q->count());
+    q->clear(10);
+    TEST_ASSERT_EQUAL(TICKER_QUEUE_SIZE, q->count());     // 10 was already gone
+    q->clear(11);
+    TEST_ASSERT_EQUAL(TICKER_QUEUE_SIZE - 1, q->count());
+}
+
+void test_full_queue_rejects_lower_priority() {
+    for (uint8_t s = 0; s < TICKER_QUEUE_SIZE; s++) {
+        q->post(10 + s, TICKER_PRIORITY_STATUS, "x", 0, 0, s);
+    }
+    uint32_t before = q->generation();
+    TEST_ASSERT_EQUAL(0, q->post(50, TICKER_PRIORITY_INFO, "i", 0, 0, 10));
+    TEST_ASSERT_NULL(q->reserve(50, TICKER_PRIORITY_INFO, 0, 0, 10));
+    TEST_ASSERT_EQUAL(before, q->generation());
+    // Equal priority still displaces the oldest
+    TEST_ASSERT_NOT_EQUAL(0, q->post(50, TICKER_PRIORITY_STATUS, "s", 0, 0, 10));
+}
+
+void test_text_truncated_and_reserved_in_place() {
+    char longText[TICKER_QUEUE_TEXT_SIZE + 40];
+    memset(longText, 'y', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    q->post(TICKER_SOURCE_STATS, TICKER_PRIORITY_INFO, longText, 0, 0, 0);
+    TEST_ASSERT_EQUAL(TICKER_QUEUE_TEXT_SIZE - 1, strlen(q->pick(0)->text));
+
+    char* out = q->reserve(TICKER_SOURCE_STATS, TICKER_PRIORITY_INFO, 0, 0, 1);
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_EQUAL_STRING("", out);                    // Reserved text starts empty
+    strcpy(out, "filled");
+    TEST_ASSERT_EQUAL_STRING("filled", q->pick(1)->text);
+}
+
+void test_ids_are_unique_and_skip_zero() {
+    uint16_t last = 0;
+    for (int i = 0; i < 70000; i++) {
+        uint16_t id = q->post(TICKER_SOURCE_STATS, TICKER_PRIORITY_INFO, "n", 0, 0, i);
+        TEST_ASSERT_NOT_EQUAL(0, id);
+        TEST_ASSERT_NOT_EQUAL(last, id);
+        last = id;
+    }
+    // A stale id no longer marks anything
+    const TickerMessage* m = q->pick(0);
+    uint16_t shownBefore = m->shown;
+    q->markShown((uint16_t)(m->id - 1 ? m->id - 1 : 0xFFFF));
+    TEST_ASSERT_EQUAL(shownBefore, m->shown);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_queue_picks_nothing);
+    RUN_TEST(test_higher_priority_preempts);
+    RUN_TEST(test_same_level_rotates_least_recently_shown);
+    RUN_TEST(test_repost_replaces_and_jumps_the_rotation);
+    RUN_TEST(test_expiry_waits_for_min_repeats);
+    RUN_TEST(test_expiry_after_ttl);
+    RUN_TEST(test_expiry_across_millis_wrap);
+    RUN_TEST(test_zero_ttl_persists);
+    RUN_TEST(test_full_queue_evicts_lowest_then_oldest);
+    RUN_TEST(test_full_queue_rejects_lower_priority);
+    RUN_TEST(test_text_truncated_and_reserved_in_place);
+    RUN_TEST(test_ids_are_unique_and_skip_zero);
+    return UNITY_END();
+}
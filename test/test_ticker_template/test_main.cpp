@@ -0,0 +1,208 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "ticker_template.h"
+#include "weather_format.h"
+
+static TickerTemplate tpl;
+static WeatherData data;
+static char out[TICKER_QUEUE_TEXT_SIZE];
+static const TickerTextFields TEXT = {"12:34:56", "06:01", "20:15", "°C", "km/h", "km"};
+
+static const char* render(const char* source) {
+    if (!tpl.compile(source)) {
+        return nullptr;
+    }
+    tpl.render(data, TEXT, out, sizeof(out));
+    return out;
+}
+
+// compile() must fail with this message at this offset and leave nothing behind
+static void expectError(const char* source, const char* message, int offset) {
+    TEST_ASSERT_FALSE(tpl.compile(source));
+    TEST_ASSERT_EQUAL_STRING(message, tpl.error());
+    TEST_ASSERT_EQUAL_INT(offset, tpl.errorOffset());
+    TEST_ASSERT_EQUAL_INT(0, tpl.opCount());
+    TEST_ASSERT_EQUAL(0, tpl.render(data, TEXT, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void setUp() {
+    data = WeatherData();
+}
+void tearDown() {}
+
+void test_literals_and_escapes() {
+    TEST_ASSERT_EQUAL_STRING("plain text", render("plain text"));
+    TEST_ASSERT_EQUAL_INT(1, tpl.opCount());
+    TEST_ASSERT_EQUAL_STRING("{temp} }", render("{{temp}} }}"));
+    TEST_ASSERT_EQUAL_INT(1, tpl.opCount());   // Escapes fold into one literal run
+    TEST_ASSERT_EQUAL_STRING("", render(""));
+    TEST_ASSERT_EQUAL_INT(0, tpl.opCount());
+    TEST_ASSERT_NULL(tpl.error());
+}
+
+void test_every_field() {
+    data.temperature = 225;
+    data.feelsLike = -31;
+    data.minTemp = -500;
+    data.maxTemp = 3049;
+    data.humidity = 77;
+    data.pressure = 1014;
+    data.windSpeed = 46;
+    data.visibility = 100;
+    data.cloudCoverage = 75;
+    data.conditionId = 803;
+    TEST_ASSERT_EQUAL_STRING("broken clouds 22.5 -3.1 -50.0 304.9 77 1014 4.6 10.0 75",
+                             render("{desc} {temp} {feels} {min} {max} {humidity} {pressure} {wind} {vis} {clouds}"));
+    TEST_ASSERT_EQUAL_STRING("12:34:56 06:01 20:15 °C km/h km",
+                             render("{updated} {sunrise} {sunset} {temp_unit} {wind_unit} {vis_unit}"));
+}
+
+void test_precision() {
+    data.temperature = 225;
+    TEST_ASSERT_EQUAL_STRING("23", render("{temp:0}"));
+    TEST_ASSERT_EQUAL_STRING("22.5", render("{temp:1}"));
+    TEST_ASSERT_EQUAL_STRING("22.500", render("{temp:3}"));
+    data.temperature = -225;
+    TEST_ASSERT_EQUAL_STRING("-23", render("{temp:0}"));   // Half away from zero
+    data.humidity = 5;
+    TEST_ASSERT_EQUAL_STRING("5.00%", render("{humidity:2}%"));
+}
+
+void test_default_template_matches_old_format() {
+    data.visibility = 100;
+    data.windSpeed = 46;
+    data.conditionId = 500;
+    TickerTextFields text = TEXT;
+    text.visUnit = "km";
+    TEST_ASSERT_EQUAL_STRING("... light rain, visibility is 10.0km, wind of 4.6km/h, last updated at 12:34:56 ...",
+                             (tpl.compile(TICKER_DEFAULT_TEMPLATE), tpl.render(data, text, out, sizeof(out)), out));
+}
+
+void test_bad_placeholders() {
+    expectError("x {bogus} y", "unknown field", 3);
+    expectError("{}", "unknown field", 1);
+    expectError("{Temp}", "unknown field", 1);
+    expectError("{temp", "unterminated field", 0);
+    expectError("ab {temp:1", "precision must be one digit 0-3", 8);
+    expectError("a } b", "unmatched '}'", 2);
+    expectError("{desc:1}", "text field takes no precision", 5);
+    expectError("{temp:4}", "precision must be one digit 0-3", 5);
+    expectError("{temp:12}", "precision must be one digit 0-3", 5);
+    expectError("{temp:}", "precision must be one digit 0-3", 5);
+    expectError("{temp:-1}", "precision must be one digit 0-3", 5);
+    // A good compile afterwards clears the error
+    TEST_ASSERT_TRUE(tpl.compile("{temp}"));
+    TEST_ASSERT_NULL(tpl.error());
+    TEST_ASSERT_EQUAL_INT(-1, tpl.errorOffset());
+}
+
+void test_template_limits() {
+    char source[TICKER_TEMPLATE_SIZE + 2];
+    memset(source, 'a', TICKER_TEMPLATE_SIZE);
+    source[TICKER_TEMPLATE_SIZE] = '\0';
+    TEST_ASSERT_TRUE(tpl.compile(source));     // Exactly fills the pool
+    source[TICKER_TEMPLATE_SIZE] = 'a';
+    source[TICKER_TEMPLATE_SIZE + 1] = '\0';
+    TEST_ASSERT_FALSE(tpl.compile(source));
+    TEST_ASSERT_EQUAL_STRING("template too long", tpl.error());
+
+    // Literal/field pairs until the op table runs out
+    char many[TICKER_TEMPLATE_MAX_OPS * 8 + 1] = "";
+    for (int i = 0; i < TICKER_TEMPLATE_MAX_OPS / 2; i++) {
+        strcat(many, "-{temp}");
+    }
+    TEST_ASSERT_TRUE(tpl.compile(many));
+    TEST_ASSERT_EQUAL_INT(TICKER_TEMPLATE_MAX_OPS, tpl.opCount());
+    strcat(many, "-");
+    TEST_ASSERT_FALSE(tpl.compile(many));
+    TEST_ASSERT_EQUAL_STRING("too many template parts", tpl.error());
+    many[strlen(many) - 1] = '\0';
+    strcat(many, "{temp}");
+    TEST_ASSERT_FALSE(tpl.compile(many));
+    TEST_ASSERT_EQUAL_STRING("too many template parts", tpl.error());
+}
+
+void test_output_truncates_at_queue_text_size() {
+    // Long text fields push the message past the queue entry size
+    char longTime[200];
+    memset(longTime, 't', sizeof(longTime) - 1);
+    longTime[sizeof(longTime) - 1] = '\0';
+    TickerTextFields text = TEXT;
+    text.updated = longTime;
+    TEST_ASSERT_TRUE(tpl.compile("{desc} {temp} {updated} {wind}"));
+    char full[512];
+    size_t fullLen = tpl.render(data, text, full, sizeof(full));
+    TEST_ASSERT_GREATER_THAN(TICKER_QUEUE_TEXT_SIZE, fullLen);
+
+    size_t len = tpl.render(data, text, out, sizeof(out));
+    TEST_ASSERT_EQUAL(TICKER_QUEUE_TEXT_SIZE - 1, len);
+    TEST_ASSERT_EQUAL(len, strlen(out));
+
+    // Every smaller buffer gets a terminated prefix of the full text
+    for (size_t size = 1; size <= sizeof(out); size++) {
+        char small[TICKER_QUEUE_TEXT_SIZE + 8];
+        memset(small, 0x55, sizeof(small));
+        len = tpl.render(data, text, small, size);
+        TEST_ASSERT_EQUAL(size - 1, len);
+        TEST_ASSERT_EQUAL('\0', small[len]);
+        TEST_ASSERT_EQUAL_MEMORY(full, small, len);
+        TEST_ASSERT_EQUAL(0x55, (uint8_t)small[size]);   // Nothing written past the end
+    }
+    TEST_ASSERT_EQUAL(0, tpl.render(data, text, out, 0));
+}
+
+// The conditions line as it was built before templates
+static size_t oldConditionsMessage(const WeatherData& d, const char* updated, char* dst, size_t dstSize) {
+    char vis[8], wind[8];
+    formatFixed(vis, sizeof(vis), d.visibility, VISIBILITY_SCALE, 1);
+    formatFixed(wind, sizeof(wind), d.windSpeed, WIND_SCALE, 1);
+    int n = snprintf(dst, dstSize, "... %s, visibility is %skm, wind of %skm/h, last updated at %s ...",
+                     conditionDescription(d.conditionId), vis, wind, updated);
+    return n < 0 ? 0 : ((size_t)n >= dstSize ? dstSize - 1 : (size_t)n);
+}
+
+void test_bench_render_vs_snprintf() {
+    const int ROUNDS = 20000;
+    TickerTextFields text = TEXT;
+    text.visUnit = "km";
+    TEST_ASSERT_TRUE(tpl.compile(TICKER_DEFAULT_TEMPLATE));
+    char expected[TICKER_QUEUE_TEXT_SIZE];
+    oldConditionsMessage(data, TEXT.updated, expected, sizeof(expected));
+    tpl.render(data, text, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING(expected, out);
+
+    volatile size_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUNDS; i++) {
+        data.windSpeed = (int16_t)i;
+        sink += oldConditionsMessage(data, TEXT.updated, expected, sizeof(expected));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUNDS; i++) {
+        data.windSpeed = (int16_t)i;
+        sink += tpl.render(data, text, out, sizeof(out));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double oldNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / ROUNDS;
+    double newNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / ROUNDS;
+    char line[96];
+    snprintf(line, sizeof(line), "snprintf %.0f ns, template %.0f ns per message", oldNs, newNs);
+    TEST_MESSAGE(line);
+    (void)sink;
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_literals_and_escapes);
+    RUN_TEST(test_every_field);
+    RUN_TEST(test_precision);
+    RUN_TEST(test_default_template_matches_old_format);
+    RUN_TEST(test_bad_placeholders);
+    RUN_TEST(test_template_limits);
+    RUN_TEST(test_output_truncates_at_queue_text_size);
+    RUN_TEST(test_bench_render_vs_snprintf);
+    return UNITY_END();
+}
@@ -0,0 +1,194 @@
+#include <unity.h>
+#include <math.h>
+#include "tween.h"
+#include "display_regions.h"
+
+static Animator* animator;
+
+void setUp() { animator = new Animator(); }
+void tearDown() { delete animator; }
+
+static double floatCurve(uint8_t curve, double t) {
+    switch (curve) {
+        case EASE_OUT_CUBIC: return 1.0 - pow(1.0 - t, 3);
+        case EASE_IN_OUT_QUAD: return t < 0.5 ? 2 * t * t : 1.0 - 2 * (1.0 - t) * (1.0 - t);
+        default: return t;
+    }
+}
+
+void test_ease_endpoints() {
+    for (uint8_t c = 0; c < EASE_CURVE_COUNT; c++) {
+        TEST_ASSERT_EQUAL_INT32(0, ease(c, 0));
+        TEST_ASSERT_EQUAL_INT32(EASE_ONE, ease(c, EASE_ONE));
+        TEST_ASSERT_EQUAL_INT32(0, ease(c, -5));
+        TEST_ASSERT_EQUAL_INT32(EASE_ONE, ease(c, EASE_ONE + 5));
+    }
+    TEST_ASSERT_EQUAL_INT32(1234, ease(EASE_CURVE_COUNT, 1234));   // Unknown curve is linear
+}
+
+void test_ease_monotonic_and_close_to_float() {
+    for (uint8_t c = 0; c < EASE_CURVE_COUNT; c++) {
+        int32_t last = 0;
+        double worst = 0;
+        for (int32_t t = 0; t <= EASE_ONE; t++) {
+            int32_t e = ease(c, t);
+            TEST_ASSERT_GREATER_OR_EQUAL(last, e);
+            last = e;
+            double err = fabs(e / (double)EASE_ONE - floatCurve(c, t / (double)EASE_ONE));
+            if (err > worst) worst = err;
+        }
+        TEST_ASSERT_TRUE(worst < 2.0 / EASE_ONE);
+    }
+}
+
+void test_in_out_quad_is_symmetric() {
+    for (int32_t t = 0; t <= EASE_ONE; t++) {
+        TEST_ASSERT_EQUAL_INT32(EASE_ONE, ease(EASE_IN_OUT_QUAD, t) + ease(EASE_IN_OUT_QUAD, EASE_ONE - t));
+    }
+}
+
+void test_tween_runs_to_exact_target() {
+    TEST_ASSERT_TRUE(animator->start(0, 100, -250, 1000, 500, EASE_OUT_CUBIC, REGION_BIT(REGION_TEMP)));
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_TEMP), animator->tick(1000));   // Start draws the first frame
+    TEST_ASSERT_EQUAL_INT32(100, animator->value(0, -250));
+    int32_t last = 100;
+    for (uint32_t now = 1016; now < 1500; now += 16) {
+        animator->tick(now);
+        int32_t v = animator->value(0, -250);
+        TEST_ASSERT_LESS_OR_EQUAL(last, v);   // Counting down, never overshooting
+        TEST_ASSERT_GREATER_OR_EQUAL(-250, v);
+        last = v;
+    }
+    TEST_ASSERT_TRUE(animator->active(0));
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_TEMP), animator->tick(1500));   // Final frame
+    TEST_ASSERT_FALSE(animator->active(0));
+    TEST_ASSERT_EQUAL_INT32(-250, animator->value(0, -250));
+    TEST_ASSERT_EQUAL_INT32(7, animator->value(0, 7));    // Idle reports the caller's value
+    TEST_ASSERT_EQUAL_HEX32(0, animator->tick(1516));
+}
+
+void test_invalidates_only_when_value_moves() {
+    // 3 units over 300 ms: most frames leave the value alone
+    animator->start(1, 0, 3, 0, 300, EASE_LINEAR, REGION_BIT(REGION_BOX2));
+    animator->tick(0);
+    int redraws = 0;
+    for (uint32_t now = 1; now < 300; now++) {
+        if (animator->tick(now) != 0) redraws++;
+    }
+    TEST_ASSERT_EQUAL(2, redraws);   // 0 -> 1 -> 2; the move to 3 is the final frame
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_BOX2), animator->tick(300));
+
+    // A tween that does not move still draws its start and end
+    animator->start(2, 5, 5, 1000, 100, EASE_LINEAR, REGION_BIT(REGION_CLOCK));
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_CLOCK), animator->tick(1000));
+    TEST_ASSERT_EQUAL_HEX32(0, animator->tick(1050));
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_CLOCK), animator->tick(1100));
+}
+
+void test_masks_combine_across_channels() {
+    animator->start(0, 0, 1000, 0, 100, EASE_LINEAR, REGION_BIT(REGION_TEMP));
+    animator->start(3, 0, 1000, 0, 200, EASE_LINEAR, REGION_BIT(REGION_BOX0) | REGION_BIT(REGION_BOX1));
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_TEMP) | REGION_BIT(REGION_BOX0) | REGION_BIT(REGION_BOX1),
+                            animator->tick(50));
+    TEST_ASSERT_EQUAL(2, animator->activeCount());
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_TEMP) | REGION_BIT(REGION_BOX0) | REGION_BIT(REGION_BOX1),
+                            animator->tick(100));
+    TEST_ASSERT_EQUAL(1, animator->activeCount());
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_BOX0) | REGION_BIT(REGION_BOX1), animator->tick(150));
+}
+
+void test_cancel_restart_and_bad_channel() {
+    TEST_ASSERT_FALSE(animator->start(TWEEN_MAX_CHANNELS, 0, 1, 0, 10, EASE_LINEAR, 1));
+    TEST_ASSERT_FALSE(animator->active(TWEEN_MAX_CHANNELS));
+    TEST_ASSERT_EQUAL_INT32(9, animator->value(TWEEN_MAX_CHANNELS, 9));
+
+    animator->start(4, 0, 100, 0, 100, EASE_LINEAR, REGION_BIT(REGION_SUN));
+    animator->tick(0);
+    animator->cancel(4);
+    TEST_ASSERT_FALSE(animator->active(4));
+    TEST_ASSERT_EQUAL_HEX32(REGION_BIT(REGION_SUN), animator->tick(10));   // Redraw at the resting value
+    animator->cancel(4);
+    TEST_ASSERT_EQUAL_HEX32(0, animator->tick(20));
+
+    // Restart replaces the running tween from its new origin
+    animator->start(4, 0, 100, 0, 100, EASE_LINEAR, REGION_BIT(REGION_SUN));
+    animator->tick(50);
+    animator->start(4, 200, 300, 50, 100, EASE_LINEAR, REGION_BIT(REGION_SUN));
+    animator->tick(100);
+    TEST_ASSERT_EQUAL_INT32(250, animator->value(4, 0));
+}
+
+void test_zero_duration_and_millis_wrap() {
+    animator->start(5, 0, 10, 100, 0, EASE_LINEAR, 1);
+    animator->tick(100);
+    TEST_ASSERT_FALSE(animator->active(5));
+    TEST_ASSERT_EQUAL_INT32(10, animator->value(5, 10));
+
+    uint32_t start = 0xFFFFFF00u;
+    animator->start(6, 0, 512, start, 512, EASE_LINEAR, 1);
+    animator->tick(start + 256);   // Past the wrap
+    TEST_ASSERT_EQUAL_INT32(256, animator->value(6, 0));
+    animator->tick(start + 512);
+    TEST_ASSERT_FALSE(animator->active(6));
+}
+
+static uint32_t maskPixels(uint32_t mask) {
+    uint32_t pixels = 0;
+    for (int r = 0; r < REGION_COUNT; r++) {
+        if (mask & REGION_BIT(r)) pixels += (uint32_t)DISPLAY_REGIONS[r].w * DISPLAY_REGIONS[r].h;
+    }
+    return pixels;
+}
+
+void test_regions_disjoint_and_on_screen() {
+    for (int a = 0; a < REGION_COUNT; a++) {
+        const RegionRect& r = DISPLAY_REGIONS[a];
+        TEST_ASSERT_TRUE(r.x >= 0 && r.y >= 0 && r.w > 0 && r.h > 0);
+        TEST_ASSERT_LESS_OR_EQUAL(SPRITE_WIDTH, r.x + r.w);
+        TEST_ASSERT_LESS_OR_EQUAL(SPRITE_HEIGHT, r.y + r.h);
+        for (int b = a + 1; b < REGION_COUNT; b++) {
+            const RegionRect& s = DISPLAY_REGIONS[b];
+            bool overlap = r.x < s.x + s.w && s.x < r.x + r.w && r.y < s.y + s.h && s.y < r.y + r.h;
+            TEST_ASSERT_FALSE_MESSAGE(overlap, "regions overlap");
+        }
+    }
+}
+
+void test_frame_cost_ceiling() {
+    const uint32_t full = (uint32_t)SPRITE_WIDTH * SPRITE_HEIGHT;
+    // Steady state: the ticker scrolls every frame, the clock once a second
+    TEST_ASSERT_LESS_THAN(full / 6, maskPixels(REGION_BIT(REGION_TICKER)));
+    TEST_ASSERT_LESS_THAN(full / 4, maskPixels(REGION_BIT(REGION_TICKER) | REGION_BIT(REGION_CLOCK)));
+    // After a fetch every value tweens at once; still cheaper than the old full push
+    TEST_ASSERT_LESS_THAN(full, maskPixels(REGION_ALL_BITS));
+
+    // A full fetch animation's per-frame masks never exceed the all-regions cost
+    animator->start(0, 0, 300, 0, TWEEN_VALUE_MS, EASE_OUT_CUBIC, REGION_BIT(REGION_TEMP));
+    for (int b = 0; b < 6; b++) {
+        animator->start(1 + b, 0, 1000, 0, TWEEN_VALUE_MS, EASE_OUT_CUBIC, REGION_BIT(REGION_BOX0 + b));
+    }
+    animator->start(7, 0, 255, 0, TWEEN_ICON_MS, EASE_IN_OUT_QUAD, REGION_BIT(REGION_SUN));
+    uint32_t worst = 0;
+    for (uint32_t now = 0; now <= TWEEN_VALUE_MS; now += RENDER_INTERVAL_MS) {
+        uint32_t pixels = maskPixels(animator->tick(now) | REGION_BIT(REGION_TICKER));
+        if (pixels > worst) worst = pixels;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(maskPixels(REGION_ALL_BITS & ~REGION_BIT(REGION_CLOCK)), worst);
+    TEST_ASSERT_LESS_THAN(full, worst);
+    TEST_ASSERT_EQUAL(0, animator->activeCount());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ease_endpoints);
+    RUN_TEST(test_ease_monotonic_and_close_to_float);
+    RUN_TEST(test_in_out_quad_is_symmetric);
+    RUN_TEST(test_tween_runs_to_exact_target);
+    RUN_TEST(test_invalidates_only_when_value_moves);
+    RUN_TEST(test_masks_combine_across_channels);
+    RUN_TEST(test_cancel_restart_and_bad_channel);
+    RUN_TEST(test_zero_duration_and_millis_wrap);
+    RUN_TEST(test_regions_disjoint_and_on_screen);
+    RUN_TEST(test_frame_cost_ceiling);
+    return UNITY_END();
+}
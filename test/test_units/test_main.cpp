@@ -0,0 +1,190 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "units.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_metric_profile() {
+    const UnitProfile& p = resolveUnitProfile("metric");
+    TEST_ASSERT_EQUAL_PTR(&MetricUnits::profile, &p);
+    TEST_ASSERT_EQUAL_STRING("C", p.tempSymbol);
+    TEST_ASSERT_EQUAL_STRING("km/h", p.windSuffix);
+    TEST_ASSERT_EQUAL_STRING("km", p.distSuffix);
+    TEST_ASSERT_EQUAL_INT(55, p.tempSymbolY);
+    TEST_ASSERT_EQUAL_INT16(225, p.temperature(22.5f));
+    TEST_ASSERT_EQUAL_INT16(-400, p.temperature(-40.0f));
+    TEST_ASSERT_EQUAL_INT16(360, p.wind(10.0f));         // 36.0 km/h
+    TEST_ASSERT_EQUAL_INT16(166, p.wind(4.6f));          // 16.56 -> 16.6
+    TEST_ASSERT_EQUAL_INT16(100, p.visibility(10000));   // 10.0 km
+    TEST_ASSERT_EQUAL_INT16(5, p.visibility(450));       // 0.45 -> 0.5
+    TEST_ASSERT_EQUAL_INT16(0, p.visibility(0));
+}
+
+void test_imperial_profile() {
+    const UnitProfile& p = resolveUnitProfile("imperial");
+    TEST_ASSERT_EQUAL_PTR(&ImperialUnits::profile, &p);
+    TEST_ASSERT_EQUAL_STRING("F", p.tempSymbol);
+    TEST_ASSERT_EQUAL_STRING("mph", p.windSuffix);
+    TEST_ASSERT_EQUAL_STRING("mi", p.distSuffix);
+    TEST_ASSERT_EQUAL_INT(49, p.tempSymbolY);
+    TEST_ASSERT_EQUAL_INT16(320, p.temperature(0.0f));
+    TEST_ASSERT_EQUAL_INT16(2120, p.temperature(100.0f));
+    TEST_ASSERT_EQUAL_INT16(-400, p.temperature(-40.0f));
+    TEST_ASSERT_EQUAL_INT16(725, p.temperature(22.5f));
+    TEST_ASSERT_EQUAL_INT16(224, p.wind(10.0f));         // 22.37 mph
+    TEST_ASSERT_EQUAL_INT16(62, p.visibility(10000));    // 6.2 mi
+    TEST_ASSERT_EQUAL_INT16(10, p.visibility(1609));
+}
+
+void test_mixed_profile() {
+    const UnitProfile& p = resolveUnitProfile("mixed");
+    TEST_ASSERT_EQUAL_PTR(&MixedUnits::profile, &p);
+    TEST_ASSERT_EQUAL_STRING("C", p.tempSymbol);
+    TEST_ASSERT_EQUAL_STRING("mph", p.windSuffix);
+    TEST_ASSERT_EQUAL_STRING("mi", p.distSuffix);
+    TEST_ASSERT_EQUAL_INT(55, p.tempSymbolY);
+    TEST_ASSERT_EQUAL_INT16(225, p.temperature(22.5f));
+    TEST_ASSERT_EQUAL_INT16(224, p.wind(10.0f));
+    TEST_ASSERT_EQUAL_INT16(62, p.visibility(10000));
+}
+
+void test_conversions_saturate() {
+    TEST_ASSERT_EQUAL_INT16(32767, ImperialUnits::profile.temperature(5000.0f));
+    TEST_ASSERT_EQUAL_INT16(-32768, MetricUnits::profile.temperature(-5000.0f));
+    TEST_ASSERT_EQUAL_INT16(32767, MetricUnits::profile.wind(1000.0f));
+}
+
+void test_profile_lookup_falls_back_to_metric() {
+    TEST_ASSERT_EQUAL_PTR(&MetricUnits::profile, &resolveUnitProfile(""));
+    TEST_ASSERT_EQUAL_PTR(&MetricUnits::profile, &resolveUnitProfile("standard"));
+    TEST_ASSERT_EQUAL_PTR(&MetricUnits::profile, &resolveUnitProfile("Imperial"));
+    TEST_ASSERT_EQUAL_PTR(&MetricUnits::profile, &resolveUnitProfile(nullptr));
+}
+
+void test_api_units() {
+    TEST_ASSERT_EQUAL(API_UNITS_METRIC, resolveApiUnits("metric"));
+    TEST_ASSERT_EQUAL(API_UNITS_IMPERIAL, resolveApiUnits("imperial"));
+    TEST_ASSERT_EQUAL(API_UNITS_STANDARD, resolveApiUnits("standard"));
+    TEST_ASSERT_EQUAL(API_UNITS_STANDARD, resolveApiUnits(""));
+    TEST_ASSERT_EQUAL(API_UNITS_STANDARD, resolveApiUnits("mixed"));   // Not an API unit system
+    TEST_ASSERT_EQUAL(API_UNITS_STANDARD, resolveApiUnits(nullptr));
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0f, apiTemperatureToCelsius(273.15f, API_UNITS_STANDARD));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 21.5f, apiTemperatureToCelsius(21.5f, API_UNITS_METRIC));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0f, apiTemperatureToCelsius(32.0f, API_UNITS_IMPERIAL));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 100.0f, apiTemperatureToCelsius(212.0f, API_UNITS_IMPERIAL));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 4.6f, apiWindToMps(4.6f, API_UNITS_STANDARD));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 4.6f, apiWindToMps(4.6f, API_UNITS_METRIC));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 10.0f, apiWindToMps(22.36936f, API_UNITS_IMPERIAL));
+}
+
+void test_api_to_display_round_trip() {
+    // Every API unit system lands on the same display value
+    const ApiUnits apis[] = {API_UNITS_STANDARD, API_UNITS_METRIC, API_UNITS_IMPERIAL};
+    const float temps[] = {293.15f, 20.0f, 68.0f};
+    const float winds[] = {10.0f, 10.0f, 22.36936f};
+    for (int i = 0; i < 3; i++) {
+        float c = apiTemperatureToCelsius(temps[i], apis[i]);
+        float mps = apiWindToMps(winds[i], apis[i]);
+        TEST_ASSERT_EQUAL_INT16(200, MetricUnits::profile.temperature(c));
+        TEST_ASSERT_EQUAL_INT16(680, ImperialUnits::profile.temperature(c));
+        TEST_ASSERT_EQUAL_INT16(360, MetricUnits::profile.wind(mps));
+        TEST_ASSERT_EQUAL_INT16(224, MixedUnits::profile.wind(mps));
+    }
+}
+
+// ---- Render path must not compare unit names ----
+
+static std::string readSource(const char* name) {
+    // Sources sit two levels up from this file; fall back to the project dir
+    std::string here = __FILE__;
+    size_t slash = here.find_last_of('/');
+    std::string candidates[2] = {
+        (slash == std::string::npos ? std::string(".") : here.substr(0, slash)) + "/../../src/" + name,
+        std::string("src/") + name,
+    };
+    for (const std::string& path : candidates) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (f == nullptr) continue;
+        std::string text;
+        char chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) text.append(chunk, n);
+        fclose(f);
+        return text;
+    }
+    return std::string();
+}
+
+// Body of the function whose definition line contains signature, comments removed
+static std::string functionBody(const std::string& source, const char* signature) {
+    size_t at = source.find(signature);
+    if (at == std::string::npos) return std::string();
+    size_t open = source.find('{', at);
+    int depth = 0;
+    std::string body;
+    for (size_t i = open; i < source.size(); i++) {
+        if (source.compare(i, 2, "//") == 0) {
+            i = source.find('\n', i);
+            if (i == std::string::npos) break;
+        }
+        char c = source[i];
+        body += c;
+        if (c == '{') depth++;
+        if (c == '}' && --depth == 0) break;
+    }
+    return body;
+}
+
+static void assertNoStringCompare(const char* file, const char* signature) {
+    std::string source = readSource(file);
+    TEST_ASSERT_TRUE_MESSAGE(!source.empty(), file);
+    std::string body = functionBody(source, signature);
+    TEST_ASSERT_TRUE_MESSAGE(!body.empty(), signature);
+    const char* calls[] = {"strcmp(", "strncmp(", "strcasecmp(", "strncasecmp(", "resolveUnitProfile(", "resolveApiUnits("};
+    for (const char* call : calls) {
+        TEST_ASSERT_TRUE_MESSAGE(body.find(call) == std::string::npos, signature);
+    }
+}
+
+void test_render_path_has_no_string_compares() {
+    const char* display[] = {
+        "void WeatherDisplay::draw()",
+        "void WeatherDisplay::drawRegion(",
+        "void WeatherDisplay::drawLeftPanel()",
+        "void WeatherDisplay::drawTemperature()",
+        "void WeatherDisplay::drawClock()",
+        "void WeatherDisplay::drawRightPanel()",
+        "void WeatherDisplay::drawSunAndIcon()",
+        "void WeatherDisplay::drawValueBox(",
+        "void WeatherDisplay::drawTickerArea()",
+        "void WeatherDisplay::renderTickerStrip()",
+        "void WeatherDisplay::drawConditionsPage()",
+        "void WeatherDisplay::updateData()",
+        "void WeatherDisplay::prepareTicker(",
+    };
+    for (const char* signature : display) {
+        assertNoStringCompare("weather_display.cpp", signature);
+    }
+    assertNoStringCompare("ticker_template.cpp", "size_t TickerTemplate::render(");
+    assertNoStringCompare("ticker_sources.cpp", "bool formatWeatherAlert(");
+    assertNoStringCompare("ticker_sources.cpp", "bool formatWindAlert(");
+    assertNoStringCompare("ticker_sources.cpp", "size_t formatForecastSummary(");
+    assertNoStringCompare("ticker_sources.cpp", "size_t formatDailyStats(");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_metric_profile);
+    RUN_TEST(test_imperial_profile);
+    RUN_TEST(test_mixed_profile);
+    RUN_TEST(test_conversions_saturate);
+    RUN_TEST(test_profile_lookup_falls_back_to_metric);
+    RUN_TEST(test_api_units);
+    RUN_TEST(test_api_to_display_round_trip);
+    RUN_TEST(test_render_path_has_no_string_compares);
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include "weather_data.h"
+#include "weather_format.h"
+
+static char buf[32];
+
+static const char* fixed(int32_t value, int32_t scale, int decimals) {
+    formatFixed(buf, sizeof(buf), value, scale, decimals);
+    return buf;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_layout_size() {
+    TEST_ASSERT_EQUAL(40, sizeof(WeatherData));
+}
+
+void test_fixed_point_round_trip() {
+    // API float -> stored int16 -> text, at the display precision
+    const float values[] = {22.5f, -3.2f, 0.0f, -0.4f, 0.05f, 99.9f, -40.0f, 1013.25f};
+    for (float v : values) {
+        int16_t stored = toFixed(v, TEMP_SCALE);
+        char expected[16];
+        snprintf(expected, sizeof(expected), "%.1f", (double)((float)stored / TEMP_SCALE));
+        if (strcmp(expected, "-0.0") == 0) strcpy(expected, "0.0");
+        TEST_ASSERT_EQUAL_STRING(expected, fixed(stored, TEMP_SCALE, 1));
+        TEST_ASSERT_FLOAT_WITHIN(0.5f / TEMP_SCALE + 1e-4f, v, (float)stored / TEMP_SCALE);
+    }
+    // Every stored tenth prints back as itself and parses back to the same value
+    for (int32_t v = -32768; v <= 32767; v += 7) {
+        fixed(v, 10, 1);
+        TEST_ASSERT_EQUAL_INT32(v, toFixed(strtof(buf, nullptr), 10));
+    }
+}
+
+void test_fixed_point_rounding_and_saturation() {
+    TEST_ASSERT_EQUAL_STRING("22.5", fixed(225, 10, 1));
+    TEST_ASSERT_EQUAL_STRING("23", fixed(225, 10, 0));    // Half away from zero
+    TEST_ASSERT_EQUAL_STRING("-23", fixed(-225, 10, 0));
+    TEST_ASSERT_EQUAL_STRING("0.5", fixed(5, 10, 1));
+    TEST_ASSERT_EQUAL_STRING("-0.5", fixed(-5, 10, 1));
+    TEST_ASSERT_EQUAL_STRING("1.00", fixed(1, 1, 2));
+    TEST_ASSERT_EQUAL_INT16(32767, toFixed(1e6f, 10));
+    TEST_ASSERT_EQUAL_INT16(-32768, toFixed(-1e6f, 10));
+    TEST_ASSERT_EQUAL_INT16(-3, toFixed(-0.25f, 10));
+
+    char small[4];
+    TEST_ASSERT_EQUAL(3, formatFixed(small, sizeof(small), 12345, 10, 1));   // Truncated, terminated
+    TEST_ASSERT_EQUAL_STRING("123", small);
+}
+
+void test_icon_round_trip() {
+    const char* codes[] = {"01d", "01n", "02d", "02n", "03d", "03n", "04d", "04n", "09d", "09n",
+                           "10d", "10n", "11d", "11n", "13d", "13n", "50d", "50n"};
+    for (const char* code : codes) {
+        uint8_t icon = parseWeatherIcon(code);
+        TEST_ASSERT_NOT_EQUAL(ICON_NONE, WEATHER_ICON_CODE(icon));
+        TEST_ASSERT_EQUAL(code[2] == 'n', WEATHER_ICON_IS_NIGHT(icon));
+        char out[4];
+        weatherIconString(icon, out);
+        TEST_ASSERT_EQUAL_STRING(code, out);
+    }
+    TEST_ASSERT_EQUAL(ICON_NONE, parseWeatherIcon("05d"));
+    TEST_ASSERT_EQUAL(ICON_NONE, parseWeatherIcon("x"));
+    TEST_ASSERT_EQUAL(ICON_NONE, parseWeatherIcon(nullptr));
+    char out[4] = "zz";
+    weatherIconString(ICON_NONE, out);
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void test_condition_descriptions_interned() {
+    TEST_ASSERT_EQUAL_STRING("clear sky", conditionDescription(800));
+    TEST_ASSERT_EQUAL_STRING("broken clouds", conditionDescription(803));
+    TEST_ASSERT_EQUAL_STRING("thunderstorm with light rain", conditionDescription(200));
+    TEST_ASSERT_EQUAL_STRING("tornado", conditionDescription(781));
+    TEST_ASSERT_EQUAL_PTR(conditionDescription(501), conditionDescription(501));
+    // Unknown ids fall back to their group
+    TEST_ASSERT_EQUAL_STRING("rain", conditionDescription(599));
+    TEST_ASSERT_EQUAL_STRING("clouds", conditionDescription(899));
+    TEST_ASSERT_EQUAL_STRING("unknown", conditionDescription(0));
+}
+
+void test_epoch_times_format_at_render() {
+    // 2024-07-04 16:30:15 UTC is 12:30:15 EDT under TIMEZONE_TZ
+    formatLocalTime(1720110615, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("12:30:15", buf);
+    formatLocalTime(1720110615, buf, sizeof(buf), "%H:%M");
+    TEST_ASSERT_EQUAL_STRING("12:30", buf);
+    formatLocalTime(0, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("--:--", buf);
+    // Local noon of that day: 16:00 UTC
+    TEST_ASSERT_EQUAL_UINT32(1720108800, localNoon(1720110615));
+    TEST_ASSERT_EQUAL_INT32(2024 * 1000 + 185, localDayNumber(1720110615));
+}
+
+void test_defaults() {
+    WeatherData d;
+    TEST_ASSERT_EQUAL_STRING("22.2", fixed(d.temperature, TEMP_SCALE, 1));
+    TEST_ASSERT_EQUAL(ICON_CLEAR_SKY, d.icon);
+    TEST_ASSERT_EQUAL_UINT32(0, d.lastUpdated);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_layout_size);
+    RUN_TEST(test_fixed_point_round_trip);
+    RUN_TEST(test_fixed_point_rounding_and_saturation);
+    RUN_TEST(test_icon_round_trip);
+    RUN_TEST(test_condition_descriptions_interned);
+    RUN_TEST(test_epoch_times_format_at_render);
+    RUN_TEST(test_defaults);
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "weather_conditions.h"
+#include "weather_icons.h"
+
+// OWM condition ids and their documented day icon; the night icon has the same number
+struct ConditionIcon {
+    uint16_t id;
+    uint8_t icon;
+};
+
+static const ConditionIcon DOCUMENTED[] = {
+    {200, 11}, {201, 11}, {202, 11}, {210, 11}, {211, 11}, {212, 11}, {221, 11},
+    {230, 11}, {231, 11}, {232, 11},
+    {300, 9}, {301, 9}, {302, 9}, {310, 9}, {311, 9}, {312, 9}, {313, 9}, {314, 9}, {321, 9},
+    {500, 10}, {501, 10}, {502, 10}, {503, 10}, {504, 10}, {511, 13},
+    {520, 9}, {521, 9}, {522, 9}, {531, 9},
+    {600, 13}, {601, 13}, {602, 13}, {611, 13}, {612, 13}, {613, 13}, {615, 13}, {616, 13},
+    {620, 13}, {621, 13}, {622, 13},
+    {701, 50}, {711, 50}, {721, 50}, {731, 50}, {741, 50}, {751, 50}, {761, 50}, {762, 50},
+    {771, 50}, {781, 50},
+    {800, 1}, {801, 2}, {802, 3}, {803, 4}, {804, 4},
+};
+
+static const uint8_t ICON_NUMBERS[] = {1, 2, 3, 4, 9, 10, 11, 13, 50};
+
+// Master index per icon code ("10n"), from the generator's "// 10d 10n" line above each array
+static int masterFor[100][2];
+
+void setUp() {}
+void tearDown() {}
+
+static std::string readHeader() {
+    std::string here = __FILE__;
+    size_t slash = here.find_last_of('/');
+    std::string candidates[2] = {
+        (slash == std::string::npos ? std::string(".") : here.substr(0, slash)) + "/../../include/weather_icons.h",
+        "include/weather_icons.h",
+    };
+    for (const std::string& path : candidates) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (f == nullptr) continue;
+        std::string text;
+        char chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) text.append(chunk, n);
+        fclose(f);
+        return text;
+    }
+    return std::string();
+}
+
+// Number of masters listed, -1 if the header cannot be read
+static int loadManifest() {
+    memset(masterFor, -1, sizeof(masterFor));
+    std::string header = readHeader();
+    if (header.empty()) return -1;
+    size_t at = 0;
+    int masters = 0;
+    while ((at = header.find("static const uint8_t icon_alpha_", at)) != std::string::npos) {
+        int index = -1;
+        sscanf(header.c_str() + at, "static const uint8_t icon_alpha_%d", &index);
+        size_t lineStart = header.rfind("\n//", at - 1);
+        std::string sources = header.substr(lineStart + 3, header.find('\n', lineStart + 1) - lineStart - 3);
+        char code[4];
+        int offset = 0, used;
+        while (sscanf(sources.c_str() + offset, " %3s%n", code, &used) == 1) {
+            int number = (code[0] - '0') * 10 + (code[1] - '0');
+            masterFor[number][code[2] == 'n'] = index;
+            offset += used;
+        }
+        masters++;
+        at++;
+    }
+    return masters;
+}
+
+void test_generator_manifest() {
+    int masters = loadManifest();
+    TEST_ASSERT_TRUE_MESSAGE(masters >= 0, "include/weather_icons.h not found");
+    TEST_ASSERT_EQUAL(sizeof(weather_icon_blobs) / sizeof(weather_icon_blobs[0]), masters);
+}
+
+void test_every_icon_has_its_own_slot() {
+    bool used[WEATHER_ICON_HASH_SLOTS] = {};
+    for (uint8_t number : ICON_NUMBERS) {
+        for (int night = 0; night < 2; night++) {
+            uint8_t slot = weatherIconSlot(number, night);
+            TEST_ASSERT_LESS_THAN(WEATHER_ICON_HASH_SLOTS, slot);
+            TEST_ASSERT_FALSE_MESSAGE(used[slot], "two icons share a hash slot");
+            used[slot] = true;
+            TEST_ASSERT_EQUAL(number, weather_icon_slot_key[slot]);
+        }
+    }
+}
+
+void test_every_documented_condition_resolves() {
+    TEST_ASSERT_GREATER_THAN(0, loadManifest());
+    for (const ConditionIcon& c : DOCUMENTED) {
+        TEST_ASSERT_NOT_NULL(conditionDescription(c.id));
+        for (int night = 0; night < 2; night++) {
+            char code[4] = {(char)('0' + c.icon / 10), (char)('0' + c.icon % 10), night ? 'n' : 'd', '\0'};
+            uint8_t parsed = parseWeatherIcon(code);
+            TEST_ASSERT_EQUAL(c.icon, WEATHER_ICON_CODE(parsed));
+            TEST_ASSERT_EQUAL(night != 0, WEATHER_ICON_IS_NIGHT(parsed));
+
+            const WeatherIcon* icon = getWeatherIcon(WEATHER_ICON_CODE(parsed), WEATHER_ICON_IS_NIGHT(parsed));
+            TEST_ASSERT_NOT_NULL(icon);
+            int master = masterFor[c.icon][night];
+            TEST_ASSERT_TRUE_MESSAGE(master >= 0, code);
+            TEST_ASSERT_EQUAL_PTR_MESSAGE(&weather_icon_blobs[master], icon, code);
+            TEST_ASSERT_EQUAL(WEATHER_ICON_MASTER_SIZE, icon->size);
+
+            char back[4];
+            weatherIconString(parsed, back);
+            TEST_ASSERT_EQUAL_STRING(code, back);
+        }
+    }
+}
+
+void test_colliding_numbers_are_rejected() {
+    // Every number that is not an icon, including those landing on a used slot
+    for (int number = 0; number < 100; number++) {
+        bool isIcon = memchr(ICON_NUMBERS, number, sizeof(ICON_NUMBERS)) != nullptr;
+        for (int night = 0; night < 2; night++) {
+            const WeatherIcon* icon = getWeatherIcon((uint8_t)number, night);
+            TEST_ASSERT_TRUE_MESSAGE((icon != nullptr) == isIcon, "unexpected hash hit");
+        }
+    }
+    TEST_ASSERT_NULL(getWeatherIcon(255, false));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_generator_manifest);
+    RUN_TEST(test_every_icon_has_its_own_slot);
+    RUN_TEST(test_every_documented_condition_resolves);
+    RUN_TEST(test_colliding_numbers_are_rejected);
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+#include <unity.h>
+#include <string.h>
+#include "wifi_cache.h"
+
+static const uint32_t NOW = 1718409600;   // 2024-06-15 00:00 UTC
+static const uint8_t BSSID[6] = {0x24, 0x0A, 0xC4, 0x12, 0x34, 0x56};
+static const uint8_t OTHER_BSSID[6] = {0x24, 0x0A, 0xC4, 0x65, 0x43, 0x21};
+
+static uint32_t ip(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+}
+
+static const WifiAddressConfig LEASE = {ip(192, 168, 1, 73), ip(192, 168, 1, 1), ip(255, 255, 255, 0),
+                                        ip(192, 168, 1, 1)};
+static const WifiAddressConfig NO_FIXED = {0, 0, 0, 0};
+
+static uint32_t hash;
+static WifiJoinCache cache;
+
+// An entry learned by a DHCP join on channel 6 at leasedAt
+static void joinWithDhcp(uint32_t leasedAt) {
+    wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, LEASE, leasedAt);
+}
+
+void setUp() {
+    hash = wifiCredentialHash("HomeNet", "hunter22");
+    wifiCacheReset(&cache, hash);
+}
+
+void tearDown() {}
+
+void test_credential_hash_separates_fields() {
+    TEST_ASSERT_EQUAL_HEX32(hash, wifiCredentialHash("HomeNet", "hunter22"));
+    TEST_ASSERT_NOT_EQUAL(hash, wifiCredentialHash("HomeNet", "hunter23"));
+    TEST_ASSERT_NOT_EQUAL(hash, wifiCredentialHash("HomeNet2", "hunter22"));
+    TEST_ASSERT_NOT_EQUAL(wifiCredentialHash("ab", "c"), wifiCredentialHash("a", "bc"));
+    TEST_ASSERT_NOT_EQUAL(wifiCredentialHash("", "x"), wifiCredentialHash("x", ""));
+}
+
+void test_cache_validity() {
+    TEST_ASSERT_TRUE(wifiCacheValid(cache, hash));
+    TEST_ASSERT_EQUAL(0, cache.channel);
+    TEST_ASSERT_EQUAL(0, cache.ip);
+
+    joinWithDhcp(NOW);
+    TEST_ASSERT_TRUE(wifiCacheValid(cache, hash));
+    // Changed credentials drop the entry
+    TEST_ASSERT_FALSE(wifiCacheValid(cache, wifiCredentialHash("HomeNet", "newpass")));
+
+    WifiJoinCache damaged = cache;
+    damaged.magic ^= 0x100;
+    TEST_ASSERT_FALSE(wifiCacheValid(damaged, hash));
+    damaged = cache;
+    damaged.channel = 15;
+    TEST_ASSERT_FALSE(wifiCacheValid(damaged, hash));
+
+    WifiJoinCache blank;
+    memset(&blank, 0, sizeof(blank));   // NVS had nothing
+    TEST_ASSERT_FALSE(wifiCacheValid(blank, hash));
+}
+
+void test_empty_cache_scans_with_dhcp() {
+    WifiJoinPlan plan = planWifiJoin(cache, NO_FIXED, true, NOW);
+    TEST_ASSERT_FALSE(plan.fastJoin);
+    TEST_ASSERT_EQUAL(0, plan.channel);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, plan.ipMode);
+}
+
+void test_cached_access_point_is_joined_directly() {
+    joinWithDhcp(NOW);
+    WifiJoinPlan plan = planWifiJoin(cache, NO_FIXED, false, NOW + 60);
+    TEST_ASSERT_TRUE(plan.fastJoin);
+    TEST_ASSERT_EQUAL(6, plan.channel);
+    TEST_ASSERT_EQUAL_MEMORY(BSSID, plan.bssid, sizeof(BSSID));
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, plan.ipMode);   // Lease reuse off
+}
+
+void test_failed_fast_joins_fall_back_to_a_scan() {
+    joinWithDhcp(NOW);
+    for (int i = 1; i < WIFI_CACHE_MAX_FAILURES; i++) {
+        TEST_ASSERT_TRUE(wifiCacheRecordFailure(&cache));
+        TEST_ASSERT_TRUE(planWifiJoin(cache, NO_FIXED, true, NOW).fastJoin);
+    }
+    TEST_ASSERT_TRUE(wifiCacheRecordFailure(&cache));
+
+    // The access point and its lease are forgotten; the credentials stay
+    TEST_ASSERT_EQUAL(0, cache.channel);
+    TEST_ASSERT_EQUAL(0, cache.ip);
+    TEST_ASSERT_TRUE(wifiCacheValid(cache, hash));
+    WifiJoinPlan plan = planWifiJoin(cache, NO_FIXED, true, NOW);
+    TEST_ASSERT_FALSE(plan.fastJoin);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, plan.ipMode);
+    TEST_ASSERT_FALSE(wifiCacheRecordFailure(&cache));   // Nothing left to fail
+
+    // A failed fast join followed by a successful one starts the count over
+    joinWithDhcp(NOW);
+    wifiCacheRecordFailure(&cache);
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, LEASE, NOW + 10));
+    TEST_ASSERT_EQUAL(0, cache.failures);
+}
+
+void test_fresh_lease_reused_only_when_enabled() {
+    joinWithDhcp(NOW);
+    WifiJoinPlan plan = planWifiJoin(cache, NO_FIXED, true, NOW + 600);
+    TEST_ASSERT_EQUAL(WIFI_IP_CACHED_LEASE, plan.ipMode);
+    TEST_ASSERT_EQUAL_HEX32(LEASE.ip, plan.address.ip);
+    TEST_ASSERT_EQUAL_HEX32(LEASE.gateway, plan.address.gateway);
+    TEST_ASSERT_EQUAL_HEX32(LEASE.subnet, plan.address.subnet);
+    TEST_ASSERT_EQUAL_HEX32(LEASE.dns, plan.address.dns);
+
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, NO_FIXED, false, NOW + 600).ipMode);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, NO_FIXED, WIFI_REUSE_LEASE, NOW + 600).ipMode);
+}
+
+void test_lease_rejected_when_stale_or_undated() {
+    joinWithDhcp(NOW);
+    TEST_ASSERT_EQUAL(WIFI_IP_CACHED_LEASE, planWifiJoin(cache, NO_FIXED, true, NOW).ipMode);
+    TEST_ASSERT_EQUAL(WIFI_IP_CACHED_LEASE,
+                      planWifiJoin(cache, NO_FIXED, true, NOW + WIFI_LEASE_REUSE_S - 1).ipMode);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, NO_FIXED, true, NOW + WIFI_LEASE_REUSE_S).ipMode);
+
+    // Clock not set since power-on: the lease's age is unknown
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, NO_FIXED, true, 0).ipMode);
+    // Clock behind the lease date
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, NO_FIXED, true, NOW - 1).ipMode);
+
+    // A lease obtained before the clock was set is never reused until it is dated
+    wifiCacheReset(&cache, hash);
+    joinWithDhcp(0);
+    TEST_ASSERT_EQUAL(0, cache.leaseEpoch);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, NO_FIXED, true, NOW).ipMode);
+    TEST_ASSERT_TRUE(wifiCacheStampLease(&cache, NOW));
+    TEST_ASSERT_EQUAL(WIFI_IP_CACHED_LEASE, planWifiJoin(cache, NO_FIXED, true, NOW + 1).ipMode);
+}
+
+void test_lease_only_on_the_fast_join_path() {
+    joinWithDhcp(NOW);
+    cache.failures = WIFI_CACHE_MAX_FAILURES;   // As if restored mid-way; no fast join
+    WifiJoinPlan plan = planWifiJoin(cache, NO_FIXED, true, NOW);
+    TEST_ASSERT_FALSE(plan.fastJoin);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, plan.ipMode);
+}
+
+void test_static_address_takes_precedence() {
+    joinWithDhcp(NOW);
+    WifiAddressConfig fixed = {ip(10, 0, 0, 50), ip(10, 0, 0, 1), ip(255, 255, 255, 0), ip(10, 0, 0, 1)};
+    WifiJoinPlan plan = planWifiJoin(cache, fixed, true, NOW);
+    TEST_ASSERT_TRUE(plan.fastJoin);
+    TEST_ASSERT_EQUAL(WIFI_IP_STATIC, plan.ipMode);
+    TEST_ASSERT_EQUAL_HEX32(fixed.ip, plan.address.ip);
+
+    // Also without a cached access point, and without a clock
+    wifiCacheReset(&cache, hash);
+    TEST_ASSERT_EQUAL(WIFI_IP_STATIC, planWifiJoin(cache, fixed, false, 0).ipMode);
+
+    // An address without a subnet isn't usable
+    fixed.subnet = 0;
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, fixed, false, NOW).ipMode);
+
+    // Unset in config.h
+    WifiAddressConfig configured = wifiStaticAddress();
+    TEST_ASSERT_EQUAL(0, configured.ip);
+    TEST_ASSERT_EQUAL(WIFI_IP_DHCP, planWifiJoin(cache, configured, false, NOW).ipMode);
+}
+
+void test_static_join_does_not_touch_the_lease() {
+    joinWithDhcp(NOW);
+    WifiAddressConfig fixed = {ip(10, 0, 0, 50), ip(10, 0, 0, 1), ip(255, 255, 255, 0), ip(10, 0, 0, 1)};
+    TEST_ASSERT_FALSE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_STATIC, fixed, NOW + 7200));
+    TEST_ASSERT_EQUAL_HEX32(LEASE.ip, cache.ip);
+    TEST_ASSERT_EQUAL(NOW, cache.leaseEpoch);
+    TEST_ASSERT_FALSE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_CACHED_LEASE, LEASE, NOW + 7200));
+    TEST_ASSERT_EQUAL(NOW, cache.leaseEpoch);   // Reusing a lease doesn't extend it
+
+    // A roam to another access point is worth saving either way
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, OTHER_BSSID, 6, WIFI_IP_STATIC, fixed, NOW + 7200));
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, OTHER_BSSID, 11, WIFI_IP_STATIC, fixed, NOW + 7200));
+    TEST_ASSERT_EQUAL_MEMORY(OTHER_BSSID, cache.bssid, sizeof(OTHER_BSSID));
+    TEST_ASSERT_EQUAL(11, cache.channel);
+}
+
+void test_lease_renewals_coalesce_flash_writes() {
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, LEASE, NOW));
+    TEST_ASSERT_EQUAL(NOW, cache.leaseEpoch);
+
+    // The same lease again within WIFI_LEASE_REFRESH_S: nothing to write
+    TEST_ASSERT_FALSE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, LEASE, NOW + 60));
+    TEST_ASSERT_FALSE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, LEASE, NOW + WIFI_LEASE_REFRESH_S - 1));
+    TEST_ASSERT_EQUAL(NOW, cache.leaseEpoch);
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, LEASE, NOW + WIFI_LEASE_REFRESH_S));
+    TEST_ASSERT_EQUAL(NOW + WIFI_LEASE_REFRESH_S, cache.leaseEpoch);
+
+    // A different lease is written at once
+    WifiAddressConfig moved = LEASE;
+    moved.ip = ip(192, 168, 1, 74);
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, moved, NOW + WIFI_LEASE_REFRESH_S + 1));
+    TEST_ASSERT_EQUAL_HEX32(moved.ip, cache.ip);
+    moved.dns = ip(1, 1, 1, 1);
+    TEST_ASSERT_TRUE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, moved, NOW + WIFI_LEASE_REFRESH_S + 2));
+
+    // Same lease, same access point, but an unknown time: nothing to write
+    TEST_ASSERT_FALSE(wifiCacheRecordJoin(&cache, BSSID, 6, WIFI_IP_DHCP, moved, 0));
+}
+
+void test_stamping_a_lease() {
+    TEST_ASSERT_FALSE(wifiCacheStampLease(&cache, NOW));   // No lease yet
+    joinWithDhcp(0);
+    TEST_ASSERT_FALSE(wifiCacheStampLease(&cache, 0));
+    TEST_ASSERT_TRUE(wifiCacheStampLease(&cache, NOW));
+    TEST_ASSERT_FALSE(wifiCacheStampLease(&cache, NOW + 10));
+    TEST_ASSERT_EQUAL(NOW, cache.leaseEpoch);
+
+    // A clock that went backwards re-dates the lease rather than trusting the old date
+    TEST_ASSERT_TRUE(wifiCacheStampLease(&cache, NOW - 3600));
+    TEST_ASSERT_EQUAL(NOW - 3600, cache.leaseEpoch);
+}
+
+void test_parse_ipv4() {
+    TEST_ASSERT_EQUAL_HEX32(ip(192, 168, 1, 50), parseIPv4("192.168.1.50"));
+    TEST_ASSERT_EQUAL_HEX32(ip(255, 255, 255, 0), parseIPv4("255.255.255.0"));
+    TEST_ASSERT_EQUAL_HEX32(ip(10, 0, 0, 1), parseIPv4("010.0.0.001"));
+    TEST_ASSERT_EQUAL_HEX32(0, parseIPv4("0.0.0.0"));
+
+    const char* bad[] = {
+        "", "1", "1.2.3", "1.2.3.", "1.2.3.4.", "1.2.3.4.5", ".1.2.3", "1..2.3",
+        "256.1.1.1", "1.2.3.999", "0001.2.3.4", " 1.2.3.4", "1.2.3.4 ", "1.2.3.4x",
+        "a.b.c.d", "1.2.-3.4", "1.2.3.+4", "1,2,3,4", "::1",
+    };
+    for (const char* text : bad) {
+        TEST_ASSERT_EQUAL_HEX32(0, parseIPv4(text));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_credential_hash_separates_fields);
+    RUN_TEST(test_cache_validity);
+    RUN_TEST(test_empty_cache_scans_with_dhcp);
+    RUN_TEST(test_cached_access_point_is_joined_directly);
+    RUN_TEST(test_failed_fast_joins_fall_back_to_a_scan);
+    RUN_TEST(test_fresh_lease_reused_only_when_enabled);
+    RUN_TEST(test_lease_rejected_when_stale_or_undated);
+    RUN_TEST(test_lease_only_on_the_fast_join_path);
+    RUN_TEST(test_static_address_takes_precedence);
+    RUN_TEST(test_static_join_does_not_touch_the_lease);
+    RUN_TEST(test_lease_renewals_coalesce_flash_writes);
+    RUN_TEST(test_stamping_a_lease);
+    RUN_TEST(test_parse_ipv4);
+    return UNITY_END();
+}
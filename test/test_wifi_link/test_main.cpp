@@ -0,0 +1,742 @@
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "wifi_link.h"
+
+// Driver disconnect reasons the scenarios report
+static const uint8_t REASON_HANDSHAKE_TIMEOUT = 15;   // Wrong password
+static const uint8_t REASON_BEACON_TIMEOUT = 200;     // Access point vanished
+static const uint8_t REASON_NO_AP_FOUND = 201;
+
+static const uint32_t SCAN_MS = 2000;
+static const uint32_t ASSOCIATE_MS = 1000;
+static const uint32_t REJECT_MS = 3000;
+
+static void bssidFor(uint8_t id, uint8_t* out) {
+    static const uint8_t base[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x00};
+    memcpy(out, base, 6);
+    out[5] = id;
+}
+
+static WifiScanResult hit(uint8_t network, int8_t rssi, uint8_t channel, uint8_t id) {
+    WifiScanResult r;
+    r.network = network;
+    r.rssi = rssi;
+    r.channel = channel;
+    bssidFor(id, r.bssid);
+    return r;
+}
+
+static void expectConnect(const WifiLinkAction& action, uint8_t network, uint8_t id, uint8_t channel) {
+    uint8_t bssid[6];
+    bssidFor(id, bssid);
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, action.type);
+    TEST_ASSERT_EQUAL(network, action.network);
+    TEST_ASSERT_EQUAL(channel, action.channel);
+    TEST_ASSERT_EQUAL_MEMORY(bssid, action.bssid, 6);
+}
+
+// Stands in for the WiFi driver and the air around it: carries out the
+// actions poll() returns and answers with events after plausible delays,
+// one WIFI_MANAGER_TICK_MS step at a time like the manager task
+struct AccessPoint {
+    uint8_t network;
+    uint8_t id;          // Last BSSID byte
+    uint8_t channel;
+    int8_t rssi;
+    bool up;
+    bool hidden;
+};
+
+struct LoggedAction {
+    uint32_t at;
+    WifiLinkAction action;
+};
+
+struct Radio {
+    enum Pending { NOTHING, SCAN_DONE, JOINED, REJECTED };
+
+    WifiLink link;
+    std::vector<AccessPoint> aps;
+    bool passwordOk[WIFI_MAX_NETWORKS] = {true, true, true};
+    uint32_t now = 0;
+    int associated = -1;     // Index into aps
+    Pending pending = NOTHING;
+    uint32_t pendingAt = 0;
+    int pendingAp = -1;
+    uint8_t pendingReason = 0;
+    uint32_t lastRssiSample = 0;
+    std::vector<LoggedAction> log;
+    std::vector<uint32_t> retryAfterFailure;
+    std::vector<uint32_t> upAt;
+
+    void add(uint8_t network, uint8_t id, uint8_t channel, int8_t rssi, bool hidden = false) {
+        aps.push_back({network, id, channel, rssi, true, hidden});
+    }
+
+    AccessPoint* ap(uint8_t id) {
+        for (AccessPoint& a : aps) {
+            if (a.id == id) return &a;
+        }
+        return nullptr;
+    }
+
+    void start(uint8_t networks, int joinedAp) {
+        if (joinedAp < 0) {
+            link.begin(networks, now, -1, nullptr, 0);
+            return;
+        }
+        uint8_t bssid[6];
+        bssidFor(aps[joinedAp].id, bssid);
+        link.begin(networks, now, aps[joinedAp].network, bssid, aps[joinedAp].channel);
+        associated = joinedAp;
+        lastRssiSample = now;
+    }
+
+    // The access point a connect reaches: the exact BSSID, or any of the network's when blind
+    int target(const WifiLinkAction& action) {
+        int best = -1;
+        for (size_t i = 0; i < aps.size(); i++) {
+            const AccessPoint& a = aps[i];
+            uint8_t bssid[6];
+            bssidFor(a.id, bssid);
+            bool match = action.channel == 0 ? a.network == action.network : memcmp(bssid, action.bssid, 6) == 0;
+            if (match && a.up && (best < 0 || a.rssi > aps[best].rssi)) {
+                best = (int)i;
+            }
+        }
+        return best;
+    }
+
+    void carryOut(const WifiLinkAction& action) {
+        if (action.type == LINK_ACTION_NONE) {
+            return;
+        }
+        log.push_back({now, action});
+        if (action.type == LINK_ACTION_SCAN) {
+            pending = SCAN_DONE;
+            pendingAt = now + SCAN_MS;
+            return;
+        }
+        if (associated >= 0) {
+            associated = -1;
+            link.onDisconnected(now, WIFI_REASON_ASSOC_LEAVE);
+        }
+        pendingAp = target(action);
+        if (pendingAp >= 0 && passwordOk[action.network]) {
+            pending = JOINED;
+            pendingAt = now + ASSOCIATE_MS;
+        } else {
+            pending = REJECTED;
+            pendingAt = now + REJECT_MS;
+            pendingReason = pendingAp >= 0 ? REASON_HANDSHAKE_TIMEOUT : REASON_NO_AP_FOUND;
+        }
+    }
+
+    void deliver() {
+        Pending p = pending;
+        pending = NOTHING;
+        if (p == SCAN_DONE) {
+            WifiScanResult results[8];
+            uint8_t count = 0;
+            for (const AccessPoint& a : aps) {
+                if (a.up && !a.hidden && count < 8) {
+                    results[count++] = hit(a.network, a.rssi, a.channel, a.id);
+                }
+            }
+            link.onScanDone(now, results, count);
+        } else if (p == JOINED) {
+            associated = pendingAp;
+            lastRssiSample = now;
+            uint8_t bssid[6];
+            bssidFor(aps[associated].id, bssid);
+            link.onConnected(now, bssid, aps[associated].channel);
+            upAt.push_back(now);
+        } else if (p == REJECTED) {
+            link.onDisconnected(now, pendingReason);
+            retryAfterFailure.push_back(link.retryInMs(now));
+        }
+    }
+
+    void step() {
+        now += WIFI_MANAGER_TICK_MS;
+        if (pending != NOTHING && now >= pendingAt) {
+            deliver();
+        }
+        if (associated >= 0 && !aps[associated].up) {
+            associated = -1;
+            link.onDisconnected(now, REASON_BEACON_TIMEOUT);
+        }
+        if (associated >= 0 && now - lastRssiSample >= WIFI_RSSI_SAMPLE_MS) {
+            lastRssiSample = now;
+            link.onRssi(now, aps[associated].rssi);
+        }
+        carryOut(link.poll(now));
+    }
+
+    void runUntil(uint32_t t) {
+        while (now < t) {
+            step();
+        }
+    }
+
+    size_t countSince(uint32_t t, WifiLinkActionType type) const {
+        size_t n = 0;
+        for (const LoggedAction& a : log) {
+            n += a.at >= t && a.action.type == type;
+        }
+        return n;
+    }
+
+    const LoggedAction* firstSince(uint32_t t) const {
+        for (const LoggedAction& a : log) {
+            if (a.at >= t) return &a;
+        }
+        return nullptr;
+    }
+};
+
+static void expectOnAp(Radio& radio, uint8_t id) {
+    uint8_t bssid[6];
+    bssidFor(id, bssid);
+    TEST_ASSERT_EQUAL(LINK_UP, radio.link.state());
+    TEST_ASSERT_EQUAL_MEMORY(bssid, radio.link.bssid(), 6);
+    TEST_ASSERT_EQUAL(radio.ap(id)->network, radio.link.network());
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_state_names() {
+    TEST_ASSERT_EQUAL_STRING("down", wifiLinkStateName(LINK_DOWN));
+    TEST_ASSERT_EQUAL_STRING("scanning", wifiLinkStateName(LINK_SCANNING));
+    TEST_ASSERT_EQUAL_STRING("connecting", wifiLinkStateName(LINK_CONNECTING));
+    TEST_ASSERT_EQUAL_STRING("up", wifiLinkStateName(LINK_UP));
+    TEST_ASSERT_EQUAL_STRING("?", wifiLinkStateName(9));
+}
+
+void test_rssi_history_keeps_the_latest() {
+    RssiHistory h;
+    TEST_ASSERT_EQUAL(0, h.count());
+    for (int i = 0; i < WIFI_RSSI_HISTORY + 10; i++) {
+        h.push((int8_t)(-i % 100));
+    }
+    TEST_ASSERT_EQUAL(WIFI_RSSI_HISTORY, h.count());
+    TEST_ASSERT_EQUAL(-10, h.at(0));
+    TEST_ASSERT_EQUAL((int8_t)(-(WIFI_RSSI_HISTORY + 9) % 100), h.at(WIFI_RSSI_HISTORY - 1));
+}
+
+void test_boot_join_result() {
+    WifiLink link;
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.begin(2, 1000, 1, bssid, 6);
+    TEST_ASSERT_EQUAL(LINK_UP, link.state());
+    TEST_ASSERT_TRUE(link.online());
+    TEST_ASSERT_EQUAL(1, link.connects());
+    TEST_ASSERT_EQUAL(0, link.reconnects());
+    TEST_ASSERT_EQUAL(1, link.networkStats(1).successes);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(1200).type);
+
+    // A failed boot join scans on the first poll
+    link.begin(2, 1000, -1, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_DOWN, link.state());
+    TEST_ASSERT_FALSE(link.online());
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(1000).type);
+    TEST_ASSERT_EQUAL(LINK_SCANNING, link.state());
+
+    // No networks configured: nothing to do
+    link.begin(0, 1000, -1, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(5000).type);
+}
+
+void test_drop_retries_the_same_access_point_then_scans() {
+    WifiLink link;
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.begin(2, 0, 0, bssid, 6);
+    link.onRssi(30000, -61);
+
+    link.onDisconnected(60000, REASON_BEACON_TIMEOUT);
+    TEST_ASSERT_EQUAL(LINK_DOWN, link.state());
+    TEST_ASSERT_EQUAL(1, link.disconnects());
+    TEST_ASSERT_EQUAL(WIFI_RECONNECT_DELAY_MS, link.retryInMs(60000));
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(60000 + WIFI_RECONNECT_DELAY_MS - 1).type);
+    expectConnect(link.poll(60000 + WIFI_RECONNECT_DELAY_MS), 0, 1, 6);
+    TEST_ASSERT_EQUAL(LINK_CONNECTING, link.state());
+
+    // The retry fails: wait out the minimum backoff, then scan
+    link.onDisconnected(63000, REASON_NO_AP_FOUND);
+    TEST_ASSERT_EQUAL(1, link.failedAttempts());
+    TEST_ASSERT_EQUAL(1, link.networkStats(0).failStreak);
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF_MIN_MS, link.retryInMs(63000));
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(63000 + WIFI_BACKOFF_MIN_MS - 1).type);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(63000 + WIFI_BACKOFF_MIN_MS).type);
+
+    // Back on the same access point: counted as a reconnect, outage measured from the drop
+    WifiScanResult seen = hit(0, -62, 6, 1);
+    link.onScanDone(67000, &seen, 1);
+    expectConnect(link.poll(67000), 0, 1, 6);
+    link.onConnected(68000, bssid, 6);
+    TEST_ASSERT_EQUAL(LINK_UP, link.state());
+    TEST_ASSERT_EQUAL(2, link.connects());
+    TEST_ASSERT_EQUAL(1, link.reconnects());
+    TEST_ASSERT_EQUAL(8000, link.lastOutageMs());
+    TEST_ASSERT_EQUAL(0, link.networkStats(0).failStreak);
+    TEST_ASSERT_EQUAL(1, link.networkStats(0).failures);
+    TEST_ASSERT_EQUAL(2, link.networkStats(0).successes);
+    TEST_ASSERT_EQUAL(-62, link.networkStats(0).lastRssi);
+    TEST_ASSERT_EQUAL(0, link.networkStats(1).lastRssi);
+}
+
+void test_backoff_doubles_up_to_the_maximum() {
+    WifiLink link;
+    link.begin(1, 0, -1, nullptr, 0);
+    const uint32_t expected[] = {2000, 4000, 8000, 16000, 32000, 60000, 60000, 60000};
+    uint32_t t = 0;
+    for (uint32_t wait : expected) {
+        TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(t).type);
+        link.onScanDone(t + 100, nullptr, 0);
+        TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, link.poll(t + 100).type);
+        link.onDisconnected(t + 200, REASON_HANDSHAKE_TIMEOUT);
+        TEST_ASSERT_EQUAL(wait, link.retryInMs(t + 200));
+        t += 200 + wait;
+    }
+    TEST_ASSERT_EQUAL(8, link.failedAttempts());
+
+    // A success resets it
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(t).type);
+    link.onScanDone(t, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, link.poll(t).type);
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.onConnected(t + 1000, bssid, 6);
+    TEST_ASSERT_EQUAL(1, link.connects());
+    TEST_ASSERT_EQUAL(0, link.reconnects());
+    link.onDisconnected(t + 5000, REASON_BEACON_TIMEOUT);
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, link.poll(t + 5000 + WIFI_RECONNECT_DELAY_MS).type);
+    link.onDisconnected(t + 6000, REASON_NO_AP_FOUND);
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF_MIN_MS, link.retryInMs(t + 6000));
+}
+
+void test_candidates_ranked_deduplicated_and_capped() {
+    WifiLink link;
+    link.begin(3, 0, -1, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(0).type);
+    WifiScanResult results[] = {
+        hit(0, -70, 1, 1),
+        hit(1, -60, 6, 2),
+        hit(2, -90, 11, 5),     // Weakest, falls off the full list
+        hit(1, -58, 6, 2),      // Same BSSID heard twice
+        hit(0, -80, 1, 4),
+        hit(7, -30, 1, 9),      // Not a configured network
+        hit(2, -65, 11, 3),
+    };
+    link.onScanDone(2000, results, sizeof(results) / sizeof(results[0]));
+    TEST_ASSERT_EQUAL(-70, link.networkStats(0).lastRssi);
+    TEST_ASSERT_EQUAL(-58, link.networkStats(1).lastRssi);
+    TEST_ASSERT_EQUAL(-65, link.networkStats(2).lastRssi);
+
+    // Best first, the next one straight after each failure
+    expectConnect(link.poll(2000), 1, 2, 6);
+    link.onDisconnected(3000, REASON_HANDSHAKE_TIMEOUT);
+    TEST_ASSERT_EQUAL(0, link.retryInMs(3000));
+    expectConnect(link.poll(3000), 2, 3, 11);
+    link.onDisconnected(4000, REASON_HANDSHAKE_TIMEOUT);
+    expectConnect(link.poll(4000), 0, 1, 1);
+    link.onDisconnected(5000, REASON_HANDSHAKE_TIMEOUT);
+    expectConnect(link.poll(5000), 0, 4, 1);
+    link.onDisconnected(6000, REASON_HANDSHAKE_TIMEOUT);
+
+    // Round exhausted
+    TEST_ASSERT_EQUAL(4, link.failedAttempts());
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF_MIN_MS, link.retryInMs(6000));
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(6000).type);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(6000 + WIFI_BACKOFF_MIN_MS).type);
+}
+
+void test_failures_and_the_last_good_network_shift_the_ranking() {
+    // A recent failure costs WIFI_FAILURE_PENALTY_DB: the weaker network goes first
+    WifiLink link;
+    link.begin(2, 0, -1, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(0).type);
+    WifiScanResult only = hit(1, -60, 6, 2);
+    link.onScanDone(1000, &only, 1);
+    expectConnect(link.poll(1000), 1, 2, 6);
+    link.onDisconnected(2000, REASON_HANDSHAKE_TIMEOUT);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(2000 + WIFI_BACKOFF_MIN_MS).type);
+    WifiScanResult both[] = {hit(0, -65, 1, 1), hit(1, -60, 6, 2)};
+    link.onScanDone(5000, both, 2);
+    expectConnect(link.poll(5000), 0, 1, 1);
+
+    // The network that last worked gets WIFI_PREFERRED_BONUS_DB, enough to
+    // stay ahead of a slightly stronger one despite the failed same-AP retry
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.begin(2, 0, 0, bssid, 1);
+    link.onDisconnected(1000, REASON_BEACON_TIMEOUT);
+    expectConnect(link.poll(1500), 0, 1, 1);
+    link.onDisconnected(4500, REASON_NO_AP_FOUND);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(4500 + WIFI_BACKOFF_MIN_MS).type);
+    WifiScanResult close[] = {hit(1, -60, 6, 2), hit(0, -56, 1, 1)};
+    link.onScanDone(8000, close, 2);
+    expectConnect(link.poll(8000), 0, 1, 1);
+    link.onDisconnected(9000, REASON_NO_AP_FOUND);
+    expectConnect(link.poll(9000), 1, 2, 6);
+}
+
+void test_blind_candidates_when_nothing_is_heard() {
+    WifiLink link;
+    link.begin(3, 0, -1, nullptr, 0);
+
+    // Give network 0 a failure and network 2 a success so the blind order shows
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(0).type);
+    WifiScanResult seen[] = {hit(0, -50, 1, 1), hit(2, -70, 11, 3)};
+    link.onScanDone(1000, seen, 2);
+    expectConnect(link.poll(1000), 0, 1, 1);
+    link.onDisconnected(2000, REASON_HANDSHAKE_TIMEOUT);
+    expectConnect(link.poll(2000), 2, 3, 11);
+    uint8_t bssid[6];
+    bssidFor(3, bssid);
+    link.onConnected(3000, bssid, 11);
+    link.onDisconnected(4000, REASON_BEACON_TIMEOUT);
+    expectConnect(link.poll(4500), 2, 3, 11);
+    link.onDisconnected(5000, REASON_NO_AP_FOUND);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(5000 + WIFI_BACKOFF_MIN_MS).type);
+
+    // Streaks now: network 0 one, network 1 none, network 2 one (with a success)
+    link.onScanDone(8000, nullptr, 0);
+    TEST_ASSERT_EQUAL(0, link.networkStats(0).lastRssi);
+    uint8_t zero[6] = {0};
+    WifiLinkAction a = link.poll(8000);
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, a.type);
+    TEST_ASSERT_EQUAL(1, a.network);
+    TEST_ASSERT_EQUAL(0, a.channel);
+    TEST_ASSERT_EQUAL_MEMORY(zero, a.bssid, 6);
+    link.onDisconnected(9000, REASON_NO_AP_FOUND);
+    a = link.poll(9000);
+    TEST_ASSERT_EQUAL(2, a.network);
+    TEST_ASSERT_EQUAL(0, a.channel);
+    link.onDisconnected(10000, REASON_NO_AP_FOUND);
+    a = link.poll(10000);
+    TEST_ASSERT_EQUAL(0, a.network);
+    TEST_ASSERT_EQUAL(0, a.channel);
+}
+
+void test_scan_and_connect_timeouts() {
+    WifiLink link;
+    link.begin(1, 0, -1, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(0).type);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(WIFI_SCAN_TIMEOUT_MS - 1).type);
+    TEST_ASSERT_EQUAL(LINK_SCANNING, link.state());
+
+    // A scan that never reports counts as an empty one: straight to a blind attempt
+    WifiLinkAction a = link.poll(WIFI_SCAN_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, a.type);
+    TEST_ASSERT_EQUAL(0, a.channel);
+    TEST_ASSERT_EQUAL(LINK_CONNECTING, link.state());
+
+    // Its late result is ignored
+    WifiScanResult late = hit(0, -50, 6, 1);
+    link.onScanDone(WIFI_SCAN_TIMEOUT_MS + 500, &late, 1);
+    TEST_ASSERT_EQUAL(LINK_CONNECTING, link.state());
+    TEST_ASSERT_EQUAL(0, link.networkStats(0).lastRssi);
+
+    // An attempt that never completes fails after WIFI_CONNECT_TIMEOUT_MS
+    uint32_t started = WIFI_SCAN_TIMEOUT_MS;
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(started + WIFI_CONNECT_TIMEOUT_MS - 1).type);
+    TEST_ASSERT_EQUAL(LINK_CONNECTING, link.state());
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(started + WIFI_CONNECT_TIMEOUT_MS).type);
+    TEST_ASSERT_EQUAL(LINK_DOWN, link.state());
+    TEST_ASSERT_EQUAL(1, link.failedAttempts());
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF_MIN_MS, link.retryInMs(started + WIFI_CONNECT_TIMEOUT_MS));
+}
+
+void test_leaving_an_access_point_is_not_a_failure() {
+    WifiLink link;
+    link.begin(1, 0, -1, nullptr, 0);
+    link.poll(0);
+    link.onScanDone(100, nullptr, 0);
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, link.poll(100).type);
+    link.onDisconnected(150, WIFI_REASON_ASSOC_LEAVE);
+    TEST_ASSERT_EQUAL(LINK_CONNECTING, link.state());
+    TEST_ASSERT_EQUAL(0, link.failedAttempts());
+
+    // Nor is a drop reported while already down
+    link.onDisconnected(200, REASON_HANDSHAKE_TIMEOUT);
+    link.onDisconnected(300, REASON_HANDSHAKE_TIMEOUT);
+    TEST_ASSERT_EQUAL(1, link.failedAttempts());
+    TEST_ASSERT_EQUAL(0, link.disconnects());
+}
+
+// Up on access point 1 (network 0, channel 6) with a weak signal and a roam scan running
+static void weakAndScanning(WifiLink& link, uint32_t since) {
+    link.onRssi(since, -80);
+    link.onRssi(since + WIFI_RSSI_SAMPLE_MS, -80);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(since + WIFI_RSSI_SAMPLE_MS).type);
+    TEST_ASSERT_EQUAL(LINK_UP, link.state());
+}
+
+void test_roam_needs_the_hysteresis_margin() {
+    WifiLink link;
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.begin(1, 0, 0, bssid, 6);
+
+    // Weak samples don't scan again within WIFI_ROAM_SCAN_INTERVAL_MS
+    link.onRssi(30000, -80);
+    link.onRssi(60000, -80);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(60000).type);
+    // One weak sample is not enough either
+    link.onRssi(WIFI_ROAM_SCAN_INTERVAL_MS, -70);
+    link.onRssi(WIFI_ROAM_SCAN_INTERVAL_MS + 1000, -80);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(WIFI_ROAM_SCAN_INTERVAL_MS + 1000).type);
+
+    uint32_t t = WIFI_ROAM_SCAN_INTERVAL_MS + 2000;
+    weakAndScanning(link, t);
+    t += WIFI_RSSI_SAMPLE_MS;
+
+    // 7 dB better than the current access point is not enough
+    WifiScanResult near[] = {hit(0, -80, 6, 1), hit(0, -80 + WIFI_ROAM_HYSTERESIS_DB - 1, 11, 2)};
+    link.onScanDone(t + 2000, near, 2);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(t + 2000).type);
+    TEST_ASSERT_TRUE(link.online());
+
+    // 8 dB is
+    t += 2000 + WIFI_ROAM_SCAN_INTERVAL_MS;
+    weakAndScanning(link, t);
+    t += WIFI_RSSI_SAMPLE_MS;
+    WifiScanResult better[] = {hit(0, -80 + WIFI_ROAM_HYSTERESIS_DB, 11, 2)};
+    link.onScanDone(t + 2000, better, 1);
+    expectConnect(link.poll(t + 2000), 0, 2, 11);
+    TEST_ASSERT_EQUAL(LINK_CONNECTING, link.state());
+    TEST_ASSERT_TRUE(link.online());
+    link.onDisconnected(t + 2050, WIFI_REASON_ASSOC_LEAVE);
+
+    uint8_t target[6];
+    bssidFor(2, target);
+    link.onConnected(t + 3000, target, 11);
+    TEST_ASSERT_EQUAL(LINK_UP, link.state());
+    TEST_ASSERT_EQUAL_MEMORY(target, link.bssid(), 6);
+    TEST_ASSERT_EQUAL(11, link.channel());
+    TEST_ASSERT_EQUAL(1, link.roams());
+    TEST_ASSERT_EQUAL(1, link.connects());
+    TEST_ASSERT_EQUAL(0, link.reconnects());
+    TEST_ASSERT_EQUAL(0, link.disconnects());
+    TEST_ASSERT_EQUAL(t + 3000, link.uptimeMs(t + 3000));   // Up since boot
+}
+
+void test_failed_roam_starts_over() {
+    WifiLink link;
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.begin(1, 0, 0, bssid, 6);
+    uint32_t t = WIFI_ROAM_SCAN_INTERVAL_MS;
+    weakAndScanning(link, t);
+    t += WIFI_RSSI_SAMPLE_MS;
+    WifiScanResult better = hit(0, -60, 11, 2);
+    link.onScanDone(t + 2000, &better, 1);
+    expectConnect(link.poll(t + 2000), 0, 2, 11);
+
+    // The old association is gone too, so no same-AP retry: scan afresh
+    link.onDisconnected(t + 5000, REASON_HANDSHAKE_TIMEOUT);
+    TEST_ASSERT_EQUAL(LINK_DOWN, link.state());
+    TEST_ASSERT_FALSE(link.online());
+    TEST_ASSERT_EQUAL(1, link.disconnects());
+    TEST_ASSERT_EQUAL(1, link.failedAttempts());
+    TEST_ASSERT_EQUAL(0, link.roams());
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, link.poll(t + 5000).type);
+}
+
+void test_roam_scan_timeout() {
+    WifiLink link;
+    uint8_t bssid[6];
+    bssidFor(1, bssid);
+    link.begin(1, 0, 0, bssid, 6);
+    uint32_t t = WIFI_ROAM_SCAN_INTERVAL_MS;
+    weakAndScanning(link, t);
+    t += WIFI_RSSI_SAMPLE_MS;
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(t + WIFI_SCAN_TIMEOUT_MS).type);
+
+    // A result after the timeout doesn't roam, and the interval restarts from the timeout
+    WifiScanResult better = hit(0, -50, 11, 2);
+    link.onScanDone(t + WIFI_SCAN_TIMEOUT_MS + 1000, &better, 1);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(t + WIFI_SCAN_TIMEOUT_MS + 1000).type);
+    link.onRssi(t + WIFI_SCAN_TIMEOUT_MS + 60000, -80);
+    link.onRssi(t + WIFI_SCAN_TIMEOUT_MS + 90000, -80);
+    TEST_ASSERT_EQUAL(LINK_ACTION_NONE, link.poll(t + WIFI_SCAN_TIMEOUT_MS + 90000).type);
+    TEST_ASSERT_EQUAL(LINK_UP, link.state());
+    TEST_ASSERT_EQUAL(0, link.roams());
+}
+
+void test_scenario_access_point_reboot() {
+    Radio radio;
+    radio.add(0, 1, 6, -60);
+    radio.start(1, 0);
+    radio.runUntil(10000);
+
+    radio.ap(1)->up = false;
+    radio.runUntil(10200);
+    TEST_ASSERT_EQUAL(LINK_DOWN, radio.link.state());
+    TEST_ASSERT_EQUAL(1, radio.link.disconnects());
+
+    // First the same access point after the short delay, then scans
+    radio.runUntil(30000);
+    const LoggedAction* first = radio.firstSince(10200);
+    TEST_ASSERT_NOT_NULL(first);
+    expectConnect(first->action, 0, 1, 6);
+    TEST_ASSERT_TRUE(first->at >= 10200 + WIFI_RECONNECT_DELAY_MS);
+    TEST_ASSERT_TRUE(first->at <= 10200 + WIFI_RECONNECT_DELAY_MS + WIFI_MANAGER_TICK_MS);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, (first + 1)->action.type);
+    TEST_ASSERT_FALSE(radio.link.online());
+
+    // Back within a backoff round of the access point returning
+    radio.ap(1)->up = true;
+    radio.runUntil(90000);
+    expectOnAp(radio, 1);
+    TEST_ASSERT_EQUAL(1, radio.upAt.size());
+    TEST_ASSERT_TRUE(radio.upAt[0] - 30000 <= 16000 + SCAN_MS + ASSOCIATE_MS);
+    TEST_ASSERT_EQUAL(radio.upAt[0] - 10200, radio.link.lastOutageMs());
+    TEST_ASSERT_EQUAL(2, radio.link.connects());
+    TEST_ASSERT_EQUAL(1, radio.link.reconnects());
+    TEST_ASSERT_EQUAL(1, radio.link.disconnects());
+    TEST_ASSERT_EQUAL(0, radio.link.networkStats(0).failStreak);
+    TEST_ASSERT_EQUAL(radio.link.failedAttempts(), radio.link.networkStats(0).failures);
+}
+
+void test_scenario_failover_to_second_network() {
+    Radio radio;
+    radio.add(0, 1, 1, -55);
+    radio.add(1, 2, 6, -70);
+    radio.start(2, 0);
+    radio.runUntil(5000);
+
+    radio.ap(1)->up = false;
+    radio.runUntil(20000);
+    expectOnAp(radio, 2);
+    TEST_ASSERT_EQUAL(1, radio.link.reconnects());
+    TEST_ASSERT_TRUE(radio.link.lastOutageMs() < WIFI_RECONNECT_DELAY_MS + REJECT_MS + WIFI_BACKOFF_MIN_MS +
+                                                     SCAN_MS + ASSOCIATE_MS + 2 * WIFI_MANAGER_TICK_MS);
+    TEST_ASSERT_EQUAL(1, radio.link.networkStats(0).failStreak);
+    TEST_ASSERT_EQUAL(1, radio.link.networkStats(1).successes);
+
+    // The first network returning stronger doesn't pull a healthy link back
+    radio.ap(1)->up = true;
+    radio.ap(1)->rssi = -40;
+    radio.runUntil(3600000);
+    expectOnAp(radio, 2);
+    TEST_ASSERT_EQUAL(0, radio.link.roams());
+    TEST_ASSERT_EQUAL(1, radio.link.disconnects());
+    TEST_ASSERT_EQUAL(0, radio.countSince(20000, LINK_ACTION_SCAN));
+}
+
+void test_scenario_no_ping_pong_between_similar_access_points() {
+    Radio radio;
+    radio.add(0, 1, 1, -78);
+    radio.add(0, 2, 11, -74);
+    radio.start(1, 0);
+
+    // Weak, so it keeps looking, but 4 dB better is not worth a move
+    radio.runUntil(3600000);
+    expectOnAp(radio, 1);
+    TEST_ASSERT_EQUAL(0, radio.link.roams());
+    TEST_ASSERT_EQUAL(0, radio.countSince(0, LINK_ACTION_CONNECT));
+    size_t scans = radio.countSince(0, LINK_ACTION_SCAN);
+    TEST_ASSERT_TRUE(scans >= 3600000 / (WIFI_ROAM_SCAN_INTERVAL_MS + WIFI_RSSI_SAMPLE_MS));
+    TEST_ASSERT_TRUE(scans <= 3600000 / WIFI_ROAM_SCAN_INTERVAL_MS);
+
+    // A clearly better one gets it once
+    radio.ap(2)->rssi = -66;
+    radio.runUntil(2 * 3600000);
+    expectOnAp(radio, 2);
+    TEST_ASSERT_EQUAL(1, radio.link.roams());
+
+    // And the signals swapping back by less than the margin doesn't undo it
+    radio.ap(1)->rssi = -70;
+    radio.ap(2)->rssi = -76;
+    radio.runUntil(3 * 3600000);
+    expectOnAp(radio, 2);
+    TEST_ASSERT_EQUAL(1, radio.link.roams());
+    TEST_ASSERT_TRUE(radio.countSince(2 * 3600000, LINK_ACTION_SCAN) > 0);
+    TEST_ASSERT_EQUAL(0, radio.link.disconnects());
+    TEST_ASSERT_EQUAL(1, radio.link.connects());
+}
+
+void test_scenario_wrong_password_backs_off_to_the_maximum() {
+    Radio radio;
+    radio.add(0, 1, 6, -55);
+    radio.passwordOk[0] = false;
+    radio.start(1, -1);
+    radio.runUntil(15 * 60000);
+
+    TEST_ASSERT_FALSE(radio.link.online());
+    TEST_ASSERT_EQUAL(0, radio.link.connects());
+    const uint32_t expected[] = {2000, 4000, 8000, 16000, 32000, 60000};
+    size_t n = sizeof(expected) / sizeof(expected[0]);
+    TEST_ASSERT_TRUE(radio.retryAfterFailure.size() > n + 5);
+    for (size_t i = 0; i < radio.retryAfterFailure.size(); i++) {
+        TEST_ASSERT_EQUAL(i < n ? expected[i] : WIFI_BACKOFF_MAX_MS, radio.retryAfterFailure[i]);
+    }
+    TEST_ASSERT_EQUAL(radio.retryAfterFailure.size(), radio.link.failedAttempts());
+    TEST_ASSERT_EQUAL(radio.link.failedAttempts(), radio.link.networkStats(0).failStreak);
+
+    // Fixing the password recovers within one maximum backoff
+    radio.passwordOk[0] = true;
+    uint32_t fixedAt = radio.now;
+    radio.runUntil(fixedAt + WIFI_BACKOFF_MAX_MS + REJECT_MS + SCAN_MS + ASSOCIATE_MS + WIFI_MANAGER_TICK_MS);
+    expectOnAp(radio, 1);
+    TEST_ASSERT_EQUAL(1, radio.link.connects());
+    TEST_ASSERT_EQUAL(0, radio.link.reconnects());
+}
+
+void test_scenario_hidden_network() {
+    Radio radio;
+    radio.add(0, 1, 6, -60, true);
+    radio.start(1, -1);
+    radio.runUntil(10000);
+
+    // Nothing in the scan, so a blind attempt lets the driver find it
+    TEST_ASSERT_TRUE(radio.log.size() >= 2);
+    TEST_ASSERT_EQUAL(LINK_ACTION_SCAN, radio.log[0].action.type);
+    uint8_t zero[6] = {0};
+    TEST_ASSERT_EQUAL(LINK_ACTION_CONNECT, radio.log[1].action.type);
+    TEST_ASSERT_EQUAL(0, radio.log[1].action.channel);
+    TEST_ASSERT_EQUAL_MEMORY(zero, radio.log[1].action.bssid, 6);
+    expectOnAp(radio, 1);
+    TEST_ASSERT_EQUAL(6, radio.link.channel());
+    TEST_ASSERT_EQUAL(0, radio.link.failedAttempts());
+
+    // After a drop the retry uses the BSSID and channel it learned
+    radio.ap(1)->up = false;
+    radio.runUntil(10200);
+    radio.ap(1)->up = true;
+    radio.runUntil(20000);
+    const LoggedAction* retry = radio.firstSince(10200);
+    TEST_ASSERT_NOT_NULL(retry);
+    expectConnect(retry->action, 0, 1, 6);
+    expectOnAp(radio, 1);
+    TEST_ASSERT_EQUAL(1, radio.link.reconnects());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_state_names);
+    RUN_TEST(test_rssi_history_keeps_the_latest);
+    RUN_TEST(test_boot_join_result);
+    RUN_TEST(test_drop_retries_the_same_access_point_then_scans);
+    RUN_TEST(test_backoff_doubles_up_to_the_maximum);
+    RUN_TEST(test_candidates_ranked_deduplicated_and_capped);
+    RUN_TEST(test_failures_and_the_last_good_network_shift_the_ranking);
+    RUN_TEST(test_blind_candidates_when_nothing_is_heard);
+    RUN_TEST(test_scan_and_connect_timeouts);
+    RUN_TEST(test_leaving_an_access_point_is_not_a_failure);
+    RUN_TEST(test_roam_needs_the_hysteresis_margin);
+    RUN_TEST(test_failed_roam_starts_over);
+    RUN_TEST(test_roam_scan_timeout);
+    RUN_TEST(test_scenario_access_point_reboot);
+    RUN_TEST(test_scenario_failover_to_second_network);
+    RUN_TEST(test_scenario_no_ping_pong_between_similar_access_points);
+    RUN_TEST(test_scenario_wrong_password_backs_off_to_the_maximum);
+    RUN_TEST(test_scenario_hidden_network);
+    return UNITY_END();
+}
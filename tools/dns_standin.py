@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Stand-in DNS responder
+
+Answers A queries over UDP with a fixed address so the station's resolver
+cache (src/dns_resolver.h) can be exercised without touching the real DNS:
+point DNS_SERVER in config.h at the machine running this.
+
+Each query is answered according to --mode:
+
+  - answer:   one A record
+  - cname:    a CNAME chain ending in the A record (TTLs: --ttl, --ttl * 2)
+  - nxdomain / servfail: the error
+  - silent:   no reply, as a dead server
+
+--delay adds latency to every reply. Sending SIGUSR1 cycles through the
+modes so a running test can break and repair DNS. Needs Python 3 only.
+
+Usage:
+    sudo python3 tools/dns_standin.py --address 203.0.113.7 --ttl 60 --delay 300
+    python3 tools/dns_standin.py --port 5353 --mode silent
+"""
+
+import argparse
+import signal
+import socket
+import struct
+import sys
+import time
+
+MODES = ['answer', 'cname', 'nxdomain', 'servfail', 'silent']
+
+
+def parse_question(packet):
+    """Returns (id, flags, qname labels, end of question) or None."""
+    if len(packet) < 12:
+        return None
+    qid, flags, qdcount = struct.unpack_from('>HHH', packet)
+    if qdcount != 1 or flags & 0x8000:
+        return None
+    labels, pos = [], 12
+    while pos < len(packet) and packet[pos]:
+        n = packet[pos]
+        labels.append(packet[pos + 1:pos + 1 + n])
+        pos += 1 + n
+    pos += 1 + 4
+    if pos > len(packet):
+        return None
+    return qid, flags, labels, pos
+
+
+def encode_name(labels):
+    return b''.join(bytes([len(l)]) + l for l in labels) + b'\x00'
+
+
+def build_reply(packet, mode, address, ttl):
+    parsed = parse_question(packet)
+    if parsed is None:
+        return None
+    qid, flags, labels, end = parsed
+    question = packet[12:end]
+    rcode = {'nxdomain': 3, 'servfail': 2}.get(mode, 0)
+    answers = []
+    if rcode == 0:
+        rdata = socket.inet_aton(address)
+        if mode == 'cname':
+            target = [b'edge'] + labels
+            # The question name compressed as a pointer to offset 12
+            answers.append(b'\xc0\x0c' + struct.pack('>HHIH', 5, 1, ttl * 2, len(encode_name(target))) +
+                           encode_name(target))
+            answers.append(encode_name(target) + struct.pack('>HHIH', 1, 1, ttl, 4) + rdata)
+        else:
+            answers.append(b'\xc0\x0c' + struct.pack('>HHIH', 1, 1, ttl, 4) + rdata)
+    header = struct.pack('>HHHHHH', qid, 0x8180 | (flags & 0x0100) | rcode, 1, len(answers), 0, 0)
+    return header + question + b''.join(answers)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Answer A queries with a fixed address')
+    parser.add_argument('--bind', default='0.0.0.0')
+    parser.add_argument('--port', type=int, default=53)
+    parser.add_argument('--address', default='127.0.0.1', help='address every name resolves to')
+    parser.add_argument('--ttl', type=int, default=60, help='seconds')
+    parser.add_argument('--delay', type=int, default=0, help='milliseconds before each reply')
+    parser.add_argument('--mode', choices=MODES, default='answer')
+    parser.add_argument('--count', type=int, default=0, help='exit after this many queries (0 = never)')
+    args = parser.parse_args()
+
+    state = {'mode': args.mode}
+
+    def next_mode(signum, frame):
+        state['mode'] = MODES[(MODES.index(state['mode']) + 1) % len(MODES)]
+        print(f'dns_standin: mode {state["mode"]}', file=sys.stderr, flush=True)
+
+    signal.signal(signal.SIGUSR1, next_mode)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    print(f'dns_standin: {args.bind}:{args.port} -> {args.address} ttl {args.ttl}s, '
+          f'delay {args.delay} ms, mode {state["mode"]}', file=sys.stderr, flush=True)
+
+    queries = 0
+    while args.count == 0 or queries < args.count:
+        try:
+            packet, peer = sock.recvfrom(512)
+        except InterruptedError:
+            continue
+        queries += 1
+        mode = state['mode']
+        print(f'dns_standin: query {queries} from {peer[0]}:{peer[1]} ({mode})', file=sys.stderr, flush=True)
+        if mode == 'silent':
+            continue
+        reply = build_reply(packet, mode, args.address, args.ttl)
+        if reply is None:
+            continue
+        if args.delay:
+            time.sleep(args.delay / 1000)
+        sock.sendto(reply, peer)
+
+
+if __name__ == '__main__':
+    main()
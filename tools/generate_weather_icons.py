@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""
+Weather icon registry generator
+
+Converts the OpenWeatherMap icon PNGs (include/<NN><d|n>.png) into
+include/weather_icons.h:
+
+  - 8-bit alpha masters at MASTER_SIZE pixels plus one RGB565 tint per icon;
+    sources of any size are resampled (Lanczos), so higher-resolution
+    artwork can replace a PNG without code changes
+  - pixel-identical icons (day/night pairs, 03/04) share one blob
+  - a constexpr perfect hash of (icon number, night) indexes the blob table;
+    the generator picks the smallest modulus that keeps icon numbers distinct
+
+The display scales masters to its drawing size on first use (icon_cache.h).
+
+The header is only rewritten when its content changes, so running this on
+every build does not trigger recompiles. Needs Python 3 and Pillow.
+
+Usage:
+    python3 tools/generate_weather_icons.py [--icons include] [--out include/weather_icons.h]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+try:
+    from PIL import Image
+except ImportError:
+    sys.exit("generate_weather_icons: Pillow is required (pip install pillow)")
+
+ICON_NAME_RE = re.compile(r'^(\d\d)([dn])\.png$')
+MASTER_SIZE = 64
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def load_icon(path):
+    """(alpha master bytes, RGB565 tint) - the tint is the alpha-weighted mean colour"""
+    image = Image.open(path).convert('RGBA')
+    alpha = image.getchannel('A')
+    if alpha.size != (MASTER_SIZE, MASTER_SIZE):
+        alpha = alpha.resize((MASTER_SIZE, MASTER_SIZE), Image.LANCZOS)
+
+    weight = [0, 0, 0, 0]
+    for r, g, b, a in image.getdata():
+        weight[0] += r * a
+        weight[1] += g * a
+        weight[2] += b * a
+        weight[3] += a
+    total = max(weight[3], 1)
+    tint = rgb565(*(int(round(c / total)) for c in weight[:3]))
+    return bytes(alpha.tobytes()), tint
+
+
+def find_modulus(numbers):
+    """Smallest m with distinct number % m - the hash is (number % m) * 2 + night"""
+    for m in range(1, max(numbers) + 2):
+        if len({n % m for n in numbers}) == len(numbers):
+            return m
+    raise ValueError('no perfect hash modulus')
+
+
+def format_array(values, per_line=16):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append('  ' + ', '.join('0x%02X' % v for v in values[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def generate(icon_dir):
+    icons = {}   # (number, night) -> blob index
+    blobs = []   # [(alpha, tint, [codes])]
+    by_pixels = {}
+    for name in sorted(os.listdir(icon_dir)):
+        match = ICON_NAME_RE.match(name)
+        if not match:
+            continue
+        number, night = int(match.group(1)), match.group(2) == 'n'
+        alpha, tint = load_icon(os.path.join(icon_dir, name))
+        key = (alpha, tint)
+        if key not in by_pixels:
+            by_pixels[key] = len(blobs)
+            blobs.append((alpha, tint, []))
+        blobs[by_pixels[key]][2].append(name[:3])
+        icons[(number, night)] = by_pixels[key]
+
+    if not icons:
+        raise ValueError('no icon PNGs found in %s' % icon_dir)
+
+    numbers = sorted({n for n, _ in icons})
+    modulus = find_modulus(numbers)
+    slots = modulus * 2
+    slot_key = [0] * slots
+    slot_blob = [0xFF] * slots
+    for (number, night), blob in icons.items():
+        slot = (number % modulus) * 2 + (1 if night else 0)
+        slot_key[slot] = number
+        slot_blob[slot] = blob
+
+    total_before = sum(len(alpha) for alpha, _, codes in blobs for _ in codes)
+    total_after = sum(len(alpha) for alpha, _, _ in blobs)
+
+    out = []
+    out.append('// Weather Icons - generated by tools/generate_weather_icons.py from include/*.png.')
+    out.append('// Do not edit; rerun the generator (PlatformIO reruns it when a PNG is newer than this file).')
+    out.append('// %dx%d 8-bit alpha masters with an RGB565 tint. %d icons, %d unique masters:'
+               % (MASTER_SIZE, MASTER_SIZE, len(icons), len(blobs)))
+    out.append('// %d bytes of flash, %d saved by sharing.' % (total_after, total_before - total_after))
+    out.append('')
+    out.append('#ifndef WEATHER_ICONS_H')
+    out.append('#define WEATHER_ICONS_H')
+    out.append('')
+    out.append('#ifdef ARDUINO')
+    out.append('#include <Arduino.h>')
+    out.append('#else')
+    out.append('#include <stdint.h>   // Host tests: flash and RAM are one address space')
+    out.append('#define PROGMEM')
+    out.append('#endif')
+    out.append('')
+    out.append('#define WEATHER_ICON_MASTER_SIZE %d' % MASTER_SIZE)
+    out.append('')
+    for index, (alpha, _, codes) in enumerate(blobs):
+        out.append('// %s' % ' '.join(codes))
+        out.append('static const uint8_t icon_alpha_%d[%d] PROGMEM = {' % (index, len(alpha)))
+        out.append(format_array(alpha))
+        out.append('};')
+        out.append('')
+    out.append('// Square master: size x size alpha bytes, row-major')
+    out.append('struct WeatherIcon {')
+    out.append('  const uint8_t* alpha;')
+    out.append('  uint16_t color;')
+    out.append('  uint8_t size;')
+    out.append('};')
+    out.append('')
+    out.append('static const WeatherIcon weather_icon_blobs[%d] = {' % len(blobs))
+    for index, (_, tint, _) in enumerate(blobs):
+        out.append('  {icon_alpha_%d, 0x%04X, WEATHER_ICON_MASTER_SIZE},' % (index, tint))
+    out.append('};')
+    out.append('')
+    out.append('// Perfect hash of the OWM icon number ("10n" -> 10) and the night flag')
+    out.append('#define WEATHER_ICON_HASH_MODULUS %d' % modulus)
+    out.append('#define WEATHER_ICON_HASH_SLOTS %d' % slots)
+    out.append('')
+    out.append('constexpr uint8_t weatherIconSlot(uint8_t number, bool night) {')
+    out.append('  return (uint8_t)((number % WEATHER_ICON_HASH_MODULUS) * 2 + (night ? 1 : 0));')
+    out.append('}')
+    out.append('')
+    out.append('// Icon number owning each slot (0 = empty), to reject numbers that merely collide')
+    out.append('static const uint8_t weather_icon_slot_key[WEATHER_ICON_HASH_SLOTS] = {')
+    out.append('  ' + ', '.join(str(k) for k in slot_key))
+    out.append('};')
+    out.append('')
+    out.append('static const uint8_t weather_icon_slot_blob[WEATHER_ICON_HASH_SLOTS] = {')
+    out.append('  ' + ', '.join(str(b) for b in slot_blob))
+    out.append('};')
+    out.append('')
+    out.append('// Icon for an OWM icon number and day/night variant, nullptr if there is none')
+    out.append('inline const WeatherIcon* getWeatherIcon(uint8_t number, bool night) {')
+    out.append('  uint8_t slot = weatherIconSlot(number, night);')
+    out.append('  if (number == 0 || weather_icon_slot_key[slot] != number) {')
+    out.append('    return nullptr;')
+    out.append('  }')
+    out.append('  return &weather_icon_blobs[weather_icon_slot_blob[slot]];')
+    out.append('}')
+    out.append('')
+    out.append('#endif // WEATHER_ICONS_H')
+    out.append('')
+    return '\n'.join(out), len(icons), len(blobs), total_before - total_after
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--icons', default=os.path.join(root, 'include'), help='directory with the icon PNGs')
+    parser.add_argument('--out', default=os.path.join(root, 'include', 'weather_icons.h'))
+    args = parser.parse_args()
+
+    text, icons, blobs, saved = generate(args.icons)
+    try:
+        with open(args.out) as f:
+            if f.read() == text:
+                return 0
+    except FileNotFoundError:
+        pass
+    with open(args.out, 'w') as f:
+        f.write(text)
+    print('generate_weather_icons: %d icons, %d unique masters, %d bytes saved -> %s'
+          % (icons, blobs, saved, os.path.relpath(args.out)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
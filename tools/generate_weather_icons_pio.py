@@ -0,0 +1,36 @@
+"""
+PlatformIO pre-build hook for tools/generate_weather_icons.py
+
+Regenerates include/weather_icons.h from the icon PNGs when a PNG (or the
+generator) is newer than the header. The header is checked in, so a build
+without Pillow warns and keeps it; only a missing header stops the build.
+"""
+
+Import("env")
+
+import glob
+import os
+import subprocess
+
+project = env.subst("$PROJECT_DIR")
+script = os.path.join(project, "tools", "generate_weather_icons.py")
+header = os.path.join(project, "include", "weather_icons.h")
+sources = glob.glob(os.path.join(project, "include", "[0-9][0-9][dn].png")) + [script]
+
+have_header = os.path.isfile(header)
+stale = not have_header or any(os.path.getmtime(s) > os.path.getmtime(header) for s in sources)
+
+if stale:
+    python = env.subst("$PYTHONEXE")
+    if subprocess.run([python, "-c", "import PIL"], capture_output=True).returncode == 0:
+        if subprocess.run([python, script]).returncode != 0:
+            env.Exit(1)
+        # The generator leaves identical output alone; mark it current anyway
+        os.utime(header, None)
+    elif have_header:
+        print("generate_weather_icons: Pillow not installed, keeping the checked-in "
+              "include/weather_icons.h (pip install pillow to regenerate)")
+    else:
+        print("generate_weather_icons: include/weather_icons.h is missing and Pillow is "
+              "not installed (pip install pillow)")
+        env.Exit(1)
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+Icon scaling reference generator
+
+Writes test/test_icon_cache/scale_reference.h, the expected output of
+scaleAlphaArea() (src/icon_cache.cpp) for the host tests:
+
+  - a small synthetic master at several sizes, byte for byte
+  - every master in include/weather_icons.h at the drawing sizes, as an
+    FNV-1a hash of the scaled image plus its centre pixel
+
+The reference is computed with exact fractions: each destination pixel is
+the area-weighted mean of the source pixels it covers, rounded half up.
+Needs Python 3 only.
+
+Usage:
+    python3 tools/icon_scale_reference.py [--out test/test_icon_cache/scale_reference.h]
+"""
+
+import argparse
+import os
+import re
+from fractions import Fraction
+
+SYNTHETIC_SIZE = 8
+SYNTHETIC_TARGETS = [1, 3, 5, 7, 8, 12]
+MASTER_TARGETS = [16, 24, 32, 40, 48, 64]
+
+
+def synthetic_master():
+    # Edges, a gradient and isolated extremes, so rounding shows up
+    size = SYNTHETIC_SIZE
+    return [((x * 37 + y * 11) % 256) if (x + y) % 5 else (255 if x < y else 0)
+            for y in range(size) for x in range(size)]
+
+
+def scale(src, src_size, dst_size):
+    step = Fraction(src_size, dst_size)   # Source pixels per destination pixel
+    out = []
+    for dy in range(dst_size):
+        y0, y1 = dy * step, (dy + 1) * step
+        for dx in range(dst_size):
+            x0, x1 = dx * step, (dx + 1) * step
+            total = Fraction(0)
+            for sy in range(int(y0), min(src_size, -(-y1.numerator // y1.denominator))):
+                h = min(y1, sy + 1) - max(y0, sy)
+                if h <= 0:
+                    continue
+                for sx in range(int(x0), min(src_size, -(-x1.numerator // x1.denominator))):
+                    w = min(x1, sx + 1) - max(x0, sx)
+                    if w > 0:
+                        total += src[sy * src_size + sx] * w * h
+            mean = total / (step * step)
+            out.append(int(mean + Fraction(1, 2)))   # Half up
+    return out
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def load_masters(header):
+    masters = []
+    with open(header) as f:
+        text = f.read()
+    size = int(re.search(r'#define WEATHER_ICON_MASTER_SIZE (\d+)', text).group(1))
+    for match in re.finditer(r'static const uint8_t icon_alpha_(\d+)\[\d+\] PROGMEM = \{(.*?)\};', text, re.S):
+        masters.append([int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{2})', match.group(2))])
+    return masters, size
+
+
+def c_array(values, indent='        '):
+    lines = []
+    for i in range(0, len(values), 16):
+        lines.append(indent + ', '.join('%d' % v for v in values[i:i + 16]) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description='Generate the icon scaling reference for the host tests')
+    parser.add_argument('--icons', default=os.path.join(root, 'include', 'weather_icons.h'))
+    parser.add_argument('--out', default=os.path.join(root, 'test', 'test_icon_cache', 'scale_reference.h'))
+    args = parser.parse_args()
+
+    synthetic = synthetic_master()
+    masters, master_size = load_masters(args.icons)
+
+    out = [
+        '// Generated by tools/icon_scale_reference.py - do not edit.',
+        '// Exact area-average reference for scaleAlphaArea(), rounded half up.',
+        '',
+        '#ifndef SCALE_REFERENCE_H',
+        '#define SCALE_REFERENCE_H',
+        '',
+        '#include <stdint.h>',
+        '',
+        '#define SYNTHETIC_SIZE %d' % SYNTHETIC_SIZE,
+        '',
+        'static const uint8_t SYNTHETIC_MASTER[%d] = {' % len(synthetic),
+        c_array(synthetic, '    '),
+        '};',
+        '',
+        'struct ScaledReference {',
+        '    uint8_t size;',
+        '    uint8_t pixels[%d];' % (max(SYNTHETIC_TARGETS) ** 2),
+        '};',
+        '',
+        'static const ScaledReference SYNTHETIC_SCALED[] = {',
+    ]
+    for size in SYNTHETIC_TARGETS:
+        out.append('    {%d, {' % size)
+        out.append(c_array(scale(synthetic, SYNTHETIC_SIZE, size)))
+        out.append('    }},')
+    out += [
+        '};',
+        '',
+        '// include/weather_icons.h masters (%dx%d) at the drawing sizes' % (master_size, master_size),
+        'struct MasterReference {',
+        '    uint8_t master;     // Index into weather_icon_blobs',
+        '    uint8_t size;',
+        '    uint32_t fnv1a;     // Hash of the scaled size x size bytes',
+        '    uint8_t centre;     // Pixel (size / 2, size / 2)',
+        '};',
+        '',
+        'static const MasterReference MASTER_SCALED[] = {',
+    ]
+    for index, master in enumerate(masters):
+        for size in MASTER_TARGETS:
+            scaled = scale(master, master_size, size)
+            out.append('    {%d, %d, 0x%08Xu, %d},' % (index, size, fnv1a(scaled),
+                                                      scaled[(size // 2) * size + size // 2]))
+    out += ['};', '', '#endif // SCALE_REFERENCE_H', '']
+
+    os.makedirs(os.path.dirname(args.out), exist_ok=True)
+    with open(args.out, 'w') as f:
+        f.write('\n'.join(out))
+    print('icon_scale_reference: %d masters -> %s' % (len(masters), os.path.relpath(args.out)))
+
+
+if __name__ == '__main__':
+    main()
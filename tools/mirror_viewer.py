@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""
+Screen mirror viewer
+
+Rebuilds the station's display from the packets FrameMirror streams
+(src/frame_mirror.h, wire format in src/mirror_codec.h) and saves PNGs:
+
+  - TCP (MIRROR_TRANSPORT=MIRROR_TCP): connects to the station on port 5005
+  - serial (MIRROR_TRANSPORT=MIRROR_SERIAL): packets are picked out of the
+    log stream by their magic and checksum; the log text is echoed
+  - file: replays a capture of either stream
+
+Images are only saved once a full refresh has arrived and no frame was
+lost since; a gap waits for the next refresh. Needs Python 3 and Pillow
+(pyserial for --serial).
+
+Usage:
+    python3 tools/mirror_viewer.py --tcp 192.168.1.50 --out shots
+    python3 tools/mirror_viewer.py --serial /dev/ttyACM0 --once --out shots
+"""
+
+import argparse
+import os
+import socket
+import struct
+import sys
+
+try:
+    from PIL import Image
+except ImportError:
+    sys.exit("mirror_viewer: Pillow is required (pip install pillow)")
+
+MAGIC = b'WM'
+VERSION = 1
+HEADER = struct.Struct('<2sBBHHIIH')
+RECORD = struct.Struct('<HHH')
+FLAG_KEYFRAME = 0x01
+FLAG_PARTIAL = 0x02
+MAX_PAYLOAD = 1 << 20
+
+
+def fletcher16(data):
+    a = b = 0
+    for byte in data:
+        a = (a + byte) % 255
+        b = (b + a) % 255
+    return (b << 8) | a
+
+
+class PacketParser:
+    """Splits a byte stream into verified packets; anything else is passed to on_text."""
+
+    def __init__(self, on_text=None):
+        self.buf = bytearray()
+        self.on_text = on_text
+
+    def _skip(self, n):
+        if self.on_text and n > 0:
+            self.on_text(bytes(self.buf[:n]))
+        del self.buf[:n]
+
+    def feed(self, data):
+        self.buf += data
+        packets = []
+        while True:
+            start = self.buf.find(MAGIC)
+            if start < 0:
+                # Keep a trailing 'W' that may start the next magic
+                self._skip(len(self.buf) - (1 if self.buf.endswith(b'W') else 0))
+                return packets
+            self._skip(start)
+            if len(self.buf) < HEADER.size:
+                return packets
+            _, version, _, _, _, _, payload, _ = HEADER.unpack_from(self.buf)
+            if version != VERSION or payload > MAX_PAYLOAD:
+                self._skip(1)
+                continue
+            total = HEADER.size + payload + 2
+            if len(self.buf) < total:
+                return packets
+            body = bytes(self.buf[:HEADER.size + payload])
+            checksum, = struct.unpack_from('<H', self.buf, HEADER.size + payload)
+            if checksum != fletcher16(body):
+                self._skip(1)  # Log text that happened to contain the magic
+                continue
+            packets.append(body)
+            del self.buf[:total]
+
+
+class Screen:
+    """Frame buffer in wire byte order (big-endian RGB565)."""
+
+    def __init__(self):
+        self.width = self.height = 0
+        self.pixels = bytearray()
+        self.synced = False
+        self.next_frame = None
+
+    def apply(self, packet):
+        """Apply one packet; returns True when the screen holds a complete frame."""
+        _, _, flags, width, height, frame, payload, records = HEADER.unpack_from(packet)
+        if (width, height) != (self.width, self.height):
+            self.width, self.height = width, height
+            self.pixels = bytearray(width * height * 2)
+            self.synced = False
+        if flags & FLAG_KEYFRAME:
+            self.synced = True
+        elif frame != self.next_frame:
+            self.synced = False  # Lost a packet; wait for the next refresh
+        self.next_frame = (frame + 1) & 0xFFFFFFFF
+
+        pos = HEADER.size
+        for _ in range(records):
+            y, x, count = RECORD.unpack_from(packet, pos)
+            pos += RECORD.size
+            if y >= height or x + count > width:
+                raise ValueError('record outside the screen')
+            dst = (y * width + x) * 2
+            while count > 0:
+                op = packet[pos]
+                pos += 1
+                n = (op & 0x7F) + 1
+                if n > count:
+                    raise ValueError('run longer than its record')
+                if op & 0x80:
+                    data = packet[pos:pos + 2] * n
+                    pos += 2
+                else:
+                    data = packet[pos:pos + 2 * n]
+                    pos += 2 * n
+                self.pixels[dst:dst + 2 * n] = data
+                dst += 2 * n
+                count -= n
+        if pos != HEADER.size + payload:
+            raise ValueError('payload length mismatch')
+        return self.synced and not flags & FLAG_PARTIAL
+
+    def image(self):
+        rgb = bytearray(self.width * self.height * 3)
+        for i in range(self.width * self.height):
+            c = (self.pixels[2 * i] << 8) | self.pixels[2 * i + 1]
+            r, g, b = (c >> 11) & 0x1F, (c >> 5) & 0x3F, c & 0x1F
+            rgb[3 * i] = (r << 3) | (r >> 2)
+            rgb[3 * i + 1] = (g << 2) | (g >> 4)
+            rgb[3 * i + 2] = (b << 3) | (b >> 2)
+        return Image.frombytes('RGB', (self.width, self.height), bytes(rgb))
+
+
+def open_source(args):
+    if args.tcp:
+        host, _, port = args.tcp.partition(':')
+        sock = socket.create_connection((host, int(port or 5005)))
+        return lambda: sock.recv(65536)
+    if args.serial:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("mirror_viewer: pyserial is required for --serial (pip install pyserial)")
+        port = serial.Serial(args.serial, args.baud, timeout=0.5)
+        return lambda: port.read(4096)
+    f = open(args.file, 'rb')
+    return lambda: f.read(65536)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Rebuild and save the station screen from the mirror stream')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--tcp', metavar='HOST[:PORT]', help='station address (MIRROR_TCP)')
+    source.add_argument('--serial', metavar='PORT', help='serial port (MIRROR_SERIAL)')
+    source.add_argument('--file', help='replay a captured stream')
+    parser.add_argument('--baud', type=int, default=921600, help='MIRROR_SERIAL_BAUD')
+    parser.add_argument('--out', default='mirror', help='directory for the PNGs')
+    parser.add_argument('--once', action='store_true', help='save the first complete frame and exit')
+    parser.add_argument('--quiet', action='store_true', help='do not echo serial log text')
+    args = parser.parse_args()
+
+    read = open_source(args)
+    echo = None
+    if args.serial and not args.quiet:
+        echo = lambda text: sys.stdout.write(text.decode('utf-8', 'replace'))
+    packets = PacketParser(echo)
+    screen = Screen()
+    os.makedirs(args.out, exist_ok=True)
+
+    saved = 0
+    while True:
+        data = read()
+        if not data and not args.serial:
+            break
+        for packet in packets.feed(data):
+            try:
+                complete = screen.apply(packet)
+            except (ValueError, IndexError, struct.error) as e:
+                print(f'mirror_viewer: bad packet ({e}), resyncing', file=sys.stderr)
+                screen.synced = False
+                continue
+            if not complete:
+                continue
+            path = os.path.join(args.out, f'frame_{screen.next_frame - 1:06d}.png')
+            screen.image().save(path)
+            saved += 1
+            print(f'saved {path}', file=sys.stderr)
+            if args.once:
+                return
+    print(f'mirror_viewer: {saved} frames saved', file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
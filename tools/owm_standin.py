@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Stand-in OpenWeatherMap server
+
+Serves a fixed current-weather response over plain HTTP with the plan's
+rate limits applied, so the station's request budget (src/api_budget.h) can
+be watched against a server that actually says no: point
+OPENWEATHERMAP_API_ENDPOINT in secrets.h at http://<this machine>:8080/data/2.5/weather.
+
+Requests over --per-minute in the last 60 seconds, or --per-day since UTC
+midnight, get 429. --retry-after picks what the 429 carries:
+
+  - seconds: Retry-After: <seconds until a request would succeed>
+  - date:    the same as an HTTP date
+  - none:    no header, leaving the station to back off on its own
+
+--fail-every N answers every Nth request with 429 regardless, as a server
+enforcing a limit lower than the station believes. Needs Python 3 only.
+
+Usage:
+    python3 tools/owm_standin.py --per-minute 60 --per-day 1000
+    python3 tools/owm_standin.py --per-minute 2 --retry-after none
+"""
+
+import argparse
+import collections
+import email.utils
+import json
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, HTTPServer
+
+RESPONSE = {
+    'coord': {'lon': -0.1257, 'lat': 51.5085},
+    'weather': [{'id': 803, 'main': 'Clouds', 'description': 'broken clouds', 'icon': '04d'}],
+    'main': {'temp': 14.2, 'feels_like': 13.6, 'temp_min': 12.9, 'temp_max': 15.4,
+             'pressure': 1014, 'humidity': 77},
+    'visibility': 10000,
+    'wind': {'speed': 4.6, 'deg': 240},
+    'clouds': {'all': 75},
+    'sys': {'sunrise': 0, 'sunset': 0},
+    'name': 'Stand-in',
+}
+
+
+class Limits:
+    def __init__(self, per_minute, per_day, fail_every):
+        self.per_minute = per_minute
+        self.per_day = per_day
+        self.fail_every = fail_every
+        self.recent = collections.deque()
+        self.day = None
+        self.day_count = 0
+        self.requests = 0
+
+    def check(self, now):
+        """Returns 0 when the request may be served, else seconds until one may."""
+        self.requests += 1
+        day = int(now // 86400)
+        if day != self.day:
+            self.day, self.day_count = day, 0
+        while self.recent and self.recent[0] + 60 <= now:
+            self.recent.popleft()
+        if self.fail_every and self.requests % self.fail_every == 0:
+            return 60
+        if len(self.recent) >= self.per_minute:
+            return max(1, int(self.recent[0] + 60 - now + 0.999))
+        if self.day_count >= self.per_day:
+            return (day + 1) * 86400 - int(now)
+        self.recent.append(now)
+        self.day_count += 1
+        return 0
+
+
+def make_handler(limits, retry_after):
+    class Handler(BaseHTTPRequestHandler):
+        def do_GET(self):
+            now = time.time()
+            wait = limits.check(now)
+            if wait:
+                body = b'{"cod":429,"message":"Your account is temporary blocked due to exceeding of requests limitation"}'
+                self.send_response(429)
+                if retry_after == 'seconds':
+                    self.send_header('Retry-After', str(wait))
+                elif retry_after == 'date':
+                    self.send_header('Retry-After', email.utils.formatdate(now + wait, usegmt=True))
+            else:
+                data = dict(RESPONSE, dt=int(now))
+                data['sys'] = {'sunrise': int(now) - 6 * 3600, 'sunset': int(now) + 6 * 3600}
+                body = json.dumps(data).encode()
+                self.send_response(200)
+            self.send_header('Content-Type', 'application/json')
+            self.send_header('Content-Length', str(len(body)))
+            self.send_header('Connection', 'close')
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, fmt, *args):
+            print(f'owm_standin: {self.address_string()} {fmt % args} '
+                  f'(minute {len(limits.recent)}/{limits.per_minute}, day {limits.day_count}/{limits.per_day})',
+                  file=sys.stderr, flush=True)
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Rate-limited stand-in for the current weather API')
+    parser.add_argument('--bind', default='0.0.0.0')
+    parser.add_argument('--port', type=int, default=8080)
+    parser.add_argument('--per-minute', type=int, default=60)
+    parser.add_argument('--per-day', type=int, default=1000)
+    parser.add_argument('--retry-after', choices=['seconds', 'date', 'none'], default='seconds')
+    parser.add_argument('--fail-every', type=int, default=0, help='429 every Nth request (0 = never)')
+    args = parser.parse_args()
+
+    limits = Limits(args.per_minute, args.per_day, args.fail_every)
+    server = HTTPServer((args.bind, args.port), make_handler(limits, args.retry_after))
+    print(f'owm_standin: http://{args.bind}:{args.port}/ {args.per_minute}/min {args.per_day}/day, '
+          f'Retry-After {args.retry_after}', file=sys.stderr, flush=True)
+    server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
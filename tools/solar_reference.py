@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+Solar reference table generator
+
+Writes test/test_solar/solar_reference.h, the expected sunrise, sunset,
+solar noon and civil twilight times the host tests hold src/solar.cpp to.
+
+The reference follows the NOAA Solar Calculator spreadsheet (Julian
+centuries, geometric mean longitude and anomaly, equation of center,
+apparent longitude, obliquity correction, equation of time) in double
+precision. Unlike the firmware, which solves the hour angle in closed form,
+it bisects the solar zenith angle at each instant for the moment it crosses
+90.833 degrees (sunrise/sunset) or 96 degrees (civil twilight), so it shares
+no approximation with the code under test beyond the NOAA sun position.
+
+Each row is the solar day whose noon is nearest the row's local noon input,
+matching solarEventTimes(). Needs Python 3 only.
+
+Usage:
+    python3 tools/solar_reference.py [--out test/test_solar/solar_reference.h]
+"""
+
+import argparse
+import calendar
+import math
+import os
+
+J2000 = 946728000          # 2000-01-01 12:00 UTC
+SUNRISE_ZENITH = 90.833
+CIVIL_ZENITH = 96.0
+
+# name, latitude, longitude, UTC offset of local noon (hours)
+LOCATIONS = [
+    ('London', 51.5074, -0.1278, 0),
+    ('New York', 40.7128, -74.0060, -5),
+    ('Sydney', -33.8688, 151.2093, 10),
+    ('Quito', -0.1807, -78.4678, -5),
+    ('Singapore', 1.3521, 103.8198, 8),
+    ('Honolulu', 21.3069, -157.8583, -10),
+    ('Auckland', -36.8485, 174.7633, 12),
+    ('Cape Town', -33.9249, 18.4241, 2),
+    ('Anchorage', 61.2181, -149.9003, -9),
+    ('Reykjavik', 64.1466, -21.9426, 0),
+    ('Tromso', 69.6492, 18.9553, 1),
+    ('McMurdo', -77.8419, 166.6863, 12),
+]
+
+DATES = [
+    (2024, 1, 15), (2024, 3, 20), (2024, 6, 21), (2024, 9, 22),
+    (2024, 12, 21), (2025, 2, 28), (2026, 5, 5), (2027, 8, 1),
+    (2029, 11, 11), (2032, 2, 29), (2037, 10, 17),
+]
+
+
+def sun_position(epoch):
+    """Declination (radians) and equation of time (minutes) at a UTC epoch."""
+    jc = (epoch - J2000) / (86400.0 * 36525.0)
+    mean_long = math.fmod(280.46646 + jc * (36000.76983 + jc * 0.0003032), 360.0)
+    mean_anom = 357.52911 + jc * (35999.05029 - 0.0001537 * jc)
+    eccent = 0.016708634 - jc * (0.000042037 + 0.0000001267 * jc)
+    m = math.radians(mean_anom)
+    center = (math.sin(m) * (1.914602 - jc * (0.004817 + 0.000014 * jc))
+              + math.sin(2 * m) * (0.019993 - 0.000101 * jc)
+              + math.sin(3 * m) * 0.000289)
+    omega = math.radians(125.04 - 1934.136 * jc)
+    apparent_long = math.radians(mean_long + center - 0.00569 - 0.00478 * math.sin(omega))
+    mean_obliq = 23 + (26 + (21.448 - jc * (46.815 + jc * (0.00059 - jc * 0.001813))) / 60) / 60
+    obliq = math.radians(mean_obliq + 0.00256 * math.cos(omega))
+    declination = math.asin(math.sin(obliq) * math.sin(apparent_long))
+    y = math.tan(obliq / 2) ** 2
+    l0 = math.radians(mean_long)
+    eq_time = 4 * math.degrees(y * math.sin(2 * l0) - 2 * eccent * math.sin(m)
+                               + 4 * eccent * y * math.sin(m) * math.cos(2 * l0)
+                               - 0.5 * y * y * math.sin(4 * l0)
+                               - 1.25 * eccent * eccent * math.sin(2 * m))
+    return declination, eq_time
+
+
+def zenith_at(latitude, longitude, epoch):
+    """Solar zenith angle in degrees, from the true solar time at the instant."""
+    declination, eq_time = sun_position(epoch)
+    minutes = (epoch % 86400) / 60.0
+    true_solar = math.fmod(minutes + eq_time + 4 * longitude, 1440.0)
+    ha = math.radians(true_solar / 4 - 180)
+    lat = math.radians(latitude)
+    cos_z = math.sin(lat) * math.sin(declination) + math.cos(lat) * math.cos(declination) * math.cos(ha)
+    return math.degrees(math.acos(max(-1.0, min(1.0, cos_z))))
+
+
+def solar_noon(longitude, near):
+    mean_noon = near - near % 86400 + (720 - 4 * longitude) * 60
+    if mean_noon - near > 43200:
+        mean_noon -= 86400
+    elif near - mean_noon > 43200:
+        mean_noon += 86400
+    t = mean_noon
+    for _ in range(20):
+        t = mean_noon - sun_position(t)[1] * 60
+    return t
+
+
+def event(latitude, longitude, noon, zenith, sign):
+    """Bisect for the crossing between noon and the midnight on that side, None if there is none."""
+    def above(t):
+        return zenith_at(latitude, longitude, t) < zenith
+    lo, hi = noon, noon + sign * 43200
+    if above(lo) == above(hi):
+        return None
+    for _ in range(60):
+        mid = (lo + hi) / 2
+        if above(mid) == above(lo):
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+
+def day(latitude, longitude, near):
+    noon = solar_noon(longitude, near)
+    rise = event(latitude, longitude, noon, SUNRISE_ZENITH, -1)
+    sset = event(latitude, longitude, noon, SUNRISE_ZENITH, 1)
+    if rise is None or sset is None:
+        above = zenith_at(latitude, longitude, noon) < SUNRISE_ZENITH
+        day_type = 'SOLAR_DAY_POLAR_DAY' if above else 'SOLAR_DAY_POLAR_NIGHT'
+        rise = sset = None
+    else:
+        day_type = 'SOLAR_DAY_NORMAL'
+    dawn = event(latitude, longitude, noon, CIVIL_ZENITH, -1)
+    dusk = event(latitude, longitude, noon, CIVIL_ZENITH, 1)
+    if dawn is None or dusk is None:
+        dawn = dusk = None
+    return day_type, dawn, rise, noon, sset, dusk
+
+
+def fmt(t):
+    return '0' if t is None else '%du' % round(t)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate the solar reference table for the host tests')
+    parser.add_argument('--out', default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                      '..', 'test', 'test_solar', 'solar_reference.h'))
+    args = parser.parse_args()
+
+    rows = []
+    for name, lat, lon, offset in LOCATIONS:
+        for y, mo, d in DATES:
+            near = calendar.timegm((y, mo, d, 12, 0, 0)) - offset * 3600
+            day_type, dawn, rise, noon, sset, dusk = day(lat, lon, near)
+            rows.append('    {"%s %04d-%02d-%02d", %.4ff, %.4ff, %du, %s, %s, %s, %s, %s, %s},'
+                        % (name, y, mo, d, lat, lon, near, day_type,
+                           fmt(dawn), fmt(rise), fmt(noon), fmt(sset), fmt(dusk)))
+
+    text = '\n'.join([
+        '// Generated by tools/solar_reference.py - do not edit.',
+        '// NOAA Solar Calculator sun position in double precision, events found by bisection.',
+        '',
+        '#ifndef SOLAR_REFERENCE_H',
+        '#define SOLAR_REFERENCE_H',
+        '',
+        '#include <stdint.h>',
+        '#include "solar.h"',
+        '',
+        'struct SolarReference {',
+        '    const char* name;',
+        '    float latitude;',
+        '    float longitude;',
+        '    uint32_t localNoon;   // Input: noon of the local calendar day',
+        '    uint8_t dayType;',
+        '    uint32_t dawn;        // UTC epochs, 0 = none',
+        '    uint32_t sunrise;',
+        '    uint32_t noon;',
+        '    uint32_t sunset;',
+        '    uint32_t dusk;',
+        '};',
+        '',
+        'static const SolarReference SOLAR_REFERENCE[] = {',
+    ] + rows + [
+        '};',
+        '',
+        '#endif // SOLAR_REFERENCE_H',
+        '',
+    ])
+    os.makedirs(os.path.dirname(args.out), exist_ok=True)
+    with open(args.out, 'w') as f:
+        f.write(text)
+    print('solar_reference: %d rows -> %s' % (len(rows), os.path.relpath(args.out)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,317 @@
+#!/usr/bin/env python3
+"""
+Static worst-case stack analysis for the weather station firmware
+
+Combines GCC's per-function frame sizes (-fstack-usage .su files) with the
+call graph disassembled from the linked ELF (objdump) and computes the
+worst-case stack depth for each entry point (setup, loop, task entry
+functions). Frames over a threshold are flagged and the run fails when an
+entry point exceeds its configured budget.
+
+Runs on Linux with nothing but Python 3 and a binutils objdump: the
+PlatformIO Xtensa toolchain for the firmware, or the host objdump for
+host builds.
+
+Usage:
+    python3 tools/stack_analysis.py --build-dir .pio/build/stack-analysis \\
+        --elf .pio/build/stack-analysis/firmware.elf \\
+        --objdump xtensa-esp32s3-elf-objdump \\
+        --entry loopTask=8192 --entry setup --entry loop
+
+    Add --mermaid to print the call graph reachable from the entry points.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+# Direct calls: Xtensa call0/4/8/12, x86/ARM call/bl. Tail calls: x86 jmp, Xtensa j.
+CALL_RE = re.compile(r'\s(call(?:0|4|8|12)?q?|bl|jmp|j)\s+[0-9a-f]+\s+<(.+)>\s*$')
+# Indirect calls: Xtensa callx*, x86 call *reg, ARM blx reg
+INDIRECT_RE = re.compile(r'\s(callx(?:0|4|8|12)|callq?\s+\*|blx\s+r)')
+FUNC_HEADER_RE = re.compile(r'^[0-9a-f]+ <(.+)>:\s*$')
+
+
+def strip_clone_suffix(name):
+    """Drop GCC clone decorations: 'f(int) [clone .constprop.0]', 'f.part.0'"""
+    name = re.sub(r'\s*\[clone [^\]]+\]', '', name)
+    name = re.sub(r'\.(constprop|isra|part|cold|lto_priv)\.\d+', '', name)
+    return name.strip()
+
+
+def normalize_signature(name):
+    """Reduce a .su or demangled objdump name to 'qualified::name(params)'
+
+    .su entries carry the return type ('bool WeatherAPI::getData(...)'),
+    objdump -C does not. Strip everything before the function name.
+    """
+    name = strip_clone_suffix(name)
+    depth = 0
+    paren = -1
+    for i, ch in enumerate(name):
+        if ch == '<':
+            depth += 1
+        elif ch == '>':
+            depth -= 1
+        elif ch == '(' and depth == 0:
+            # 'operator()' has its own parentheses before the parameter list
+            if name[max(0, i - 8):i].endswith('operator') and name[i:i + 2] == '()':
+                continue
+            paren = i
+            break
+    if paren < 0:
+        return name
+    head, params = name[:paren], name[paren:]
+    depth = 0
+    start = 0
+    for i in range(len(head) - 1, -1, -1):
+        ch = head[i]
+        if ch == '>':
+            depth += 1
+        elif ch == '<':
+            depth -= 1
+        elif ch == ' ' and depth == 0 and not head[:i].endswith('operator'):
+            start = i + 1
+            break
+    return head[start:] + re.sub(r'\s+const$', '', params)
+
+
+def bare_name(signature):
+    """'Foo::bar(int)' -> 'Foo::bar' for fallback matching"""
+    paren = signature.find('(')
+    return signature if paren < 0 else signature[:paren]
+
+
+def parse_stack_usage(build_dir):
+    """Collect frame sizes from every .su file under build_dir
+
+    Returns {signature: (bytes, qualifier, location)}. 'dynamic' frames
+    (alloca/VLA) are kept but flagged by the report.
+    """
+    frames = {}
+    for root, _dirs, files in os.walk(build_dir):
+        for file in files:
+            if not file.endswith('.su'):
+                continue
+            with open(os.path.join(root, file), 'r', encoding='utf-8', errors='replace') as f:
+                for line in f:
+                    parts = line.rstrip('\n').split('\t')
+                    if len(parts) < 3:
+                        continue
+                    # file:line:col:function
+                    loc_and_name = parts[0].split(':', 3)
+                    if len(loc_and_name) < 4:
+                        continue
+                    location = ':'.join(loc_and_name[:2])
+                    signature = normalize_signature(loc_and_name[3])
+                    size = int(parts[1])
+                    # Keep the largest if a name appears twice (static helpers in several TUs)
+                    if signature not in frames or frames[signature][0] < size:
+                        frames[signature] = (size, parts[2], location)
+    return frames
+
+
+def parse_call_graph(elf, objdump):
+    """Disassemble the ELF and return ({caller: set(callees)}, set(indirect callers))"""
+    try:
+        output = subprocess.run([objdump, '-d', '-C', '--no-show-raw-insn', elf],
+                                check=True, capture_output=True, text=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f"Error running {objdump}: {e}")
+        sys.exit(2)
+
+    calls = defaultdict(set)
+    indirect = set()
+    current = None
+    for line in output.splitlines():
+        header = FUNC_HEADER_RE.match(line)
+        if header:
+            current = normalize_signature(header.group(1))
+            calls.setdefault(current, set())
+            continue
+        if current is None:
+            continue
+        match = CALL_RE.search(line)
+        if match:
+            target = match.group(2)
+            if '+0x' in target or '-0x' in target:
+                continue  # Branch inside a function, not a call
+            callee = normalize_signature(target)
+            if callee != current or match.group(1).startswith('call'):
+                calls[current].add(callee)
+        elif INDIRECT_RE.search(line):
+            indirect.add(current)
+    return calls, indirect
+
+
+class StackAnalyzer:
+    """Worst-case stack depth over the call graph, memoized per function"""
+
+    def __init__(self, frames, calls, indirect):
+        self.frames = frames
+        self.calls = calls
+        self.indirect = indirect
+        self.by_bare = defaultdict(list)
+        for signature in frames:
+            self.by_bare[bare_name(signature)].append(signature)
+        self.memo = {}
+        self.unknown = set()
+        self.recursive = set()
+
+    def frame(self, function):
+        if function in self.frames:
+            return self.frames[function][0]
+        candidates = self.by_bare.get(bare_name(function), [])
+        if len(candidates) == 1:
+            return self.frames[candidates[0]][0]
+        self.unknown.add(function)
+        return 0
+
+    def resolve(self, name):
+        """Map an entry point given on the command line to a graph node"""
+        if name in self.calls:
+            return name
+        matches = [f for f in self.calls if bare_name(f) == name]
+        return matches[0] if matches else None
+
+    def worst(self, function, stack=()):
+        """Return (depth, path) of the deepest call chain starting at function"""
+        if function in self.memo:
+            return self.memo[function]
+        if function in stack:
+            self.recursive.add(function)
+            return 0, []
+        best_depth, best_path = 0, []
+        for callee in self.calls.get(function, ()):
+            depth, path = self.worst(callee, stack + (function,))
+            if depth > best_depth:
+                best_depth, best_path = depth, path
+        result = (self.frame(function) + best_depth, [function] + best_path)
+        self.memo[function] = result
+        return result
+
+    def reachable(self, roots):
+        seen = set()
+        pending = list(roots)
+        while pending:
+            function = pending.pop()
+            if function in seen:
+                continue
+            seen.add(function)
+            pending.extend(self.calls.get(function, ()))
+        return seen
+
+
+def generate_mermaid_graph(analyzer, functions):
+    """Generate a Mermaid flowchart of the reachable call graph with frame sizes"""
+    print("```mermaid")
+    print("graph TD")
+    node_id = {func: f"F{i}" for i, func in enumerate(sorted(functions))}
+    for func, node in node_id.items():
+        label = bare_name(func).replace('"', "'")
+        print(f'    {node}["{label} ({analyzer.frame(func)} B)"]')
+    for caller in sorted(functions):
+        for callee in sorted(analyzer.calls.get(caller, ())):
+            if callee in node_id:
+                print(f"    {node_id[caller]} --> {node_id[callee]}")
+    print("```")
+
+
+def parse_entry(spec):
+    """'loopTask=8192' -> ('loopTask', 8192); 'setup' -> ('setup', None)"""
+    name, _, budget = spec.partition('=')
+    return name.strip(), int(budget) if budget else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Worst-case stack analysis from .su files and objdump")
+    parser.add_argument('--build-dir', required=True, help="Directory searched for .su files")
+    parser.add_argument('--elf', required=True, help="Linked firmware ELF")
+    parser.add_argument('--objdump', default='objdump', help="objdump matching the ELF's architecture")
+    parser.add_argument('--entry', action='append', default=[],
+                        help="Entry point, optionally with a budget in bytes: loopTask=8192")
+    parser.add_argument('--frame-warn', type=int, default=1024, help="Flag single frames at or above this size")
+    parser.add_argument('--mermaid', action='store_true', help="Print the reachable call graph as Mermaid")
+    args = parser.parse_args()
+
+    entries = [parse_entry(spec) for spec in (args.entry or ['setup', 'loop'])]
+
+    frames = parse_stack_usage(args.build_dir)
+    if not frames:
+        print(f"Error: no .su files under {args.build_dir} - build with -fstack-usage")
+        return 2
+    calls, indirect = parse_call_graph(args.elf, args.objdump)
+    analyzer = StackAnalyzer(frames, calls, indirect)
+
+    print("# Stack Usage Analysis")
+    print(f"\n{len(frames)} frames from .su files, {len(calls)} functions in the call graph")
+
+    failed = False
+    roots = []
+    print("\n## Worst-case depth per entry point")
+    for name, budget in entries:
+        function = analyzer.resolve(name)
+        if function is None:
+            print(f"- **{name}**: not found in {args.elf}")
+            failed = failed or budget is not None
+            continue
+        roots.append(function)
+        depth, path = analyzer.worst(function)
+        verdict = ""
+        if budget is not None:
+            verdict = f" / budget {budget} B"
+            if depth > budget:
+                verdict += " - **OVER BUDGET**"
+                failed = True
+        print(f"- **{name}**: {depth} B{verdict}")
+        for step in path:
+            print(f"    {analyzer.frame(step):6d}  {bare_name(step)}")
+
+    reachable = analyzer.reachable(roots)
+
+    print(f"\n## Frames >= {args.frame_warn} B")
+    large = sorted(((frames[f][0], f) for f in frames if frames[f][0] >= args.frame_warn), reverse=True)
+    for size, func in large:
+        size, qualifier, location = frames[func]
+        print(f"- {size} B ({qualifier}) {bare_name(func)} at {location}")
+    if not large:
+        print("- none")
+
+    dynamic = sorted(f for f in reachable if f in frames and 'dynamic' in frames[f][1]
+                     and 'bounded' not in frames[f][1])
+    if dynamic:
+        print("\n## Unbounded dynamic frames (alloca/VLA) - depths are lower bounds")
+        for func in dynamic:
+            print(f"- {bare_name(func)}")
+
+    recursion = sorted(analyzer.recursive)
+    if recursion:
+        print("\n## Recursion - one iteration counted")
+        for func in recursion:
+            print(f"- {bare_name(func)}")
+
+    indirect_reachable = sorted(indirect & reachable)
+    if indirect_reachable:
+        print("\n## Indirect calls (not followed) - depths are lower bounds")
+        for func in indirect_reachable:
+            print(f"- {bare_name(func)}")
+
+    unknown = sorted(analyzer.unknown & reachable)
+    if unknown:
+        print(f"\n{len(unknown)} reachable functions have no .su entry (precompiled libraries), counted as 0 B")
+
+    if args.mermaid:
+        print("\n## Call Graph")
+        generate_mermaid_graph(analyzer, reachable)
+
+    if failed:
+        print("\nStack budget exceeded")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,37 @@
+"""
+PlatformIO post-build hook for tools/stack_analysis.py
+
+Runs the stack analysis after the ELF is linked and fails the build when an
+entry point exceeds its budget. Configured from platformio.ini:
+
+    custom_stack_entries     entry points, optionally name=budget_bytes
+    custom_stack_frame_warn  flag single frames at or above this size
+"""
+
+Import("env")
+
+import os
+import subprocess
+
+
+def run_stack_analysis(source, target, env):
+    # Same toolchain prefix as the compiler: xtensa-esp32s3-elf-gcc -> xtensa-esp32s3-elf-objdump
+    objdump_name = os.path.basename(env.subst("$CC")).replace("gcc", "objdump")
+    objdump = env.WhereIs(objdump_name) or objdump_name
+
+    cmd = [
+        env.subst("$PYTHONEXE"),
+        os.path.join(env.subst("$PROJECT_DIR"), "tools", "stack_analysis.py"),
+        "--build-dir", env.subst("$BUILD_DIR"),
+        "--elf", target[0].get_abspath(),
+        "--objdump", objdump,
+        "--frame-warn", env.GetProjectOption("custom_stack_frame_warn", "1024"),
+    ]
+    for entry in env.GetProjectOption("custom_stack_entries", "setup loop").split():
+        cmd += ["--entry", entry]
+
+    if subprocess.run(cmd).returncode != 0:
+        env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", run_stack_analysis)